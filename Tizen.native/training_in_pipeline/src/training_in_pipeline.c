@@ -42,8 +42,16 @@ typedef struct appdata {
 	unsigned version;
 	gchar *model_name;
 	gchar *resource_path[3];
+	gint64 epoch_start; /* start time of the epoch */
+	double epoch_ms; /* time of the last epoch */
+	double samples_per_sec; /* throughput of the last epoch */
 } appdata_s;
 
+/**
+ * @brief the number of samples in an epoch (num-training-samples + num-validation-samples)
+ */
+#define SAMPLES_PER_EPOCH 1000
+
 /**
  * @brief get output from the tensor_sink and update label
  */
@@ -66,6 +74,13 @@ get_output_from_tensor_sink(const ml_tensors_data_h data, const ml_tensors_info_
 		ad->result_data[i] = output[i];
 	}
 
+	/* tensor_trainer pushes the result at the end of each epoch */
+	gint64 now = g_get_monotonic_time();
+	ad->epoch_ms = (now - ad->epoch_start) / 1000.0;
+	ad->samples_per_sec = ad->epoch_ms > 0 ? SAMPLES_PER_EPOCH * 1000.0 / ad->epoch_ms : 0;
+	ad->epoch_start = now;
+	dlog_print(DLOG_INFO, LOG_TAG, "[epoch_time: %.1f ms, samples/sec: %.1f]", ad->epoch_ms, ad->samples_per_sec);
+
 	dlog_print(DLOG_INFO, LOG_TAG,
 			"[training_loss: %f, training_accuracy: %f, validation_loss: %f, validation_accuracy: %f]",
 			ad->result_data[0], ad->result_data[1], ad->result_data[2], ad->result_data[3]);
@@ -103,6 +118,7 @@ create_ml_pipeline(appdata_s *ad)
 	gchar *res_path = NULL;
 	gchar *shared_path = NULL;
 	gchar *pipeline_description = NULL;
+	gchar *load_prop = NULL;
 	int ret = ML_ERROR_NONE;
 
 	res_path = app_get_resource_path();
@@ -110,13 +126,20 @@ create_ml_pipeline(appdata_s *ad)
 	ad->model_name = "new_mnist_nntrainer_model.bin";
 	ad->model_save_path = g_strdup_printf("%s/%s", shared_path, ad->model_name);
 
+	/* resume from the model saved by the last training if no model is registered */
+	if (!ad->model_load_path && g_file_test(ad->model_save_path, G_FILE_TEST_EXISTS))
+		ad->model_load_path = g_strdup(ad->model_save_path);
+	if (ad->model_load_path)
+		load_prop = g_strdup_printf("model-load-path=%s", ad->model_load_path);
+
 	pipeline_description = g_strdup_printf(
 			"datareposrc location=%s json=%s epochs=10 ! queue ! "
 			"tensor_trainer name=tensor_trainer0 framework=nntrainer model-config=%s "
-			"model-save-path=%s model-load-path=%s num-inputs=1 num-labels=1 "
+			"model-save-path=%s %s num-inputs=1 num-labels=1 "
 			"num-training-samples=500 num-validation-samples=500 epochs=10 ! "
 			"tensor_sink name=tensor_sink0 sync=true",
-			ad->resource_path[0], ad->resource_path[1], ad->resource_path[2], ad->model_save_path, ad->model_load_path
+			ad->resource_path[0], ad->resource_path[1], ad->resource_path[2], ad->model_save_path,
+			load_prop ? load_prop : ""
 			);
 
 	ret = ml_pipeline_construct(pipeline_description, NULL, NULL, &ad->ml_pipe);
@@ -140,6 +163,7 @@ error:
 	g_free(ad->resource_path[1]);
 	g_free(ad->resource_path[2]);
 	g_free(pipeline_description);
+	g_free(load_prop);
 
 }
 
@@ -346,6 +370,7 @@ start_button_cb(void *data, Evas_Object *obj, void *event_info)
 
 	create_ml_pipeline(ad);
 
+	ad->epoch_start = g_get_monotonic_time();
 	ret = ml_pipeline_start(ad->ml_pipe);
 	if (ret != ML_ERROR_NONE) {
 		dlog_print(DLOG_INFO, LOG_TAG, "Failed to start ml pipeline ret(%d)", ret);
@@ -412,8 +437,10 @@ ecore_pipe_cb(void *data, void *buffer, unsigned int nbyte)
 	appdata_s *ad = data;
 	dlog_print(DLOG_INFO, LOG_TAG, "start >> ecore_pipe_cb");
 	gchar *text = g_strdup_printf(
-		"<align=center>%d epochs = [training_loss: %f, training_accuracy: %f, validation_loss: %f, validation_accuracy: %f]</align>",
-		ad->epochs++, ad->result_data[0], ad->result_data[1], ad->result_data[2], ad->result_data[3]);
+		"<align=center>%d epochs = [training_loss: %f, training_accuracy: %f, validation_loss: %f, validation_accuracy: %f]</align>"
+		"</br><align=center>epoch time: %.1f ms, samples/sec: %.1f</align>",
+		ad->epochs++, ad->result_data[0], ad->result_data[1], ad->result_data[2], ad->result_data[3],
+		ad->epoch_ms, ad->samples_per_sec);
 	elm_object_text_set(ad->label1, text);
 	g_free(text);
 	dlog_print(DLOG_INFO, LOG_TAG, "end >> ecore_pipe_cb");
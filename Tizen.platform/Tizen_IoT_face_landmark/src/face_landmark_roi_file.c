@@ -0,0 +1,306 @@
+/**
+ * @file face_landmark_roi_file.c
+ * @date 19 October 2026
+ * @brief run the face landmark ROI tracking with a video file on Linux
+ * @see  https://github.com/nnsuite/nnstreamer
+ * @author Hyunil Park <hyunil46.park@samsung.com>
+ * @bug No known bugs
+ *
+ * The same ROI tracking as the Tizen application (--tracking), without the display.
+ * Every frame of the file is given to the model, and the crop of each frame is derived from
+ * the landmarks of the previous frame. --fixed runs the fixed crop of the application for comparison.
+ *
+ * usage:
+ * $ ./face_landmark_roi_file --input=face.mp4 --model=face_landmark.tflite [--fixed] [--csv=frames.csv]
+ *
+ * result (stdout):
+ * mode,frames,face_frames,face_pct,tracked,detect_frames,redetections,fps
+ * frames.csv:
+ * frame,state,face_flag,roi_x,roi_y,roi_w,roi_h,face_x,face_y,face_w,face_h
+ */
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <gst/gst.h>
+#include "face_roi.h"
+
+#define NUM_OF_LANDMARK 468
+
+/**
+ * @brief app data structure
+ */
+typedef struct
+{
+	GMainLoop *loop;
+	GstElement *pipeline;
+	GstElement *crop;
+	gboolean fixed;
+	int width;
+	int height;
+	face_roi_tracker_s tracker;
+	face_roi_rect_s roi_used; /**< crop of the frame in the model */
+	int crop_set[4]; /**< left, top, right and bottom of videocrop */
+	float landmarks[NUM_OF_LANDMARK * 3];
+	guint frames;
+	guint face_frames;
+	FILE *csv;
+}app_data_s;
+
+/**
+ * @brief message callback
+ */
+static gboolean bus_call(GstBus *bus, GstMessage *msg, gpointer data)
+{
+	app_data_s *app_data = data;
+	gchar *debug;
+	GError *error;
+
+	switch (GST_MESSAGE_TYPE(msg)) {
+		case GST_MESSAGE_EOS:
+			g_main_loop_quit(app_data->loop);
+			break;
+		case GST_MESSAGE_ERROR:
+			gst_message_parse_error(msg, &error, &debug);
+			g_free(debug);
+
+			g_printerr("Error: %s\n", error->message);
+			g_error_free(error);
+			g_main_loop_quit(app_data->loop);
+			break;
+		default:
+			break;
+	}
+	return TRUE;
+}
+
+/**
+ * @brief set the crop of the tracker before videocrop handles the frame
+ */
+static GstPadProbeReturn __crop_probe_cb(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+	app_data_s *app_data = user_data;
+	int crop[4];
+
+	face_roi_get_crop(&app_data->tracker, &app_data->roi_used, &crop[0], &crop[1], &crop[2], &crop[3]);
+
+	if (memcmp(crop, app_data->crop_set, sizeof(crop)) != 0) {
+		g_object_set(app_data->crop, "left", crop[0], "top", crop[1],
+				"right", crop[2], "bottom", crop[3], NULL);
+		memcpy(app_data->crop_set, crop, sizeof(crop));
+	}
+
+	return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief new-data callback of tensor_sink, the model runs in the same thread as videocrop
+ */
+static void __new_data_cb(GstElement *element, GstBuffer *gstbuffer, gpointer user_data)
+{
+	app_data_s *app_data = user_data;
+	GstMemory *mem;
+	GstMapInfo info;
+	float face_flag = 0;
+	face_roi_state_e state;
+
+	if (gst_buffer_n_memory(gstbuffer) < 2)
+		return;
+
+	mem = gst_buffer_peek_memory(gstbuffer, 0);
+	if (gst_memory_map(mem, &info, GST_MAP_READ)) {
+		memcpy(app_data->landmarks, info.data, MIN(info.size, sizeof(app_data->landmarks)));
+		gst_memory_unmap(mem, &info);
+	}
+
+	mem = gst_buffer_peek_memory(gstbuffer, 1);
+	if (gst_memory_map(mem, &info, GST_MAP_READ)) {
+		face_flag = ((float *) info.data)[0];
+		gst_memory_unmap(mem, &info);
+	}
+
+	if (face_flag > FACE_FLAG_THRESHOLD)
+		app_data->face_frames++;
+
+	if (app_data->fixed)
+		state = face_flag > FACE_FLAG_THRESHOLD ? FACE_ROI_STATE_TRACK : FACE_ROI_STATE_DETECT;
+	else
+		state = face_roi_update(&app_data->tracker, &app_data->roi_used, app_data->landmarks,
+				NUM_OF_LANDMARK, face_flag);
+
+	if (app_data->csv)
+		fprintf(app_data->csv, "%u,%s,%.2f,%.0f,%.0f,%.0f,%.0f,%.1f,%.1f,%.1f,%.1f\n",
+				app_data->frames, state == FACE_ROI_STATE_TRACK ? "track" : "detect", face_flag,
+				app_data->roi_used.x, app_data->roi_used.y, app_data->roi_used.w, app_data->roi_used.h,
+				app_data->tracker.face.x, app_data->tracker.face.y,
+				app_data->tracker.face.w, app_data->tracker.face.h);
+
+	app_data->frames++;
+}
+
+/**
+ * @brief print usage info
+ */
+static void __usage(void)
+{
+	g_print("usage: face_landmark_roi_file [options]\n"
+			"  --input      Set the video file.\n"
+			"  --model      Set the face landmark model. (default face_landmark.tflite)\n"
+			"  --width      Set the width of the frame. (default 320)\n"
+			"  --height     Set the height of the frame. (default 240)\n"
+			"  --fixed      Use the fixed crop of the application (320x240 only).\n"
+			"  --padding    Set the margin of the face. (default 0.25)\n"
+			"  --smoothing  Set the weight of the new ROI, 1.0 to disable. (default 0.6)\n"
+			"  --csv        Write the ROI of each frame to the file.\n");
+}
+
+/**
+ * @brief main function
+ */
+int main(int argc, char *argv[])
+{
+	app_data_s ad;
+	face_roi_param_s param;
+	gchar *input = NULL, *model = NULL, *csv = NULL;
+	gchar *pipeline_description;
+	GstElement *tensor_sink;
+	GstBus *bus;
+	GstPad *pad;
+	gint64 start, elapsed;
+	gint opt;
+	struct option long_options[] = {
+			{ "input", required_argument, NULL, 'i' },
+			{ "model", required_argument, NULL, 'm' },
+			{ "width", required_argument, NULL, 'w' },
+			{ "height", required_argument, NULL, 'a' },
+			{ "fixed", no_argument, NULL, 'f' },
+			{ "padding", required_argument, NULL, 'p' },
+			{ "smoothing", required_argument, NULL, 's' },
+			{ "csv", required_argument, NULL, 'c' },
+			{ "help", no_argument, NULL, 'h' },
+			{ 0, 0, 0, 0 }
+	};
+
+	memset(&ad, 0, sizeof(app_data_s));
+	ad.width = 320;
+	ad.height = 240;
+	face_roi_param_init(&param);
+
+	while ((opt = getopt_long(argc, argv, "i:m:w:a:fp:s:c:h", long_options, NULL)) != -1) {
+		switch (opt) {
+			case 'i':
+				g_free(input);
+				input = g_strdup(optarg);
+				break;
+			case 'm':
+				g_free(model);
+				model = g_strdup(optarg);
+				break;
+			case 'w':
+				ad.width = (int) g_ascii_strtoll(optarg, NULL, 10);
+				break;
+			case 'a':
+				ad.height = (int) g_ascii_strtoll(optarg, NULL, 10);
+				break;
+			case 'f':
+				ad.fixed = TRUE;
+				break;
+			case 'p':
+				param.padding = (float) g_ascii_strtod(optarg, NULL);
+				break;
+			case 's':
+				param.smoothing = (float) g_ascii_strtod(optarg, NULL);
+				break;
+			case 'c':
+				g_free(csv);
+				csv = g_strdup(optarg);
+				break;
+			default:
+				__usage();
+				return 0;
+		}
+	}
+
+	if (!input) {
+		__usage();
+		return -1;
+	}
+
+	if (!model)
+		model = g_strdup("face_landmark.tflite");
+
+	if (ad.fixed) {
+		ad.width = 320;
+		ad.height = 240;
+	}
+
+	if (csv) {
+		ad.csv = fopen(csv, "w");
+		if (ad.csv)
+			fprintf(ad.csv, "frame,state,face_flag,roi_x,roi_y,roi_w,roi_h,face_x,face_y,face_w,face_h\n");
+	}
+
+	gst_init(&argc, &argv);
+	face_roi_tracker_init(&ad.tracker, ad.width, ad.height, &param);
+
+	pipeline_description = g_strdup_printf
+	("filesrc location=%s ! decodebin ! videoconvert ! videoscale ! video/x-raw,width=%d,height=%d,format=RGB "
+	 "! videocrop name=roi_crop %s ! videoscale ! video/x-raw,width=%d,height=%d,format=RGB ! tensor_converter "
+	 "! tensor_transform mode=typecast option=float32 ! tensor_filter framework=tensorflow-lite model=%s "
+	 "! tensor_sink name=tensor_sink sync=false", input, ad.width, ad.height,
+	 ad.fixed ? "top=48 left=128" : "", FACE_ROI_MODEL_SIZE, FACE_ROI_MODEL_SIZE, model);
+
+	ad.pipeline = gst_parse_launch(pipeline_description, NULL);
+	g_free(pipeline_description);
+	if (!ad.pipeline) {
+		g_printerr("Error: Failed to launch \n");
+		return -1;
+	}
+
+	ad.loop = g_main_loop_new(NULL, FALSE);
+	bus = gst_pipeline_get_bus(GST_PIPELINE(ad.pipeline));
+	gst_bus_add_watch(bus, bus_call, &ad);
+	gst_object_unref(bus);
+
+	/* videocrop and the model run in the streaming thread, so the crop of each frame is known */
+	ad.crop = gst_bin_get_by_name(GST_BIN(ad.pipeline), "roi_crop");
+	if (ad.fixed) {
+		ad.roi_used.x = 128;
+		ad.roi_used.y = 48;
+		ad.roi_used.w = FACE_ROI_MODEL_SIZE;
+		ad.roi_used.h = FACE_ROI_MODEL_SIZE;
+	} else {
+		pad = gst_element_get_static_pad(ad.crop, "sink");
+		gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, __crop_probe_cb, &ad, NULL);
+		gst_object_unref(pad);
+	}
+
+	tensor_sink = gst_bin_get_by_name(GST_BIN(ad.pipeline), "tensor_sink");
+	g_signal_connect(tensor_sink, "new-data", G_CALLBACK(__new_data_cb), &ad);
+	gst_object_unref(tensor_sink);
+
+	start = g_get_monotonic_time();
+	gst_element_set_state(ad.pipeline, GST_STATE_PLAYING);
+	g_main_loop_run(ad.loop);
+	elapsed = g_get_monotonic_time() - start;
+
+	gst_element_set_state(ad.pipeline, GST_STATE_NULL);
+
+	g_print("mode,frames,face_frames,face_pct,tracked,detect_frames,redetections,fps\n");
+	g_print("%s,%u,%u,%.1f,%u,%u,%u,%.1f\n", ad.fixed ? "fixed" : "tracking",
+			ad.frames, ad.face_frames, ad.frames ? 100.0 * ad.face_frames / ad.frames : 0.0,
+			ad.tracker.tracked, ad.tracker.frames - ad.tracker.tracked, ad.tracker.detections,
+			elapsed > 0 ? ad.frames * (gdouble) G_USEC_PER_SEC / elapsed : 0.0);
+
+	if (ad.csv)
+		fclose(ad.csv);
+	gst_object_unref(ad.crop);
+	gst_object_unref(ad.pipeline);
+	g_main_loop_unref(ad.loop);
+	g_free(input);
+	g_free(model);
+	g_free(csv);
+
+	return 0;
+}
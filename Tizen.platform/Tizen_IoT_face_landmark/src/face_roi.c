@@ -0,0 +1,263 @@
+/**
+ * @file face_roi.c
+ * @date 19 October 2026
+ * @brief ROI tracking for the face landmark model
+ * @see  https://github.com/nnsuite/nnstreamer
+ * @author Hyunil Park <hyunil46.park@samsung.com>
+ * @bug No known bugs
+ */
+#include <string.h>
+#include "face_roi.h"
+
+#define ROI_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define ROI_MAX(a, b) ((a) > (b) ? (a) : (b))
+#define ROI_ABS(a) ((a) < 0 ? -(a) : (a))
+
+/**
+ * @brief set the default parameters
+ */
+void face_roi_param_init(face_roi_param_s *param)
+{
+	if (!param)
+		return;
+
+	/* the model expects a margin of 25% of the face size */
+	param->padding = 0.25f;
+	param->smoothing = 0.6f;
+	param->jump = 0.2f;
+	param->threshold = FACE_FLAG_THRESHOLD;
+}
+
+/**
+ * @brief get the windows of a search level along an axis, evenly spread from an edge to the other
+ */
+static int __get_search_steps(int frame_size, float size)
+{
+	float range = frame_size - size;
+
+	if (range <= 0)
+		return 1;
+
+	/* windows overlap by half of the size */
+	return (int) (range / (size / 2) + 0.999f) + 1;
+}
+
+/**
+ * @brief get the position of the window along an axis
+ */
+static float __get_search_pos(int frame_size, float size, int steps, int index)
+{
+	if (steps <= 1)
+		return ROI_MAX(0, (frame_size - size) / 2);
+
+	return (frame_size - size) * index / (steps - 1);
+}
+
+/**
+ * @brief set the ROI to the next search window, a square of the model aspect ratio
+ *
+ * The model input is square, a crop of the whole frame would squash the face.
+ * The first window is the largest square at the center, then the frame is scanned with
+ * the largest squares and the squares of 2/3 of the size, one window per frame.
+ */
+static void __set_search_window(face_roi_tracker_s *tracker)
+{
+	float sizes[FACE_ROI_SEARCH_LEVELS];
+	int nx, ny, level, index;
+	int total = 1;
+
+	sizes[0] = ROI_MIN(tracker->frame_width, tracker->frame_height);
+	for (level = 1; level < FACE_ROI_SEARCH_LEVELS; level++)
+		sizes[level] = ROI_MAX(sizes[level - 1] * 2 / 3, ROI_MIN(FACE_ROI_MIN_SIZE, sizes[0]));
+
+	for (level = 0; level < FACE_ROI_SEARCH_LEVELS; level++) {
+		total += __get_search_steps(tracker->frame_width, sizes[level]) *
+			__get_search_steps(tracker->frame_height, sizes[level]);
+	}
+
+	index = tracker->search % total;
+	tracker->search++;
+
+	/* the centered window */
+	if (index == 0) {
+		tracker->roi.w = sizes[0];
+		tracker->roi.h = sizes[0];
+		tracker->roi.x = (tracker->frame_width - sizes[0]) / 2;
+		tracker->roi.y = (tracker->frame_height - sizes[0]) / 2;
+		return;
+	}
+
+	index--;
+	for (level = 0; level < FACE_ROI_SEARCH_LEVELS; level++) {
+		nx = __get_search_steps(tracker->frame_width, sizes[level]);
+		ny = __get_search_steps(tracker->frame_height, sizes[level]);
+
+		if (index < nx * ny) {
+			tracker->roi.w = sizes[level];
+			tracker->roi.h = sizes[level];
+			tracker->roi.x = __get_search_pos(tracker->frame_width, sizes[level], nx, index % nx);
+			tracker->roi.y = __get_search_pos(tracker->frame_height, sizes[level], ny, index / nx);
+			return;
+		}
+
+		index -= nx * ny;
+	}
+}
+
+/**
+ * @brief derive the square ROI from the face, smoothed with the previous ROI while tracking
+ */
+static void __set_roi_from_face(face_roi_tracker_s *tracker, const face_roi_rect_s *face, int smooth)
+{
+	float cx, cy, size, prev_cx, prev_cy, a;
+	float max_size;
+
+	cx = face->x + face->w / 2;
+	cy = face->y + face->h / 2;
+	size = ROI_MAX(face->w, face->h) * (1 + 2 * tracker->param.padding);
+
+	if (smooth) {
+		prev_cx = tracker->roi.x + tracker->roi.w / 2;
+		prev_cy = tracker->roi.y + tracker->roi.h / 2;
+
+		/* follow a fast movement at once, smooth the jitter of the landmarks */
+		if (ROI_MAX(ROI_ABS(cx - prev_cx), ROI_ABS(cy - prev_cy)) < tracker->param.jump * tracker->roi.w) {
+			a = tracker->param.smoothing;
+			cx = a * cx + (1 - a) * prev_cx;
+			cy = a * cy + (1 - a) * prev_cy;
+			size = a * size + (1 - a) * tracker->roi.w;
+		}
+	}
+
+	max_size = ROI_MIN(tracker->frame_width, tracker->frame_height);
+	size = ROI_MAX(ROI_MIN(size, max_size), ROI_MIN(FACE_ROI_MIN_SIZE, max_size));
+
+	/* shift the ROI into the frame, the face is not centered near the edge */
+	tracker->roi.w = size;
+	tracker->roi.h = size;
+	tracker->roi.x = ROI_MAX(0, ROI_MIN(cx - size / 2, tracker->frame_width - size));
+	tracker->roi.y = ROI_MAX(0, ROI_MIN(cy - size / 2, tracker->frame_height - size));
+}
+
+/**
+ * @brief initialize the tracker in the detection state
+ */
+void face_roi_tracker_init(face_roi_tracker_s *tracker, int frame_width, int frame_height,
+	const face_roi_param_s *param)
+{
+	if (!tracker)
+		return;
+
+	memset(tracker, 0, sizeof(face_roi_tracker_s));
+	if (param)
+		tracker->param = *param;
+	else
+		face_roi_param_init(&tracker->param);
+
+	tracker->frame_width = frame_width;
+	tracker->frame_height = frame_height;
+	tracker->state = FACE_ROI_STATE_DETECT;
+	__set_search_window(tracker);
+}
+
+/**
+ * @brief get the crop of the next frame, snapped to the pixel grid
+ */
+void face_roi_get_crop(const face_roi_tracker_s *tracker, face_roi_rect_s *roi,
+	int *left, int *top, int *right, int *bottom)
+{
+	int x, y, w, h;
+
+	if (!tracker || !roi)
+		return;
+
+	/* even offsets and sizes, so small changes do not renegotiate the crop every frame */
+	x = ((int) (tracker->roi.x + 0.5f)) & ~1;
+	y = ((int) (tracker->roi.y + 0.5f)) & ~1;
+	w = ((int) (tracker->roi.w + 0.5f)) & ~1;
+	h = ((int) (tracker->roi.h + 0.5f)) & ~1;
+
+	w = ROI_MAX(2, ROI_MIN(w, tracker->frame_width - x));
+	h = ROI_MAX(2, ROI_MIN(h, tracker->frame_height - y));
+
+	roi->x = x;
+	roi->y = y;
+	roi->w = w;
+	roi->h = h;
+
+	if (left)
+		*left = x;
+	if (top)
+		*top = y;
+	if (right)
+		*right = tracker->frame_width - x - w;
+	if (bottom)
+		*bottom = tracker->frame_height - y - h;
+}
+
+/**
+ * @brief convert the point in the model input coordinates to the frame coordinates
+ */
+void face_roi_to_frame(const face_roi_rect_s *roi, float x, float y, float *frame_x, float *frame_y)
+{
+	if (!roi)
+		return;
+
+	if (frame_x)
+		*frame_x = roi->x + x * roi->w / FACE_ROI_MODEL_SIZE;
+	if (frame_y)
+		*frame_y = roi->y + y * roi->h / FACE_ROI_MODEL_SIZE;
+}
+
+/**
+ * @brief update the tracker with the model output of a frame
+ */
+face_roi_state_e face_roi_update(face_roi_tracker_s *tracker, const face_roi_rect_s *roi,
+	const float *landmarks, int num_landmarks, float face_flag)
+{
+	face_roi_rect_s face;
+	float x, y, min_x, min_y, max_x, max_y;
+	int i;
+
+	if (!tracker)
+		return FACE_ROI_STATE_DETECT;
+
+	tracker->frames++;
+
+	/* face is lost, search the frame again from the centered window */
+	if (!roi || !landmarks || num_landmarks <= 0 || face_flag < tracker->param.threshold) {
+		if (tracker->state == FACE_ROI_STATE_TRACK) {
+			tracker->detections++;
+			tracker->search = 0;
+		}
+
+		tracker->state = FACE_ROI_STATE_DETECT;
+		__set_search_window(tracker);
+		return tracker->state;
+	}
+
+	face_roi_to_frame(roi, landmarks[0], landmarks[1], &min_x, &min_y);
+	max_x = min_x;
+	max_y = min_y;
+
+	for (i = 1; i < num_landmarks; i++) {
+		face_roi_to_frame(roi, landmarks[i * 3], landmarks[i * 3 + 1], &x, &y);
+		min_x = ROI_MIN(min_x, x);
+		min_y = ROI_MIN(min_y, y);
+		max_x = ROI_MAX(max_x, x);
+		max_y = ROI_MAX(max_y, y);
+	}
+
+	face.x = min_x;
+	face.y = min_y;
+	face.w = max_x - min_x;
+	face.h = max_y - min_y;
+
+	__set_roi_from_face(tracker, &face, tracker->state == FACE_ROI_STATE_TRACK);
+	tracker->face = face;
+	tracker->state = FACE_ROI_STATE_TRACK;
+	tracker->tracked++;
+
+	return tracker->state;
+}
+
@@ -0,0 +1,114 @@
+/**
+ * @file face_roi.h
+ * @date 19 October 2026
+ * @brief ROI tracking for the face landmark model
+ * @see  https://github.com/nnsuite/nnstreamer
+ * @author Hyunil Park <hyunil46.park@samsung.com>
+ * @bug No known bugs
+ *
+ * The crop of the next frame is derived from the landmarks of the previous frame.
+ * When the face flag drops below the threshold, the tracker goes back to the detection state
+ * and searches the frame with square windows (one per frame) to find the face again.
+ * This module depends on the C library only, the same code runs on Tizen and on Linux.
+ */
+#ifndef __FACE_ROI_H__
+#define __FACE_ROI_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef FACE_FLAG_THRESHOLD
+#define FACE_FLAG_THRESHOLD 120
+#endif
+
+#define FACE_ROI_MODEL_SIZE 192
+#define FACE_ROI_MIN_SIZE 32
+#define FACE_ROI_SEARCH_LEVELS 2
+
+/**
+ * @brief rectangle in the frame coordinates
+ */
+typedef struct
+{
+	float x;
+	float y;
+	float w;
+	float h;
+}face_roi_rect_s;
+
+/**
+ * @brief tracker state
+ */
+typedef enum
+{
+	FACE_ROI_STATE_DETECT = 0, /**< face is not found, search the frame with square windows */
+	FACE_ROI_STATE_TRACK, /**< crop is derived from the previous landmarks */
+}face_roi_state_e;
+
+/**
+ * @brief tracker parameters
+ */
+typedef struct
+{
+	float padding; /**< margin of each side, ratio of the face size */
+	float smoothing; /**< weight of the new ROI, 1.0 to disable smoothing */
+	float jump; /**< the ROI is not smoothed if the face moves more than this ratio of the ROI size */
+	float threshold; /**< face flag threshold */
+}face_roi_param_s;
+
+/**
+ * @brief tracker
+ */
+typedef struct
+{
+	face_roi_param_s param;
+	int frame_width;
+	int frame_height;
+	face_roi_state_e state;
+	face_roi_rect_s roi; /**< ROI of the next frame */
+	face_roi_rect_s face; /**< bounding box of the last landmarks */
+	unsigned int frames; /**< the number of updates */
+	unsigned int tracked; /**< the number of frames the face is tracked */
+	unsigned int detections; /**< the number of times the tracker lost the face */
+	unsigned int search; /**< the next search window in the detection state */
+}face_roi_tracker_s;
+
+/**
+ * @brief set the default parameters
+ */
+void face_roi_param_init(face_roi_param_s *param);
+
+/**
+ * @brief initialize the tracker in the detection state
+ */
+void face_roi_tracker_init(face_roi_tracker_s *tracker, int frame_width, int frame_height,
+	const face_roi_param_s *param);
+
+/**
+ * @brief get the crop of the next frame, snapped to the pixel grid
+ * @param[out] roi the rectangle actually cropped, pass it to face_roi_update()
+ * @param[out] left, top, right, bottom the properties of videocrop
+ */
+void face_roi_get_crop(const face_roi_tracker_s *tracker, face_roi_rect_s *roi,
+	int *left, int *top, int *right, int *bottom);
+
+/**
+ * @brief update the tracker with the model output of a frame
+ * @param roi the crop given to the model
+ * @param landmarks (x,y,z) of the landmarks in the model input coordinates
+ * @return the state for the next frame
+ */
+face_roi_state_e face_roi_update(face_roi_tracker_s *tracker, const face_roi_rect_s *roi,
+	const float *landmarks, int num_landmarks, float face_flag);
+
+/**
+ * @brief convert the point in the model input coordinates to the frame coordinates
+ */
+void face_roi_to_frame(const face_roi_rect_s *roi, float x, float y, float *frame_x, float *frame_y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FACE_ROI_H__ */
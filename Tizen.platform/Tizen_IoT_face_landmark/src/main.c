@@ -27,6 +27,11 @@
  *         Face flag indicating the likelihood of the face being present in the input image.
  *         Used in tracking mode to detect that the face was lost and the face detector should be applied to
  *         obtain a new face position.
+ *
+ * tracking mode (tizen_iot_face_landmark --tracking):
+ *         The crop of the next frame is derived from the landmarks of the previous frame (face_roi.c),
+ *         instead of the fixed crop. When the face flag drops below FACE_FLAG_THRESHOLD,
+ *         the frame is searched with square windows to find the face again.
 */
 #include <glib.h>
 #include <stdio.h>
@@ -48,6 +53,9 @@
 #define PACKAGE "face-landmarks"
 #define FACE_FLAG_THRESHOLD 120
 #define NUM_OF_LANDMARK 468
+#define FRAME_WIDTH 320
+#define FRAME_HEIGHT 240
+#include "face_roi.h"
 
 /**
  * @brief tflite model info structure
@@ -79,6 +87,13 @@ typedef struct
 	tflite_info_s tflite_info;
 	point_s point[NUM_OF_LANDMARK];
 	float face_flag;
+	gboolean tracking;
+	GMutex lock;
+	GstElement *crop;
+	face_roi_tracker_s tracker;
+	face_roi_rect_s roi_used; /* crop of the frame in the model */
+	face_roi_rect_s roi_draw; /* crop of the landmarks to draw */
+	int crop_set[4];
 }app_data_s;
 
 /**
@@ -366,12 +381,16 @@ static void __new_data_cb (GstElement *element, GstBuffer *gstbuffer, gpointer u
 		return;
 	}
 
+	/* in tracking mode, __draw_cb reads the points and the ROI together */
+	if (app_data->tracking)
+		g_mutex_lock(&app_data->lock);
+
 	/* Repeat as time as model's number of output */
 	for (i = 0; i < gst_buffer_n_memory(gstbuffer); i++) {
 		mem = gst_buffer_peek_memory(gstbuffer, i);
 		if (mem == NULL) {
 			g_print("Faild peek memory \n");
-			return;
+			break;
 		}
 		if (gst_memory_map(mem, &info, GST_MAP_READ)) {
 			int len = info.size/4;
@@ -382,7 +401,36 @@ static void __new_data_cb (GstElement *element, GstBuffer *gstbuffer, gpointer u
 			}
 			gst_memory_unmap(mem, &info);
 		}
-	}	
+	}
+
+	/* derive the crop of the next frame from the landmarks */
+	if (app_data->tracking) {
+		face_roi_update(&app_data->tracker, &app_data->roi_used, (float *) app_data->point,
+				NUM_OF_LANDMARK, app_data->face_flag);
+		app_data->roi_draw = app_data->roi_used;
+		g_mutex_unlock(&app_data->lock);
+	}
+}
+
+/**
+ * @brief set the crop of the tracker before videocrop handles the frame
+ */
+static GstPadProbeReturn __crop_probe_cb(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+	app_data_s *app_data = user_data;
+	int crop[4];
+
+	g_mutex_lock(&app_data->lock);
+	face_roi_get_crop(&app_data->tracker, &app_data->roi_used, &crop[0], &crop[1], &crop[2], &crop[3]);
+	g_mutex_unlock(&app_data->lock);
+
+	if (memcmp(crop, app_data->crop_set, sizeof(crop)) != 0) {
+		g_object_set(app_data->crop, "left", crop[0], "top", crop[1],
+				"right", crop[2], "bottom", crop[3], NULL);
+		memcpy(app_data->crop_set, crop, sizeof(crop));
+	}
+
+	return GST_PAD_PROBE_OK;
 }
 
 /**
@@ -395,6 +443,27 @@ static void __draw_cb(GstElement *overlay, cairo_t *cr, guint64 timestamp,
 	app_data = user_data;
 	g_return_if_fail(app_data != NULL);      
 	
+	if (app_data->tracking) {
+		g_mutex_lock(&app_data->lock);
+		if (app_data->face_flag > FACE_FLAG_THRESHOLD) {
+			/* landmarks are in the crop, draw them on the whole frame */
+			cairo_set_source_rgba(cr, 0, 1.0, 0, 1.0);
+			for (int i = 0; i < NUM_OF_LANDMARK; i++) {
+				float x, y;
+				face_roi_to_frame(&app_data->roi_draw, app_data->point[i].x, app_data->point[i].y, &x, &y);
+				cairo_arc(cr, x, y, 0.1, 0, 2*M_PI);
+				cairo_stroke(cr);
+			}
+
+			cairo_set_source_rgba(cr, 1.0, 1.0, 0, 1.0);
+			cairo_rectangle(cr, app_data->roi_draw.x, app_data->roi_draw.y,
+					app_data->roi_draw.w, app_data->roi_draw.h);
+			cairo_stroke(cr);
+		}
+		g_mutex_unlock(&app_data->lock);
+		return;
+	}
+
 	if (app_data->face_flag > FACE_FLAG_THRESHOLD) {
 		cairo_set_source_rgba(cr, 0, 1.0, 0, 1.0);
 		for (int i = 0; i < NUM_OF_LANDMARK; i++) {
@@ -446,11 +515,24 @@ static int app_create(void *data)
 	/* gstreamer init */
 	gst_init(NULL, NULL);
 
-	/* RPI4 with common profile */
-	pipeline_description = g_strdup_printf
-	("v4l2src ! videoconvert ! video/x-raw,width=320,height=240,format=RGB ! videocrop top=48 left=128 !videoscale ! video/x-raw,width=192,height=192,format=RGB ! tee name=t_raw  t_raw. ! queue "
-	 "! videoconvert ! cairooverlay name=cairo_overlay ! tizenwlsink name=videosink t_raw. ! queue leaky=2 max-size-buffers=2 ! tensor_converter "
-	 "! tensor_transform mode=typecast option=float32 ! tensor_filter framework=tensorflow-lite model=%s ! tensor_sink name=tensor_sink", app_data->tflite_info.model_path);
+	/* tracking mode: the model runs on the crop of the tracker, the whole frame is displayed */
+	if (app_data->tracking) {
+		g_mutex_init(&app_data->lock);
+		face_roi_tracker_init(&app_data->tracker, FRAME_WIDTH, FRAME_HEIGHT, NULL);
+
+		pipeline_description = g_strdup_printf
+		("v4l2src ! videoconvert ! video/x-raw,width=%d,height=%d,format=RGB ! tee name=t_raw  t_raw. ! queue "
+		 "! videoconvert ! cairooverlay name=cairo_overlay ! tizenwlsink name=videosink t_raw. ! queue leaky=2 max-size-buffers=2 "
+		 "! videocrop name=roi_crop ! videoscale ! video/x-raw,width=%d,height=%d,format=RGB ! tensor_converter "
+		 "! tensor_transform mode=typecast option=float32 ! tensor_filter framework=tensorflow-lite model=%s ! tensor_sink name=tensor_sink",
+		 FRAME_WIDTH, FRAME_HEIGHT, FACE_ROI_MODEL_SIZE, FACE_ROI_MODEL_SIZE, app_data->tflite_info.model_path);
+	} else {
+		/* RPI4 with common profile */
+		pipeline_description = g_strdup_printf
+		("v4l2src ! videoconvert ! video/x-raw,width=320,height=240,format=RGB ! videocrop top=48 left=128 !videoscale ! video/x-raw,width=192,height=192,format=RGB ! tee name=t_raw  t_raw. ! queue "
+		 "! videoconvert ! cairooverlay name=cairo_overlay ! tizenwlsink name=videosink t_raw. ! queue leaky=2 max-size-buffers=2 ! tensor_converter "
+		 "! tensor_transform mode=typecast option=float32 ! tensor_filter framework=tensorflow-lite model=%s ! tensor_sink name=tensor_sink", app_data->tflite_info.model_path);
+	}
 
 	/** TM1 ref target with mobile profile
 	pipeline_description = g_strdup_printf
@@ -483,10 +565,24 @@ static int app_create(void *data)
 	gst_video_overlay_set_wl_window_wl_surface_id(GST_VIDEO_OVERLAY(videosink), app_data->parent_id);
 
 	/* set display roi for setting good camera angle */
-	g_object_set(GST_OBJECT(videosink), "display-geometry-method", 5,
-			"display-roi-x", 0,"display-roi-y", 0, "display-roi-width", 256,"display-roi-height", 256, NULL);
+	if (app_data->tracking)
+		g_object_set(GST_OBJECT(videosink), "display-geometry-method", 5,
+				"display-roi-x", 0,"display-roi-y", 0, "display-roi-width", FRAME_WIDTH,"display-roi-height", FRAME_HEIGHT, NULL);
+	else
+		g_object_set(GST_OBJECT(videosink), "display-geometry-method", 5,
+				"display-roi-x", 0,"display-roi-y", 0, "display-roi-width", 256,"display-roi-height", 256, NULL);
 	gst_object_unref(GST_OBJECT(videosink));
 
+	/* videocrop and the model run in the same thread, the probe sets the crop of each frame */
+	if (app_data->tracking) {
+		GstPad *pad = NULL;
+
+		app_data->crop = gst_bin_get_by_name(GST_BIN(app_data->pipeline), "roi_crop");
+		pad = gst_element_get_static_pad(app_data->crop, "sink");
+		gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, __crop_probe_cb, app_data, NULL);
+		gst_object_unref(pad);
+	}
+
 	/* add new-data callback to tensorsink */
 	tensor_sink = gst_bin_get_by_name(GST_BIN(app_data->pipeline), "tensor_sink");
 	g_signal_connect(GST_OBJECT(tensor_sink), "new-data", G_CALLBACK(__new_data_cb), app_data);
@@ -523,6 +619,14 @@ static int app_terminate(void *data)
 			gst_bus_remove_watch(app_data->bus);
 	}
 
+	if (app_data->crop) {
+		gst_object_unref(app_data->crop);
+		app_data->crop = NULL;
+	}
+
+	if (app_data->tracking)
+		g_mutex_clear(&app_data->lock);
+
 	if (app_data->tflite_info.model_path) {
 		g_free(app_data->tflite_info.model_path);
 		app_data->tflite_info.model_path = NULL;
@@ -551,5 +655,8 @@ int main(int argc, char *argv[])
 	memset(&ad, 0x0, sizeof(app_data_s));
 	ops.data = &ad;
 
+	if (argc > 1 && g_strcmp0(argv[1], "--tracking") == 0)
+		ad.tracking = TRUE;
+
 	return appcore_efl_main(PACKAGE, &argc, &argv, &ops);
 }
@@ -0,0 +1,847 @@
+/**
+ * @file	nnstreamer_example_inference_offloading_adaptive.c
+ * @date	19 October 2026
+ * @brief	Leaf program choosing local inference or offloading to the edge server for each frame.
+ * @see	https://github.com/nnstreamer/nnstreamer
+ * @author	 <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ */
+/**
+ * @note The frame goes to tensor_if, and a custom condition of tensor_if chooses the path.
+ * src_0 (TRUE) sends the frame to the edge server with tensor_query_client,
+ * src_1 (FALSE) runs the local tensor_filter.
+ *
+ * The latency of each path is measured from the queue of the path to the tensor_sink,
+ * and the policy keeps the moving average (EWMA) of each path.
+ * The oldest frame in flight is counted too, so a path which stops responding looks slow.
+ *  - latency: choose the path with the lower latency.
+ *  - deadline: choose local inference if it meets the deadline, otherwise the remote one
+ *    if it meets the deadline, otherwise the faster one.
+ *  - local, remote: always use the path (baseline).
+ * Every --probe-interval frames, a frame goes to the other path to update its latency.
+ *
+ * With --test, the edge server runs in the same process (localhost), and the local inference
+ * and the round-trip to the server are emulated with custom-easy filters sleeping for the delay
+ * given by --schedule. Each policy in --policies runs the phases in the schedule, and the result
+ * shows the policy tracking the faster path.
+ *
+ * Result is printed as CSV:
+ * policy,phase,local_delay_ms,remote_delay_ms,frames,remote_pct,lat_mean_ms,lat_p50_ms,lat_p90_ms,est_local_ms,est_remote_ms,dropped
+ *
+ * Run example :
+ * $ ./nnstreamer_example_inference_offloading_adaptive --test --schedule=30:10,30:60,30:10 --phase-sec=5
+ * $ ./nnstreamer_example_inference_offloading_edge --host=192.168.0.2 --port=5001
+ * $ ./nnstreamer_example_inference_offloading_adaptive --host=192.168.0.2 --port=5001 --local-ms=30 --duration=30
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib.h>
+#include <gst/gst.h>
+#include <nnstreamer/tensor_filter_custom_easy.h>
+#include <nnstreamer/tensor_if.h>
+#include <nnstreamer_plugin_api_util.h>
+#include <getopt.h>
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) if (DBG) g_message (__VA_ARGS__)
+
+/**
+ * @brief Paths of the frame.
+ */
+typedef enum
+{
+  PATH_LOCAL = 0,
+  PATH_REMOTE,
+  PATH_NUM
+} OffloadPath;
+
+/**
+ * @brief Offloading policies.
+ */
+typedef enum
+{
+  POLICY_LATENCY = 0,
+  POLICY_DEADLINE,
+  POLICY_LOCAL,
+  POLICY_REMOTE,
+  POLICY_UNKNOWN
+} OffloadPolicy;
+
+/**
+ * @brief Names of the policies.
+ */
+static const gchar *policy_names[] = { "latency", "deadline", "local", "remote", NULL };
+
+/**
+ * @brief Frame in flight.
+ */
+typedef struct
+{
+  GstClockTime pts; /**< timestamp of the frame */
+  gint64 time; /**< time the frame entered the path */
+} FrameStamp;
+
+/**
+ * @brief Options of the example.
+ */
+typedef struct
+{
+  gchar *host; /**< edge server host */
+  guint16 port; /**< edge server port */
+  gchar *client_host;
+  gchar *framework; /**< framework of the local model */
+  gchar *model; /**< local model, custom-easy filter sleeping local-ms if not given */
+  guint local_ms; /**< emulated local inference time */
+  OffloadPolicy policy;
+  gdouble deadline_ms;
+  gdouble alpha; /**< weight of the new latency in EWMA */
+  guint probe_interval; /**< send a frame to the other path every N frames, 0 to disable */
+  guint framerate;
+  guint duration; /**< running time in sec */
+  gboolean test; /**< loopback test with emulated delays */
+  gchar *schedule; /**< phases of the test, local_ms:remote_ms */
+  guint phase_sec;
+  gchar *policies; /**< policies of the test */
+} OffloadOptions;
+
+/**
+ * @brief State of the policy and the statistics.
+ */
+typedef struct
+{
+  GMutex lock;
+  OffloadPolicy policy;
+  gdouble deadline_ms;
+  gdouble alpha;
+  guint probe_interval;
+  guint since_probe; /**< frames after the last probe */
+  gdouble est_ms[PATH_NUM]; /**< EWMA of the latency, negative if unknown */
+  GQueue pending[PATH_NUM]; /**< FrameStamp in flight */
+
+  /* statistics of the phase */
+  guint64 frames[PATH_NUM]; /**< completed frames */
+  guint64 dropped; /**< frames without the result */
+  GArray *latency; /**< end-to-end latency (ms) */
+} OffloadState;
+
+/**
+ * @brief Data for the callbacks of a path.
+ */
+typedef struct
+{
+  OffloadState *state;
+  OffloadPath path;
+} PathData;
+
+/**
+ * @brief Emulated delays of the test (ms).
+ */
+static gint local_delay_ms;
+static gint remote_delay_ms;
+
+/**
+ * @brief Print usage info
+ */
+static void
+_usage (void)
+{
+  g_print ("usage: nnstreamer_example_inference_offloading_adaptive [options]\n"
+      "  --host            Set edge server host. (default localhost)\n"
+      "  --port            Set edge server port. (default 5001)\n"
+      "  --client_host     Set the host of tensor_query_client. (default localhost)\n"
+      "  --framework       Set the framework of the local model. (default tensorflow-lite)\n"
+      "  --model           Set the local model. (default custom-easy sleeping --local-ms)\n"
+      "  --local-ms        Set the emulated local inference time in ms. (default 20)\n"
+      "  --policy          Set the policy, latency, deadline, local or remote. (default latency)\n"
+      "  --deadline-ms     Set the deadline in ms. (default 50)\n"
+      "  --alpha           Set the weight of the new latency in the average. (default 0.2)\n"
+      "  --probe-interval  Send a frame to the other path every N frames. (default 10, 0 to disable)\n"
+      "  --framerate       Set the framerate. (default 10)\n"
+      "  --duration        Set the running time in sec. (default 10)\n"
+      "  --test            Run the loopback test with emulated delays.\n"
+      "  --schedule        Set the phases of the test, local_ms:remote_ms,... (default 30:10,30:60,30:10)\n"
+      "  --phase-sec       Set the time of a phase in sec. (default 5)\n"
+      "  --policies        Set the policies of the test. (default local,remote,latency)\n");
+}
+
+/**
+ * @brief Get the policy from the name.
+ */
+static OffloadPolicy
+_get_policy (const gchar * name)
+{
+  guint i;
+
+  for (i = 0; policy_names[i]; i++) {
+    if (g_ascii_strcasecmp (name, policy_names[i]) == 0)
+      return (OffloadPolicy) i;
+  }
+
+  return POLICY_UNKNOWN;
+}
+
+/**
+ * @brief Compare function to sort the latency.
+ */
+static gint
+_compare_latency (gconstpointer a, gconstpointer b)
+{
+  gdouble la = *((const gdouble *) a);
+  gdouble lb = *((const gdouble *) b);
+
+  return (la > lb) ? 1 : ((la < lb) ? -1 : 0);
+}
+
+/**
+ * @brief Get the percentile from the sorted latency array.
+ */
+static gdouble
+_percentile (GArray * sorted, gdouble p)
+{
+  guint idx;
+
+  if (sorted->len == 0)
+    return 0.0;
+
+  idx = (guint) (p / 100.0 * (sorted->len - 1) + 0.5);
+  return g_array_index (sorted, gdouble, MIN (idx, sorted->len - 1));
+}
+
+/**
+ * @brief Function for custom-easy filter, emulates local inference.
+ */
+static int
+ce_offload_local (void *data, const GstTensorFilterProperties *prop,
+    const GstTensorMemory *in, GstTensorMemory *out)
+{
+  guint delay = (guint) g_atomic_int_get (&local_delay_ms);
+
+  if (delay > 0)
+    g_usleep (delay * 1000);
+
+  memset (out[0].data, 0, out[0].size);
+  return 0;
+}
+
+/**
+ * @brief Function for custom-easy filter, emulates the network round-trip and the server inference.
+ */
+static int
+ce_offload_server (void *data, const GstTensorFilterProperties *prop,
+    const GstTensorMemory *in, GstTensorMemory *out)
+{
+  guint delay = (guint) g_atomic_int_get (&remote_delay_ms);
+
+  if (delay > 0)
+    g_usleep (delay * 1000);
+
+  memset (out[0].data, 0, out[0].size);
+  return 0;
+}
+
+/**
+ * @brief Get the expected latency of the path. Called with the lock.
+ * @return the latency in ms, negative if unknown
+ */
+static gdouble
+_expected_latency (OffloadState * state, OffloadPath path, gint64 now)
+{
+  FrameStamp *oldest;
+  gdouble waiting;
+
+  oldest = (FrameStamp *) g_queue_peek_head (&state->pending[path]);
+  if (oldest == NULL)
+    return state->est_ms[path];
+
+  /* the path is slower than the average if the oldest frame is still waiting */
+  waiting = (now - oldest->time) / 1000.0;
+  return MAX (state->est_ms[path], waiting);
+}
+
+/**
+ * @brief Choose the path of the frame. Called with the lock.
+ */
+static OffloadPath
+_choose_path (OffloadState * state)
+{
+  gdouble local, remote;
+  OffloadPath best, other;
+  gint64 now;
+  guint p;
+
+  if (state->policy == POLICY_LOCAL)
+    return PATH_LOCAL;
+  if (state->policy == POLICY_REMOTE)
+    return PATH_REMOTE;
+
+  /* try the path without the latency first */
+  for (p = 0; p < PATH_NUM; p++) {
+    if (state->est_ms[p] < 0.0 && g_queue_is_empty (&state->pending[p]))
+      return (OffloadPath) p;
+  }
+
+  now = g_get_monotonic_time ();
+  local = _expected_latency (state, PATH_LOCAL, now);
+  remote = _expected_latency (state, PATH_REMOTE, now);
+
+  /* wait for the first result of a path */
+  if (local < 0.0)
+    return PATH_REMOTE;
+  if (remote < 0.0)
+    return PATH_LOCAL;
+
+  if (state->policy == POLICY_DEADLINE) {
+    if (local <= state->deadline_ms)
+      best = PATH_LOCAL;
+    else if (remote <= state->deadline_ms)
+      best = PATH_REMOTE;
+    else
+      best = (remote < local) ? PATH_REMOTE : PATH_LOCAL;
+  } else {
+    best = (remote < local) ? PATH_REMOTE : PATH_LOCAL;
+  }
+
+  /* probe the other path not to keep the old latency */
+  other = (best == PATH_LOCAL) ? PATH_REMOTE : PATH_LOCAL;
+  if (state->probe_interval > 0 && ++state->since_probe >= state->probe_interval &&
+      g_queue_is_empty (&state->pending[other])) {
+    state->since_probe = 0;
+    return other;
+  }
+
+  return best;
+}
+
+/**
+ * @brief Custom condition of tensor_if, TRUE to offload the frame.
+ */
+static gboolean
+_offload_policy_cb (const GstTensorsInfo * info, const GstTensorMemory * input,
+    void *user_data, gboolean * result)
+{
+  OffloadState *state = (OffloadState *) user_data;
+  OffloadPath path;
+
+  g_mutex_lock (&state->lock);
+  path = _choose_path (state);
+  g_mutex_unlock (&state->lock);
+
+  *result = (path == PATH_REMOTE);
+  return TRUE;
+}
+
+/**
+ * @brief Pad probe at the queue of the path, the frame enters the path.
+ */
+static GstPadProbeReturn
+_path_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  PathData *pdata = (PathData *) user_data;
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  FrameStamp *stamp;
+
+  stamp = g_new0 (FrameStamp, 1);
+  stamp->pts = GST_BUFFER_PTS (buffer);
+  stamp->time = g_get_monotonic_time ();
+
+  g_mutex_lock (&pdata->state->lock);
+  g_queue_push_tail (&pdata->state->pending[pdata->path], stamp);
+  g_mutex_unlock (&pdata->state->lock);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Callback for tensor sink signal, the result of the path.
+ */
+static void
+_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  PathData *pdata = (PathData *) user_data;
+  OffloadState *state = pdata->state;
+  GQueue *pending = &state->pending[pdata->path];
+  GstClockTime pts = GST_BUFFER_PTS (buffer);
+  FrameStamp *stamp;
+  gdouble latency;
+  GList *l;
+
+  g_mutex_lock (&state->lock);
+
+  /**
+   * The frames before the one with the same timestamp are dropped in the path.
+   * If the path does not keep the timestamp, the result is the oldest frame.
+   */
+  for (l = pending->head; l && GST_CLOCK_TIME_IS_VALID (pts); l = l->next) {
+    if (((FrameStamp *) l->data)->pts == pts) {
+      while (pending->head != l) {
+        g_free (g_queue_pop_head (pending));
+        state->dropped++;
+      }
+      break;
+    }
+  }
+
+  stamp = (FrameStamp *) g_queue_pop_head (pending);
+  if (stamp) {
+    latency = (g_get_monotonic_time () - stamp->time) / 1000.0;
+    g_free (stamp);
+
+    if (state->est_ms[pdata->path] < 0.0)
+      state->est_ms[pdata->path] = latency;
+    else
+      state->est_ms[pdata->path] += state->alpha * (latency - state->est_ms[pdata->path]);
+
+    state->frames[pdata->path]++;
+    g_array_append_val (state->latency, latency);
+  }
+
+  g_mutex_unlock (&state->lock);
+}
+
+/**
+ * @brief Initialize the state of the policy.
+ */
+static void
+_state_init (OffloadState * state, OffloadOptions * opt, OffloadPolicy policy)
+{
+  guint p;
+
+  memset (state, 0, sizeof (OffloadState));
+  g_mutex_init (&state->lock);
+  state->policy = policy;
+  state->deadline_ms = opt->deadline_ms;
+  state->alpha = opt->alpha;
+  state->probe_interval = opt->probe_interval;
+  state->latency = g_array_new (FALSE, FALSE, sizeof (gdouble));
+
+  for (p = 0; p < PATH_NUM; p++) {
+    state->est_ms[p] = -1.0;
+    g_queue_init (&state->pending[p]);
+  }
+}
+
+/**
+ * @brief Free the data in the state.
+ */
+static void
+_state_clear (OffloadState * state)
+{
+  guint p;
+
+  for (p = 0; p < PATH_NUM; p++)
+    g_queue_clear_full (&state->pending[p], g_free);
+
+  g_array_free (state->latency, TRUE);
+  g_mutex_clear (&state->lock);
+}
+
+/**
+ * @brief Print the CSV header.
+ */
+static void
+_print_csv_header (void)
+{
+  g_print ("policy,phase,local_delay_ms,remote_delay_ms,frames,remote_pct,lat_mean_ms,"
+      "lat_p50_ms,lat_p90_ms,est_local_ms,est_remote_ms,dropped\n");
+}
+
+/**
+ * @brief Print the statistics of the phase as CSV and reset them. The estimates are kept.
+ */
+static void
+_print_phase (OffloadState * state, const gchar * phase)
+{
+  guint64 frames;
+  gdouble mean = 0.0;
+  guint i;
+
+  g_mutex_lock (&state->lock);
+
+  frames = state->frames[PATH_LOCAL] + state->frames[PATH_REMOTE];
+  for (i = 0; i < state->latency->len; i++)
+    mean += g_array_index (state->latency, gdouble, i);
+  if (state->latency->len > 0)
+    mean /= state->latency->len;
+  g_array_sort (state->latency, _compare_latency);
+
+  g_print ("%s,%s,%d,%d,%" G_GUINT64_FORMAT ",%.1f,%.2f,%.2f,%.2f,%.2f,%.2f,%"
+      G_GUINT64_FORMAT "\n", policy_names[state->policy], phase,
+      g_atomic_int_get (&local_delay_ms), g_atomic_int_get (&remote_delay_ms), frames,
+      frames ? state->frames[PATH_REMOTE] * 100.0 / frames : 0.0, mean,
+      _percentile (state->latency, 50.0), _percentile (state->latency, 90.0),
+      state->est_ms[PATH_LOCAL], state->est_ms[PATH_REMOTE], state->dropped);
+
+  state->frames[PATH_LOCAL] = state->frames[PATH_REMOTE] = 0;
+  state->dropped = 0;
+  g_array_set_size (state->latency, 0);
+
+  g_mutex_unlock (&state->lock);
+}
+
+/**
+ * @brief Stop and release the pipeline.
+ */
+static void
+_stop_pipeline (GstElement * pipeline)
+{
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  g_usleep (200 * 1000);
+
+  gst_element_set_state (pipeline, GST_STATE_READY);
+  g_usleep (200 * 1000);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  g_usleep (200 * 1000);
+
+  gst_object_unref (pipeline);
+}
+
+/**
+ * @brief Create the edge server of the test, same as nnstreamer_example_inference_offloading_edge.
+ */
+static GstElement *
+_start_server (OffloadOptions * opt)
+{
+  GstElement *pipeline;
+  gchar *str_pipeline;
+
+  str_pipeline = g_strdup_printf
+      ("tensor_query_serversrc host=%s port=%u ! video/x-raw,width=224,height=224,format=RGB,framerate=0/1 ! "
+      "tensor_converter ! tensor_filter framework=custom-easy model=offload_server ! "
+      "tensor_query_serversink async=false", opt->host, opt->port);
+  _print_log ("%s", str_pipeline);
+
+  pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  if (!pipeline)
+    return NULL;
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  return pipeline;
+}
+
+/**
+ * @brief Connect the probe and the sink callback of the path.
+ */
+static void
+_connect_path (GstElement * pipeline, const gchar * queue_name,
+    const gchar * sink_name, PathData * pdata)
+{
+  GstElement *element;
+  GstPad *pad;
+
+  element = gst_bin_get_by_name (GST_BIN (pipeline), queue_name);
+  pad = gst_element_get_static_pad (element, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, _path_probe_cb, pdata, NULL);
+  gst_object_unref (pad);
+  gst_object_unref (element);
+
+  element = gst_bin_get_by_name (GST_BIN (pipeline), sink_name);
+  g_signal_connect (element, "new-data", (GCallback) _new_data_cb, pdata);
+  gst_object_unref (element);
+}
+
+/**
+ * @brief Create and start the client pipeline.
+ */
+static GstElement *
+_start_client (OffloadOptions * opt, PathData * pdata)
+{
+  GstElement *pipeline;
+  gchar *str_pipeline, *local_filter;
+
+  if (opt->model)
+    local_filter = g_strdup_printf ("tensor_filter framework=%s model=%s",
+        opt->framework, opt->model);
+  else
+    local_filter = g_strdup ("tensor_filter framework=custom-easy model=offload_local");
+
+  /* tensor_query_client sends video to the edge server, same as the leaf_pipe example */
+  str_pipeline = g_strdup_printf
+      ("videotestsrc is-live=true ! videoconvert ! videoscale ! "
+      "video/x-raw,width=224,height=224,format=RGB,framerate=%u/1 ! tensor_converter ! "
+      "tensor_if name=tif compared-value=CUSTOM compared-value-option=offload_policy "
+      "then=PASSTHROUGH else=PASSTHROUGH "
+      "tif.src_0 ! queue name=q_remote ! tensor_decoder mode=direct_video ! "
+      "video/x-raw,width=224,height=224,format=RGB ! "
+      "tensor_query_client host=%s port=0 dest-host=%s dest-port=%u ! "
+      "tensor_sink name=remote_sink sync=false "
+      "tif.src_1 ! queue name=q_local ! %s ! tensor_sink name=local_sink sync=false",
+      opt->framerate, opt->client_host, opt->host, opt->port, local_filter);
+  g_free (local_filter);
+  _print_log ("%s", str_pipeline);
+
+  pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  if (!pipeline)
+    return NULL;
+
+  _connect_path (pipeline, "q_local", "local_sink", &pdata[PATH_LOCAL]);
+  _connect_path (pipeline, "q_remote", "remote_sink", &pdata[PATH_REMOTE]);
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  return pipeline;
+}
+
+/**
+ * @brief Run the client with the policy, and print the statistics of each phase.
+ * @param phases local_ms:remote_ms of each phase, NULL to run for the duration
+ */
+static void
+_run_policy (OffloadOptions * opt, OffloadPolicy policy, gchar ** phases)
+{
+  OffloadState state;
+  PathData pdata[PATH_NUM];
+  GstElement *pipeline;
+  gchar **delays, *phase;
+  guint i;
+
+  _state_init (&state, opt, policy);
+  pdata[PATH_LOCAL].state = pdata[PATH_REMOTE].state = &state;
+  pdata[PATH_LOCAL].path = PATH_LOCAL;
+  pdata[PATH_REMOTE].path = PATH_REMOTE;
+
+  nnstreamer_if_custom_register ("offload_policy", _offload_policy_cb, &state);
+
+  pipeline = _start_client (opt, pdata);
+  if (!pipeline) {
+    g_critical ("Failed to create the client pipeline.");
+    goto done;
+  }
+
+  if (phases) {
+    for (i = 0; phases[i]; i++) {
+      delays = g_strsplit (phases[i], ":", 2);
+      g_atomic_int_set (&local_delay_ms, (gint) g_ascii_strtoll (delays[0], NULL, 10));
+      if (delays[1])
+        g_atomic_int_set (&remote_delay_ms, (gint) g_ascii_strtoll (delays[1], NULL, 10));
+      g_strfreev (delays);
+
+      g_usleep ((guint64) opt->phase_sec * G_USEC_PER_SEC);
+
+      phase = g_strdup_printf ("%u", i);
+      _print_phase (&state, phase);
+      g_free (phase);
+    }
+  } else {
+    for (i = 0; i < opt->duration; i++) {
+      g_usleep (G_USEC_PER_SEC);
+
+      phase = g_strdup_printf ("%us", i + 1);
+      _print_phase (&state, phase);
+      g_free (phase);
+    }
+  }
+
+  _stop_pipeline (pipeline);
+
+done:
+  nnstreamer_if_custom_unregister ("offload_policy");
+  _state_clear (&state);
+}
+
+/**
+ * @brief Function for getting options
+ * @return FALSE if the usage is printed
+ */
+static gboolean
+_get_option (int argc, char **argv, OffloadOptions * opt)
+{
+  gint ch;
+  struct option long_options[] = {
+      { "host", required_argument,  NULL, 'h' },
+      { "port", required_argument,  NULL, 'p' },
+      { "client_host", required_argument,  NULL, 'c' },
+      { "framework", required_argument,  NULL, 'f' },
+      { "model", required_argument,  NULL, 'm' },
+      { "local-ms", required_argument,  NULL, 'l' },
+      { "policy", required_argument,  NULL, 'P' },
+      { "deadline-ms", required_argument,  NULL, 'D' },
+      { "alpha", required_argument,  NULL, 'a' },
+      { "probe-interval", required_argument,  NULL, 'i' },
+      { "framerate", required_argument,  NULL, 'r' },
+      { "duration", required_argument,  NULL, 'd' },
+      { "test", no_argument,  NULL, 'T' },
+      { "schedule", required_argument,  NULL, 's' },
+      { "phase-sec", required_argument,  NULL, 'S' },
+      { "policies", required_argument,  NULL, 'L' },
+      { "help", no_argument,  NULL, '?' },
+      { 0, 0, 0, 0}
+  };
+  gchar *optstring = "h:p:c:f:m:d:";
+
+  memset (opt, 0, sizeof (OffloadOptions));
+  opt->host = g_strdup ("localhost");
+  opt->port = 5001;
+  opt->client_host = g_strdup ("localhost");
+  opt->framework = g_strdup ("tensorflow-lite");
+  opt->local_ms = 20;
+  opt->policy = POLICY_LATENCY;
+  opt->deadline_ms = 50.0;
+  opt->alpha = 0.2;
+  opt->probe_interval = 10;
+  opt->framerate = 10;
+  opt->duration = 10;
+  opt->schedule = g_strdup ("30:10,30:60,30:10");
+  opt->phase_sec = 5;
+  opt->policies = g_strdup ("local,remote,latency");
+
+  while ((ch = getopt_long (argc, argv, optstring, long_options, NULL)) != -1) {
+    switch (ch) {
+      case 'h':
+        g_free (opt->host);
+        opt->host = g_strdup (optarg);
+        break;
+      case 'p':
+        opt->port = (guint16) g_ascii_strtoll (optarg, NULL, 10);
+        break;
+      case 'c':
+        g_free (opt->client_host);
+        opt->client_host = g_strdup (optarg);
+        break;
+      case 'f':
+        g_free (opt->framework);
+        opt->framework = g_strdup (optarg);
+        break;
+      case 'm':
+        g_free (opt->model);
+        opt->model = g_strdup (optarg);
+        break;
+      case 'l':
+        opt->local_ms = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'P':
+        opt->policy = _get_policy (optarg);
+        break;
+      case 'D':
+        opt->deadline_ms = g_ascii_strtod (optarg, NULL);
+        break;
+      case 'a':
+        opt->alpha = CLAMP (g_ascii_strtod (optarg, NULL), 0.01, 1.0);
+        break;
+      case 'i':
+        opt->probe_interval = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'r':
+        opt->framerate = MAX (1U, (guint) g_ascii_strtoull (optarg, NULL, 10));
+        break;
+      case 'd':
+        opt->duration = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'T':
+        opt->test = TRUE;
+        break;
+      case 's':
+        g_free (opt->schedule);
+        opt->schedule = g_strdup (optarg);
+        break;
+      case 'S':
+        opt->phase_sec = MAX (1U, (guint) g_ascii_strtoull (optarg, NULL, 10));
+        break;
+      case 'L':
+        g_free (opt->policies);
+        opt->policies = g_strdup (optarg);
+        break;
+      default:
+        _usage ();
+        return FALSE;
+    }
+  }
+
+  if (opt->policy == POLICY_UNKNOWN) {
+    _usage ();
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  OffloadOptions opt;
+  GstElement *server = NULL;
+  GstTensorsInfo info_in, info_out;
+  gchar **phases = NULL, **policies = NULL;
+  OffloadPolicy policy;
+  guint i;
+
+  /* init gstreamer */
+  gst_init (&argc, &argv);
+
+  if (!_get_option (argc, argv, &opt))
+    goto done;
+
+  /* same tensors as the edge server example */
+  gst_tensors_info_init (&info_in);
+  gst_tensors_info_init (&info_out);
+  info_in.num_tensors = 1U;
+  info_in.info[0].type = _NNS_UINT8;
+  gst_tensor_parse_dimension ("3:224:224:1", info_in.info[0].dimension);
+  info_out.num_tensors = 1U;
+  info_out.info[0].type = _NNS_UINT8;
+  gst_tensor_parse_dimension ("10:10:1:1", info_out.info[0].dimension);
+
+  NNS_custom_easy_register ("offload_local", ce_offload_local, NULL, &info_in, &info_out);
+  NNS_custom_easy_register ("offload_server", ce_offload_server, NULL, &info_in, &info_out);
+  g_atomic_int_set (&local_delay_ms, (gint) opt.local_ms);
+
+  _print_csv_header ();
+
+  if (opt.test) {
+    phases = g_strsplit (opt.schedule, ",", -1);
+    policies = g_strsplit (opt.policies, ",", -1);
+
+    server = _start_server (&opt);
+    if (!server) {
+      g_critical ("Failed to create the edge server pipeline.");
+      goto unregister;
+    }
+    /* wait for the server to listen */
+    g_usleep (1000 * 1000);
+
+    for (i = 0; policies[i]; i++) {
+      policy = _get_policy (g_strstrip (policies[i]));
+      if (policy == POLICY_UNKNOWN) {
+        g_critical ("Unknown policy %s", policies[i]);
+        continue;
+      }
+      _run_policy (&opt, policy, phases);
+    }
+
+    _stop_pipeline (server);
+  } else {
+    _run_policy (&opt, opt.policy, NULL);
+  }
+
+unregister:
+  NNS_custom_easy_unregister ("offload_local");
+  NNS_custom_easy_unregister ("offload_server");
+
+done:
+  g_strfreev (phases);
+  g_strfreev (policies);
+  g_free (opt.host);
+  g_free (opt.client_host);
+  g_free (opt.framework);
+  g_free (opt.model);
+  g_free (opt.schedule);
+  g_free (opt.policies);
+
+  return 0;
+}
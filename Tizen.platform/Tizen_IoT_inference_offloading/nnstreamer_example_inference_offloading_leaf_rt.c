@@ -1,21 +1,73 @@
 /**
  * @file	nnstreamer_example_inference_offloading_leaf_rt.c
  * @date	16 Mar 2023
- * @brief	Leaf program requesting inference to edge server.
+ * @brief	Leaf program requesting inference to edge server, and load generator for the query server.
  * @see	https://github.com/nnstreamer/nnstreamer
  * @author	 <gichan2.jang@samsung.com>
  * @bug		No known bugs.
  */
+/**
+ * @note The program sends requests with nns_edge_* functions only (no GStreamer),
+ * so the result shows the capacity of the transport and the server without tensor_query_client.
+ *
+ * Open-loop (--rate): the requests are scheduled at the given rate whether or not the replies arrive.
+ * The latency is measured from the send time, and the corrected latency from the scheduled time.
+ * When the sender falls behind (--max-inflight or a slow send), the corrected latency includes
+ * the time the request waited to be sent (coordinated omission).
+ * Closed-loop (--concurrency): the given number of requests are in flight,
+ * a new request is sent when a reply arrives.
+ *
+ * The sequence number of the request is set in the data info ("seq") and at the beginning
+ * of the payload. A reply is matched by the sequence number when the server returns either of them
+ * (e.g., a custom-easy filter copying the input), otherwise in the order of the requests.
+ * A request without a reply in --timeout is counted as lost.
+ * Matching by order skips the lost requests, so a dropped request does not shift the following replies.
+ * A reply arriving after its request is lost cannot be told from the reply of the next request
+ * without the sequence number, use a server echoing it for exact matching with late replies.
+ *
+ * Result is printed as CSV:
+ * mode,payload_bytes,target_rps,concurrency,sent,received,lost,unmatched,send_failed,throughput_rps,
+ * lat_mean_us,lat_p50_us,lat_p90_us,lat_p99_us,lat_p999_us,lat_max_us,
+ * co_p50_us,co_p90_us,co_p99_us,co_max_us,by_seq,by_order
+ *
+ * Run example :
+ * $ ./performance_benchmark_query --server -t 60 --width=224 --height=224
+ * $ ./nnstreamer_example_inference_offloading_leaf_rt --connecttype=TCP --nodetype=QUERY --destport=5001 --rate=200 --duration=10
+ * $ ./nnstreamer_example_inference_offloading_leaf_rt --connecttype=TCP --nodetype=QUERY --destport=5001 --concurrency=4 --duration=10
+ */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
 #include "nnstreamer-edge.h"
 #include <getopt.h>
 #include <string.h>
 
+/**
+ * @brief The number of requests in the ring, max requests in flight.
+ */
+#define REQ_RING_SIZE 65536U
+
+/**
+ * @brief Magic number of the payload header.
+ */
+#define PAYLOAD_MAGIC 0x4e4e5152U
 
-unsigned int received;
+/**
+ * @brief Header at the beginning of each payload.
+ */
+typedef struct
+{
+  uint32_t magic; /**< PAYLOAD_MAGIC */
+  uint32_t reserved;
+  uint64_t seq; /**< sequence number of the request */
+} payload_header_s;
 
 /**
  * @brief Data struct for options.
@@ -29,19 +81,218 @@ typedef struct
   unsigned int dest_port;
   nns_edge_connect_type_e conn_type;
   nns_edge_node_type_e node_type;
+  unsigned int rate; /**< requests per second (open-loop) */
+  unsigned int concurrency; /**< requests in flight (closed-loop), 0 for open-loop */
+  unsigned int max_inflight; /**< max requests in flight in open-loop, 0 for no limit */
+  unsigned int count; /**< the number of requests, 0 to run for duration */
+  unsigned int duration; /**< running time in sec */
+  unsigned int warmup; /**< the number of requests not measured */
+  unsigned int size; /**< payload size in bytes */
+  unsigned int timeout_ms; /**< time to wait for a reply */
+  char *output; /**< CSV file to append the result */
 } opt_data_s;
 
+/**
+ * @brief A request in flight.
+ */
+typedef struct
+{
+  int64_t intended; /**< scheduled send time (usec) */
+  int64_t sent; /**< send time (usec) */
+  bool pending; /**< waiting for the reply */
+} request_s;
+
+/**
+ * @brief Array of latency.
+ */
+typedef struct
+{
+  int64_t *values;
+  size_t len;
+  size_t alloc;
+} latency_array_s;
+
+/**
+ * @brief Statistics of the load generator.
+ */
+typedef struct
+{
+  pthread_mutex_t lock;
+  pthread_cond_t cond; /**< signaled when a reply arrives */
+  bool expect_reply; /**< false for the publisher */
+  request_s *reqs; /**< ring of requests, index is seq % REQ_RING_SIZE */
+  uint64_t next_seq; /**< sequence number of the next request */
+  uint64_t oldest; /**< the oldest sequence number which may be pending */
+  unsigned int inflight; /**< the number of pending requests */
+  uint64_t warmup; /**< requests with sequence number less than this are not measured */
+  uint64_t sent;
+  uint64_t received;
+  uint64_t lost; /**< no reply in timeout */
+  uint64_t unmatched; /**< replies without pending request */
+  uint64_t send_failed;
+  uint64_t by_seq; /**< replies matched by the sequence number */
+  uint64_t by_order; /**< replies matched in the order of requests */
+  int64_t measure_start; /**< send time of the first measured request */
+  int64_t last_reply; /**< receive time of the last measured reply */
+  latency_array_s latency; /**< latency from the send time */
+  latency_array_s corrected; /**< latency from the scheduled time */
+} load_stats_s;
+
+/**
+ * @brief Get the monotonic time in usec.
+ */
+static int64_t
+_now_us (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief Sleep until the given monotonic time in usec.
+ */
+static void
+_sleep_until (int64_t time_us)
+{
+  struct timespec ts;
+
+  ts.tv_sec = time_us / 1000000;
+  ts.tv_nsec = (time_us % 1000000) * 1000;
+  while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+}
+
+/**
+ * @brief Get the absolute time to wait for the condition.
+ */
+static void
+_get_abstime (int64_t time_us, struct timespec *ts)
+{
+  ts->tv_sec = time_us / 1000000;
+  ts->tv_nsec = (time_us % 1000000) * 1000;
+}
+
+/**
+ * @brief Append the latency to the array.
+ */
+static void
+_latency_add (latency_array_s * arr, int64_t value)
+{
+  int64_t *values;
+
+  if (arr->len == arr->alloc) {
+    arr->alloc = arr->alloc ? arr->alloc * 2 : 4096;
+    values = (int64_t *) realloc (arr->values, arr->alloc * sizeof (int64_t));
+    if (!values)
+      return;
+    arr->values = values;
+  }
+
+  arr->values[arr->len++] = value;
+}
+
+/**
+ * @brief Compare function to sort the latency.
+ */
+static int
+_compare_latency (const void *a, const void *b)
+{
+  int64_t la = *((const int64_t *) a);
+  int64_t lb = *((const int64_t *) b);
+
+  return (la > lb) - (la < lb);
+}
+
+/**
+ * @brief Get the percentile from the sorted array.
+ */
+static int64_t
+_percentile (latency_array_s * arr, double p)
+{
+  size_t idx;
+
+  if (arr->len == 0)
+    return 0;
+
+  idx = (size_t) (p / 100.0 * (arr->len - 1) + 0.5);
+  return arr->values[idx < arr->len ? idx : arr->len - 1];
+}
+
+/**
+ * @brief Move the oldest sequence number to the first pending request. Called with the lock.
+ */
+static void
+_advance_oldest (load_stats_s * stats)
+{
+  while (stats->oldest < stats->next_seq &&
+      !stats->reqs[stats->oldest % REQ_RING_SIZE].pending)
+    stats->oldest++;
+}
+
+/**
+ * @brief Count the requests without reply in timeout as lost. Called with the lock.
+ */
+static void
+_expire_requests (load_stats_s * stats, int64_t now, int64_t timeout_us)
+{
+  request_s *req;
+
+  _advance_oldest (stats);
+  while (stats->oldest < stats->next_seq) {
+    req = &stats->reqs[stats->oldest % REQ_RING_SIZE];
+    if (req->sent + timeout_us > now)
+      break;
+
+    req->pending = false;
+    stats->inflight--;
+    stats->lost++;
+    _advance_oldest (stats);
+  }
+}
+
+/**
+ * @brief Get the sequence number of the reply from the data info or the payload header.
+ */
+static bool
+_get_reply_seq (nns_edge_data_h data_h, uint64_t * seq)
+{
+  payload_header_s header;
+  char *value = NULL;
+  void *data;
+  nns_size_t data_len;
+
+  if (NNS_EDGE_ERROR_NONE == nns_edge_data_get_info (data_h, "seq", &value) && value) {
+    *seq = strtoull (value, NULL, 10);
+    free (value);
+    return true;
+  }
+
+  if (NNS_EDGE_ERROR_NONE == nns_edge_data_get (data_h, 0, &data, &data_len) &&
+      data_len >= sizeof (payload_header_s)) {
+    memcpy (&header, data, sizeof (payload_header_s));
+    if (header.magic == PAYLOAD_MAGIC) {
+      *seq = header.seq;
+      return true;
+    }
+  }
+
+  return false;
+}
+
 /**
  * @brief Edge event callback.
  */
 static int
 _query_client_event_cb (nns_edge_event_h event_h, void *user_data)
 {
+  load_stats_s *stats = (load_stats_s *) user_data;
   nns_edge_event_e event = NNS_EDGE_EVENT_UNKNOWN;
   nns_edge_data_h data_h;
-  void *data;
-  nns_size_t data_len;
-  unsigned int count;
+  request_s *req;
+  uint64_t seq;
+  bool has_seq;
+  int64_t now;
   int ret;
 
   ret = nns_edge_event_get_type (event_h, &event);
@@ -50,15 +301,46 @@ _query_client_event_cb (nns_edge_event_h event_h, void *user_data)
 
   switch (event) {
     case NNS_EDGE_EVENT_NEW_DATA_RECEIVED:
-      received++;
-
-      nns_edge_event_parse_new_data (event_h, &data_h);
+      now = _now_us ();
 
-      nns_edge_data_get_count (data_h, &count);
-      nns_edge_data_get (data_h, 0, &data, &data_len);
+      if (NNS_EDGE_ERROR_NONE != nns_edge_event_parse_new_data (event_h, &data_h))
+        break;
+      has_seq = _get_reply_seq (data_h, &seq);
       nns_edge_data_destroy (data_h);
-      printf ("[DEBUG] New data received. the number of mem: %u, size: %u \n",
-          count, (unsigned int) data_len);
+
+      pthread_mutex_lock (&stats->lock);
+      stats->received++;
+
+      /**
+       * The query server replies to a client in the order of requests.
+       * The cursor is the oldest pending request, the expired requests are skipped.
+       * The reply without pending request (all requests expired) is unmatched.
+       */
+      if (!has_seq) {
+        _advance_oldest (stats);
+        seq = stats->oldest;
+      }
+
+      req = &stats->reqs[seq % REQ_RING_SIZE];
+      if (seq < stats->oldest || seq >= stats->next_seq || !req->pending) {
+        stats->unmatched++;
+      } else {
+        req->pending = false;
+        stats->inflight--;
+        if (has_seq)
+          stats->by_seq++;
+        else
+          stats->by_order++;
+
+        if (seq >= stats->warmup) {
+          _latency_add (&stats->latency, now - req->sent);
+          _latency_add (&stats->corrected, now - req->intended);
+          stats->last_reply = now;
+        }
+      }
+
+      pthread_cond_signal (&stats->cond);
+      pthread_mutex_unlock (&stats->lock);
       break;
     default:
       break;
@@ -109,9 +391,38 @@ _get_node_type (char *arg)
 }
 
 /**
- * @brief Function for getting options
+ * @brief Print usage info
  */
 static void
+_usage (void)
+{
+  printf ("usage: nnstreamer_example_inference_offloading_leaf_rt [options]\n"
+      "  --host         Set host address. (default localhost)\n"
+      "  --port         Set port of the publisher.\n"
+      "  --topic        Set topic.\n"
+      "  --connecttype  Set connection type. (TCP, HYBRID, MQTT, AITT)\n"
+      "  --desthost     Set query server or broker host address. (default localhost)\n"
+      "  --destport     Set query server or broker port. (default 5001)\n"
+      "  --nodetype     Set node type. (QUERY, PUB)\n"
+      "  --rate         Open-loop, set requests per second. (default 10)\n"
+      "  --concurrency  Closed-loop, set the number of requests in flight.\n"
+      "  --max-inflight Set max requests in flight in open-loop. (default no limit)\n"
+      "  --count        Set the number of requests. (default 50 without --duration)\n"
+      "  --duration     Set the running time in sec.\n"
+      "  --warmup       Set the number of requests not measured. (default 0)\n"
+      "  --size         Set the payload size in bytes. (default 3 * 224 * 224)\n"
+      "  --timeout      Set the time to wait for a reply in ms. (default 5000)\n"
+      "                 Replies are matched by the sequence number if the server echoes it,\n"
+      "                 otherwise by order. By order, a late reply of a lost request is\n"
+      "                 matched to the next request, the server should echo for exact latency.\n"
+      "  --output       Append CSV result to the file.\n");
+}
+
+/**
+ * @brief Function for getting options
+ * @return false if the usage is printed.
+ */
+static bool
 _get_option (int argc, char **argv, opt_data_s *opt_data)
 {
   int opt;
@@ -123,9 +434,19 @@ _get_option (int argc, char **argv, opt_data_s *opt_data)
       { "desthost", required_argument,  NULL, 'b' },
       { "destport", required_argument,  NULL, 'd' },
       { "nodetype", required_argument,  NULL, 'n' },
+      { "rate", required_argument,  NULL, 'r' },
+      { "concurrency", required_argument,  NULL, 'C' },
+      { "max-inflight", required_argument,  NULL, 'M' },
+      { "count", required_argument,  NULL, 'N' },
+      { "duration", required_argument,  NULL, 'D' },
+      { "warmup", required_argument,  NULL, 'W' },
+      { "size", required_argument,  NULL, 's' },
+      { "timeout", required_argument,  NULL, 'T' },
+      { "output", required_argument,  NULL, 'o' },
+      { "help", no_argument,  NULL, '?' },
       { 0, 0, 0, 0}
   };
-  char *optstring = "h:p:t:c:n:b:d:";
+  char *optstring = "h:p:t:c:n:b:d:r:s:o:";
 
   opt_data->host = strdup ("localhost");
   opt_data->port = 0;
@@ -134,6 +455,15 @@ _get_option (int argc, char **argv, opt_data_s *opt_data)
   opt_data->dest_port = 5001;
   opt_data->conn_type = NNS_EDGE_CONNECT_TYPE_UNKNOWN;
   opt_data->node_type = NNS_EDGE_NODE_TYPE_UNKNOWN;
+  opt_data->rate = 10;
+  opt_data->concurrency = 0;
+  opt_data->max_inflight = 0;
+  opt_data->count = 0;
+  opt_data->duration = 0;
+  opt_data->warmup = 0;
+  opt_data->size = 3 * 224 * 224;
+  opt_data->timeout_ms = 5000;
+  opt_data->output = NULL;
 
   while ((opt = getopt_long (argc, argv, optstring, long_options, NULL)) != -1) {
     switch (opt) {
@@ -160,24 +490,66 @@ _get_option (int argc, char **argv, opt_data_s *opt_data)
       case 'n':
         opt_data->node_type = _get_node_type (optarg);
         break;
-      default:
+      case 'r':
+        opt_data->rate = (uint) strtoul (optarg, NULL, 10);
+        break;
+      case 'C':
+        opt_data->concurrency = (uint) strtoul (optarg, NULL, 10);
+        break;
+      case 'M':
+        opt_data->max_inflight = (uint) strtoul (optarg, NULL, 10);
+        break;
+      case 'N':
+        opt_data->count = (uint) strtoul (optarg, NULL, 10);
+        break;
+      case 'D':
+        opt_data->duration = (uint) strtoul (optarg, NULL, 10);
+        break;
+      case 'W':
+        opt_data->warmup = (uint) strtoul (optarg, NULL, 10);
+        break;
+      case 's':
+        opt_data->size = (uint) strtoul (optarg, NULL, 10);
+        break;
+      case 'T':
+        opt_data->timeout_ms = (uint) strtoul (optarg, NULL, 10);
         break;
+      case 'o':
+        free (opt_data->output);
+        opt_data->output = strdup (optarg);
+        break;
+      default:
+        _usage ();
+        return false;
     }
   }
+
+  if (opt_data->rate == 0)
+    opt_data->rate = 1;
+  if (opt_data->count == 0 && opt_data->duration == 0)
+    opt_data->count = 50;
+  if (opt_data->concurrency >= REQ_RING_SIZE)
+    opt_data->concurrency = REQ_RING_SIZE - 1;
+  if (opt_data->max_inflight == 0 || opt_data->max_inflight >= REQ_RING_SIZE)
+    opt_data->max_inflight = REQ_RING_SIZE - 1;
+  if (opt_data->timeout_ms == 0)
+    opt_data->timeout_ms = 5000;
+
+  return true;
 }
 
 /**
  * @brief Prepare edge data to send
  */
 static int
-_prepare_edge_data (nns_edge_data_h *data_h)
+_prepare_edge_data (nns_edge_data_h *data_h, unsigned int size, void **payload)
 {
   nns_size_t data_len;
   void *data = NULL;
   int ret = NNS_EDGE_ERROR_NONE;
 
-  data_len = 3 * 224 * 224 * sizeof (char);
-  data = malloc (data_len);
+  data_len = size * sizeof (char);
+  data = calloc (1, data_len);
   if (!data) {
     printf ("Failed to allocate camera data.\n");
     return NNS_EDGE_ERROR_OUT_OF_MEMORY;
@@ -196,32 +568,241 @@ _prepare_edge_data (nns_edge_data_h *data_h)
     free (data);
   }
 
+  *payload = data;
+  return ret;
+}
+
+/**
+ * @brief Wait until the number of requests in flight is less than the limit. Called with the lock.
+ */
+static void
+_wait_inflight (load_stats_s * stats, unsigned int limit, int64_t timeout_us)
+{
+  struct timespec ts;
+  int64_t now = _now_us ();
+
+  _expire_requests (stats, now, timeout_us);
+  while (stats->inflight >= limit) {
+    /* wake up when the oldest request is expired */
+    _get_abstime (stats->reqs[stats->oldest % REQ_RING_SIZE].sent + timeout_us, &ts);
+    pthread_cond_timedwait (&stats->cond, &stats->lock, &ts);
+
+    now = _now_us ();
+    _expire_requests (stats, now, timeout_us);
+  }
+}
+
+/**
+ * @brief Send a request with the next sequence number.
+ */
+static int
+_send_request (nns_edge_h client_h, nns_edge_data_h data_h, void *payload,
+    unsigned int size, load_stats_s * stats, int64_t intended)
+{
+  payload_header_s header;
+  char seq_str[24];
+  request_s *req;
+  uint64_t seq;
+  int ret;
+
+  pthread_mutex_lock (&stats->lock);
+  seq = stats->next_seq;
+  req = &stats->reqs[seq % REQ_RING_SIZE];
+  if (req->pending) {
+    /* the ring is full of old requests */
+    req->pending = false;
+    stats->inflight--;
+    stats->lost++;
+  }
+  pthread_mutex_unlock (&stats->lock);
+
+  /* nns_edge_send () copies the data, the payload can be updated for the next request */
+  if (size >= sizeof (payload_header_s)) {
+    header.magic = PAYLOAD_MAGIC;
+    header.reserved = 0;
+    header.seq = seq;
+    memcpy (payload, &header, sizeof (payload_header_s));
+  }
+  snprintf (seq_str, sizeof (seq_str), "%" PRIu64, seq);
+  nns_edge_data_set_info (data_h, "seq", seq_str);
+
+  pthread_mutex_lock (&stats->lock);
+  stats->next_seq++;
+  req->intended = intended;
+  req->sent = _now_us ();
+  req->pending = stats->expect_reply;
+  if (req->pending)
+    stats->inflight++;
+  if (seq == stats->warmup)
+    stats->measure_start = req->sent;
+  pthread_mutex_unlock (&stats->lock);
+
+  ret = nns_edge_send (client_h, data_h);
+
+  pthread_mutex_lock (&stats->lock);
+  if (NNS_EDGE_ERROR_NONE == ret) {
+    stats->sent++;
+  } else {
+    stats->send_failed++;
+    if (req->pending) {
+      req->pending = false;
+      stats->inflight--;
+    }
+  }
+  pthread_mutex_unlock (&stats->lock);
+
   return ret;
 }
 
+/**
+ * @brief Send requests in open-loop or closed-loop until the count or duration.
+ */
+static void
+_run_load (nns_edge_h client_h, nns_edge_data_h data_h, void *payload,
+    opt_data_s * opt_data, load_stats_s * stats)
+{
+  int64_t start, end, intended, timeout_us;
+  double interval;
+  uint64_t i, total;
+  unsigned int limit;
+  struct timespec ts;
+
+  timeout_us = (int64_t) opt_data->timeout_ms * 1000;
+  limit = opt_data->concurrency > 0 ? opt_data->concurrency : opt_data->max_inflight;
+  interval = 1000000.0 / opt_data->rate;
+  total = opt_data->count > 0 ? (uint64_t) opt_data->count + opt_data->warmup : UINT64_MAX;
+
+  start = _now_us ();
+  end = opt_data->duration > 0 ? start + (int64_t) opt_data->duration * 1000000 : INT64_MAX;
+
+  for (i = 0; i < total; i++) {
+    if (opt_data->concurrency > 0) {
+      intended = _now_us ();
+    } else {
+      intended = start + (int64_t) (i * interval);
+      if (intended >= end)
+        break;
+      _sleep_until (intended);
+    }
+
+    pthread_mutex_lock (&stats->lock);
+    _wait_inflight (stats, limit, timeout_us);
+    pthread_mutex_unlock (&stats->lock);
+
+    if (_now_us () >= end)
+      break;
+
+    if (opt_data->concurrency > 0)
+      intended = _now_us ();
+    _send_request (client_h, data_h, payload, opt_data->size, stats, intended);
+  }
+
+  /* wait for the replies in flight */
+  pthread_mutex_lock (&stats->lock);
+  _expire_requests (stats, _now_us (), timeout_us);
+  while (stats->inflight > 0) {
+    _get_abstime (stats->reqs[stats->oldest % REQ_RING_SIZE].sent + timeout_us, &ts);
+    pthread_cond_timedwait (&stats->cond, &stats->lock, &ts);
+    _expire_requests (stats, _now_us (), timeout_us);
+  }
+  pthread_mutex_unlock (&stats->lock);
+}
+
+/**
+ * @brief Print the CSV header.
+ */
+static void
+_print_csv_header (FILE * out)
+{
+  fprintf (out, "mode,payload_bytes,target_rps,concurrency,sent,received,lost,"
+      "unmatched,send_failed,throughput_rps,lat_mean_us,lat_p50_us,lat_p90_us,"
+      "lat_p99_us,lat_p999_us,lat_max_us,co_p50_us,co_p90_us,co_p99_us,co_max_us,"
+      "by_seq,by_order\n");
+}
+
+/**
+ * @brief Print the result as CSV. The latency arrays should be sorted.
+ */
+static void
+_print_csv (FILE * out, opt_data_s * opt_data, load_stats_s * stats)
+{
+  double throughput = 0.0, mean = 0.0;
+  int64_t span;
+  size_t i;
+
+  span = stats->last_reply - stats->measure_start;
+  if (stats->latency.len > 0 && span > 0)
+    throughput = stats->latency.len * 1000000.0 / span;
+
+  for (i = 0; i < stats->latency.len; i++)
+    mean += stats->latency.values[i];
+  if (stats->latency.len > 0)
+    mean /= stats->latency.len;
+
+  fprintf (out, "%s,%u,%u,%u,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+      ",%" PRIu64 ",%.1f,%.1f,%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64
+      ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRIu64
+      ",%" PRIu64 "\n",
+      opt_data->concurrency > 0 ? "closed" : "open", opt_data->size,
+      opt_data->concurrency > 0 ? 0 : opt_data->rate, opt_data->concurrency,
+      stats->sent, stats->received, stats->lost, stats->unmatched,
+      stats->send_failed, throughput, mean,
+      _percentile (&stats->latency, 50.0), _percentile (&stats->latency, 90.0),
+      _percentile (&stats->latency, 99.0), _percentile (&stats->latency, 99.9),
+      _percentile (&stats->latency, 100.0),
+      _percentile (&stats->corrected, 50.0), _percentile (&stats->corrected, 90.0),
+      _percentile (&stats->corrected, 99.0), _percentile (&stats->corrected, 100.0),
+      stats->by_seq, stats->by_order);
+  fflush (out);
+}
+
 /**
  * @brief Main function.
  */
 int
 main (int argc, char **argv)
 {
-  nns_edge_h client_h;
-  nns_edge_data_h data_h;
+  nns_edge_h client_h = NULL;
+  nns_edge_data_h data_h = NULL;
+  void *payload = NULL;
   int ret = NNS_EDGE_ERROR_NONE;
-  unsigned int i, retry = 0;
   opt_data_s opt_data;
+  load_stats_s stats;
+  pthread_condattr_t cond_attr;
+  FILE *out;
+  bool exists;
 
   printf ("============== Start app.. ============== \n\n");
 
-  _get_option (argc, argv, &opt_data);
+  memset (&stats, 0, sizeof (load_stats_s));
+  pthread_mutex_init (&stats.lock, NULL);
+  /* the deadline of the wait is the monotonic time (_get_abstime) */
+  pthread_condattr_init (&cond_attr);
+  pthread_condattr_setclock (&cond_attr, CLOCK_MONOTONIC);
+  pthread_cond_init (&stats.cond, &cond_attr);
+  pthread_condattr_destroy (&cond_attr);
+
+  if (!_get_option (argc, argv, &opt_data))
+    goto done;
 
   printf ("[INFO] desthost: %s, destport: %u, topic: %s \n",
       opt_data.dest_host, opt_data.dest_port, opt_data.topic);
 
-  received = 0;
+  stats.expect_reply = (NNS_EDGE_NODE_TYPE_QUERY_CLIENT == opt_data.node_type);
+  stats.warmup = opt_data.warmup;
+  stats.reqs = (request_s *) calloc (REQ_RING_SIZE, sizeof (request_s));
+  if (!stats.reqs) {
+    ret = NNS_EDGE_ERROR_OUT_OF_MEMORY;
+    goto done;
+  }
+
   ret = nns_edge_create_handle ("TEMP_ID", opt_data.conn_type,
       opt_data.node_type, &client_h);
-  nns_edge_set_event_callback (client_h, _query_client_event_cb, NULL);
+  if (NNS_EDGE_ERROR_NONE != ret) {
+    printf ("Failed to create edge handle.\n");
+    goto done;
+  }
+  nns_edge_set_event_callback (client_h, _query_client_event_cb, &stats);
 
   nns_edge_set_info (client_h, "HOST", opt_data.host);
   if (opt_data.topic)
@@ -257,37 +838,50 @@ main (int argc, char **argv)
 
   sleep (1);
 
-  ret = _prepare_edge_data (&data_h);
+  ret = _prepare_edge_data (&data_h, opt_data.size, &payload);
   if (NNS_EDGE_ERROR_NONE != ret) {
     printf ("Failed to prepare to nns edge data.\n");
     goto done;
   }
 
-  received = 0;
-  for (i = 0; i < 50U; i++) {
-    nns_edge_send (client_h, data_h);
-    usleep (100000);
-  }
+  _run_load (client_h, data_h, payload, &opt_data, &stats);
 
-  nns_edge_data_destroy (data_h);
+  printf ("[DEBUG] Total received the number of data: %" PRIu64 "\n", stats.received);
 
-  /* Wait for responding data (20 seconds) */
-  do {
-    usleep (100000);
-    if (received > 0)
-      break;
-  } while (NNS_EDGE_NODE_TYPE_QUERY_CLIENT == opt_data.node_type &&
-        retry++ < 100U);
+  qsort (stats.latency.values, stats.latency.len, sizeof (int64_t), _compare_latency);
+  qsort (stats.corrected.values, stats.corrected.len, sizeof (int64_t), _compare_latency);
+
+  _print_csv_header (stdout);
+  _print_csv (stdout, &opt_data, &stats);
 
-  printf ("[DEBUG] Total received the number of data: %u\n", received);
+  if (opt_data.output) {
+    exists = (access (opt_data.output, F_OK) == 0);
+    out = fopen (opt_data.output, "a");
+    if (out) {
+      if (!exists)
+        _print_csv_header (out);
+      _print_csv (out, &opt_data, &stats);
+      fclose (out);
+    } else {
+      printf ("Failed to open %s\n", opt_data.output);
+    }
+  }
 
 done:
-  nns_edge_release_handle (client_h);
-  nns_edge_data_destroy (data_h);
+  if (client_h)
+    nns_edge_release_handle (client_h);
+  if (data_h)
+    nns_edge_data_destroy (data_h);
+  pthread_mutex_destroy (&stats.lock);
+  pthread_cond_destroy (&stats.cond);
+  free (stats.reqs);
+  free (stats.latency.values);
+  free (stats.corrected.values);
   free (opt_data.dest_host);
   free (opt_data.host);
   if (opt_data.topic)
     free (opt_data.topic);
+  free (opt_data.output);
 
   return ret;
 }
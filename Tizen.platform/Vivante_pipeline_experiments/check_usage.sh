@@ -3,7 +3,10 @@
 ## @file check_usage.sh
 ## @author HyoungJoo Ahn <hello.ahn@samsung.com>
 ## @date 13 May 2020
-## @brief print cpu(real/user/sys) time & memory(peak) usage 
+## @brief print cpu(user/sys) time & memory(peak) usage
+##
+## The process is followed by its PID ($!) and sampled from /proc every 100 ms until it exits.
+## The native examples link native/common/resource_sampler.c to sample themselves.
 ##
 
 if [ -z "$1" ]; then
@@ -30,21 +33,44 @@ else
   SLEEP_TIME=$4
 fi
 
-time vivante-pipeline-experiment $ENABLE_VNN_INCEPTION $ENABLE_VNN_YOLO $ENABLE_TFLITE_INCEPTION $SLEEP_TIME &
-process_id=`/bin/ps -fu $USER| grep "vivante-pipeline-experiment" | grep -v "grep" | awk '{print $2}'`
-
-taskset -cp 2-5 $process_id # set affinity
-end=$((SECONDS+$SLEEP_TIME+1))
+# taskset sets the affinity before the threads are created
+taskset -c 2-5 vivante-pipeline-experiment $ENABLE_VNN_INCEPTION $ENABLE_VNN_YOLO $ENABLE_TFLITE_INCEPTION $SLEEP_TIME &
+process_id=$!
 
-PEAK=0
-MIN=10000000000000
+CLK_TCK=$(getconf CLK_TCK)
+START=$(date +%s.%3N)
+HWM=0
+RSS_SUM=0
 CNT=0
-SUM_MEM=0
+UTIME=0
+STIME=0
+
+while [ -d "/proc/$process_id" ]; do
+  status=$(cat /proc/$process_id/status 2>/dev/null)
+  stat=$(cat /proc/$process_id/stat 2>/dev/null)
+  [ -z "$stat" ] && break
+
+  hwm=$(echo "$status" | awk '/^VmHWM:/{print $2}')
+  rss=$(echo "$status" | awk '/^VmRSS:/{print $2}')
+  [ -n "$hwm" ] && HWM=$hwm
+  if [ -n "$rss" ]; then
+    RSS_SUM=$((RSS_SUM + rss))
+    CNT=$((CNT + 1))
+  fi
+
+  # utime and stime are the fields 14 and 15, counted after the name in parentheses
+  read -ra fields <<< "${stat##*) }"
+  UTIME=${fields[11]}
+  STIME=${fields[12]}
+  sleep 0.1
+done
+wait $process_id
 
-if [ -d "/proc/$process_id" ]; then
-  sleep $SLEEP_TIME
-  output=`grep VmRSS /proc/$process_id/status`
-  IFS=' ' read -ra mem_str <<< "$output"
-  mem_usage=$((${mem_str[1]}))
+END=$(date +%s.%3N)
+echo "real: $(echo "scale=3; $END - $START" | bc) s"
+echo "user: $(echo "scale=3; $UTIME / $CLK_TCK" | bc) s"
+echo "sys: $(echo "scale=3; $STIME / $CLK_TCK" | bc) s"
+echo "Mem Usage (peak): $HWM kB"
+if [ $CNT -gt 0 ]; then
+  echo "Mem Usage (avg): $((RSS_SUM / CNT)) kB"
 fi
-echo "Mem Usage: $mem_usage"
@@ -0,0 +1,65 @@
+#!/usr/bin/env bash
+##
+## @file deploy_bench.sh
+## @brief Compare the model deployment in a buffer and in chunks on localhost.
+##
+## The sender and the receiver run on the same device. It prints the CSV rows of both.
+##   single   : whole model in a buffer (same as ml_remote_service_register)
+##   cold     : chunked, the store of the receiver is empty
+##   update   : chunked, v2 of the model (a region is overwritten and some bytes are inserted)
+##   resume   : chunked, the transfer is interrupted after a few chunks and started again
+##
+## usage: ./deploy_bench.sh [size_mb] [chunk_kb]
+##
+
+SIZE_MB=${1:-128}
+CHUNK_KB=${2:-1024}
+PORT=3000
+BIN=${BIN:-./nnstreamer_example_ml_remote_model_deploy}
+WORK=$(mktemp -d /tmp/deploy_bench.XXXXXX)
+
+trap 'rm -rf ${WORK}' EXIT
+
+# v1: random (weights) and zeros (padding), v2: 1MB overwritten at 1/3 and 4KB inserted at 2/3
+RAND_MB=$((SIZE_MB * 3 / 4))
+dd if=/dev/urandom of=${WORK}/v1.bin bs=1M count=${RAND_MB} status=none
+dd if=/dev/zero bs=1M count=$((SIZE_MB - RAND_MB)) status=none >> ${WORK}/v1.bin
+
+head -c $((SIZE_MB * 1024 * 1024 / 3)) ${WORK}/v1.bin > ${WORK}/v2.bin
+head -c $((1024 * 1024)) /dev/urandom >> ${WORK}/v2.bin
+head -c $((SIZE_MB * 1024 * 1024 * 2 / 3)) ${WORK}/v1.bin | tail -c +$((SIZE_MB * 1024 * 1024 / 3 + 1024 * 1024 + 1)) >> ${WORK}/v2.bin
+head -c 4096 /dev/urandom >> ${WORK}/v2.bin
+tail -c +$((SIZE_MB * 1024 * 1024 * 2 / 3 + 1)) ${WORK}/v1.bin >> ${WORK}/v2.bin
+
+# $1: scenario, $2: mode, $3: model, $4: extra options of the sender
+run () {
+  ${BIN} --receiver --port=${PORT} --store=${WORK}/store --outdir=${WORK}/out --sessions=1 \
+      > ${WORK}/receiver.log 2>/dev/null &
+  RECEIVER=$!
+  sleep 1
+
+  ${BIN} --sender --destport=${PORT} --mode=$2 --model=$3 --name=model.bin \
+      --chunk-kb=${CHUNK_KB} $4 > ${WORK}/sender.log 2>/dev/null
+
+  # the receiver does not finish the session if the transfer is interrupted
+  if [ -n "$4" ]; then
+    kill ${RECEIVER} 2>/dev/null
+  fi
+  wait ${RECEIVER} 2>/dev/null
+
+  echo "scenario,$(grep '^role,' ${WORK}/sender.log)"
+  echo "$1,$(grep '^sender,' ${WORK}/sender.log)"
+  if grep -q '^receiver,' ${WORK}/receiver.log; then
+    echo "$1,$(grep '^receiver,' ${WORK}/receiver.log)"
+    cmp -s $3 ${WORK}/out/model.bin || echo "$1: the received model is different!"
+  fi
+  PORT=$((PORT + 1))
+}
+
+run single single ${WORK}/v1.bin
+run cold chunked ${WORK}/v1.bin
+run update chunked ${WORK}/v2.bin
+
+rm -rf ${WORK}/store ${WORK}/out
+run interrupted chunked ${WORK}/v1.bin "--max-chunks=$((SIZE_MB * 1024 / CHUNK_KB / 3))"
+run resume chunked ${WORK}/v1.bin
@@ -0,0 +1,1141 @@
+/**
+ * @file	nnstreamer_example_ml_remote_model_deploy.c
+ * @date	19 October 2026
+ * @brief	Deploy a model to the remote node in content-hashed, compressed chunks.
+ * @see	https://github.com/nnstreamer/nnstreamer
+ * @author	 <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ */
+/**
+ * @note ml_remote_service_register () sends the model in a buffer, the sender and the receiver
+ * hold the whole model in memory. This example sends the model with nnstreamer-edge in chunks.
+ *
+ * 1. The sender splits the model into content-defined chunks (gear hash, average --chunk-kb)
+ *    and sends the manifest, the SHA-256 and the size of each chunk.
+ * 2. The receiver replies the chunks not in its store (--store), so an updated model sends
+ *    the changed chunks only, and an interrupted transfer sends the remaining chunks.
+ * 3. The sender reads, compresses (zlib, --level) and sends the needed chunks one by one,
+ *    with --window chunks in flight. The receiver decompresses and verifies each chunk
+ *    and writes it to the store.
+ * 4. The receiver assembles the model from the store and registers it with
+ *    ml_service_model_register () if --register is given.
+ *
+ * --mode=single sends the whole model in a buffer, the same as ml_remote_service_register ().
+ *
+ * Result is printed as CSV:
+ * sender: role,mode,file_bytes,chunks,sent_chunks,skipped_chunks,sent_bytes,ratio,time_ms,mb_per_sec,peak_rss_mb
+ * receiver: role,mode,name,file_bytes,received_bytes,written_chunks,time_ms,peak_rss_mb
+ *
+ * Run example :
+ * $ ./nnstreamer_example_ml_remote_model_deploy --receiver --port=3000 --store=/tmp/store --outdir=/tmp/models
+ * $ ./nnstreamer_example_ml_remote_model_deploy --sender --destport=3000 --model=mobilenet_v2.tflite --name=mobilenet
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+#include <ml-api-service.h>
+#include <nnstreamer-edge.h>
+#include <getopt.h>
+
+/**
+ * @brief Size of SHA-256 digest.
+ */
+#define DIGEST_LEN 32
+
+/**
+ * @brief Time to wait for a reply from the receiver (sec).
+ */
+#define REPLY_TIMEOUT 30
+
+/**
+ * @brief Chunk in the manifest.
+ */
+typedef struct
+{
+  guint8 digest[DIGEST_LEN]; /**< SHA-256 of the raw data */
+  guint32 size; /**< size of the raw data */
+  guint32 reserved;
+} chunk_entry_s;
+
+/**
+ * @brief Chunk in the model file.
+ */
+typedef struct
+{
+  chunk_entry_s entry;
+  goffset offset; /**< offset in the file */
+} chunk_info_s;
+
+/**
+ * @brief Data struct for options.
+ */
+typedef struct
+{
+  gboolean is_sender;
+  gchar *mode; /**< chunked or single */
+  gchar *host;
+  guint port;
+  gchar *dest_host;
+  guint dest_port;
+  gchar *model; /**< model file to send */
+  gchar *name; /**< model name */
+  guint chunk_kb; /**< average chunk size */
+  gint level; /**< compression level */
+  guint window; /**< chunks in flight */
+  guint max_chunks; /**< stop after sending the chunks to emulate an interruption, 0 for all */
+  gchar *store; /**< chunk store of the receiver */
+  gchar *outdir; /**< directory of the assembled model */
+  gboolean do_register; /**< register the model with ml-service */
+  guint sessions; /**< receiver exits after the sessions, 0 to run forever */
+} opt_data_s;
+
+/**
+ * @brief Session of the receiver.
+ */
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  opt_data_s *opt;
+  nns_edge_h edge_h;
+  gchar *name;
+  chunk_entry_s *entries; /**< manifest */
+  guint num_entries;
+  guint64 file_size;
+  guint64 received_bytes;
+  guint written_chunks;
+  gint64 start_time;
+  guint finished; /**< the number of finished sessions */
+} receiver_s;
+
+/**
+ * @brief Gear table for content-defined chunking, the same for all senders.
+ */
+static guint64 gear_table[256];
+
+/**
+ * @brief Initialize the gear table with a fixed seed.
+ */
+static void
+_init_gear_table (void)
+{
+  guint64 x = 0x9e3779b97f4a7c15ULL;
+  guint i;
+
+  for (i = 0; i < 256; i++) {
+    /* xorshift64 */
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    gear_table[i] = x;
+  }
+}
+
+/**
+ * @brief Get the peak RSS (VmHWM) of the process in MB.
+ */
+static gdouble
+_get_peak_rss_mb (void)
+{
+  gchar *contents = NULL, *p;
+  gdouble mb = 0.0;
+
+  if (g_file_get_contents ("/proc/self/status", &contents, NULL, NULL)) {
+    p = strstr (contents, "VmHWM:");
+    if (p)
+      mb = g_ascii_strtoull (p + strlen ("VmHWM:"), NULL, 10) / 1024.0;
+  }
+
+  g_free (contents);
+  return mb;
+}
+
+/**
+ * @brief Get the SHA-256 digest of the data.
+ */
+static void
+_get_digest (const guint8 * data, gsize size, guint8 * digest)
+{
+  GChecksum *checksum = g_checksum_new (G_CHECKSUM_SHA256);
+  gsize len = DIGEST_LEN;
+
+  g_checksum_update (checksum, data, size);
+  g_checksum_get_digest (checksum, digest, &len);
+  g_checksum_free (checksum);
+}
+
+/**
+ * @brief Get the path of the chunk in the store.
+ */
+static gchar *
+_get_chunk_path (const gchar * store, const guint8 * digest)
+{
+  gchar hex[DIGEST_LEN * 2 + 1];
+  guint i;
+
+  for (i = 0; i < DIGEST_LEN; i++)
+    g_snprintf (hex + i * 2, 3, "%02x", digest[i]);
+
+  return g_build_filename (store, hex, NULL);
+}
+
+/**
+ * @brief Compress or decompress the data with zlib.
+ * @return the size of the output, 0 if failed or the output buffer is too small
+ */
+static gsize
+_zlib_convert (gboolean compress, gint level, const guint8 * in, gsize in_size,
+    guint8 * out, gsize out_size)
+{
+  GConverter *converter;
+  GConverterResult result;
+  gsize read = 0, written = 0, total_read = 0, total_written = 0;
+
+  if (compress)
+    converter = G_CONVERTER (g_zlib_compressor_new (G_ZLIB_COMPRESSOR_FORMAT_RAW, level));
+  else
+    converter = G_CONVERTER (g_zlib_decompressor_new (G_ZLIB_COMPRESSOR_FORMAT_RAW));
+
+  do {
+    result = g_converter_convert (converter, in + total_read, in_size - total_read,
+        out + total_written, out_size - total_written, G_CONVERTER_INPUT_AT_END,
+        &read, &written, NULL);
+    total_read += read;
+    total_written += written;
+  } while (result == G_CONVERTER_CONVERTED && total_written < out_size);
+
+  g_object_unref (converter);
+  return (result == G_CONVERTER_FINISHED) ? total_written : 0;
+}
+
+/**
+ * @brief Split the file into content-defined chunks. The file is read once, not kept in memory.
+ * @return array of chunk_info_s, NULL if failed
+ */
+static GArray *
+_split_chunks (const gchar * path, guint avg_size, guint64 * file_size)
+{
+  GArray *chunks;
+  chunk_info_s info;
+  FILE *fp;
+  guint8 *buf;
+  gsize len = 0, n, pos, min_size, max_size, cut;
+  guint64 hash, mask;
+  goffset offset = 0;
+
+  fp = g_fopen (path, "rb");
+  if (!fp)
+    return NULL;
+
+  min_size = avg_size / 4;
+  max_size = (gsize) avg_size * 4;
+  mask = g_bit_nth_msf (avg_size, -1) > 0 ?
+      (((guint64) 1 << g_bit_nth_msf (avg_size, -1)) - 1) : 0;
+
+  buf = (guint8 *) g_malloc (max_size);
+  chunks = g_array_new (FALSE, FALSE, sizeof (chunk_info_s));
+
+  while (TRUE) {
+    n = fread (buf + len, 1, max_size - len, fp);
+    len += n;
+    if (len == 0)
+      break;
+
+    /* find the boundary in [min_size, max_size) */
+    cut = len;
+    if (len > min_size) {
+      hash = 0;
+      for (pos = (min_size > 64) ? min_size - 64 : 0; pos < len; pos++) {
+        hash = (hash << 1) + gear_table[buf[pos]];
+        if (pos >= min_size && (hash & mask) == 0) {
+          cut = pos + 1;
+          break;
+        }
+      }
+    }
+
+    /* the end of the file in the buffer, or the max size */
+    if (cut == len && !feof (fp) && !ferror (fp) && len < max_size)
+      continue;
+
+    memset (&info, 0, sizeof (chunk_info_s));
+    _get_digest (buf, cut, info.entry.digest);
+    info.entry.size = (guint32) cut;
+    info.offset = offset;
+    g_array_append_val (chunks, info);
+
+    offset += cut;
+    len -= cut;
+    memmove (buf, buf + cut, len);
+  }
+
+  fclose (fp);
+  g_free (buf);
+
+  *file_size = (guint64) offset;
+  return chunks;
+}
+
+/**
+ * @brief Create the edge data with the type and the payload. The payload is copied when sent.
+ */
+static nns_edge_data_h
+_create_data (const gchar * type, const gchar * name, void *payload, gsize size)
+{
+  nns_edge_data_h data_h;
+
+  if (NNS_EDGE_ERROR_NONE != nns_edge_data_create (&data_h))
+    return NULL;
+
+  nns_edge_data_set_info (data_h, "type", type);
+  if (name)
+    nns_edge_data_set_info (data_h, "name", name);
+  if (payload && size > 0)
+    nns_edge_data_add (data_h, payload, size, NULL);
+
+  return data_h;
+}
+
+/**
+ * @brief Get the info of the edge data as an integer.
+ */
+static guint64
+_get_info_uint (nns_edge_data_h data_h, const gchar * key)
+{
+  gchar *value = NULL;
+  guint64 ret = 0;
+
+  if (NNS_EDGE_ERROR_NONE == nns_edge_data_get_info (data_h, key, &value) && value)
+    ret = g_ascii_strtoull (value, NULL, 10);
+
+  g_free (value);
+  return ret;
+}
+
+/**
+ * @brief Check the type of the edge data.
+ */
+static gboolean
+_is_type (nns_edge_data_h data_h, const gchar * type)
+{
+  gchar *value = NULL;
+  gboolean ret;
+
+  nns_edge_data_get_info (data_h, "type", &value);
+  ret = (g_strcmp0 (value, type) == 0);
+  g_free (value);
+
+  return ret;
+}
+
+/**
+ * @brief Edge event callback of the sender, the replies are pushed to the queue.
+ */
+static int
+_sender_event_cb (nns_edge_event_h event_h, void *user_data)
+{
+  GAsyncQueue *replies = (GAsyncQueue *) user_data;
+  nns_edge_event_e event = NNS_EDGE_EVENT_UNKNOWN;
+  nns_edge_data_h data_h;
+  int ret;
+
+  ret = nns_edge_event_get_type (event_h, &event);
+  if (NNS_EDGE_ERROR_NONE != ret)
+    return ret;
+
+  if (event == NNS_EDGE_EVENT_NEW_DATA_RECEIVED &&
+      NNS_EDGE_ERROR_NONE == nns_edge_event_parse_new_data (event_h, &data_h))
+    g_async_queue_push (replies, data_h);
+
+  return NNS_EDGE_ERROR_NONE;
+}
+
+/**
+ * @brief Wait for the reply with the type. Other replies are discarded.
+ */
+static nns_edge_data_h
+_wait_reply (GAsyncQueue * replies, const gchar * type)
+{
+  nns_edge_data_h data_h;
+
+  while ((data_h = g_async_queue_timeout_pop (replies,
+              (guint64) REPLY_TIMEOUT * G_USEC_PER_SEC)) != NULL) {
+    if (_is_type (data_h, type))
+      return data_h;
+    nns_edge_data_destroy (data_h);
+  }
+
+  g_critical ("No reply (%s) from the receiver.", type);
+  return NULL;
+}
+
+/**
+ * @brief Send the whole model in a buffer, the same as ml_remote_service_register ().
+ */
+static gboolean
+_send_single (nns_edge_h edge_h, GAsyncQueue * replies, opt_data_s * opt,
+    guint64 * file_size, guint64 * sent_bytes)
+{
+  nns_edge_data_h data_h;
+  gchar *contents = NULL;
+  gsize len = 0;
+  gboolean ret = FALSE;
+
+  if (!g_file_get_contents (opt->model, &contents, &len, NULL)) {
+    g_critical ("Failed to read %s", opt->model);
+    return FALSE;
+  }
+
+  data_h = _create_data ("single", opt->name, contents, len);
+  if (data_h) {
+    ret = (NNS_EDGE_ERROR_NONE == nns_edge_send (edge_h, data_h));
+    nns_edge_data_destroy (data_h);
+  }
+  g_free (contents);
+
+  if (ret && (data_h = _wait_reply (replies, "done")) != NULL) {
+    ret = (_get_info_uint (data_h, "status") == 0);
+    nns_edge_data_destroy (data_h);
+  } else {
+    ret = FALSE;
+  }
+
+  *file_size = *sent_bytes = len;
+  return ret;
+}
+
+/**
+ * @brief Send the model in chunks.
+ */
+static gboolean
+_send_chunked (nns_edge_h edge_h, GAsyncQueue * replies, opt_data_s * opt,
+    guint64 * file_size, guint * num_chunks, guint * sent_chunks, guint64 * sent_bytes)
+{
+  GArray *chunks;
+  chunk_entry_s *manifest;
+  chunk_info_s *info;
+  nns_edge_data_h data_h;
+  guint32 *need = NULL;
+  guint8 *raw = NULL, *packed = NULL;
+  gsize max_size, packed_size;
+  void *payload;
+  nns_size_t payload_len;
+  guint i, num_need = 0, num_requested, inflight = 0;
+  gchar num[32];
+  FILE *fp = NULL;
+  gboolean ret = FALSE;
+
+  chunks = _split_chunks (opt->model, opt->chunk_kb * 1024, file_size);
+  if (!chunks) {
+    g_critical ("Failed to read %s", opt->model);
+    return FALSE;
+  }
+  *num_chunks = chunks->len;
+
+  /* manifest */
+  manifest = g_new0 (chunk_entry_s, MAX (chunks->len, 1U));
+  for (i = 0; i < chunks->len; i++)
+    manifest[i] = g_array_index (chunks, chunk_info_s, i).entry;
+
+  data_h = _create_data ("manifest", opt->name, manifest, sizeof (chunk_entry_s) * chunks->len);
+  g_snprintf (num, sizeof (num), "%" G_GUINT64_FORMAT, *file_size);
+  nns_edge_data_set_info (data_h, "file_size", num);
+  g_snprintf (num, sizeof (num), "%u", chunks->len);
+  nns_edge_data_set_info (data_h, "chunks", num);
+  nns_edge_send (edge_h, data_h);
+  nns_edge_data_destroy (data_h);
+  g_free (manifest);
+
+  /* chunks the receiver does not have */
+  data_h = _wait_reply (replies, "need");
+  if (!data_h)
+    goto done;
+
+  if (NNS_EDGE_ERROR_NONE == nns_edge_data_get (data_h, 0, &payload, &payload_len)) {
+    num_need = (guint) (payload_len / sizeof (guint32));
+    need = g_new (guint32, MAX (num_need, 1U));
+    memcpy (need, payload, num_need * sizeof (guint32));
+  }
+  nns_edge_data_destroy (data_h);
+
+  num_requested = num_need;
+  if (opt->max_chunks > 0)
+    num_need = MIN (num_need, opt->max_chunks);
+
+  max_size = (gsize) opt->chunk_kb * 1024 * 4;
+  raw = (guint8 *) g_malloc (max_size);
+  packed = (guint8 *) g_malloc (max_size);
+  fp = g_fopen (opt->model, "rb");
+  if (!fp)
+    goto done;
+
+  for (i = 0; i < num_need; i++) {
+    if (need[i] >= chunks->len)
+      continue;
+    info = &g_array_index (chunks, chunk_info_s, need[i]);
+
+    if (fseeko (fp, info->offset, SEEK_SET) != 0 ||
+        fread (raw, 1, info->entry.size, fp) != info->entry.size) {
+      g_critical ("Failed to read the chunk %u", need[i]);
+      goto done;
+    }
+
+    /* send the raw data if it is not compressed */
+    packed_size = _zlib_convert (TRUE, opt->level, raw, info->entry.size, packed, max_size);
+    if (packed_size == 0 || packed_size >= info->entry.size)
+      data_h = _create_data ("chunk", NULL, raw, info->entry.size);
+    else
+      data_h = _create_data ("chunk", NULL, packed, packed_size);
+
+    g_snprintf (num, sizeof (num), "%u", need[i]);
+    nns_edge_data_set_info (data_h, "index", num);
+    nns_edge_data_set_info (data_h, "compressed",
+        (packed_size == 0 || packed_size >= info->entry.size) ? "0" : "1");
+
+    if (NNS_EDGE_ERROR_NONE != nns_edge_send (edge_h, data_h)) {
+      nns_edge_data_destroy (data_h);
+      goto done;
+    }
+    nns_edge_data_destroy (data_h);
+
+    (*sent_chunks)++;
+    *sent_bytes += (packed_size == 0 || packed_size >= info->entry.size) ?
+        info->entry.size : packed_size;
+
+    /* flow control, the sender does not queue the whole model */
+    if (++inflight >= opt->window) {
+      data_h = _wait_reply (replies, "ack");
+      if (!data_h)
+        goto done;
+      nns_edge_data_destroy (data_h);
+      inflight--;
+    }
+  }
+
+  for (; inflight > 0; inflight--) {
+    data_h = _wait_reply (replies, "ack");
+    if (!data_h)
+      goto done;
+    nns_edge_data_destroy (data_h);
+  }
+
+  /* interrupted, the receiver keeps the chunks in the store */
+  if (num_need < num_requested) {
+    ret = TRUE;
+    goto done;
+  }
+
+  data_h = _create_data ("commit", opt->name, NULL, 0);
+  nns_edge_send (edge_h, data_h);
+  nns_edge_data_destroy (data_h);
+
+  data_h = _wait_reply (replies, "done");
+  if (data_h) {
+    ret = (_get_info_uint (data_h, "status") == 0);
+    nns_edge_data_destroy (data_h);
+  }
+
+done:
+  if (fp)
+    fclose (fp);
+  g_free (raw);
+  g_free (packed);
+  g_free (need);
+  g_array_free (chunks, TRUE);
+  return ret;
+}
+
+/**
+ * @brief Run the sender.
+ */
+static gint
+_run_sender (opt_data_s * opt)
+{
+  nns_edge_h edge_h = NULL;
+  GAsyncQueue *replies;
+  guint64 file_size = 0, sent_bytes = 0;
+  guint num_chunks = 0, sent_chunks = 0;
+  gint64 start, elapsed;
+  gboolean single, ret = FALSE;
+  nns_edge_data_h data_h;
+
+  single = (g_ascii_strcasecmp (opt->mode, "single") == 0);
+  replies = g_async_queue_new ();
+
+  if (NNS_EDGE_ERROR_NONE != nns_edge_create_handle ("model_deploy_sender",
+          NNS_EDGE_CONNECT_TYPE_TCP, NNS_EDGE_NODE_TYPE_QUERY_CLIENT, &edge_h)) {
+    g_critical ("Failed to create edge handle.");
+    goto done;
+  }
+  nns_edge_set_event_callback (edge_h, _sender_event_cb, replies);
+  nns_edge_set_info (edge_h, "HOST", opt->host);
+
+  if (NNS_EDGE_ERROR_NONE != nns_edge_start (edge_h) ||
+      NNS_EDGE_ERROR_NONE != nns_edge_connect (edge_h, opt->dest_host, opt->dest_port)) {
+    g_critical ("Failed to connect to the receiver.");
+    goto done;
+  }
+
+  start = g_get_monotonic_time ();
+  if (single)
+    ret = _send_single (edge_h, replies, opt, &file_size, &sent_bytes);
+  else
+    ret = _send_chunked (edge_h, replies, opt, &file_size, &num_chunks, &sent_chunks,
+        &sent_bytes);
+  elapsed = g_get_monotonic_time () - start;
+
+  g_print ("role,mode,file_bytes,chunks,sent_chunks,skipped_chunks,sent_bytes,ratio,"
+      "time_ms,mb_per_sec,peak_rss_mb\n");
+  g_print ("sender,%s,%" G_GUINT64_FORMAT ",%u,%u,%u,%" G_GUINT64_FORMAT ",%.3f,%.1f,%.1f,%.1f\n",
+      single ? "single" : "chunked", file_size, num_chunks, sent_chunks,
+      (num_chunks > sent_chunks) ? num_chunks - sent_chunks : 0, sent_bytes,
+      file_size ? (gdouble) sent_bytes / file_size : 0.0, elapsed / 1000.0,
+      elapsed > 0 ? file_size / (1024.0 * 1024.0) / (elapsed / (gdouble) G_USEC_PER_SEC) : 0.0,
+      _get_peak_rss_mb ());
+
+  if (!ret)
+    g_critical ("Failed to deploy %s", opt->model);
+
+done:
+  if (edge_h)
+    nns_edge_release_handle (edge_h);
+  while ((data_h = g_async_queue_try_pop (replies)) != NULL)
+    nns_edge_data_destroy (data_h);
+  g_async_queue_unref (replies);
+
+  return ret ? 0 : -1;
+}
+
+/**
+ * @brief Send the reply to the client of the request.
+ */
+static void
+_send_reply (receiver_s * recv, nns_edge_data_h request_h, nns_edge_data_h reply_h)
+{
+  gchar *client_id = NULL;
+
+  if (NNS_EDGE_ERROR_NONE == nns_edge_data_get_info (request_h, "client_id", &client_id)) {
+    nns_edge_data_set_info (reply_h, "client_id", client_id);
+    nns_edge_send (recv->edge_h, reply_h);
+  }
+
+  g_free (client_id);
+  nns_edge_data_destroy (reply_h);
+}
+
+/**
+ * @brief Print the result of the session and register the model.
+ */
+static gint
+_finish_session (receiver_s * recv, const gchar * mode, const gchar * path)
+{
+  gint64 elapsed = g_get_monotonic_time () - recv->start_time;
+  guint version = 0;
+  gint status = 0;
+
+  if (recv->opt->do_register && path) {
+    status = ml_service_model_register (recv->name, path, TRUE, "deployed in chunks", &version);
+    if (ML_ERROR_NONE != status)
+      g_critical ("Failed to register the model %s (%d)", recv->name, status);
+    else
+      g_message ("The model %s is registered, version %u", recv->name, version);
+  }
+
+  g_print ("role,mode,name,file_bytes,received_bytes,written_chunks,time_ms,peak_rss_mb\n");
+  g_print ("receiver,%s,%s,%" G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT ",%u,%.1f,%.1f\n",
+      mode, recv->name, recv->file_size, recv->received_bytes, recv->written_chunks,
+      elapsed / 1000.0, _get_peak_rss_mb ());
+
+  g_mutex_lock (&recv->lock);
+  recv->finished++;
+  g_cond_signal (&recv->cond);
+  g_mutex_unlock (&recv->lock);
+
+  return status;
+}
+
+/**
+ * @brief Check the model name from the sender, it is used as a file name in the output directory.
+ */
+static gboolean
+_is_valid_name (const gchar * name)
+{
+  return (name && name[0] != '\0' && !g_str_equal (name, ".") &&
+      !g_str_equal (name, "..") && strchr (name, '/') == NULL &&
+      strchr (name, G_DIR_SEPARATOR) == NULL);
+}
+
+/**
+ * @brief Handle the whole model in a buffer.
+ */
+static void
+_receive_single (receiver_s * recv, nns_edge_data_h data_h)
+{
+  nns_edge_data_h reply_h;
+  void *data;
+  nns_size_t len = 0;
+  gchar *path = NULL, num[16];
+  gint status = -1;
+
+  g_free (recv->name);
+  recv->name = NULL;
+  nns_edge_data_get_info (data_h, "name", &recv->name);
+  recv->start_time = g_get_monotonic_time ();
+
+  if (!_is_valid_name (recv->name)) {
+    g_warning ("Invalid model name %s", recv->name ? recv->name : "(null)");
+  } else if (NNS_EDGE_ERROR_NONE == nns_edge_data_get (data_h, 0, &data, &len)) {
+    path = g_build_filename (recv->opt->outdir, recv->name, NULL);
+    if (g_file_set_contents (path, (const gchar *) data, (gssize) len, NULL))
+      status = 0;
+  }
+
+  recv->file_size = recv->received_bytes = len;
+  recv->written_chunks = 0;
+  if (status == 0)
+    status = _finish_session (recv, "single", path);
+
+  reply_h = _create_data ("done", recv->name, NULL, 0);
+  g_snprintf (num, sizeof (num), "%d", status);
+  nns_edge_data_set_info (reply_h, "status", num);
+  _send_reply (recv, data_h, reply_h);
+  g_free (path);
+}
+
+/**
+ * @brief Handle the manifest, reply the chunks not in the store.
+ */
+static void
+_receive_manifest (receiver_s * recv, nns_edge_data_h data_h)
+{
+  nns_edge_data_h reply_h;
+  GHashTable *requested;
+  GArray *need;
+  void *data;
+  nns_size_t len = 0;
+  gchar *path;
+  GStatBuf st;
+  guint32 i;
+
+  g_free (recv->name);
+  g_free (recv->entries);
+  recv->name = NULL;
+  recv->entries = NULL;
+  recv->num_entries = 0;
+  recv->received_bytes = 0;
+  recv->written_chunks = 0;
+  recv->start_time = g_get_monotonic_time ();
+
+  nns_edge_data_get_info (data_h, "name", &recv->name);
+  recv->file_size = _get_info_uint (data_h, "file_size");
+  if (NNS_EDGE_ERROR_NONE == nns_edge_data_get (data_h, 0, &data, &len)) {
+    recv->num_entries = (guint) (len / sizeof (chunk_entry_s));
+    recv->entries = g_new (chunk_entry_s, MAX (recv->num_entries, 1U));
+    memcpy (recv->entries, data, recv->num_entries * sizeof (chunk_entry_s));
+  }
+
+  /* the same chunk in the model is requested once */
+  requested = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  need = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+  for (i = 0; i < recv->num_entries; i++) {
+    path = _get_chunk_path (recv->opt->store, recv->entries[i].digest);
+
+    if ((g_stat (path, &st) == 0 && (guint64) st.st_size == recv->entries[i].size) ||
+        g_hash_table_contains (requested, path)) {
+      g_free (path);
+      continue;
+    }
+
+    g_hash_table_add (requested, path);
+    g_array_append_val (need, i);
+  }
+
+  g_message ("manifest %s: %u chunks, %u chunks needed", recv->name, recv->num_entries,
+      need->len);
+
+  reply_h = _create_data ("need", recv->name, need->data, need->len * sizeof (guint32));
+  _send_reply (recv, data_h, reply_h);
+
+  g_array_free (need, TRUE);
+  g_hash_table_destroy (requested);
+}
+
+/**
+ * @brief Handle a chunk, verify and write it to the store.
+ */
+static void
+_receive_chunk (receiver_s * recv, nns_edge_data_h data_h)
+{
+  nns_edge_data_h reply_h;
+  chunk_entry_s *entry;
+  guint8 digest[DIGEST_LEN];
+  guint8 *raw = NULL;
+  void *data;
+  nns_size_t len = 0;
+  gchar *path = NULL, *tmp = NULL;
+  guint64 index;
+
+  index = _get_info_uint (data_h, "index");
+  if (index >= recv->num_entries ||
+      NNS_EDGE_ERROR_NONE != nns_edge_data_get (data_h, 0, &data, &len))
+    goto ack;
+
+  entry = &recv->entries[index];
+  recv->received_bytes += len;
+
+  if (_get_info_uint (data_h, "compressed") == 1) {
+    raw = (guint8 *) g_malloc (entry->size);
+    if (_zlib_convert (FALSE, 0, data, len, raw, entry->size) != entry->size) {
+      g_warning ("Failed to decompress the chunk %" G_GUINT64_FORMAT, index);
+      goto ack;
+    }
+    data = raw;
+    len = entry->size;
+  }
+
+  _get_digest (data, len, digest);
+  if (len != entry->size || memcmp (digest, entry->digest, DIGEST_LEN) != 0) {
+    g_warning ("Invalid chunk %" G_GUINT64_FORMAT, index);
+    goto ack;
+  }
+
+  /* write and rename, an interrupted write does not leave a broken chunk */
+  path = _get_chunk_path (recv->opt->store, digest);
+  tmp = g_strdup_printf ("%s.tmp", path);
+  if (g_file_set_contents (tmp, data, (gssize) len, NULL) && g_rename (tmp, path) == 0)
+    recv->written_chunks++;
+
+ack:
+  reply_h = _create_data ("ack", NULL, NULL, 0);
+  _send_reply (recv, data_h, reply_h);
+  g_free (raw);
+  g_free (path);
+  g_free (tmp);
+}
+
+/**
+ * @brief Assemble the model from the store.
+ */
+static void
+_receive_commit (receiver_s * recv, nns_edge_data_h data_h)
+{
+  nns_edge_data_h reply_h;
+  gchar *path = NULL, *tmp = NULL, *chunk_path, *contents;
+  gchar num[16];
+  gsize len;
+  FILE *fp = NULL;
+  guint i;
+  gint status = 0;
+
+  if (recv->name && !_is_valid_name (recv->name)) {
+    g_warning ("Invalid model name %s", recv->name);
+    status = -1;
+  } else {
+    path = g_build_filename (recv->opt->outdir, recv->name ? recv->name : "model", NULL);
+    tmp = g_strdup_printf ("%s.tmp", path);
+
+    fp = g_fopen (tmp, "wb");
+    if (!fp)
+      status = -1;
+  }
+
+  /* read a chunk at a time */
+  for (i = 0; fp && i < recv->num_entries && status == 0; i++) {
+    chunk_path = _get_chunk_path (recv->opt->store, recv->entries[i].digest);
+    if (!g_file_get_contents (chunk_path, &contents, &len, NULL)) {
+      g_warning ("The chunk %u is missing.", i);
+      status = -1;
+    } else {
+      if (fwrite (contents, 1, len, fp) != len)
+        status = -1;
+      g_free (contents);
+    }
+    g_free (chunk_path);
+  }
+
+  if (fp && fclose (fp) != 0)
+    status = -1;
+  if (status == 0 && g_rename (tmp, path) != 0)
+    status = -1;
+  if (status != 0 && tmp)
+    g_unlink (tmp);
+
+  if (status == 0)
+    status = _finish_session (recv, "chunked", path);
+
+  reply_h = _create_data ("done", recv->name, NULL, 0);
+  g_snprintf (num, sizeof (num), "%d", status);
+  nns_edge_data_set_info (reply_h, "status", num);
+  _send_reply (recv, data_h, reply_h);
+
+  g_free (path);
+  g_free (tmp);
+}
+
+/**
+ * @brief Edge event callback of the receiver.
+ */
+static int
+_receiver_event_cb (nns_edge_event_h event_h, void *user_data)
+{
+  receiver_s *recv = (receiver_s *) user_data;
+  nns_edge_event_e event = NNS_EDGE_EVENT_UNKNOWN;
+  nns_edge_data_h data_h;
+  int ret;
+
+  ret = nns_edge_event_get_type (event_h, &event);
+  if (NNS_EDGE_ERROR_NONE != ret)
+    return ret;
+
+  if (event != NNS_EDGE_EVENT_NEW_DATA_RECEIVED ||
+      NNS_EDGE_ERROR_NONE != nns_edge_event_parse_new_data (event_h, &data_h))
+    return NNS_EDGE_ERROR_NONE;
+
+  if (_is_type (data_h, "single"))
+    _receive_single (recv, data_h);
+  else if (_is_type (data_h, "manifest"))
+    _receive_manifest (recv, data_h);
+  else if (_is_type (data_h, "chunk"))
+    _receive_chunk (recv, data_h);
+  else if (_is_type (data_h, "commit"))
+    _receive_commit (recv, data_h);
+
+  nns_edge_data_destroy (data_h);
+  return NNS_EDGE_ERROR_NONE;
+}
+
+/**
+ * @brief Run the receiver.
+ */
+static gint
+_run_receiver (opt_data_s * opt)
+{
+  receiver_s recv;
+  gchar port[8];
+  gint ret = -1;
+
+  memset (&recv, 0, sizeof (receiver_s));
+  g_mutex_init (&recv.lock);
+  g_cond_init (&recv.cond);
+  recv.opt = opt;
+
+  if (g_mkdir_with_parents (opt->store, 0700) != 0 ||
+      g_mkdir_with_parents (opt->outdir, 0700) != 0) {
+    g_critical ("Failed to create %s or %s", opt->store, opt->outdir);
+    goto done;
+  }
+
+  if (NNS_EDGE_ERROR_NONE != nns_edge_create_handle ("model_deploy_receiver",
+          NNS_EDGE_CONNECT_TYPE_TCP, NNS_EDGE_NODE_TYPE_QUERY_SERVER, &recv.edge_h)) {
+    g_critical ("Failed to create edge handle.");
+    goto done;
+  }
+  nns_edge_set_event_callback (recv.edge_h, _receiver_event_cb, &recv);
+  nns_edge_set_info (recv.edge_h, "HOST", opt->host);
+  g_snprintf (port, sizeof (port), "%u", opt->port);
+  nns_edge_set_info (recv.edge_h, "PORT", port);
+
+  if (NNS_EDGE_ERROR_NONE != nns_edge_start (recv.edge_h)) {
+    g_critical ("Failed to start the receiver.");
+    goto done;
+  }
+
+  g_message ("Waiting for the model, port %u, store %s", opt->port, opt->store);
+
+  g_mutex_lock (&recv.lock);
+  while (opt->sessions == 0 || recv.finished < opt->sessions)
+    g_cond_wait (&recv.cond, &recv.lock);
+  g_mutex_unlock (&recv.lock);
+  ret = 0;
+
+done:
+  if (recv.edge_h)
+    nns_edge_release_handle (recv.edge_h);
+  g_free (recv.name);
+  g_free (recv.entries);
+  g_mutex_clear (&recv.lock);
+  g_cond_clear (&recv.cond);
+
+  return ret;
+}
+
+/**
+ * @brief Print usage info
+ */
+static void
+_usage (void)
+{
+  g_print ("usage: nnstreamer_example_ml_remote_model_deploy [options]\n"
+      "  --sender      Send the model. (default)\n"
+      "  --receiver    Receive the model.\n"
+      "  --mode        Set chunked or single. (default chunked)\n"
+      "  --host        Set host address. (default localhost)\n"
+      "  --port        Set port of the receiver. (default 3000)\n"
+      "  --desthost    Set host address of the receiver. (default localhost)\n"
+      "  --destport    Set port of the receiver. (default 3000)\n"
+      "  --model       Set the model file to send.\n"
+      "  --name        Set the model name. (default the file name)\n"
+      "  --chunk-kb    Set the average chunk size in KB. (default 1024)\n"
+      "  --level       Set the compression level, 0 to 9. (default 1)\n"
+      "  --window      Set the number of chunks in flight. (default 8)\n"
+      "  --max-chunks  Stop after sending the chunks, to emulate an interruption.\n"
+      "  --store       Set the chunk store of the receiver. (default ./chunk_store)\n"
+      "  --outdir      Set the directory of the received model. (default .)\n"
+      "  --register    Register the received model with ml-service.\n"
+      "  --sessions    Exit after receiving the models. (default 0, run forever)\n");
+}
+
+/**
+ * @brief Function for getting options
+ */
+static gboolean
+_get_option (int argc, char **argv, opt_data_s *opt_data)
+{
+  gint opt;
+  struct option long_options[] = {
+      { "sender", no_argument,  NULL, 'S' },
+      { "receiver", no_argument,  NULL, 'R' },
+      { "mode", required_argument,  NULL, 'M' },
+      { "host", required_argument,  NULL, 'h' },
+      { "port", required_argument,  NULL, 'p' },
+      { "desthost", required_argument,  NULL, 'b' },
+      { "destport", required_argument,  NULL, 'd' },
+      { "model", required_argument,  NULL, 'm' },
+      { "name", required_argument,  NULL, 'n' },
+      { "chunk-kb", required_argument,  NULL, 'c' },
+      { "level", required_argument,  NULL, 'l' },
+      { "window", required_argument,  NULL, 'w' },
+      { "max-chunks", required_argument,  NULL, 'x' },
+      { "store", required_argument,  NULL, 's' },
+      { "outdir", required_argument,  NULL, 'o' },
+      { "register", no_argument,  NULL, 'r' },
+      { "sessions", required_argument,  NULL, 'e' },
+      { "help", no_argument,  NULL, '?' },
+      { 0, 0, 0, 0}
+  };
+  gchar *optstring = "h:p:b:d:m:n:c:l:w:s:o:";
+
+  memset (opt_data, 0, sizeof (opt_data_s));
+  opt_data->is_sender = TRUE;
+  opt_data->mode = g_strdup ("chunked");
+  opt_data->host = g_strdup ("localhost");
+  opt_data->port = 3000;
+  opt_data->dest_host = g_strdup ("localhost");
+  opt_data->dest_port = 3000;
+  opt_data->chunk_kb = 1024;
+  opt_data->level = 1;
+  opt_data->window = 8;
+  opt_data->store = g_strdup ("chunk_store");
+  opt_data->outdir = g_strdup (".");
+
+  while ((opt = getopt_long (argc, argv, optstring, long_options, NULL)) != -1) {
+    switch (opt) {
+      case 'S':
+        opt_data->is_sender = TRUE;
+        break;
+      case 'R':
+        opt_data->is_sender = FALSE;
+        break;
+      case 'M':
+        g_free (opt_data->mode);
+        opt_data->mode = g_strdup (optarg);
+        break;
+      case 'h':
+        g_free (opt_data->host);
+        opt_data->host = g_strdup (optarg);
+        break;
+      case 'p':
+        opt_data->port = (guint16) g_ascii_strtoll (optarg, NULL, 10);
+        break;
+      case 'b':
+        g_free (opt_data->dest_host);
+        opt_data->dest_host = g_strdup (optarg);
+        break;
+      case 'd':
+        opt_data->dest_port = (guint16) g_ascii_strtoll (optarg, NULL, 10);
+        break;
+      case 'm':
+        g_free (opt_data->model);
+        opt_data->model = g_strdup (optarg);
+        break;
+      case 'n':
+        g_free (opt_data->name);
+        opt_data->name = g_strdup (optarg);
+        break;
+      case 'c':
+        opt_data->chunk_kb = MAX (4U, (guint) g_ascii_strtoull (optarg, NULL, 10));
+        break;
+      case 'l':
+        opt_data->level = CLAMP ((gint) g_ascii_strtoll (optarg, NULL, 10), 0, 9);
+        break;
+      case 'w':
+        opt_data->window = MAX (1U, (guint) g_ascii_strtoull (optarg, NULL, 10));
+        break;
+      case 'x':
+        opt_data->max_chunks = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 's':
+        g_free (opt_data->store);
+        opt_data->store = g_strdup (optarg);
+        break;
+      case 'o':
+        g_free (opt_data->outdir);
+        opt_data->outdir = g_strdup (optarg);
+        break;
+      case 'r':
+        opt_data->do_register = TRUE;
+        break;
+      case 'e':
+        opt_data->sessions = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      default:
+        _usage ();
+        return FALSE;
+    }
+  }
+
+  if (opt_data->is_sender && !opt_data->model) {
+    _usage ();
+    return FALSE;
+  }
+
+  if (opt_data->is_sender && !opt_data->name)
+    opt_data->name = g_path_get_basename (opt_data->model);
+
+  return TRUE;
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  opt_data_s opt_data;
+  gint ret = 0;
+
+  _init_gear_table ();
+
+  if (_get_option (argc, argv, &opt_data)) {
+    if (opt_data.is_sender)
+      ret = _run_sender (&opt_data);
+    else
+      ret = _run_receiver (&opt_data);
+  }
+
+  g_free (opt_data.mode);
+  g_free (opt_data.host);
+  g_free (opt_data.dest_host);
+  g_free (opt_data.model);
+  g_free (opt_data.name);
+  g_free (opt_data.store);
+  g_free (opt_data.outdir);
+
+  return ret;
+}
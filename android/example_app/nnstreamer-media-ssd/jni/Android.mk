@@ -31,8 +31,12 @@ include $(LOCAL_PATH)/Android-nnstreamer.mk
 #------------------------------------------------------
 include $(CLEAR_VARS)
 
+# shared helpers of the native examples (box priors loader)
+NNS_EX_COMMON_PATH := $(LOCAL_PATH)/../../../../native/common
+
 LOCAL_MODULE    := nnstreamer-jni
-LOCAL_SRC_FILES := nnstreamer-jni.c nnstreamer-ex.cpp
+LOCAL_SRC_FILES := nnstreamer-jni.c nnstreamer-ex.cpp $(NNS_EX_COMMON_PATH)/box_priors.c
+LOCAL_C_INCLUDES := $(NNS_EX_COMMON_PATH)
 LOCAL_STATIC_LIBRARIES := nnstreamer tensorflow-lite cpufeatures
 LOCAL_SHARED_LIBRARIES := gstreamer_android
 LOCAL_LDLIBS := -llog -landroid -lmediandk -lOpenMAXAL
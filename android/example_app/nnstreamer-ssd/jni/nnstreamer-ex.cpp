@@ -18,6 +18,7 @@
 #include <cairo/cairo.h>
 
 #include "nnstreamer-jni.h"
+#include "box_priors.h"
 
 #define EX_MODEL_PATH "/sdcard/nnstreamer/tflite_model"
 
@@ -65,7 +66,7 @@ typedef struct
  */
 typedef struct
 {
-  gfloat box_priors[SSD_BOX_SIZE][SSD_DETECTION_MAX]; /**< box prior */
+  BoxPriors box_priors; /**< box prior, rows of ycenter, xcenter, h and w */
   GSList *labels_obj;           /**< list of loaded labels (object detection) */
   gboolean is_initialized;
 } nns_ex_model_info_s;
@@ -101,42 +102,13 @@ nns_ex_read_lines (const gchar * file_name, GSList ** lines)
 static gboolean
 nns_ex_load_box_priors (void)
 {
-  GSList *box_priors = NULL;
-  gchar *box_row;
-
-  if (!nns_ex_read_lines (EX_BOX_PRIORS, &box_priors)) {
+  /* parsed once, the next start maps the cache (box_priors.txt.bin) */
+  if (!box_priors_load (&nns_ex_model_info.box_priors, EX_BOX_PRIORS,
+          SSD_BOX_SIZE, SSD_DETECTION_MAX)) {
     nns_loge ("Failed to load box prior");
     return FALSE;
   }
 
-  for (guint row = 0; row < SSD_BOX_SIZE; row++) {
-    gint column = 0;
-    gint i = 0, j = 0;
-    gchar buff[11];
-
-    memset (buff, 0, 11);
-    box_row = (gchar *) g_slist_nth_data (box_priors, row);
-
-    while ((box_row[i] != '\n') && (box_row[i] != '\0')) {
-      if (box_row[i] != ' ') {
-        buff[j] = box_row[i];
-        j++;
-      } else {
-        if (j != 0) {
-          nns_ex_model_info.box_priors[row][column++] =
-              (gfloat) g_ascii_strtod (buff, NULL);
-          memset (buff, 0, 11);
-        }
-        j = 0;
-      }
-      i++;
-    }
-
-    nns_ex_model_info.box_priors[row][column] =
-        (gfloat) g_ascii_strtod (buff, NULL);
-  }
-
-  g_slist_free_full (box_priors, g_free);
   return TRUE;
 }
 
@@ -163,6 +135,7 @@ nns_ex_free (void)
   g_mutex_clear (&res_mutex);
   detected_object.clear ();
 
+  box_priors_clear (&nns_ex_model_info.box_priors);
   nns_ex_model_info.is_initialized = FALSE;
 }
 
@@ -292,12 +265,12 @@ ssd_update_detection (gfloat * detections, gfloat * boxes)
   for (guint d = 0; d < SSD_DETECTION_MAX; d++) {
     box = boxes + (SSD_BOX_SIZE * d);
 
-    ycenter = box[0] / Y_SCALE * nns_ex_model_info.box_priors[2][d] +
-        nns_ex_model_info.box_priors[0][d];
-    xcenter = box[1] / X_SCALE * nns_ex_model_info.box_priors[3][d] +
-        nns_ex_model_info.box_priors[1][d];
-    height = (gfloat) expf (box[2] / H_SCALE) * nns_ex_model_info.box_priors[2][d];
-    width = (gfloat) expf (box[3] / W_SCALE) * nns_ex_model_info.box_priors[3][d];
+    ycenter = box[0] / Y_SCALE * nns_ex_model_info.box_priors.row[2][d] +
+        nns_ex_model_info.box_priors.row[0][d];
+    xcenter = box[1] / X_SCALE * nns_ex_model_info.box_priors.row[3][d] +
+        nns_ex_model_info.box_priors.row[1][d];
+    height = (gfloat) expf (box[2] / H_SCALE) * nns_ex_model_info.box_priors.row[2][d];
+    width = (gfloat) expf (box[3] / W_SCALE) * nns_ex_model_info.box_priors.row[3][d];
 
     ymin = ycenter - height / 2.f;
     xmin = xcenter - width / 2.f;
@@ -0,0 +1,184 @@
+/**
+ * @file	appsrc_feeder.c
+ * @date	19 October 2026
+ * @brief	Feeder for appsrc, recycles the buffers with GstBufferPool
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Gichan Jang <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+#include <gst/app/gstappsrc.h>
+#include "appsrc_feeder.h"
+
+/**
+ * @brief Feeder for appsrc.
+ */
+struct _AppsrcFeeder
+{
+  GstElement *appsrc; /**< appsrc element */
+  GstBufferPool *pool; /**< pool of the preallocated buffers */
+  gsize size; /**< size of a buffer in the pool */
+  GMutex lock; /**< lock for the statistics */
+  AppsrcFeederStats stats; /**< statistics */
+};
+
+/**
+ * @brief Create the feeder and activate the buffer pool.
+ * @param appsrc appsrc element to push the buffers
+ * @param size size of a buffer
+ * @param min_buffers number of buffers to preallocate
+ * @param max_buffers max number of buffers, 0 for no limit (the pool never runs out)
+ * @param align alignment of the memory in bytes, power of 2 (e.g., 64), 0 for default
+ * @return newly created feeder, NULL if failed
+ */
+AppsrcFeeder *
+appsrc_feeder_new (GstElement * appsrc, gsize size, guint min_buffers,
+    guint max_buffers, guint align)
+{
+  AppsrcFeeder *feeder;
+  GstStructure *config;
+  GstAllocationParams params;
+
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), NULL);
+  g_return_val_if_fail (size > 0, NULL);
+
+  feeder = g_new0 (AppsrcFeeder, 1);
+  feeder->appsrc = gst_object_ref (appsrc);
+  feeder->size = size;
+  g_mutex_init (&feeder->lock);
+
+  gst_allocation_params_init (&params);
+  if (align > 1)
+    params.align = align - 1;
+
+  feeder->pool = gst_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (feeder->pool);
+  gst_buffer_pool_config_set_params (config, NULL, (guint) size, min_buffers, max_buffers);
+  gst_buffer_pool_config_set_allocator (config, NULL, &params);
+
+  if (!gst_buffer_pool_set_config (feeder->pool, config) ||
+      !gst_buffer_pool_set_active (feeder->pool, TRUE)) {
+    g_critical ("Failed to activate the buffer pool (size %zd).", size);
+    appsrc_feeder_free (feeder);
+    return NULL;
+  }
+
+  return feeder;
+}
+
+/**
+ * @brief Get a free buffer and map it to write.
+ * Waits if all buffers are in use (max_buffers), the time is counted as wait-time.
+ * @param size size of the data, the buffer is allocated out of the pool if it is larger than the pool buffer
+ * @param map mapped info of the buffer, fill map->data
+ * @return buffer, pass it to appsrc_feeder_push () with the map. NULL if failed
+ */
+GstBuffer *
+appsrc_feeder_acquire (AppsrcFeeder * feeder, gsize size, GstMapInfo * map)
+{
+  GstBuffer *buffer = NULL;
+  GstBufferPoolAcquireParams params;
+  GstFlowReturn ret;
+  gint64 start, wait_us;
+
+  g_return_val_if_fail (feeder != NULL && map != NULL, NULL);
+
+  memset (&params, 0, sizeof (GstBufferPoolAcquireParams));
+  params.flags = GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT;
+
+  if (size > feeder->size) {
+    buffer = gst_buffer_new_allocate (NULL, size, NULL);
+
+    g_mutex_lock (&feeder->lock);
+    feeder->stats.fallback++;
+    g_mutex_unlock (&feeder->lock);
+  } else {
+    ret = gst_buffer_pool_acquire_buffer (feeder->pool, &buffer, &params);
+
+    if (ret == GST_FLOW_EOS) {
+      /* all buffers are in use, wait until downstream releases one */
+      start = g_get_monotonic_time ();
+      ret = gst_buffer_pool_acquire_buffer (feeder->pool, &buffer, NULL);
+      wait_us = g_get_monotonic_time () - start;
+
+      g_mutex_lock (&feeder->lock);
+      feeder->stats.exhausted++;
+      feeder->stats.wait_us += wait_us;
+      feeder->stats.wait_us_max = MAX (feeder->stats.wait_us_max, wait_us);
+      g_mutex_unlock (&feeder->lock);
+    }
+
+    if (ret != GST_FLOW_OK)
+      return NULL;
+
+    /* the buffer may be released with the size of the previous data */
+    gst_buffer_set_size (buffer, size);
+
+    g_mutex_lock (&feeder->lock);
+    feeder->stats.acquired++;
+    g_mutex_unlock (&feeder->lock);
+  }
+
+  if (!gst_buffer_map (buffer, map, GST_MAP_WRITE)) {
+    gst_buffer_unref (buffer);
+    return NULL;
+  }
+
+  return buffer;
+}
+
+/**
+ * @brief Unmap the buffer and push it to appsrc. The feeder takes the ownership of the buffer.
+ */
+GstFlowReturn
+appsrc_feeder_push (AppsrcFeeder * feeder, GstBuffer * buffer, GstMapInfo * map)
+{
+  GstFlowReturn ret;
+
+  g_return_val_if_fail (feeder != NULL, GST_FLOW_ERROR);
+  g_return_val_if_fail (buffer != NULL && map != NULL, GST_FLOW_ERROR);
+
+  gst_buffer_unmap (buffer, map);
+
+  ret = gst_app_src_push_buffer (GST_APP_SRC (feeder->appsrc), buffer);
+  if (ret == GST_FLOW_OK) {
+    g_mutex_lock (&feeder->lock);
+    feeder->stats.pushed++;
+    g_mutex_unlock (&feeder->lock);
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Get the statistics of the feeder.
+ */
+void
+appsrc_feeder_get_stats (AppsrcFeeder * feeder, AppsrcFeederStats * stats)
+{
+  g_return_if_fail (feeder != NULL && stats != NULL);
+
+  g_mutex_lock (&feeder->lock);
+  *stats = feeder->stats;
+  g_mutex_unlock (&feeder->lock);
+}
+
+/**
+ * @brief Deactivate the pool and free the feeder.
+ * @note Call this after the pipeline is stopped, the buffers in use are freed when released.
+ */
+void
+appsrc_feeder_free (AppsrcFeeder * feeder)
+{
+  g_return_if_fail (feeder != NULL);
+
+  if (feeder->pool) {
+    gst_buffer_pool_set_active (feeder->pool, FALSE);
+    gst_object_unref (feeder->pool);
+  }
+
+  gst_object_unref (feeder->appsrc);
+  g_mutex_clear (&feeder->lock);
+  g_free (feeder);
+}
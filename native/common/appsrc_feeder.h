@@ -0,0 +1,52 @@
+/**
+ * @file	appsrc_feeder.h
+ * @date	19 October 2026
+ * @brief	Feeder for appsrc, recycles the buffers with GstBufferPool
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Gichan Jang <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ *
+ * The examples pushing data with appsrc allocated a new memory block for each frame
+ * (g_malloc and gst_buffer_new_wrapped). The feeder preallocates aligned buffers in a
+ * GstBufferPool, and a buffer goes back to the pool when downstream releases it.
+ *
+ * usage:
+ *   feeder = appsrc_feeder_new (appsrc, size, 2, 4, 64);
+ *   buffer = appsrc_feeder_acquire (feeder, size, &map);
+ *   (fill map.data)
+ *   appsrc_feeder_push (feeder, buffer, &map);
+ *   appsrc_feeder_free (feeder);
+ */
+#ifndef __APPSRC_FEEDER_H__
+#define __APPSRC_FEEDER_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Statistics of the feeder.
+ */
+typedef struct
+{
+  guint64 acquired; /**< buffers acquired from the pool */
+  guint64 pushed; /**< buffers pushed to appsrc */
+  guint64 exhausted; /**< times the pool had no free buffer */
+  gint64 wait_us; /**< total time waited for a free buffer */
+  gint64 wait_us_max; /**< max time waited for a free buffer */
+  guint64 fallback; /**< buffers allocated out of the pool, larger than the pool buffer */
+} AppsrcFeederStats;
+
+typedef struct _AppsrcFeeder AppsrcFeeder;
+
+extern AppsrcFeeder * appsrc_feeder_new (GstElement * appsrc, gsize size, guint min_buffers,
+    guint max_buffers, guint align);
+extern GstBuffer * appsrc_feeder_acquire (AppsrcFeeder * feeder, gsize size, GstMapInfo * map);
+extern GstFlowReturn appsrc_feeder_push (AppsrcFeeder * feeder, GstBuffer * buffer, GstMapInfo * map);
+extern void appsrc_feeder_get_stats (AppsrcFeeder * feeder, AppsrcFeederStats * stats);
+extern void appsrc_feeder_free (AppsrcFeeder * feeder);
+
+G_END_DECLS
+
+#endif /* __APPSRC_FEEDER_H__ */
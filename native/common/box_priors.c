@@ -0,0 +1,371 @@
+/**
+ * @file	box_priors.c
+ * @date	19 October 2026
+ * @brief	Loader of the SSD box priors with a binary cache
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Gichan Jang <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "box_priors.h"
+
+#define CACHE_MAGIC "BOXPRI01"
+#define CACHE_SUFFIX ".bin"
+#define ROUND_UP_16(n) (((n) + 15U) & ~15U)
+
+/**
+ * @brief Header of the cache, the rows follow it.
+ */
+typedef struct
+{
+  gchar magic[8]; /**< CACHE_MAGIC */
+  guint32 rows;
+  guint32 count;
+  guint32 stride;
+  guint32 reserved;
+  gint64 mtime_ns; /**< mtime of the text file */
+  guint64 text_size; /**< size of the text file */
+  guint64 text_hash; /**< hash of the text file */
+  guint64 data_hash; /**< hash of the rows */
+  guint8 padding[BOX_PRIORS_ALIGN - 56];
+} BoxPriorsHeader;
+
+G_STATIC_ASSERT (sizeof (BoxPriorsHeader) == BOX_PRIORS_ALIGN);
+
+/**
+ * @brief 64-bit FNV-1a hash.
+ */
+static guint64
+_hash (const void *data, gsize size)
+{
+  const guint8 *p = (const guint8 *) data;
+  guint64 h = G_GUINT64_CONSTANT (14695981039346656037);
+  gsize i;
+
+  for (i = 0; i < size; i++) {
+    h ^= p[i];
+    h *= G_GUINT64_CONSTANT (1099511628211);
+  }
+
+  return h;
+}
+
+/**
+ * @brief Get the mtime in nanoseconds.
+ */
+static gint64
+_mtime_ns (const struct stat *st)
+{
+#if defined(__APPLE__)
+  return (gint64) st->st_mtimespec.tv_sec * 1000000000 + st->st_mtimespec.tv_nsec;
+#else
+  return (gint64) st->st_mtim.tv_sec * 1000000000 + st->st_mtim.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Get the size of the cache.
+ */
+static gsize
+_cache_size (guint rows, guint stride)
+{
+  return sizeof (BoxPriorsHeader) + (gsize) rows * stride * sizeof (gfloat);
+}
+
+/**
+ * @brief Set the rows of the priors.
+ */
+static void
+_set_rows (BoxPriors * priors, const BoxPriorsHeader * header)
+{
+  const gfloat *data = (const gfloat *) (header + 1);
+  guint r;
+
+  priors->rows = header->rows;
+  priors->count = header->count;
+  priors->stride = header->stride;
+  for (r = 0; r < header->rows; r++)
+    priors->row[r] = data + (gsize) r * header->stride;
+}
+
+/**
+ * @brief Get the hash of the text file.
+ */
+static gboolean
+_hash_text (const gchar * path, guint64 * hash)
+{
+  gchar *contents;
+  gsize len;
+
+  if (!g_file_get_contents (path, &contents, &len, NULL))
+    return FALSE;
+
+  *hash = _hash (contents, len);
+  g_free (contents);
+  return TRUE;
+}
+
+/**
+ * @brief Update the mtime in the cache, the text is not hashed again on the next start.
+ */
+static void
+_update_mtime (const gchar * cache, gint64 mtime_ns)
+{
+  gint fd = open (cache, O_WRONLY);
+
+  if (fd >= 0) {
+    if (pwrite (fd, &mtime_ns, sizeof (mtime_ns),
+            G_STRUCT_OFFSET (BoxPriorsHeader, mtime_ns)) != sizeof (mtime_ns))
+      g_warning ("box priors: failed to update %s", cache);
+    close (fd);
+  }
+}
+
+/**
+ * @brief Map the cache if it is valid for the text file.
+ */
+static gboolean
+_map_cache (BoxPriors * priors, const gchar * path, const gchar * cache,
+    const struct stat *text_st, guint rows, guint count)
+{
+  const BoxPriorsHeader *header;
+  struct stat st;
+  gpointer map;
+  gsize size;
+  guint64 hash;
+  gint fd;
+
+  fd = open (cache, O_RDONLY);
+  if (fd < 0)
+    return FALSE;
+
+  size = _cache_size (rows, ROUND_UP_16 (count));
+  if (fstat (fd, &st) != 0 || (gsize) st.st_size != size) {
+    close (fd);
+    return FALSE;
+  }
+
+  map = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    return FALSE;
+
+  header = (const BoxPriorsHeader *) map;
+  if (memcmp (header->magic, CACHE_MAGIC, sizeof (header->magic)) != 0 ||
+      header->rows != rows || header->count != count ||
+      header->text_size != (guint64) text_st->st_size ||
+      header->data_hash != _hash (header + 1, size - sizeof (BoxPriorsHeader)))
+    goto invalid;
+
+  priors->source = BOX_PRIORS_SOURCE_CACHE;
+  if (header->mtime_ns != _mtime_ns (text_st)) {
+    /* e.g., copied again to the device, the same contents */
+    if (!_hash_text (path, &hash) || hash != header->text_hash)
+      goto invalid;
+    priors->source = BOX_PRIORS_SOURCE_CACHE_HASH;
+    _update_mtime (cache, _mtime_ns (text_st));
+  }
+
+  priors->data = map;
+  priors->size = size;
+  priors->mapped = TRUE;
+  _set_rows (priors, header);
+  return TRUE;
+
+invalid:
+  munmap (map, size);
+  priors->source = BOX_PRIORS_SOURCE_NONE;
+  return FALSE;
+}
+
+/**
+ * @brief Parse the text file into the rows.
+ */
+static gboolean
+_parse_text (const gchar * contents, gfloat * data, guint rows, guint count, guint stride)
+{
+  const gchar *p = contents;
+  gchar *end;
+  guint r, c;
+
+  for (r = 0; r < rows; r++) {
+    for (c = 0; c < count; c++) {
+      while (*p == ' ' || *p == '\t' || *p == '\r')
+        p++;
+      if (*p == '\n' || *p == '\0')
+        break;
+
+      data[(gsize) r * stride + c] = (gfloat) g_ascii_strtod (p, &end);
+      if (end == p)
+        break;
+      p = end;
+    }
+
+    if (c < count) {
+      g_warning ("box priors: row %u has %u values, %u expected", r, c, count);
+      return FALSE;
+    }
+
+    /* next row */
+    while (*p != '\n' && *p != '\0')
+      p++;
+    if (*p == '\n')
+      p++;
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Write the cache, to a temporary file renamed to the cache.
+ */
+static gboolean
+_write_cache (const gchar * cache, const void *data, gsize size)
+{
+  gchar *tmp = g_strdup_printf ("%s.%d.tmp", cache, (gint) getpid ());
+  gboolean ret = FALSE;
+  gsize written = 0;
+  gssize n;
+  gint fd;
+
+  fd = open (tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd >= 0) {
+    while (written < size) {
+      n = write (fd, (const guint8 *) data + written, size - written);
+      if (n <= 0)
+        break;
+      written += n;
+    }
+
+    ret = (written == size);
+    ret &= (close (fd) == 0);
+    if (ret)
+      ret = (rename (tmp, cache) == 0);
+    if (!ret)
+      unlink (tmp);
+  }
+
+  g_free (tmp);
+  return ret;
+}
+
+/**
+ * @brief Parse the text file and write the cache.
+ */
+static gboolean
+_load_text (BoxPriors * priors, const gchar * path, const gchar * cache,
+    const struct stat *text_st, guint rows, guint count)
+{
+  BoxPriorsHeader *header;
+  gchar *contents;
+  gsize len, size;
+  guint stride = ROUND_UP_16 (count);
+  void *data = NULL;
+
+  if (!g_file_get_contents (path, &contents, &len, NULL)) {
+    g_warning ("box priors: failed to read %s", path);
+    return FALSE;
+  }
+
+  size = _cache_size (rows, stride);
+  if (posix_memalign (&data, BOX_PRIORS_ALIGN, size) != 0) {
+    g_free (contents);
+    return FALSE;
+  }
+  memset (data, 0, size);
+
+  header = (BoxPriorsHeader *) data;
+  if (!_parse_text (contents, (gfloat *) (header + 1), rows, count, stride)) {
+    g_free (contents);
+    free (data);
+    return FALSE;
+  }
+
+  memcpy (header->magic, CACHE_MAGIC, sizeof (header->magic));
+  header->rows = rows;
+  header->count = count;
+  header->stride = stride;
+  header->mtime_ns = _mtime_ns (text_st);
+  header->text_size = (guint64) text_st->st_size;
+  header->text_hash = _hash (contents, len);
+  header->data_hash = _hash (header + 1, size - sizeof (BoxPriorsHeader));
+  g_free (contents);
+
+  /* the directory of the model may be read-only, the priors are still usable */
+  priors->cache_written = _write_cache (cache, data, size);
+  priors->source = BOX_PRIORS_SOURCE_TEXT;
+  priors->data = data;
+  priors->size = size;
+  priors->mapped = FALSE;
+  _set_rows (priors, header);
+
+  return TRUE;
+}
+
+/**
+ * @brief Get the path of the cache of the text file.
+ */
+gchar *
+box_priors_cache_path (const gchar * path)
+{
+  g_return_val_if_fail (path != NULL, NULL);
+
+  return g_strconcat (path, CACHE_SUFFIX, NULL);
+}
+
+/**
+ * @brief Load the priors of the text file, from its cache if it is valid.
+ */
+gboolean
+box_priors_load (BoxPriors * priors, const gchar * path, guint rows, guint count)
+{
+  struct stat st;
+  gchar cache[4096];
+  gboolean ret = FALSE;
+
+  g_return_val_if_fail (priors != NULL, FALSE);
+  g_return_val_if_fail (path != NULL, FALSE);
+  g_return_val_if_fail (rows > 0 && rows <= BOX_PRIORS_MAX_ROWS, FALSE);
+  g_return_val_if_fail (count > 0, FALSE);
+
+  memset (priors, 0, sizeof (BoxPriors));
+
+  if (stat (path, &st) != 0) {
+    g_warning ("box priors: cannot find %s", path);
+    return FALSE;
+  }
+
+  /* no allocation if the cache is valid */
+  if (g_snprintf (cache, sizeof (cache), "%s" CACHE_SUFFIX, path) < (gint) sizeof (cache)) {
+    ret = _map_cache (priors, path, cache, &st, rows, count);
+    if (!ret)
+      ret = _load_text (priors, path, cache, &st, rows, count);
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Release the priors.
+ */
+void
+box_priors_clear (BoxPriors * priors)
+{
+  g_return_if_fail (priors != NULL);
+
+  if (priors->data) {
+    if (priors->mapped)
+      munmap (priors->data, priors->size);
+    else
+      free (priors->data);
+  }
+
+  memset (priors, 0, sizeof (BoxPriors));
+}
@@ -0,0 +1,84 @@
+/**
+ * @file	box_priors.h
+ * @date	19 October 2026
+ * @brief	Loader of the SSD box priors with a binary cache
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Gichan Jang <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ *
+ * The SSD examples parsed box_priors.txt (4 rows of 1917 values) at every start, and each
+ * example had its own copy of the parser. The loader parses the text once and writes
+ * <path>.bin next to it. On the next start the cache is mapped (mmap) without allocation
+ * if the text has the same mtime and size, or the same hash when only the mtime changed.
+ *
+ * The rows are stored as separate arrays (ycenter, xcenter, height and width of the priors),
+ * each starts at BOX_PRIORS_ALIGN bytes and is padded with 0 to a multiple of 16 values,
+ * so the decoder can read the values of consecutive priors with vector loads.
+ *
+ * usage:
+ *   BoxPriors priors;
+ *   if (box_priors_load (&priors, "box_priors.txt", 4, 1917)) {
+ *     ycenter = box[0] / Y_SCALE * priors.row[2][d] + priors.row[0][d];
+ *     box_priors_clear (&priors);
+ *   }
+ */
+#ifndef __BOX_PRIORS_H__
+#define __BOX_PRIORS_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define BOX_PRIORS_MAX_ROWS 4
+#define BOX_PRIORS_ALIGN 64
+
+/**
+ * @brief Where the priors are loaded from.
+ */
+typedef enum
+{
+  BOX_PRIORS_SOURCE_NONE = 0,
+  BOX_PRIORS_SOURCE_TEXT, /**< parsed, the cache is written if possible */
+  BOX_PRIORS_SOURCE_CACHE, /**< mapped from the cache */
+  BOX_PRIORS_SOURCE_CACHE_HASH /**< mapped from the cache, the mtime changed but the hash is the same */
+} BoxPriorsSource;
+
+/**
+ * @brief The loaded priors.
+ */
+typedef struct
+{
+  const gfloat *row[BOX_PRIORS_MAX_ROWS]; /**< aligned rows */
+  guint rows; /**< the number of rows */
+  guint count; /**< the number of priors in a row */
+  guint stride; /**< the number of values from a row to the next, multiple of 16 */
+  BoxPriorsSource source; /**< where the priors are loaded from */
+  gboolean cache_written; /**< the cache is written by this load */
+
+  gpointer data; /**< mapped cache or aligned memory */
+  gsize size;
+  gboolean mapped;
+} BoxPriors;
+
+/**
+ * @brief Load the priors of the text file, from its cache if it is valid.
+ * @param priors the priors to fill, cleared with box_priors_clear()
+ * @param path box_priors.txt, the values of a row are separated by spaces
+ * @param rows the number of rows (BOX_PRIORS_MAX_ROWS at most)
+ * @param count the number of values in each row
+ */
+extern gboolean box_priors_load (BoxPriors * priors, const gchar * path, guint rows, guint count);
+
+/**
+ * @brief Release the priors.
+ */
+extern void box_priors_clear (BoxPriors * priors);
+
+/**
+ * @brief Get the path of the cache of the text file, to be freed.
+ */
+extern gchar * box_priors_cache_path (const gchar * path);
+
+G_END_DECLS
+
+#endif /* __BOX_PRIORS_H__ */
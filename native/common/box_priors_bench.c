@@ -0,0 +1,289 @@
+/**
+ * @file	box_priors_bench.c
+ * @date	19 October 2026
+ * @brief	Benchmark the loading of the SSD box priors, text parsing vs. the binary cache
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Gichan Jang <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ *
+ * text : read the lines into a list and parse each value, as the SSD examples did.
+ * cold : box_priors_load without the cache, parses the text and writes the cache.
+ * warm : box_priors_load with the cache, maps the cache.
+ * first_us is the first load of the mode in the process, the others are averaged.
+ * Without --priors, a box_priors.txt of random values is generated.
+ *
+ * $ ./box_priors_bench --priors=tflite_model/box_priors.txt --count=100
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <glib.h>
+#include "box_priors.h"
+
+#define PRIOR_ROWS 4
+#define PRIOR_COUNT 1917
+
+/**
+ * @brief Load the priors as the SSD examples did (read_lines and tflite_load_box_priors).
+ */
+static gboolean
+_load_text (const gchar * path, gfloat priors[PRIOR_ROWS][PRIOR_COUNT])
+{
+  GList *lines = NULL;
+  gchar *line = NULL, *box_row;
+  size_t len = 0;
+  gssize n;
+  FILE *fp;
+  gint row, column, i, j;
+  gchar buff[11];
+
+  fp = fopen (path, "r");
+  if (!fp)
+    return FALSE;
+
+  while ((n = getline (&line, &len, fp)) != -1)
+    lines = g_list_append (lines, g_strdup (line));
+  free (line);
+  fclose (fp);
+
+  if (g_list_length (lines) < PRIOR_ROWS) {
+    g_list_free_full (lines, g_free);
+    return FALSE;
+  }
+
+  for (row = 0; row < PRIOR_ROWS; row++) {
+    column = 0;
+    i = j = 0;
+    memset (buff, 0, 11);
+    box_row = (gchar *) g_list_nth_data (lines, row);
+
+    while (box_row[i] != '\n' && box_row[i] != '\0' && column < PRIOR_COUNT) {
+      if (box_row[i] != ' ') {
+        if (j < 10)
+          buff[j++] = box_row[i];
+      } else {
+        if (j != 0) {
+          priors[row][column++] = (gfloat) atof (buff);
+          memset (buff, 0, 11);
+        }
+        j = 0;
+      }
+      i++;
+    }
+
+    if (j != 0 && column < PRIOR_COUNT)
+      priors[row][column++] = (gfloat) atof (buff);
+  }
+
+  g_list_free_full (lines, g_free);
+  return TRUE;
+}
+
+/**
+ * @brief Write box_priors.txt of random values.
+ */
+static gboolean
+_generate (const gchar * path)
+{
+  FILE *fp = fopen (path, "w");
+  gint row, column;
+
+  if (!fp)
+    return FALSE;
+
+  for (row = 0; row < PRIOR_ROWS; row++) {
+    for (column = 0; column < PRIOR_COUNT; column++)
+      fprintf (fp, "%.8f ", g_random_double ());
+    fprintf (fp, "\n");
+  }
+
+  return (fclose (fp) == 0);
+}
+
+/**
+ * @brief Get the max difference of the priors.
+ */
+static gdouble
+_diff (const BoxPriors * priors, gfloat text[PRIOR_ROWS][PRIOR_COUNT])
+{
+  gdouble diff = 0;
+  gint row, column;
+
+  for (row = 0; row < PRIOR_ROWS; row++) {
+    for (column = 0; column < PRIOR_COUNT; column++)
+      diff = MAX (diff, ABS ((gdouble) priors->row[row][column] - text[row][column]));
+  }
+
+  return diff;
+}
+
+/**
+ * @brief Name of the source.
+ */
+static const gchar *
+_source_name (BoxPriorsSource source)
+{
+  switch (source) {
+    case BOX_PRIORS_SOURCE_TEXT:
+      return "text";
+    case BOX_PRIORS_SOURCE_CACHE:
+      return "cache";
+    case BOX_PRIORS_SOURCE_CACHE_HASH:
+      return "cache_hash";
+    default:
+      break;
+  }
+
+  return "none";
+}
+
+/**
+ * @brief Load the priors count times and print the row.
+ */
+static gboolean
+_run_bench (const gchar * mode, const gchar * path, guint count,
+    gfloat text[PRIOR_ROWS][PRIOR_COUNT])
+{
+  static gfloat loaded[PRIOR_ROWS][PRIOR_COUNT];
+  BoxPriors priors;
+  gchar *cache = box_priors_cache_path (path);
+  gint64 start, elapsed, first = 0, total = 0, min = G_MAXINT64, max = 0;
+  const gchar *source = "text";
+  gdouble diff = 0;
+  gboolean ret = TRUE;
+  guint i;
+
+  for (i = 0; i < count && ret; i++) {
+    if (g_str_equal (mode, "cold"))
+      unlink (cache);
+
+    start = g_get_monotonic_time ();
+    if (g_str_equal (mode, "text")) {
+      ret = _load_text (path, loaded);
+      elapsed = g_get_monotonic_time () - start;
+    } else {
+      ret = box_priors_load (&priors, path, PRIOR_ROWS, PRIOR_COUNT);
+      elapsed = g_get_monotonic_time () - start;
+      if (ret) {
+        source = _source_name (priors.source);
+        diff = MAX (diff, _diff (&priors, text));
+        box_priors_clear (&priors);
+      }
+    }
+
+    if (i == 0) {
+      first = elapsed;
+    } else {
+      total += elapsed;
+      min = MIN (min, elapsed);
+      max = MAX (max, elapsed);
+    }
+  }
+
+  if (ret) {
+    g_print ("%s,%s,%u,%" G_GINT64_FORMAT ",%.1f,%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT
+        ",%g\n", mode, source, count, first, count > 1 ? (gdouble) total / (count - 1) : 0.0,
+        count > 1 ? min : 0, max, diff);
+  } else {
+    g_printerr ("Failed to load %s (%s)\n", path, mode);
+  }
+
+  g_free (cache);
+  return ret;
+}
+
+/**
+ * @brief Print usage info.
+ */
+static void
+_usage (void)
+{
+  g_print ("usage: box_priors_bench [options]\n"
+      "    --priors  box_priors.txt (4 rows of 1917 values). (default: random values)\n"
+      "    --count   Number of loads of each mode. (default 100)\n"
+      "    --modes   Comma-separated text, cold and warm. (default text,cold,warm)\n");
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  static gfloat text[PRIOR_ROWS][PRIOR_COUNT];
+  gchar *path = NULL, *tmp_dir = NULL, *cache;
+  gchar *modes_str = g_strdup ("text,cold,warm");
+  gchar **modes;
+  guint i, count = 100;
+  gint o, ret = 0;
+  struct option long_options[] = {
+    {"priors", required_argument, NULL, 'p'},
+    {"count", required_argument, NULL, 'c'},
+    {"modes", required_argument, NULL, 'o'},
+    {"help", no_argument, NULL, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  while ((o = getopt_long (argc, argv, "p:c:o:h", long_options, NULL)) != -1) {
+    switch (o) {
+      case 'p':
+        g_free (path);
+        path = g_strdup (optarg);
+        break;
+      case 'c':
+        count = MAX ((guint) g_ascii_strtoull (optarg, NULL, 10), 1U);
+        break;
+      case 'o':
+        g_free (modes_str);
+        modes_str = g_strdup (optarg);
+        break;
+      default:
+        _usage ();
+        g_free (path);
+        g_free (modes_str);
+        return 0;
+    }
+  }
+
+  if (!path) {
+    tmp_dir = g_dir_make_tmp ("box_priors_XXXXXX", NULL);
+    path = g_build_filename (tmp_dir, "box_priors.txt", NULL);
+    if (!tmp_dir || !_generate (path)) {
+      g_printerr ("Failed to generate %s\n", path);
+      ret = -1;
+      goto done;
+    }
+  }
+
+  if (!_load_text (path, text)) {
+    g_printerr ("Failed to load %s\n", path);
+    ret = -1;
+    goto done;
+  }
+
+  g_print ("mode,source,count,first_us,avg_us,min_us,max_us,max_diff\n");
+
+  modes = g_strsplit (modes_str, ",", -1);
+  for (i = 0; modes[i]; i++) {
+    if (!_run_bench (modes[i], path, count, text))
+      ret = -1;
+  }
+  g_strfreev (modes);
+
+done:
+  if (tmp_dir) {
+    cache = box_priors_cache_path (path);
+    unlink (cache);
+    unlink (path);
+    rmdir (tmp_dir);
+    g_free (cache);
+    g_free (tmp_dir);
+  }
+
+  g_free (path);
+  g_free (modes_str);
+  return ret;
+}
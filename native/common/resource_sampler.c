@@ -0,0 +1,544 @@
+/**
+ * @file	resource_sampler.c
+ * @date	19 October 2026
+ * @brief	In-process sampler of CPU, memory, context switches and page faults
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Gichan Jang <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "resource_sampler.h"
+
+/**
+ * @brief Counters of a thread or the process from /proc.
+ */
+typedef struct
+{
+  guint64 ticks; /**< utime + stime in clock ticks */
+  guint64 minflt; /**< minor page faults */
+  guint64 majflt; /**< major page faults */
+  guint64 vcsw; /**< voluntary context switches */
+  guint64 ivcsw; /**< involuntary context switches */
+  guint64 run_ns; /**< time on the CPU (schedstat) */
+  guint64 wait_ns; /**< time waited on the run queue (schedstat) */
+  gboolean has_schedstat; /**< schedstat is available */
+} SamplerCounters;
+
+/**
+ * @brief A thread seen by the sampler.
+ */
+typedef struct
+{
+  gint tid; /**< thread id */
+  gchar name[32]; /**< thread name */
+  SamplerCounters first; /**< counters when the thread is seen first */
+  SamplerCounters last; /**< counters of the last sample */
+} SamplerTask;
+
+/**
+ * @brief Resource sampler.
+ */
+struct _ResourceSampler
+{
+  guint interval_ms; /**< sampling interval */
+  ResourceSamplerFlags flags; /**< flags */
+  glong page_kb; /**< page size in KB */
+  glong clk_tck; /**< clock ticks per second */
+
+  GThread *thread; /**< sampling thread */
+  GMutex lock; /**< lock for the data below */
+  GCond cond; /**< signaled to stop */
+  gboolean running; /**< sampling thread is running */
+
+  gint64 start_time; /**< time of the first sample */
+  gint64 last_time; /**< time of the last sample */
+  SamplerCounters proc_first; /**< process counters of the first sample */
+  SamplerCounters proc_last; /**< process counters of the last sample */
+  GHashTable *tasks; /**< tid to SamplerTask */
+
+  guint samples; /**< number of samples after the first one */
+  gdouble cpu_max; /**< max CPU usage in an interval */
+  guint64 rss_sum_kb; /**< sum of RSS for the average */
+  guint64 rss_peak_kb; /**< peak RSS */
+  guint64 hwm_kb; /**< VmHWM */
+  guint64 pss_peak_kb; /**< peak PSS */
+  guint threads_max; /**< max number of threads */
+};
+
+/**
+ * @brief Read a small file in /proc without allocation.
+ * @return TRUE if the file is read
+ */
+static gboolean
+_read_file (const gchar * path, gchar * buf, gsize len)
+{
+  gssize n;
+  gint fd;
+
+  fd = open (path, O_RDONLY);
+  if (fd < 0)
+    return FALSE;
+
+  n = read (fd, buf, len - 1);
+  close (fd);
+
+  if (n <= 0)
+    return FALSE;
+
+  buf[n] = '\0';
+  return TRUE;
+}
+
+/**
+ * @brief Get the value of a key in /proc/.../status, e.g., "VmRSS:".
+ */
+static guint64
+_status_value (const gchar * buf, const gchar * key)
+{
+  const gchar *p = strstr (buf, key);
+
+  if (p == NULL)
+    return 0;
+
+  return g_ascii_strtoull (p + strlen (key), NULL, 10);
+}
+
+/**
+ * @brief Parse /proc/.../stat, the name may have spaces and parentheses.
+ * @return number of threads (field 20), 0 if failed
+ */
+static guint
+_parse_stat (const gchar * buf, gchar * name, gsize name_len, SamplerCounters * c)
+{
+  const gchar *open_paren, *close_paren;
+  unsigned long long minflt, majflt, utime, stime;
+  long num_threads;
+
+  open_paren = strchr (buf, '(');
+  close_paren = strrchr (buf, ')');
+  if (open_paren == NULL || close_paren == NULL || close_paren < open_paren)
+    return 0;
+
+  if (name) {
+    gsize len = MIN ((gsize) (close_paren - open_paren - 1), name_len - 1);
+
+    memcpy (name, open_paren + 1, len);
+    name[len] = '\0';
+  }
+
+  /* fields from 3 (state) to 20 (num_threads) */
+  if (sscanf (close_paren + 1, " %*c %*d %*d %*d %*d %*d %*u %llu %*u %llu %*u %llu %llu "
+          "%*d %*d %*d %*d %ld", &minflt, &majflt, &utime, &stime, &num_threads) != 5)
+    return 0;
+
+  c->minflt = minflt;
+  c->majflt = majflt;
+  c->ticks = utime + stime;
+  return (guint) MAX (num_threads, 1);
+}
+
+/**
+ * @brief Read the counters of a thread.
+ */
+static gboolean
+_read_task (gint tid, gchar * name, gsize name_len, SamplerCounters * c)
+{
+  gchar path[64];
+  gchar buf[2048];
+  unsigned long long run_ns, wait_ns;
+
+  memset (c, 0, sizeof (SamplerCounters));
+
+  g_snprintf (path, sizeof (path), "/proc/self/task/%d/stat", tid);
+  if (!_read_file (path, buf, sizeof (buf)) || _parse_stat (buf, name, name_len, c) == 0)
+    return FALSE;
+
+  g_snprintf (path, sizeof (path), "/proc/self/task/%d/status", tid);
+  if (_read_file (path, buf, sizeof (buf))) {
+    c->vcsw = _status_value (buf, "\nvoluntary_ctxt_switches:");
+    c->ivcsw = _status_value (buf, "\nnonvoluntary_ctxt_switches:");
+  }
+
+  g_snprintf (path, sizeof (path), "/proc/self/task/%d/schedstat", tid);
+  if (_read_file (path, buf, sizeof (buf)) &&
+      sscanf (buf, "%llu %llu", &run_ns, &wait_ns) == 2) {
+    c->run_ns = run_ns;
+    c->wait_ns = wait_ns;
+    c->has_schedstat = TRUE;
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Sample the threads, and get the CPU time (ns) of all threads in the interval.
+ * @return CPU time in the interval, -1 if schedstat is not available
+ */
+static gint64
+_sample_tasks (ResourceSampler * sampler)
+{
+  GDir *dir;
+  const gchar *entry;
+  SamplerTask *task;
+  SamplerCounters c;
+  gchar name[32];
+  gint64 run_ns = 0;
+  gboolean has_schedstat = TRUE;
+  gint tid;
+
+  dir = g_dir_open ("/proc/self/task", 0, NULL);
+  if (dir == NULL)
+    return -1;
+
+  while ((entry = g_dir_read_name (dir)) != NULL) {
+    tid = (gint) g_ascii_strtoll (entry, NULL, 10);
+    if (tid <= 0 || !_read_task (tid, name, sizeof (name), &c))
+      continue;
+
+    task = (SamplerTask *) g_hash_table_lookup (sampler->tasks, GINT_TO_POINTER (tid));
+    if (task == NULL) {
+      task = g_new0 (SamplerTask, 1);
+      task->tid = tid;
+
+      /* a new thread after the first sample, count from 0 */
+      if (sampler->start_time > 0)
+        memset (&task->first, 0, sizeof (SamplerCounters));
+      else
+        task->first = c;
+      task->last = task->first;
+
+      g_hash_table_insert (sampler->tasks, GINT_TO_POINTER (tid), task);
+    }
+
+    g_strlcpy (task->name, name, sizeof (task->name));
+    has_schedstat = has_schedstat && c.has_schedstat;
+    run_ns += (gint64) (c.run_ns - task->last.run_ns);
+    task->last = c;
+  }
+
+  g_dir_close (dir);
+  return has_schedstat ? run_ns : -1;
+}
+
+/**
+ * @brief Take a sample. Called with the lock.
+ */
+static void
+_sample (ResourceSampler * sampler)
+{
+  gchar buf[4096];
+  SamplerCounters proc;
+  unsigned long long size, resident;
+  guint64 rss_kb = 0, pss_kb;
+  gint64 now, task_ns;
+  gdouble cpu, interval_ms;
+  guint threads = 0;
+
+  memset (&proc, 0, sizeof (SamplerCounters));
+  if (_read_file ("/proc/self/stat", buf, sizeof (buf)))
+    threads = _parse_stat (buf, NULL, 0, &proc);
+
+  if (_read_file ("/proc/self/statm", buf, sizeof (buf)) &&
+      sscanf (buf, "%llu %llu", &size, &resident) == 2)
+    rss_kb = resident * sampler->page_kb;
+
+  if (_read_file ("/proc/self/status", buf, sizeof (buf)))
+    sampler->hwm_kb = _status_value (buf, "\nVmHWM:");
+
+  if ((sampler->flags & RESOURCE_SAMPLER_PSS) &&
+      _read_file ("/proc/self/smaps_rollup", buf, sizeof (buf))) {
+    pss_kb = _status_value (buf, "\nPss:");
+    sampler->pss_peak_kb = MAX (sampler->pss_peak_kb, pss_kb);
+  }
+
+  task_ns = _sample_tasks (sampler);
+  now = g_get_monotonic_time ();
+
+  if (sampler->start_time == 0) {
+    sampler->start_time = now;
+    sampler->proc_first = proc;
+  } else {
+    interval_ms = MAX (now - sampler->last_time, 1) / 1000.0;
+
+    /* schedstat is in ns, the clock tick is 10 ms in most systems */
+    if (task_ns >= 0)
+      cpu = task_ns / 1e6 / interval_ms * 100.0;
+    else
+      cpu = (proc.ticks - sampler->proc_last.ticks) * 1000.0 / sampler->clk_tck /
+          interval_ms * 100.0;
+
+    sampler->cpu_max = MAX (sampler->cpu_max, cpu);
+    sampler->rss_sum_kb += rss_kb;
+    sampler->samples++;
+  }
+
+  sampler->last_time = now;
+  sampler->proc_last = proc;
+  sampler->rss_peak_kb = MAX (sampler->rss_peak_kb, rss_kb);
+  sampler->threads_max = MAX (sampler->threads_max, threads);
+}
+
+/**
+ * @brief Sampling thread.
+ */
+static gpointer
+_sampler_thread (gpointer data)
+{
+  ResourceSampler *sampler = (ResourceSampler *) data;
+  gint64 end_time;
+
+  g_mutex_lock (&sampler->lock);
+  while (sampler->running) {
+    end_time = g_get_monotonic_time () + sampler->interval_ms * G_TIME_SPAN_MILLISECOND;
+
+    while (sampler->running && g_cond_wait_until (&sampler->cond, &sampler->lock, end_time))
+      ;
+
+    if (sampler->running)
+      _sample (sampler);
+  }
+  g_mutex_unlock (&sampler->lock);
+
+  return NULL;
+}
+
+/**
+ * @brief Create the sampler.
+ * @param interval_ms sampling interval in milliseconds
+ * @param flags RESOURCE_SAMPLER_THREADS to report each thread, RESOURCE_SAMPLER_PSS to read PSS
+ */
+ResourceSampler *
+resource_sampler_new (guint interval_ms, ResourceSamplerFlags flags)
+{
+  ResourceSampler *sampler;
+
+  sampler = g_new0 (ResourceSampler, 1);
+  sampler->interval_ms = MAX (interval_ms, 1U);
+  sampler->flags = flags;
+  sampler->page_kb = MAX (sysconf (_SC_PAGESIZE) / 1024, 1L);
+  sampler->clk_tck = MAX (sysconf (_SC_CLK_TCK), 1L);
+  sampler->tasks = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+  g_mutex_init (&sampler->lock);
+  g_cond_init (&sampler->cond);
+
+  return sampler;
+}
+
+/**
+ * @brief Take the first sample and start the sampling thread. The previous result is cleared.
+ */
+gboolean
+resource_sampler_start (ResourceSampler * sampler)
+{
+  g_return_val_if_fail (sampler != NULL, FALSE);
+  g_return_val_if_fail (sampler->thread == NULL, FALSE);
+
+  g_mutex_lock (&sampler->lock);
+  g_hash_table_remove_all (sampler->tasks);
+  sampler->start_time = sampler->last_time = 0;
+  sampler->samples = 0;
+  sampler->cpu_max = 0.0;
+  sampler->rss_sum_kb = sampler->rss_peak_kb = sampler->hwm_kb = sampler->pss_peak_kb = 0;
+  sampler->threads_max = 0;
+
+  _sample (sampler);
+  sampler->running = TRUE;
+  g_mutex_unlock (&sampler->lock);
+
+  sampler->thread = g_thread_new ("res-sampler", _sampler_thread, sampler);
+  return TRUE;
+}
+
+/**
+ * @brief Stop the sampling thread and take the last sample.
+ */
+void
+resource_sampler_stop (ResourceSampler * sampler)
+{
+  g_return_if_fail (sampler != NULL);
+
+  if (sampler->thread == NULL)
+    return;
+
+  g_mutex_lock (&sampler->lock);
+  sampler->running = FALSE;
+  g_cond_signal (&sampler->cond);
+  g_mutex_unlock (&sampler->lock);
+
+  g_thread_join (sampler->thread);
+  sampler->thread = NULL;
+
+  g_mutex_lock (&sampler->lock);
+  _sample (sampler);
+  g_mutex_unlock (&sampler->lock);
+}
+
+/**
+ * @brief Compare function to sort the threads by CPU time.
+ */
+static gint
+_compare_thread (gconstpointer a, gconstpointer b)
+{
+  const ResourceSamplerThread *ta = (const ResourceSamplerThread *) a;
+  const ResourceSamplerThread *tb = (const ResourceSamplerThread *) b;
+
+  return (ta->cpu_ms < tb->cpu_ms) ? 1 : ((ta->cpu_ms > tb->cpu_ms) ? -1 : 0);
+}
+
+/**
+ * @brief Get the report from start to the last sample. Call resource_sampler_report_clear () after use.
+ */
+void
+resource_sampler_get_report (ResourceSampler * sampler, ResourceSamplerReport * report)
+{
+  GHashTableIter iter;
+  gpointer value;
+  SamplerTask *task;
+  ResourceSamplerThread *t;
+  gdouble elapsed_ms;
+  guint i = 0;
+
+  g_return_if_fail (sampler != NULL && report != NULL);
+
+  memset (report, 0, sizeof (ResourceSamplerReport));
+
+  g_mutex_lock (&sampler->lock);
+
+  report->samples = sampler->samples;
+  report->elapsed_sec = (sampler->last_time - sampler->start_time) / (gdouble) G_USEC_PER_SEC;
+  elapsed_ms = MAX (report->elapsed_sec * 1000.0, 1.0);
+
+  report->cpu_percent_avg = (sampler->proc_last.ticks - sampler->proc_first.ticks) *
+      1000.0 / sampler->clk_tck / elapsed_ms * 100.0;
+  report->cpu_percent_max = MAX (sampler->cpu_max, report->cpu_percent_avg);
+  report->rss_mb_avg = sampler->samples ?
+      sampler->rss_sum_kb / 1024.0 / sampler->samples : sampler->rss_peak_kb / 1024.0;
+  report->rss_mb_peak = sampler->rss_peak_kb / 1024.0;
+  report->hwm_mb = sampler->hwm_kb / 1024.0;
+  report->pss_mb_peak = sampler->pss_peak_kb / 1024.0;
+  report->minor_faults = sampler->proc_last.minflt - sampler->proc_first.minflt;
+  report->major_faults = sampler->proc_last.majflt - sampler->proc_first.majflt;
+  report->threads_max = sampler->threads_max;
+
+  if (sampler->flags & RESOURCE_SAMPLER_THREADS) {
+    report->num_threads = g_hash_table_size (sampler->tasks);
+    report->threads = g_new0 (ResourceSamplerThread, MAX (report->num_threads, 1U));
+  }
+
+  g_hash_table_iter_init (&iter, sampler->tasks);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    task = (SamplerTask *) value;
+
+    report->vol_ctxsw += task->last.vcsw - task->first.vcsw;
+    report->invol_ctxsw += task->last.ivcsw - task->first.ivcsw;
+    report->run_delay_ms += (task->last.wait_ns - task->first.wait_ns) / 1e6;
+
+    if (report->threads == NULL)
+      continue;
+
+    t = &report->threads[i++];
+    t->tid = task->tid;
+    g_strlcpy (t->name, task->name, sizeof (t->name));
+    if (task->last.has_schedstat)
+      t->cpu_ms = (task->last.run_ns - task->first.run_ns) / 1e6;
+    else
+      t->cpu_ms = (task->last.ticks - task->first.ticks) * 1000.0 / sampler->clk_tck;
+    t->cpu_percent = t->cpu_ms / elapsed_ms * 100.0;
+    t->vol_ctxsw = task->last.vcsw - task->first.vcsw;
+    t->invol_ctxsw = task->last.ivcsw - task->first.ivcsw;
+    t->minor_faults = task->last.minflt - task->first.minflt;
+    t->major_faults = task->last.majflt - task->first.majflt;
+    t->run_delay_ms = (task->last.wait_ns - task->first.wait_ns) / 1e6;
+  }
+
+  g_mutex_unlock (&sampler->lock);
+
+  if (report->threads)
+    qsort (report->threads, report->num_threads, sizeof (ResourceSamplerThread), _compare_thread);
+}
+
+/**
+ * @brief Free the data in the report.
+ */
+void
+resource_sampler_report_clear (ResourceSamplerReport * report)
+{
+  g_return_if_fail (report != NULL);
+
+  g_free (report->threads);
+  report->threads = NULL;
+  report->num_threads = 0;
+}
+
+/**
+ * @brief Stop and free the sampler.
+ */
+void
+resource_sampler_free (ResourceSampler * sampler)
+{
+  g_return_if_fail (sampler != NULL);
+
+  resource_sampler_stop (sampler);
+
+  g_hash_table_destroy (sampler->tasks);
+  g_mutex_clear (&sampler->lock);
+  g_cond_clear (&sampler->cond);
+  g_free (sampler);
+}
+
+/**
+ * @brief Get the CSV header of the report, the columns of resource_sampler_csv_row ().
+ */
+const gchar *
+resource_sampler_csv_header (void)
+{
+  return "cpu_avg_pct,cpu_max_pct,rss_avg_mb,rss_peak_mb,hwm_mb,pss_peak_mb,"
+      "minor_faults,major_faults,vol_ctxsw,invol_ctxsw,run_delay_ms,threads";
+}
+
+/**
+ * @brief Get the report as a CSV row. Free the string with g_free ().
+ */
+gchar *
+resource_sampler_csv_row (const ResourceSamplerReport * report)
+{
+  g_return_val_if_fail (report != NULL, NULL);
+
+  return g_strdup_printf ("%.1f,%.1f,%.2f,%.2f,%.2f,%.2f,%" G_GUINT64_FORMAT ",%"
+      G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT ",%.2f,%u",
+      report->cpu_percent_avg, report->cpu_percent_max, report->rss_mb_avg,
+      report->rss_mb_peak, report->hwm_mb, report->pss_mb_peak, report->minor_faults,
+      report->major_faults, report->vol_ctxsw, report->invol_ctxsw,
+      report->run_delay_ms, report->threads_max);
+}
+
+/**
+ * @brief Print the threads in the report as CSV, with RESOURCE_SAMPLER_THREADS.
+ */
+void
+resource_sampler_print_threads (const ResourceSamplerReport * report, FILE * out)
+{
+  const ResourceSamplerThread *t;
+  guint i;
+
+  g_return_if_fail (report != NULL && out != NULL);
+
+  if (report->num_threads == 0)
+    return;
+
+  fprintf (out, "thread,tid,name,cpu_ms,cpu_pct,vol_ctxsw,invol_ctxsw,"
+      "minor_faults,major_faults,run_delay_ms\n");
+
+  for (i = 0; i < report->num_threads; i++) {
+    t = &report->threads[i];
+    fprintf (out, "thread,%d,%s,%.1f,%.1f,%" G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT
+        ",%" G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT ",%.2f\n", t->tid, t->name,
+        t->cpu_ms, t->cpu_percent, t->vol_ctxsw, t->invol_ctxsw, t->minor_faults,
+        t->major_faults, t->run_delay_ms);
+  }
+  fflush (out);
+}
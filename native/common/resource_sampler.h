@@ -0,0 +1,100 @@
+/**
+ * @file	resource_sampler.h
+ * @date	19 October 2026
+ * @brief	In-process sampler of CPU, memory, context switches and page faults
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Gichan Jang <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ *
+ * The profiling scripts polled ps/pidstat once a second from bash, so they could not see short spikes
+ * and picked the process with grep. The sampler runs a background thread in the benchmark process,
+ * and reads /proc/self/stat, statm, status and the stat, status and schedstat of each thread
+ * (/proc/self/task/TID) at the given interval.
+ *
+ * usage:
+ *   sampler = resource_sampler_new (100, RESOURCE_SAMPLER_THREADS);
+ *   resource_sampler_start (sampler);
+ *   (run the benchmark)
+ *   resource_sampler_stop (sampler);
+ *   resource_sampler_get_report (sampler, &report);
+ *   row = resource_sampler_csv_row (&report);
+ *   g_print ("fps,%s\n%.2f,%s\n", resource_sampler_csv_header (), fps, row);
+ *   resource_sampler_report_clear (&report);
+ *   resource_sampler_free (sampler);
+ *
+ * CPU usage is in percent of a core (200 means two cores are busy).
+ * A thread created and exited between two samples is counted in the process CPU time only.
+ */
+#ifndef __RESOURCE_SAMPLER_H__
+#define __RESOURCE_SAMPLER_H__
+
+#include <stdio.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Flags of the sampler.
+ */
+typedef enum
+{
+  RESOURCE_SAMPLER_DEFAULT = 0,
+  RESOURCE_SAMPLER_THREADS = (1 << 0), /**< report each thread */
+  RESOURCE_SAMPLER_PSS = (1 << 1) /**< read PSS from smaps_rollup, costs more than RSS */
+} ResourceSamplerFlags;
+
+/**
+ * @brief Resource usage of a thread between start and stop.
+ */
+typedef struct
+{
+  gint tid; /**< thread id */
+  gchar name[32]; /**< thread name (comm) */
+  gdouble cpu_ms; /**< CPU time */
+  gdouble cpu_percent; /**< CPU usage */
+  guint64 vol_ctxsw; /**< voluntary context switches */
+  guint64 invol_ctxsw; /**< involuntary context switches */
+  guint64 minor_faults; /**< minor page faults */
+  guint64 major_faults; /**< major page faults */
+  gdouble run_delay_ms; /**< time waited on the run queue */
+} ResourceSamplerThread;
+
+/**
+ * @brief Resource usage of the process between start and stop.
+ */
+typedef struct
+{
+  guint samples; /**< number of samples */
+  gdouble elapsed_sec; /**< time from start to stop */
+  gdouble cpu_percent_avg; /**< average CPU usage */
+  gdouble cpu_percent_max; /**< max CPU usage in a sampling interval */
+  gdouble rss_mb_avg; /**< average RSS */
+  gdouble rss_mb_peak; /**< peak RSS of the samples */
+  gdouble hwm_mb; /**< peak RSS from the kernel (VmHWM), includes the time before start */
+  gdouble pss_mb_peak; /**< peak PSS, 0 without RESOURCE_SAMPLER_PSS */
+  guint64 minor_faults; /**< minor page faults */
+  guint64 major_faults; /**< major page faults */
+  guint64 vol_ctxsw; /**< voluntary context switches of all threads */
+  guint64 invol_ctxsw; /**< involuntary context switches of all threads */
+  gdouble run_delay_ms; /**< time all threads waited on the run queue */
+  guint threads_max; /**< max number of threads */
+  ResourceSamplerThread *threads; /**< threads sorted by CPU time, with RESOURCE_SAMPLER_THREADS */
+  guint num_threads; /**< number of threads in the array */
+} ResourceSamplerReport;
+
+typedef struct _ResourceSampler ResourceSampler;
+
+extern ResourceSampler * resource_sampler_new (guint interval_ms, ResourceSamplerFlags flags);
+extern gboolean resource_sampler_start (ResourceSampler * sampler);
+extern void resource_sampler_stop (ResourceSampler * sampler);
+extern void resource_sampler_get_report (ResourceSampler * sampler, ResourceSamplerReport * report);
+extern void resource_sampler_report_clear (ResourceSamplerReport * report);
+extern void resource_sampler_free (ResourceSampler * sampler);
+
+extern const gchar * resource_sampler_csv_header (void);
+extern gchar * resource_sampler_csv_row (const ResourceSamplerReport * report);
+extern void resource_sampler_print_threads (const ResourceSamplerReport * report, FILE * out);
+
+G_END_DECLS
+
+#endif /* __RESOURCE_SAMPLER_H__ */
@@ -0,0 +1,79 @@
+#!/usr/bin/env bash
+# Cold and warm first-result latency of the detection and classification examples.
+# cold: a new plugin registry (gst_init scans the plugins) and no box priors cache,
+#       the page cache is dropped if run as root.
+# warm: the same command again, the registry, the cache and the files are in place.
+# Each run is done without and with --parallel-init.
+# usage: ./startup_benchmark.sh [RUNS] [SRC]
+RUNS=${1:-5}
+SRC=${2:-videotestsrc}
+DET=./nnstreamer_example_object_detection_tflite_2cam
+CLS=./nnstreamer_example_image_classification_tflite
+
+export GST_REGISTRY=$(mktemp -u /tmp/startup_registry_XXXXXX.bin)
+trap 'rm -f "$GST_REGISTRY"' EXIT
+
+# start from a new registry and no cache
+cold () {
+  rm -f "$GST_REGISTRY" tflite_model/box_priors.txt.bin
+  if [ "$(id -u)" = "0" ]; then
+    sync
+    echo 3 > /proc/sys/vm/drop_caches
+  fi
+}
+
+# run the app and print a row from the startup phases
+# usage: run APP START INIT COMMAND...
+run () {
+  local app=$1 start=$2 init=$3
+  shift 3
+  timeout 120 "$@" --trace-startup --until-first-result 2>/dev/null | awk -F, \
+      -v app=$app -v start=$start -v init=$init '
+    $1 == "exec" { exec_ms = $4 }
+    $1 == "gst_init" { gst = $3 - $2 }
+    $1 == "parse" { parse = $3 - $2 }
+    $1 == "set_state_playing" { playing = $3 - $2 }
+    $1 == "wait:loaders" { wait = $3 - $2 }
+    $1 ~ /^load:/ { load += $3 - $2 }
+    $1 == "first_result" { first = $3 }
+    END {
+      if (first == "")
+        printf "%s,%s,%s,NA,NA,NA,NA,NA,NA,NA\n", app, start, init;
+      else
+        printf "%s,%s,%s,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", app, start, init,
+            exec_ms, gst, parse, playing, load, wait, first;
+    }'
+}
+
+# usage: bench APP COMMAND...
+bench () {
+  local app=$1 init
+  shift
+  for init in serial parallel; do
+    local opt=""
+    [ "$init" = "parallel" ] && opt="--parallel-init"
+    cold
+    run $app cold $init "$@" $opt
+    for i in $(seq $RUNS); do
+      run $app warm $init "$@" $opt
+    done
+  done
+}
+
+ROWS=$(
+  [ -x $DET ] && bench detection $DET batch --cams=1 --src=$SRC --headless --seconds=60
+  [ -x $CLS ] && bench classification $CLS --src=$SRC --headless
+)
+
+echo "app,start,init,exec_ms,gst_init_ms,parse_ms,set_state_playing_ms,load_ms,wait_loaders_ms,first_result_ms"
+echo "$ROWS"
+
+# average of the runs (first_result_ms is from main, exec_ms is before main)
+echo
+echo "app,start,init,runs,first_result_ms,exec_ms"
+echo "$ROWS" | awk -F, '$10 != "NA" && NF == 10 {
+  key = $1 "," $2 "," $3; n[key]++; first[key] += $10; exec_ms[key] += $4
+} END {
+  for (key in n)
+    printf "%s,%d,%.1f,%.1f\n", key, n[key], first[key] / n[key], exec_ms[key] / n[key];
+}' | sort
@@ -0,0 +1,663 @@
+/**
+ * @file	startup_tracer.c
+ * @date	19 October 2026
+ * @brief	Startup-time tracer and parallel initialization of the example pipelines
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Gichan Jang <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "startup_tracer.h"
+
+/**
+ * @brief A recorded phase, the times are relative to the creation of the tracer.
+ */
+typedef struct
+{
+  gchar *phase;
+  gint64 start; /**< usec */
+  gint64 end; /**< usec */
+} StartupPhase;
+
+/**
+ * @brief A pad probe or a signal handler connected by the tracer.
+ */
+typedef struct
+{
+  StartupTracer *tracer;
+  gpointer object; /**< GstPad (probe) or GstElement (pad-added), referenced */
+  gulong id;
+  gboolean is_probe;
+  gint removed; /**< the probe is removed after the first buffer */
+  gchar *phase; /**< phase of the first buffer */
+} StartupHook;
+
+/**
+ * @brief Startup tracer.
+ */
+struct _StartupTracer
+{
+  GMutex lock;
+  gint64 origin; /**< monotonic time of startup_tracer_new */
+  gint64 exec_us; /**< time from the start of the process to origin, -1 if unknown */
+  GArray *phases; /**< StartupPhase */
+  GHashTable *recorded; /**< names of the recorded phases */
+  GPtrArray *hooks; /**< StartupHook */
+
+  GstElement *pipeline;
+  GstBus *bus;
+  gulong sync_id; /**< handler of the state-changed sync message */
+  gulong deep_id; /**< handler of deep-element-added */
+
+  gint has_result;
+  gint64 first_result;
+};
+
+/**
+ * @brief A loader of StartupTasks.
+ */
+typedef struct
+{
+  StartupTasks *tasks;
+  gchar *name;
+  StartupTaskFunc func;
+  gpointer user_data;
+  GThread *thread; /**< NULL if it is run in startup_tasks_add */
+} StartupTask;
+
+/**
+ * @brief Loaders run on worker threads.
+ */
+struct _StartupTasks
+{
+  GMutex lock;
+  GCond cond;
+  gboolean threaded;
+  StartupTracer *tracer;
+  GPtrArray *tasks; /**< StartupTask */
+  guint pending; /**< loaders not finished */
+  gint done; /**< no loader is pending, read without the lock */
+  gboolean failed; /**< a loader failed */
+};
+
+static void _attach_element (StartupTracer * tracer, GstElement * element);
+
+/**
+ * @brief Get the time from the start of the process, -1 if unknown.
+ * The start time in /proc/self/stat is in clock ticks (10 msec in general).
+ */
+static gint64
+_process_age_us (void)
+{
+  gint64 age = -1;
+#ifdef CLOCK_BOOTTIME
+  gchar *contents = NULL;
+  gchar **fields;
+  gchar *p;
+  struct timespec ts;
+  guint64 start_ticks;
+  glong hz = sysconf (_SC_CLK_TCK);
+
+  if (hz <= 0 || !g_file_get_contents ("/proc/self/stat", &contents, NULL, NULL))
+    return -1;
+
+  /* comm may have spaces, the fields after comm start from the state (3rd) */
+  p = strrchr (contents, ')');
+  if (p && p[1] == ' ') {
+    fields = g_strsplit (p + 2, " ", -1);
+
+    /* starttime is the 22nd field, in clock ticks since boot */
+    if (g_strv_length (fields) > 19 && clock_gettime (CLOCK_BOOTTIME, &ts) == 0) {
+      start_ticks = g_ascii_strtoull (fields[19], NULL, 10);
+      age = (gint64) ts.tv_sec * G_USEC_PER_SEC + ts.tv_nsec / 1000 -
+          (gint64) (start_ticks * G_USEC_PER_SEC / hz);
+      age = MAX (age, 0);
+    }
+
+    g_strfreev (fields);
+  }
+
+  g_free (contents);
+#endif
+  return age;
+}
+
+/**
+ * @brief Record a phase if it is not recorded yet.
+ */
+static void
+_record (StartupTracer * tracer, const gchar * phase, gint64 start, gint64 end)
+{
+  StartupPhase p;
+
+  g_mutex_lock (&tracer->lock);
+  if (!g_hash_table_contains (tracer->recorded, phase)) {
+    p.phase = g_strdup (phase);
+    p.start = start - tracer->origin;
+    p.end = end - tracer->origin;
+
+    g_hash_table_add (tracer->recorded, p.phase);
+    g_array_append_val (tracer->phases, p);
+  }
+  g_mutex_unlock (&tracer->lock);
+}
+
+/**
+ * @brief Add a hook to release in startup_tracer_free.
+ */
+static StartupHook *
+_add_hook (StartupTracer * tracer, gpointer object, gboolean is_probe)
+{
+  StartupHook *hook = g_new0 (StartupHook, 1);
+
+  hook->tracer = tracer;
+  hook->object = gst_object_ref (object);
+  hook->is_probe = is_probe;
+
+  g_mutex_lock (&tracer->lock);
+  g_ptr_array_add (tracer->hooks, hook);
+  g_mutex_unlock (&tracer->lock);
+
+  return hook;
+}
+
+/**
+ * @brief Pad probe to record the first buffer, removed after the first buffer.
+ */
+static GstPadProbeReturn
+_first_buffer_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  StartupHook *hook = (StartupHook *) user_data;
+
+  startup_tracer_mark (hook->tracer, hook->phase);
+  g_atomic_int_set (&hook->removed, 1);
+
+  return GST_PAD_PROBE_REMOVE;
+}
+
+/**
+ * @brief Check the pad is where the element outputs a buffer.
+ * A sink has no source pad, the first buffer is at its sink pad.
+ */
+static gboolean
+_is_traced_pad (GstElement * element, GstPad * pad)
+{
+  if (GST_OBJECT_FLAG_IS_SET (element, GST_ELEMENT_FLAG_SINK))
+    return GST_PAD_IS_SINK (pad);
+
+  return GST_PAD_IS_SRC (pad);
+}
+
+/**
+ * @brief Add the first buffer probe to the pad.
+ */
+static void
+_attach_pad (StartupTracer * tracer, GstElement * element, GstPad * pad)
+{
+  StartupHook *hook = _add_hook (tracer, pad, TRUE);
+
+  hook->phase = g_strdup_printf ("first_buffer:%s", GST_OBJECT_NAME (element));
+  hook->id = gst_pad_add_probe (pad,
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      _first_buffer_probe_cb, hook, NULL);
+}
+
+/**
+ * @brief Iterator callback for the pads of an element.
+ */
+static void
+_attach_pad_foreach (const GValue * item, gpointer user_data)
+{
+  StartupTracer *tracer = (StartupTracer *) user_data;
+  GstPad *pad = GST_PAD (g_value_get_object (item));
+  GstElement *element = gst_pad_get_parent_element (pad);
+
+  if (element) {
+    _attach_pad (tracer, element, pad);
+    gst_object_unref (element);
+  }
+}
+
+/**
+ * @brief Callback for a pad added to an element, e.g., decodebin and demuxers.
+ */
+static void
+_pad_added_cb (GstElement * element, GstPad * pad, gpointer user_data)
+{
+  StartupTracer *tracer = (StartupTracer *) user_data;
+
+  if (_is_traced_pad (element, pad))
+    _attach_pad (tracer, element, pad);
+}
+
+/**
+ * @brief Callback for an element added to the pipeline or its bins after attach.
+ */
+static void
+_deep_element_added_cb (GstBin * bin, GstBin * sub_bin, GstElement * element,
+    gpointer user_data)
+{
+  _attach_element ((StartupTracer *) user_data, element);
+}
+
+/**
+ * @brief Iterator callback for the elements of the pipeline.
+ */
+static void
+_attach_element_foreach (const GValue * item, gpointer user_data)
+{
+  _attach_element ((StartupTracer *) user_data,
+      GST_ELEMENT (g_value_get_object (item)));
+}
+
+/**
+ * @brief Add the first buffer probes and watch the pads added to the element.
+ */
+static void
+_attach_element (StartupTracer * tracer, GstElement * element)
+{
+  GstIterator *it;
+  StartupHook *hook;
+
+  /* the elements in a bin are traced */
+  if (GST_IS_BIN (element))
+    return;
+
+  if (GST_OBJECT_FLAG_IS_SET (element, GST_ELEMENT_FLAG_SINK))
+    it = gst_element_iterate_sink_pads (element);
+  else
+    it = gst_element_iterate_src_pads (element);
+
+  gst_iterator_foreach (it, _attach_pad_foreach, tracer);
+  gst_iterator_free (it);
+
+  hook = _add_hook (tracer, element, FALSE);
+  hook->id = g_signal_connect (element, "pad-added", G_CALLBACK (_pad_added_cb), tracer);
+}
+
+/**
+ * @brief Sync message handler for the state changes, called in the thread of the element.
+ */
+static void
+_state_changed_cb (GstBus * bus, GstMessage * message, gpointer user_data)
+{
+  StartupTracer *tracer = (StartupTracer *) user_data;
+  GstState old_state, new_state;
+  gchar *phase;
+
+  gst_message_parse_state_changed (message, &old_state, &new_state, NULL);
+
+  if (GST_MESSAGE_SRC (message) == GST_OBJECT (tracer->pipeline)) {
+    phase = g_strdup_printf ("pipeline:%s", gst_element_state_get_name (new_state));
+  } else if (old_state == GST_STATE_READY && new_state == GST_STATE_PAUSED) {
+    /* devices are opened and models are loaded from READY to PAUSED */
+    phase = g_strdup_printf ("paused:%s", GST_MESSAGE_SRC_NAME (message));
+  } else {
+    return;
+  }
+
+  startup_tracer_mark (tracer, phase);
+  g_free (phase);
+}
+
+/**
+ * @brief Compare the phases by the end time.
+ */
+static gint
+_compare_phase (gconstpointer a, gconstpointer b)
+{
+  const StartupPhase *pa = (const StartupPhase *) a;
+  const StartupPhase *pb = (const StartupPhase *) b;
+
+  if (pa->end != pb->end)
+    return (pa->end < pb->end) ? -1 : 1;
+  if (pa->start != pb->start)
+    return (pa->start < pb->start) ? -1 : 1;
+
+  return 0;
+}
+
+/**
+ * @brief Create the tracer, the times are relative to this call.
+ */
+StartupTracer *
+startup_tracer_new (void)
+{
+  StartupTracer *tracer = g_new0 (StartupTracer, 1);
+
+  tracer->origin = g_get_monotonic_time ();
+  tracer->exec_us = _process_age_us ();
+
+  g_mutex_init (&tracer->lock);
+  tracer->phases = g_array_new (FALSE, FALSE, sizeof (StartupPhase));
+  tracer->recorded = g_hash_table_new (g_str_hash, g_str_equal);
+  tracer->hooks = g_ptr_array_new ();
+
+  return tracer;
+}
+
+/**
+ * @brief Free the tracer, call after the pipeline is stopped.
+ */
+void
+startup_tracer_free (StartupTracer * tracer)
+{
+  StartupHook *hook;
+  guint i;
+
+  if (!tracer)
+    return;
+
+  for (i = 0; i < tracer->hooks->len; i++) {
+    hook = (StartupHook *) g_ptr_array_index (tracer->hooks, i);
+
+    if (!hook->is_probe)
+      g_signal_handler_disconnect (hook->object, hook->id);
+    else if (!g_atomic_int_get (&hook->removed))
+      gst_pad_remove_probe (GST_PAD (hook->object), hook->id);
+
+    gst_object_unref (hook->object);
+    g_free (hook->phase);
+    g_free (hook);
+  }
+  g_ptr_array_free (tracer->hooks, TRUE);
+
+  if (tracer->bus) {
+    g_signal_handler_disconnect (tracer->bus, tracer->sync_id);
+    gst_bus_disable_sync_message_emission (tracer->bus);
+    gst_object_unref (tracer->bus);
+  }
+
+  if (tracer->pipeline) {
+    g_signal_handler_disconnect (tracer->pipeline, tracer->deep_id);
+    gst_object_unref (tracer->pipeline);
+  }
+
+  for (i = 0; i < tracer->phases->len; i++)
+    g_free (g_array_index (tracer->phases, StartupPhase, i).phase);
+  g_array_free (tracer->phases, TRUE);
+  g_hash_table_destroy (tracer->recorded);
+
+  g_mutex_clear (&tracer->lock);
+  g_free (tracer);
+}
+
+/**
+ * @brief Record a phase from start (g_get_monotonic_time) to now.
+ */
+void
+startup_tracer_span (StartupTracer * tracer, const gchar * phase, gint64 start)
+{
+  if (tracer)
+    _record (tracer, phase, start, g_get_monotonic_time ());
+}
+
+/**
+ * @brief Record a phase at now.
+ */
+void
+startup_tracer_mark (StartupTracer * tracer, const gchar * phase)
+{
+  gint64 now;
+
+  if (tracer) {
+    now = g_get_monotonic_time ();
+    _record (tracer, phase, now, now);
+  }
+}
+
+/**
+ * @brief Record the state changes and the first buffer at each element of the pipeline.
+ */
+void
+startup_tracer_attach (StartupTracer * tracer, GstElement * pipeline)
+{
+  GstIterator *it;
+
+  if (!tracer)
+    return;
+
+  g_return_if_fail (GST_IS_BIN (pipeline));
+  g_return_if_fail (tracer->pipeline == NULL);
+
+  tracer->pipeline = (GstElement *) gst_object_ref (pipeline);
+  tracer->bus = gst_element_get_bus (pipeline);
+
+  /* the sync message does not change the bus watch of the application */
+  gst_bus_enable_sync_message_emission (tracer->bus);
+  tracer->sync_id = g_signal_connect (tracer->bus, "sync-message::state-changed",
+      G_CALLBACK (_state_changed_cb), tracer);
+  tracer->deep_id = g_signal_connect (pipeline, "deep-element-added",
+      G_CALLBACK (_deep_element_added_cb), tracer);
+
+  it = gst_bin_iterate_recurse (GST_BIN (pipeline));
+  gst_iterator_foreach (it, _attach_element_foreach, tracer);
+  gst_iterator_free (it);
+}
+
+/**
+ * @brief Record the first result, returns TRUE for the first call.
+ */
+gboolean
+startup_tracer_first_result (StartupTracer * tracer)
+{
+  gint64 now;
+
+  if (!tracer || g_atomic_int_get (&tracer->has_result))
+    return FALSE;
+
+  now = g_get_monotonic_time ();
+  if (!g_atomic_int_compare_and_exchange (&tracer->has_result, 0, 1))
+    return FALSE;
+
+  tracer->first_result = now - tracer->origin;
+  _record (tracer, "first_result", now, now);
+  return TRUE;
+}
+
+/**
+ * @brief Get the time from startup_tracer_new to the first result, -1 if no result.
+ */
+gint64
+startup_tracer_get_first_result_us (StartupTracer * tracer)
+{
+  if (!tracer || !g_atomic_int_get (&tracer->has_result))
+    return -1;
+
+  return tracer->first_result;
+}
+
+/**
+ * @brief Print the phases in CSV, ordered by the end time.
+ */
+void
+startup_tracer_print (StartupTracer * tracer, FILE * fp)
+{
+  GArray *phases;
+  StartupPhase *p;
+  gint64 prev = 0;
+  guint i;
+
+  if (!tracer)
+    return;
+
+  g_mutex_lock (&tracer->lock);
+  phases = g_array_sized_new (FALSE, FALSE, sizeof (StartupPhase), tracer->phases->len);
+  g_array_append_vals (phases, tracer->phases->data, tracer->phases->len);
+  g_mutex_unlock (&tracer->lock);
+
+  g_array_sort (phases, _compare_phase);
+
+  fprintf (fp, "phase,start_ms,end_ms,delta_ms\n");
+  if (tracer->exec_us >= 0) {
+    fprintf (fp, "exec,%.3f,0.000,%.3f\n", -tracer->exec_us / 1000.0,
+        tracer->exec_us / 1000.0);
+  }
+
+  for (i = 0; i < phases->len; i++) {
+    p = &g_array_index (phases, StartupPhase, i);
+    fprintf (fp, "%s,%.3f,%.3f,%.3f\n", p->phase, p->start / 1000.0,
+        p->end / 1000.0, (p->end - prev) / 1000.0);
+    prev = p->end;
+  }
+
+  g_array_free (phases, TRUE);
+}
+
+/**
+ * @brief Run a loader and record it.
+ */
+static gboolean
+_run_task (StartupTask * task)
+{
+  gint64 start = g_get_monotonic_time ();
+  gboolean ret = task->func (task->user_data);
+  gchar *phase = g_strdup_printf ("load:%s", task->name);
+
+  startup_tracer_span (task->tasks->tracer, phase, start);
+  g_free (phase);
+
+  if (!ret)
+    g_warning ("startup: failed to load %s", task->name);
+
+  return ret;
+}
+
+/**
+ * @brief Thread of a loader.
+ */
+static gpointer
+_task_thread (gpointer user_data)
+{
+  StartupTask *task = (StartupTask *) user_data;
+  StartupTasks *tasks = task->tasks;
+  gboolean ret = _run_task (task);
+
+  g_mutex_lock (&tasks->lock);
+  if (!ret)
+    tasks->failed = TRUE;
+  if (--tasks->pending == 0)
+    g_atomic_int_set (&tasks->done, 1);
+  g_cond_broadcast (&tasks->cond);
+  g_mutex_unlock (&tasks->lock);
+
+  return NULL;
+}
+
+/**
+ * @brief Create the loaders.
+ */
+StartupTasks *
+startup_tasks_new (gboolean threaded, StartupTracer * tracer)
+{
+  StartupTasks *tasks = g_new0 (StartupTasks, 1);
+
+  g_mutex_init (&tasks->lock);
+  g_cond_init (&tasks->cond);
+  tasks->threaded = threaded;
+  tasks->tracer = tracer;
+  tasks->tasks = g_ptr_array_new ();
+  tasks->done = 1;
+
+  return tasks;
+}
+
+/**
+ * @brief Add a loader, started at once.
+ */
+void
+startup_tasks_add (StartupTasks * tasks, const gchar * name,
+    StartupTaskFunc func, gpointer user_data)
+{
+  StartupTask *task;
+
+  g_return_if_fail (tasks != NULL);
+  g_return_if_fail (name != NULL && func != NULL);
+
+  task = g_new0 (StartupTask, 1);
+  task->tasks = tasks;
+  task->name = g_strdup (name);
+  task->func = func;
+  task->user_data = user_data;
+
+  g_mutex_lock (&tasks->lock);
+  g_ptr_array_add (tasks->tasks, task);
+  if (tasks->threaded) {
+    tasks->pending++;
+    g_atomic_int_set (&tasks->done, 0);
+  }
+  g_mutex_unlock (&tasks->lock);
+
+  if (tasks->threaded) {
+    task->thread = g_thread_new (name, _task_thread, task);
+  } else if (!_run_task (task)) {
+    g_mutex_lock (&tasks->lock);
+    tasks->failed = TRUE;
+    g_mutex_unlock (&tasks->lock);
+  }
+}
+
+/**
+ * @brief Wait for the loaders, returns FALSE if a loader failed.
+ */
+gboolean
+startup_tasks_wait (StartupTasks * tasks)
+{
+  gboolean ret;
+  gint64 start;
+
+  if (!tasks)
+    return TRUE;
+
+  /* an atomic read once the loaders are done */
+  if (g_atomic_int_get (&tasks->done))
+    return !tasks->failed;
+
+  start = g_get_monotonic_time ();
+
+  g_mutex_lock (&tasks->lock);
+  while (tasks->pending > 0)
+    g_cond_wait (&tasks->cond, &tasks->lock);
+  ret = !tasks->failed;
+  g_mutex_unlock (&tasks->lock);
+
+  /* time the first waiter was blocked by the loaders */
+  startup_tracer_span (tasks->tracer, "wait:loaders", start);
+  return ret;
+}
+
+/**
+ * @brief Wait for the loaders and free.
+ */
+void
+startup_tasks_free (StartupTasks * tasks)
+{
+  StartupTask *task;
+  guint i;
+
+  if (!tasks)
+    return;
+
+  startup_tasks_wait (tasks);
+
+  for (i = 0; i < tasks->tasks->len; i++) {
+    task = (StartupTask *) g_ptr_array_index (tasks->tasks, i);
+
+    if (task->thread)
+      g_thread_join (task->thread);
+    g_free (task->name);
+    g_free (task);
+  }
+  g_ptr_array_free (tasks->tasks, TRUE);
+
+  g_cond_clear (&tasks->cond);
+  g_mutex_clear (&tasks->lock);
+  g_free (tasks);
+}
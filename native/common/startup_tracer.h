@@ -0,0 +1,125 @@
+/**
+ * @file	startup_tracer.h
+ * @date	19 October 2026
+ * @brief	Startup-time tracer and parallel initialization of the example pipelines
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Gichan Jang <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ *
+ * The tracer records the phases from the start of the process to the first result:
+ * exec (process start to startup_tracer_new, from /proc/self/stat in clock ticks),
+ * gst_init (includes the scan of the plugin registry), the parse of the pipeline,
+ * the state changes of the pipeline and the elements, the first buffer at each element
+ * and the first result. The state changes are read from the sync messages of the bus,
+ * so the bus watch of the application is not changed. Only the first record of a phase
+ * is kept, the first buffer probes are removed after the first buffer.
+ *
+ * StartupTasks runs the loaders (labels, box priors, vocab) on worker threads while the
+ * pipeline starts (parse, model loading in tensor_filter and preroll). The result callback
+ * waits for them before it uses the loaded data, the wait costs an atomic read once done.
+ *
+ * usage:
+ *   tracer = startup_tracer_new ();
+ *   start = g_get_monotonic_time ();
+ *   gst_init (&argc, &argv);
+ *   startup_tracer_span (tracer, "gst_init", start);
+ *   tasks = startup_tasks_new (TRUE, tracer);
+ *   startup_tasks_add (tasks, "labels", load_labels, info);
+ *   (parse the pipeline)
+ *   startup_tracer_attach (tracer, pipeline);
+ *   gst_element_set_state (pipeline, GST_STATE_PLAYING);
+ *   (in the result callback)
+ *   if (!startup_tasks_wait (tasks))
+ *     return;
+ *   startup_tracer_first_result (tracer);
+ *   (after the pipeline is stopped)
+ *   startup_tracer_print (tracer, stdout);
+ *   startup_tasks_free (tasks);
+ *   startup_tracer_free (tracer);
+ *
+ * The tracer may be NULL (tracing is disabled), then nothing is recorded.
+ */
+#ifndef __STARTUP_TRACER_H__
+#define __STARTUP_TRACER_H__
+
+#include <stdio.h>
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _StartupTracer StartupTracer;
+typedef struct _StartupTasks StartupTasks;
+
+/**
+ * @brief Loader run by StartupTasks, returns FALSE if it failed.
+ */
+typedef gboolean (*StartupTaskFunc) (gpointer user_data);
+
+/**
+ * @brief Create the tracer, the times are relative to this call.
+ */
+extern StartupTracer * startup_tracer_new (void);
+
+/**
+ * @brief Free the tracer, call after the pipeline is stopped.
+ */
+extern void startup_tracer_free (StartupTracer * tracer);
+
+/**
+ * @brief Record a phase from start (g_get_monotonic_time) to now.
+ */
+extern void startup_tracer_span (StartupTracer * tracer, const gchar * phase, gint64 start);
+
+/**
+ * @brief Record a phase at now.
+ */
+extern void startup_tracer_mark (StartupTracer * tracer, const gchar * phase);
+
+/**
+ * @brief Record the state changes and the first buffer at each element of the pipeline.
+ * Call before the state of the pipeline is changed to PLAYING.
+ */
+extern void startup_tracer_attach (StartupTracer * tracer, GstElement * pipeline);
+
+/**
+ * @brief Record the first result, returns TRUE for the first call.
+ */
+extern gboolean startup_tracer_first_result (StartupTracer * tracer);
+
+/**
+ * @brief Get the time from startup_tracer_new to the first result, -1 if no result.
+ */
+extern gint64 startup_tracer_get_first_result_us (StartupTracer * tracer);
+
+/**
+ * @brief Print the phases in CSV, ordered by the end time.
+ * phase,start_ms,end_ms,delta_ms (delta from the end of the previous phase)
+ */
+extern void startup_tracer_print (StartupTracer * tracer, FILE * fp);
+
+/**
+ * @brief Create the loaders.
+ * @param threaded TRUE to run each loader on a thread, FALSE to run it in startup_tasks_add
+ * @param tracer the tracer to record the loaders, or NULL
+ */
+extern StartupTasks * startup_tasks_new (gboolean threaded, StartupTracer * tracer);
+
+/**
+ * @brief Add a loader, started at once.
+ */
+extern void startup_tasks_add (StartupTasks * tasks, const gchar * name, StartupTaskFunc func, gpointer user_data);
+
+/**
+ * @brief Wait for the loaders, returns FALSE if a loader failed. tasks may be NULL.
+ */
+extern gboolean startup_tasks_wait (StartupTasks * tasks);
+
+/**
+ * @brief Wait for the loaders and free.
+ */
+extern void startup_tasks_free (StartupTasks * tasks);
+
+G_END_DECLS
+
+#endif /* __STARTUP_TRACER_H__ */
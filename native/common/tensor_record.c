@@ -0,0 +1,858 @@
+/**
+ * @file	tensor_record.c
+ * @date	19 October 2026
+ * @brief	Recorder of the tensors at a pad and replay of them, for deterministic benchmarks
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Gichan Jang <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <gst/app/app.h>
+#include "tensor_record.h"
+
+#define RECORD_MAGIC "TNSREC01"
+#define RECORD_VERSION 1
+#define RECORD_GROW (4 * 1024 * 1024)
+#define ROUND_UP(n, a) ((((gsize) (n)) + ((a) - 1)) & ~((gsize) (a) - 1))
+
+/**
+ * @brief Type of a record.
+ */
+typedef enum
+{
+  RECORD_TYPE_CAPS = 1, /**< caps string in the first memory */
+  RECORD_TYPE_BUFFER = 2 /**< memories of a buffer */
+} RecordType;
+
+/**
+ * @brief Header of the file.
+ */
+typedef struct
+{
+  gchar magic[8]; /**< RECORD_MAGIC */
+  guint32 version;
+  guint32 align; /**< TENSOR_RECORD_ALIGN */
+  guint64 buffers; /**< number of buffers, written at close */
+  guint64 end; /**< end of the records, 0 if not closed (the records are read until an invalid one) */
+  guint8 padding[TENSOR_RECORD_ALIGN - 32];
+} RecordHeader;
+
+G_STATIC_ASSERT (sizeof (RecordHeader) == TENSOR_RECORD_ALIGN);
+
+/**
+ * @brief Header of a record, the sizes of the memories (guint64) follow it.
+ */
+typedef struct
+{
+  guint32 type; /**< RecordType */
+  guint32 n_mems; /**< number of memories */
+  guint64 size; /**< size of the record, to the next record */
+  guint64 pts;
+  guint64 dts;
+  guint64 duration;
+  guint64 reserved;
+} RecordEntry;
+
+/**
+ * @brief Recorder.
+ */
+struct _TensorRecorder
+{
+  GMutex lock;
+  gint fd;
+  guint8 *map; /**< mapped file */
+  gsize mapped; /**< size of the file and the mapping */
+  gsize offset; /**< end of the records */
+  guint64 max_buffers; /**< 0 for no limit */
+  TensorRecorderStats stats;
+
+  GstPad *pad; /**< tapped pad */
+  gulong buffer_probe;
+  gulong event_probe;
+};
+
+/**
+ * @brief Mapped file of the replay, referenced by the buffers in use.
+ */
+typedef struct
+{
+  gint ref;
+  guint8 *data;
+  gsize size;
+} ReplayMap;
+
+/**
+ * @brief Index of a recorded buffer.
+ */
+typedef struct
+{
+  gsize offset; /**< offset of the record */
+  guint caps; /**< index of the caps, G_MAXUINT if no caps */
+} ReplayIndex;
+
+/**
+ * @brief Replay.
+ */
+struct _TensorReplay
+{
+  ReplayMap *map;
+  GArray *buffers; /**< ReplayIndex */
+  GPtrArray *caps; /**< GstCaps */
+  GstClockTime first_pts; /**< first valid timestamp */
+  GstClockTime last_pts; /**< last valid timestamp */
+  gsize max_size; /**< max size of a buffer */
+
+  GMutex lock;
+  GCond cond;
+  GstElement *appsrc;
+  GThread *thread;
+  gint stop;
+  gdouble speed;
+  guint loops;
+  guint64 pushed;
+  gint64 first_push;
+  gint64 last_push;
+};
+
+/**
+ * @brief Size of the record header and the sizes of the memories.
+ */
+static gsize
+_meta_size (guint n_mems)
+{
+  return ROUND_UP (sizeof (RecordEntry) + n_mems * sizeof (guint64), TENSOR_RECORD_ALIGN);
+}
+
+/**
+ * @brief Grow the file and the mapping for a record.
+ */
+static gboolean
+_reserve (TensorRecorder * recorder, gsize size)
+{
+  gsize need = recorder->offset + size;
+  gsize new_size;
+  gpointer map;
+  gint err;
+
+  if (need <= recorder->mapped)
+    return TRUE;
+
+  new_size = ROUND_UP (MAX (recorder->mapped * 2, need), RECORD_GROW);
+
+  /* allocate the blocks, a full disk fails here instead of SIGBUS on the mapping */
+  err = posix_fallocate (recorder->fd, 0, new_size);
+  if (err == EINVAL || err == EOPNOTSUPP)
+    err = (ftruncate (recorder->fd, new_size) == 0) ? 0 : errno;
+  if (err != 0) {
+    g_warning ("tensor recorder: failed to grow the file (%s)", g_strerror (err));
+    return FALSE;
+  }
+
+  if (recorder->map)
+    munmap (recorder->map, recorder->mapped);
+  recorder->map = NULL;
+  recorder->mapped = 0;
+
+  map = mmap (NULL, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, recorder->fd, 0);
+  if (map == MAP_FAILED) {
+    g_warning ("tensor recorder: failed to map the file");
+    return FALSE;
+  }
+
+  recorder->map = (guint8 *) map;
+  recorder->mapped = new_size;
+  return TRUE;
+}
+
+/**
+ * @brief Append the caps.
+ */
+static void
+_record_caps (TensorRecorder * recorder, GstCaps * caps)
+{
+  RecordEntry *entry;
+  gchar *str = gst_caps_to_string (caps);
+  guint64 len = strlen (str) + 1;
+  gsize meta = _meta_size (1);
+  gsize size = meta + ROUND_UP (len, TENSOR_RECORD_ALIGN);
+
+  g_mutex_lock (&recorder->lock);
+  if (_reserve (recorder, size)) {
+    entry = (RecordEntry *) (recorder->map + recorder->offset);
+    memset (entry, 0, sizeof (RecordEntry));
+    entry->type = RECORD_TYPE_CAPS;
+    entry->n_mems = 1;
+    entry->size = size;
+    entry->pts = entry->dts = entry->duration = GST_CLOCK_TIME_NONE;
+    memcpy (entry + 1, &len, sizeof (len));
+    memcpy (recorder->map + recorder->offset + meta, str, len);
+
+    recorder->offset += size;
+    recorder->stats.caps++;
+    recorder->stats.bytes = recorder->offset;
+  }
+  g_mutex_unlock (&recorder->lock);
+
+  g_free (str);
+}
+
+/**
+ * @brief Append the memories and the timestamps of the buffer.
+ */
+static void
+_record_buffer (TensorRecorder * recorder, GstBuffer * buffer)
+{
+  RecordEntry *entry;
+  GstMemory *mem;
+  GstMapInfo info;
+  guint64 sizes[TENSOR_RECORD_MAX_MEMS];
+  guint n_mems = gst_buffer_n_memory (buffer);
+  gsize meta, size, offset;
+  gint64 start;
+  guint i;
+
+  if (n_mems == 0 || n_mems > TENSOR_RECORD_MAX_MEMS) {
+    g_mutex_lock (&recorder->lock);
+    recorder->stats.dropped++;
+    g_mutex_unlock (&recorder->lock);
+    return;
+  }
+
+  meta = _meta_size (n_mems);
+  size = meta;
+  for (i = 0; i < n_mems; i++) {
+    sizes[i] = gst_memory_get_sizes (gst_buffer_peek_memory (buffer, i), NULL, NULL);
+    size += ROUND_UP (sizes[i], TENSOR_RECORD_ALIGN);
+  }
+
+  g_mutex_lock (&recorder->lock);
+  if (recorder->max_buffers > 0 && recorder->stats.buffers >= recorder->max_buffers)
+    goto done;
+
+  if (!_reserve (recorder, size)) {
+    recorder->stats.dropped++;
+    goto done;
+  }
+
+  start = g_get_monotonic_time ();
+
+  entry = (RecordEntry *) (recorder->map + recorder->offset);
+  memset (entry, 0, sizeof (RecordEntry));
+  entry->type = RECORD_TYPE_BUFFER;
+  entry->n_mems = n_mems;
+  entry->size = size;
+  entry->pts = GST_BUFFER_PTS (buffer);
+  entry->dts = GST_BUFFER_DTS (buffer);
+  entry->duration = GST_BUFFER_DURATION (buffer);
+  memcpy (entry + 1, sizes, n_mems * sizeof (guint64));
+
+  /* the blocks are zero-filled, the padding is not written */
+  offset = recorder->offset + meta;
+  for (i = 0; i < n_mems; i++) {
+    mem = gst_buffer_peek_memory (buffer, i);
+    if (gst_memory_map (mem, &info, GST_MAP_READ)) {
+      memcpy (recorder->map + offset, info.data, MIN (info.size, sizes[i]));
+      gst_memory_unmap (mem, &info);
+    }
+    offset += ROUND_UP (sizes[i], TENSOR_RECORD_ALIGN);
+  }
+
+  recorder->offset += size;
+  recorder->stats.buffers++;
+  recorder->stats.bytes = recorder->offset;
+  recorder->stats.copy_us += g_get_monotonic_time () - start;
+
+done:
+  g_mutex_unlock (&recorder->lock);
+}
+
+/**
+ * @brief Pad probe for the buffers.
+ */
+static GstPadProbeReturn
+_buffer_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  _record_buffer ((TensorRecorder *) user_data, GST_PAD_PROBE_INFO_BUFFER (info));
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Pad probe for the caps.
+ */
+static GstPadProbeReturn
+_event_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+  GstCaps *caps;
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_CAPS) {
+    gst_event_parse_caps (event, &caps);
+    _record_caps ((TensorRecorder *) user_data, caps);
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Create the recorder, the file is truncated.
+ */
+TensorRecorder *
+tensor_recorder_new (const gchar * path)
+{
+  TensorRecorder *recorder;
+  RecordHeader *header;
+  gint fd;
+
+  g_return_val_if_fail (path != NULL, NULL);
+
+  fd = open (path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    g_warning ("tensor recorder: cannot open %s", path);
+    return NULL;
+  }
+
+  recorder = g_new0 (TensorRecorder, 1);
+  g_mutex_init (&recorder->lock);
+  recorder->fd = fd;
+
+  if (!_reserve (recorder, sizeof (RecordHeader))) {
+    tensor_recorder_free (recorder);
+    return NULL;
+  }
+
+  header = (RecordHeader *) recorder->map;
+  memcpy (header->magic, RECORD_MAGIC, sizeof (header->magic));
+  header->version = RECORD_VERSION;
+  header->align = TENSOR_RECORD_ALIGN;
+  recorder->offset = sizeof (RecordHeader);
+  recorder->stats.bytes = recorder->offset;
+
+  return recorder;
+}
+
+/**
+ * @brief Record the caps and the buffers flowing through the pad.
+ */
+gboolean
+tensor_recorder_attach (TensorRecorder * recorder, GstPad * pad, guint64 max_buffers)
+{
+  GstCaps *caps;
+
+  g_return_val_if_fail (recorder != NULL, FALSE);
+  g_return_val_if_fail (pad != NULL, FALSE);
+  g_return_val_if_fail (recorder->pad == NULL, FALSE);
+
+  recorder->pad = (GstPad *) gst_object_ref (pad);
+  recorder->max_buffers = max_buffers;
+
+  /* the caps event is already sent if the pipeline is running */
+  caps = gst_pad_get_current_caps (pad);
+  if (caps) {
+    _record_caps (recorder, caps);
+    gst_caps_unref (caps);
+  }
+
+  recorder->event_probe = gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+      _event_probe_cb, recorder, NULL);
+  recorder->buffer_probe = gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      _buffer_probe_cb, recorder, NULL);
+
+  return (recorder->event_probe != 0 && recorder->buffer_probe != 0);
+}
+
+/**
+ * @brief Record the output of the element, the source pad or the sink pad of a sink element.
+ */
+gboolean
+tensor_recorder_attach_element (TensorRecorder * recorder, GstElement * pipeline,
+    const gchar * name, guint64 max_buffers)
+{
+  GstElement *element;
+  GstPad *pad;
+  gboolean ret = FALSE;
+
+  g_return_val_if_fail (GST_IS_BIN (pipeline), FALSE);
+  g_return_val_if_fail (name != NULL, FALSE);
+
+  element = gst_bin_get_by_name (GST_BIN (pipeline), name);
+  if (!element) {
+    g_warning ("tensor recorder: cannot find %s", name);
+    return FALSE;
+  }
+
+  pad = gst_element_get_static_pad (element, "src");
+  if (!pad)
+    pad = gst_element_get_static_pad (element, "sink");
+
+  if (pad) {
+    ret = tensor_recorder_attach (recorder, pad, max_buffers);
+    gst_object_unref (pad);
+  } else {
+    g_warning ("tensor recorder: %s has no static src or sink pad", name);
+  }
+
+  gst_object_unref (element);
+  return ret;
+}
+
+/**
+ * @brief Get the statistics of the recorder.
+ */
+void
+tensor_recorder_get_stats (TensorRecorder * recorder, TensorRecorderStats * stats)
+{
+  g_return_if_fail (recorder != NULL);
+  g_return_if_fail (stats != NULL);
+
+  g_mutex_lock (&recorder->lock);
+  *stats = recorder->stats;
+  g_mutex_unlock (&recorder->lock);
+}
+
+/**
+ * @brief Remove the probes, write the header and close the file.
+ */
+void
+tensor_recorder_free (TensorRecorder * recorder)
+{
+  RecordHeader header;
+
+  if (!recorder)
+    return;
+
+  if (recorder->pad) {
+    if (recorder->event_probe)
+      gst_pad_remove_probe (recorder->pad, recorder->event_probe);
+    if (recorder->buffer_probe)
+      gst_pad_remove_probe (recorder->pad, recorder->buffer_probe);
+    gst_object_unref (recorder->pad);
+  }
+
+  if (recorder->map)
+    munmap (recorder->map, recorder->mapped);
+
+  if (recorder->offset > 0) {
+    memset (&header, 0, sizeof (header));
+    memcpy (header.magic, RECORD_MAGIC, sizeof (header.magic));
+    header.version = RECORD_VERSION;
+    header.align = TENSOR_RECORD_ALIGN;
+    header.buffers = recorder->stats.buffers;
+    header.end = recorder->offset;
+
+    if (pwrite (recorder->fd, &header, sizeof (header), 0) != sizeof (header) ||
+        ftruncate (recorder->fd, recorder->offset) != 0)
+      g_warning ("tensor recorder: failed to close the file");
+  }
+
+  close (recorder->fd);
+  g_mutex_clear (&recorder->lock);
+  g_free (recorder);
+}
+
+/**
+ * @brief Add a reference to the mapped file.
+ */
+static ReplayMap *
+_map_ref (ReplayMap * map)
+{
+  g_atomic_int_inc (&map->ref);
+  return map;
+}
+
+/**
+ * @brief Release a reference to the mapped file.
+ */
+static void
+_map_unref (gpointer data)
+{
+  ReplayMap *map = (ReplayMap *) data;
+
+  if (g_atomic_int_dec_and_test (&map->ref)) {
+    munmap (map->data, map->size);
+    g_free (map);
+  }
+}
+
+/**
+ * @brief Check the record and add it to the index.
+ */
+static gboolean
+_index_record (TensorReplay * replay, gsize offset, gsize end)
+{
+  const RecordEntry *entry = (const RecordEntry *) (replay->map->data + offset);
+  const guint64 *sizes = (const guint64 *) (entry + 1);
+  const gchar *str;
+  ReplayIndex index;
+  GstCaps *caps;
+  gsize size, total = 0;
+  guint i;
+
+  if (offset + sizeof (RecordEntry) > end || entry->n_mems == 0 ||
+      entry->n_mems > TENSOR_RECORD_MAX_MEMS || entry->size > end - offset ||
+      entry->size % TENSOR_RECORD_ALIGN != 0)
+    return FALSE;
+
+  size = _meta_size (entry->n_mems);
+  if (size > entry->size)
+    return FALSE;
+
+  for (i = 0; i < entry->n_mems; i++) {
+    if (sizes[i] > entry->size)
+      return FALSE;
+    size += ROUND_UP (sizes[i], TENSOR_RECORD_ALIGN);
+    total += sizes[i];
+  }
+  if (size != entry->size)
+    return FALSE;
+
+  switch (entry->type) {
+    case RECORD_TYPE_CAPS:
+      str = (const gchar *) entry + _meta_size (1);
+      if (sizes[0] == 0 || str[sizes[0] - 1] != '\0')
+        return FALSE;
+
+      caps = gst_caps_from_string (str);
+      if (!caps)
+        return FALSE;
+      g_ptr_array_add (replay->caps, caps);
+      break;
+
+    case RECORD_TYPE_BUFFER:
+      index.offset = offset;
+      index.caps = (replay->caps->len > 0) ? replay->caps->len - 1 : G_MAXUINT;
+      g_array_append_val (replay->buffers, index);
+
+      if (GST_CLOCK_TIME_IS_VALID (entry->pts)) {
+        if (!GST_CLOCK_TIME_IS_VALID (replay->first_pts))
+          replay->first_pts = entry->pts;
+        replay->last_pts = entry->pts;
+      }
+      replay->max_size = MAX (replay->max_size, total);
+      break;
+
+    default:
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Map the recorded file.
+ */
+TensorReplay *
+tensor_replay_open (const gchar * path)
+{
+  TensorReplay *replay;
+  const RecordHeader *header;
+  struct stat st;
+  gpointer data;
+  gsize offset, end;
+  gint fd;
+
+  g_return_val_if_fail (path != NULL, NULL);
+
+  fd = open (path, O_RDONLY);
+  if (fd < 0) {
+    g_warning ("tensor replay: cannot open %s", path);
+    return NULL;
+  }
+
+  if (fstat (fd, &st) != 0 || (gsize) st.st_size < sizeof (RecordHeader)) {
+    g_warning ("tensor replay: invalid file %s", path);
+    close (fd);
+    return NULL;
+  }
+
+  data = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED) {
+    g_warning ("tensor replay: failed to map %s", path);
+    return NULL;
+  }
+
+  header = (const RecordHeader *) data;
+  if (memcmp (header->magic, RECORD_MAGIC, sizeof (header->magic)) != 0 ||
+      header->version != RECORD_VERSION || header->align != TENSOR_RECORD_ALIGN) {
+    g_warning ("tensor replay: %s is not a tensor record", path);
+    munmap (data, st.st_size);
+    return NULL;
+  }
+
+  replay = g_new0 (TensorReplay, 1);
+  replay->map = g_new0 (ReplayMap, 1);
+  replay->map->ref = 1;
+  replay->map->data = (guint8 *) data;
+  replay->map->size = st.st_size;
+  replay->buffers = g_array_new (FALSE, FALSE, sizeof (ReplayIndex));
+  replay->caps = g_ptr_array_new_with_free_func ((GDestroyNotify) gst_caps_unref);
+  replay->first_pts = replay->last_pts = GST_CLOCK_TIME_NONE;
+  g_mutex_init (&replay->lock);
+  g_cond_init (&replay->cond);
+
+  /* not closed (e.g., the recording process is killed), read until an invalid record */
+  end = (header->end > 0 && header->end <= (guint64) st.st_size) ? header->end : (gsize) st.st_size;
+
+  offset = sizeof (RecordHeader);
+  while (offset < end) {
+    if (!_index_record (replay, offset, end))
+      break;
+    offset += ((const RecordEntry *) (replay->map->data + offset))->size;
+  }
+
+  if (header->end > 0 && (offset != end || header->buffers != replay->buffers->len))
+    g_warning ("tensor replay: %s is truncated, %u buffers", path, replay->buffers->len);
+
+  return replay;
+}
+
+/**
+ * @brief Release the mapping, the buffers in use keep the file mapped.
+ */
+void
+tensor_replay_free (TensorReplay * replay)
+{
+  if (!replay)
+    return;
+
+  tensor_replay_stop (replay);
+
+  g_array_free (replay->buffers, TRUE);
+  g_ptr_array_free (replay->caps, TRUE);
+  g_mutex_clear (&replay->lock);
+  g_cond_clear (&replay->cond);
+  _map_unref (replay->map);
+  g_free (replay);
+}
+
+/**
+ * @brief Get the number of recorded buffers.
+ */
+guint
+tensor_replay_get_count (TensorReplay * replay)
+{
+  g_return_val_if_fail (replay != NULL, 0);
+
+  return replay->buffers->len;
+}
+
+/**
+ * @brief Get the caps of the buffer, to be unreffed.
+ */
+GstCaps *
+tensor_replay_get_caps (TensorReplay * replay, guint index)
+{
+  guint caps;
+
+  g_return_val_if_fail (replay != NULL, NULL);
+  g_return_val_if_fail (index < replay->buffers->len, NULL);
+
+  caps = g_array_index (replay->buffers, ReplayIndex, index).caps;
+  if (caps >= replay->caps->len)
+    return NULL;
+
+  return gst_caps_ref ((GstCaps *) g_ptr_array_index (replay->caps, caps));
+}
+
+/**
+ * @brief Get the recorded buffer, each memory wraps the mapped file without copy.
+ */
+GstBuffer *
+tensor_replay_get_buffer (TensorReplay * replay, guint index)
+{
+  const RecordEntry *entry;
+  const guint64 *sizes;
+  GstBuffer *buffer;
+  guint8 *data;
+  guint i;
+
+  g_return_val_if_fail (replay != NULL, NULL);
+  g_return_val_if_fail (index < replay->buffers->len, NULL);
+
+  entry = (const RecordEntry *) (replay->map->data +
+      g_array_index (replay->buffers, ReplayIndex, index).offset);
+  sizes = (const guint64 *) (entry + 1);
+  data = (guint8 *) entry + _meta_size (entry->n_mems);
+
+  buffer = gst_buffer_new ();
+  for (i = 0; i < entry->n_mems; i++) {
+    gst_buffer_append_memory (buffer,
+        gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, data, sizes[i], 0,
+            sizes[i], _map_ref (replay->map), _map_unref));
+    data += ROUND_UP (sizes[i], TENSOR_RECORD_ALIGN);
+  }
+
+  GST_BUFFER_PTS (buffer) = entry->pts;
+  GST_BUFFER_DTS (buffer) = entry->dts;
+  GST_BUFFER_DURATION (buffer) = entry->duration;
+
+  return buffer;
+}
+
+/**
+ * @brief Get the recorded rate from the timestamps, 0 if unknown.
+ */
+gdouble
+tensor_replay_get_rate (TensorReplay * replay)
+{
+  g_return_val_if_fail (replay != NULL, 0.0);
+
+  if (replay->buffers->len < 2 || !GST_CLOCK_TIME_IS_VALID (replay->first_pts) ||
+      replay->last_pts <= replay->first_pts)
+    return 0.0;
+
+  return (replay->buffers->len - 1) * (gdouble) GST_SECOND /
+      (replay->last_pts - replay->first_pts);
+}
+
+/**
+ * @brief Thread to push the buffers to appsrc.
+ */
+static gpointer
+_replay_thread (gpointer user_data)
+{
+  TensorReplay *replay = (TensorReplay *) user_data;
+  GstAppSrc *appsrc = GST_APP_SRC (replay->appsrc);
+  GstBuffer *buffer;
+  GstCaps *caps;
+  GstClockTime pts, span = 0;
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint caps_index = G_MAXUINT, count = replay->buffers->len;
+  guint loop, i, index;
+  gint64 start, target, now;
+  gdouble rate = tensor_replay_get_rate (replay);
+
+  /* length of a loop, the timestamps of the next loop follow the last buffer */
+  if (rate > 0)
+    span = replay->last_pts - replay->first_pts + (GstClockTime) (GST_SECOND / rate);
+
+  start = g_get_monotonic_time ();
+  for (loop = 0; loop < replay->loops && ret == GST_FLOW_OK; loop++) {
+    for (i = 0; i < count && ret == GST_FLOW_OK; i++) {
+      if (g_atomic_int_get (&replay->stop))
+        goto done;
+
+      index = g_array_index (replay->buffers, ReplayIndex, i).caps;
+      if (index != caps_index && index < replay->caps->len) {
+        caps = (GstCaps *) g_ptr_array_index (replay->caps, index);
+        gst_app_src_set_caps (appsrc, caps);
+        caps_index = index;
+      }
+
+      buffer = tensor_replay_get_buffer (replay, i);
+      pts = GST_BUFFER_PTS (buffer);
+      GST_BUFFER_DTS (buffer) = GST_CLOCK_TIME_NONE;
+
+      if (GST_CLOCK_TIME_IS_VALID (pts) && pts >= replay->first_pts) {
+        pts = pts - replay->first_pts + loop * span;
+        GST_BUFFER_PTS (buffer) = pts;
+
+        if (replay->speed > 0) {
+          /* recorded rate, the time of the buffer from the start */
+          target = start + (gint64) (pts / GST_USECOND / replay->speed);
+
+          g_mutex_lock (&replay->lock);
+          while (!replay->stop && (now = g_get_monotonic_time ()) < target)
+            g_cond_wait_until (&replay->cond, &replay->lock, target);
+          g_mutex_unlock (&replay->lock);
+        }
+      }
+
+      ret = gst_app_src_push_buffer (appsrc, buffer);
+
+      g_mutex_lock (&replay->lock);
+      now = g_get_monotonic_time ();
+      if (replay->pushed++ == 0)
+        replay->first_push = now;
+      replay->last_push = now;
+      g_mutex_unlock (&replay->lock);
+    }
+  }
+
+done:
+  gst_app_src_end_of_stream (appsrc);
+  return NULL;
+}
+
+/**
+ * @brief Push the buffers to appsrc from a thread, and EOS after the last loop.
+ */
+gboolean
+tensor_replay_start (TensorReplay * replay, GstElement * appsrc, gdouble speed, guint loops)
+{
+  g_return_val_if_fail (replay != NULL, FALSE);
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), FALSE);
+  g_return_val_if_fail (replay->thread == NULL, FALSE);
+
+  if (replay->buffers->len == 0) {
+    g_warning ("tensor replay: no buffer");
+    return FALSE;
+  }
+
+  replay->appsrc = (GstElement *) gst_object_ref (appsrc);
+  replay->speed = MAX (speed, 0.0);
+  replay->loops = MAX (loops, 1U);
+  replay->stop = 0;
+  replay->pushed = 0;
+
+  /* a few buffers are queued in appsrc, the replay waits for the pipeline */
+  g_object_set (appsrc, "format", GST_FORMAT_TIME, "block", TRUE,
+      "max-bytes", (guint64) MAX (replay->max_size * 4, 200000), NULL);
+
+  replay->thread = g_thread_new ("tensor_replay", _replay_thread, replay);
+  return TRUE;
+}
+
+/**
+ * @brief Stop pushing and wait for the thread.
+ * Call after EOS or after the pipeline is stopped, appsrc may block the thread.
+ */
+void
+tensor_replay_stop (TensorReplay * replay)
+{
+  g_return_if_fail (replay != NULL);
+
+  g_mutex_lock (&replay->lock);
+  replay->stop = 1;
+  g_cond_broadcast (&replay->cond);
+  g_mutex_unlock (&replay->lock);
+
+  if (replay->thread) {
+    g_thread_join (replay->thread);
+    replay->thread = NULL;
+  }
+
+  if (replay->appsrc) {
+    gst_object_unref (replay->appsrc);
+    replay->appsrc = NULL;
+  }
+}
+
+/**
+ * @brief Get the number of pushed buffers and the time from the first to the last push.
+ */
+guint64
+tensor_replay_get_pushed (TensorReplay * replay, gint64 * elapsed_us)
+{
+  guint64 pushed;
+
+  g_return_val_if_fail (replay != NULL, 0);
+
+  g_mutex_lock (&replay->lock);
+  pushed = replay->pushed;
+  if (elapsed_us)
+    *elapsed_us = replay->last_push - replay->first_push;
+  g_mutex_unlock (&replay->lock);
+
+  return pushed;
+}
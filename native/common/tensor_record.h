@@ -0,0 +1,136 @@
+/**
+ * @file	tensor_record.h
+ * @date	19 October 2026
+ * @brief	Recorder of the tensors at a pad and replay of them, for deterministic benchmarks
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Gichan Jang <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ *
+ * The examples start from a live camera or microphone, so the results differ from run to run
+ * and the postprocessing (decoders, NMS, overlays) could not be benchmarked alone.
+ * The recorder taps a pad (e.g., the output of tensor_filter) with pad probes, and appends
+ * the caps and the buffers (each memory, e.g., a tensor, and the timestamps) to a file mapped
+ * with mmap. The replay maps the file, and gives the buffers without copy, to call the callback
+ * of the application directly or to push them to appsrc at the recorded or the maximum rate.
+ *
+ * File: a header (TENSOR_RECORD_ALIGN bytes) and the records, each record has a header,
+ * the sizes of the memories and the memories, aligned to TENSOR_RECORD_ALIGN bytes.
+ *
+ * usage:
+ *   recorder = tensor_recorder_new ("ssd.tsrec");
+ *   tensor_recorder_attach (recorder, pad, 0);
+ *   (run the pipeline)
+ *   tensor_recorder_free (recorder);
+ *
+ *   replay = tensor_replay_open ("ssd.tsrec");
+ *   for (i = 0; i < tensor_replay_get_count (replay); i++) {
+ *     buffer = tensor_replay_get_buffer (replay, i);
+ *     new_data_cb (NULL, buffer, app);
+ *     gst_buffer_unref (buffer);
+ *   }
+ *   tensor_replay_start (replay, appsrc, 1.0, 1);
+ *   tensor_replay_free (replay);
+ */
+#ifndef __TENSOR_RECORD_H__
+#define __TENSOR_RECORD_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+#define TENSOR_RECORD_ALIGN 64
+#define TENSOR_RECORD_MAX_MEMS 16
+
+typedef struct _TensorRecorder TensorRecorder;
+typedef struct _TensorReplay TensorReplay;
+
+/**
+ * @brief Statistics of the recorder.
+ */
+typedef struct
+{
+  guint64 buffers; /**< recorded buffers */
+  guint64 caps; /**< recorded caps */
+  guint64 bytes; /**< size of the file */
+  guint64 dropped; /**< buffers not recorded, more than TENSOR_RECORD_MAX_MEMS memories or no space */
+  gint64 copy_us; /**< time to copy the buffers in the streaming thread */
+} TensorRecorderStats;
+
+/**
+ * @brief Create the recorder, the file is truncated.
+ */
+extern TensorRecorder * tensor_recorder_new (const gchar * path);
+
+/**
+ * @brief Record the caps and the buffers flowing through the pad.
+ * The current caps of the pad are recorded first, if the caps are already set.
+ * @param max_buffers stop recording after max_buffers, 0 for no limit
+ */
+extern gboolean tensor_recorder_attach (TensorRecorder * recorder, GstPad * pad, guint64 max_buffers);
+
+/**
+ * @brief Record the output of the element, the source pad or the sink pad of a sink element.
+ */
+extern gboolean tensor_recorder_attach_element (TensorRecorder * recorder, GstElement * pipeline, const gchar * name, guint64 max_buffers);
+
+/**
+ * @brief Get the statistics of the recorder.
+ */
+extern void tensor_recorder_get_stats (TensorRecorder * recorder, TensorRecorderStats * stats);
+
+/**
+ * @brief Remove the probes, write the header and close the file.
+ */
+extern void tensor_recorder_free (TensorRecorder * recorder);
+
+/**
+ * @brief Map the recorded file.
+ */
+extern TensorReplay * tensor_replay_open (const gchar * path);
+
+/**
+ * @brief Release the mapping, the buffers in use keep the file mapped.
+ */
+extern void tensor_replay_free (TensorReplay * replay);
+
+/**
+ * @brief Get the number of recorded buffers.
+ */
+extern guint tensor_replay_get_count (TensorReplay * replay);
+
+/**
+ * @brief Get the caps of the buffer, to be unreffed.
+ */
+extern GstCaps * tensor_replay_get_caps (TensorReplay * replay, guint index);
+
+/**
+ * @brief Get the recorded buffer, each memory wraps the mapped file without copy.
+ */
+extern GstBuffer * tensor_replay_get_buffer (TensorReplay * replay, guint index);
+
+/**
+ * @brief Get the recorded rate from the timestamps, 0 if unknown.
+ */
+extern gdouble tensor_replay_get_rate (TensorReplay * replay);
+
+/**
+ * @brief Push the buffers to appsrc from a thread, and EOS after the last loop.
+ * @param speed 1.0 for the recorded rate (the timestamps), 2.0 for twice, 0 for the maximum rate
+ * @param loops number of times to push the recorded buffers
+ */
+extern gboolean tensor_replay_start (TensorReplay * replay, GstElement * appsrc, gdouble speed, guint loops);
+
+/**
+ * @brief Stop pushing and wait for the thread.
+ */
+extern void tensor_replay_stop (TensorReplay * replay);
+
+/**
+ * @brief Get the number of pushed buffers and the time from the first to the last push.
+ */
+extern guint64 tensor_replay_get_pushed (TensorReplay * replay, gint64 * elapsed_us);
+
+G_END_DECLS
+
+#endif /* __TENSOR_RECORD_H__ */
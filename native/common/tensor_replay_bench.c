@@ -0,0 +1,330 @@
+/**
+ * @file	tensor_replay_bench.c
+ * @date	19 October 2026
+ * @brief	Record the tensors of a pipeline and replay them to the postprocessing alone
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Gichan Jang <gichan2.jang@samsung.com>
+ * @bug		No known bugs.
+ *
+ * record : run the pipeline and record the output of the element named with --tap,
+ *          until EOS or --count buffers.
+ * replay : push the recorded buffers with appsrc to the elements of --sink,
+ *          at the recorded rate (--rate=recorded), a factor of it or the maximum rate.
+ * info : print the caps and the number of the recorded buffers.
+ *
+ * $ ./tensor_replay_bench --mode=record --output=ssd.tsrec --tap=filter --count=300 \
+ *     --pipeline="v4l2src ! videoconvert ! videoscale ! video/x-raw,width=300,height=300,format=RGB ! \
+ *     tensor_converter ! tensor_transform mode=arithmetic option=typecast:float32,add:-127.5,div:127.5 ! \
+ *     tensor_filter name=filter framework=tensorflow-lite model=tflite_model/ssd_mobilenet_v2_coco.tflite ! fakesink"
+ * $ ./tensor_replay_bench --mode=replay --input=ssd.tsrec --rate=max --loops=10 \
+ *     --sink="tensor_decoder mode=bounding_boxes option1=mobilenet-ssd ... ! fakesink sync=false"
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include <glib.h>
+#include <gst/gst.h>
+#include "tensor_record.h"
+
+/**
+ * @brief Options of the benchmark.
+ */
+typedef struct
+{
+  gchar *pipeline; /**< pipeline description to record */
+  gchar *tap; /**< name of the element to record */
+  gchar *sink; /**< description of the elements after appsrc */
+  gchar *file; /**< recorded file */
+  gchar *rate; /**< max, recorded or a factor of the recorded rate */
+  guint64 count; /**< max buffers to record, 0 for no limit */
+  guint loops; /**< number of replays */
+} BenchOption;
+
+/**
+ * @brief Run the pipeline and record the output of the tap.
+ */
+static gboolean
+_run_record (const BenchOption * opt)
+{
+  GstElement *pipeline;
+  GstBus *bus;
+  GstMessage *msg = NULL;
+  TensorRecorder *recorder;
+  TensorRecorderStats stats;
+  gint64 start, elapsed;
+  gboolean ret = FALSE;
+
+  if (!opt->pipeline || !opt->tap) {
+    g_printerr ("record needs --pipeline and --tap\n");
+    return FALSE;
+  }
+
+  pipeline = gst_parse_launch (opt->pipeline, NULL);
+  if (pipeline == NULL) {
+    g_printerr ("Failed to parse the pipeline\n");
+    return FALSE;
+  }
+
+  recorder = tensor_recorder_new (opt->file);
+  if (recorder == NULL)
+    goto done;
+
+  if (!tensor_recorder_attach_element (recorder, pipeline, opt->tap, opt->count))
+    goto done;
+
+  bus = gst_element_get_bus (pipeline);
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  start = g_get_monotonic_time ();
+
+  /* check the count of the recorded buffers every 100 ms */
+  while (TRUE) {
+    msg = gst_bus_timed_pop_filtered (bus, 100 * GST_MSECOND,
+        (GstMessageType) (GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+    if (msg)
+      break;
+
+    tensor_recorder_get_stats (recorder, &stats);
+    if (opt->count > 0 && stats.buffers >= opt->count)
+      break;
+  }
+
+  elapsed = g_get_monotonic_time () - start;
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+
+  if (msg && GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    g_printerr ("Error in the pipeline\n");
+  } else {
+    tensor_recorder_get_stats (recorder, &stats);
+    g_print ("mode,buffers,caps,bytes,dropped,seconds,copy_us_per_buffer\n");
+    g_print ("record,%" G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT
+        ",%" G_GUINT64_FORMAT ",%.2f,%.1f\n", stats.buffers, stats.caps, stats.bytes,
+        stats.dropped, elapsed / (gdouble) G_USEC_PER_SEC,
+        stats.buffers > 0 ? stats.copy_us / (gdouble) stats.buffers : 0.0);
+    ret = (stats.buffers > 0);
+  }
+
+  if (msg)
+    gst_message_unref (msg);
+
+done:
+  tensor_recorder_free (recorder);
+  gst_object_unref (pipeline);
+  return ret;
+}
+
+/**
+ * @brief Push the recorded buffers to the sink and print the rate.
+ */
+static gboolean
+_run_replay (const BenchOption * opt, TensorReplay * replay)
+{
+  GstElement *pipeline, *appsrc;
+  GstBus *bus;
+  GstMessage *msg;
+  gchar *str_pipeline;
+  gdouble speed = 0.0;
+  gint64 start, elapsed, push_us;
+  guint64 pushed;
+  gboolean ret = FALSE;
+
+  if (g_str_equal (opt->rate, "recorded"))
+    speed = 1.0;
+  else if (!g_str_equal (opt->rate, "max"))
+    speed = g_ascii_strtod (opt->rate, NULL);
+
+  str_pipeline = g_strdup_printf ("appsrc name=src ! %s", opt->sink);
+  pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  if (pipeline == NULL) {
+    g_printerr ("Failed to parse the pipeline\n");
+    return FALSE;
+  }
+
+  appsrc = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+  bus = gst_element_get_bus (pipeline);
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  start = g_get_monotonic_time ();
+
+  if (tensor_replay_start (replay, appsrc, speed, opt->loops)) {
+    msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+        (GstMessageType) (GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+    elapsed = g_get_monotonic_time () - start;
+
+    gst_element_set_state (pipeline, GST_STATE_NULL);
+    tensor_replay_stop (replay);
+    pushed = tensor_replay_get_pushed (replay, &push_us);
+
+    if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS) {
+      g_print ("mode,rate,loops,recorded_fps,pushed,seconds,fps\n");
+      g_print ("replay,%s,%u,%.2f,%" G_GUINT64_FORMAT ",%.3f,%.2f\n", opt->rate,
+          opt->loops, tensor_replay_get_rate (replay), pushed,
+          elapsed / (gdouble) G_USEC_PER_SEC,
+          elapsed > 0 ? pushed * (gdouble) G_USEC_PER_SEC / elapsed : 0.0);
+      ret = TRUE;
+    } else {
+      g_printerr ("Error in the pipeline\n");
+    }
+
+    gst_message_unref (msg);
+  } else {
+    gst_element_set_state (pipeline, GST_STATE_NULL);
+  }
+
+  gst_object_unref (bus);
+  gst_object_unref (appsrc);
+  gst_object_unref (pipeline);
+  return ret;
+}
+
+/**
+ * @brief Print the caps and the number of the recorded buffers.
+ */
+static void
+_print_info (TensorReplay * replay)
+{
+  GstCaps *caps, *last = NULL;
+  gchar *str;
+  guint i, count = tensor_replay_get_count (replay);
+
+  g_print ("buffers: %u\nrate: %.2f\n", count, tensor_replay_get_rate (replay));
+
+  for (i = 0; i < count; i++) {
+    caps = tensor_replay_get_caps (replay, i);
+    if (caps && caps != last) {
+      str = gst_caps_to_string (caps);
+      g_print ("caps from buffer %u: %s\n", i, str);
+      g_free (str);
+    }
+
+    if (last)
+      gst_caps_unref (last);
+    last = caps;
+  }
+
+  if (last)
+    gst_caps_unref (last);
+}
+
+/**
+ * @brief Print usage info.
+ */
+static void
+_usage (void)
+{
+  g_print ("usage: tensor_replay_bench [options]\n"
+      "    --mode      record, replay or info. (default info)\n"
+      "    --pipeline  Pipeline description to record.\n"
+      "    --tap       Name of the element to record, its src pad or the sink pad of a sink.\n"
+      "    --output    File to record. (default tensors.tsrec)\n"
+      "    --count     Max buffers to record, 0 for no limit. (default 0)\n"
+      "    --input     File to replay. (default tensors.tsrec)\n"
+      "    --sink      Description of the elements after appsrc. (default fakesink sync=false)\n"
+      "    --rate      max, recorded or a factor of the recorded rate (e.g., 2.0). (default max)\n"
+      "    --loops     Number of replays. (default 1)\n");
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  BenchOption opt;
+  TensorReplay *replay;
+  gchar *mode = g_strdup ("info");
+  gint o, ret = 0;
+  struct option long_options[] = {
+    {"mode", required_argument, NULL, 'm'},
+    {"pipeline", required_argument, NULL, 'p'},
+    {"tap", required_argument, NULL, 't'},
+    {"output", required_argument, NULL, 'o'},
+    {"input", required_argument, NULL, 'i'},
+    {"count", required_argument, NULL, 'c'},
+    {"sink", required_argument, NULL, 'k'},
+    {"rate", required_argument, NULL, 'r'},
+    {"loops", required_argument, NULL, 'l'},
+    {"help", no_argument, NULL, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  memset (&opt, 0, sizeof (BenchOption));
+  opt.file = g_strdup ("tensors.tsrec");
+  opt.sink = g_strdup ("fakesink sync=false");
+  opt.rate = g_strdup ("max");
+  opt.loops = 1;
+
+  while ((o = getopt_long (argc, argv, "m:p:t:o:i:c:k:r:l:h", long_options, NULL)) != -1) {
+    switch (o) {
+      case 'm':
+        g_free (mode);
+        mode = g_strdup (optarg);
+        break;
+      case 'p':
+        g_free (opt.pipeline);
+        opt.pipeline = g_strdup (optarg);
+        break;
+      case 't':
+        g_free (opt.tap);
+        opt.tap = g_strdup (optarg);
+        break;
+      case 'o':
+      case 'i':
+        g_free (opt.file);
+        opt.file = g_strdup (optarg);
+        break;
+      case 'c':
+        opt.count = g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'k':
+        g_free (opt.sink);
+        opt.sink = g_strdup (optarg);
+        break;
+      case 'r':
+        g_free (opt.rate);
+        opt.rate = g_strdup (optarg);
+        break;
+      case 'l':
+        opt.loops = MAX ((guint) g_ascii_strtoull (optarg, NULL, 10), 1U);
+        break;
+      default:
+        _usage ();
+        ret = -1;
+        goto done;
+    }
+  }
+
+  gst_init (&argc, &argv);
+
+  if (g_str_equal (mode, "record")) {
+    if (!_run_record (&opt))
+      ret = -1;
+  } else if (g_str_equal (mode, "replay") || g_str_equal (mode, "info")) {
+    replay = tensor_replay_open (opt.file);
+    if (replay == NULL) {
+      ret = -1;
+      goto done;
+    }
+
+    if (g_str_equal (mode, "info"))
+      _print_info (replay);
+    else if (!_run_replay (&opt, replay))
+      ret = -1;
+
+    tensor_replay_free (replay);
+  } else {
+    _usage ();
+    ret = -1;
+  }
+
+done:
+  g_free (mode);
+  g_free (opt.pipeline);
+  g_free (opt.tap);
+  g_free (opt.sink);
+  g_free (opt.file);
+  g_free (opt.rate);
+  return ret;
+}
@@ -1,4 +1,7 @@
 #!/usr/bin/env bash
+# Run the server (or publisher) and client (or subscriber) benchmarks together.
+# Each benchmark samples its own CPU and memory usage (see native/common/resource_sampler.h)
+# and prints it with the received count, so ps/pidstat are not needed.
 if [ -z "$1" ]; then
   echo "video width is not given. Use 640."
   WIDTH="640"
@@ -18,83 +21,55 @@ else
   PROTOCOL="$3"
 fi
 
-COUNTER=0
 RUNNING_TIME=10
-
-SERVER_CPU_TOT=0
-SEVER_MEM_TOT=0
-CLIENT_CPU_TOT=0.0
-CLIENT_MEM_TOT=0
+SAMPLE_MS=100
+SERVER_LOG=$(mktemp)
+CLIENT_LOG=$(mktemp)
+COMMON="-t $RUNNING_TIME --width=$WIDTH --height=$HEIGHT --sample-ms=$SAMPLE_MS"
+MQTT_OPT="--desthost=127.0.0.1 --destport=1883 --topic=profilingTopic"
 
 START_TIME=$(date +%s.%3N)
 
 if [[ "$PROTOCOL" == "query/hybrid" ]]; then
-  ./performance_benchmark_query --server -t 100 --desthost=127.0.0.1 --destport=1883 --topic=profilingTopic --width=$WIDTH --height=$HEIGHT --connecttype=HYBRID &
-  ./performance_benchmark_query --client -t 100 --desthost=127.0.0.1 --destport=1883 --topic=profilingTopic --width=$WIDTH --height=$HEIGHT --connecttype=HYBRID &
-  SERVER_PID=`ps aux | grep performance_benchmark | grep server | awk '{print $2}'`
-  CLIENT_PID=`ps aux | grep performance_benchmark | grep client | awk '{print $2}'`
+  ./performance_benchmark_query --server $COMMON $MQTT_OPT --connecttype=HYBRID > $SERVER_LOG &
+  SERVER_PID=$!
+  ./performance_benchmark_query --client $COMMON $MQTT_OPT --connecttype=HYBRID > $CLIENT_LOG &
+  CLIENT_PID=$!
 elif [[ "$PROTOCOL" == "query/tcp" ]]; then
-  ./performance_benchmark_query --server -t 100 --width=$WIDTH --height=$HEIGHT &
-  ./performance_benchmark_query --client -t 100 --width=$WIDTH --height=$HEIGHT &
-  SERVER_PID=`ps aux | grep performance_benchmark | grep server | awk '{print $2}'`
-  CLIENT_PID=`ps aux | grep performance_benchmark | grep client | awk '{print $2}'`
-elif [[ "$PROTOCOL" == "pubsub/zmq" ]]; then # zemsrc/sink
-  ./performance_benchmark_broadcast --pub -t 100 --width=$WIDTH --height=$HEIGHT --connecttype=ZMQ &
-  ./performance_benchmark_broadcast --sub -t 100 --width=$WIDTH --height=$HEIGHT --connecttype=ZMQ &
-  SERVER_PID=`ps aux | grep performance_benchmark | grep pub | awk '{print $2}'`
-  CLIENT_PID=`ps aux | grep performance_benchmark | grep sub | awk '{print $2}'`
-elif [[ "$PROTOCOL" == "pubsub/hybrid" ]]; then #edgesrc/sink
-  ./performance_benchmark_broadcast --pub -t 100 --desthost=127.0.0.1 --destport=1883 --topic=profilingTopic --width=$WIDTH --height=$HEIGHT --connecttype=HYBRID &
-  ./performance_benchmark_broadcast --sub -t 100 --desthost=127.0.0.1 --destport=1883 --topic=profilingTopic --width=$WIDTH --height=$HEIGHT --connecttype=HYBRID &
-  SERVER_PID=`ps aux | grep performance_benchmark | grep pub | awk '{print $2}'`
-  CLIENT_PID=`ps aux | grep performance_benchmark | grep sub | awk '{print $2}'`
-elif [[ "$PROTOCOL" == "pubsub/aitt" ]]; then #edgesrc/sink
-  ./performance_benchmark_broadcast --pub -t 100 --desthost=127.0.0.1 --destport=1883 --topic=profilingTopic --width=$WIDTH --height=$HEIGHT --connecttype=AITT &
-  ./performance_benchmark_broadcast --sub -t 100 --desthost=127.0.0.1 --destport=1883 --topic=profilingTopic --width=$WIDTH --height=$HEIGHT --connecttype=AITT &
-  SERVER_PID=`ps aux | grep performance_benchmark | grep pub | awk '{print $2}'`
-  CLIENT_PID=`ps aux | grep performance_benchmark | grep sub | awk '{print $2}'`
-else # mqttsrc/sink
-  ./performance_benchmark_broadcast --pub -t 100 --width=$WIDTH --height=$HEIGHT --connecttype=MQTT &
-  ./performance_benchmark_broadcast --sub -t 100 --width=$WIDTH --height=$HEIGHT --connecttype=MQTT &
-  SERVER_PID=`ps aux | grep performance_benchmark | grep pub | awk '{print $2}'`
-  CLIENT_PID=`ps aux | grep performance_benchmark | grep sub | awk '{print $2}'`
+  ./performance_benchmark_query --server $COMMON > $SERVER_LOG &
+  SERVER_PID=$!
+  ./performance_benchmark_query --client $COMMON > $CLIENT_LOG &
+  CLIENT_PID=$!
+else
+  if [[ "$PROTOCOL" == "pubsub/zmq" ]]; then # zmqsrc/sink
+    TYPE_OPT="--connecttype=ZMQ"
+  elif [[ "$PROTOCOL" == "pubsub/hybrid" ]]; then # edgesrc/sink
+    TYPE_OPT="$MQTT_OPT --connecttype=HYBRID"
+  elif [[ "$PROTOCOL" == "pubsub/aitt" ]]; then # edgesrc/sink
+    TYPE_OPT="$MQTT_OPT --connecttype=AITT"
+  else # mqttsrc/sink
+    TYPE_OPT="--connecttype=MQTT"
+  fi
+  # start the subscriber first not to lose the first messages
+  ./performance_benchmark_broadcast --sub $COMMON $TYPE_OPT > $CLIENT_LOG &
+  CLIENT_PID=$!
+  sleep 1
+  ./performance_benchmark_broadcast --pub $COMMON $TYPE_OPT > $SERVER_LOG &
+  SERVER_PID=$!
 fi
 
 echo "server pid: $SERVER_PID client pid: $CLIENT_PID"
+wait $SERVER_PID $CLIENT_PID
 
-while true; do
-  STAT=`pidstat -u -r -p $SERVER_PID -p $CLIENT_PID 1 1`
-
-  SERVER_CPU=`echo "$STAT" | awk 'NR==4{print}' | awk '{print $10}'`
-  SEVER_MEM=`echo "$STAT" | awk 'NR==8{print}' | awk '{print $9}'`
-  SERVER_CPU_TOT=`awk "BEGIN{ print $SERVER_CPU_TOT + $SERVER_CPU }"`
-  SEVER_MEM_TOT=$[ $SEVER_MEM_TOT + $SEVER_MEM]
-
-  CLIENT_CPU=`echo "$STAT" | awk 'NR==5{print}' | awk '{print $10}'`
-  CLIENT_MEM=`echo "$STAT" | awk 'NR==9{print}' | awk '{print $9}'`
-  CLIENT_CPU_TOT=`awk "BEGIN{ print $CLIENT_CPU_TOT + $CLIENT_CPU }"`
-  CLIENT_MEM_TOT=$[ $CLIENT_MEM_TOT + $CLIENT_MEM]
-
-  echo "Server CPU total: $SERVER_CPU_TOT, mem total: $SEVER_MEM_TOT"
-  echo "Client CPU total: $CLIENT_CPU_TOT, mem total: $CLIENT_MEM_TOT"
-  echo ""
-
-  COUNTER=$[ $COUNTER +1 ]
-  echo "$COUNTER sec"
-  if [ $COUNTER -ge $RUNNING_TIME ]; then
-    break;
-  fi
-done
-ps aux  |  grep -i performance  |  awk '{print $2}'  |  xargs kill -15
 END_TIME=$(date +%s.%3N)
 ELAPSED=$(echo "scale=3; $END_TIME - $START_TIME" | bc)
-SERVER_CPU_AVG=`echo "scale=4; $SERVER_CPU_TOT / $RUNNING_TIME" | bc`
-SERVER_MEM_AVG=`echo "scale=4; $SEVER_MEM_TOT / $RUNNING_TIME" | bc`
-CLEINT_CPU_AVG=`echo "scale=4; $CLIENT_CPU_TOT / $RUNNING_TIME" | bc`
-CLIENT_MEM_AVG=`echo "scale=4; $CLIENT_MEM_TOT / $RUNNING_TIME" | bc`
 
-echo "$ELAPSED"
-echo "$SERVER_CPU_AVG"
-echo "$SERVER_MEM_AVG"
-echo "$CLEINT_CPU_AVG"
-echo "$CLIENT_MEM_AVG"
+# the header and the row of the resource usage, e.g., role,received,fps,cpu_avg_pct,...
+echo "$ELAPSED sec"
+grep -A 1 "^role," $SERVER_LOG
+grep -A 1 "^role," $CLIENT_LOG | tail -n 1
+echo ""
+grep "^thread," $SERVER_LOG
+grep "^thread," $CLIENT_LOG | tail -n +2
+
+rm -f $SERVER_LOG $CLIENT_LOG
@@ -1,4 +1,6 @@
 #!/usr/bin/env bash
+# Run a benchmark pipeline on CPU 0 and append the resource usage the benchmark sampled by itself
+# (see native/common/resource_sampler.h) to temp_result.txt.
 if [ -z "$1" ]; then
   echo "video width is not given. Use 640."
   WIDTH="640"
@@ -29,15 +31,13 @@ else
   FRAMERATE="$5"
 fi
 
-echo "" >> temp_result*.txt
-echo "$PROTOCOL" >> temp_result*.txt
-echo "$WIDTH X $HEIGHT" >> temp_result*.txt
-
-COUNTER=0
+RESULT=temp_result.txt
 RUNNING_TIME=10
+LOG=$(mktemp)
 
-CPU_TOT=0
-MEM_TOT=0
+echo "" >> $RESULT
+echo "$PROTOCOL" >> $RESULT
+echo "$WIDTH X $HEIGHT" >> $RESULT
 
 # cat /sys/devices/system/cpu/cpu0/cpufreq/scaling_available_governors
 # echo performance > /sys/devices/system/cpu/cpu0/cpufreq/scaling_governor
@@ -48,53 +48,34 @@ MEM_TOT=0
 # cat /sys/devices/system/cpu/offline
 # echo 1 > /sys/devices/system/cpu/cpu0/online
 
+COMMON="-t $RUNNING_TIME --width=$WIDTH --height=$HEIGHT --sample-ms=100"
+
 START_TIME=$(date +%s.%3N)
 
+# taskset sets the affinity before the threads are created
 if [[ "$PROTOCOL" == "query/mqtt" ]]; then
-  ./performance_benchmark_query --$TYPE -t 100 --srvhost= --desthost= --destport= --topic=profilingTopic --width=$WIDTH --height=$HEIGHT --connecttype=HYBRID --framerate=$FRAMERATE &
+  taskset -c 0 ./performance_benchmark_query --$TYPE $COMMON --srvhost= --desthost= --destport= --topic=profilingTopic --connecttype=HYBRID --framerate=$FRAMERATE > $LOG &
 elif [[ "$PROTOCOL" == "query/tcp" ]]; then
-  ./performance_benchmark_query --$TYPE -t 100 --srvhost= --srvport= --width=$WIDTH --height=$HEIGHT --framerate=$FRAMERATE &
+  taskset -c 0 ./performance_benchmark_query --$TYPE $COMMON --srvhost= --srvport= --framerate=$FRAMERATE > $LOG &
 elif [[ "$PROTOCOL" == "pubsub/zmq" ]]; then
-  ./performance_benchmark_broadcast --$TYPE -t 100 --host=  --width=$WIDTH --height=$HEIGHT --connecttype=ZMQ &
+  taskset -c 0 ./performance_benchmark_broadcast --$TYPE $COMMON --host= --connecttype=ZMQ > $LOG &
 elif [[ "$PROTOCOL" == "pubsub/hybrid" ]]; then
-  ./performance_benchmark_broadcast --$TYPE -t 100 --host= --desthost= --destport= --topic=profilingTopic --width=$WIDTH --height=$HEIGHT --connecttype=HYBRID &
+  taskset -c 0 ./performance_benchmark_broadcast --$TYPE $COMMON --host= --desthost= --destport= --topic=profilingTopic --connecttype=HYBRID > $LOG &
 elif [[ "$PROTOCOL" == "pubsub/aitt" ]]; then
-  ./performance_benchmark_broadcast --$TYPE -t 100 --host= --desthost= --destport= --topic=profilingTopic --width=$WIDTH --height=$HEIGHT --connecttype=AITT &
+  taskset -c 0 ./performance_benchmark_broadcast --$TYPE $COMMON --host= --desthost= --destport= --topic=profilingTopic --connecttype=AITT > $LOG &
 else
-  ./performance_benchmark_broadcast --$TYPE -t 100 --host= --width=$WIDTH --height=$HEIGHT --connecttype=MQTT &
+  taskset -c 0 ./performance_benchmark_broadcast --$TYPE $COMMON --host= --connecttype=MQTT > $LOG &
 fi
-PID=`ps aux | grep performance_benchmark | grep $TYPE | awk '{print $2}'`
+PID=$!
 
 echo "pid: $PID"
-taskset -cp 0 $PID
-
-while true; do
-  STAT=`pidstat -u -r -p $PID 1 1`
-
-  CPU=`echo "$STAT" | awk 'NR==4{print}' | awk '{print $8}'`
-  MEM=`echo "$STAT" | awk 'NR==7{print}' | awk '{print $7}'`
-  CPU_TOT=`awk "BEGIN{ print $CPU_TOT + $CPU }"`
-  MEM_TOT=$[ $MEM_TOT + $MEM]
-
-  echo "Server CPU total: $MEM, mem total: $MEM_TOT"
-  echo ""
-
-  COUNTER=$[ $COUNTER +1 ]
-  echo "$COUNTER sec"
-  if [ $COUNTER -ge $RUNNING_TIME ]; then
-    break;
-  fi
-done
+wait $PID
 
 END_TIME=$(date +%s.%3N)
 ELAPSED=$(echo "scale=3; $END_TIME - $START_TIME" | bc)
-kill -15 $PID
-elapsed=$(( end_time - start_time ))
-echo %elapsed
 
-CPU_AVG=`echo "scale=4; $CPU_TOT / $RUNNING_TIME" | bc`
-MEM_AVG=`echo "scale=4; $MEM_TOT / $RUNNING_TIME" | bc`
+echo "$ELAPSED" >> $RESULT
+grep -A 1 "^role," $LOG >> $RESULT
+grep "^thread," $LOG
 
-echo "$ELAPSED" >> temp_result*.txt
-echo "$CPU_AVG" >> temp_result*.txt
-echo "$MEM_AVG" >> temp_result*.txt
+rm -f $LOG
@@ -7,12 +7,34 @@
  */
 /**
  * @note The ZeroMQ element used from `https://github.com/mjhowell/gst-zeromq`
+ *
+ * The publisher writes a header (sequence number and send time) at the beginning of each payload.
+ * The subscriber measures throughput, one-way latency, jitter and gaps from the header.
+ * The send time is the wall-clock time, run publisher and subscriber on the same host
+ * or on hosts with synchronized clocks.
+ *
+ * Result is printed as CSV:
+ * transport,payload_bytes,sent,received,gaps,msgs_per_sec,mb_per_sec,lat_p50_us,lat_p90_us,lat_p99_us,lat_max_us,jitter_us
+ *
+ * Run example :
+ * $ ./performance_benchmark_broadcast --sub --connecttype=MQTT --size=65536 --timeout=10
+ * $ ./performance_benchmark_broadcast --pub --connecttype=MQTT --size=65536 --timeout=10
+ * Publisher and subscriber also print CPU and memory usage of the process (see resource_sampler.h) :
+ * role,messages,cpu_avg_pct,cpu_max_pct,rss_avg_mb,rss_peak_mb,...
+ * Push messages as fast as the transport accepts them with --rate=0 :
+ * $ ./performance_benchmark_broadcast --pub --connecttype=MQTT --size=65536 --rate=0 --timeout=10
+ * Sweep payload size with publisher and subscriber in one process :
+ * $ ./performance_benchmark_broadcast --sweep=1024,65536,1048576,8388608 --transports=MQTT,ZMQ --output=pubsub.csv
  */
 
 #include <unistd.h>
+#include <string.h>
+#include <stdio.h>
 #include <glib.h>
 #include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
 #include <getopt.h>
+#include "resource_sampler.h"
 
 /**
  * @brief Macro for debug mode.
@@ -26,7 +48,65 @@
  */
 #define _print_log(...) if (DBG) g_message (__VA_ARGS__)
 
-guint received;
+/**
+ * @brief Magic number of the payload header.
+ */
+#define PAYLOAD_MAGIC 0x4e4e5342U
+
+/**
+ * @brief Header at the beginning of each payload.
+ */
+typedef struct
+{
+  guint32 magic; /**< PAYLOAD_MAGIC */
+  guint32 reserved;
+  guint64 seq; /**< sequence number, starts from 0 */
+  gint64 sent; /**< wall-clock time (usec) when the message was pushed */
+} PayloadHeader;
+
+/**
+ * @brief Options of the benchmark.
+ */
+typedef struct
+{
+  gchar *connect_type; /**< MQTT, ZMQ, HYBRID or AITT */
+  gchar *host;
+  guint16 port;
+  gchar *dest_host;
+  guint16 dest_port;
+  gchar *topic;
+  guint size; /**< payload size in bytes */
+  guint rate; /**< messages per second, 0 for unthrottled */
+  guint timeout; /**< running time in sec */
+} BenchOptions;
+
+/**
+ * @brief Statistics of the subscriber.
+ */
+typedef struct
+{
+  GMutex lock;
+  guint64 received; /**< number of received messages */
+  guint64 bytes; /**< received bytes */
+  guint64 first_seq;
+  guint64 last_seq;
+  guint64 reordered; /**< messages with sequence number less than the last one */
+  gint64 first_time; /**< receive time of the first message */
+  gint64 last_time; /**< receive time of the last message */
+  gint64 prev_latency;
+  gdouble jitter_sum; /**< sum of the latency difference between consecutive messages */
+  GArray *latency; /**< one-way latency of each message (usec) */
+} SubStats;
+
+/**
+ * @brief Data structure for the publisher.
+ */
+typedef struct
+{
+  BenchOptions *opt;
+  GstElement *src;
+  guint64 sent; /**< number of pushed messages */
+} Publisher;
 
 /**
  * @brief Print usage info
@@ -42,10 +122,30 @@ _usage (void)
   "    --topic Set topic. \n"
   "    --host   Set host address. \n"
   "    --port   Set port. \n"
-  "    --repeat    Set the number of repetitions. \n"
   "    --timeout   Set the running time in Sec. \n"
   "    --width     Set the width of the video. \n"
-  "    --height    Set the height of the video. \n");
+  "    --height    Set the height of the video. \n"
+  "    --size      Set the payload size in bytes. (default width * height * 3) \n"
+  "    --rate      Set messages per second. (0: unthrottled, default 60) \n"
+  "    --sweep     Run publisher and subscriber in one process with given payload sizes. \n"
+  "    --transports  Set transports for the sweep. (default MQTT,ZMQ) \n"
+  "    --output    Append CSV result to the file. \n"
+  "    --sample-ms Set the interval to sample CPU and memory in ms. (0: disable, default 100) \n");
+}
+
+/**
+ * @brief Reset the statistics.
+ */
+static void
+_stats_reset (SubStats * stats)
+{
+  g_mutex_lock (&stats->lock);
+  stats->received = stats->bytes = 0;
+  stats->first_seq = stats->last_seq = stats->reordered = 0;
+  stats->first_time = stats->last_time = stats->prev_latency = 0;
+  stats->jitter_sum = 0.0;
+  g_array_set_size (stats->latency, 0);
+  g_mutex_unlock (&stats->lock);
 }
 
 /**
@@ -54,9 +154,388 @@ _usage (void)
 static void
 _new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
 {
-  /* print progress */
-  received++;
-  g_message ("receiving new data [%d]", received);
+  SubStats *stats = (SubStats *) user_data;
+  PayloadHeader header;
+  gint64 now = g_get_real_time ();
+  gint64 latency;
+
+  if (gst_buffer_extract (buffer, 0, &header, sizeof (PayloadHeader)) !=
+      sizeof (PayloadHeader) || header.magic != PAYLOAD_MAGIC) {
+    _print_log ("invalid payload");
+    return;
+  }
+
+  latency = now - header.sent;
+
+  g_mutex_lock (&stats->lock);
+  if (stats->received == 0) {
+    stats->first_seq = header.seq;
+    stats->first_time = now;
+  } else {
+    if (header.seq < stats->last_seq)
+      stats->reordered++;
+    stats->jitter_sum += ABS (latency - stats->prev_latency);
+  }
+
+  stats->last_seq = MAX (stats->last_seq, header.seq);
+  stats->last_time = now;
+  stats->prev_latency = latency;
+  stats->received++;
+  stats->bytes += gst_buffer_get_size (buffer);
+  g_array_append_val (stats->latency, latency);
+  g_mutex_unlock (&stats->lock);
+}
+
+/**
+ * @brief Compare function for latency values.
+ */
+static gint
+_compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 la = *((const gint64 *) a);
+  gint64 lb = *((const gint64 *) b);
+
+  return (la > lb) ? 1 : ((la < lb) ? -1 : 0);
+}
+
+/**
+ * @brief Get the percentile from the sorted latency array.
+ */
+static gint64
+_percentile (GArray * sorted, gdouble p)
+{
+  guint idx;
+
+  if (sorted->len == 0)
+    return 0;
+
+  idx = (guint) (p / 100.0 * (sorted->len - 1) + 0.5);
+  return g_array_index (sorted, gint64, MIN (idx, sorted->len - 1));
+}
+
+/**
+ * @brief Print the CSV header.
+ */
+static void
+_print_csv_header (FILE * out)
+{
+  fprintf (out, "transport,payload_bytes,sent,received,gaps,reordered,msgs_per_sec,"
+      "mb_per_sec,lat_p50_us,lat_p90_us,lat_p99_us,lat_max_us,jitter_us\n");
+}
+
+/**
+ * @brief Print the result of the subscriber as CSV.
+ * @param sent the number of sent messages, 0 if unknown.
+ */
+static void
+_print_csv (FILE * out, BenchOptions * opt, SubStats * stats, guint64 sent)
+{
+  guint64 expected, gaps;
+  gdouble span, msgs_per_sec = 0.0, mb_per_sec = 0.0, jitter = 0.0;
+
+  g_mutex_lock (&stats->lock);
+  g_array_sort (stats->latency, _compare_latency);
+
+  /* the subscriber may join after the first messages, count from the first received one */
+  expected = (stats->received > 0) ? stats->last_seq - stats->first_seq + 1 : sent;
+  if (sent > 0)
+    expected = MAX (expected, sent);
+  gaps = (expected > stats->received) ? expected - stats->received : 0;
+
+  span = (stats->last_time - stats->first_time) / (gdouble) G_USEC_PER_SEC;
+  if (stats->received > 1 && span > 0.0) {
+    msgs_per_sec = (stats->received - 1) / span;
+    mb_per_sec = msgs_per_sec * (stats->bytes / (gdouble) stats->received) /
+        (1024.0 * 1024.0);
+    jitter = stats->jitter_sum / (stats->received - 1);
+  }
+
+  fprintf (out, "%s,%u,%" G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT ",%"
+      G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT ",%.1f,%.2f,%" G_GINT64_FORMAT
+      ",%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%.1f\n",
+      opt->connect_type, opt->size, expected, stats->received, gaps,
+      stats->reordered, msgs_per_sec, mb_per_sec,
+      _percentile (stats->latency, 50.0), _percentile (stats->latency, 90.0),
+      _percentile (stats->latency, 99.0), _percentile (stats->latency, 100.0),
+      jitter);
+  fflush (out);
+  g_mutex_unlock (&stats->lock);
+}
+
+/**
+ * @brief Stop the sampler and print the resource usage of the process.
+ */
+static void
+_print_resource (ResourceSampler * sampler, const gchar * role, guint64 messages)
+{
+  ResourceSamplerReport report;
+  gchar *row;
+
+  if (!sampler)
+    return;
+
+  resource_sampler_stop (sampler);
+  resource_sampler_get_report (sampler, &report);
+  row = resource_sampler_csv_row (&report);
+
+  g_print ("role,messages,%s\n", resource_sampler_csv_header ());
+  g_print ("%s,%" G_GUINT64_FORMAT ",%s\n", role, messages, row);
+  resource_sampler_print_threads (&report, stdout);
+
+  g_free (row);
+  resource_sampler_report_clear (&report);
+}
+
+/**
+ * @brief Get the publisher pipeline.
+ */
+static gchar *
+_pub_pipeline (BenchOptions * opt)
+{
+  gchar *str_pipeline, *src, *block;
+
+  /* unthrottled publisher blocks in appsrc when the transport is slower, instead of queuing all messages */
+  block = (opt->rate == 0) ?
+      g_strdup_printf ("block=true max-bytes=%" G_GUINT64_FORMAT " ", (guint64) opt->size * 8) :
+      g_strdup ("");
+  src = g_strdup_printf ("appsrc name=src is-live=true format=time %s"
+      "caps=other/tensors,num_tensors=1,dimensions=%u:1:1:1,types=uint8,framerate=%u/1,format=static",
+      block, opt->size, opt->rate);
+  g_free (block);
+
+  if (0 == g_strcmp0 (opt->connect_type, "ZMQ")) {
+    gchar *endpoint = g_strdup ("");
+    if (0 != g_ascii_strcasecmp (opt->host, "")) {
+      g_free (endpoint);
+      endpoint = g_strdup_printf ("endpoint=tcp://%s:5556", opt->host);
+    }
+    str_pipeline = g_strdup_printf ("%s ! zmqsink %s", src, endpoint);
+    g_free (endpoint);
+  } else if (0 == g_strcmp0 (opt->connect_type, "MQTT")) {
+    gchar *mqtthost = g_strdup ("");
+    if (0 != g_ascii_strcasecmp (opt->host, "")) {
+      g_free (mqtthost);
+      mqtthost = g_strdup_printf ("host=%s", opt->host);
+    }
+    /* mqttsink allocates the message buffer with max-buffer-size */
+    str_pipeline = g_strdup_printf ("%s ! mqttsink pub-topic=%s %s max-buffer-size=%u sync=false",
+        src, opt->topic, mqtthost, opt->size + 4096);
+    g_free (mqtthost);
+  } else { /** For edgesrc/sink */
+    str_pipeline = g_strdup_printf ("%s ! edgesink host=%s port=0 dest-host=%s dest-port=%u "
+        "connect-type=%s topic=%s sync=false", src, opt->host, opt->dest_host,
+        opt->dest_port, opt->connect_type, opt->topic);
+  }
+
+  g_free (src);
+  return str_pipeline;
+}
+
+/**
+ * @brief Get the subscriber pipeline.
+ */
+static gchar *
+_sub_pipeline (BenchOptions * opt)
+{
+  gchar *str_pipeline;
+
+  if (0 == g_strcmp0 (opt->connect_type, "ZMQ")) {
+    gchar *endpoint = g_strdup ("");
+    if (0 != g_ascii_strcasecmp (opt->host, "")) {
+      g_free (endpoint);
+      endpoint = g_strdup_printf ("endpoint=tcp://%s:5556", opt->host);
+    }
+    str_pipeline = g_strdup_printf ("zmqsrc %s ! tensor_sink name=sinkx sync=false", endpoint);
+    g_free (endpoint);
+  } else if (0 == g_strcmp0 (opt->connect_type, "MQTT")) {
+    gchar *mqtthost = g_strdup ("");
+    if (0 != g_ascii_strcasecmp (opt->host, "")) {
+      g_free (mqtthost);
+      mqtthost = g_strdup_printf ("host=%s", opt->host);
+    }
+    str_pipeline = g_strdup_printf ("mqttsrc sub-topic=%s %s ! tensor_sink name=sinkx sync=false",
+        opt->topic, mqtthost);
+    g_free (mqtthost);
+  } else { /** For edgesrc/sink */
+    str_pipeline = g_strdup_printf ("edgesrc host=%s port=0 dest-host=%s dest-port=%u "
+        "connect-type=%s topic=%s ! tensor_sink name=sinkx sync=false", opt->host,
+        opt->dest_host, opt->dest_port, opt->connect_type, opt->topic);
+  }
+
+  return str_pipeline;
+}
+
+/**
+ * @brief Publisher thread, pushes messages at the given rate or as fast as possible with rate 0.
+ */
+static gpointer
+_pub_thread (gpointer user_data)
+{
+  Publisher *pub = (Publisher *) user_data;
+  BenchOptions *opt = pub->opt;
+  gint64 start, next, end, interval, now;
+  PayloadHeader header;
+  GstBuffer *buf;
+
+  interval = (opt->rate > 0) ? G_USEC_PER_SEC / opt->rate : 0;
+  start = next = g_get_monotonic_time ();
+  end = start + (gint64) opt->timeout * G_USEC_PER_SEC;
+
+  memset (&header, 0, sizeof (PayloadHeader));
+  header.magic = PAYLOAD_MAGIC;
+
+  while ((now = g_get_monotonic_time ()) < end) {
+    if (now < next) {
+      g_usleep (next - now);
+      continue;
+    }
+    next += interval;
+
+    buf = gst_buffer_new_allocate (NULL, opt->size, NULL);
+    header.seq = pub->sent;
+    header.sent = g_get_real_time ();
+    gst_buffer_fill (buf, 0, &header, sizeof (PayloadHeader));
+    GST_BUFFER_PTS (buf) = (now - start) * GST_USECOND;
+
+    if (gst_app_src_push_buffer (GST_APP_SRC (pub->src), buf) != GST_FLOW_OK) {
+      _print_log ("failed to push buffer [%" G_GUINT64_FORMAT "]", header.seq);
+      break;
+    }
+    pub->sent++;
+  }
+
+  gst_app_src_end_of_stream (GST_APP_SRC (pub->src));
+  return NULL;
+}
+
+/**
+ * @brief Stop and release the pipeline.
+ */
+static void
+_stop_pipeline (GstElement * pipeline)
+{
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  g_usleep (200 * 1000);
+
+  gst_element_set_state (pipeline, GST_STATE_READY);
+  g_usleep (200 * 1000);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  g_usleep (200 * 1000);
+
+  gst_object_unref (pipeline);
+}
+
+/**
+ * @brief Create and start the subscriber pipeline.
+ */
+static GstElement *
+_start_sub (BenchOptions * opt, SubStats * stats)
+{
+  GstElement *pipeline, *element;
+  gchar *str_pipeline;
+
+  str_pipeline = _sub_pipeline (opt);
+  _print_log ("%s", str_pipeline);
+  pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  if (!pipeline)
+    return NULL;
+
+  element = gst_bin_get_by_name (GST_BIN (pipeline), "sinkx");
+  g_signal_connect (element, "new-data", (GCallback) _new_data_cb, stats);
+  gst_object_unref (element);
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  return pipeline;
+}
+
+/**
+ * @brief Create the publisher pipeline and push messages until timeout.
+ * @return the number of pushed messages.
+ */
+static guint64
+_run_pub (BenchOptions * opt)
+{
+  GstElement *pipeline;
+  Publisher pub;
+  GThread *thread;
+  gchar *str_pipeline;
+
+  str_pipeline = _pub_pipeline (opt);
+  _print_log ("%s", str_pipeline);
+  pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  if (!pipeline)
+    return 0;
+
+  memset (&pub, 0, sizeof (Publisher));
+  pub.opt = opt;
+  pub.src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  thread = g_thread_new ("publisher", _pub_thread, &pub);
+  g_thread_join (thread);
+
+  /* wait for the sink to send remaining messages */
+  g_usleep (500 * 1000);
+
+  gst_object_unref (pub.src);
+  _stop_pipeline (pipeline);
+  return pub.sent;
+}
+
+/**
+ * @brief Sweep payload sizes for each transport with publisher and subscriber in one process.
+ */
+static void
+_run_sweep (BenchOptions * opt, const gchar * sizes, const gchar * transports,
+    FILE * out)
+{
+  gchar **size_arr = g_strsplit (sizes, ",", -1);
+  gchar **transport_arr = g_strsplit (transports, ",", -1);
+  gchar *connect_type = opt->connect_type;
+  GstElement *sub;
+  SubStats stats;
+  guint64 sent;
+  guint s, t;
+
+  memset (&stats, 0, sizeof (SubStats));
+  g_mutex_init (&stats.lock);
+  stats.latency = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+  for (t = 0; transport_arr[t]; t++) {
+    opt->connect_type = g_strstrip (transport_arr[t]);
+
+    for (s = 0; size_arr[s]; s++) {
+      opt->size = MAX ((guint) g_ascii_strtoull (size_arr[s], NULL, 10),
+          (guint) sizeof (PayloadHeader));
+      _stats_reset (&stats);
+
+      sub = _start_sub (opt, &stats);
+      if (!sub) {
+        g_critical ("Failed to start subscriber (%s).", opt->connect_type);
+        continue;
+      }
+      /* wait for the subscription */
+      g_usleep (1000 * 1000);
+
+      sent = _run_pub (opt);
+      /* wait for messages in flight */
+      g_usleep (1000 * 1000);
+
+      _stop_pipeline (sub);
+      _print_csv (out, opt, &stats, sent);
+      if (out != stdout)
+        _print_csv (stdout, opt, &stats, sent);
+    }
+  }
+
+  opt->connect_type = connect_type;
+  g_array_free (stats.latency, TRUE);
+  g_mutex_clear (&stats.lock);
+  g_strfreev (size_arr);
+  g_strfreev (transport_arr);
 }
 
 /**
@@ -65,12 +544,17 @@ _new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
 int
 main (int argc, char **argv)
 {
-  gchar *str_pipeline = NULL, *in_dim = NULL;
-  GstElement *pipeline, *element;
+  BenchOptions opt;
+  GstElement *pipeline;
   gboolean is_pub = TRUE;
-  gchar *host = g_strdup ("127.0.0.1"), *topic = NULL, *connect_type = g_strdup ("TCP"), *dest_host = g_strdup ("");
-  guint16 port = 1883, repeat = 1, timeout = 10, width = 640, height = 480, dest_port=1883;
-  gint opt;
+  gchar *sweep = NULL, *transports = g_strdup ("MQTT,ZMQ"), *output = NULL;
+  guint16 width = 640, height = 480;
+  guint sample_ms = 100;
+  ResourceSampler *sampler = NULL;
+  SubStats stats;
+  FILE *out = stdout;
+  guint64 sent;
+  gint ch;
   struct option long_options[] = {
       { "pub", no_argument, NULL, 'p' },
       { "sub", no_argument, NULL, 's' },
@@ -79,23 +563,36 @@ main (int argc, char **argv)
       { "port", required_argument,  NULL, 'b' },
       { "desthost", required_argument,  NULL, 'm' },
       { "destport", required_argument,  NULL, 'd' },
-      { "repeat", required_argument,  NULL, 'r' },
       { "timeout", required_argument,  NULL, 't' },
       { "help", required_argument,  NULL, 'h' },
       { "width", required_argument,  NULL, 'w' },
       { "height", required_argument,  NULL, 'a' },
       { "connecttype", required_argument,  NULL, 'c' },
+      { "size", required_argument,  NULL, 'z' },
+      { "rate", required_argument,  NULL, 'f' },
+      { "sweep", required_argument,  NULL, 'S' },
+      { "transports", required_argument,  NULL, 'T' },
+      { "output", required_argument,  NULL, 'O' },
+      { "sample-ms", required_argument,  NULL, 'M' },
       { 0, 0, 0, 0}
   };
-  gchar *optstring = "z:m:p:s:o:u:b:r:t:h:w:a";
+  gchar *optstring = "";
 
   /* init gstreamer */
   gst_init (&argc, &argv);
 
-  topic = g_strdup ("pubsub/benchmark");
+  memset (&opt, 0, sizeof (BenchOptions));
+  opt.host = g_strdup ("127.0.0.1");
+  opt.port = 1883;
+  opt.connect_type = g_strdup ("TCP");
+  opt.dest_host = g_strdup ("");
+  opt.dest_port = 1883;
+  opt.topic = g_strdup ("pubsub/benchmark");
+  opt.rate = 60;
+  opt.timeout = 10;
 
-  while ((opt = getopt_long (argc, argv, optstring, long_options, NULL)) != -1) {
-    switch (opt) {
+  while ((ch = getopt_long (argc, argv, optstring, long_options, NULL)) != -1) {
+    switch (ch) {
       case 'p':
         is_pub = TRUE;
         break;
@@ -103,20 +600,18 @@ main (int argc, char **argv)
         is_pub = FALSE;
         break;
       case 'o':
-        topic = g_strdup (optarg);
+        g_free (opt.topic);
+        opt.topic = g_strdup (optarg);
         break;
       case 'u':
-        g_free (host);
-        host = g_strdup (optarg);
+        g_free (opt.host);
+        opt.host = g_strdup (optarg);
         break;
       case 'b':
-        port = (guint16) g_ascii_strtoll (optarg, NULL, 10);
-        break;
-      case 'r':
-        repeat = (guint16) g_ascii_strtoll (optarg, NULL, 10);
+        opt.port = (guint16) g_ascii_strtoll (optarg, NULL, 10);
         break;
       case 't':
-        timeout = (guint16) g_ascii_strtoll (optarg, NULL, 10);
+        opt.timeout = (guint) g_ascii_strtoll (optarg, NULL, 10);
         break;
       case 'w':
         width = (guint16) g_ascii_strtoll (optarg, NULL, 10);
@@ -125,102 +620,110 @@ main (int argc, char **argv)
         height = (guint16) g_ascii_strtoll (optarg, NULL, 10);
         break;
       case 'c':
-        g_free (connect_type);
-        connect_type = g_strdup (optarg);
+        g_free (opt.connect_type);
+        opt.connect_type = g_strdup (optarg);
         break;
       case 'm':
-        g_free (dest_host);
-        dest_host = g_strdup (optarg);
+        g_free (opt.dest_host);
+        opt.dest_host = g_strdup (optarg);
         break;
       case 'd':
-        dest_port = (guint16) g_ascii_strtoll (optarg, NULL, 10);
+        opt.dest_port = (guint16) g_ascii_strtoll (optarg, NULL, 10);
+        break;
+      case 'z':
+        opt.size = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'f':
+        opt.rate = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'S':
+        g_free (sweep);
+        sweep = g_strdup (optarg);
+        break;
+      case 'T':
+        g_free (transports);
+        transports = g_strdup (optarg);
+        break;
+      case 'O':
+        g_free (output);
+        output = g_strdup (optarg);
+        break;
+      case 'M':
+        sample_ms = (guint) g_ascii_strtoull (optarg, NULL, 10);
         break;
       default:
         _usage ();
-        return 0;
+        goto done;
     }
   }
 
-  g_print ("host: %s, port: %u\n", host, port);
-  g_print ("topic: %s, repeat: %u \n\n", topic, repeat);
+  if (opt.size == 0)
+    opt.size = (guint) width * height * 3;
+  opt.size = MAX (opt.size, (guint) sizeof (PayloadHeader));
 
-  /* Create pipeline */
-  if (0 == g_strcmp0 (connect_type, "ZMQ")) {
-    gchar *endpoint = g_strdup ("");
-    if (0 != g_ascii_strcasecmp (host, "")) {
-      g_free (endpoint);
-      endpoint = g_strdup_printf ("endpoint=tcp://%s:5556", host);
-    }
-    if (is_pub) {
-      str_pipeline =
-          g_strdup_printf
-          ("videotestsrc is-live=true ! videoconvert ! videoscale ! video/x-raw,width=%u,height=%u,format=RGB,framerate=60/1 ! tensor_converter ! zmqsink %s", width, height, endpoint);
-    } else {
-      str_pipeline =
-          g_strdup_printf
-          ("zmqsrc %s ! tensor_sink name=sinkx sync=true", endpoint);
-    }
-    g_free (endpoint);
-  } else if (0 == g_strcmp0 (connect_type, "MQTT")) {
-    gchar *mqtthost = g_strdup ("");
-    if (0 != g_ascii_strcasecmp (host, "")) {
-      g_free (mqtthost);
-      mqtthost = g_strdup_printf ("host=%s", host);
-    }
-    if (is_pub) {
-      str_pipeline =
-          g_strdup_printf
-          ("videotestsrc is-live=true ! videoconvert ! videoscale ! video/x-raw,width=%u,height=%u,format=RGB,framerate=60/1 ! tensor_converter ! mqttsink pub-topic=%s %s sync=true", width, height, topic, mqtthost);
-    } else {
-      str_pipeline =
-           g_strdup_printf
-           ("mqttsrc sub-topic=%s %s ! tensor_sink name=sinkx sync=true", topic, mqtthost);
-    }
-    g_free (mqtthost);
-  } else { /** For edgesrc/sink */
-    if (is_pub) {
-      str_pipeline =
-          g_strdup_printf
-          ("videotestsrc is-live=true ! videoconvert ! videoscale ! video/x-raw,width=%u,height=%u,format=RGB,framerate=60/1 ! tensor_converter ! edgesink host=%s port=0  dest-host=%s dest-port=%u connect-type=%s topic=%s sync=true", width, height, host, dest_host, dest_port, connect_type, topic);
-    } else {
-      str_pipeline =
-           g_strdup_printf
-           ("edgesrc host=%s port=0 dest-host=%s dest-port=%u connect-type=%s topic=%s ! tensor_sink name=sinkx sync=true", host, dest_host, dest_port, connect_type, topic);
+  g_print ("host: %s, port: %u\n", opt.host, opt.port);
+  g_print ("topic: %s \n\n", opt.topic);
+
+  if (output) {
+    gboolean exists = g_file_test (output, G_FILE_TEST_EXISTS);
+
+    out = fopen (output, "a");
+    if (!out) {
+      g_critical ("Failed to open %s", output);
+      goto done;
     }
+    if (!exists)
+      _print_csv_header (out);
   }
 
-  g_print ("%s\n", str_pipeline);
-  pipeline = gst_parse_launch (str_pipeline, NULL);
-  g_free (str_pipeline);
-
-  element = gst_bin_get_by_name (GST_BIN (pipeline), "sinkx");
-  g_signal_connect (element, "new-data", (GCallback) _new_data_cb, NULL);
-  gst_object_unref (element);
-  received = 0;
+  /* the sweep runs both roles in a process, sample the single role only */
+  if (!sweep && sample_ms > 0) {
+    sampler = resource_sampler_new (sample_ms, RESOURCE_SAMPLER_THREADS);
+    resource_sampler_start (sampler);
+  }
 
-  /* start pipeline */
-  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  if (sweep) {
+    _print_csv_header (stdout);
+    _run_sweep (&opt, sweep, transports, out);
+  } else if (is_pub) {
+    sent = _run_pub (&opt);
+    g_print ("Sent data cnt: %" G_GUINT64_FORMAT "\n", sent);
+    _print_resource (sampler, "pub", sent);
+  } else {
+    memset (&stats, 0, sizeof (SubStats));
+    g_mutex_init (&stats.lock);
+    stats.latency = g_array_new (FALSE, FALSE, sizeof (gint64));
 
-  g_usleep (timeout * 1000 * 1000);
+    pipeline = _start_sub (&opt, &stats);
+    if (pipeline) {
+      g_usleep ((guint64) opt.timeout * G_USEC_PER_SEC);
+      _stop_pipeline (pipeline);
 
-  g_message ("Received data cnt: %u", received);
+      if (out != stdout)
+        _print_csv (out, &opt, &stats, 0);
+      _print_csv_header (stdout);
+      _print_csv (stdout, &opt, &stats, 0);
+      _print_resource (sampler, "sub", stats.received);
+    }
 
-  gst_element_set_state (pipeline, GST_STATE_PAUSED);
-  g_usleep (200 * 1000);
+    g_array_free (stats.latency, TRUE);
+    g_mutex_clear (&stats.lock);
+  }
 
-  gst_element_set_state (pipeline, GST_STATE_READY);
-  g_usleep (200 * 1000);
+  if (out != stdout)
+    fclose (out);
 
-  gst_element_set_state (pipeline, GST_STATE_NULL);
-  g_usleep (200 * 1000);
+  if (sampler)
+    resource_sampler_free (sampler);
 
-  gst_object_unref (pipeline);
-  pipeline = NULL;
-  g_free (host);
-  g_free (dest_host);
-  g_free (connect_type);
-  g_free (topic);
-  g_free (in_dim);
+done:
+  g_free (opt.host);
+  g_free (opt.dest_host);
+  g_free (opt.connect_type);
+  g_free (opt.topic);
+  g_free (sweep);
+  g_free (transports);
+  g_free (output);
 
   return 0;
 }
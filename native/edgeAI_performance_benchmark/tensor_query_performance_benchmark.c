@@ -12,6 +12,7 @@
 #include <getopt.h>
 #include <nnstreamer_plugin_api.h>
 #include <nnstreamer/tensor_filter_custom_easy.h>
+#include "resource_sampler.h"
 
 guint received;
 
@@ -45,7 +46,8 @@ _usage (void)
   "    --repeat    Set the number of repetitions. \n"
   "    --timeout   Set the running time in Sec. \n"
   "    --width     Set the width of the video. \n"
-  "    --height    Set the height of the video. \n");
+  "    --height    Set the height of the video. \n"
+  "    --sample-ms Set the interval to sample CPU and memory in ms. (0: disable, default 100) \n");
 }
 
 /**
@@ -87,6 +89,11 @@ main (int argc, char **argv)
   GstElement *pipeline, *element;
   gchar *srv_host, *client_host, *topic = NULL, *dest_host = NULL, *connect_type = NULL;
   guint16 srv_port = 5001, dest_port = 1883, repeat = 1, timeout = 10, width=640, height=480, framerate = 60;
+  guint sample_ms = 100;
+  ResourceSampler *sampler = NULL;
+  ResourceSamplerReport report;
+  gchar *row;
+  gint64 start_time, end_time;
   gint opt;
   struct option long_options[] = {
       { "server", no_argument, NULL, 's' },
@@ -105,6 +112,7 @@ main (int argc, char **argv)
       { "height", required_argument,  NULL, 'a' },
       { "connecttype", required_argument,  NULL, 'p' },
       { "framerate", required_argument,  NULL, 'f' },
+      { "sample-ms", required_argument,  NULL, 'e' },
       { 0, 0, 0, 0}
   };
   gchar *optstring = "s:c:o:u:b:k:n:m:r:t:h:w:a";
@@ -173,6 +181,9 @@ main (int argc, char **argv)
       case 'f':
         framerate = (guint16) g_ascii_strtoll (optarg, NULL, 10);
         break;
+      case 'e':
+        sample_ms = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
       default:
         _usage ();
         return 0;
@@ -231,16 +242,42 @@ main (int argc, char **argv)
 
   /** Shut down the application after timeout. */
   element = gst_bin_get_by_name (GST_BIN (pipeline), "sinkx");
-  g_signal_connect (element, "new-data", (GCallback) _new_data_cb, NULL);
-  gst_object_unref (element);
+  if (element) {
+    g_signal_connect (element, "new-data", (GCallback) _new_data_cb, NULL);
+    gst_object_unref (element);
+  }
   received = 0;
 
+  /* sample this process instead of polling it with pidstat */
+  if (sample_ms > 0) {
+    sampler = resource_sampler_new (sample_ms, RESOURCE_SAMPLER_THREADS);
+    resource_sampler_start (sampler);
+  }
+
+  start_time = g_get_monotonic_time ();
   gst_element_set_state (pipeline, GST_STATE_PLAYING);
   g_message ("Start pipeline");
 
   g_usleep ((timeout + 1) * 1000 * 1000);
 
+  end_time = g_get_monotonic_time ();
   g_message ("Received data cnt: %u", received);
+
+  if (sampler) {
+    resource_sampler_stop (sampler);
+    resource_sampler_get_report (sampler, &report);
+    row = resource_sampler_csv_row (&report);
+
+    g_print ("role,received,fps,%s\n", resource_sampler_csv_header ());
+    g_print ("%s,%u,%.2f,%s\n", is_server ? "server" : "client", received,
+        received * (gdouble) G_USEC_PER_SEC / MAX (end_time - start_time, 1), row);
+    resource_sampler_print_threads (&report, stdout);
+
+    g_free (row);
+    resource_sampler_report_clear (&report);
+    resource_sampler_free (sampler);
+  }
+
   gst_element_set_state (pipeline, GST_STATE_PAUSED);
   g_usleep (200 * 1000);
 
@@ -0,0 +1,616 @@
+/**
+ * @file	tensor_query_scaling_benchmark.c
+ * @date	19 Oct 2026
+ * @brief	edgeAI performance benchmark - scaling of query servers and clients
+ * @author	Gichan Jang <gichan2.jnag@samsung.com>
+ * @bug		No known bugs.
+ *
+ * The orchestrator starts N query servers and M clients on localhost and sweeps N and M.
+ * With MQTT-hybrid, the servers publish their information to the same topic
+ * (see bash_script/example_tensor_query_mqtt) and each client chooses a server.
+ * With TCP, the clients are assigned to the servers in round-robin order.
+ *
+ * Each client runs closed-loop with one frame in flight. The client writes the send time into
+ * the payload, and the server echoes it back, so the client measures the round-trip latency.
+ * A frame without reply in --reply-timeout msec is resent, so a lost reply does not stall the client.
+ * Each case uses its own topic and server ids, so a client does not choose a server of the previous case.
+ * Each server counts the processed frames to show the load imbalance.
+ *
+ * By default the orchestrator spawns 'mosquitto' on the given broker port as a local broker stand-in.
+ *
+ * Run example :
+ * $ ./performance_benchmark_query_scaling --servers=1,2,4 --clients=1,4,8,16 --timeout=10
+ * $ ./performance_benchmark_query_scaling --connecttype=TCP --servers=1,2,4 --clients=8
+ */
+
+#include <unistd.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/types.h>
+#include <glib.h>
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+#include <getopt.h>
+#include <nnstreamer_plugin_api.h>
+#include <nnstreamer/tensor_filter_custom_easy.h>
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) if (DBG) g_message (__VA_ARGS__)
+
+/**
+ * @brief Options of the benchmark.
+ */
+typedef struct
+{
+  gchar *connect_type; /**< HYBRID or TCP */
+  gchar *dest_host; /**< broker host */
+  guint16 dest_port; /**< broker port */
+  gchar *topic; /**< MQTT-hybrid topic */
+  guint16 srv_port; /**< base port of the TCP servers */
+  gboolean spawn_broker; /**< start mosquitto as a local broker stand-in */
+  gchar *servers; /**< comma separated server counts */
+  gchar *clients; /**< comma separated client counts */
+  guint timeout; /**< running time of each case in sec */
+  guint width;
+  guint height;
+  guint cost_us; /**< processing time of the server per frame */
+  guint reply_timeout_ms; /**< resend the frame without reply after this time */
+  guint case_id; /**< index of the running case, for the topic and the server ids */
+} BenchOptions;
+
+/**
+ * @brief Data structure for a query server.
+ */
+typedef struct
+{
+  GstElement *pipeline;
+  gchar *model_name;
+  guint cost_us;
+  gint processed; /**< number of processed frames */
+} QueryServer;
+
+/**
+ * @brief Data structure for a query client.
+ */
+typedef struct
+{
+  GstElement *pipeline;
+  GstElement *src;
+  gsize frame_size;
+  gboolean running;
+  GMutex lock;
+  gint64 sent; /**< send time of the frame in flight */
+  guint64 timeouts; /**< frames resent without reply */
+  GArray *latency; /**< round-trip latency (usec) */
+} QueryClient;
+
+/**
+ * @brief Print usage info
+ */
+static void
+_usage (void)
+{
+  g_message ("\nusage: \n"
+  "    --connecttype Set connect type, HYBRID or TCP. (default HYBRID) \n"
+  "    --desthost    Set broker host address. (default 127.0.0.1) \n"
+  "    --destport    Set broker port. (default 1883) \n"
+  "    --topic       Set MQTT-hybrid topic. \n"
+  "    --srvport     Set the base port of TCP servers. (default 5001) \n"
+  "    --nobroker    Do not spawn mosquitto, use the running broker. \n"
+  "    --servers     Set server counts to sweep. (default 1,2,4) \n"
+  "    --clients     Set client counts to sweep. (default 1,2,4,8,16) \n"
+  "    --timeout     Set the running time of each case in Sec. (default 10) \n"
+  "    --width       Set the width of the video. (default 320) \n"
+  "    --height      Set the height of the video. (default 240) \n"
+  "    --cost        Set the processing time of the server in usec. (default 5000) \n"
+  "    --reply-timeout  Set the time in msec to resend a frame without reply. (default 1000) \n");
+}
+
+/**
+ * @brief Function for custom-easy filter, echoes the input and counts processed frames.
+ */
+static int
+_server_invoke (void *data, const GstTensorFilterProperties * prop,
+    const GstTensorMemory * in, GstTensorMemory * out)
+{
+  QueryServer *server = (QueryServer *) data;
+
+  memcpy (out[0].data, in[0].data, MIN (in[0].size, out[0].size));
+  if (server->cost_us > 0)
+    g_usleep (server->cost_us);
+
+  g_atomic_int_inc (&server->processed);
+  return 0;
+}
+
+/**
+ * @brief Get the topic of the running case.
+ */
+static gchar *
+_get_case_topic (BenchOptions * opt)
+{
+  return g_strdup_printf ("%s_%u", opt->topic, opt->case_id);
+}
+
+/**
+ * @brief Start a query server.
+ */
+static gboolean
+_server_start (QueryServer * server, BenchOptions * opt, guint idx)
+{
+  GstTensorsInfo info;
+  gchar *str_pipeline, *in_dim, *topic;
+  /* new ids for each case, the servers of the previous case may be still known to the broker */
+  guint id = opt->case_id * 1000 + idx + 1;
+
+  memset (server, 0, sizeof (QueryServer));
+  server->cost_us = opt->cost_us;
+  server->model_name = g_strdup_printf ("scaling_server_%u", id);
+
+  in_dim = g_strdup_printf ("3:%u:%u:1", opt->width, opt->height);
+  gst_tensors_info_init (&info);
+  info.num_tensors = 1U;
+  info.info[0].type = _NNS_UINT8;
+  gst_tensor_parse_dimension (in_dim, info.info[0].dimension);
+  NNS_custom_easy_register (server->model_name, _server_invoke, server,
+      &info, &info);
+
+  if (g_ascii_strcasecmp (opt->connect_type, "HYBRID") == 0) {
+    topic = _get_case_topic (opt);
+    str_pipeline = g_strdup_printf
+        ("tensor_query_serversrc id=%u host=localhost port=0 dest-host=%s dest-port=%u "
+        "topic=%s connect-type=HYBRID ! "
+        "other/tensors,num_tensors=1,dimensions=%s,types=uint8,framerate=0/1,format=static ! "
+        "tensor_filter framework=custom-easy model=%s ! "
+        "tensor_query_serversink id=%u connect-type=HYBRID async=false",
+        id, opt->dest_host, opt->dest_port, topic, in_dim,
+        server->model_name, id);
+    g_free (topic);
+  } else {
+    str_pipeline = g_strdup_printf
+        ("tensor_query_serversrc id=%u host=localhost port=%u ! "
+        "other/tensors,num_tensors=1,dimensions=%s,types=uint8,framerate=0/1,format=static ! "
+        "tensor_filter framework=custom-easy model=%s ! "
+        "tensor_query_serversink id=%u async=false",
+        id, opt->srv_port + idx, in_dim, server->model_name, id);
+  }
+  g_free (in_dim);
+
+  _print_log ("%s", str_pipeline);
+  server->pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  if (!server->pipeline)
+    return FALSE;
+
+  return (gst_element_set_state (server->pipeline, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+}
+
+/**
+ * @brief Stop a query server.
+ */
+static void
+_server_stop (QueryServer * server)
+{
+  if (server->pipeline) {
+    gst_element_set_state (server->pipeline, GST_STATE_NULL);
+    gst_object_unref (server->pipeline);
+    server->pipeline = NULL;
+  }
+
+  NNS_custom_easy_unregister (server->model_name);
+  g_free (server->model_name);
+  server->model_name = NULL;
+}
+
+/**
+ * @brief Push a new frame with the send time, called with the lock.
+ */
+static void
+_client_push_frame (QueryClient * client)
+{
+  GstBuffer *buf;
+
+  buf = gst_buffer_new_allocate (NULL, client->frame_size, NULL);
+  client->sent = g_get_monotonic_time ();
+  gst_buffer_fill (buf, 0, &client->sent, sizeof (gint64));
+
+  if (gst_app_src_push_buffer (GST_APP_SRC (client->src), buf) != GST_FLOW_OK)
+    _print_log ("failed to push buffer");
+}
+
+/**
+ * @brief Callback for tensor sink signal.
+ */
+static void
+_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  QueryClient *client = (QueryClient *) user_data;
+  gint64 sent, latency;
+
+  if (gst_buffer_extract (buffer, 0, &sent, sizeof (gint64)) != sizeof (gint64))
+    return;
+
+  latency = g_get_monotonic_time () - sent;
+
+  g_mutex_lock (&client->lock);
+  /* a late reply of a resent frame is ignored, one frame stays in flight */
+  if (client->running && sent == client->sent) {
+    g_array_append_val (client->latency, latency);
+    _client_push_frame (client);
+  }
+  g_mutex_unlock (&client->lock);
+}
+
+/**
+ * @brief Resend the frame without reply in the timeout.
+ */
+static void
+_client_check_timeout (QueryClient * client, guint timeout_ms)
+{
+  g_mutex_lock (&client->lock);
+  if (client->running &&
+      g_get_monotonic_time () - client->sent > (gint64) timeout_ms * 1000) {
+    client->timeouts++;
+    _client_push_frame (client);
+  }
+  g_mutex_unlock (&client->lock);
+}
+
+/**
+ * @brief Start a closed-loop query client.
+ */
+static gboolean
+_client_start (QueryClient * client, BenchOptions * opt, guint idx,
+    guint num_servers)
+{
+  GstElement *element;
+  gchar *str_pipeline, *topic;
+
+  memset (client, 0, sizeof (QueryClient));
+  g_mutex_init (&client->lock);
+  client->latency = g_array_new (FALSE, FALSE, sizeof (gint64));
+  client->frame_size = 3 * opt->width * opt->height;
+
+  if (g_ascii_strcasecmp (opt->connect_type, "HYBRID") == 0) {
+    topic = _get_case_topic (opt);
+    str_pipeline = g_strdup_printf
+        ("appsrc name=src format=time is-live=true "
+        "caps=other/tensors,num_tensors=1,dimensions=3:%u:%u:1,types=uint8,framerate=0/1,format=static ! "
+        "tensor_query_client connect-type=HYBRID host=localhost port=0 "
+        "dest-host=%s dest-port=%u topic=%s ! tensor_sink name=sinkx sync=false",
+        opt->width, opt->height, opt->dest_host, opt->dest_port, topic);
+    g_free (topic);
+  } else {
+    /* assign the server in round-robin order */
+    str_pipeline = g_strdup_printf
+        ("appsrc name=src format=time is-live=true "
+        "caps=other/tensors,num_tensors=1,dimensions=3:%u:%u:1,types=uint8,framerate=0/1,format=static ! "
+        "tensor_query_client host=localhost port=0 dest-host=localhost dest-port=%u ! "
+        "tensor_sink name=sinkx sync=false",
+        opt->width, opt->height, opt->srv_port + (idx % num_servers));
+  }
+
+  client->pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  if (!client->pipeline)
+    return FALSE;
+
+  element = gst_bin_get_by_name (GST_BIN (client->pipeline), "sinkx");
+  g_signal_connect (element, "new-data", (GCallback) _new_data_cb, client);
+  gst_object_unref (element);
+
+  client->src = gst_bin_get_by_name (GST_BIN (client->pipeline), "src");
+
+  if (gst_element_set_state (client->pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE)
+    return FALSE;
+
+  g_mutex_lock (&client->lock);
+  client->running = TRUE;
+  _client_push_frame (client);
+  g_mutex_unlock (&client->lock);
+  return TRUE;
+}
+
+/**
+ * @brief Stop a query client.
+ */
+static void
+_client_stop (QueryClient * client)
+{
+  g_mutex_lock (&client->lock);
+  client->running = FALSE;
+  g_mutex_unlock (&client->lock);
+
+  if (client->pipeline) {
+    gst_element_set_state (client->pipeline, GST_STATE_NULL);
+    gst_object_unref (client->pipeline);
+    client->pipeline = NULL;
+  }
+
+  if (client->src) {
+    gst_object_unref (client->src);
+    client->src = NULL;
+  }
+}
+
+/**
+ * @brief Compare function for latency values.
+ */
+static gint
+_compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 la = *((const gint64 *) a);
+  gint64 lb = *((const gint64 *) b);
+
+  return (la > lb) ? 1 : ((la < lb) ? -1 : 0);
+}
+
+/**
+ * @brief Get p99 latency of the client in msec.
+ */
+static gdouble
+_client_p99_ms (QueryClient * client)
+{
+  guint idx;
+
+  if (client->latency->len == 0)
+    return 0.0;
+
+  g_array_sort (client->latency, _compare_latency);
+  idx = (guint) (0.99 * (client->latency->len - 1) + 0.5);
+  return g_array_index (client->latency, gint64, idx) / 1000.0;
+}
+
+/**
+ * @brief Run N servers and M clients, and print the result.
+ */
+static void
+_run_case (BenchOptions * opt, guint num_servers, guint num_clients)
+{
+  QueryServer *servers = g_new0 (QueryServer, num_servers);
+  QueryClient *clients = g_new0 (QueryClient, num_clients);
+  guint64 total = 0, srv_total = 0, timeouts = 0;
+  gint srv_min = G_MAXINT, srv_max = 0, processed;
+  gdouble elapsed, p99, p99_max = 0.0, p99_sum = 0.0, srv_mean;
+  gint64 start, end;
+  guint i, started = 0;
+
+  for (i = 0; i < num_servers; i++) {
+    if (!_server_start (&servers[i], opt, i))
+      g_critical ("Failed to start server %u.", i);
+  }
+  /* wait for the servers to publish their information */
+  g_usleep (1000 * 1000);
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < num_clients; i++) {
+    if (_client_start (&clients[i], opt, i, num_servers))
+      started++;
+    else
+      g_critical ("Failed to start client %u.", i);
+  }
+
+  /* resend the frames without reply while running */
+  end = start + (gint64) opt->timeout * G_USEC_PER_SEC;
+  while (g_get_monotonic_time () < end) {
+    g_usleep (MIN (50 * 1000, MAX (end - g_get_monotonic_time (), 0)));
+    for (i = 0; i < num_clients; i++)
+      _client_check_timeout (&clients[i], opt->reply_timeout_ms);
+  }
+
+  for (i = 0; i < num_clients; i++)
+    _client_stop (&clients[i]);
+  elapsed = (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+
+  for (i = 0; i < num_clients; i++) {
+    total += clients[i].latency->len;
+    timeouts += clients[i].timeouts;
+    p99 = _client_p99_ms (&clients[i]);
+    p99_sum += p99;
+    p99_max = MAX (p99_max, p99);
+  }
+
+  for (i = 0; i < num_servers; i++) {
+    processed = g_atomic_int_get (&servers[i].processed);
+    srv_min = MIN (srv_min, processed);
+    srv_max = MAX (srv_max, processed);
+    srv_total += processed;
+    _server_stop (&servers[i]);
+  }
+  srv_mean = srv_total / (gdouble) num_servers;
+
+  /* imbalance: max server load over mean server load, 1.0 means perfectly balanced */
+  g_print ("%u,%u,%u,%" G_GUINT64_FORMAT ",%.1f,%.2f,%.2f,%d,%d,%.2f,%"
+      G_GUINT64_FORMAT "\n", num_servers, num_clients, started, total,
+      total / elapsed, p99_sum / MAX (num_clients, 1), p99_max, srv_min, srv_max,
+      (srv_mean > 0.0) ? srv_max / srv_mean : 0.0, timeouts);
+
+  for (i = 0; i < num_clients; i++) {
+    g_array_free (clients[i].latency, TRUE);
+    g_mutex_clear (&clients[i].lock);
+  }
+  g_free (clients);
+  g_free (servers);
+}
+
+/**
+ * @brief Spawn mosquitto as a local broker stand-in.
+ */
+static gboolean
+_spawn_broker (BenchOptions * opt, GPid * pid)
+{
+  gchar *port = g_strdup_printf ("%u", opt->dest_port);
+  gchar *argv[] = { (gchar *) "mosquitto", (gchar *) "-p", port, NULL };
+  GError *err = NULL;
+  gboolean ret;
+
+  ret = g_spawn_async (NULL, argv, NULL,
+      G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD |
+      G_SPAWN_STDOUT_TO_DEV_NULL | G_SPAWN_STDERR_TO_DEV_NULL,
+      NULL, NULL, pid, &err);
+  if (!ret) {
+    g_critical ("Failed to spawn mosquitto: %s", err ? err->message : "");
+    g_clear_error (&err);
+  } else {
+    /* wait for the broker to be ready */
+    g_usleep (500 * 1000);
+  }
+
+  g_free (port);
+  return ret;
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  BenchOptions opt;
+  gchar **servers = NULL, **clients = NULL;
+  GPid broker_pid = 0;
+  guint s, c, num_servers, num_clients;
+  gint ch;
+  struct option long_options[] = {
+      { "connecttype", required_argument, NULL, 'p' },
+      { "desthost", required_argument, NULL, 'm' },
+      { "destport", required_argument, NULL, 'd' },
+      { "topic", required_argument, NULL, 'o' },
+      { "srvport", required_argument, NULL, 'b' },
+      { "nobroker", no_argument, NULL, 'n' },
+      { "servers", required_argument, NULL, 's' },
+      { "clients", required_argument, NULL, 'c' },
+      { "timeout", required_argument, NULL, 't' },
+      { "width", required_argument, NULL, 'w' },
+      { "height", required_argument, NULL, 'a' },
+      { "cost", required_argument, NULL, 'x' },
+      { "reply-timeout", required_argument, NULL, 'R' },
+      { "help", no_argument, NULL, 'h' },
+      { 0, 0, 0, 0}
+  };
+
+  /* init gstreamer */
+  gst_init (&argc, &argv);
+
+  memset (&opt, 0, sizeof (BenchOptions));
+  opt.connect_type = g_strdup ("HYBRID");
+  opt.dest_host = g_strdup ("127.0.0.1");
+  opt.dest_port = 1883;
+  opt.topic = g_strdup ("scalingTopic");
+  opt.srv_port = 5001;
+  opt.spawn_broker = TRUE;
+  opt.servers = g_strdup ("1,2,4");
+  opt.clients = g_strdup ("1,2,4,8,16");
+  opt.timeout = 10;
+  opt.width = 320;
+  opt.height = 240;
+  opt.cost_us = 5000;
+  opt.reply_timeout_ms = 1000;
+
+  while ((ch = getopt_long (argc, argv, "", long_options, NULL)) != -1) {
+    switch (ch) {
+      case 'p':
+        g_free (opt.connect_type);
+        opt.connect_type = g_strdup (optarg);
+        break;
+      case 'm':
+        g_free (opt.dest_host);
+        opt.dest_host = g_strdup (optarg);
+        break;
+      case 'd':
+        opt.dest_port = (guint16) g_ascii_strtoll (optarg, NULL, 10);
+        break;
+      case 'o':
+        g_free (opt.topic);
+        opt.topic = g_strdup (optarg);
+        break;
+      case 'b':
+        opt.srv_port = (guint16) g_ascii_strtoll (optarg, NULL, 10);
+        break;
+      case 'n':
+        opt.spawn_broker = FALSE;
+        break;
+      case 's':
+        g_free (opt.servers);
+        opt.servers = g_strdup (optarg);
+        break;
+      case 'c':
+        g_free (opt.clients);
+        opt.clients = g_strdup (optarg);
+        break;
+      case 't':
+        opt.timeout = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'w':
+        opt.width = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'a':
+        opt.height = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'x':
+        opt.cost_us = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'R':
+        opt.reply_timeout_ms = MAX (1, (guint) g_ascii_strtoull (optarg, NULL, 10));
+        break;
+      default:
+        _usage ();
+        goto done;
+    }
+  }
+
+  if (g_ascii_strcasecmp (opt.connect_type, "HYBRID") == 0 && opt.spawn_broker) {
+    if (!_spawn_broker (&opt, &broker_pid))
+      goto done;
+  }
+
+  servers = g_strsplit (opt.servers, ",", -1);
+  clients = g_strsplit (opt.clients, ",", -1);
+
+  g_print ("servers,clients,started_clients,frames,fps,client_p99_mean_ms,"
+      "client_p99_max_ms,server_min_frames,server_max_frames,imbalance,timeouts\n");
+
+  for (s = 0; servers[s]; s++) {
+    num_servers = (guint) g_ascii_strtoull (servers[s], NULL, 10);
+    if (num_servers == 0)
+      continue;
+
+    for (c = 0; clients[c]; c++) {
+      num_clients = (guint) g_ascii_strtoull (clients[c], NULL, 10);
+      if (num_clients == 0)
+        continue;
+
+      _run_case (&opt, num_servers, num_clients);
+      /* use new ports for the next case to avoid waiting for closed sockets */
+      opt.srv_port += num_servers;
+      opt.case_id++;
+    }
+  }
+
+done:
+  if (broker_pid > 0) {
+    kill (broker_pid, SIGTERM);
+    g_spawn_close_pid (broker_pid);
+  }
+
+  g_strfreev (servers);
+  g_strfreev (clients);
+  g_free (opt.connect_type);
+  g_free (opt.dest_host);
+  g_free (opt.topic);
+  g_free (opt.servers);
+  g_free (opt.clients);
+
+  return 0;
+}
@@ -0,0 +1,604 @@
+/**
+ * @file	nnstreamer_example_capi_latency.c
+ * @date	19 October 2026
+ * @brief	Latency of single-shot vs. pipeline invocation of the same model
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	HyoungJoo Ahn <hello.ahn@samsung.com>
+ * @bug		No known bugs.
+ *
+ * Invokes the same model, one input at a time (closed loop), with:
+ * single : ml_single_invoke (), as Tizen.native/SingleSample does.
+ * pipeline : ml_pipeline with appsrc and tensor_sink, ml_pipeline_src_input_data () and the sink callback.
+ * gst : gst_parse_launch () with appsrc and tensor_sink, gst_app_src_push_buffer () and the new-data signal.
+ *
+ * Each mode has a reuse variant (single-reuse, pipeline-reuse, gst-reuse).
+ * The default mode creates the input data (ml_tensors_data_create or gst_buffer_new_allocate) for each call,
+ * the reuse variant creates the input once and fills it for each call.
+ * ml_single_invoke () always allocates the output, it is destroyed after each call in both variants.
+ * alloc_us_avg is the time spent to create and destroy the data in the application for each call.
+ *
+ * $ ./nnstreamer_example_capi_latency --count=1000
+ * $ ./nnstreamer_example_capi_latency --model=./mobilenet_v1_1.0_224.tflite --modes=single,single-reuse
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include <glib.h>
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+#include <nnstreamer.h>
+
+/**
+ * @brief Options of the benchmark.
+ */
+typedef struct
+{
+  gchar *model; /**< model file */
+  gchar *framework; /**< tensor_filter framework */
+  guint count; /**< measured calls */
+  guint warmup; /**< calls before measuring */
+} BenchOption;
+
+/**
+ * @brief Result of a mode.
+ */
+typedef struct
+{
+  GArray *latency; /**< latency of each call (us) */
+  gint64 alloc_us; /**< total time to create and destroy the data */
+  gint64 elapsed; /**< total time of the measured calls */
+} BenchResult;
+
+/**
+ * @brief Wait for the result from the sink callback.
+ */
+typedef struct
+{
+  GMutex lock; /**< lock for received */
+  GCond cond; /**< signaled when a result arrives */
+  guint received; /**< number of results */
+} BenchWaiter;
+
+/**
+ * @brief Tensor type names, same order as ml_tensor_type_e.
+ */
+static const gchar *tensor_types[] = {
+  "int32", "uint32", "int16", "uint16", "int8", "uint8",
+  "float64", "float32", "int64", "uint64", "float16"
+};
+
+/**
+ * @brief Compare function to sort latency.
+ */
+static gint
+_compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 la = *((const gint64 *) a);
+  gint64 lb = *((const gint64 *) b);
+
+  return (la > lb) ? 1 : ((la < lb) ? -1 : 0);
+}
+
+/**
+ * @brief Get the percentile from the sorted latency array.
+ */
+static gint64
+_percentile (GArray * sorted, gdouble p)
+{
+  guint idx;
+
+  if (sorted->len == 0)
+    return 0;
+
+  idx = (guint) (p / 100.0 * (sorted->len - 1) + 0.5);
+  return g_array_index (sorted, gint64, MIN (idx, sorted->len - 1));
+}
+
+/**
+ * @brief Get the nnfw type of single-shot from the tensor_filter framework name.
+ */
+static ml_nnfw_type_e
+_get_nnfw_type (const gchar * framework)
+{
+  if (g_str_has_prefix (framework, "tensorflow") && g_str_has_suffix (framework, "lite"))
+    return ML_NNFW_TYPE_TENSORFLOW_LITE;
+  if (g_strcmp0 (framework, "nnfw") == 0)
+    return ML_NNFW_TYPE_NNFW;
+
+  /* find the framework with the file extension */
+  return ML_NNFW_TYPE_ANY;
+}
+
+/**
+ * @brief Get the caps string of the first input tensor.
+ */
+static gchar *
+_get_caps_string (ml_tensors_info_h info)
+{
+  ml_tensor_type_e type;
+  ml_tensor_dimension dim;
+
+  ml_tensors_info_get_tensor_type (info, 0, &type);
+  ml_tensors_info_get_tensor_dimension (info, 0, dim);
+
+  if ((guint) type >= G_N_ELEMENTS (tensor_types))
+    return NULL;
+
+  return g_strdup_printf ("other/tensor,type=%s,dimension=%u:%u:%u:%u,framerate=0/1",
+      tensor_types[type], MAX (dim[0], 1U), MAX (dim[1], 1U), MAX (dim[2], 1U), MAX (dim[3], 1U));
+}
+
+/**
+ * @brief Signal the waiter, called from the sink callback.
+ */
+static void
+_waiter_signal (BenchWaiter * waiter)
+{
+  g_mutex_lock (&waiter->lock);
+  waiter->received++;
+  g_cond_signal (&waiter->cond);
+  g_mutex_unlock (&waiter->lock);
+}
+
+/**
+ * @brief Wait until the number of results reaches the count.
+ */
+static gboolean
+_waiter_wait (BenchWaiter * waiter, guint count)
+{
+  gint64 end_time = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  gboolean ret = TRUE;
+
+  g_mutex_lock (&waiter->lock);
+  while (waiter->received < count && ret)
+    ret = g_cond_wait_until (&waiter->cond, &waiter->lock, end_time);
+  g_mutex_unlock (&waiter->lock);
+
+  return ret;
+}
+
+/**
+ * @brief Add the latency of a call.
+ */
+static void
+_add_result (BenchResult * result, guint i, const BenchOption * opt,
+    gint64 start, gint64 end, gint64 alloc_us)
+{
+  gint64 latency = end - start;
+
+  if (i < opt->warmup)
+    return;
+
+  g_array_append_val (result->latency, latency);
+  result->alloc_us += alloc_us;
+  result->elapsed += latency;
+}
+
+/**
+ * @brief Invoke the model with ml_single_invoke ().
+ */
+static gboolean
+_run_single (const BenchOption * opt, gboolean reuse, BenchResult * result)
+{
+  ml_single_h single;
+  ml_tensors_info_h in_info = NULL;
+  ml_tensors_data_h input = NULL, output;
+  void *data;
+  size_t size;
+  gint64 start, t, alloc_us;
+  guint i;
+  gboolean ret = FALSE;
+
+  if (ml_single_open (&single, opt->model, NULL, NULL,
+          _get_nnfw_type (opt->framework), ML_NNFW_HW_ANY) != ML_ERROR_NONE) {
+    g_critical ("Failed to open the model %s.", opt->model);
+    return FALSE;
+  }
+
+  if (ml_single_get_input_info (single, &in_info) != ML_ERROR_NONE)
+    goto done;
+
+  if (reuse && ml_tensors_data_create (in_info, &input) != ML_ERROR_NONE)
+    goto done;
+
+  for (i = 0; i < opt->warmup + opt->count; i++) {
+    start = g_get_monotonic_time ();
+    alloc_us = 0;
+
+    if (!reuse) {
+      if (ml_tensors_data_create (in_info, &input) != ML_ERROR_NONE)
+        goto done;
+      alloc_us += g_get_monotonic_time () - start;
+    }
+
+    ml_tensors_data_get_tensor_data (input, 0, &data, &size);
+    memset (data, i & 0xff, size);
+
+    if (ml_single_invoke (single, input, &output) != ML_ERROR_NONE) {
+      g_critical ("Failed to invoke the model.");
+      goto done;
+    }
+
+    t = g_get_monotonic_time ();
+    ml_tensors_data_destroy (output);
+    if (!reuse) {
+      ml_tensors_data_destroy (input);
+      input = NULL;
+    }
+    alloc_us += g_get_monotonic_time () - t;
+
+    _add_result (result, i, opt, start, g_get_monotonic_time (), alloc_us);
+  }
+
+  ret = TRUE;
+
+done:
+  if (input)
+    ml_tensors_data_destroy (input);
+  if (in_info)
+    ml_tensors_info_destroy (in_info);
+  ml_single_close (single);
+  return ret;
+}
+
+/**
+ * @brief Callback for ml_pipeline sink.
+ */
+static void
+_pipeline_sink_cb (const ml_tensors_data_h data, const ml_tensors_info_h info,
+    void *user_data)
+{
+  _waiter_signal ((BenchWaiter *) user_data);
+}
+
+/**
+ * @brief Invoke the model with ml_pipeline, appsrc and tensor_sink.
+ */
+static gboolean
+_run_pipeline (const BenchOption * opt, ml_tensors_info_h in_info,
+    const gchar * caps, gboolean reuse, BenchResult * result)
+{
+  ml_pipeline_h pipe;
+  ml_pipeline_src_h src = NULL;
+  ml_pipeline_sink_h sink = NULL;
+  ml_tensors_data_h input = NULL;
+  BenchWaiter waiter;
+  gchar *str_pipeline;
+  void *data;
+  size_t size;
+  gint64 start, alloc_us;
+  guint i;
+  gboolean ret = FALSE;
+  gint status;
+
+  memset (&waiter, 0, sizeof (BenchWaiter));
+  g_mutex_init (&waiter.lock);
+  g_cond_init (&waiter.cond);
+
+  str_pipeline = g_strdup_printf ("appsrc name=srcx ! %s ! "
+      "tensor_filter framework=%s model=%s ! tensor_sink name=sinkx sync=false",
+      caps, opt->framework, opt->model);
+  status = ml_pipeline_construct (str_pipeline, NULL, NULL, &pipe);
+  g_free (str_pipeline);
+
+  if (status != ML_ERROR_NONE) {
+    g_critical ("Failed to construct the pipeline.");
+    goto error;
+  }
+
+  if (ml_pipeline_src_get_handle (pipe, "srcx", &src) != ML_ERROR_NONE ||
+      ml_pipeline_sink_register (pipe, "sinkx", _pipeline_sink_cb, &waiter,
+          &sink) != ML_ERROR_NONE)
+    goto done;
+
+  if (reuse && ml_tensors_data_create (in_info, &input) != ML_ERROR_NONE)
+    goto done;
+
+  ml_pipeline_start (pipe);
+
+  for (i = 0; i < opt->warmup + opt->count; i++) {
+    start = g_get_monotonic_time ();
+    alloc_us = 0;
+
+    if (!reuse) {
+      /* freed by the pipeline (ML_PIPELINE_BUF_POLICY_AUTO_FREE) */
+      if (ml_tensors_data_create (in_info, &input) != ML_ERROR_NONE)
+        goto done;
+      alloc_us = g_get_monotonic_time () - start;
+    }
+
+    ml_tensors_data_get_tensor_data (input, 0, &data, &size);
+    memset (data, i & 0xff, size);
+
+    status = ml_pipeline_src_input_data (src, input, reuse ?
+        ML_PIPELINE_BUF_POLICY_DO_NOT_FREE : ML_PIPELINE_BUF_POLICY_AUTO_FREE);
+    if (!reuse)
+      input = NULL;
+
+    if (status != ML_ERROR_NONE || !_waiter_wait (&waiter, i + 1)) {
+      g_critical ("Failed to get the result from the pipeline.");
+      goto done;
+    }
+
+    _add_result (result, i, opt, start, g_get_monotonic_time (), alloc_us);
+  }
+
+  ret = TRUE;
+
+done:
+  ml_pipeline_stop (pipe);
+  if (sink)
+    ml_pipeline_sink_unregister (sink);
+  if (src)
+    ml_pipeline_src_release_handle (src);
+  ml_pipeline_destroy (pipe);
+
+  /* the pipeline is destroyed, now it is safe to free the reused data */
+  if (input)
+    ml_tensors_data_destroy (input);
+
+error:
+  g_mutex_clear (&waiter.lock);
+  g_cond_clear (&waiter.cond);
+  return ret;
+}
+
+/**
+ * @brief Callback for tensor sink signal.
+ */
+static void
+_gst_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  _waiter_signal ((BenchWaiter *) user_data);
+}
+
+/**
+ * @brief Invoke the model with the pipeline from gst_parse_launch (), appsrc and tensor_sink.
+ */
+static gboolean
+_run_gst (const BenchOption * opt, const gchar * caps, gsize size,
+    gboolean reuse, BenchResult * result)
+{
+  GstElement *pipeline, *src, *sink;
+  GstBuffer *buffer, *reused = NULL;
+  GstMapInfo map;
+  BenchWaiter waiter;
+  gchar *str_pipeline;
+  guint8 *data = NULL;
+  gint64 start, alloc_us;
+  guint i;
+  gboolean ret = FALSE;
+
+  str_pipeline = g_strdup_printf ("appsrc name=srcx ! %s ! "
+      "tensor_filter framework=%s model=%s ! tensor_sink name=sinkx sync=false",
+      caps, opt->framework, opt->model);
+  pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+
+  if (pipeline == NULL) {
+    g_critical ("Failed to launch the pipeline.");
+    return FALSE;
+  }
+
+  memset (&waiter, 0, sizeof (BenchWaiter));
+  g_mutex_init (&waiter.lock);
+  g_cond_init (&waiter.cond);
+
+  src = gst_bin_get_by_name (GST_BIN (pipeline), "srcx");
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sinkx");
+  g_signal_connect (sink, "new-data", G_CALLBACK (_gst_new_data_cb), &waiter);
+
+  if (reuse) {
+    /* the application owns the memory, the buffer is pushed with a new reference */
+    data = (guint8 *) g_malloc0 (size);
+    reused = gst_buffer_new_wrapped_full ((GstMemoryFlags) 0, data, size, 0, size, NULL, NULL);
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  for (i = 0; i < opt->warmup + opt->count; i++) {
+    start = g_get_monotonic_time ();
+    alloc_us = 0;
+
+    if (reuse) {
+      /* the previous result is received, the filter does not use the memory */
+      memset (data, i & 0xff, size);
+      buffer = gst_buffer_ref (reused);
+    } else {
+      buffer = gst_buffer_new_allocate (NULL, size, NULL);
+      alloc_us = g_get_monotonic_time () - start;
+
+      gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+      memset (map.data, i & 0xff, map.size);
+      gst_buffer_unmap (buffer, &map);
+    }
+
+    if (gst_app_src_push_buffer (GST_APP_SRC (src), buffer) != GST_FLOW_OK ||
+        !_waiter_wait (&waiter, i + 1)) {
+      g_critical ("Failed to get the result from the pipeline.");
+      goto done;
+    }
+
+    _add_result (result, i, opt, start, g_get_monotonic_time (), alloc_us);
+  }
+
+  ret = TRUE;
+
+done:
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  if (reused)
+    gst_buffer_unref (reused);
+  g_free (data);
+  gst_object_unref (src);
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+  g_mutex_clear (&waiter.lock);
+  g_cond_clear (&waiter.cond);
+  return ret;
+}
+
+/**
+ * @brief Print the result of a mode.
+ */
+static void
+_print_result (const gchar * mode, BenchResult * result)
+{
+  guint n = result->latency->len;
+
+  g_array_sort (result->latency, _compare_latency);
+
+  g_print ("%s,%u,%.1f,%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT
+      ",%" G_GINT64_FORMAT ",%.1f,%.2f\n", mode, n,
+      n ? result->elapsed / (gdouble) n : 0.0,
+      _percentile (result->latency, 50.0), _percentile (result->latency, 90.0),
+      _percentile (result->latency, 99.0), _percentile (result->latency, 100.0),
+      result->elapsed > 0 ? n * (gdouble) G_USEC_PER_SEC / result->elapsed : 0.0,
+      n ? result->alloc_us / (gdouble) n : 0.0);
+}
+
+/**
+ * @brief Get the input info of the model.
+ */
+static gboolean
+_get_input_info (const BenchOption * opt, ml_tensors_info_h * info,
+    gchar ** caps, gsize * size)
+{
+  ml_single_h single;
+  size_t data_size = 0;
+
+  if (ml_single_open (&single, opt->model, NULL, NULL,
+          _get_nnfw_type (opt->framework), ML_NNFW_HW_ANY) != ML_ERROR_NONE) {
+    g_critical ("Failed to open the model %s.", opt->model);
+    return FALSE;
+  }
+
+  if (ml_single_get_input_info (single, info) != ML_ERROR_NONE) {
+    ml_single_close (single);
+    return FALSE;
+  }
+  ml_single_close (single);
+
+  ml_tensors_info_get_tensor_size (*info, 0, &data_size);
+  *size = data_size;
+  *caps = _get_caps_string (*info);
+
+  if (*caps == NULL) {
+    g_critical ("Unsupported input tensor type.");
+    ml_tensors_info_destroy (*info);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Print usage info.
+ */
+static void
+_usage (void)
+{
+  g_print ("usage: nnstreamer_example_capi_latency [options]\n"
+      "    --model      Model file. (default ./tflite_model_img/mobilenet_v1_1.0_224_quant.tflite)\n"
+      "    --framework  tensor_filter framework. (default tensorflow-lite)\n"
+      "    --count      Number of measured calls for each mode. (default 1000)\n"
+      "    --warmup     Number of calls before measuring. (default 50)\n"
+      "    --modes      Comma-separated single, single-reuse, pipeline, pipeline-reuse, gst and gst-reuse. (default all)\n");
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  BenchOption opt;
+  BenchResult result;
+  ml_tensors_info_h in_info;
+  gchar *modes_str = g_strdup ("single,single-reuse,pipeline,pipeline-reuse,gst,gst-reuse");
+  gchar **modes;
+  gchar *caps = NULL;
+  gsize size = 0;
+  guint i;
+  gint o;
+  gboolean ret;
+  struct option long_options[] = {
+    {"model", required_argument, NULL, 'm'},
+    {"framework", required_argument, NULL, 'f'},
+    {"count", required_argument, NULL, 'c'},
+    {"warmup", required_argument, NULL, 'w'},
+    {"modes", required_argument, NULL, 'o'},
+    {"help", no_argument, NULL, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  opt.model = g_strdup ("./tflite_model_img/mobilenet_v1_1.0_224_quant.tflite");
+  opt.framework = g_strdup ("tensorflow-lite");
+  opt.count = 1000;
+  opt.warmup = 50;
+
+  while ((o = getopt_long (argc, argv, "m:f:c:w:o:h", long_options, NULL)) != -1) {
+    switch (o) {
+      case 'm':
+        g_free (opt.model);
+        opt.model = g_strdup (optarg);
+        break;
+      case 'f':
+        g_free (opt.framework);
+        opt.framework = g_strdup (optarg);
+        break;
+      case 'c':
+        opt.count = MAX ((guint) g_ascii_strtoull (optarg, NULL, 10), 1U);
+        break;
+      case 'w':
+        opt.warmup = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'o':
+        g_free (modes_str);
+        modes_str = g_strdup (optarg);
+        break;
+      default:
+        _usage ();
+        goto done;
+    }
+  }
+
+  gst_init (&argc, &argv);
+
+  if (!_get_input_info (&opt, &in_info, &caps, &size))
+    goto done;
+
+  g_print ("mode,calls,mean_us,p50_us,p90_us,p99_us,max_us,calls_per_sec,alloc_us_avg\n");
+
+  modes = g_strsplit (modes_str, ",", -1);
+  for (i = 0; modes[i]; i++) {
+    memset (&result, 0, sizeof (BenchResult));
+    result.latency = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+    if (g_str_has_prefix (modes[i], "single"))
+      ret = _run_single (&opt, g_str_has_suffix (modes[i], "-reuse"), &result);
+    else if (g_str_has_prefix (modes[i], "pipeline"))
+      ret = _run_pipeline (&opt, in_info, caps, g_str_has_suffix (modes[i], "-reuse"), &result);
+    else if (g_str_has_prefix (modes[i], "gst"))
+      ret = _run_gst (&opt, caps, size, g_str_has_suffix (modes[i], "-reuse"), &result);
+    else
+      ret = FALSE;
+
+    if (ret)
+      _print_result (modes[i], &result);
+    else
+      g_critical ("Failed to run the mode %s.", modes[i]);
+
+    g_array_free (result.latency, TRUE);
+  }
+
+  g_strfreev (modes);
+  ml_tensors_info_destroy (in_info);
+
+done:
+  g_free (caps);
+  g_free (modes_str);
+  g_free (opt.model);
+  g_free (opt.framework);
+  return 0;
+}
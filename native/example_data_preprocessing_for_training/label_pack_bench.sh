@@ -0,0 +1,58 @@
+#!/usr/bin/env bash
+##
+## @file label_pack_bench.sh
+## @brief Compare the serial and the parallel packing of the YOLO annotations.
+##
+## A dataset of random annotations (1 to max-objects boxes per image) is generated, the image
+## files are empty since they are not read. It prints the CSV rows of each mode and checks that
+## the label files are the same.
+##   serial   : getline and g_strsplit for each file, one by one
+##   parallel : the files are parsed by the worker threads, 1 and [threads]
+##
+## usage: ./label_pack_bench.sh [images] [threads] [max_objects]
+##
+
+IMAGES=${1:-12000}
+THREADS=${2:-$(nproc)}
+MAX_OBJECTS=${3:-10}
+BIN=${BIN:-./nnstreamer_example_yolo_label_pack}
+WORK=$(mktemp -d /tmp/label_pack_bench.XXXXXX)
+
+trap 'rm -rf ${WORK}' EXIT
+
+mkdir -p ${WORK}/dataset/images ${WORK}/dataset/annotations
+awk -v n=${IMAGES} -v m=${MAX_OBJECTS} -v dir=${WORK}/dataset 'BEGIN {
+  srand (1);
+  for (i = 0; i < n; i++) {
+    name = sprintf ("%012d", i * 7 + 5000);
+    printf "" > (dir "/images/" name ".png");
+    close (dir "/images/" name ".png");
+    f = dir "/annotations/" name ".txt";
+    boxes = 1 + int (rand () * m);
+    for (b = 0; b < boxes; b++) {
+      x = int (rand () * 400); y = int (rand () * 400);
+      printf "%d %d %d %d %d\n", int (rand () * 80), x, y, 1 + int (rand () * (416 - x)),
+          1 + int (rand () * (416 - y)) > f;
+    }
+    close (f);
+  }
+}'
+
+# $1: name, $2: options
+run () {
+  ${BIN} ${WORK}/dataset --output=${WORK}/$1.label --max-objects=${MAX_OBJECTS} $2 \
+      > ${WORK}/$1.log
+  if [ -z "${HEADER}" ]; then
+    head -1 ${WORK}/$1.log
+    HEADER=1
+  fi
+  tail -1 ${WORK}/$1.log
+}
+
+HEADER=
+run serial "--serial"
+run single "--threads=1"
+run parallel "--threads=${THREADS}"
+
+cmp -s ${WORK}/serial.label ${WORK}/parallel.label || echo "The label files are different!"
+cmp -s ${WORK}/serial.label ${WORK}/single.label || echo "The label files are different!"
@@ -0,0 +1,611 @@
+/**
+ * @file	nnstreamer_example_yolo_label_pack.c
+ * @date	19 October 2026
+ * @brief	Pack the YOLO annotations into a label file of datareposrc
+ * @author	Hyunil Park <hyunil46.park@samsung.com>
+ * @bug		No known bugs.
+ *
+ * The annotation files (class x y width height, in pixels) of the images are parsed by
+ * worker threads into one binary file of fixed-size labels (MAX_OBJECT x 5 float32, padded
+ * with 0), in the sorted order of the images. It also writes the JSON of datareposrc for the
+ * label file and the list of the images, so the labels are read by datareposrc and paired
+ * with the images by tensor_mux without filesrc blocksize and tensor_converter.
+ *
+ * Run example :
+ * $ ./nnstreamer_example_yolo_label_pack coco_sample --output=yolo.label --rename=image
+ *
+ * <dataset dir>/images/000000005477.png <-> <dataset dir>/annotations/000000005477.txt
+ * yolo.label, yolo.label.json and yolo.label.list are written.
+ */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) if (DBG) g_message (__VA_ARGS__)
+
+#define ITEMS 5                 /* x, y, width, height and class */
+#define CHUNK 64                /* the number of files a worker takes at once */
+#define MAX_ERROR_LOG 10        /* the number of invalid files to print */
+
+/**
+ * @brief Counters of the annotations.
+ */
+typedef struct
+{
+  guint files;
+  guint boxes;
+  guint empty; /**< no object in the image */
+  guint missing; /**< no annotation file */
+  guint overflow; /**< more than max-objects */
+  guint malformed; /**< a line is not 5 numbers, dropped */
+  guint out_of_range; /**< a box is out of the image */
+} PackCounters;
+
+/**
+ * @brief Data structure for the packing.
+ */
+typedef struct
+{
+  gchar *annotation_dir;
+  gchar **images; /**< sorted filenames of the images */
+  guint num_images;
+  guint max_objects;
+  gdouble image_size;
+  gfloat *labels; /**< num_images x max_objects x ITEMS */
+
+  volatile gint next; /**< index of the next file to parse */
+  volatile gint error_logs;
+} PackJob;
+
+/**
+ * @brief Data structure for a worker.
+ */
+typedef struct
+{
+  PackJob *job;
+  GThread *thread;
+  gchar *buf; /**< contents of the annotation file */
+  gsize buf_size;
+  PackCounters counters;
+} PackWorker;
+
+static const gchar *output = "yolo.label";
+static const gchar *rename_prefix = NULL;
+static gint max_objects = 10;
+static gint image_size = 416;
+static gint threads = 0;
+static gboolean serial = FALSE;
+static gboolean truncate_objects = FALSE;
+static gboolean allow_missing = FALSE;
+
+static GOptionEntry entries[] = {
+  {"output", 0, 0, G_OPTION_ARG_STRING, &output,
+      "label file, <output>.json and <output>.list are written as well"},
+  {"max-objects", 0, 0, G_OPTION_ARG_INT, &max_objects,
+      "the maximum number of objects in an image (dimension of a label is 1:(max-objects x 5))"},
+  {"image-size", 0, 0, G_OPTION_ARG_INT, &image_size,
+      "width and height of the images, to normalize the boxes"},
+  {"threads", 0, 0, G_OPTION_ARG_INT, &threads,
+      "the number of worker threads (default: the number of processors)"},
+  {"rename", 0, 0, G_OPTION_ARG_STRING, &rename_prefix,
+      "rename the images to <rename>_%0Nd.<ext> in the order of the labels, for multifilesrc"},
+  {"truncate", 0, 0, G_OPTION_ARG_NONE, &truncate_objects,
+      "drop the objects beyond max-objects, instead of failing"},
+  {"allow-missing", 0, 0, G_OPTION_ARG_NONE, &allow_missing,
+      "an image without annotation file has no object, instead of failing"},
+  {"serial", 0, 0, G_OPTION_ARG_NONE, &serial,
+      "parse the files one by one with getline and g_strsplit, to compare with"},
+  {NULL}
+};
+
+/**
+ * @brief Compare the filenames for g_qsort_with_data.
+ */
+static gint
+_compare_names (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  return strcmp (*(const gchar **) a, *(const gchar **) b);
+}
+
+/**
+ * @brief Get the sorted filenames of the images.
+ * g_dir_read_name() does not return the files in a specific order.
+ */
+static gchar **
+_list_images (const gchar * dir_path, guint * num)
+{
+  GPtrArray *names;
+  GDir *dir;
+  const gchar *name;
+
+  dir = g_dir_open (dir_path, 0, NULL);
+  if (!dir)
+    return NULL;
+
+  names = g_ptr_array_new ();
+  while ((name = g_dir_read_name (dir)) != NULL) {
+    if (name[0] != '.')
+      g_ptr_array_add (names, g_strdup (name));
+  }
+  g_dir_close (dir);
+
+  g_qsort_with_data (names->pdata, names->len, sizeof (gpointer), _compare_names, NULL);
+  *num = names->len;
+  g_ptr_array_add (names, NULL);
+
+  return (gchar **) g_ptr_array_free (names, FALSE);
+}
+
+/**
+ * @brief Print the invalid file, up to MAX_ERROR_LOG files.
+ */
+static void
+_log_invalid (PackJob * job, guint index, const gchar * reason)
+{
+  if (g_atomic_int_add (&job->error_logs, 1) < MAX_ERROR_LOG)
+    g_printerr ("%s: %s\n", job->images[index], reason);
+}
+
+/**
+ * @brief Store a box in the label.
+ */
+static void
+_add_box (PackJob * job, gfloat * label, guint obj, const gdouble * value,
+    PackCounters * counters)
+{
+  gdouble size = job->image_size;
+
+  if (value[1] < 0 || value[2] < 0 || value[3] <= 0 || value[4] <= 0 ||
+      value[1] + value[3] > size + 1 || value[2] + value[4] > size + 1)
+    counters->out_of_range++;
+
+  label[obj * ITEMS + 0] = (gfloat) (value[1] / size);
+  label[obj * ITEMS + 1] = (gfloat) (value[2] / size);
+  label[obj * ITEMS + 2] = (gfloat) (value[3] / size);
+  label[obj * ITEMS + 3] = (gfloat) (value[4] / size);
+  label[obj * ITEMS + 4] = (gfloat) value[0];
+}
+
+/**
+ * @brief Make the path of the annotation file of the image.
+ */
+static gboolean
+_annotation_path (PackJob * job, guint index, gchar * path, gsize size)
+{
+  const gchar *image = job->images[index];
+  const gchar *ext = strrchr (image, '.');
+  gint len = ext ? (gint) (ext - image) : (gint) strlen (image);
+
+  return (g_snprintf (path, size, "%s/%.*s.txt", job->annotation_dir, len, image) <
+      (gint) size);
+}
+
+/**
+ * @brief Read the annotation file into the buffer of the worker.
+ */
+static gboolean
+_read_file (PackWorker * worker, const gchar * path, gsize * len)
+{
+  gssize n = 0;
+  gint fd;
+
+  fd = open (path, O_RDONLY);
+  if (fd < 0)
+    return FALSE;
+
+  *len = 0;
+  while (TRUE) {
+    if (*len + 1 >= worker->buf_size) {
+      worker->buf_size = MAX (worker->buf_size * 2, 4096);
+      worker->buf = g_realloc (worker->buf, worker->buf_size);
+    }
+
+    n = read (fd, worker->buf + *len, worker->buf_size - *len - 1);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      break;
+    *len += n;
+  }
+  close (fd);
+
+  worker->buf[*len] = '\0';
+  return (n == 0);
+}
+
+/**
+ * @brief Parse an annotation file into the label of the image.
+ */
+static gboolean
+_parse_file (PackWorker * worker, guint index)
+{
+  PackJob *job = worker->job;
+  PackCounters *counters = &worker->counters;
+  gfloat *label = job->labels + (gsize) index * job->max_objects * ITEMS;
+  gchar path[4096];
+  gdouble value[ITEMS];
+  gchar *p, *end;
+  guint n, obj = 0;
+  gsize len;
+
+  counters->files++;
+
+  if (!_annotation_path (job, index, path, sizeof (path)) ||
+      !_read_file (worker, path, &len)) {
+    counters->missing++;
+    counters->empty++;
+    if (!allow_missing) {
+      _log_invalid (job, index, "no annotation file");
+      return FALSE;
+    }
+    return TRUE;
+  }
+
+  p = worker->buf;
+  while (*p) {
+    /* a line: class x y width height, strtod skips the newline as well */
+    while (*p == ' ' || *p == '\t')
+      p++;
+    for (n = 0; n < ITEMS && *p != '\n' && *p != '\r' && *p != '\0'; n++) {
+      value[n] = g_ascii_strtod (p, &end);
+      if (end == p)
+        break;
+      p = end;
+      while (*p == ' ' || *p == '\t')
+        p++;
+    }
+
+    if (n == 0 && (*p == '\n' || *p == '\r' || *p == '\0')) {
+      /* empty line */
+    } else if (n < ITEMS || (*p != '\n' && *p != '\r' && *p != '\0')) {
+      /* the box is dropped, the other boxes are still valid */
+      counters->malformed++;
+      _log_invalid (job, index, "a line is not 'class x y width height', dropped");
+    } else if (obj >= job->max_objects) {
+      counters->overflow++;
+      if (!truncate_objects) {
+        _log_invalid (job, index, "too many objects, see --max-objects");
+        return FALSE;
+      }
+    } else {
+      _add_box (job, label, obj++, value, counters);
+    }
+
+    while (*p && *p != '\n')
+      p++;
+    while (*p == '\n' || *p == '\r')
+      p++;
+  }
+
+  counters->boxes += obj;
+  if (obj == 0)
+    counters->empty++;
+
+  return TRUE;
+}
+
+/**
+ * @brief Parse an annotation file, the same way as nnstreamer_example_data_preprocessing.
+ */
+static gboolean
+_parse_file_serial (PackWorker * worker, guint index)
+{
+  PackJob *job = worker->job;
+  PackCounters *counters = &worker->counters;
+  gfloat *label = job->labels + (gsize) index * job->max_objects * ITEMS;
+  gdouble value[ITEMS];
+  gchar *name, *path, *line = NULL, **strv;
+  size_t len = 0;
+  guint n, obj = 0;
+  gboolean ret = TRUE;
+  FILE *fp;
+
+  counters->files++;
+
+  name = g_strdup (job->images[index]);
+  if (strrchr (name, '.'))
+    *strrchr (name, '.') = '\0';
+  path = g_strdup_printf ("%s/%s.txt", job->annotation_dir, name);
+  fp = fopen (path, "r");
+  g_free (path);
+  g_free (name);
+
+  if (!fp) {
+    counters->missing++;
+    counters->empty++;
+    if (!allow_missing) {
+      _log_invalid (job, index, "no annotation file");
+      return FALSE;
+    }
+    return TRUE;
+  }
+
+  while (ret && getline (&line, &len, fp) != -1) {
+    g_strstrip (line);
+    if (line[0] == '\0')
+      continue;
+
+    strv = g_strsplit_set (line, " \t", -1);
+    for (n = 0; strv[n] != NULL && n < ITEMS; n++)
+      value[n] = atof (strv[n]);
+
+    if (n < ITEMS || strv[n] != NULL) {
+      counters->malformed++;
+      _log_invalid (job, index, "a line is not 'class x y width height', dropped");
+    } else if (obj >= job->max_objects) {
+      counters->overflow++;
+      if (!truncate_objects) {
+        _log_invalid (job, index, "too many objects, see --max-objects");
+        ret = FALSE;
+      }
+    } else {
+      _add_box (job, label, obj++, value, counters);
+    }
+    g_strfreev (strv);
+  }
+  free (line);
+  fclose (fp);
+
+  counters->boxes += obj;
+  if (obj == 0)
+    counters->empty++;
+
+  return ret;
+}
+
+/**
+ * @brief Worker thread, parse the files in chunks.
+ */
+static gpointer
+_worker_thread (gpointer user_data)
+{
+  PackWorker *worker = (PackWorker *) user_data;
+  PackJob *job = worker->job;
+  gboolean ret = TRUE;
+  guint i, start, end;
+
+  while ((start = (guint) g_atomic_int_add (&job->next, CHUNK)) < job->num_images) {
+    end = MIN (start + CHUNK, job->num_images);
+    for (i = start; i < end; i++)
+      ret &= _parse_file (worker, i);
+  }
+
+  return GINT_TO_POINTER (ret);
+}
+
+/**
+ * @brief Write the contents to a temporary file and rename it.
+ */
+static gboolean
+_write_file (const gchar * path, const void *data, gsize size)
+{
+  gchar *tmp = g_strdup_printf ("%s.tmp", path);
+  gboolean ret = FALSE;
+  FILE *fp;
+
+  fp = g_fopen (tmp, "wb");
+  if (fp) {
+    ret = (fwrite (data, 1, size, fp) == size);
+    ret &= (fclose (fp) == 0);
+    if (ret)
+      ret = (g_rename (tmp, path) == 0);
+    if (!ret)
+      g_remove (tmp);
+  }
+
+  g_free (tmp);
+  return ret;
+}
+
+/**
+ * @brief Write the label file, the JSON of datareposrc and the list of the images.
+ */
+static gboolean
+_write_output (PackJob * job, const gchar * images_dir, const gchar * name_format)
+{
+  gsize label_size = (gsize) job->max_objects * ITEMS * sizeof (gfloat);
+  GString *str;
+  gchar *path, *image;
+  gboolean ret;
+  guint i;
+
+  if (!_write_file (output, job->labels, label_size * job->num_images))
+    return FALSE;
+
+  path = g_strdup_printf ("%s.json", output);
+  str = g_string_new (NULL);
+  g_string_append_printf (str, "{\n"
+      "  \"gst_caps\":\"other/tensors, format=(string)static, framerate=(fraction)0/1, "
+      "num_tensors=(int)1, dimensions=(string)1:%u:1:1, types=(string)float32\",\n"
+      "  \"total_samples\":%u,\n"
+      "  \"sample_size\":%" G_GSIZE_FORMAT "\n}\n",
+      job->max_objects * ITEMS, job->num_images, label_size);
+  ret = _write_file (path, str->str, str->len);
+  g_string_free (str, TRUE);
+  g_free (path);
+
+  /* image of each label, renamed or not */
+  path = g_strdup_printf ("%s.list", output);
+  str = g_string_new (NULL);
+  for (i = 0; i < job->num_images; i++) {
+    if (name_format) {
+      const gchar *ext = strrchr (job->images[i], '.');
+      gchar *name = g_strdup_printf (name_format, i);
+
+      image = g_strdup_printf ("%s/%s%s", images_dir, name, ext ? ext : "");
+      g_free (name);
+    } else {
+      image = g_build_filename (images_dir, job->images[i], NULL);
+    }
+    g_string_append_printf (str, "%s\n", image);
+    g_free (image);
+  }
+  ret &= _write_file (path, str->str, str->len);
+  g_string_free (str, TRUE);
+  g_free (path);
+
+  return ret;
+}
+
+/**
+ * @brief Rename the images in the order of the labels.
+ * @return format of the new names, to be freed
+ */
+static gchar *
+_rename_images (PackJob * job, const gchar * images_dir)
+{
+  gchar *format, *name, *old_path, *new_path;
+  const gchar *ext;
+  guint i, digits = 3;
+
+  /* multifilesrc location=<rename>_%0Nd.<ext> */
+  for (i = job->num_images; i >= 1000; i /= 10)
+    digits++;
+  format = g_strdup_printf ("%s_%%0%ud", rename_prefix, digits);
+
+  for (i = 0; i < job->num_images; i++) {
+    ext = strrchr (job->images[i], '.');
+    name = g_strdup_printf (format, i);
+    old_path = g_build_filename (images_dir, job->images[i], NULL);
+    new_path = g_strdup_printf ("%s/%s%s", images_dir, name, ext ? ext : "");
+
+    if (g_strcmp0 (old_path, new_path) != 0 && g_rename (old_path, new_path) != 0)
+      g_printerr ("Failed to rename %s\n", old_path);
+    _print_log ("rename: %s -> %s", old_path, new_path);
+
+    g_free (old_path);
+    g_free (new_path);
+    g_free (name);
+  }
+
+  return format;
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *err = NULL;
+  PackJob job;
+  PackWorker *workers;
+  PackCounters total;
+  gchar *images_dir, *name_format = NULL;
+  gint64 start, list_us, parse_us, write_us;
+  gboolean ret = TRUE;
+  guint i, num_workers;
+
+  context = g_option_context_new ("<dataset dir> - pack the YOLO annotations");
+  g_option_context_add_main_entries (context, entries, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &err)) {
+    g_printerr ("Error initializing: %s\n", err->message);
+    g_error_free (err);
+    g_option_context_free (context);
+    return -1;
+  }
+  g_option_context_free (context);
+
+  if (argc < 2 || max_objects <= 0 || image_size <= 0) {
+    g_critical ("command example: ./nnstreamer_example_yolo_label_pack coco_sample "
+        "--output=yolo.label --max-objects=10 --image-size=416 --rename=image");
+    return -1;
+  }
+
+  memset (&job, 0, sizeof (PackJob));
+  memset (&total, 0, sizeof (PackCounters));
+  images_dir = g_build_filename (argv[1], "images", NULL);
+  job.annotation_dir = g_build_filename (argv[1], "annotations", NULL);
+  job.max_objects = (guint) max_objects;
+  job.image_size = image_size;
+
+  start = g_get_monotonic_time ();
+  job.images = _list_images (images_dir, &job.num_images);
+  list_us = g_get_monotonic_time () - start;
+  if (!job.images || job.num_images == 0) {
+    g_critical ("No image in %s", images_dir);
+    g_strfreev (job.images);
+    g_free (images_dir);
+    g_free (job.annotation_dir);
+    return -1;
+  }
+
+  job.labels = g_new0 (gfloat, (gsize) job.num_images * job.max_objects * ITEMS);
+  num_workers = serial ? 1 : (threads > 0 ? (guint) threads : g_get_num_processors ());
+  num_workers = MIN (num_workers, (job.num_images + CHUNK - 1) / CHUNK);
+  workers = g_new0 (PackWorker, num_workers);
+
+  start = g_get_monotonic_time ();
+  if (serial) {
+    workers[0].job = &job;
+    for (i = 0; i < job.num_images; i++)
+      ret &= _parse_file_serial (&workers[0], i);
+  } else {
+    for (i = 0; i < num_workers; i++) {
+      workers[i].job = &job;
+      workers[i].thread = g_thread_new ("label_pack", _worker_thread, &workers[i]);
+    }
+    for (i = 0; i < num_workers; i++)
+      ret &= GPOINTER_TO_INT (g_thread_join (workers[i].thread));
+  }
+  parse_us = g_get_monotonic_time () - start;
+
+  for (i = 0; i < num_workers; i++) {
+    total.files += workers[i].counters.files;
+    total.boxes += workers[i].counters.boxes;
+    total.empty += workers[i].counters.empty;
+    total.missing += workers[i].counters.missing;
+    total.overflow += workers[i].counters.overflow;
+    total.malformed += workers[i].counters.malformed;
+    total.out_of_range += workers[i].counters.out_of_range;
+    g_free (workers[i].buf);
+  }
+  g_free (workers);
+
+  start = g_get_monotonic_time ();
+  if (ret) {
+    if (rename_prefix)
+      name_format = _rename_images (&job, images_dir);
+    ret = _write_output (&job, images_dir, name_format);
+    if (!ret)
+      g_printerr ("Failed to write %s\n", output);
+  }
+  write_us = g_get_monotonic_time () - start;
+
+  g_print ("mode,threads,files,boxes,empty,missing,overflow,malformed,out_of_range,"
+      "list_ms,parse_ms,write_ms,files_per_sec\n");
+  g_print ("%s,%u,%u,%u,%u,%u,%u,%u,%u,%.1f,%.1f,%.1f,%.0f\n",
+      serial ? "serial" : "parallel", num_workers, total.files, total.boxes, total.empty,
+      total.missing, total.overflow, total.malformed, total.out_of_range,
+      list_us / 1000.0, parse_us / 1000.0, write_us / 1000.0,
+      parse_us > 0 ? total.files * (gdouble) G_USEC_PER_SEC / parse_us : 0.0);
+
+  if (ret && name_format)
+    g_print ("multifilesrc location=%s/%s%s\n", images_dir, name_format,
+        strrchr (job.images[0], '.') ? strrchr (job.images[0], '.') : "");
+
+  g_free (name_format);
+  g_free (job.labels);
+  g_strfreev (job.images);
+  g_free (job.annotation_dir);
+  g_free (images_dir);
+
+  return ret ? 0 : -1;
+}
@@ -0,0 +1,503 @@
+/**
+ * @file	nnstreamer_example_filter_null_overhead.c
+ * @date	19 Oct 2026
+ * @brief	Measure per-buffer framework overhead with the tensor-filter subplugin "null"
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	MyungJoo Ham <myungjoo.ham@samsung.com>
+ * @bug		No known bugs.
+ *
+ * Pipeline :
+ * appsrc -- (queue) -- tensor_filter (framework=null) -- tensor_sink
+ *
+ * The application writes a sequence number and the push time in the first input tensor.
+ * The null subplugin copies them to the output with the invoke entry and exit time.
+ * Per buffer, the framework overhead is the time from push to tensor_sink
+ * minus the time spent in the invoke.
+ *
+ * For each combination of tensor size, number of tensors and queue depth,
+ * two runs are made:
+ *  - closed : push a buffer and wait for it at tensor_sink, the latency of a single buffer.
+ *  - open   : push all buffers as fast as appsrc accepts, the throughput.
+ *
+ * Result is printed as CSV.
+ *
+ * Run example :
+ * $ ./nnstreamer_example_filter_null_overhead
+ * $ ./nnstreamer_example_filter_null_overhead --sizes=1024,1048576 --tensors=1,4 --depths=0,4 --mode=spin --us=200
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include <glib.h>
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+#include "tensor_filter_null.h"
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) if (DBG) g_message (__VA_ARGS__)
+
+/**
+ * @brief Max time to wait for a buffer at tensor_sink.
+ */
+#define WAIT_TIMEOUT_US (5 * G_USEC_PER_SEC)
+
+/**
+ * @brief Options of the benchmark.
+ */
+typedef struct
+{
+  gchar *sizes; /**< bytes per tensor */
+  gchar *tensors; /**< number of tensors */
+  gchar *depths; /**< queue depth, 0 for no queue */
+  gchar *mode; /**< workload of the null subplugin */
+  guint us; /**< time to sleep or spin in the invoke */
+  guint frames;
+  guint warmup;
+  gchar *output;
+} BenchOptions;
+
+/**
+ * @brief Data of a run.
+ */
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  guint64 received; /**< buffers arrived at tensor_sink */
+  guint warmup;
+  gint64 first_push; /**< push time of the first measured buffer */
+  gint64 last_sink; /**< arrival time of the last buffer */
+
+  GArray *total; /**< push to tensor_sink (usec) */
+  GArray *invoke; /**< invoke entry to exit (usec) */
+  GArray *overhead; /**< total - invoke (usec) */
+  GArray *upstream; /**< push to invoke entry (usec) */
+  GArray *downstream; /**< invoke exit to tensor_sink (usec) */
+} RunData;
+
+/**
+ * @brief Print usage info
+ */
+static void
+_usage (void)
+{
+  g_message ("\nusage: \n"
+  "    --sizes     Bytes per tensor. (default 64,4096,150528,1048576,8388608) \n"
+  "    --tensors   Number of tensors. (default 1,2,4,8) \n"
+  "    --depths    Depth of the queue before tensor_filter, 0 for no queue. (default 0,1,4,16) \n"
+  "    --mode      Workload of the invoke, none, sleep, spin or copy. (default none) \n"
+  "    --us        Time to sleep or spin in the invoke. (default 0) \n"
+  "    --frames    Number of measured buffers per run. (default 1000) \n"
+  "    --warmup    Number of buffers before measuring. (default 50) \n"
+  "    --output    Append CSV result to the file. \n");
+}
+
+/**
+ * @brief Compare function for latency values.
+ */
+static gint
+_compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 la = *((const gint64 *) a);
+  gint64 lb = *((const gint64 *) b);
+
+  return (la > lb) ? 1 : ((la < lb) ? -1 : 0);
+}
+
+/**
+ * @brief Get the percentile from the sorted latency array.
+ */
+static gint64
+_percentile (GArray * sorted, gdouble p)
+{
+  guint idx;
+
+  if (sorted->len == 0)
+    return 0;
+
+  idx = (guint) (p / 100.0 * (sorted->len - 1) + 0.5);
+  return g_array_index (sorted, gint64, MIN (idx, sorted->len - 1));
+}
+
+/**
+ * @brief Get the average of the latency array.
+ */
+static gdouble
+_average (GArray * arr)
+{
+  gdouble sum = 0.0;
+  guint i;
+
+  if (arr->len == 0)
+    return 0.0;
+
+  for (i = 0; i < arr->len; i++)
+    sum += g_array_index (arr, gint64, i);
+
+  return sum / arr->len;
+}
+
+/**
+ * @brief Callback for tensor sink signal.
+ */
+static void
+_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  RunData *data = (RunData *) user_data;
+  NullFilterStamp stamp;
+  gint64 now = g_get_monotonic_time ();
+  gint64 total, invoke, overhead, upstream, downstream;
+
+  if (gst_buffer_extract (buffer, 0, &stamp, sizeof (NullFilterStamp)) !=
+      sizeof (NullFilterStamp)) {
+    _print_log ("buffer is smaller than the stamp");
+    return;
+  }
+
+  g_mutex_lock (&data->lock);
+  if (stamp.user[0] >= data->warmup) {
+    total = now - (gint64) stamp.user[1];
+    invoke = stamp.exit - stamp.entry;
+    overhead = total - invoke;
+    upstream = stamp.entry - (gint64) stamp.user[1];
+    downstream = now - stamp.exit;
+
+    if (data->total->len == 0)
+      data->first_push = (gint64) stamp.user[1];
+    data->last_sink = now;
+
+    g_array_append_val (data->total, total);
+    g_array_append_val (data->invoke, invoke);
+    g_array_append_val (data->overhead, overhead);
+    g_array_append_val (data->upstream, upstream);
+    g_array_append_val (data->downstream, downstream);
+  }
+  data->received++;
+  g_cond_signal (&data->cond);
+  g_mutex_unlock (&data->lock);
+}
+
+/**
+ * @brief Wait until the given number of buffers arrive at tensor_sink.
+ */
+static gboolean
+_wait_received (RunData * data, guint64 count)
+{
+  gint64 deadline = g_get_monotonic_time () + WAIT_TIMEOUT_US;
+  gboolean ret = TRUE;
+
+  g_mutex_lock (&data->lock);
+  while (data->received < count) {
+    if (!g_cond_wait_until (&data->cond, &data->lock, deadline)) {
+      ret = FALSE;
+      break;
+    }
+  }
+  g_mutex_unlock (&data->lock);
+
+  return ret;
+}
+
+/**
+ * @brief Get the caps string of the input tensors.
+ */
+static gchar *
+_get_caps_string (guint size, guint num_tensors)
+{
+  GString *dims = g_string_new (NULL);
+  GString *types = g_string_new (NULL);
+  gchar *caps;
+  guint i;
+
+  for (i = 0; i < num_tensors; i++) {
+    g_string_append_printf (dims, "%s%u:1:1:1", (i > 0) ? "," : "", size);
+    g_string_append_printf (types, "%suint8", (i > 0) ? "," : "");
+  }
+
+  caps = g_strdup_printf ("other/tensors,format=static,num_tensors=%u,"
+      "dimensions=(string)\"%s\",types=(string)\"%s\",framerate=(fraction)0/1",
+      num_tensors, dims->str, types->str);
+
+  g_string_free (dims, TRUE);
+  g_string_free (types, TRUE);
+  return caps;
+}
+
+/**
+ * @brief Run the pipeline and print the result.
+ */
+static void
+_run (BenchOptions * opt, guint size, guint num_tensors, guint depth,
+    gboolean closed, FILE * out)
+{
+  GstElement *pipeline, *src, *sink;
+  GstMemory *shared[16] = { NULL, };
+  GstMemory *mem;
+  GstBuffer *buf;
+  GstMapInfo map;
+  GstCaps *caps;
+  RunData data;
+  gchar *str_pipeline, *queue, *caps_str;
+  guint64 i, total;
+  guint t;
+  gdouble fps = 0.0, invoke_avg;
+  gboolean ok = TRUE;
+
+  queue = (depth > 0) ? g_strdup_printf ("queue max-size-buffers=%u "
+      "max-size-bytes=0 max-size-time=0 ! ", depth) : g_strdup ("");
+  str_pipeline = g_strdup_printf ("appsrc name=src format=time block=true "
+      "max-bytes=%" G_GUINT64_FORMAT " ! %stensor_filter framework=null "
+      "custom=mode:%s,us:%u ! tensor_sink name=sink sync=false",
+      (guint64) size * num_tensors * 2, queue, opt->mode, opt->us);
+  _print_log ("%s", str_pipeline);
+
+  pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  g_free (queue);
+  if (!pipeline) {
+    g_critical ("Failed to create the pipeline.");
+    return;
+  }
+
+  memset (&data, 0, sizeof (RunData));
+  g_mutex_init (&data.lock);
+  g_cond_init (&data.cond);
+  data.warmup = opt->warmup;
+  data.total = g_array_sized_new (FALSE, FALSE, sizeof (gint64), opt->frames);
+  data.invoke = g_array_sized_new (FALSE, FALSE, sizeof (gint64), opt->frames);
+  data.overhead = g_array_sized_new (FALSE, FALSE, sizeof (gint64), opt->frames);
+  data.upstream = g_array_sized_new (FALSE, FALSE, sizeof (gint64), opt->frames);
+  data.downstream = g_array_sized_new (FALSE, FALSE, sizeof (gint64), opt->frames);
+
+  src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+  caps_str = _get_caps_string (size, num_tensors);
+  caps = gst_caps_from_string (caps_str);
+  g_object_set (src, "caps", caps, NULL);
+  gst_caps_unref (caps);
+  g_free (caps_str);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  g_signal_connect (sink, "new-data", (GCallback) _new_data_cb, &data);
+  gst_object_unref (sink);
+
+  /* tensors except the first one are shared, the first one carries the stamp */
+  for (t = 1; t < num_tensors; t++)
+    shared[t] = gst_allocator_alloc (NULL, size, NULL);
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  total = (guint64) opt->warmup + opt->frames;
+  for (i = 0; i < total; i++) {
+    buf = gst_buffer_new ();
+    mem = gst_allocator_alloc (NULL, size, NULL);
+    gst_buffer_append_memory (buf, mem);
+    for (t = 1; t < num_tensors; t++)
+      gst_buffer_append_memory (buf, gst_memory_share (shared[t], 0, -1));
+
+    if (gst_memory_map (mem, &map, GST_MAP_WRITE)) {
+      guint64 *header = (guint64 *) map.data;
+
+      header[0] = i;
+      header[1] = (guint64) g_get_monotonic_time ();
+      gst_memory_unmap (mem, &map);
+    }
+
+    if (gst_app_src_push_buffer (GST_APP_SRC (src), buf) != GST_FLOW_OK) {
+      g_critical ("Failed to push buffer [%" G_GUINT64_FORMAT "]", i);
+      ok = FALSE;
+      break;
+    }
+
+    if (closed && !_wait_received (&data, i + 1)) {
+      g_critical ("Timeout, buffer [%" G_GUINT64_FORMAT "] is not arrived.", i);
+      ok = FALSE;
+      break;
+    }
+  }
+
+  if (ok && !closed && !_wait_received (&data, total)) {
+    g_critical ("Timeout, %" G_GUINT64_FORMAT " buffers are not arrived.",
+        total - data.received);
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (src);
+  gst_object_unref (pipeline);
+
+  for (t = 1; t < num_tensors; t++)
+    gst_memory_unref (shared[t]);
+
+  g_array_sort (data.total, _compare_latency);
+  g_array_sort (data.overhead, _compare_latency);
+  g_array_sort (data.upstream, _compare_latency);
+  g_array_sort (data.downstream, _compare_latency);
+
+  invoke_avg = _average (data.invoke);
+  if (data.total->len > 1 && data.last_sink > data.first_push)
+    fps = (data.total->len * (gdouble) G_USEC_PER_SEC) /
+        (data.last_sink - data.first_push);
+
+  fprintf (out, "%u,%u,%u,%s,%u,%s,%u,%.2f,%" G_GINT64_FORMAT ",%"
+      G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%"
+      G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%.1f,%.2f\n",
+      size, num_tensors, depth, opt->mode, opt->us, closed ? "closed" : "open",
+      data.total->len, invoke_avg, _percentile (data.total, 50.0),
+      _percentile (data.total, 99.0), _percentile (data.overhead, 50.0),
+      _percentile (data.overhead, 90.0), _percentile (data.overhead, 99.0),
+      _percentile (data.upstream, 50.0), _percentile (data.downstream, 50.0),
+      fps, (fps > 0.0) ? (G_USEC_PER_SEC / fps) - invoke_avg : 0.0);
+  fflush (out);
+
+  g_array_free (data.total, TRUE);
+  g_array_free (data.invoke, TRUE);
+  g_array_free (data.overhead, TRUE);
+  g_array_free (data.upstream, TRUE);
+  g_array_free (data.downstream, TRUE);
+  g_cond_clear (&data.cond);
+  g_mutex_clear (&data.lock);
+}
+
+/**
+ * @brief Print the CSV header.
+ */
+static void
+_print_csv_header (FILE * out)
+{
+  fprintf (out, "tensor_bytes,num_tensors,queue_depth,mode,mode_us,loop,frames,"
+      "invoke_avg_us,total_p50_us,total_p99_us,overhead_p50_us,overhead_p90_us,"
+      "overhead_p99_us,upstream_p50_us,downstream_p50_us,fps,stream_overhead_us\n");
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  BenchOptions opt;
+  gchar **sizes = NULL, **tensors = NULL, **depths = NULL;
+  guint s, n, d, size, num_tensors, depth;
+  FILE *out = NULL;
+  gint ch;
+  struct option long_options[] = {
+      { "sizes", required_argument, NULL, 's' },
+      { "tensors", required_argument, NULL, 'n' },
+      { "depths", required_argument, NULL, 'd' },
+      { "mode", required_argument, NULL, 'm' },
+      { "us", required_argument, NULL, 'u' },
+      { "frames", required_argument, NULL, 'f' },
+      { "warmup", required_argument, NULL, 'w' },
+      { "output", required_argument, NULL, 'o' },
+      { "help", no_argument, NULL, 'h' },
+      { 0, 0, 0, 0}
+  };
+
+  /* init gstreamer */
+  gst_init (&argc, &argv);
+
+  memset (&opt, 0, sizeof (BenchOptions));
+  opt.sizes = g_strdup ("64,4096,150528,1048576,8388608");
+  opt.tensors = g_strdup ("1,2,4,8");
+  opt.depths = g_strdup ("0,1,4,16");
+  opt.mode = g_strdup ("none");
+  opt.frames = 1000;
+  opt.warmup = 50;
+
+  while ((ch = getopt_long (argc, argv, "s:n:d:m:u:f:w:o:h", long_options, NULL)) != -1) {
+    switch (ch) {
+      case 's':
+        g_free (opt.sizes);
+        opt.sizes = g_strdup (optarg);
+        break;
+      case 'n':
+        g_free (opt.tensors);
+        opt.tensors = g_strdup (optarg);
+        break;
+      case 'd':
+        g_free (opt.depths);
+        opt.depths = g_strdup (optarg);
+        break;
+      case 'm':
+        g_free (opt.mode);
+        opt.mode = g_strdup (optarg);
+        break;
+      case 'u':
+        opt.us = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'f':
+        opt.frames = MAX (1, (guint) g_ascii_strtoull (optarg, NULL, 10));
+        break;
+      case 'w':
+        opt.warmup = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'o':
+        g_free (opt.output);
+        opt.output = g_strdup (optarg);
+        break;
+      default:
+        _usage ();
+        goto done;
+    }
+  }
+
+  if (opt.output) {
+    gboolean exists = g_file_test (opt.output, G_FILE_TEST_EXISTS);
+
+    out = fopen (opt.output, "a");
+    if (!out) {
+      g_critical ("Failed to open %s", opt.output);
+      goto done;
+    }
+    if (!exists)
+      _print_csv_header (out);
+  } else {
+    out = stdout;
+    _print_csv_header (out);
+  }
+
+  sizes = g_strsplit (opt.sizes, ",", -1);
+  tensors = g_strsplit (opt.tensors, ",", -1);
+  depths = g_strsplit (opt.depths, ",", -1);
+
+  for (s = 0; sizes[s]; s++) {
+    /* the first tensor carries the stamp */
+    size = MAX ((guint) g_ascii_strtoull (sizes[s], NULL, 10),
+        (guint) sizeof (NullFilterStamp));
+
+    for (n = 0; tensors[n]; n++) {
+      num_tensors = CLAMP ((guint) g_ascii_strtoull (tensors[n], NULL, 10), 1, 16);
+
+      for (d = 0; depths[d]; d++) {
+        depth = (guint) g_ascii_strtoull (depths[d], NULL, 10);
+
+        _run (&opt, size, num_tensors, depth, TRUE, out);
+        _run (&opt, size, num_tensors, depth, FALSE, out);
+      }
+    }
+  }
+
+  if (out != stdout)
+    fclose (out);
+
+done:
+  g_strfreev (sizes);
+  g_strfreev (tensors);
+  g_strfreev (depths);
+  g_free (opt.sizes);
+  g_free (opt.tensors);
+  g_free (opt.depths);
+  g_free (opt.mode);
+  g_free (opt.output);
+
+  return 0;
+}
@@ -0,0 +1,231 @@
+/**
+ * @file	tensor_filter_null.c
+ * @date	19 Oct 2026
+ * @brief	NNStreamer tensor-filter subplugin "null" to measure the framework overhead
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	MyungJoo Ham <myungjoo.ham@samsung.com>
+ * @bug		No known bugs
+ *
+ * Based on templates/tensor_filter_subplugin.
+ * This accepts any input and gives the output with the same dimension and type.
+ * The invoke does nothing, or spends the given time with the custom property, e.g.,
+ *   tensor_filter framework=null custom=mode:spin,us:500
+ *  - mode : none (default), sleep, spin (busy loop) or copy (copy input to output).
+ *  - us   : time to sleep or spin in usec.
+ *
+ * Each invoke writes NullFilterStamp at the beginning of the first output tensor,
+ * the first 16 bytes of the first input tensor (e.g., sequence number and push time
+ * given by the application) followed by the invoke entry and exit time.
+ * The time is g_get_monotonic_time () in usec.
+ */
+
+#include <string.h>
+#include <glib.h>
+#include <nnstreamer_plugin_api_filter.h>
+#include "tensor_filter_null.h"
+
+void init_filter_null (void) __attribute__ ((constructor));
+void fini_filter_null (void) __attribute__ ((destructor));
+
+/**
+ * @brief Synthetic workload of the invoke.
+ */
+typedef enum
+{
+  NULL_MODE_NONE = 0,
+  NULL_MODE_SLEEP,
+  NULL_MODE_SPIN,
+  NULL_MODE_COPY
+} null_mode_e;
+
+/**
+ * @brief Private data of the null subplugin.
+ */
+typedef struct
+{
+  null_mode_e mode;
+  gint64 us; /**< time to sleep or spin */
+  GstTensorsInfo info; /**< input and output info */
+} null_pdata;
+
+static void null_close (const GstTensorFilterProperties * prop,
+    void **private_data);
+
+/**
+ * @brief Parse the custom property (key:value,key:value).
+ */
+static void
+null_parse_custom (null_pdata * pdata, const gchar * custom)
+{
+  gchar **options, **kv;
+  guint i;
+
+  if (!custom)
+    return;
+
+  options = g_strsplit (custom, ",", -1);
+  for (i = 0; options[i]; i++) {
+    kv = g_strsplit (options[i], ":", 2);
+
+    if (g_strv_length (kv) == 2) {
+      g_strstrip (kv[0]);
+      g_strstrip (kv[1]);
+
+      if (g_ascii_strcasecmp (kv[0], "mode") == 0) {
+        if (g_ascii_strcasecmp (kv[1], "sleep") == 0)
+          pdata->mode = NULL_MODE_SLEEP;
+        else if (g_ascii_strcasecmp (kv[1], "spin") == 0)
+          pdata->mode = NULL_MODE_SPIN;
+        else if (g_ascii_strcasecmp (kv[1], "copy") == 0)
+          pdata->mode = NULL_MODE_COPY;
+        else
+          pdata->mode = NULL_MODE_NONE;
+      } else if (g_ascii_strcasecmp (kv[0], "us") == 0) {
+        pdata->us = g_ascii_strtoll (kv[1], NULL, 10);
+      }
+    }
+
+    g_strfreev (kv);
+  }
+  g_strfreev (options);
+}
+
+/**
+ * @brief The standard tensor_filter callback
+ */
+static int
+null_open (const GstTensorFilterProperties * prop, void **private_data)
+{
+  null_pdata *pdata;
+
+  if (*private_data != NULL) {
+    /* no model to reload, just update the options */
+    null_parse_custom ((null_pdata *) *private_data, prop->custom_properties);
+    return 1;
+  }
+
+  pdata = g_new0 (null_pdata, 1);
+  if (pdata == NULL)
+    return -1;
+
+  *private_data = (void *) pdata;
+
+  gst_tensors_info_init (&pdata->info);
+  null_parse_custom (pdata, prop->custom_properties);
+
+  return 0;
+}
+
+/**
+ * @brief The standard tensor_filter callback
+ */
+static void
+null_close (const GstTensorFilterProperties * prop, void **private_data)
+{
+  null_pdata *pdata;
+  pdata = *private_data;
+
+  gst_tensors_info_free (&pdata->info);
+
+  g_free (pdata);
+  *private_data = NULL;
+}
+
+/**
+ * @brief The tensor_filter callback for flexible input/output dimension.
+ */
+static int
+null_setInputDim (const GstTensorFilterProperties * prop,
+    void **private_data, const GstTensorsInfo * in_info,
+    GstTensorsInfo * out_info)
+{
+  null_pdata *pdata = *private_data;
+
+  gst_tensors_info_free (&pdata->info);
+  gst_tensors_info_copy (&pdata->info, in_info);
+  gst_tensors_info_copy (out_info, in_info);
+
+  return 0;
+}
+
+/**
+ * @brief The standard tensor_filter callback
+ */
+static int
+null_invoke (const GstTensorFilterProperties * prop,
+    void **private_data, const GstTensorMemory * input,
+    GstTensorMemory * output)
+{
+  null_pdata *pdata = *private_data;
+  NullFilterStamp stamp;
+  gint64 deadline;
+  guint i;
+
+  stamp.entry = g_get_monotonic_time ();
+
+  switch (pdata->mode) {
+    case NULL_MODE_SLEEP:
+      if (pdata->us > 0)
+        g_usleep (pdata->us);
+      break;
+    case NULL_MODE_SPIN:
+      deadline = stamp.entry + pdata->us;
+      while (g_get_monotonic_time () < deadline)
+        ;
+      break;
+    case NULL_MODE_COPY:
+      for (i = 0; i < pdata->info.num_tensors; i++)
+        memcpy (output[i].data, input[i].data, MIN (input[i].size, output[i].size));
+      break;
+    default:
+      break;
+  }
+
+  if (output[0].size >= sizeof (NullFilterStamp) &&
+      input[0].size >= sizeof (NullFilterStamp)) {
+    memcpy (stamp.user, input[0].data, sizeof (stamp.user));
+    stamp.exit = g_get_monotonic_time ();
+    memcpy (output[0].data, &stamp, sizeof (NullFilterStamp));
+  }
+
+  return 0;
+}
+
+static gchar filter_subplugin_null[] = "null";
+
+static GstTensorFilterFramework NNS_support_null = {
+#ifdef GST_TENSOR_FILTER_API_VERSION_DEFINED
+  .version = GST_TENSOR_FILTER_FRAMEWORK_V0,
+#else
+  .name = filter_subplugin_null,
+  .allow_in_place = FALSE,
+  .allocate_in_invoke = FALSE,
+  .run_without_model = TRUE,
+  .invoke_NN = null_invoke,
+  .setInputDimension = null_setInputDim,
+#endif
+  .open = null_open,
+  .close = null_close,
+};
+
+/**@brief Initialize this object for tensor_filter subplugin runtime register */
+void
+init_filter_null (void)
+{
+#ifdef GST_TENSOR_FILTER_API_VERSION_DEFINED
+  NNS_support_null.name = filter_subplugin_null;
+  NNS_support_null.allow_in_place = FALSE;
+  NNS_support_null.allocate_in_invoke = FALSE;
+  NNS_support_null.run_without_model = TRUE;
+  NNS_support_null.invoke_NN = null_invoke;
+  NNS_support_null.setInputDimension = null_setInputDim;
+#endif
+  nnstreamer_filter_probe (&NNS_support_null);
+}
+
+/** @brief Destruct the subplugin */
+void
+fini_filter_null (void)
+{
+  nnstreamer_filter_exit (NNS_support_null.name);
+}
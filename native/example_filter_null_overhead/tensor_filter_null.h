@@ -0,0 +1,25 @@
+/**
+ * @file	tensor_filter_null.h
+ * @date	19 Oct 2026
+ * @brief	Layout of the timestamps written by the tensor-filter subplugin "null"
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	MyungJoo Ham <myungjoo.ham@samsung.com>
+ * @bug		No known bugs
+ */
+#ifndef __TENSOR_FILTER_NULL_H__
+#define __TENSOR_FILTER_NULL_H__
+
+#include <glib.h>
+
+/**
+ * @brief Written at the beginning of the first output tensor.
+ *        Tensors smaller than this are not stamped.
+ */
+typedef struct
+{
+  guint64 user[2]; /**< first 16 bytes of the first input tensor */
+  gint64 entry; /**< invoke entry, g_get_monotonic_time () */
+  gint64 exit; /**< invoke exit, g_get_monotonic_time () */
+} NullFilterStamp;
+
+#endif /* __TENSOR_FILTER_NULL_H__ */
@@ -0,0 +1,970 @@
+/**
+ * @file	nnstreamer_example_image_classification_eval.c
+ * @date	19 October 2026
+ * @brief	Offline accuracy and throughput of the image classification examples
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Jaeyun Jung <jy1210.jung@samsung.com>
+ * @bug		No known bugs.
+ *
+ * Runs the model of image classification example (tflite, nnfw or caffe2) over a folder of images,
+ * and reports top-1/top-5 accuracy, images/sec and latency percentiles.
+ *
+ * The images are decoded on a thread pool (filesrc ! decodebin ! videoscale ! appsink),
+ * and pushed to the inference pipeline as fast as possible:
+ * appsrc ! tensor_converter ! (transform) ! tensor_filter ! tensor_sink
+ *
+ * The manifest has an image and its ground truth in each line, separated by a tab, comma or space.
+ * The ground truth is a label name (e.g., 'goldfish', or the synset 'n01443537' with the caffe2 labels)
+ * or an index in the label file (plus --label-offset).
+ *   images/0001.jpg,goldfish
+ *   images/0002.jpg 2
+ * Without the manifest, all files in the folder are classified and only the throughput is reported.
+ *
+ * $ ./nnstreamer_example_image_classification_eval --backend=tflite --images=./val --manifest=./val.txt
+ * $ ./nnstreamer_example_image_classification_eval --backend=nnfw --images=./val --manifest=./val.txt
+ * $ ./nnstreamer_example_image_classification_eval --backend=caffe2 --images=./val --manifest=./val.txt
+ * $ ./nnstreamer_example_image_classification_eval --backend=tflite --model=./mobilenet_v1_1.0_224.tflite \
+ *     --transform="tensor_transform mode=arithmetic option=typecast:float32,add:-127.5,div:127.5"
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <glib.h>
+#include <gst/gst.h>
+#include <gst/app/app.h>
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) if (DBG) g_message (__VA_ARGS__)
+
+/**
+ * @brief Macro to check error case.
+ */
+#define _check_cond_err(cond) \
+  do { \
+    if (!(cond)) { \
+      _print_log ("app failed! [line : %d]", __LINE__); \
+      goto error; \
+    } \
+  } while (0)
+
+#define TOP_K 5
+
+/**
+ * @brief Options and the model of the backend.
+ */
+typedef struct
+{
+  gchar *backend; /**< tflite, nnfw or caffe2 */
+  gchar *framework; /**< tensor_filter framework */
+  gchar *model; /**< model file(s) */
+  gchar *labels; /**< label file */
+  gchar *transform; /**< elements between tensor_converter and tensor_filter */
+  gchar *filter_options; /**< more properties of tensor_filter */
+  guint width; /**< model input width */
+  guint height; /**< model input height */
+  gint label_offset; /**< added to the numeric ground truth */
+
+  gchar *images; /**< folder of the images */
+  gchar *manifest; /**< manifest file, NULL to classify all images in the folder */
+  gchar *output; /**< file to write the result of each image */
+  guint threads; /**< number of decoding threads */
+  guint inflight; /**< max images in the inference pipeline */
+  guint limit; /**< max images, 0 for all */
+  gboolean preload; /**< decode all images before the inference */
+} EvalOption;
+
+/**
+ * @brief An image and its result.
+ */
+typedef struct
+{
+  guint index; /**< index in the manifest */
+  gchar *path; /**< image file path */
+  gint truth; /**< index of the ground truth label, -1 if unknown */
+  GstSample *sample; /**< decoded image */
+  gint64 decode_us; /**< decoding time */
+  gint64 pushed; /**< time when the image is pushed */
+  gint64 latency; /**< time from push to result */
+  gint top[TOP_K]; /**< top-k label indices */
+  gfloat score[TOP_K]; /**< top-k scores */
+} EvalImage;
+
+/**
+ * @brief Data structure for app.
+ */
+typedef struct
+{
+  EvalOption opt; /**< options */
+  gchar **labels; /**< loaded labels */
+  guint total_labels; /**< count of labels */
+  GHashTable *label_names; /**< lower-case label name to index */
+
+  GPtrArray *images; /**< images to classify */
+  GAsyncQueue *decoded; /**< decoded images */
+  GAsyncQueue *pending; /**< images in the inference pipeline, in push order */
+  GThreadPool *decoders; /**< decoding threads */
+
+  GstElement *pipeline; /**< inference pipeline */
+  GstElement *src; /**< appsrc */
+  GstBus *bus; /**< bus of the inference pipeline */
+
+  GMutex mutex; /**< lock for the counters below */
+  GCond cond; /**< signaled when a result arrives */
+  guint inflight; /**< images in the inference pipeline */
+  guint done; /**< images with the result */
+  guint failed; /**< images failed to decode */
+  gboolean error; /**< the pipeline posted an error */
+  gchar *out_type; /**< output tensor type */
+  gint64 first_push; /**< time of the first push */
+  gint64 last_result; /**< time of the last result */
+} AppData;
+
+/**
+ * @brief Data for pipeline and result.
+ */
+static AppData g_app;
+
+/**
+ * @brief Compare function to sort latency.
+ */
+static gint
+_compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 la = *((const gint64 *) a);
+  gint64 lb = *((const gint64 *) b);
+
+  return (la > lb) ? 1 : ((la < lb) ? -1 : 0);
+}
+
+/**
+ * @brief Get the percentile from the sorted latency array.
+ */
+static gint64
+_percentile (GArray * sorted, gdouble p)
+{
+  guint idx;
+
+  if (sorted->len == 0)
+    return 0;
+
+  idx = (guint) (p / 100.0 * (sorted->len - 1) + 0.5);
+  return g_array_index (sorted, gint64, MIN (idx, sorted->len - 1));
+}
+
+/**
+ * @brief Set the default model of the backend, same as the image classification examples.
+ */
+static gboolean
+_set_backend (EvalOption * opt)
+{
+  if (g_strcmp0 (opt->backend, "tflite") == 0 || g_strcmp0 (opt->backend, "nnfw") == 0) {
+    if (!opt->framework)
+      opt->framework = g_strdup (g_strcmp0 (opt->backend, "nnfw") == 0 ?
+          "nnfw" : "tensorflow-lite");
+    if (!opt->model)
+      opt->model = g_strdup ("./tflite_model_img/mobilenet_v1_1.0_224_quant.tflite");
+    if (!opt->labels)
+      opt->labels = g_strdup ("./tflite_model_img/labels.txt");
+  } else if (g_strcmp0 (opt->backend, "caffe2") == 0) {
+    if (!opt->framework)
+      opt->framework = g_strdup ("caffe2");
+    if (!opt->model)
+      opt->model = g_strdup ("./caffe2_model/init_net.pb,./caffe2_model/predict_net.pb");
+    if (!opt->labels)
+      opt->labels = g_strdup ("./caffe2_model/labels.txt");
+    if (!opt->transform)
+      opt->transform = g_strdup ("tensor_transform mode=transpose option=1:2:0:3 ! "
+          "tensor_transform mode=arithmetic option=typecast:float32,add:-123,div:63");
+    if (!opt->filter_options)
+      opt->filter_options = g_strdup ("inputname=data input=224:224:3:1 inputtype=float32 "
+          "output=1000:1 outputtype=float32 outputname=softmax");
+  } else if (!opt->framework || !opt->model || !opt->labels) {
+    g_critical ("Unknown backend [%s], set --framework, --model and --labels.", opt->backend);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Add a label name (lower-case) to the table, the first index wins.
+ */
+static void
+_add_label_name (const gchar * name, guint index)
+{
+  gchar *key = g_ascii_strdown (g_strstrip (g_strdup (name)), -1);
+
+  if (key[0] == '\0' || g_hash_table_contains (g_app.label_names, key)) {
+    g_free (key);
+    return;
+  }
+
+  g_hash_table_insert (g_app.label_names, key, GUINT_TO_POINTER (index));
+}
+
+/**
+ * @brief Load labels. A line may have the synset and synonyms, e.g., 'n01443537 goldfish, Carassius auratus'.
+ */
+static gboolean
+_load_labels (const gchar * path)
+{
+  gchar *contents = NULL;
+  gchar **names, **words;
+  guint i, j;
+
+  if (!g_file_get_contents (path, &contents, NULL, NULL)) {
+    g_critical ("cannot find label [%s]", path);
+    return FALSE;
+  }
+
+  g_app.labels = g_strsplit (contents, "\n", -1);
+  g_free (contents);
+
+  g_app.total_labels = g_strv_length (g_app.labels);
+  while (g_app.total_labels > 0 && g_app.labels[g_app.total_labels - 1][0] == '\0')
+    g_app.total_labels--;
+
+  g_app.label_names = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  for (i = 0; i < g_app.total_labels; i++) {
+    g_strstrip (g_app.labels[i]);
+    _add_label_name (g_app.labels[i], i);
+
+    words = g_strsplit (g_app.labels[i], " ", 2);
+    if (words[0] && words[1] && strlen (words[0]) == 9 && words[0][0] == 'n') {
+      _add_label_name (words[0], i);
+
+      names = g_strsplit (words[1], ",", -1);
+      for (j = 0; names[j]; j++)
+        _add_label_name (names[j], i);
+      g_strfreev (names);
+    }
+    g_strfreev (words);
+  }
+
+  _print_log ("finished to load labels, total %d", g_app.total_labels);
+  return TRUE;
+}
+
+/**
+ * @brief Get the index of the ground truth.
+ */
+static gint
+_get_truth (const gchar * truth)
+{
+  gchar *key, *end = NULL;
+  gint64 index;
+  gpointer value;
+
+  index = g_ascii_strtoll (truth, &end, 10);
+  if (end != truth && *end == '\0') {
+    index += g_app.opt.label_offset;
+    return (index >= 0 && index < g_app.total_labels) ? (gint) index : -1;
+  }
+
+  key = g_ascii_strdown (truth, -1);
+  if (!g_hash_table_lookup_extended (g_app.label_names, key, NULL, &value))
+    value = GINT_TO_POINTER (-1);
+  g_free (key);
+
+  return GPOINTER_TO_INT (value);
+}
+
+/**
+ * @brief Create an image.
+ */
+static EvalImage *
+_new_image (const gchar * path, gint truth)
+{
+  EvalImage *image = g_new0 (EvalImage, 1);
+
+  image->index = g_app.images->len;
+  image->path = g_strdup (path);
+  image->truth = truth;
+  return image;
+}
+
+/**
+ * @brief Free an image.
+ */
+static void
+_free_image (gpointer data)
+{
+  EvalImage *image = (EvalImage *) data;
+
+  if (image->sample)
+    gst_sample_unref (image->sample);
+  g_free (image->path);
+  g_free (image);
+}
+
+/**
+ * @brief Load the list of images from the manifest or the folder.
+ */
+static gboolean
+_load_images (void)
+{
+  gchar *contents = NULL;
+  gchar **lines, **fields;
+  gchar *path;
+  const gchar *name;
+  GDir *dir;
+  GPtrArray *names;
+  guint i, unknown = 0;
+  gint truth;
+
+  g_app.images = g_ptr_array_new_with_free_func (_free_image);
+
+  if (g_app.opt.manifest) {
+    if (!g_file_get_contents (g_app.opt.manifest, &contents, NULL, NULL)) {
+      g_critical ("cannot find manifest [%s]", g_app.opt.manifest);
+      return FALSE;
+    }
+
+    lines = g_strsplit (contents, "\n", -1);
+    g_free (contents);
+
+    for (i = 0; lines[i]; i++) {
+      g_strstrip (lines[i]);
+      if (lines[i][0] == '\0' || lines[i][0] == '#')
+        continue;
+
+      fields = g_strsplit_set (lines[i], "\t, ", 2);
+      truth = -1;
+      if (fields[1]) {
+        truth = _get_truth (g_strstrip (fields[1]));
+        if (truth < 0)
+          unknown++;
+      }
+
+      path = g_path_is_absolute (fields[0]) ? g_strdup (fields[0]) :
+          g_build_filename (g_app.opt.images, fields[0], NULL);
+      g_ptr_array_add (g_app.images, _new_image (path, truth));
+      g_free (path);
+      g_strfreev (fields);
+
+      if (g_app.opt.limit > 0 && g_app.images->len >= g_app.opt.limit)
+        break;
+    }
+
+    g_strfreev (lines);
+
+    if (unknown > 0)
+      g_warning ("%u images have unknown ground truth, they are excluded from accuracy.", unknown);
+  } else {
+    dir = g_dir_open (g_app.opt.images, 0, NULL);
+    if (dir == NULL) {
+      g_critical ("cannot open the folder [%s]", g_app.opt.images);
+      return FALSE;
+    }
+
+    names = g_ptr_array_new_with_free_func (g_free);
+    while ((name = g_dir_read_name (dir)) != NULL)
+      g_ptr_array_add (names, g_build_filename (g_app.opt.images, name, NULL));
+    g_dir_close (dir);
+
+    /* same order for each run */
+    g_ptr_array_sort (names, (GCompareFunc) g_strcmp0);
+    for (i = 0; i < names->len; i++) {
+      if (!g_file_test ((gchar *) g_ptr_array_index (names, i), G_FILE_TEST_IS_REGULAR))
+        continue;
+
+      g_ptr_array_add (g_app.images, _new_image (g_ptr_array_index (names, i), -1));
+      if (g_app.opt.limit > 0 && g_app.images->len >= g_app.opt.limit)
+        break;
+    }
+    g_ptr_array_free (names, TRUE);
+  }
+
+  return (g_app.images->len > 0);
+}
+
+/**
+ * @brief Thread pool function, decode an image and resize it to the model input.
+ */
+static void
+_decode_image (gpointer data, gpointer user_data)
+{
+  EvalImage *image = (EvalImage *) data;
+  GstElement *pipeline, *src, *sink;
+  gchar *str_pipeline;
+  gint64 start = g_get_monotonic_time ();
+
+  str_pipeline = g_strdup_printf
+      ("filesrc name=src ! decodebin ! videoconvert ! videoscale ! "
+      "video/x-raw,format=RGB,width=%u,height=%u ! "
+      "appsink name=sink sync=false max-buffers=1",
+      g_app.opt.width, g_app.opt.height);
+
+  pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+
+  if (pipeline) {
+    /* set the path here, no need to escape it in the pipeline description */
+    src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+    g_object_set (src, "location", image->path, NULL);
+    gst_object_unref (src);
+
+    sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+    gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+    /* NULL if failed to decode */
+    image->sample = gst_app_sink_try_pull_sample (GST_APP_SINK (sink), 10 * GST_SECOND);
+
+    gst_element_set_state (pipeline, GST_STATE_NULL);
+    gst_object_unref (sink);
+    gst_object_unref (pipeline);
+  }
+
+  image->decode_us = g_get_monotonic_time () - start;
+  g_async_queue_push (g_app.decoded, image);
+}
+
+/**
+ * @brief Get top-k of the scores.
+ */
+static void
+_get_top_k (const guint8 * data, gsize size, EvalImage * image)
+{
+  guint num, i, k, j;
+  gfloat score;
+
+  if (g_str_equal (g_app.out_type, "float32"))
+    num = size / sizeof (gfloat);
+  else
+    num = size;
+
+  for (k = 0; k < TOP_K; k++) {
+    image->top[k] = -1;
+    image->score[k] = -G_MAXFLOAT;
+  }
+
+  for (i = 0; i < num; i++) {
+    if (g_str_equal (g_app.out_type, "float32"))
+      score = ((const gfloat *) data)[i];
+    else if (g_str_equal (g_app.out_type, "int8"))
+      score = ((const gint8 *) data)[i];
+    else
+      score = data[i];
+
+    if (score <= image->score[TOP_K - 1])
+      continue;
+
+    /* insert into the sorted top-k */
+    for (k = TOP_K - 1; k > 0 && score > image->score[k - 1]; k--)
+      ;
+    for (j = TOP_K - 1; j > k; j--) {
+      image->top[j] = image->top[j - 1];
+      image->score[j] = image->score[j - 1];
+    }
+    image->top[k] = (gint) i;
+    image->score[k] = score;
+  }
+}
+
+/**
+ * @brief Get the type of the output tensor from the caps of tensor_sink.
+ */
+static void
+_parse_output_type (GstElement * element)
+{
+  GstPad *pad;
+  GstCaps *caps = NULL;
+  GstStructure *structure;
+  const gchar *type = NULL;
+  gchar **types;
+
+  pad = gst_element_get_static_pad (element, "sink");
+  if (pad) {
+    caps = gst_pad_get_current_caps (pad);
+    gst_object_unref (pad);
+  }
+
+  if (caps) {
+    structure = gst_caps_get_structure (caps, 0);
+    type = gst_structure_get_string (structure, "type");
+    if (type == NULL)
+      type = gst_structure_get_string (structure, "types");
+  }
+
+  types = g_strsplit (type ? type : "uint8", ",", 2);
+  g_app.out_type = g_strdup (types[0]);
+  g_strfreev (types);
+
+  if (caps)
+    gst_caps_unref (caps);
+
+  _print_log ("output type %s", g_app.out_type);
+}
+
+/**
+ * @brief Callback for tensor sink signal, results arrive in the push order.
+ */
+static void
+_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  EvalImage *image;
+  GstMemory *mem;
+  GstMapInfo info;
+  gint64 now = g_get_monotonic_time ();
+
+  image = (EvalImage *) g_async_queue_try_pop (g_app.pending);
+  g_return_if_fail (image != NULL);
+
+  if (g_app.out_type == NULL)
+    _parse_output_type (element);
+
+  image->latency = now - image->pushed;
+
+  mem = gst_buffer_peek_memory (buffer, 0);
+  if (gst_memory_map (mem, &info, GST_MAP_READ)) {
+    _get_top_k (info.data, info.size, image);
+    gst_memory_unmap (mem, &info);
+  }
+
+  /* the decoded image is no longer needed */
+  gst_sample_unref (image->sample);
+  image->sample = NULL;
+
+  g_mutex_lock (&g_app.mutex);
+  g_app.inflight--;
+  g_app.done++;
+  g_app.last_result = now;
+  g_cond_signal (&g_app.cond);
+  g_mutex_unlock (&g_app.mutex);
+}
+
+/**
+ * @brief Callback for message.
+ */
+static void
+_message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
+{
+  GError *error = NULL;
+  gchar *debug = NULL;
+
+  if (GST_MESSAGE_TYPE (message) != GST_MESSAGE_ERROR)
+    return;
+
+  gst_message_parse_error (message, &error, &debug);
+  gst_object_default_error (GST_MESSAGE_SRC (message), error, debug);
+  g_error_free (error);
+  g_free (debug);
+
+  g_mutex_lock (&g_app.mutex);
+  g_app.error = TRUE;
+  g_cond_signal (&g_app.cond);
+  g_mutex_unlock (&g_app.mutex);
+}
+
+/**
+ * @brief Push the decoded image to the inference pipeline.
+ * @return FALSE if the pipeline has an error
+ */
+static gboolean
+_push_image (EvalImage * image)
+{
+  GstBuffer *buffer;
+
+  g_mutex_lock (&g_app.mutex);
+  while (g_app.inflight >= g_app.opt.inflight && !g_app.error)
+    g_cond_wait (&g_app.cond, &g_app.mutex);
+
+  if (g_app.error) {
+    g_mutex_unlock (&g_app.mutex);
+    return FALSE;
+  }
+  g_app.inflight++;
+  g_mutex_unlock (&g_app.mutex);
+
+  image->pushed = g_get_monotonic_time ();
+  if (g_app.first_push == 0)
+    g_app.first_push = image->pushed;
+
+  /* results arrive in the push order */
+  g_async_queue_push (g_app.pending, image);
+
+  buffer = gst_buffer_ref (gst_sample_get_buffer (image->sample));
+  if (gst_app_src_push_buffer (GST_APP_SRC (g_app.src), buffer) != GST_FLOW_OK) {
+    /* no result will arrive, do not wait for it */
+    g_warning ("Failed to push %s", image->path);
+    g_async_queue_remove (g_app.pending, image);
+
+    g_mutex_lock (&g_app.mutex);
+    g_app.inflight--;
+    g_app.error = TRUE;
+    g_cond_signal (&g_app.cond);
+    g_mutex_unlock (&g_app.mutex);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Get the image from the decoders, push the next image to keep the decoders busy.
+ */
+static EvalImage *
+_next_decoded (guint * next, guint * decoding)
+{
+  guint ahead = g_app.opt.preload ? G_MAXUINT : g_app.opt.threads * 4;
+
+  /* bounded, the decoded images stay in memory until the result */
+  while (*next < g_app.images->len && *decoding < ahead) {
+    g_thread_pool_push (g_app.decoders, g_ptr_array_index (g_app.images, *next), NULL);
+    (*next)++;
+    (*decoding)++;
+  }
+
+  if (*decoding == 0)
+    return NULL;
+
+  (*decoding)--;
+  return (EvalImage *) g_async_queue_pop (g_app.decoded);
+}
+
+/**
+ * @brief Print the report and write the result of each image.
+ */
+static void
+_report (gint64 decode_elapsed)
+{
+  EvalImage *image;
+  GArray *latency;
+  FILE *fp = NULL;
+  guint i, k, labeled = 0, top1 = 0, top5 = 0;
+  gboolean correct1, correct5;
+  gint64 decode_sum = 0;
+  gdouble elapsed;
+
+  latency = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+  if (g_app.opt.output) {
+    fp = fopen (g_app.opt.output, "w");
+    if (fp)
+      fprintf (fp, "image,truth,top1,score,correct_top1,correct_top5,latency_us,decode_us\n");
+  }
+
+  for (i = 0; i < g_app.images->len; i++) {
+    image = (EvalImage *) g_ptr_array_index (g_app.images, i);
+    if (image->pushed == 0 || image->latency == 0)
+      continue;
+
+    g_array_append_val (latency, image->latency);
+    decode_sum += image->decode_us;
+
+    correct1 = correct5 = FALSE;
+    if (image->truth >= 0) {
+      labeled++;
+      correct1 = (image->top[0] == image->truth);
+      for (k = 0; k < TOP_K && !correct5; k++)
+        correct5 = (image->top[k] == image->truth);
+
+      top1 += correct1 ? 1 : 0;
+      top5 += correct5 ? 1 : 0;
+    }
+
+    if (fp) {
+      fprintf (fp, "%s,%d,%d,%.4f,%d,%d,%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT "\n",
+          image->path, image->truth, image->top[0], image->score[0], correct1, correct5,
+          image->latency, image->decode_us);
+    }
+  }
+
+  if (fp)
+    fclose (fp);
+
+  g_array_sort (latency, _compare_latency);
+  elapsed = (g_app.last_result - g_app.first_push) / (gdouble) G_USEC_PER_SEC;
+
+  g_print ("backend,framework,images,labeled,decode_failed,top1,top5,images_per_sec,"
+      "decode_ms_avg,decode_images_per_sec,lat_p50_us,lat_p90_us,lat_p99_us,lat_max_us\n");
+  g_print ("%s,%s,%u,%u,%u,%.4f,%.4f,%.2f,%.2f,%.2f,%" G_GINT64_FORMAT ",%"
+      G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT "\n",
+      g_app.opt.backend, g_app.opt.framework, latency->len, labeled, g_app.failed,
+      labeled ? top1 / (gdouble) labeled : 0.0, labeled ? top5 / (gdouble) labeled : 0.0,
+      elapsed > 0 ? latency->len / elapsed : 0.0,
+      latency->len ? decode_sum / 1000.0 / latency->len : 0.0,
+      decode_elapsed > 0 ? (latency->len + g_app.failed) * (gdouble) G_USEC_PER_SEC / decode_elapsed : 0.0,
+      _percentile (latency, 50.0), _percentile (latency, 90.0),
+      _percentile (latency, 99.0), _percentile (latency, 100.0));
+
+  g_array_free (latency, TRUE);
+}
+
+/**
+ * @brief Print usage info.
+ */
+static void
+_usage (void)
+{
+  g_print ("usage: nnstreamer_example_image_classification_eval [options]\n"
+      "    --backend         tflite, nnfw or caffe2, the model of the image classification example. (default tflite)\n"
+      "    --images          Folder of the images. (default ./images)\n"
+      "    --manifest        Image and its ground truth in each line, classify all images in the folder if not given.\n"
+      "    --threads         Number of decoding threads. (default 4)\n"
+      "    --inflight        Max images in the inference pipeline, 1 for latency without queueing. (default 4)\n"
+      "    --limit           Max images, 0 for all. (default 0)\n"
+      "    --preload         Decode all images before the inference.\n"
+      "    --output          CSV file to write the result of each image.\n"
+      "    --framework       tensor_filter framework, overrides the backend.\n"
+      "    --model           Model file(s), overrides the backend.\n"
+      "    --labels          Label file, overrides the backend.\n"
+      "    --transform       Elements between tensor_converter and tensor_filter.\n"
+      "    --filter-options  More properties of tensor_filter.\n"
+      "    --size            Model input WIDTHxHEIGHT. (default 224x224)\n"
+      "    --label-offset    Added to the numeric ground truth, e.g., 1 for the labels with background. (default 0)\n");
+}
+
+/**
+ * @brief Parse the options.
+ */
+static gboolean
+_parse_options (int argc, char **argv, EvalOption * opt)
+{
+  gint o;
+  struct option long_options[] = {
+    {"backend", required_argument, NULL, 'b'},
+    {"images", required_argument, NULL, 'i'},
+    {"manifest", required_argument, NULL, 'm'},
+    {"threads", required_argument, NULL, 't'},
+    {"inflight", required_argument, NULL, 'f'},
+    {"limit", required_argument, NULL, 'l'},
+    {"preload", no_argument, NULL, 'p'},
+    {"output", required_argument, NULL, 'o'},
+    {"framework", required_argument, NULL, 'w'},
+    {"model", required_argument, NULL, 'M'},
+    {"labels", required_argument, NULL, 'L'},
+    {"transform", required_argument, NULL, 'T'},
+    {"filter-options", required_argument, NULL, 'F'},
+    {"size", required_argument, NULL, 's'},
+    {"label-offset", required_argument, NULL, 'O'},
+    {"help", no_argument, NULL, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  opt->backend = g_strdup ("tflite");
+  opt->images = g_strdup ("./images");
+  opt->threads = 4;
+  opt->inflight = 4;
+  opt->width = opt->height = 224;
+
+  while ((o = getopt_long (argc, argv, "b:i:m:t:f:l:po:w:M:L:T:F:s:O:h",
+              long_options, NULL)) != -1) {
+    switch (o) {
+      case 'b':
+        g_free (opt->backend);
+        opt->backend = g_strdup (optarg);
+        break;
+      case 'i':
+        g_free (opt->images);
+        opt->images = g_strdup (optarg);
+        break;
+      case 'm':
+        opt->manifest = g_strdup (optarg);
+        break;
+      case 't':
+        opt->threads = MAX ((guint) g_ascii_strtoull (optarg, NULL, 10), 1U);
+        break;
+      case 'f':
+        opt->inflight = MAX ((guint) g_ascii_strtoull (optarg, NULL, 10), 1U);
+        break;
+      case 'l':
+        opt->limit = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'p':
+        opt->preload = TRUE;
+        break;
+      case 'o':
+        opt->output = g_strdup (optarg);
+        break;
+      case 'w':
+        opt->framework = g_strdup (optarg);
+        break;
+      case 'M':
+        opt->model = g_strdup (optarg);
+        break;
+      case 'L':
+        opt->labels = g_strdup (optarg);
+        break;
+      case 'T':
+        opt->transform = g_strdup (optarg);
+        break;
+      case 'F':
+        opt->filter_options = g_strdup (optarg);
+        break;
+      case 's':
+        if (sscanf (optarg, "%ux%u", &opt->width, &opt->height) != 2)
+          return FALSE;
+        break;
+      case 'O':
+        opt->label_offset = (gint) g_ascii_strtoll (optarg, NULL, 10);
+        break;
+      default:
+        return FALSE;
+    }
+  }
+
+  return _set_backend (opt);
+}
+
+/**
+ * @brief Free the options.
+ */
+static void
+_free_options (EvalOption * opt)
+{
+  g_free (opt->backend);
+  g_free (opt->framework);
+  g_free (opt->model);
+  g_free (opt->labels);
+  g_free (opt->transform);
+  g_free (opt->filter_options);
+  g_free (opt->images);
+  g_free (opt->manifest);
+  g_free (opt->output);
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  EvalImage *image;
+  GstElement *element;
+  gchar *str_pipeline;
+  guint next = 0, decoding = 0, i;
+  gint64 decode_start, decode_elapsed = 0;
+
+  memset (&g_app, 0, sizeof (AppData));
+  g_mutex_init (&g_app.mutex);
+  g_cond_init (&g_app.cond);
+
+  if (!_parse_options (argc, argv, &g_app.opt)) {
+    _usage ();
+    goto error;
+  }
+
+  /* init gstreamer */
+  gst_init (&argc, &argv);
+
+  _check_cond_err (_load_labels (g_app.opt.labels));
+  _check_cond_err (_load_images ());
+
+  g_app.decoded = g_async_queue_new ();
+  g_app.pending = g_async_queue_new ();
+  g_app.decoders = g_thread_pool_new (_decode_image, NULL, g_app.opt.threads, TRUE, NULL);
+  _check_cond_err (g_app.decoders != NULL);
+
+  /* init pipeline */
+  str_pipeline = g_strdup_printf
+      ("appsrc name=src format=time caps=video/x-raw,format=RGB,width=%u,height=%u,framerate=0/1 ! "
+      "tensor_converter ! %s%s tensor_filter framework=%s model=\"%s\" %s ! "
+      "tensor_sink name=tensor_sink sync=false",
+      g_app.opt.width, g_app.opt.height,
+      g_app.opt.transform ? g_app.opt.transform : "", g_app.opt.transform ? " !" : "",
+      g_app.opt.framework, g_app.opt.model,
+      g_app.opt.filter_options ? g_app.opt.filter_options : "");
+  _print_log ("%s\n", str_pipeline);
+
+  g_app.pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  _check_cond_err (g_app.pipeline != NULL);
+
+  g_app.bus = gst_element_get_bus (g_app.pipeline);
+  _check_cond_err (g_app.bus != NULL);
+  gst_bus_enable_sync_message_emission (g_app.bus);
+  g_signal_connect (g_app.bus, "sync-message", G_CALLBACK (_message_cb), NULL);
+
+  g_app.src = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "src");
+  _check_cond_err (g_app.src != NULL);
+
+  element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_sink");
+  _check_cond_err (element != NULL);
+  g_signal_connect (element, "new-data", G_CALLBACK (_new_data_cb), NULL);
+  gst_object_unref (element);
+
+  /* decode all images first */
+  decode_start = g_get_monotonic_time ();
+  if (g_app.opt.preload) {
+    for (i = 0; i < g_app.images->len; i++)
+      g_thread_pool_push (g_app.decoders, g_ptr_array_index (g_app.images, i), NULL);
+
+    next = decoding = g_app.images->len;
+    while ((guint) g_async_queue_length (g_app.decoded) < g_app.images->len)
+      g_usleep (1000);
+    decode_elapsed = g_get_monotonic_time () - decode_start;
+  }
+
+  gst_element_set_state (g_app.pipeline, GST_STATE_PLAYING);
+
+  /* push as fast as possible, up to the inflight images */
+  while ((image = _next_decoded (&next, &decoding)) != NULL) {
+    if (image->sample == NULL) {
+      g_warning ("Failed to decode %s", image->path);
+      g_app.failed++;
+      continue;
+    }
+
+    if (!_push_image (image))
+      break;
+  }
+
+  if (!g_app.opt.preload)
+    decode_elapsed = g_get_monotonic_time () - decode_start;
+
+  /* wait for the results */
+  g_mutex_lock (&g_app.mutex);
+  while (g_app.inflight > 0 && !g_app.error)
+    g_cond_wait (&g_app.cond, &g_app.mutex);
+  g_mutex_unlock (&g_app.mutex);
+
+  gst_app_src_end_of_stream (GST_APP_SRC (g_app.src));
+  gst_element_set_state (g_app.pipeline, GST_STATE_NULL);
+
+  if (!g_app.error)
+    _report (decode_elapsed);
+
+error:
+  if (g_app.decoders)
+    g_thread_pool_free (g_app.decoders, TRUE, TRUE);
+  if (g_app.decoded) {
+    /* decoded but not pushed (error) */
+    while (g_async_queue_try_pop (g_app.decoded) != NULL)
+      ;
+    g_async_queue_unref (g_app.decoded);
+  }
+  if (g_app.pending) {
+    while (g_async_queue_try_pop (g_app.pending) != NULL)
+      ;
+    g_async_queue_unref (g_app.pending);
+  }
+  if (g_app.src)
+    gst_object_unref (g_app.src);
+  if (g_app.bus)
+    gst_object_unref (g_app.bus);
+  if (g_app.pipeline)
+    gst_object_unref (g_app.pipeline);
+  if (g_app.images)
+    g_ptr_array_free (g_app.images, TRUE);
+  if (g_app.label_names)
+    g_hash_table_destroy (g_app.label_names);
+  g_strfreev (g_app.labels);
+  g_free (g_app.out_type);
+  _free_options (&g_app.opt);
+  g_mutex_clear (&g_app.mutex);
+  g_cond_clear (&g_app.cond);
+  return 0;
+}
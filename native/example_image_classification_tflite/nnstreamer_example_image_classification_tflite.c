@@ -25,6 +25,17 @@
  * Before running this example, GST_PLUGIN_PATH should be updated for nnstreamer plug-in.
  * $ export GST_PLUGIN_PATH=$GST_PLUGIN_PATH:<nnstreamer plugin path>
  * $ ./nnstreamer_example_image_classification_tflite
+ *
+ * Startup time :
+ * --trace-startup prints the startup phases until the first result, --parallel-init loads
+ * the labels on a worker thread while the pipeline starts (see startup_benchmark.sh).
+ * $ ./nnstreamer_example_image_classification_tflite --src=videotestsrc --headless --trace-startup --until-first-result
+ *
+ * Replay :
+ * --record=FILE records the output of tensor_filter, --replay=FILE calls the result callback
+ * with the recorded tensors without the pipeline (see tensor_record.h).
+ * $ ./nnstreamer_example_image_classification_tflite --src=videotestsrc --headless --record=mobilenet.tsrec
+ * $ ./nnstreamer_example_image_classification_tflite --replay=mobilenet.tsrec --loops=100
  */
 
 #ifndef _GNU_SOURCE
@@ -34,8 +45,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <getopt.h>
 #include <glib.h>
 #include <gst/gst.h>
+#include "startup_tracer.h"
+#include "tensor_record.h"
 
 /**
  * @brief Macro for debug mode.
@@ -85,6 +99,10 @@ typedef struct
   gint current_label_index; /**< current label index */
   gint new_label_index; /**< new label index */
   tflite_info_s tflite_info; /**< tflite model info */
+
+  StartupTracer *tracer; /**< startup phases, NULL if not traced */
+  StartupTasks *tasks; /**< loader of the labels, the result waits for it */
+  gboolean until_first_result; /**< quit when the first result arrives */
 } AppData;
 
 /**
@@ -116,10 +134,46 @@ _tflite_free_info (tflite_info_s * tflite_info)
   }
 }
 
+/**
+ * @brief Load labels.
+ */
+static gboolean
+_tflite_load_labels (gpointer user_data)
+{
+  tflite_info_s *tflite_info = (tflite_info_s *) user_data;
+  FILE *fp;
+
+  if ((fp = fopen (tflite_info->label_path, "r")) != NULL) {
+    char *line = NULL;
+    size_t len = 0;
+    ssize_t read;
+    gchar *label;
+
+    while ((read = getline (&line, &len, fp)) != -1) {
+      label = g_strdup ((gchar *) line);
+      tflite_info->labels = g_list_append (tflite_info->labels, label);
+    }
+
+    if (line) {
+      free (line);
+    }
+
+    fclose (fp);
+  } else {
+    g_critical ("cannot find tflite label [%s]", tflite_info->label_path);
+    return FALSE;
+  }
+
+  tflite_info->total_labels = g_list_length (tflite_info->labels);
+  _print_log ("finished to load labels, total %d", tflite_info->total_labels);
+  return TRUE;
+}
+
 /**
  * @brief Check tflite model and load labels.
  *
  * This example uses 'Mobilenet_1.0_224_quant' for image classification.
+ * The labels are loaded on a worker thread with --parallel-init.
  */
 static gboolean
 _tflite_init_info (tflite_info_s * tflite_info, const gchar * path)
@@ -127,8 +181,6 @@ _tflite_init_info (tflite_info_s * tflite_info, const gchar * path)
   const gchar tflite_model[] = "mobilenet_v1_1.0_224_quant.tflite";
   const gchar tflite_label[] = "labels.txt";
 
-  FILE *fp;
-
   g_return_val_if_fail (tflite_info != NULL, FALSE);
 
   tflite_info->model_path = NULL;
@@ -146,29 +198,12 @@ _tflite_init_info (tflite_info_s * tflite_info, const gchar * path)
   /* load labels */
   tflite_info->label_path = g_strdup_printf ("%s/%s", path, tflite_label);
 
-  if ((fp = fopen (tflite_info->label_path, "r")) != NULL) {
-    char *line = NULL;
-    size_t len = 0;
-    ssize_t read;
-    gchar *label;
-
-    while ((read = getline (&line, &len, fp)) != -1) {
-      label = g_strdup ((gchar *) line);
-      tflite_info->labels = g_list_append (tflite_info->labels, label);
-    }
-
-    if (line) {
-      free (line);
-    }
-
-    fclose (fp);
-  } else {
+  if (access (tflite_info->label_path, F_OK) != 0) {
     g_critical ("cannot find tflite label [%s]", tflite_info->label_path);
     return FALSE;
   }
 
-  tflite_info->total_labels = g_list_length (tflite_info->labels);
-  _print_log ("finished to load labels, total %d", tflite_info->total_labels);
+  startup_tasks_add (g_app.tasks, "labels", _tflite_load_labels, tflite_info);
   return TRUE;
 }
 
@@ -240,6 +275,13 @@ _free_app_data (void)
     g_app.pipeline = NULL;
   }
 
+  startup_tracer_free (g_app.tracer);
+  g_app.tracer = NULL;
+
+  /* wait for the loader before releasing the labels */
+  startup_tasks_free (g_app.tasks);
+  g_app.tasks = NULL;
+
   _tflite_free_info (&g_app.tflite_info);
 }
 
@@ -323,6 +365,16 @@ _message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
   }
 }
 
+/**
+ * @brief Idle callback to quit the main loop, on the main context.
+ */
+static gboolean
+_quit_loop_cb (gpointer user_data)
+{
+  g_main_loop_quit (g_app.loop);
+  return FALSE;
+}
+
 /**
  * @brief Callback for tensor sink signal.
  */
@@ -339,6 +391,10 @@ _new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
     guint i;
     guint num_mems;
 
+    /* the labels may be loaded on a worker thread */
+    if (!startup_tasks_wait (g_app.tasks))
+      return;
+
     num_mems = gst_buffer_n_memory (buffer);
     for (i = 0; i < num_mems; i++) {
       mem = gst_buffer_peek_memory (buffer, i);
@@ -350,6 +406,13 @@ _new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
         gst_memory_unmap (mem, &info);
       }
     }
+
+    /**
+     * This is the streaming thread, the first result may arrive before the main loop runs.
+     * The idle source quits the loop once it runs.
+     */
+    if (startup_tracer_first_result (g_app.tracer) && g_app.until_first_result)
+      g_idle_add (_quit_loop_cb, NULL);
   }
 }
 
@@ -406,6 +469,71 @@ _timer_update_result_cb (gpointer user_data)
   return TRUE;
 }
 
+/**
+ * @brief Call the result callback with the recorded tensors, without the pipeline.
+ */
+static gboolean
+_run_replay (const gchar * path, guint loops)
+{
+  TensorReplay *replay;
+  GstBuffer *buffer;
+  gint64 start, begin, elapsed, max_us = 0;
+  guint count, loop, i;
+  gdouble seconds;
+
+  replay = tensor_replay_open (path);
+  if (replay == NULL)
+    return FALSE;
+
+  count = tensor_replay_get_count (replay);
+  if (count == 0 || !startup_tasks_wait (g_app.tasks)) {
+    tensor_replay_free (replay);
+    return FALSE;
+  }
+
+  g_app.running = TRUE;
+  begin = g_get_monotonic_time ();
+  for (loop = 0; loop < loops; loop++) {
+    for (i = 0; i < count; i++) {
+      buffer = tensor_replay_get_buffer (replay, i);
+
+      start = g_get_monotonic_time ();
+      _new_data_cb (NULL, buffer, NULL);
+      elapsed = g_get_monotonic_time () - start;
+      max_us = MAX (max_us, elapsed);
+
+      gst_buffer_unref (buffer);
+    }
+  }
+  seconds = (g_get_monotonic_time () - begin) / (gdouble) G_USEC_PER_SEC;
+  g_app.running = FALSE;
+
+  g_print ("mode,buffers,seconds,results_per_sec,avg_us,max_us,last_label\n");
+  g_print ("replay,%u,%.3f,%.1f,%.2f,%" G_GINT64_FORMAT ",%d\n", count * loops,
+      seconds, (seconds > 0) ? count * loops / seconds : 0.0,
+      seconds * G_USEC_PER_SEC / (count * loops), max_us, g_app.new_label_index);
+
+  tensor_replay_free (replay);
+  return TRUE;
+}
+
+/**
+ * @brief Print usage info.
+ */
+static void
+_usage (void)
+{
+  g_print ("usage: nnstreamer_example_image_classification_tflite [options]\n"
+      "    --src                 Source, v4l2src, /dev/videoX or videotestsrc. (default v4l2src)\n"
+      "    --headless            Use fakesink instead of ximagesink.\n"
+      "    --trace-startup       Print the startup phases until the first result.\n"
+      "    --parallel-init       Load the labels on a worker thread while the pipeline starts.\n"
+      "    --until-first-result  Quit when the first result arrives.\n"
+      "    --record              Record the output of tensor_filter to the file.\n"
+      "    --replay              Call the result callback with the recorded file, without the pipeline.\n"
+      "    --loops               Number of times to replay the recorded file. (default 1)\n");
+}
+
 /**
  * @brief Main function.
  */
@@ -415,37 +543,124 @@ main (int argc, char **argv)
   const gchar tflite_model_path[] = "./tflite_model_img";
 
   gchar *str_pipeline;
+  gchar *src = g_strdup ("v4l2src");
+  gchar *src_desc;
+  gchar *record_path = NULL, *replay_path = NULL;
+  TensorRecorder *recorder = NULL;
+  guint loops = 1;
   gulong handle_id;
   guint timer_id = 0;
   GstElement *element;
+  gboolean headless = FALSE, trace = FALSE, parallel_init = FALSE;
+  gint64 start;
+  gint opt;
+  struct option long_options[] = {
+    {"src", required_argument, NULL, 's'},
+    {"headless", no_argument, NULL, 'l'},
+    {"trace-startup", no_argument, NULL, 'r'},
+    {"parallel-init", no_argument, NULL, 'p'},
+    {"until-first-result", no_argument, NULL, 'f'},
+    {"record", required_argument, NULL, 'w'},
+    {"replay", required_argument, NULL, 'y'},
+    {"loops", required_argument, NULL, 'o'},
+    {"help", no_argument, NULL, 'h'},
+    {0, 0, 0, 0}
+  };
 
   _print_log ("start app..");
 
+  /* created before gst_init, freed below without --trace-startup */
+  g_app.tracer = startup_tracer_new ();
+
+  /* init gstreamer */
+  start = g_get_monotonic_time ();
+  gst_init (&argc, &argv);
+  startup_tracer_span (g_app.tracer, "gst_init", start);
+
+  while ((opt = getopt_long (argc, argv, "s:lrpfw:y:o:h", long_options, NULL)) != -1) {
+    switch (opt) {
+      case 's':
+        g_free (src);
+        src = g_strdup (optarg);
+        break;
+      case 'l':
+        headless = TRUE;
+        break;
+      case 'r':
+        trace = TRUE;
+        break;
+      case 'p':
+        parallel_init = TRUE;
+        break;
+      case 'f':
+        g_app.until_first_result = TRUE;
+        break;
+      case 'w':
+        g_free (record_path);
+        record_path = g_strdup (optarg);
+        break;
+      case 'y':
+        g_free (replay_path);
+        replay_path = g_strdup (optarg);
+        break;
+      case 'o':
+        loops = MAX ((guint) g_ascii_strtoull (optarg, NULL, 10), 1U);
+        break;
+      default:
+        _usage ();
+        g_free (src);
+        g_free (record_path);
+        g_free (replay_path);
+        startup_tracer_free (g_app.tracer);
+        return 0;
+    }
+  }
+
+  if (!trace) {
+    startup_tracer_free (g_app.tracer);
+    g_app.tracer = NULL;
+  }
+
   /* init app variable */
   g_app.running = FALSE;
   g_app.received = 0;
   g_app.current_label_index = -1;
   g_app.new_label_index = -1;
+  g_app.tasks = startup_tasks_new (parallel_init, g_app.tracer);
 
+  start = g_get_monotonic_time ();
   _check_cond_err (_tflite_init_info (&g_app.tflite_info, tflite_model_path));
-
-  /* init gstreamer */
-  gst_init (&argc, &argv);
+  startup_tracer_span (g_app.tracer, "init_info", start);
 
   /* main loop */
   g_app.loop = g_main_loop_new (NULL, FALSE);
   _check_cond_err (g_app.loop != NULL);
 
+  if (replay_path) {
+    _check_cond_err (_run_replay (replay_path, loops));
+    goto error;
+  }
+
   /* init pipeline */
+  if (g_str_has_prefix (src, "/dev/"))
+    src_desc = g_strdup_printf ("v4l2src name=cam_src device=%s", src);
+  else if (g_str_equal (src, "videotestsrc"))
+    src_desc = g_strdup ("videotestsrc name=cam_src is-live=true");
+  else
+    src_desc = g_strdup_printf ("%s name=cam_src", src);
+
   str_pipeline =
       g_strdup_printf
-      ("v4l2src name=cam_src ! videoconvert ! videoscale ! "
+      ("%s ! videoconvert ! videoscale ! "
       "video/x-raw,width=640,height=480,format=RGB ! tee name=t_raw "
       "t_raw. ! queue ! textoverlay name=tensor_res font-desc=Sans,24 ! "
-      "videoconvert ! ximagesink name=img_tensor "
+      "videoconvert ! %s name=img_tensor "
       "t_raw. ! queue leaky=2 max-size-buffers=2 ! videoscale ! tensor_converter ! "
       "tensor_filter framework=tensorflow-lite model=%s ! "
-      "tensor_sink name=tensor_sink", g_app.tflite_info.model_path);
+      "tensor_sink name=tensor_sink", src_desc,
+      headless ? "fakesink sync=false" : "ximagesink",
+      g_app.tflite_info.model_path);
+  g_free (src_desc);
 
   _print_log ("%s\n", str_pipeline);
 
@@ -454,9 +669,12 @@ main (int argc, char **argv)
    * input[0] >> type:5 (uint8), dim[3:224:224:1] video stream (RGB 224x224)
    * output[0] >> type:5 (uint8), dim[1001:1] LABEL_SIZE:1
    */
+  start = g_get_monotonic_time ();
   g_app.pipeline = gst_parse_launch (str_pipeline, NULL);
+  startup_tracer_span (g_app.tracer, "parse", start);
   g_free (str_pipeline);
   _check_cond_err (g_app.pipeline != NULL);
+  startup_tracer_attach (g_app.tracer, g_app.pipeline);
 
   /* bus and message callback */
   g_app.bus = gst_element_get_bus (g_app.pipeline);
@@ -474,20 +692,30 @@ main (int argc, char **argv)
   gst_object_unref (element);
   _check_cond_err (handle_id > 0);
 
+  if (record_path) {
+    recorder = tensor_recorder_new (record_path);
+    _check_cond_err (recorder != NULL);
+    _check_cond_err (tensor_recorder_attach_element (recorder, g_app.pipeline,
+            "tensor_sink", 0));
+  }
+
   /* timer to update result */
   timer_id = g_timeout_add (500, _timer_update_result_cb, NULL);
   _check_cond_err (timer_id > 0);
 
   /* start pipeline */
+  start = g_get_monotonic_time ();
   gst_element_set_state (g_app.pipeline, GST_STATE_PLAYING);
+  startup_tracer_span (g_app.tracer, "set_state_playing", start);
 
   g_app.running = TRUE;
 
   /* set window title */
   _set_window_title ("img_tensor", "NNStreamer Example");
 
-  /* run main loop */
-  g_main_loop_run (g_app.loop);
+  /* run main loop, the labels are loaded while the pipeline starts */
+  if (startup_tasks_wait (g_app.tasks))
+    g_main_loop_run (g_app.loop);
 
   /* quit when received eos or error message */
   g_app.running = FALSE;
@@ -506,6 +734,8 @@ main (int argc, char **argv)
   g_usleep (200 * 1000);
   gst_object_unref (element);
 
+  startup_tracer_print (g_app.tracer, stdout);
+
 error:
   _print_log ("close app..");
 
@@ -513,6 +743,10 @@ error:
     g_source_remove (timer_id);
   }
 
+  tensor_recorder_free (recorder);
   _free_app_data ();
+  g_free (src);
+  g_free (record_path);
+  g_free (replay_path);
   return 0;
 }
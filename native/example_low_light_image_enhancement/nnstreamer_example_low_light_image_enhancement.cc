@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include "appsrc_feeder.h"
 
 #define IMG_HEIGHT 400
 #define IMG_WIDTH 600
@@ -34,6 +35,7 @@ typedef struct {
   GstElement *pipeline; /**< gst pipeline for data stream */
   GstBus *bus;          /**< gst bus for data pipeline */
   GstElement *src;      /**< appsrc element in pipeline */
+  AppsrcFeeder *feeder; /**< recycles the input buffers of appsrc */
 
   gchar *model_file; /**< tensorflow-lite model file */
   gchar *image_file;
@@ -162,13 +164,14 @@ static void handle_input_image(app_data_s *app) {
     gint bpp = img.channels();
     gint imagesize = width * height * bpp;
 
-    gint *buffer_array = (gint *)g_malloc(imagesize);
-    memcpy(buffer_array, img.data, imagesize);
+    GstMapInfo map;
 
-    buf = gst_buffer_new_wrapped(buffer_array, imagesize);
+    /* buffer from the pool, allocated out of the pool if the image is larger */
+    buf = appsrc_feeder_acquire(app->feeder, imagesize, &map);
     g_assert(buf);
-    g_assert(gst_app_src_push_buffer(GST_APP_SRC(app->src), buf) ==
-             GST_FLOW_OK);
+    memcpy(map.data, img.data, imagesize);
+
+    g_assert(appsrc_feeder_push(app->feeder, buf, &map) == GST_FLOW_OK);
   } else {
     g_critical("Failed to find %s", app->image_file);
   }
@@ -274,6 +277,10 @@ int main(int argc, char **argv) {
 
   gst_object_unref(element);
 
+  /* preallocated buffers for the input image */
+  app->feeder = appsrc_feeder_new(app->src, IMG_WIDTH * IMG_HEIGHT * 3, 1, 2, 64);
+  g_assert(app->feeder);
+
   /* Start playing */
   ret = gst_element_set_state(app->pipeline, GST_STATE_PLAYING);
 
@@ -298,5 +305,8 @@ int main(int argc, char **argv) {
     gst_element_set_state(app->pipeline, GST_STATE_NULL);
     gst_object_unref(app->pipeline);
   }
+  if (app->feeder) {
+    appsrc_feeder_free(app->feeder);
+  }
   return 0;
 }
@@ -0,0 +1,836 @@
+/**
+ * @file	nnstreamer_example_multi_pipeline.c
+ * @date	19 October 2026
+ * @brief	Run N model pipelines concurrently with CPU affinity, thread budget, priority and target FPS
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	HyoungJoo Ahn <hello.ahn@samsung.com>
+ * @bug		No known bugs.
+ *
+ * Portable version of Tizen.platform/Vivante_pipeline_experiments, without NPU.
+ * Each pipeline has its own source and model:
+ *   videotestsrc ! video/x-raw,format=RGB,width=W,height=H,framerate=FPS/1 ! tensor_converter !
+ *   queue (leaky with target FPS) ! tensor_filter ! tensor_sink
+ *
+ * Each pipeline is described with key=value pairs separated by ';'.
+ *   name     : name of the pipeline
+ *   model    : model file, or custom:MS for the synthetic model costing MS milliseconds of CPU per frame (solo)
+ *   framework: tensor_filter framework (default tensorflow-lite)
+ *   size     : model input WIDTHxHEIGHT (default 224x224)
+ *   cpus     : CPU affinity of the pipeline threads, e.g., 0-1,3
+ *   threads  : number of threads of tensorflow-lite (custom=NumThreads:N)
+ *   nice     : nice value of the pipeline threads
+ *   rt       : SCHED_FIFO priority of the pipeline threads (1-99), needs CAP_SYS_NICE
+ *   fps      : target FPS, 0 to run as fast as possible (default 30)
+ *
+ * The affinity and priority are applied to the streaming threads when they start (stream-status message),
+ * and to the application thread while the pipeline starts, so the threads created by the framework
+ * when the model is opened inherit them.
+ * The streaming threads may be reused by another pipeline, so a pipeline without cpus, nice or rt
+ * resets them to all CPUs, SCHED_OTHER and nice 0.
+ * Raising nice cannot be undone without CAP_SYS_NICE, so the application thread does not raise it,
+ * and the framework threads created while opening the model do not inherit a positive nice.
+ *
+ * Each pipeline runs solo first, then all pipelines run concurrently.
+ * The interference is the ratio of the concurrent result to the solo result.
+ *
+ * $ ./nnstreamer_example_multi_pipeline \
+ *     --pipeline="name=cls;model=./tflite_model_img/mobilenet_v1_1.0_224_quant.tflite;cpus=0-1;threads=2;fps=30" \
+ *     --pipeline="name=load;model=custom:20;cpus=2;nice=10;fps=0" --duration=10
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <glib.h>
+#include <gst/gst.h>
+#include <nnstreamer/tensor_filter_custom_easy.h>
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) if (DBG) g_message (__VA_ARGS__)
+
+#define MAX_PIPELINES 16
+#define STAMP_RING 64
+
+/**
+ * @brief Description of a pipeline.
+ */
+typedef struct
+{
+  gchar *name; /**< name of the pipeline */
+  gchar *model; /**< model file */
+  gchar *framework; /**< tensor_filter framework */
+  guint width; /**< model input width */
+  guint height; /**< model input height */
+  gchar *cpus; /**< CPU list, NULL for no affinity */
+  cpu_set_t cpuset; /**< parsed CPU list */
+  guint threads; /**< number of threads of the framework, 0 for default */
+  gint nice; /**< nice value */
+  gint rt; /**< SCHED_FIFO priority, 0 for SCHED_OTHER */
+  guint fps; /**< target FPS, 0 for max */
+
+  gdouble work_ms; /**< CPU time of the synthetic model */
+  guint reps; /**< calibrated repeats of the synthetic model */
+  gchar *custom_name; /**< registered name of the synthetic model */
+} PipelineSpec;
+
+/**
+ * @brief Result of a pipeline in a phase.
+ */
+typedef struct
+{
+  guint64 produced; /**< frames from the source */
+  guint64 results; /**< results from tensor_sink */
+  gdouble fps; /**< results per second */
+  gint64 p50; /**< latency p50 (us) */
+  gint64 p90; /**< latency p90 (us) */
+  gint64 p99; /**< latency p99 (us) */
+  guint threads_set; /**< streaming threads configured */
+  gboolean failed; /**< the pipeline posted an error */
+} PipelineResult;
+
+/**
+ * @brief Running pipeline.
+ */
+typedef struct
+{
+  PipelineSpec *spec; /**< description */
+  GstElement *pipeline; /**< pipeline */
+  GMutex lock; /**< lock for the stamps and counters */
+  GstClockTime stamp_pts[STAMP_RING]; /**< PTS of the produced frames */
+  gint64 stamp_time[STAMP_RING]; /**< time when the frame is produced */
+  guint stamp_idx; /**< next index of the stamp ring */
+  gint64 measure_start; /**< results before this time are ignored */
+  gboolean measuring; /**< counting produced frames and results */
+  guint64 produced; /**< frames from the source */
+  guint64 results; /**< results from tensor_sink */
+  GArray *latency; /**< latency of each result (us) */
+  gint threads_set; /**< streaming threads configured */
+} PipelineRun;
+
+/**
+ * @brief Scheduling attributes of a thread, to restore the application thread.
+ */
+typedef struct
+{
+  cpu_set_t cpuset; /**< affinity */
+  gint nice; /**< nice value */
+  gint policy; /**< scheduling policy */
+  struct sched_param param; /**< scheduling parameter */
+} ThreadAttr;
+
+/**
+ * @brief Compare function to sort latency.
+ */
+static gint
+_compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 la = *((const gint64 *) a);
+  gint64 lb = *((const gint64 *) b);
+
+  return (la > lb) ? 1 : ((la < lb) ? -1 : 0);
+}
+
+/**
+ * @brief Get the percentile from the sorted latency array.
+ */
+static gint64
+_percentile (GArray * sorted, gdouble p)
+{
+  guint idx;
+
+  if (sorted->len == 0)
+    return 0;
+
+  idx = (guint) (p / 100.0 * (sorted->len - 1) + 0.5);
+  return g_array_index (sorted, gint64, MIN (idx, sorted->len - 1));
+}
+
+/**
+ * @brief Get the thread id of the calling thread.
+ */
+static pid_t
+_gettid (void)
+{
+  return (pid_t) syscall (SYS_gettid);
+}
+
+/**
+ * @brief Apply the affinity and priority of the pipeline to the calling thread.
+ * @param app_thread TRUE for the application thread, nice is not raised.
+ */
+static void
+_apply_thread_config (PipelineSpec * spec, gboolean app_thread)
+{
+  struct sched_param param;
+  gint nice;
+
+  /* all CPUs if not given */
+  if (pthread_setaffinity_np (pthread_self (), sizeof (cpu_set_t), &spec->cpuset) != 0)
+    g_warning ("[%s] Failed to set the CPU affinity %s.", spec->name,
+        spec->cpus ? spec->cpus : "all");
+
+  memset (&param, 0, sizeof (param));
+  if (spec->rt > 0) {
+    param.sched_priority = spec->rt;
+    if (pthread_setschedparam (pthread_self (), SCHED_FIFO, &param) != 0)
+      g_warning ("[%s] Failed to set SCHED_FIFO %d, CAP_SYS_NICE is required.",
+          spec->name, spec->rt);
+    return;
+  }
+
+  if (pthread_setschedparam (pthread_self (), SCHED_OTHER, &param) != 0)
+    g_warning ("[%s] Failed to set SCHED_OTHER.", spec->name);
+
+  if (app_thread) {
+    errno = 0;
+    nice = getpriority (PRIO_PROCESS, _gettid ());
+    if (errno != 0 || spec->nice > nice)
+      return;
+  }
+
+  /* nice is per-thread in Linux */
+  if (setpriority (PRIO_PROCESS, _gettid (), spec->nice) != 0)
+    g_warning ("[%s] Failed to set nice %d.", spec->name, spec->nice);
+}
+
+/**
+ * @brief Save the scheduling attributes of the calling thread.
+ * @return FALSE if the attributes cannot be read, then they are not changed.
+ */
+static gboolean
+_save_thread_attr (ThreadAttr * attr)
+{
+  if (pthread_getaffinity_np (pthread_self (), sizeof (cpu_set_t), &attr->cpuset) != 0)
+    return FALSE;
+
+  errno = 0;
+  attr->nice = getpriority (PRIO_PROCESS, _gettid ());
+  if (errno != 0)
+    return FALSE;
+
+  return (pthread_getschedparam (pthread_self (), &attr->policy, &attr->param) == 0);
+}
+
+/**
+ * @brief Restore the scheduling attributes of the calling thread.
+ */
+static void
+_restore_thread_attr (const ThreadAttr * attr)
+{
+  if (pthread_setaffinity_np (pthread_self (), sizeof (cpu_set_t), &attr->cpuset) != 0)
+    g_warning ("Failed to restore the CPU affinity of the application thread.");
+  if (pthread_setschedparam (pthread_self (), attr->policy, &attr->param) != 0)
+    g_warning ("Failed to restore the scheduling policy of the application thread.");
+  if (setpriority (PRIO_PROCESS, _gettid (), attr->nice) != 0)
+    g_warning ("Failed to restore nice %d of the application thread.", attr->nice);
+}
+
+/**
+ * @brief Synthetic model, the same amount of computation for each frame.
+ */
+static gfloat
+_busy_work (const guint8 * data, gsize size, guint reps)
+{
+  gfloat acc = 0.0f;
+  gsize i;
+  guint r;
+
+  for (r = 0; r < reps; r++) {
+    for (i = 0; i < size; i++)
+      acc = acc * 0.999f + data[i] * 0.001f;
+  }
+
+  return acc;
+}
+
+/**
+ * @brief Invoke callback of the synthetic model.
+ */
+static int
+_busy_invoke (void *data, const GstTensorFilterProperties * prop,
+    const GstTensorMemory * in, GstTensorMemory * out)
+{
+  PipelineSpec *spec = (PipelineSpec *) data;
+
+  *((gfloat *) out[0].data) = _busy_work ((const guint8 *) in[0].data, in[0].size, spec->reps);
+  return 0;
+}
+
+/**
+ * @brief Find the repeats of the synthetic model to cost work_ms, measured on an idle system.
+ */
+static void
+_calibrate_busy_work (PipelineSpec * spec)
+{
+  gsize size = (gsize) spec->width * spec->height * 3;
+  guint8 *data = (guint8 *) g_malloc0 (size);
+  gint64 start, elapsed, best = G_MAXINT64;
+  volatile gfloat sink;
+  guint i;
+
+  for (i = 0; i < 5; i++) {
+    start = g_get_monotonic_time ();
+    sink = _busy_work (data, size, 1);
+    elapsed = g_get_monotonic_time () - start;
+    best = MIN (best, MAX (elapsed, 1));
+  }
+  (void) sink;
+
+  spec->reps = (guint) MAX (spec->work_ms * 1000.0 / best + 0.5, 1.0);
+  g_free (data);
+
+  _print_log ("[%s] %.1f ms = %u repeats", spec->name, spec->work_ms, spec->reps);
+}
+
+/**
+ * @brief Register the synthetic model of the pipeline.
+ */
+static gboolean
+_register_busy_model (PipelineSpec * spec, guint index)
+{
+  GstTensorsInfo in_info, out_info;
+  gchar *dims;
+  gint ret;
+
+  spec->custom_name = g_strdup_printf ("multi_pipeline_busy_%u", index);
+
+  dims = g_strdup_printf ("3:%u:%u:1", spec->width, spec->height);
+  gst_tensors_info_init (&in_info);
+  in_info.num_tensors = gst_tensors_info_parse_dimensions_string (&in_info, dims);
+  gst_tensors_info_parse_types_string (&in_info, "uint8");
+  g_free (dims);
+
+  gst_tensors_info_init (&out_info);
+  out_info.num_tensors = gst_tensors_info_parse_dimensions_string (&out_info, "1:1:1:1");
+  gst_tensors_info_parse_types_string (&out_info, "float32");
+
+  _calibrate_busy_work (spec);
+  ret = NNS_custom_easy_register (spec->custom_name, _busy_invoke, spec, &in_info, &out_info);
+
+  gst_tensors_info_free (&in_info);
+  gst_tensors_info_free (&out_info);
+  return (ret == 0);
+}
+
+/**
+ * @brief Parse the CPU list, e.g., 0-1,3.
+ */
+static gboolean
+_parse_cpus (const gchar * cpus, cpu_set_t * cpuset)
+{
+  gchar **ranges;
+  guint i, first, last, c;
+  gboolean ret = TRUE;
+
+  CPU_ZERO (cpuset);
+  ranges = g_strsplit (cpus, ",", -1);
+
+  for (i = 0; ranges[i] && ret; i++) {
+    if (sscanf (ranges[i], "%u-%u", &first, &last) == 2) {
+      ret = (first <= last && last < CPU_SETSIZE);
+    } else if (sscanf (ranges[i], "%u", &first) == 1) {
+      last = first;
+      ret = (first < CPU_SETSIZE);
+    } else {
+      ret = FALSE;
+    }
+
+    for (c = first; ret && c <= last; c++)
+      CPU_SET (c, cpuset);
+  }
+
+  g_strfreev (ranges);
+  return ret && CPU_COUNT (cpuset) > 0;
+}
+
+/**
+ * @brief Parse the description of a pipeline.
+ */
+static gboolean
+_parse_spec (const gchar * desc, guint index, PipelineSpec * spec)
+{
+  gchar **pairs, **kv;
+  guint i;
+  gboolean ret = TRUE;
+
+  memset (spec, 0, sizeof (PipelineSpec));
+  spec->width = spec->height = 224;
+  spec->fps = 30;
+
+  /* all CPUs unless cpus is given */
+  CPU_ZERO (&spec->cpuset);
+  for (i = 0; i < CPU_SETSIZE && (glong) i < sysconf (_SC_NPROCESSORS_CONF); i++)
+    CPU_SET (i, &spec->cpuset);
+
+  pairs = g_strsplit (desc, ";", -1);
+  for (i = 0; pairs[i] && ret; i++) {
+    kv = g_strsplit (g_strstrip (pairs[i]), "=", 2);
+
+    if (kv[0] == NULL || kv[0][0] == '\0') {
+      g_strfreev (kv);
+      continue;
+    }
+
+    if (kv[1] == NULL) {
+      ret = FALSE;
+    } else if (g_str_equal (kv[0], "name")) {
+      spec->name = g_strdup (kv[1]);
+    } else if (g_str_equal (kv[0], "model")) {
+      spec->model = g_strdup (kv[1]);
+    } else if (g_str_equal (kv[0], "framework")) {
+      spec->framework = g_strdup (kv[1]);
+    } else if (g_str_equal (kv[0], "size")) {
+      ret = (sscanf (kv[1], "%ux%u", &spec->width, &spec->height) == 2);
+    } else if (g_str_equal (kv[0], "cpus")) {
+      spec->cpus = g_strdup (kv[1]);
+      ret = _parse_cpus (kv[1], &spec->cpuset);
+    } else if (g_str_equal (kv[0], "threads")) {
+      spec->threads = (guint) g_ascii_strtoull (kv[1], NULL, 10);
+    } else if (g_str_equal (kv[0], "nice")) {
+      spec->nice = (gint) g_ascii_strtoll (kv[1], NULL, 10);
+    } else if (g_str_equal (kv[0], "rt")) {
+      spec->rt = CLAMP ((gint) g_ascii_strtoll (kv[1], NULL, 10), 0, 99);
+    } else if (g_str_equal (kv[0], "fps")) {
+      spec->fps = (guint) g_ascii_strtoull (kv[1], NULL, 10);
+    } else {
+      ret = FALSE;
+    }
+
+    if (!ret)
+      g_critical ("Invalid option '%s' in pipeline %u.", pairs[i], index);
+    g_strfreev (kv);
+  }
+  g_strfreev (pairs);
+
+  if (!ret)
+    return FALSE;
+
+  if (spec->model == NULL) {
+    g_critical ("The model of pipeline %u is not given.", index);
+    return FALSE;
+  }
+
+  if (spec->name == NULL)
+    spec->name = g_strdup_printf ("pipeline%u", index);
+
+  if (g_str_has_prefix (spec->model, "custom:")) {
+    spec->work_ms = g_ascii_strtod (spec->model + strlen ("custom:"), NULL);
+    g_free (spec->framework);
+    spec->framework = g_strdup ("custom-easy");
+    return _register_busy_model (spec, index);
+  }
+
+  if (spec->framework == NULL)
+    spec->framework = g_strdup ("tensorflow-lite");
+
+  return TRUE;
+}
+
+/**
+ * @brief Free the description of a pipeline.
+ */
+static void
+_free_spec (PipelineSpec * spec)
+{
+  if (spec->custom_name) {
+    NNS_custom_easy_unregister (spec->custom_name);
+    g_free (spec->custom_name);
+  }
+
+  g_free (spec->name);
+  g_free (spec->model);
+  g_free (spec->framework);
+  g_free (spec->cpus);
+}
+
+/**
+ * @brief Bus sync handler, configures the streaming threads of the pipeline.
+ */
+static GstBusSyncReply
+_sync_handler (GstBus * bus, GstMessage * message, gpointer user_data)
+{
+  PipelineRun *run = (PipelineRun *) user_data;
+  GstStreamStatusType type;
+  GstElement *owner;
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_STREAM_STATUS:
+      gst_message_parse_stream_status (message, &type, &owner);
+
+      /* posted from the new streaming thread */
+      if (type == GST_STREAM_STATUS_TYPE_ENTER) {
+        _apply_thread_config (run->spec, FALSE);
+        g_atomic_int_inc (&run->threads_set);
+      }
+      return GST_BUS_DROP;
+    case GST_MESSAGE_ERROR:
+    case GST_MESSAGE_EOS:
+      return GST_BUS_PASS;
+    default:
+      return GST_BUS_DROP;
+  }
+}
+
+/**
+ * @brief Pad probe of the source, records the time when a frame is produced.
+ */
+static GstPadProbeReturn
+_src_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  PipelineRun *run = (PipelineRun *) user_data;
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  gint64 now = g_get_monotonic_time ();
+
+  g_mutex_lock (&run->lock);
+  run->stamp_pts[run->stamp_idx] = GST_BUFFER_PTS (buffer);
+  run->stamp_time[run->stamp_idx] = now;
+  run->stamp_idx = (run->stamp_idx + 1) % STAMP_RING;
+  if (run->measuring)
+    run->produced++;
+  g_mutex_unlock (&run->lock);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Callback for tensor sink signal.
+ */
+static void
+_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  PipelineRun *run = (PipelineRun *) user_data;
+  GstClockTime pts = GST_BUFFER_PTS (buffer);
+  gint64 now = g_get_monotonic_time ();
+  gint64 latency;
+  guint i;
+
+  g_mutex_lock (&run->lock);
+  if (run->measuring) {
+    run->results++;
+
+    for (i = 0; i < STAMP_RING; i++) {
+      if (run->stamp_pts[i] == pts && run->stamp_time[i] >= run->measure_start) {
+        latency = now - run->stamp_time[i];
+        g_array_append_val (run->latency, latency);
+        break;
+      }
+    }
+  }
+  g_mutex_unlock (&run->lock);
+}
+
+/**
+ * @brief Get the pipeline description.
+ */
+static gchar *
+_get_pipeline_desc (PipelineSpec * spec)
+{
+  gchar *filter, *desc;
+
+  if (spec->custom_name) {
+    filter = g_strdup_printf ("tensor_filter framework=custom-easy model=%s", spec->custom_name);
+  } else if (spec->threads > 0 && g_str_has_prefix (spec->framework, "tensorflow")) {
+    filter = g_strdup_printf ("tensor_filter framework=%s model=%s custom=NumThreads:%u",
+        spec->framework, spec->model, spec->threads);
+  } else {
+    filter = g_strdup_printf ("tensor_filter framework=%s model=%s",
+        spec->framework, spec->model);
+  }
+
+  /* with target FPS, drop the old frame if the model is slower than the source */
+  desc = g_strdup_printf ("videotestsrc name=src is-live=%s pattern=ball ! "
+      "video/x-raw,format=RGB,width=%u,height=%u,framerate=%u/1 ! tensor_converter ! "
+      "queue max-size-buffers=2 %s ! %s ! tensor_sink name=sink sync=false",
+      spec->fps > 0 ? "true" : "false", spec->width, spec->height,
+      spec->fps > 0 ? spec->fps : 1000, spec->fps > 0 ? "leaky=2" : "",
+      filter);
+  g_free (filter);
+
+  return desc;
+}
+
+/**
+ * @brief Create and start the pipeline.
+ */
+static gboolean
+_start_pipeline (PipelineRun * run)
+{
+  GstElement *element;
+  GstBus *bus;
+  GstPad *pad;
+  ThreadAttr attr;
+  gboolean saved;
+  gchar *desc;
+  GstStateChangeReturn ret;
+
+  desc = _get_pipeline_desc (run->spec);
+  _print_log ("[%s] %s", run->spec->name, desc);
+
+  run->pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
+
+  if (run->pipeline == NULL) {
+    g_critical ("[%s] Failed to create the pipeline.", run->spec->name);
+    return FALSE;
+  }
+
+  bus = gst_element_get_bus (run->pipeline);
+  gst_bus_set_sync_handler (bus, _sync_handler, run, NULL);
+  gst_object_unref (bus);
+
+  element = gst_bin_get_by_name (GST_BIN (run->pipeline), "src");
+  pad = gst_element_get_static_pad (element, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, _src_probe_cb, run, NULL);
+  gst_object_unref (pad);
+  gst_object_unref (element);
+
+  element = gst_bin_get_by_name (GST_BIN (run->pipeline), "sink");
+  g_signal_connect (element, "new-data", G_CALLBACK (_new_data_cb), run);
+  gst_object_unref (element);
+
+  /* the threads created while opening the model inherit the attributes of this thread */
+  saved = _save_thread_attr (&attr);
+  if (saved)
+    _apply_thread_config (run->spec, TRUE);
+
+  gst_element_set_state (run->pipeline, GST_STATE_PLAYING);
+  ret = gst_element_get_state (run->pipeline, NULL, NULL, 10 * GST_SECOND);
+
+  if (saved)
+    _restore_thread_attr (&attr);
+
+  if (ret == GST_STATE_CHANGE_FAILURE) {
+    g_critical ("[%s] Failed to start the pipeline.", run->spec->name);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Stop the pipeline and get the result.
+ * @param elapsed measured time, the measurement is stopped before.
+ */
+static void
+_stop_pipeline (PipelineRun * run, gint64 elapsed, PipelineResult * result)
+{
+  GstBus *bus;
+  GstMessage *msg;
+  GError *error = NULL;
+
+  memset (result, 0, sizeof (PipelineResult));
+
+  if (run->pipeline) {
+    bus = gst_element_get_bus (run->pipeline);
+    msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR);
+    if (msg) {
+      gst_message_parse_error (msg, &error, NULL);
+      g_critical ("[%s] %s", run->spec->name, error ? error->message : "error");
+      g_clear_error (&error);
+      gst_message_unref (msg);
+      result->failed = TRUE;
+    }
+    gst_object_unref (bus);
+
+    gst_element_set_state (run->pipeline, GST_STATE_NULL);
+    gst_object_unref (run->pipeline);
+    run->pipeline = NULL;
+  } else {
+    result->failed = TRUE;
+  }
+
+  g_array_sort (run->latency, _compare_latency);
+  result->produced = run->produced;
+  result->results = run->results;
+  result->fps = elapsed > 0 ? run->results * (gdouble) G_USEC_PER_SEC / elapsed : 0.0;
+  result->p50 = _percentile (run->latency, 50.0);
+  result->p90 = _percentile (run->latency, 90.0);
+  result->p99 = _percentile (run->latency, 99.0);
+  result->threads_set = (guint) g_atomic_int_get (&run->threads_set);
+}
+
+/**
+ * @brief Run the pipelines at once and get the result of each pipeline.
+ */
+static void
+_run_phase (PipelineSpec ** specs, guint n, guint warmup, guint duration,
+    PipelineResult * results)
+{
+  PipelineRun runs[MAX_PIPELINES];
+  gint64 start, end;
+  guint i;
+
+  memset (runs, 0, sizeof (runs));
+
+  for (i = 0; i < n; i++) {
+    runs[i].spec = specs[i];
+    runs[i].latency = g_array_new (FALSE, FALSE, sizeof (gint64));
+    g_mutex_init (&runs[i].lock);
+
+    if (!_start_pipeline (&runs[i]) && runs[i].pipeline) {
+      gst_element_set_state (runs[i].pipeline, GST_STATE_NULL);
+      gst_object_unref (runs[i].pipeline);
+      runs[i].pipeline = NULL;
+    }
+  }
+
+  g_usleep (warmup * G_USEC_PER_SEC);
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < n; i++) {
+    g_mutex_lock (&runs[i].lock);
+    runs[i].measure_start = start;
+    runs[i].measuring = TRUE;
+    g_mutex_unlock (&runs[i].lock);
+  }
+
+  g_usleep (duration * G_USEC_PER_SEC);
+
+  /* stop measuring all pipelines at once, stopping a pipeline takes time */
+  end = g_get_monotonic_time ();
+  for (i = 0; i < n; i++) {
+    g_mutex_lock (&runs[i].lock);
+    runs[i].measuring = FALSE;
+    g_mutex_unlock (&runs[i].lock);
+  }
+
+  for (i = 0; i < n; i++)
+    _stop_pipeline (&runs[i], end - start, &results[i]);
+
+  for (i = 0; i < n; i++) {
+    g_array_free (runs[i].latency, TRUE);
+    g_mutex_clear (&runs[i].lock);
+  }
+}
+
+/**
+ * @brief Print the result of a pipeline.
+ */
+static void
+_print_result (const gchar * phase, PipelineSpec * spec, PipelineResult * result,
+    PipelineResult * solo)
+{
+  g_print ("%s,%s,%s,%s,%u,%d,%d,%u,%" G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT
+      ",%.2f,%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%u,%.3f,%.3f%s\n",
+      phase, spec->name, spec->framework, spec->cpus ? spec->cpus : "all",
+      spec->threads, spec->nice, spec->rt, spec->fps, result->produced,
+      result->results, result->fps, result->p50, result->p90, result->p99,
+      result->threads_set,
+      (solo && solo->fps > 0) ? result->fps / solo->fps : 1.0,
+      (solo && solo->p50 > 0) ? result->p50 / (gdouble) solo->p50 : 1.0,
+      result->failed ? ",failed" : "");
+}
+
+/**
+ * @brief Print usage info.
+ */
+static void
+_usage (void)
+{
+  g_print ("usage: nnstreamer_example_multi_pipeline [options]\n"
+      "    --pipeline  Description of a pipeline, key=value pairs separated by ';', repeat for N pipelines.\n"
+      "                keys: name, model (file or custom:MS), framework, size, cpus, threads, nice, rt, fps\n"
+      "    --duration  Seconds to measure in each phase. (default 10)\n"
+      "    --warmup    Seconds before measuring. (default 2)\n"
+      "    --no-solo   Skip the solo runs.\n");
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  PipelineSpec specs[MAX_PIPELINES];
+  PipelineSpec *list[MAX_PIPELINES];
+  PipelineResult solo[MAX_PIPELINES], concurrent[MAX_PIPELINES];
+  const gchar *descs[MAX_PIPELINES];
+  guint n = 0, parsed = 0, i;
+  guint duration = 10, warmup = 2;
+  gboolean run_solo = TRUE;
+  gint o;
+  struct option long_options[] = {
+    {"pipeline", required_argument, NULL, 'p'},
+    {"duration", required_argument, NULL, 'd'},
+    {"warmup", required_argument, NULL, 'w'},
+    {"no-solo", no_argument, NULL, 's'},
+    {"help", no_argument, NULL, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  while ((o = getopt_long (argc, argv, "p:d:w:sh", long_options, NULL)) != -1) {
+    switch (o) {
+      case 'p':
+        if (n < MAX_PIPELINES)
+          descs[n++] = optarg;
+        break;
+      case 'd':
+        duration = MAX ((guint) g_ascii_strtoull (optarg, NULL, 10), 1U);
+        break;
+      case 'w':
+        warmup = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 's':
+        run_solo = FALSE;
+        break;
+      default:
+        _usage ();
+        return 0;
+    }
+  }
+
+  /* default: the image classification model and two synthetic loads */
+  if (n == 0) {
+    descs[n++] = "name=cls;model=./tflite_model_img/mobilenet_v1_1.0_224_quant.tflite;fps=30";
+    descs[n++] = "name=load1;model=custom:20;fps=30";
+    descs[n++] = "name=load2;model=custom:20;fps=0";
+  }
+
+  /* init gstreamer */
+  gst_init (&argc, &argv);
+
+  for (parsed = 0; parsed < n; parsed++) {
+    if (!_parse_spec (descs[parsed], parsed, &specs[parsed])) {
+      _free_spec (&specs[parsed]);
+      goto done;
+    }
+    list[parsed] = &specs[parsed];
+  }
+
+  g_print ("phase,name,framework,cpus,threads,nice,rt,target_fps,produced,results,fps,"
+      "lat_p50_us,lat_p90_us,lat_p99_us,threads_configured,fps_vs_solo,p50_vs_solo\n");
+
+  if (run_solo) {
+    for (i = 0; i < n; i++) {
+      _run_phase (&list[i], 1, warmup, duration, &solo[i]);
+      _print_result ("solo", list[i], &solo[i], NULL);
+    }
+  }
+
+  _run_phase (list, n, warmup, duration, concurrent);
+  for (i = 0; i < n; i++)
+    _print_result ("concurrent", list[i], &concurrent[i], run_solo ? &solo[i] : NULL);
+
+done:
+  for (i = 0; i < parsed; i++)
+    _free_spec (&specs[i]);
+  return 0;
+}
@@ -11,6 +11,7 @@
 #include <glib.h>
 #include <gst/gst.h>
 #include <gst/app/app.h>
+#include "appsrc_feeder.h"
 
 #define VIDEO_WIDTH 640
 #define VIDEO_HEIGHT 480
@@ -52,6 +53,7 @@ typedef struct
   GstElement *pipeline; /**< gst pipeline for data stream */
   GstBus *bus; /**< gst bus for data pipeline */
   GstElement *src; /**< appsrc element in pipeline */
+  AppsrcFeeder *feeder; /**< recycles the input buffers of appsrc */
 
   gchar *model_file; /**< tensorflow-lite model file */
 } app_data_s;
@@ -160,20 +162,17 @@ static void
 handle_input_string (app_data_s * app)
 {
   GstBuffer *buf;
-  guint8 *float_array;
+  GstMapInfo map;
 
-  float_array = g_new0 (guint8, sizeof (guint8) * VIDEO_WIDTH * VIDEO_HEIGHT * CH);
-  g_assert (float_array);
-
-  buf =
-      gst_buffer_new_wrapped (float_array,
-      sizeof (guint8) * VIDEO_WIDTH * VIDEO_HEIGHT * CH);
+  /* buffer from the pool, clear it to push an empty frame */
+  buf = appsrc_feeder_acquire (app->feeder,
+      sizeof (guint8) * VIDEO_WIDTH * VIDEO_HEIGHT * CH, &map);
   g_assert (buf);
+  memset (map.data, 0, map.size);
 
   printf("buffer_n_memory: %d\n", gst_buffer_n_memory (buf));
 
-  g_assert (gst_app_src_push_buffer (GST_APP_SRC (app->src),
-          buf) == GST_FLOW_OK);
+  g_assert (appsrc_feeder_push (app->feeder, buf, &map) == GST_FLOW_OK);
   start_time = g_get_real_time ();
 }
 
@@ -273,6 +272,11 @@ main (int argc, char **argv)
   gst_caps_unref (caps);
   gst_object_unref (element);
 
+  /* preallocated buffers for the input frame */
+  app->feeder = appsrc_feeder_new (app->src,
+      sizeof (guint8) * VIDEO_WIDTH * VIDEO_HEIGHT * CH, 2, 4, 64);
+  g_assert (app->feeder);
+
   /* Start playing */
   gst_element_set_state (app->pipeline, GST_STATE_PLAYING);
   g_usleep(1000);
@@ -288,6 +292,7 @@ main (int argc, char **argv)
   _print_log ("Average Latency: %" G_GINT64_FORMAT, avg_time / TEST_LOOP);
   /* stop the pipeline */
   gst_element_set_state (app->pipeline, GST_STATE_NULL);
+  appsrc_feeder_free (app->feeder);
 
   /* close app */
   gst_bus_remove_signal_watch (app->bus);
@@ -0,0 +1,23 @@
+#!/usr/bin/env bash
+# Compare N sources with one batched model instance (batch) and a model instance for each source (independent).
+# usage: ./ncam_benchmark.sh [CAMS] [SECONDS] [SRC] [MODEL]
+# MODEL is the model with a batch of CAMS for batch mode, the default model has a batch of 1.
+CAMS=${1:-4}
+SECONDS_RUN=${2:-30}
+SRC=${3:-videotestsrc}
+MODEL=${4:+--model=$4}
+APP=./nnstreamer_example_object_detection_tflite_2cam
+
+BATCH=$($APP batch --cams=$CAMS --seconds=$SECONDS_RUN --src=$SRC $MODEL --headless | tail -n 1)
+INDEP=$($APP independent --cams=$CAMS --seconds=$SECONDS_RUN --src=$SRC --headless | tail -n 1)
+
+echo "mode,cams,seconds,frames,aggregate_fps,min_cam_fps,rss_mb,peak_rss_mb"
+echo "$BATCH"
+echo "$INDEP"
+
+# memory saved and fps ratio of batch compared to independent
+echo "$BATCH" "$INDEP" | awk -F'[ ,]' '{
+  printf "memory saved (rss): %.1f MB, memory saved (peak): %.1f MB\n", $15 - $7, $16 - $8;
+  if ($13 > 0)
+    printf "aggregate fps: batch %.2f, independent %.2f (x%.2f)\n", $5, $13, $5 / $13;
+}'
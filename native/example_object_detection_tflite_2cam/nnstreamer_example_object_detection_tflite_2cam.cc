@@ -18,6 +18,28 @@
  * $ ./nnstreamer_example_object_detection_tflite_2cam sender   IP PORT1 /dev/video0 PORT2 /dev/video1
  * $ ./nnstreamer_example_object_detection_tflite_2cam receiver IP PORT1 PORT2
  *
+ * BATCH: N sources in one pipeline, frames are merged into a batch tensor [3:300:300:N]
+ * and a single tensor_filter (one model instance) detects objects of all sources.
+ * The result is split per source and drawn on each overlay.
+ * INDEPENDENT: N sources in one pipeline, a tensor_filter for each source (baseline of BATCH).
+ * $ ./nnstreamer_example_object_detection_tflite_2cam batch --cams=4 --src=videotestsrc --seconds=30 --headless
+ * $ ./nnstreamer_example_object_detection_tflite_2cam independent --cams=4 --src=videotestsrc --seconds=30 --headless
+ * --src is a comma-separated list of videotestsrc, /dev/videoX or file:PATH, repeated for N sources.
+ * A camera cannot be opened twice, so each /dev/videoX is given once.
+ * ssd_mobilenet_v2_coco.tflite has a fixed batch of 1, BATCH with N > 1 needs a model exported
+ * with a batch of N (--model), the run stops if the result is not a batch of N.
+ * $ ./nnstreamer_example_object_detection_tflite_2cam batch --cams=4 --model=./ssd_mobilenet_v2_coco_batch4.tflite --headless
+ * Both print a CSV row with the aggregate FPS and memory (see ncam_benchmark.sh to compare).
+ * --trace-startup prints the startup phases until the first result, --parallel-init loads
+ * labels and box priors on worker threads while the pipeline starts (see startup_benchmark.sh).
+ * $ ./nnstreamer_example_object_detection_tflite_2cam batch --cams=1 --headless --trace-startup --parallel-init --until-first-result
+ *
+ * REPLAY: --record=FILE records the output of tensor_filter (BATCH and INDEPENDENT, the first source),
+ * replay calls the result callback with the recorded tensors without the pipeline, to benchmark
+ * the decoding and NMS alone with the same input on any machine.
+ * $ ./nnstreamer_example_object_detection_tflite_2cam batch --cams=2 --headless --seconds=10 --record=ssd.tsrec
+ * $ ./nnstreamer_example_object_detection_tflite_2cam replay --input=ssd.tsrec --loops=10
+ *
  * Required model and resources are stored at below link
  * https://github.com/nnsuite/testcases/tree/master/DeepLearningModels/tensorflow-lite/ssd_mobilenet_v2_coco
  */
@@ -39,10 +61,15 @@
 #include <fstream>
 #include <algorithm>
 
+#include <getopt.h>
 #include <math.h>
 #include <cairo.h>
 #include <cairo-gobject.h>
 
+#include "box_priors.h"
+#include "startup_tracer.h"
+#include "tensor_record.h"
+
 /**
  * @brief Macro for debug mode.
  */
@@ -109,8 +136,9 @@ typedef struct
   gchar *model_path; /**< tflite model file path */
   gchar *label_path; /**< label file path */
   gchar *box_prior_path; /**< box prior file path */
-  gfloat box_priors[BOX_SIZE][DETECTION_MAX]; /**< box prior */
+  BoxPriors box_priors; /**< box prior, rows of ycenter, xcenter, h and w */
   GList *labels; /**< list of loaded labels */
+  StartupTasks *tasks; /**< loaders of labels and box priors, the results wait for them */
 } TFLiteModelInfo;
 
 /**
@@ -124,8 +152,10 @@ typedef struct
   gboolean running; /**< true when app is running */
   GMutex mutex; /**< mutex for processing */
   TFLiteModelInfo tflite_info; /**< tflite model info */
+  TFLiteModelInfo *model; /**< model info in use, shared by cameras in batch mode */
   CairoOverlayState overlay_state;
   std::vector<DetectedObject> detected_objects;
+  guint64 frames; /**< number of results */
 } AppData;
 
 /**
@@ -134,8 +164,30 @@ typedef struct
  */
 #define SENDER 1
 #define RECEIVER 2
+#define BATCH 3
+#define INDEPENDENT 4
+#define REPLAY 5
 static int tcp_sr = SENDER;
 
+/**
+ * @brief Data structure for N sources in one pipeline (BATCH and INDEPENDENT).
+ */
+typedef struct
+{
+  GMainLoop *loop; /**< main event loop */
+  GstElement *pipeline; /**< gst pipeline for all sources */
+  GstBus *bus; /**< gst bus for data pipeline */
+  TFLiteModelInfo tflite_info; /**< tflite model info, shared by all sources */
+  std::vector<AppData *> cams; /**< per-source result and overlay */
+  GMutex lock; /**< lock for the result time, the results arrive on the streaming threads */
+  gint64 first_result; /**< time of the first result, excludes model loading */
+  gint64 last_result; /**< time of the last result */
+  gsize rss_kb; /**< VmRSS when the first result arrived */
+  gint invalid; /**< set when the result is not a batch of the sources */
+  StartupTracer *tracer; /**< startup phases, NULL if not traced */
+  gboolean until_first_result; /**< quit when the first result arrives */
+} NCamData;
+
 /**
  * @brief Read strings from file.
  */
@@ -162,39 +214,15 @@ read_lines (const gchar * file_name, GList ** lines)
 static gboolean
 tflite_load_box_priors (TFLiteModelInfo * tflite_info)
 {
-  GList *box_priors = NULL;
-  gchar *box_row;
-
   g_return_val_if_fail (tflite_info != NULL, FALSE);
-  g_return_val_if_fail (read_lines (tflite_info->box_prior_path, &box_priors),
-      FALSE);
-
-  for (int row = 0; row < BOX_SIZE; row++) {
-    int column = 0;
-    int i = 0, j = 0;
-    char buff[11];
-
-    memset (buff, 0, 11);
-    box_row = (gchar *) g_list_nth_data (box_priors, row);
-
-    while ((box_row[i] != '\n') && (box_row[i] != '\0')) {
-      if (box_row[i] != ' ') {
-        buff[j] = box_row[i];
-        j++;
-      } else {
-        if (j != 0) {
-          tflite_info->box_priors[row][column++] = atof (buff);
-          memset (buff, 0, 11);
-        }
-        j = 0;
-      }
-      i++;
-    }
 
-    tflite_info->box_priors[row][column++] = atof (buff);
+  /* parsed once, the next start maps the cache (box_priors.txt.bin) */
+  if (!box_priors_load (&tflite_info->box_priors, tflite_info->box_prior_path,
+          BOX_SIZE, DETECTION_MAX)) {
+    _print_log ("Failed to load box priors %s", tflite_info->box_prior_path);
+    return FALSE;
   }
 
-  g_list_free_full (box_priors, g_free);
   return TRUE;
 }
 
@@ -211,9 +239,11 @@ tflite_load_labels (TFLiteModelInfo * tflite_info)
 
 /**
  * @brief Check tflite model and load labels.
+ * @param tasks loaders of labels and box priors, NULL to load them here
  */
 static gboolean
-tflite_init_info (TFLiteModelInfo * tflite_info, const gchar * path)
+tflite_init_info (TFLiteModelInfo * tflite_info, const gchar * path,
+    StartupTasks * tasks)
 {
   const gchar tflite_model[] = "ssd_mobilenet_v2_coco.tflite";
   const gchar tflite_label[] = "coco_labels_list.txt";
@@ -227,6 +257,8 @@ tflite_init_info (TFLiteModelInfo * tflite_info, const gchar * path)
       g_strdup_printf ("%s/%s", path, tflite_box_priors);
 
   tflite_info->labels = NULL;
+  memset (&tflite_info->box_priors, 0, sizeof (BoxPriors));
+  tflite_info->tasks = tasks;
 
   if (!g_file_test (tflite_info->model_path, G_FILE_TEST_IS_REGULAR)) {
     g_critical ("cannot find tflite model [%s]", tflite_info->model_path);
@@ -241,6 +273,15 @@ tflite_init_info (TFLiteModelInfo * tflite_info, const gchar * path)
     return FALSE;
   }
 
+  if (tasks) {
+    /* on worker threads with --parallel-init, while the pipeline starts */
+    startup_tasks_add (tasks, "box_priors",
+        (StartupTaskFunc) tflite_load_box_priors, tflite_info);
+    startup_tasks_add (tasks, "labels",
+        (StartupTaskFunc) tflite_load_labels, tflite_info);
+    return TRUE;
+  }
+
   g_return_val_if_fail (tflite_load_box_priors (tflite_info), FALSE);
   g_return_val_if_fail (tflite_load_labels (tflite_info), FALSE);
 
@@ -255,6 +296,10 @@ tflite_free_info (TFLiteModelInfo * tflite_info)
 {
   g_return_if_fail (tflite_info != NULL);
 
+  /* wait for the loaders before releasing the data */
+  startup_tasks_free (tflite_info->tasks);
+  tflite_info->tasks = NULL;
+
   if (tflite_info->model_path) {
     g_free (tflite_info->model_path);
     tflite_info->model_path = NULL;
@@ -274,6 +319,8 @@ tflite_free_info (TFLiteModelInfo * tflite_info)
     g_list_free_full (tflite_info->labels, g_free);
     tflite_info->labels = NULL;
   }
+
+  box_priors_clear (&tflite_info->box_priors);
 }
 
 /**
@@ -448,10 +495,11 @@ nms (std::vector<DetectedObject> &detected, AppData* app)
     if (!del[i]) {
       app->detected_objects.push_back (detected[i]);
 
-      if (DBG) {
+      /* the replay measures the decoding and NMS, the log would dominate the time */
+      if (DBG && tcp_sr != REPLAY) {
         _print_log ("==============================");
         _print_log ("Label           : %s",
-            (gchar *) g_list_nth_data (app->tflite_info.labels,
+            (gchar *) g_list_nth_data (app->model->labels,
                 detected[i].class_id));
         _print_log ("x               : %d", detected[i].x);
         _print_log ("y               : %d", detected[i].y);
@@ -477,17 +525,13 @@ get_detected_objects (gfloat * detections, gfloat * boxes, AppData* app)
   const float threshold_score = .5f;
   std::vector<DetectedObject> detected;
 
+  const gfloat *const *priors = app->model->box_priors.row;
+
   for (int d = 0; d < DETECTION_MAX; d++) {
-    float ycenter =
-        boxes[0] / Y_SCALE * app->tflite_info.box_priors[2][d] +
-        app->tflite_info.box_priors[0][d];
-    float xcenter =
-        boxes[1] / X_SCALE * app->tflite_info.box_priors[3][d] +
-        app->tflite_info.box_priors[1][d];
-    float h =
-        (float) expf (boxes[2] / H_SCALE) * app->tflite_info.box_priors[2][d];
-    float w =
-        (float) expf (boxes[3] / W_SCALE) * app->tflite_info.box_priors[3][d];
+    float ycenter = boxes[0] / Y_SCALE * priors[2][d] + priors[0][d];
+    float xcenter = boxes[1] / X_SCALE * priors[3][d] + priors[1][d];
+    float h = (float) expf (boxes[2] / H_SCALE) * priors[2][d];
+    float w = (float) expf (boxes[3] / W_SCALE) * priors[3][d];
 
     float ymin = ycenter - h / 2.f;
     float xmin = xcenter - w / 2.f;
@@ -541,7 +585,11 @@ new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
   GstMapInfo info_boxes, info_detections;
   gfloat *boxes, *detections;
 
-  g_return_if_fail (app->running);
+  g_return_if_fail (g_atomic_int_get (&app->running));
+
+  /* labels and box priors may be loaded on worker threads */
+  if (!startup_tasks_wait (app->model->tasks))
+    return;
 
   /**
    * tensor type is float32.
@@ -563,6 +611,7 @@ new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
   detections = (gfloat *) info_detections.data;
 
   get_detected_objects (detections, boxes, app);
+  app->frames++;
 
   gst_memory_unmap (mem_boxes, &info_boxes);
   gst_memory_unmap (mem_detections, &info_detections);
@@ -625,7 +674,7 @@ draw_overlay_cb (GstElement * overlay, cairo_t * cr, guint64 timestamp,
   guint drawed = 0;
 
   g_return_if_fail (state->valid);
-  g_return_if_fail (app->running);
+  g_return_if_fail (g_atomic_int_get (&app->running));
 
   std::vector<DetectedObject> detected;
   std::vector<DetectedObject>::iterator iter;
@@ -641,7 +690,7 @@ draw_overlay_cb (GstElement * overlay, cairo_t * cr, guint64 timestamp,
 
   for (iter = detected.begin (); iter != detected.end (); ++iter) {
     label =
-        (gchar *) g_list_nth_data (app->tflite_info.labels, iter->class_id);
+        (gchar *) g_list_nth_data (app->model->labels, iter->class_id);
 
     x = iter->x * VIDEO_WIDTH / MODEL_WIDTH;
     y = iter->y * VIDEO_HEIGHT / MODEL_HEIGHT;
@@ -728,10 +777,687 @@ init_app_variable (AppData* app)
   app->bus = NULL;
   app->pipeline = NULL;
   app->detected_objects.clear ();
+  app->model = &(app->tflite_info);
+  app->frames = 0;
+  memset (&(app->overlay_state), 0, sizeof (CairoOverlayState));
+  memset (&(app->tflite_info), 0, sizeof (TFLiteModelInfo));
 
   g_mutex_init (&(app->mutex));
 }
 
+/**
+ * @brief Read a value (kB) from /proc/self/status, e.g., VmRSS.
+ */
+static gsize
+read_proc_status_kb (const gchar * key)
+{
+  gchar *contents = NULL;
+  gchar **lines;
+  gsize value = 0;
+  guint i;
+
+  if (!g_file_get_contents ("/proc/self/status", &contents, NULL, NULL))
+    return 0;
+
+  lines = g_strsplit (contents, "\n", -1);
+  for (i = 0; lines[i]; i++) {
+    if (g_str_has_prefix (lines[i], key) && lines[i][strlen (key)] == ':') {
+      value = (gsize) g_ascii_strtoull (lines[i] + strlen (key) + 1, NULL, 10);
+      break;
+    }
+  }
+
+  g_strfreev (lines);
+  g_free (contents);
+  return value;
+}
+
+/**
+ * @brief Idle callback to quit the main loop, the streaming threads add it.
+ */
+static gboolean
+ncam_quit_cb (gpointer user_data)
+{
+  NCamData *ncam = (NCamData *) user_data;
+
+  g_main_loop_quit (ncam->loop);
+  return FALSE;
+}
+
+/**
+ * @brief Callback for tensor sink signal (BATCH), split the result per source.
+ */
+static void
+batch_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  NCamData *ncam = (NCamData *) user_data;
+  GstMemory *mem_boxes, *mem_detections;
+  GstMapInfo info_boxes, info_detections;
+  gfloat *boxes, *detections;
+  gsize num = ncam->cams.size ();
+  gsize i;
+
+  /**
+   * tensor type is float32.
+   * [0] dim of boxes > BOX_SIZE : 1 : DETECTION_MAX : N
+   * [1] dim of labels > LABEL_SIZE : DETECTION_MAX : N
+   */
+  g_return_if_fail (gst_buffer_n_memory (buffer) == 2);
+
+  if (!startup_tasks_wait (ncam->tflite_info.tasks))
+    return;
+
+  mem_boxes = gst_buffer_peek_memory (buffer, 0);
+  mem_detections = gst_buffer_peek_memory (buffer, 1);
+  if (!gst_memory_map (mem_boxes, &info_boxes, GST_MAP_READ))
+    return;
+  if (!gst_memory_map (mem_detections, &info_detections, GST_MAP_READ)) {
+    gst_memory_unmap (mem_boxes, &info_boxes);
+    return;
+  }
+
+  if (info_boxes.size == num * BOX_SIZE * DETECTION_MAX * 4 &&
+      info_detections.size == num * LABEL_SIZE * DETECTION_MAX * 4) {
+    boxes = (gfloat *) info_boxes.data;
+    detections = (gfloat *) info_detections.data;
+
+    for (i = 0; i < num; i++) {
+      if (!g_atomic_int_get (&ncam->cams[i]->running))
+        continue;
+
+      get_detected_objects (detections + i * LABEL_SIZE * DETECTION_MAX,
+          boxes + i * BOX_SIZE * DETECTION_MAX, ncam->cams[i]);
+      ncam->cams[i]->frames++;
+    }
+  } else if (g_atomic_int_compare_and_exchange (&ncam->invalid, 0, 1)) {
+    /* the model did not resize the batch, e.g., a model with a fixed batch of 1 */
+    g_critical ("Invalid result size, boxes %zd detections %zd, the model should have a batch of %zd",
+        info_boxes.size, info_detections.size, num);
+    g_idle_add (ncam_quit_cb, ncam);
+  }
+
+  gst_memory_unmap (mem_boxes, &info_boxes);
+  gst_memory_unmap (mem_detections, &info_detections);
+}
+
+/**
+ * @brief Callback for tensor sink signal, track the time of the results.
+ */
+static void
+ncam_result_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  NCamData *ncam = (NCamData *) user_data;
+  gint64 now = g_get_monotonic_time ();
+
+  g_mutex_lock (&ncam->lock);
+  if (ncam->first_result == 0) {
+    ncam->first_result = now;
+    ncam->rss_kb = read_proc_status_kb ("VmRSS");
+  }
+  ncam->last_result = now;
+  g_mutex_unlock (&ncam->lock);
+
+  /* the first result may arrive before the main loop runs, quit on the main context */
+  if (startup_tracer_first_result (ncam->tracer) && ncam->until_first_result)
+    g_idle_add (ncam_quit_cb, ncam);
+}
+
+/**
+ * @brief Callback for message (BATCH and INDEPENDENT).
+ */
+static void
+ncam_bus_message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
+{
+  NCamData *ncam = (NCamData *) user_data;
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_EOS:
+      _print_log ("received eos message");
+      g_main_loop_quit (ncam->loop);
+      break;
+
+    case GST_MESSAGE_ERROR:
+      _print_log ("received error message");
+      parse_err_message (message);
+      g_main_loop_quit (ncam->loop);
+      break;
+
+    case GST_MESSAGE_WARNING:
+      parse_err_message (message);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Timer callback to stop the main loop.
+ */
+static gboolean
+ncam_timeout_cb (gpointer user_data)
+{
+  NCamData *ncam = (NCamData *) user_data;
+
+  g_main_loop_quit (ncam->loop);
+  return FALSE;
+}
+
+/**
+ * @brief Get the description of the source.
+ * @param src videotestsrc, /dev/videoX or file:PATH
+ */
+static gchar *
+get_source_desc (const gchar * src, guint index)
+{
+  if (g_str_has_prefix (src, "file:"))
+    return g_strdup_printf ("filesrc location=%s ! decodebin", src + 5);
+
+  if (g_str_has_prefix (src, "/dev/"))
+    return g_strdup_printf ("v4l2src device=%s", src);
+
+  /* different pattern for each source */
+  return g_strdup_printf ("videotestsrc is-live=true pattern=%u", index % 20);
+}
+
+/**
+ * @brief Check the sources, a camera cannot be shared by the sources.
+ */
+static gboolean
+check_sources (guint num, gchar ** sources)
+{
+  guint num_src = g_strv_length (sources);
+  guint i, j;
+
+  if (num_src == 0) {
+    g_critical ("no source is given");
+    return FALSE;
+  }
+
+  for (i = 0; i < num; i++) {
+    if (!g_str_has_prefix (sources[i % num_src], "/dev/"))
+      continue;
+
+    for (j = 0; j < i; j++) {
+      if (g_str_equal (sources[i % num_src], sources[j % num_src])) {
+        g_critical ("%s is used by source %u and %u, give a camera for each source",
+            sources[i % num_src], j, i);
+        return FALSE;
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Get the pipeline description for N sources.
+ */
+static gchar *
+get_ncam_pipeline (guint num, gchar ** sources, gboolean batched,
+    gboolean headless, const gchar * model_path)
+{
+  GString *desc = g_string_new (NULL);
+  guint num_src = g_strv_length (sources);
+  gchar *src;
+  guint i;
+
+  for (i = 0; i < num; i++) {
+    src = get_source_desc (sources[i % num_src], i);
+
+    g_string_append_printf (desc,
+        "%s ! videoconvert ! videoscale ! video/x-raw,width=%d,height=%d,format=RGB ! tee name=t_raw_%u "
+        "t_raw_%u. ! queue leaky=2 max-size-buffers=2 ! videoconvert ! cairooverlay name=tensor_res_%u ! ",
+        src, VIDEO_WIDTH, VIDEO_HEIGHT, i, i, i);
+    if (headless)
+      g_string_append_printf (desc, "fakesink name=img_tensor_%u sync=false ", i);
+    else
+      g_string_append_printf (desc, "videoconvert ! ximagesink name=img_tensor_%u ", i);
+
+    g_string_append_printf (desc,
+        "t_raw_%u. ! queue leaky=2 max-size-buffers=2 ! videoscale ! video/x-raw,width=%d,height=%d ! tensor_converter ! ",
+        i, MODEL_WIDTH, MODEL_HEIGHT);
+
+    if (batched) {
+      g_string_append_printf (desc, "merge.sink_%u ", i);
+    } else {
+      g_string_append_printf (desc,
+          "tensor_transform mode=arithmetic option=typecast:float32,add:-127.5,div:127.5 ! "
+          "tensor_filter framework=tensorflow-lite model=%s ! "
+          "tensor_sink name=tensor_sink_%u ", model_path, i);
+    }
+
+    g_free (src);
+  }
+
+  if (batched) {
+    /* one model instance, input batch is the number of sources */
+    g_string_append_printf (desc,
+        "tensor_merge name=merge mode=linear option=3 sync-mode=slowest ! "
+        "tensor_transform mode=arithmetic option=typecast:float32,add:-127.5,div:127.5 ! "
+        "tensor_filter framework=tensorflow-lite model=%s input=3:%d:%d:%u inputtype=float32 ! "
+        "tensor_sink name=tensor_sink ", model_path, MODEL_WIDTH, MODEL_HEIGHT, num);
+  }
+
+  return g_string_free (desc, FALSE);
+}
+
+/**
+ * @brief Print usage info (BATCH and INDEPENDENT).
+ */
+static void
+ncam_usage (void)
+{
+  g_print ("usage: batch|independent [options]\n"
+      "    --cams      Number of sources. (default 4)\n"
+      "    --src       Comma-separated sources, videotestsrc, /dev/videoX or file:PATH. (default videotestsrc)\n"
+      "                Sources are repeated for N sources, a camera is given once for each source.\n"
+      "    --model     tflite model file. (default ./tflite_model/ssd_mobilenet_v2_coco.tflite)\n"
+      "                batch with N > 1 needs a model with a batch of N, the default model has a batch of 1.\n"
+      "    --seconds   Running time, 0 to run until EOS. (default 30)\n"
+      "    --headless  Use fakesink instead of ximagesink.\n"
+      "    --trace-startup       Print the startup phases until the first result.\n"
+      "    --parallel-init       Load labels and box priors on worker threads while the pipeline starts.\n"
+      "    --until-first-result  Quit when the first result arrives.\n"
+      "    --record    Record the output of tensor_filter to the file, see replay.\n");
+}
+
+/**
+ * @brief Run N sources in one pipeline (BATCH and INDEPENDENT).
+ */
+static int
+run_ncam (int argc, char ** argv, gboolean batched)
+{
+  const gchar tflite_model_path[] = "./tflite_model";
+  NCamData ncam;
+  AppData *app;
+  GstElement *element;
+  gchar *str_pipeline, *name;
+  gchar *src_list = g_strdup ("videotestsrc");
+  gchar *record_path = NULL;
+  gchar *model_file = NULL;
+  gchar **sources = NULL;
+  TensorRecorder *recorder = NULL;
+  TensorRecorderStats record_stats;
+  guint num = 4, seconds = 30, i;
+  gboolean headless = FALSE, trace = FALSE, parallel_init = FALSE;
+  gboolean until_first_result = FALSE, loaded = FALSE;
+  guint64 total = 0, min_frames = G_MAXUINT64;
+  gdouble elapsed;
+  gint64 start;
+  gint opt, ret = -1;
+  struct option long_options[] = {
+      { "cams", required_argument, NULL, 'n' },
+      { "src", required_argument, NULL, 's' },
+      { "seconds", required_argument, NULL, 't' },
+      { "headless", no_argument, NULL, 'l' },
+      { "trace-startup", no_argument, NULL, 'r' },
+      { "parallel-init", no_argument, NULL, 'p' },
+      { "until-first-result", no_argument, NULL, 'f' },
+      { "record", required_argument, NULL, 'w' },
+      { "model", required_argument, NULL, 'm' },
+      { "help", no_argument, NULL, 'h' },
+      { 0, 0, 0, 0 }
+  };
+
+  /* created before gst_init, freed below without --trace-startup */
+  ncam.tracer = startup_tracer_new ();
+  start = g_get_monotonic_time ();
+  gst_init (&argc, &argv);
+  startup_tracer_span (ncam.tracer, "gst_init", start);
+
+  /* skip the mode */
+  optind = 1;
+  while ((opt = getopt_long (argc - 1, argv + 1, "n:s:t:lrpfw:m:h", long_options, NULL)) != -1) {
+    switch (opt) {
+      case 'n':
+        num = CLAMP ((guint) g_ascii_strtoull (optarg, NULL, 10), 1, 16);
+        break;
+      case 's':
+        g_free (src_list);
+        src_list = g_strdup (optarg);
+        break;
+      case 't':
+        seconds = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'l':
+        headless = TRUE;
+        break;
+      case 'r':
+        trace = TRUE;
+        break;
+      case 'p':
+        parallel_init = TRUE;
+        break;
+      case 'f':
+        until_first_result = TRUE;
+        break;
+      case 'w':
+        g_free (record_path);
+        record_path = g_strdup (optarg);
+        break;
+      case 'm':
+        g_free (model_file);
+        model_file = g_strdup (optarg);
+        break;
+      default:
+        ncam_usage ();
+        g_free (src_list);
+        g_free (record_path);
+        g_free (model_file);
+        startup_tracer_free (ncam.tracer);
+        return -1;
+    }
+  }
+
+  if (!trace) {
+    startup_tracer_free (ncam.tracer);
+    ncam.tracer = NULL;
+  }
+
+  tcp_sr = batched ? BATCH : INDEPENDENT;
+  sources = g_strsplit (src_list, ",", -1);
+  g_free (src_list);
+
+  ncam.loop = NULL;
+  ncam.pipeline = NULL;
+  ncam.bus = NULL;
+  g_mutex_init (&ncam.lock);
+  ncam.first_result = ncam.last_result = 0;
+  ncam.rss_kb = 0;
+  ncam.invalid = 0;
+  ncam.until_first_result = until_first_result;
+  memset (&ncam.tflite_info, 0, sizeof (TFLiteModelInfo));
+
+  /* labels and box priors are loaded once for all sources */
+  start = g_get_monotonic_time ();
+  _check_cond_err (tflite_init_info (&ncam.tflite_info, tflite_model_path,
+          startup_tasks_new (parallel_init, ncam.tracer)));
+  startup_tracer_span (ncam.tracer, "init_info", start);
+  _check_cond_err (check_sources (num, sources));
+
+  if (model_file) {
+    /* labels and box priors are the same, e.g., the model exported with a batch of N */
+    if (!g_file_test (model_file, G_FILE_TEST_IS_REGULAR)) {
+      g_critical ("cannot find tflite model [%s]", model_file);
+      goto error;
+    }
+    g_free (ncam.tflite_info.model_path);
+    ncam.tflite_info.model_path = g_strdup (model_file);
+  }
+
+  for (i = 0; i < num; i++) {
+    app = new AppData;
+    init_app_variable (app);
+    app->model = &ncam.tflite_info;
+    ncam.cams.push_back (app);
+  }
+
+  ncam.loop = g_main_loop_new (NULL, FALSE);
+  _check_cond_err (ncam.loop != NULL);
+
+  str_pipeline = get_ncam_pipeline (num, sources, batched, headless,
+      ncam.tflite_info.model_path);
+  _print_log ("%s\n", str_pipeline);
+
+  start = g_get_monotonic_time ();
+  ncam.pipeline = gst_parse_launch (str_pipeline, NULL);
+  startup_tracer_span (ncam.tracer, "parse", start);
+  g_free (str_pipeline);
+  _check_cond_err (ncam.pipeline != NULL);
+  startup_tracer_attach (ncam.tracer, ncam.pipeline);
+
+  ncam.bus = gst_element_get_bus (ncam.pipeline);
+  _check_cond_err (ncam.bus != NULL);
+  gst_bus_add_signal_watch (ncam.bus);
+  g_signal_connect (ncam.bus, "message", G_CALLBACK (ncam_bus_message_cb), &ncam);
+
+  for (i = 0; i < num; i++) {
+    app = ncam.cams[i];
+    app->pipeline = ncam.pipeline;
+
+    if (!batched) {
+      name = g_strdup_printf ("tensor_sink_%u", i);
+      element = gst_bin_get_by_name (GST_BIN (ncam.pipeline), name);
+      g_signal_connect (element, "new-data", G_CALLBACK (new_data_cb), app);
+      g_signal_connect (element, "new-data", G_CALLBACK (ncam_result_cb), &ncam);
+      gst_object_unref (element);
+      g_free (name);
+    }
+
+    name = g_strdup_printf ("tensor_res_%u", i);
+    element = gst_bin_get_by_name (GST_BIN (ncam.pipeline), name);
+    g_signal_connect (element, "draw", G_CALLBACK (draw_overlay_cb), app);
+    g_signal_connect (element, "caps-changed", G_CALLBACK (prepare_overlay_cb), app);
+    gst_object_unref (element);
+    g_free (name);
+  }
+
+  if (batched) {
+    element = gst_bin_get_by_name (GST_BIN (ncam.pipeline), "tensor_sink");
+    g_signal_connect (element, "new-data", G_CALLBACK (batch_new_data_cb), &ncam);
+    g_signal_connect (element, "new-data", G_CALLBACK (ncam_result_cb), &ncam);
+    gst_object_unref (element);
+  }
+
+  if (record_path) {
+    /* the input of tensor_sink, the output of tensor_filter */
+    recorder = tensor_recorder_new (record_path);
+    _check_cond_err (recorder != NULL);
+    _check_cond_err (tensor_recorder_attach_element (recorder, ncam.pipeline,
+            batched ? "tensor_sink" : "tensor_sink_0", 0));
+  }
+
+  start = g_get_monotonic_time ();
+  gst_element_set_state (ncam.pipeline, GST_STATE_PLAYING);
+  startup_tracer_span (ncam.tracer, "set_state_playing", start);
+  for (i = 0; i < num; i++)
+    g_atomic_int_set (&ncam.cams[i]->running, TRUE);
+
+  if (!headless) {
+    for (i = 0; i < num; i++) {
+      gchar *title = g_strdup_printf ("NNStreamer Example %u", i + 1);
+
+      name = g_strdup_printf ("img_tensor_%u", i);
+      set_window_title (ncam.cams[i], name, title);
+      g_free (name);
+      g_free (title);
+    }
+  }
+
+  if (seconds > 0)
+    g_timeout_add_seconds (seconds, ncam_timeout_cb, &ncam);
+
+  /* the loaders run while the pipeline starts, the results wait for them */
+  loaded = startup_tasks_wait (ncam.tflite_info.tasks);
+  if (loaded)
+    g_main_loop_run (ncam.loop);
+  else
+    g_critical ("cannot load labels and box priors");
+
+  for (i = 0; i < num; i++)
+    g_atomic_int_set (&ncam.cams[i]->running, FALSE);
+
+  gst_element_set_state (ncam.pipeline, GST_STATE_NULL);
+
+  /* aggregate fps since the first result, model loading is excluded */
+  elapsed = (ncam.last_result - ncam.first_result) / (gdouble) G_USEC_PER_SEC;
+  for (i = 0; i < num; i++) {
+    total += ncam.cams[i]->frames;
+    min_frames = MIN (min_frames, ncam.cams[i]->frames);
+  }
+
+  g_print ("mode,cams,seconds,frames,aggregate_fps,min_cam_fps,rss_mb,peak_rss_mb\n");
+  g_print ("%s,%u,%.1f,%" G_GUINT64_FORMAT ",%.2f,%.2f,%.1f,%.1f\n",
+      batched ? "batch" : "independent", num, elapsed, total,
+      (elapsed > 0) ? total / elapsed : 0.0,
+      (elapsed > 0) ? min_frames / elapsed : 0.0,
+      ncam.rss_kb / 1024.0, read_proc_status_kb ("VmHWM") / 1024.0);
+  startup_tracer_print (ncam.tracer, stdout);
+  ret = (loaded && !ncam.invalid) ? 0 : -1;
+
+  if (recorder) {
+    tensor_recorder_get_stats (recorder, &record_stats);
+    g_print ("recorded %" G_GUINT64_FORMAT " buffers (%" G_GUINT64_FORMAT
+        " bytes, %" G_GUINT64_FORMAT " dropped) to %s\n", record_stats.buffers,
+        record_stats.bytes, record_stats.dropped, record_path);
+  }
+
+error:
+  _print_log ("close app..");
+
+  for (i = 0; i < ncam.cams.size (); i++) {
+    app = ncam.cams[i];
+    app->pipeline = NULL;
+    app->detected_objects.clear ();
+    g_mutex_clear (&(app->mutex));
+    delete app;
+  }
+  ncam.cams.clear ();
+
+  if (ncam.bus) {
+    gst_bus_remove_signal_watch (ncam.bus);
+    gst_object_unref (ncam.bus);
+  }
+  startup_tracer_free (ncam.tracer);
+  tensor_recorder_free (recorder);
+  g_free (record_path);
+  if (ncam.pipeline)
+    gst_object_unref (ncam.pipeline);
+  if (ncam.loop)
+    g_main_loop_unref (ncam.loop);
+
+  tflite_free_info (&ncam.tflite_info);
+  g_mutex_clear (&ncam.lock);
+  g_free (model_file);
+  g_strfreev (sources);
+  return ret;
+}
+
+/**
+ * @brief Print usage info (REPLAY).
+ */
+static void
+replay_usage (void)
+{
+  g_print ("usage: replay [options]\n"
+      "    --input     File recorded with --record. (default tensors.tsrec)\n"
+      "    --loops     Number of times to process the recorded tensors. (default 1)\n");
+}
+
+/**
+ * @brief Call the result callback with the recorded tensors, without the pipeline (REPLAY).
+ */
+static int
+run_replay (int argc, char ** argv)
+{
+  const gchar tflite_model_path[] = "./tflite_model";
+  NCamData ncam;
+  AppData *app;
+  TensorReplay *replay = NULL;
+  GstBuffer *buffer;
+  gchar *input = g_strdup ("tensors.tsrec");
+  guint loops = 1, count = 0, num = 0, loop, i;
+  gint64 start, begin, elapsed, max_us = 0;
+  guint64 frames = 0;
+  gdouble seconds;
+  gint opt, ret = -1;
+  struct option long_options[] = {
+      { "input", required_argument, NULL, 'i' },
+      { "loops", required_argument, NULL, 'l' },
+      { "help", no_argument, NULL, 'h' },
+      { 0, 0, 0, 0 }
+  };
+
+  gst_init (&argc, &argv);
+
+  /* skip the mode */
+  optind = 1;
+  while ((opt = getopt_long (argc - 1, argv + 1, "i:l:h", long_options, NULL)) != -1) {
+    switch (opt) {
+      case 'i':
+        g_free (input);
+        input = g_strdup (optarg);
+        break;
+      case 'l':
+        loops = MAX ((guint) g_ascii_strtoull (optarg, NULL, 10), 1U);
+        break;
+      default:
+        replay_usage ();
+        g_free (input);
+        return -1;
+    }
+  }
+
+  tcp_sr = REPLAY;
+  memset (&ncam.tflite_info, 0, sizeof (TFLiteModelInfo));
+  ncam.loop = NULL;
+  ncam.pipeline = NULL;
+  ncam.bus = NULL;
+  ncam.tracer = NULL;
+
+  _check_cond_err (tflite_init_info (&ncam.tflite_info, tflite_model_path, NULL));
+
+  replay = tensor_replay_open (input);
+  _check_cond_err (replay != NULL);
+  count = tensor_replay_get_count (replay);
+  _check_cond_err (count > 0);
+
+  /* the number of sources from the size of the boxes, [4:1:1917:N] */
+  buffer = tensor_replay_get_buffer (replay, 0);
+  if (gst_buffer_n_memory (buffer) == 2)
+    num = gst_memory_get_sizes (gst_buffer_peek_memory (buffer, 0), NULL, NULL) /
+        (BOX_SIZE * DETECTION_MAX * 4);
+  gst_buffer_unref (buffer);
+  _check_cond_err (num > 0);
+
+  for (i = 0; i < num; i++) {
+    app = new AppData;
+    init_app_variable (app);
+    app->model = &ncam.tflite_info;
+    app->running = TRUE;
+    ncam.cams.push_back (app);
+  }
+
+  begin = g_get_monotonic_time ();
+  for (loop = 0; loop < loops; loop++) {
+    for (i = 0; i < count; i++) {
+      buffer = tensor_replay_get_buffer (replay, i);
+
+      start = g_get_monotonic_time ();
+      batch_new_data_cb (NULL, buffer, &ncam);
+      elapsed = g_get_monotonic_time () - start;
+      max_us = MAX (max_us, elapsed);
+
+      gst_buffer_unref (buffer);
+    }
+  }
+  seconds = (g_get_monotonic_time () - begin) / (gdouble) G_USEC_PER_SEC;
+
+  for (i = 0; i < num; i++)
+    frames += ncam.cams[i]->frames;
+
+  g_print ("mode,cams,buffers,frames,seconds,results_per_sec,avg_us,max_us\n");
+  g_print ("replay,%u,%u,%" G_GUINT64_FORMAT ",%.3f,%.1f,%.1f,%" G_GINT64_FORMAT "\n",
+      num, count * loops, frames, seconds, (seconds > 0) ? frames / seconds : 0.0,
+      seconds * G_USEC_PER_SEC / (count * loops), max_us);
+  ret = 0;
+
+error:
+  for (i = 0; i < ncam.cams.size (); i++) {
+    app = ncam.cams[i];
+    app->detected_objects.clear ();
+    g_mutex_clear (&(app->mutex));
+    delete app;
+  }
+  ncam.cams.clear ();
+
+  tensor_replay_free (replay);
+  tflite_free_info (&ncam.tflite_info);
+  g_free (input);
+  return ret;
+}
+
 /**
  * @brief Main function.
  */
@@ -754,12 +1480,22 @@ main (int argc, char ** argv)
   g_print ("Example using 2 cameras.\n");
   g_print ("You should input 'sender/receiver', 'host ip address', 'port1 for camera1', 'device node for camera1', 'port2 for camera2', and 'device node for camera2'\n");
   g_print ("e.g) $ ./nnstreamer_example_object_detection_tflite_2cam sender   IP PORT1 /dev/video0 PORT2 /dev/video1\n");
-  g_print ("e.g) $ ./nnstreamer_example_object_detection_tflite_2cam receiver IP PORT1 PORT2\n\n");
+  g_print ("e.g) $ ./nnstreamer_example_object_detection_tflite_2cam receiver IP PORT1 PORT2\n");
+  g_print ("e.g) $ ./nnstreamer_example_object_detection_tflite_2cam batch --cams=4 --src=videotestsrc --headless\n");
+  g_print ("e.g) $ ./nnstreamer_example_object_detection_tflite_2cam replay --input=ssd.tsrec --loops=10\n\n");
 
   if (argc < 2) {
     return -1;
   }
 
+  if (g_strcmp0 ("batch", argv[1]) == 0 || g_strcmp0 ("independent", argv[1]) == 0) {
+    /* gst_init is traced in run_ncam */
+    return run_ncam (argc, argv, g_strcmp0 ("batch", argv[1]) == 0);
+  }
+
+  if (g_strcmp0 ("replay", argv[1]) == 0)
+    return run_replay (argc, argv);
+
   if (g_strcmp0 ("sender", argv[1]) == 0) {
     tcp_sr = SENDER;
   }
@@ -800,8 +1536,8 @@ main (int argc, char ** argv)
   init_app_variable (&app2);
 
   if (tcp_sr == RECEIVER) {
-    _check_cond_err (tflite_init_info (&app1.tflite_info, tflite_model_path));
-    _check_cond_err (tflite_init_info (&app2.tflite_info, tflite_model_path));
+    _check_cond_err (tflite_init_info (&app1.tflite_info, tflite_model_path, NULL));
+    _check_cond_err (tflite_init_info (&app2.tflite_info, tflite_model_path, NULL));
   }
 
   /* init gstreamer */
@@ -0,0 +1,482 @@
+/**
+ * @file    nnstreamer_example_pose_postprocess_bench.cc
+ * @date    19 October 2026
+ * @brief   Benchmark of the pose postprocessor against tensor_decoder mode=pose_estimation
+ * @author  Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ * @bug     No known bugs.
+ *
+ * The input is a synthetic PoseNet output (heatmap [K:W:H:1] and offsets [2K:W:H:1]),
+ * so no model is needed.
+ *
+ * 1. Postprocessing only, in-process loop:
+ *    - scalar     : argmax per keypoint, the loop used in the Android multi example.
+ *    - simd       : pose_decode_single ().
+ *    - simd_multi : pose_decode_multi (), up to --peaks per keypoint.
+ * 2. Pipeline, appsrc pushes the tensors:
+ *    - pipe_none    : appsrc ! tensor_sink, no postprocessing.
+ *    - pipe_simd    : appsrc ! tensor_sink, pose_decode_single () in new-data callback.
+ *    - pipe_decoder : appsrc ! tensor_decoder mode=pose_estimation option4=heatmap-offset ! fakesink
+ *      The decoder also draws the keypoints into an RGBA frame of --video size.
+ *
+ * Result is printed as CSV.
+ *
+ * Run example :
+ * $ ./nnstreamer_example_pose_postprocess_bench
+ * $ ./nnstreamer_example_pose_postprocess_bench --grid=96:96 --keypoints=14 --input=192:192
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+#include "pose_postprocess.h"
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) if (DBG) g_message (__VA_ARGS__)
+
+/**
+ * @brief Data structure for the benchmark.
+ */
+typedef struct
+{
+  PoseGrid grid; /**< shape of the model output */
+  guint video_w; /**< output video size of tensor_decoder */
+  guint video_h;
+  guint iter; /**< number of frames */
+  guint peaks; /**< peaks per keypoint for multi-person */
+
+  gfloat *heatmap;
+  gfloat *offsets;
+  gsize heatmap_size; /**< bytes */
+  gsize offsets_size; /**< bytes */
+
+  PoseKeypoints kp; /**< result of the pipeline callback */
+  guint received;
+  gfloat checksum; /**< keeps the result alive */
+} BenchData;
+
+/**
+ * @brief Fill the synthetic model output, a few peaks on noise.
+ */
+static void
+_fill_input (BenchData * data)
+{
+  const PoseGrid *g = &data->grid;
+  guint num_cells = g->grid_w * g->grid_h;
+  guint i, k, p;
+
+  srand (1234);
+  for (i = 0; i < num_cells * g->num_keypoints; i++)
+    data->heatmap[i] = -6.0f + (rand () % 1000) / 250.0f;
+
+  for (i = 0; i < num_cells * g->num_keypoints * 2; i++)
+    data->offsets[i] = -8.0f + (rand () % 1000) / 62.5f;
+
+  for (k = 0; k < g->num_keypoints; k++) {
+    for (i = 0; i < 3; i++) {
+      p = (guint) rand () % num_cells;
+      data->heatmap[p * g->num_keypoints + k] = 2.0f + i;
+    }
+  }
+}
+
+/**
+ * @brief Reference, argmax per keypoint and refinement without SIMD.
+ */
+static void
+_decode_scalar (BenchData * data, PoseKeypoints * kp)
+{
+  const PoseGrid *g = &data->grid;
+  guint index[POSE_MAX_KEYPOINTS];
+  gfloat value[POSE_MAX_KEYPOINTS];
+  guint k, gx, gy;
+  const gfloat *off;
+
+  pose_argmax_scalar (data->heatmap, g->grid_w * g->grid_h, g->num_keypoints,
+      index, value);
+
+  for (k = 0; k < g->num_keypoints; k++) {
+    gx = index[k] % g->grid_w;
+    gy = index[k] / g->grid_w;
+    off = data->offsets + (gsize) index[k] * g->num_keypoints * 2;
+
+    kp->x[k * kp->max_peaks] = (gfloat) gx / (g->grid_w - 1) * g->input_w +
+        off[g->num_keypoints + k];
+    kp->y[k * kp->max_peaks] = (gfloat) gy / (g->grid_h - 1) * g->input_h + off[k];
+    kp->score[k * kp->max_peaks] = 1.0f / (1.0f + expf (-value[k]));
+    kp->count[k] = 1;
+  }
+}
+
+/**
+ * @brief Print a CSV row.
+ */
+static void
+_print_result (const gchar * stage, BenchData * data, guint frames, gint64 elapsed)
+{
+  gdouble us = (frames > 0) ? (gdouble) elapsed / frames : 0.0;
+
+  g_print ("%s,%u:%u,%u,%u,%.3f,%.1f\n", stage, data->grid.grid_w,
+      data->grid.grid_h, data->grid.num_keypoints, frames, us,
+      (us > 0.0) ? G_USEC_PER_SEC / us : 0.0);
+}
+
+/**
+ * @brief Run the postprocessing only.
+ */
+static void
+_bench_postprocess (BenchData * data)
+{
+  PoseKeypoints ref, kp;
+  gint64 start;
+  guint i, k;
+  gboolean match = TRUE;
+
+  pose_keypoints_init (&ref, data->grid.num_keypoints, 1);
+  pose_keypoints_init (&kp, data->grid.num_keypoints, data->peaks);
+
+  /* check the result is the same as the reference */
+  _decode_scalar (data, &ref);
+  pose_decode_single (&data->grid, data->heatmap, data->offsets, &kp);
+  for (k = 0; k < data->grid.num_keypoints; k++) {
+    if (ref.x[k] != kp.x[k * kp.max_peaks] || ref.y[k] != kp.y[k * kp.max_peaks])
+      match = FALSE;
+  }
+  if (!match)
+    g_critical ("The result of simd is different from the reference.");
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < data->iter; i++) {
+    _decode_scalar (data, &ref);
+    data->checksum += ref.x[0];
+  }
+  _print_result ("scalar", data, data->iter, g_get_monotonic_time () - start);
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < data->iter; i++) {
+    pose_decode_single (&data->grid, data->heatmap, data->offsets, &kp);
+    data->checksum += kp.x[0];
+  }
+  _print_result ("simd", data, data->iter, g_get_monotonic_time () - start);
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < data->iter; i++) {
+    pose_decode_multi (&data->grid, data->heatmap, data->offsets, &kp);
+    data->checksum += kp.count[0];
+  }
+  _print_result ("simd_multi", data, data->iter, g_get_monotonic_time () - start);
+
+  pose_keypoints_free (&ref);
+  pose_keypoints_free (&kp);
+}
+
+/**
+ * @brief Callback for tensor sink signal.
+ */
+static void
+_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  BenchData *data = (BenchData *) user_data;
+  GstMemory *mem_heatmap, *mem_offsets;
+  GstMapInfo info_heatmap, info_offsets;
+
+  data->received++;
+
+  if (data->kp.storage == NULL)
+    return;
+
+  if (gst_buffer_n_memory (buffer) != 2) {
+    _print_log ("Invalid result, the number of memory blocks is different.");
+    return;
+  }
+
+  mem_heatmap = gst_buffer_peek_memory (buffer, 0);
+  mem_offsets = gst_buffer_peek_memory (buffer, 1);
+
+  if (gst_memory_map (mem_heatmap, &info_heatmap, GST_MAP_READ)) {
+    if (gst_memory_map (mem_offsets, &info_offsets, GST_MAP_READ)) {
+      pose_decode_single (&data->grid, (const gfloat *) info_heatmap.data,
+          (const gfloat *) info_offsets.data, &data->kp);
+      data->checksum += data->kp.x[0];
+      gst_memory_unmap (mem_offsets, &info_offsets);
+    }
+    gst_memory_unmap (mem_heatmap, &info_heatmap);
+  }
+}
+
+/**
+ * @brief Run the pipeline until all frames are processed.
+ * @param sink_desc Description of the elements after appsrc.
+ * @param decode TRUE to run the postprocessor in tensor_sink callback.
+ */
+static void
+_bench_pipeline (BenchData * data, const gchar * stage, const gchar * sink_desc,
+    gboolean decode)
+{
+  GstElement *pipeline, *src, *sink;
+  GstMemory *mem_heatmap, *mem_offsets;
+  GstMessage *msg;
+  GstBuffer *buf;
+  GstCaps *caps;
+  GstBus *bus;
+  gchar *str_pipeline, *str_caps;
+  gint64 start, elapsed;
+  guint i;
+
+  str_pipeline = g_strdup_printf ("appsrc name=src format=time block=true "
+      "max-bytes=%" G_GSIZE_FORMAT " ! %s",
+      (data->heatmap_size + data->offsets_size) * 4, sink_desc);
+  _print_log ("%s", str_pipeline);
+
+  pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  if (!pipeline) {
+    g_critical ("Failed to create pipeline (%s).", stage);
+    return;
+  }
+
+  src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+  str_caps = g_strdup_printf ("other/tensors,format=static,num_tensors=2,"
+      "dimensions=(string)\"%u:%u:%u:1,%u:%u:%u:1\",types=(string)\"float32,float32\","
+      "framerate=(fraction)0/1", data->grid.num_keypoints, data->grid.grid_w,
+      data->grid.grid_h, data->grid.num_keypoints * 2, data->grid.grid_w,
+      data->grid.grid_h);
+  caps = gst_caps_from_string (str_caps);
+  g_object_set (src, "caps", caps, NULL);
+  gst_caps_unref (caps);
+  g_free (str_caps);
+
+  data->received = 0;
+  if (decode)
+    pose_keypoints_init (&data->kp, data->grid.num_keypoints, 1);
+
+  if (g_str_has_prefix (sink_desc, "tensor_sink")) {
+    sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+    g_signal_connect (sink, "new-data", (GCallback) _new_data_cb, data);
+    gst_object_unref (sink);
+  }
+
+  /* the tensors are not changed, share the memory */
+  mem_heatmap = gst_memory_new_wrapped ((GstMemoryFlags) GST_MEMORY_FLAG_READONLY,
+      data->heatmap, data->heatmap_size, 0, data->heatmap_size, NULL, NULL);
+  mem_offsets = gst_memory_new_wrapped ((GstMemoryFlags) GST_MEMORY_FLAG_READONLY,
+      data->offsets, data->offsets_size, 0, data->offsets_size, NULL, NULL);
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < data->iter; i++) {
+    buf = gst_buffer_new ();
+    gst_buffer_append_memory (buf, gst_memory_share (mem_heatmap, 0, -1));
+    gst_buffer_append_memory (buf, gst_memory_share (mem_offsets, 0, -1));
+    GST_BUFFER_PTS (buf) = i * GST_MSECOND;
+
+    if (gst_app_src_push_buffer (GST_APP_SRC (src), buf) != GST_FLOW_OK) {
+      g_critical ("Failed to push buffer [%u] (%s).", i, stage);
+      break;
+    }
+  }
+  gst_app_src_end_of_stream (GST_APP_SRC (src));
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, 60 * GST_SECOND,
+      (GstMessageType) (GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+  elapsed = g_get_monotonic_time () - start;
+
+  if (msg == NULL || GST_MESSAGE_TYPE (msg) != GST_MESSAGE_EOS)
+    g_critical ("Failed to run pipeline (%s).", stage);
+  else
+    _print_result (stage, data, i, elapsed);
+
+  if (msg)
+    gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (src);
+  gst_object_unref (pipeline);
+  gst_memory_unref (mem_heatmap);
+  gst_memory_unref (mem_offsets);
+
+  if (decode)
+    pose_keypoints_free (&data->kp);
+}
+
+/**
+ * @brief Write the label file for tensor_decoder, one keypoint per line.
+ */
+static gchar *
+_write_labels (guint num_keypoints)
+{
+  GString *labels = g_string_new (NULL);
+  gchar *path;
+  guint k;
+
+  for (k = 0; k < num_keypoints; k++)
+    g_string_append_printf (labels, "point%u\n", k);
+
+  path = g_build_filename (g_get_tmp_dir (), "pose_postprocess_bench_labels.txt", NULL);
+  if (!g_file_set_contents (path, labels->str, -1, NULL)) {
+    g_free (path);
+    path = NULL;
+  }
+
+  g_string_free (labels, TRUE);
+  return path;
+}
+
+/**
+ * @brief Print usage info
+ */
+static void
+_usage (void)
+{
+  g_message ("\nusage: \n"
+  "    --grid       Heatmap W:H. (default 9:9, PoseNet 257x257) \n"
+  "    --keypoints  Number of keypoints. (default 17) \n"
+  "    --input      Model input W:H. (default 257:257) \n"
+  "    --video      Output video of tensor_decoder W:H. (default 640:480) \n"
+  "    --iter       Number of frames. (default 10000) \n"
+  "    --peaks      Peaks per keypoint for multi-person. (default 5) \n"
+  "    --threshold  Min score of a peak for multi-person. (default 0.5) \n"
+  "    --no-pipeline  Skip the pipeline benchmark. \n");
+}
+
+/**
+ * @brief Parse W:H.
+ */
+static void
+_parse_size (const gchar * str, guint * w, guint * h)
+{
+  gchar **s = g_strsplit (str, ":", 2);
+
+  if (g_strv_length (s) == 2) {
+    *w = MAX (2, (guint) g_ascii_strtoull (s[0], NULL, 10));
+    *h = MAX (2, (guint) g_ascii_strtoull (s[1], NULL, 10));
+  }
+  g_strfreev (s);
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char ** argv)
+{
+  BenchData data;
+  gboolean run_pipeline = TRUE;
+  gchar *labels, *desc;
+  gsize num_cells;
+  gint ch;
+  struct option long_options[] = {
+      { "grid", required_argument, NULL, 'g' },
+      { "keypoints", required_argument, NULL, 'k' },
+      { "input", required_argument, NULL, 'i' },
+      { "video", required_argument, NULL, 'v' },
+      { "iter", required_argument, NULL, 'n' },
+      { "peaks", required_argument, NULL, 'p' },
+      { "threshold", required_argument, NULL, 't' },
+      { "no-pipeline", no_argument, NULL, 'x' },
+      { "help", no_argument, NULL, 'h' },
+      { 0, 0, 0, 0}
+  };
+
+  /* init gstreamer */
+  gst_init (&argc, &argv);
+
+  memset (&data, 0, sizeof (BenchData));
+  data.grid.num_keypoints = 17;
+  data.grid.grid_w = data.grid.grid_h = 9;
+  data.grid.input_w = data.grid.input_h = 257;
+  data.grid.sigmoid = TRUE;
+  data.grid.threshold = 0.5f;
+  data.grid.nms_radius = 1;
+  data.video_w = 640;
+  data.video_h = 480;
+  data.iter = 10000;
+  data.peaks = 5;
+
+  while ((ch = getopt_long (argc, argv, "g:k:i:v:n:p:t:xh", long_options, NULL)) != -1) {
+    switch (ch) {
+      case 'g':
+        _parse_size (optarg, &data.grid.grid_w, &data.grid.grid_h);
+        break;
+      case 'k':
+        data.grid.num_keypoints = CLAMP ((guint) g_ascii_strtoull (optarg, NULL, 10),
+            1, POSE_MAX_KEYPOINTS);
+        break;
+      case 'i':
+        _parse_size (optarg, &data.grid.input_w, &data.grid.input_h);
+        break;
+      case 'v':
+        _parse_size (optarg, &data.video_w, &data.video_h);
+        break;
+      case 'n':
+        data.iter = MAX (1, (guint) g_ascii_strtoull (optarg, NULL, 10));
+        break;
+      case 'p':
+        data.peaks = MAX (1, (guint) g_ascii_strtoull (optarg, NULL, 10));
+        break;
+      case 't':
+        data.grid.threshold = (gfloat) g_ascii_strtod (optarg, NULL);
+        break;
+      case 'x':
+        run_pipeline = FALSE;
+        break;
+      default:
+        _usage ();
+        return 0;
+    }
+  }
+
+  num_cells = (gsize) data.grid.grid_w * data.grid.grid_h;
+  data.heatmap_size = num_cells * data.grid.num_keypoints * sizeof (gfloat);
+  data.offsets_size = data.heatmap_size * 2;
+  data.heatmap = (gfloat *) g_malloc (data.heatmap_size);
+  data.offsets = (gfloat *) g_malloc (data.offsets_size);
+  _fill_input (&data);
+
+  g_print ("stage,grid,keypoints,frames,us_per_frame,fps\n");
+  _bench_postprocess (&data);
+
+  if (run_pipeline) {
+    _bench_pipeline (&data, "pipe_none", "tensor_sink name=sink sync=false", FALSE);
+    _bench_pipeline (&data, "pipe_simd", "tensor_sink name=sink sync=false", TRUE);
+
+    labels = _write_labels (data.grid.num_keypoints);
+    if (labels) {
+      desc = g_strdup_printf ("tensor_decoder mode=pose_estimation option1=%u:%u "
+          "option2=%u:%u option3=%s option4=heatmap-offset ! "
+          "fakesink name=sink sync=false", data.video_w, data.video_h,
+          data.grid.input_w, data.grid.input_h, labels);
+      _bench_pipeline (&data, "pipe_decoder", desc, FALSE);
+      g_free (desc);
+      g_remove (labels);
+      g_free (labels);
+    }
+  }
+
+  _print_log ("checksum %f", data.checksum);
+  g_free (data.heatmap);
+  g_free (data.offsets);
+
+  return 0;
+}
@@ -0,0 +1,375 @@
+/**
+ * @file    pose_postprocess.cc
+ * @date    19 October 2026
+ * @brief   Portable pose heatmap postprocessor (argmax and offset refinement)
+ * @author  Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ * @bug     No known bugs.
+ *
+ * See pose_postprocess.h for the layout of the input and output.
+ * The refinement follows tensor_decoder mode=pose_estimation option4=heatmap-offset:
+ *   x = grid_x / (W - 1) * input_w + offset_x
+ *   y = grid_y / (H - 1) * input_h + offset_y
+ */
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include "pose_postprocess.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define POSE_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define POSE_SIMD_NEON 1
+#endif
+
+/**
+ * @brief Number of float lanes of the SIMD register.
+ */
+#define POSE_LANES 4
+
+/**
+ * @brief Initialize the keypoints buffer.
+ * @param max_peaks Peaks per keypoint, 1 for single person.
+ */
+gboolean
+pose_keypoints_init (PoseKeypoints * kp, guint num_keypoints, guint max_peaks)
+{
+  gsize n;
+  guint8 *mem;
+
+  g_return_val_if_fail (kp != NULL, FALSE);
+  g_return_val_if_fail (num_keypoints > 0 && num_keypoints <= POSE_MAX_KEYPOINTS, FALSE);
+  g_return_val_if_fail (max_peaks > 0, FALSE);
+
+  n = (gsize) num_keypoints * max_peaks;
+  mem = (guint8 *) g_malloc0 (num_keypoints * sizeof (guint) + 3 * n * sizeof (gfloat));
+
+  kp->num_keypoints = num_keypoints;
+  kp->max_peaks = max_peaks;
+  kp->storage = mem;
+  kp->x = (gfloat *) mem;
+  kp->y = kp->x + n;
+  kp->score = kp->y + n;
+  kp->count = (guint *) (kp->score + n);
+
+  return TRUE;
+}
+
+/**
+ * @brief Free the keypoints buffer.
+ */
+void
+pose_keypoints_free (PoseKeypoints * kp)
+{
+  g_return_if_fail (kp != NULL);
+
+  g_free (kp->storage);
+  memset (kp, 0, sizeof (PoseKeypoints));
+}
+
+/**
+ * @brief Reference argmax, scans the heatmap once per keypoint.
+ *        Same as the hand-written loop of the Android multi example.
+ */
+void
+pose_argmax_scalar (const gfloat * heatmap, guint num_cells,
+    guint num_keypoints, guint * index, gfloat * value)
+{
+  guint k, p;
+  gfloat max, v;
+
+  for (k = 0; k < num_keypoints; k++) {
+    max = -FLT_MAX;
+    index[k] = 0;
+
+    for (p = 0; p < num_cells; p++) {
+      v = heatmap[p * num_keypoints + k];
+      if (v > max) {
+        max = v;
+        index[k] = p;
+      }
+    }
+
+    value[k] = max;
+  }
+}
+
+/**
+ * @brief Argmax of keypoints [from, to), scans the heatmap once.
+ */
+static void
+_argmax_cells (const gfloat * heatmap, guint num_cells, guint num_keypoints,
+    guint from, guint to, guint * index, gfloat * value)
+{
+  guint k, p;
+  const gfloat *cell;
+
+  for (k = from; k < to; k++) {
+    value[k] = -FLT_MAX;
+    index[k] = 0;
+  }
+
+  for (p = 0; p < num_cells; p++) {
+    cell = heatmap + (gsize) p * num_keypoints;
+
+    for (k = from; k < to; k++) {
+      if (cell[k] > value[k]) {
+        value[k] = cell[k];
+        index[k] = p;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Argmax of all keypoints, compares a cell of K keypoints with SIMD lanes.
+ *        The first cell wins on ties, same as the reference.
+ * @param index Cell index (y * W + x) of the max per keypoint.
+ * @param value Max value per keypoint.
+ */
+void
+pose_argmax (const gfloat * heatmap, guint num_cells, guint num_keypoints,
+    guint * index, gfloat * value)
+{
+#if defined(POSE_SIMD_SSE2) || defined(POSE_SIMD_NEON)
+  const guint blocks = num_keypoints / POSE_LANES;
+  const guint vec_k = blocks * POSE_LANES;
+  guint b, p;
+  const gfloat *cell;
+
+  if (blocks == 0 || num_keypoints > POSE_MAX_KEYPOINTS) {
+    _argmax_cells (heatmap, num_cells, num_keypoints, 0, num_keypoints, index, value);
+    return;
+  }
+
+#if defined(POSE_SIMD_SSE2)
+  {
+    __m128 vmax[POSE_MAX_KEYPOINTS / POSE_LANES];
+    __m128i vidx[POSE_MAX_KEYPOINTS / POSE_LANES];
+    __m128 v, mask;
+    __m128i vp, mi;
+
+    for (b = 0; b < blocks; b++) {
+      vmax[b] = _mm_set1_ps (-FLT_MAX);
+      vidx[b] = _mm_setzero_si128 ();
+    }
+
+    for (p = 0; p < num_cells; p++) {
+      cell = heatmap + (gsize) p * num_keypoints;
+      vp = _mm_set1_epi32 ((int) p);
+
+      for (b = 0; b < blocks; b++) {
+        v = _mm_loadu_ps (cell + b * POSE_LANES);
+        mask = _mm_cmpgt_ps (v, vmax[b]);
+        mi = _mm_castps_si128 (mask);
+
+        vmax[b] = _mm_or_ps (_mm_and_ps (mask, v), _mm_andnot_ps (mask, vmax[b]));
+        vidx[b] = _mm_or_si128 (_mm_and_si128 (mi, vp), _mm_andnot_si128 (mi, vidx[b]));
+      }
+    }
+
+    for (b = 0; b < blocks; b++) {
+      _mm_storeu_ps (value + b * POSE_LANES, vmax[b]);
+      _mm_storeu_si128 ((__m128i *) (index + b * POSE_LANES), vidx[b]);
+    }
+  }
+#else
+  {
+    float32x4_t vmax[POSE_MAX_KEYPOINTS / POSE_LANES];
+    uint32x4_t vidx[POSE_MAX_KEYPOINTS / POSE_LANES];
+    float32x4_t v;
+    uint32x4_t mask, vp;
+
+    for (b = 0; b < blocks; b++) {
+      vmax[b] = vdupq_n_f32 (-FLT_MAX);
+      vidx[b] = vdupq_n_u32 (0);
+    }
+
+    for (p = 0; p < num_cells; p++) {
+      cell = heatmap + (gsize) p * num_keypoints;
+      vp = vdupq_n_u32 (p);
+
+      for (b = 0; b < blocks; b++) {
+        v = vld1q_f32 (cell + b * POSE_LANES);
+        mask = vcgtq_f32 (v, vmax[b]);
+
+        vmax[b] = vbslq_f32 (mask, v, vmax[b]);
+        vidx[b] = vbslq_u32 (mask, vp, vidx[b]);
+      }
+    }
+
+    for (b = 0; b < blocks; b++) {
+      vst1q_f32 (value + b * POSE_LANES, vmax[b]);
+      vst1q_u32 (index + b * POSE_LANES, vidx[b]);
+    }
+  }
+#endif
+
+  /* remaining keypoints */
+  if (vec_k < num_keypoints)
+    _argmax_cells (heatmap, num_cells, num_keypoints, vec_k, num_keypoints, index, value);
+#else
+  _argmax_cells (heatmap, num_cells, num_keypoints, 0, num_keypoints, index, value);
+#endif
+}
+
+/**
+ * @brief Get the score from the heatmap value.
+ */
+static inline gfloat
+_score (const PoseGrid * grid, gfloat v)
+{
+  return grid->sigmoid ? 1.0f / (1.0f + expf (-v)) : v;
+}
+
+/**
+ * @brief Get the position of keypoint k at the cell, refined with the offsets.
+ */
+static inline void
+_refine (const PoseGrid * grid, const gfloat * offsets, guint k, guint cell,
+    gfloat * x, gfloat * y)
+{
+  guint gx = cell % grid->grid_w;
+  guint gy = cell / grid->grid_w;
+
+  if (offsets) {
+    const gfloat *off = offsets + (gsize) cell * grid->num_keypoints * 2;
+
+    *x = (grid->grid_w > 1 ? (gfloat) gx / (grid->grid_w - 1) : 0.0f) *
+        grid->input_w + off[grid->num_keypoints + k];
+    *y = (grid->grid_h > 1 ? (gfloat) gy / (grid->grid_h - 1) : 0.0f) *
+        grid->input_h + off[k];
+  } else {
+    /* center of the cell */
+    *x = (gx + 0.5f) * grid->input_w / grid->grid_w;
+    *y = (gy + 0.5f) * grid->input_h / grid->grid_h;
+  }
+}
+
+/**
+ * @brief Find the max of each keypoint (single person).
+ * @param offsets The offsets, NULL to use the center of the cell.
+ * @param kp The result, kp->count[k] is 1 and the peak is at [k * max_peaks].
+ */
+void
+pose_decode_single (const PoseGrid * grid, const gfloat * heatmap,
+    const gfloat * offsets, PoseKeypoints * kp)
+{
+  guint index[POSE_MAX_KEYPOINTS];
+  gfloat value[POSE_MAX_KEYPOINTS];
+  guint k, o;
+
+  g_return_if_fail (grid != NULL && heatmap != NULL && kp != NULL);
+  g_return_if_fail (grid->num_keypoints == kp->num_keypoints);
+
+  pose_argmax (heatmap, grid->grid_w * grid->grid_h, grid->num_keypoints,
+      index, value);
+
+  for (k = 0; k < grid->num_keypoints; k++) {
+    o = k * kp->max_peaks;
+    _refine (grid, offsets, k, index[k], &kp->x[o], &kp->y[o]);
+    kp->score[o] = _score (grid, value[k]);
+    kp->count[k] = 1;
+  }
+}
+
+/**
+ * @brief Check the value at (x, y) of keypoint k is the max in the window.
+ *        On plateaus, only the first cell in raster order is a peak.
+ */
+static gboolean
+_is_local_max (const PoseGrid * grid, const gfloat * heatmap, guint k,
+    guint x, guint y, gfloat v)
+{
+  guint r = grid->nms_radius;
+  guint x0 = (x > r) ? x - r : 0, x1 = MIN (x + r, grid->grid_w - 1);
+  guint y0 = (y > r) ? y - r : 0, y1 = MIN (y + r, grid->grid_h - 1);
+  guint i, j;
+  gfloat n;
+
+  for (j = y0; j <= y1; j++) {
+    for (i = x0; i <= x1; i++) {
+      if (i == x && j == y)
+        continue;
+
+      n = heatmap[((gsize) j * grid->grid_w + i) * grid->num_keypoints + k];
+      if (n > v || (n == v && (j < y || (j == y && i < x))))
+        return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Find the peaks of each keypoint above the threshold (multi-person).
+ *        Peaks are sorted by score, up to kp->max_peaks per keypoint.
+ *        Grouping the peaks into persons is left to the caller.
+ */
+void
+pose_decode_multi (const PoseGrid * grid, const gfloat * heatmap,
+    const gfloat * offsets, PoseKeypoints * kp)
+{
+  const guint K = grid->num_keypoints;
+  const guint num_cells = grid->grid_w * grid->grid_h;
+  guint *cells;
+  gfloat *values;
+  gfloat thr, v;
+  guint p, k, i, n, o, x, y;
+  const gfloat *cell;
+
+  g_return_if_fail (grid != NULL && heatmap != NULL && kp != NULL);
+  g_return_if_fail (K == kp->num_keypoints);
+
+  /* compare the raw value, the threshold is a score */
+  thr = grid->threshold;
+  if (grid->sigmoid) {
+    thr = CLAMP (thr, 1e-6f, 1.0f - 1e-6f);
+    thr = logf (thr / (1.0f - thr));
+  }
+
+  cells = (guint *) g_alloca (K * kp->max_peaks * sizeof (guint));
+  values = (gfloat *) g_alloca (K * kp->max_peaks * sizeof (gfloat));
+  memset (kp->count, 0, K * sizeof (guint));
+
+  for (p = 0; p < num_cells; p++) {
+    cell = heatmap + (gsize) p * K;
+    x = p % grid->grid_w;
+    y = p / grid->grid_w;
+
+    for (k = 0; k < K; k++) {
+      v = cell[k];
+      if (v < thr)
+        continue;
+
+      o = k * kp->max_peaks;
+      n = kp->count[k];
+      if (n == kp->max_peaks && v <= values[o + n - 1])
+        continue;
+
+      if (!_is_local_max (grid, heatmap, k, x, y, v))
+        continue;
+
+      /* insert, sorted by value */
+      i = (n < kp->max_peaks) ? n++ : n - 1;
+      while (i > 0 && values[o + i - 1] < v) {
+        values[o + i] = values[o + i - 1];
+        cells[o + i] = cells[o + i - 1];
+        i--;
+      }
+      values[o + i] = v;
+      cells[o + i] = p;
+      kp->count[k] = n;
+    }
+  }
+
+  for (k = 0; k < K; k++) {
+    o = k * kp->max_peaks;
+    for (i = 0; i < kp->count[k]; i++) {
+      _refine (grid, offsets, k, cells[o + i], &kp->x[o + i], &kp->y[o + i]);
+      kp->score[o + i] = _score (grid, values[o + i]);
+    }
+  }
+}
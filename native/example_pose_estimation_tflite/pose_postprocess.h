@@ -0,0 +1,73 @@
+/**
+ * @file    pose_postprocess.h
+ * @date    19 October 2026
+ * @brief   Portable pose heatmap postprocessor (argmax and offset refinement)
+ * @author  Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ * @bug     No known bugs.
+ *
+ * The heatmap and offsets are the output of the tensor_filter, in the
+ * nnstreamer dimension order (innermost first):
+ *  - heatmap : float32 [K:W:H:1], K keypoints interleaved per grid cell.
+ *  - offsets : float32 [2K:W:H:1], y offsets of K keypoints, then x offsets. (optional)
+ *
+ * The argmax runs over all keypoints of a grid cell at once with SSE2 or NEON
+ * (scalar fallback), so the heatmap is read once regardless of K.
+ * The result is a struct of arrays, x/y/score of keypoint k and peak i at [k * max_peaks + i].
+ */
+#ifndef __POSE_POSTPROCESS_H__
+#define __POSE_POSTPROCESS_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Max number of keypoints.
+ */
+#define POSE_MAX_KEYPOINTS 64
+
+/**
+ * @brief Shape of the model output and options.
+ */
+typedef struct
+{
+  guint num_keypoints; /**< K, the innermost dimension of the heatmap */
+  guint grid_w; /**< W of the heatmap */
+  guint grid_h; /**< H of the heatmap */
+  guint input_w; /**< width of the model input, offsets are in this scale */
+  guint input_h; /**< height of the model input */
+  gboolean sigmoid; /**< heatmap is logit, score is sigmoid of the peak */
+  gfloat threshold; /**< min score of a peak for multi-person extraction */
+  guint nms_radius; /**< a peak is the max in (2r+1)x(2r+1) window (multi-person) */
+} PoseGrid;
+
+/**
+ * @brief Keypoints, struct of arrays in one allocation.
+ */
+typedef struct
+{
+  guint num_keypoints;
+  guint max_peaks; /**< peaks per keypoint, 1 for single person */
+  guint *count; /**< [K] number of peaks found */
+  gfloat *x; /**< [K * max_peaks] x in model input scale */
+  gfloat *y; /**< [K * max_peaks] y in model input scale */
+  gfloat *score; /**< [K * max_peaks] score of the peak */
+  gpointer storage; /**< backing memory of the arrays */
+} PoseKeypoints;
+
+extern gboolean pose_keypoints_init (PoseKeypoints * kp, guint num_keypoints, guint max_peaks);
+extern void pose_keypoints_free (PoseKeypoints * kp);
+
+extern void pose_argmax (const gfloat * heatmap, guint num_cells, guint num_keypoints,
+    guint * index, gfloat * value);
+extern void pose_argmax_scalar (const gfloat * heatmap, guint num_cells, guint num_keypoints,
+    guint * index, gfloat * value);
+
+extern void pose_decode_single (const PoseGrid * grid, const gfloat * heatmap,
+    const gfloat * offsets, PoseKeypoints * kp);
+extern void pose_decode_multi (const PoseGrid * grid, const gfloat * heatmap,
+    const gfloat * offsets, PoseKeypoints * kp);
+
+G_END_DECLS
+
+#endif /* __POSE_POSTPROCESS_H__ */
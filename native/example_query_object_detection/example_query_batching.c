@@ -0,0 +1,1152 @@
+/**
+ * @file	example_query_batching.c
+ * @date	19 Oct 2026
+ * @brief	tensor query server with dynamic request batching and its loopback load test
+ * @author	Gichan Jang <gichan2.jnag@samsung.com>
+ * @bug		No known bugs.
+ *
+ * The plain query server runs 'tensor_query_serversrc ! tensor_filter ! tensor_query_serversink',
+ * so the model is invoked once per client frame (batch size 1).
+ * The batching server splits the pipeline with appsink/appsrc:
+ *
+ *   tensor_query_serversrc ! appsink name=req_sink            (requests from all clients)
+ *   appsrc name=batch_src ! tensor_filter ! tensor_sink name=batch_sink   (one invoke per batch)
+ *   appsrc name=res_src ! tensor_query_serversink              (results routed back to each client)
+ *
+ * A batcher thread collects up to B requests or waits at most T microseconds,
+ * then concatenates them along the outermost (batch) dimension.
+ * The batched result is sliced per request and the query meta (client id) of each request
+ * is copied to its result, so tensor_query_serversink sends it back to the right client.
+ *
+ * Run example :
+ * $ ./nnstreamer_example_query_batching server --batch=8 --timeout-us=2000
+ * $ ./nnstreamer_example_query_batching client
+ * $ ./nnstreamer_example_query_batching loadtest --clients=1,2,4,8,16 --duration=5
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib.h>
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+#include <gst/app/gstappsink.h>
+#include <getopt.h>
+#include <nnstreamer_plugin_api.h>
+#include <nnstreamer/tensor_filter_custom_easy.h>
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) if (DBG) g_message (__VA_ARGS__)
+
+/**
+ * @brief Macro to check error case.
+ */
+#define _check_cond_err(cond) \
+  do { \
+    if (!(cond)) { \
+      _print_log ("app failed! [line : %d]", __LINE__); \
+      goto error; \
+    } \
+  } while (0)
+
+/**
+ * @brief Header written at the beginning of each request payload by the client.
+ * @note The synthetic model echoes the input, so the header comes back with the result.
+ * A real model (--model) does not, then the latency is not measured.
+ */
+typedef struct
+{
+  guint64 seq; /**< sequence number of the frame */
+  gint64 sent; /**< monotonic time (usec) when the frame was pushed */
+} FrameHeader;
+
+/**
+ * @brief Options shared by server, client and load test.
+ */
+typedef struct
+{
+  gchar *host; /**< server host address */
+  guint16 port; /**< server port */
+  gchar *connect_type; /**< TCP or HYBRID */
+  gchar *dest_host; /**< broker host for HYBRID */
+  guint16 dest_port; /**< broker port for HYBRID */
+  gchar *topic; /**< MQTT-hybrid topic */
+  guint server_id; /**< id shared by serversrc and serversink */
+
+  gchar *dim; /**< per-frame input dimension without batch, e.g. 3:300:300 */
+  gchar *type; /**< input tensor type */
+  gchar *out_dims; /**< per-frame output dimensions without batch */
+  gchar *out_types; /**< output tensor types */
+  gchar *model; /**< tflite model with batch dimension, NULL to use the synthetic model */
+
+  guint batch; /**< max frames in a batch (B) */
+  guint timeout_us; /**< max time to wait for a full batch (T) */
+  gboolean unbatched; /**< run the plain per-frame server */
+  guint fixed_cost_us; /**< synthetic model: cost per invoke */
+  guint frame_cost_us; /**< synthetic model: cost per frame in a batch */
+
+  guint inflight; /**< client: frames in flight per client */
+  guint reply_timeout_ms; /**< client: resend a frame without reply after this time */
+  guint duration; /**< running time in sec */
+  gchar *clients; /**< load test: comma separated client counts */
+} QueryOptions;
+
+/**
+ * @brief Pending batch, results come out of tensor_filter in the same order.
+ */
+typedef struct
+{
+  guint64 id; /**< batch number, set to the offset of the batch buffer */
+  GPtrArray *requests; /**< request buffers holding the query meta */
+} PendingBatch;
+
+/**
+ * @brief Data structure for the server.
+ */
+typedef struct
+{
+  QueryOptions *opt;
+  GstElement *pipeline;
+  GstElement *batch_src;
+  GstElement *res_src;
+  gchar *model_name; /**< registered custom-easy model name */
+
+  GAsyncQueue *requests; /**< request buffers from appsink */
+  GAsyncQueue *pending; /**< batches waiting for the result */
+  GThread *batcher;
+  gint running; /**< atomic, the batcher runs while set */
+
+  gsize frame_size; /**< size of a request tensor */
+  guint64 batches; /**< number of invokes */
+  guint64 frames; /**< number of requests */
+} QueryServer;
+
+/**
+ * @brief Data structure for a client.
+ */
+typedef struct
+{
+  GstElement *pipeline;
+  GstElement *src;
+  gsize frame_size;
+  guint64 seq; /**< next sequence number */
+  gboolean running;
+  gboolean echo; /**< the server echoes the header, the latency is measured */
+  GMutex lock;
+  GQueue *outstanding; /**< FrameHeader of the frames in flight, in send order */
+  GArray *latency; /**< round-trip latency of each frame (usec) */
+  guint64 replies; /**< replies matched to a frame in flight */
+  guint64 timeouts; /**< frames resent without reply */
+} QueryClient;
+
+/**
+ * @brief Print usage info
+ */
+static void
+_usage (void)
+{
+  g_message ("\nusage: nnstreamer_example_query_batching {server, client, loadtest} [options]\n"
+  "    --host        Set server host address. (default localhost) \n"
+  "    --port        Set server port. (default 5001) \n"
+  "    --connecttype Set connect type, TCP or HYBRID. (default TCP) \n"
+  "    --desthost    Set broker host for HYBRID. \n"
+  "    --destport    Set broker port for HYBRID. (default 1883) \n"
+  "    --topic       Set MQTT-hybrid topic. \n"
+  "    --dim         Set per-frame input dimension without batch. (default 3:300:300) \n"
+  "    --type        Set input tensor type. (default uint8) \n"
+  "    --outdims     Set per-frame output dimensions without batch. (default same as input) \n"
+  "    --outtypes    Set output tensor types. (default same as input) \n"
+  "    --model       Set tflite model with batch dimension. (default synthetic model) \n"
+  "                  The client does not measure the latency with a model, only the echo model returns the header. \n"
+  "    --batch       Set max frames in a batch. (default 8) \n"
+  "    --timeout-us  Set max time to wait for a full batch. (default 2000) \n"
+  "    --unbatched   Run the plain per-frame server. \n"
+  "    --fixed-cost  Set synthetic cost per invoke in usec. (default 4000) \n"
+  "    --frame-cost  Set synthetic cost per frame in usec. (default 500) \n"
+  "    --inflight    Set frames in flight per client. (default 1) \n"
+  "    --reply-timeout  Set the time in msec to resend a frame without reply. (default 1000) \n"
+  "    --duration    Set the running time in sec. (default 5) \n"
+  "    --clients     Set client counts for the load test. (default 1,2,4,8,16) \n");
+}
+
+/**
+ * @brief Get the batched dimension string, e.g. 3:300:300 to 3:300:300:8.
+ */
+static gchar *
+_get_batched_dims (const gchar * dims, guint batch)
+{
+  gchar **dim_arr = g_strsplit (dims, ",", -1);
+  guint i, num = g_strv_length (dim_arr);
+  GString *str = g_string_new (NULL);
+
+  for (i = 0; i < num; i++) {
+    if (i > 0)
+      g_string_append (str, ",");
+    g_string_append_printf (str, "%s:%u", g_strstrip (dim_arr[i]), batch);
+  }
+
+  g_strfreev (dim_arr);
+  return g_string_free (str, FALSE);
+}
+
+/**
+ * @brief Get the size of a per-frame tensor.
+ */
+static gsize
+_get_frame_size (const gchar * dim, const gchar * type)
+{
+  GstTensorInfo info;
+
+  memset (&info, 0, sizeof (GstTensorInfo));
+  info.type = gst_tensor_get_type (type);
+  gst_tensor_parse_dimension (dim, info.dimension);
+
+  return gst_tensor_info_get_size (&info);
+}
+
+/**
+ * @brief Parse tensors info for custom-easy model.
+ */
+static void
+_parse_tensors_info (GstTensorsInfo * info, const gchar * dims,
+    const gchar * types)
+{
+  gst_tensors_info_init (info);
+  info->num_tensors = gst_tensors_info_parse_dimensions_string (info, dims);
+  gst_tensors_info_parse_types_string (info, types);
+}
+
+/**
+ * @brief Synthetic model, echoes the input and costs fixed + frame * batch usec.
+ */
+static int
+_synthetic_invoke (void *data, const GstTensorFilterProperties * prop,
+    const GstTensorMemory * in, GstTensorMemory * out)
+{
+  QueryServer *server = (QueryServer *) data;
+  guint batch = server->opt->unbatched ? 1 : server->opt->batch;
+  unsigned int t;
+
+  for (t = 0; t < prop->output_meta.num_tensors; t++) {
+    if (prop->input_meta.num_tensors <= t)
+      memset (out[t].data, 0, out[t].size);
+    else
+      memcpy (out[t].data, in[t].data, MIN (in[t].size, out[t].size));
+  }
+
+  g_usleep (server->opt->fixed_cost_us + server->opt->frame_cost_us * batch);
+  return 0;
+}
+
+/**
+ * @brief Get the filter description of the server pipeline.
+ */
+static gchar *
+_get_filter_desc (QueryServer * server, guint batch)
+{
+  QueryOptions *opt = server->opt;
+  gchar *desc, *in_dims;
+
+  if (opt->model) {
+    in_dims = _get_batched_dims (opt->dim, batch);
+    desc = g_strdup_printf ("tensor_filter framework=tensorflow-lite model=%s "
+        "input=%s inputtype=%s", opt->model, in_dims, opt->type);
+    g_free (in_dims);
+  } else {
+    desc = g_strdup_printf ("tensor_filter framework=custom-easy model=%s",
+        server->model_name);
+  }
+
+  return desc;
+}
+
+/**
+ * @brief Get the properties of tensor_query_serversrc.
+ */
+static gchar *
+_get_serversrc_props (QueryOptions * opt)
+{
+  if (g_ascii_strcasecmp (opt->connect_type, "HYBRID") == 0) {
+    return g_strdup_printf ("id=%u host=%s port=%u dest-host=%s dest-port=%u "
+        "topic=%s connect-type=HYBRID", opt->server_id, opt->host, opt->port,
+        opt->dest_host, opt->dest_port, opt->topic);
+  }
+
+  return g_strdup_printf ("id=%u host=%s port=%u", opt->server_id, opt->host,
+      opt->port);
+}
+
+/**
+ * @brief Callback for appsink, queue the request for the batcher.
+ */
+static GstFlowReturn
+_request_cb (GstElement * sink, gpointer user_data)
+{
+  QueryServer *server = (QueryServer *) user_data;
+  GstSample *sample;
+  GstBuffer *buffer;
+
+  g_signal_emit_by_name (sink, "pull-sample", &sample);
+  if (!sample)
+    return GST_FLOW_ERROR;
+
+  buffer = gst_sample_get_buffer (sample);
+  if (buffer)
+    g_async_queue_push (server->requests, gst_buffer_ref (buffer));
+
+  gst_sample_unref (sample);
+  return GST_FLOW_OK;
+}
+
+/**
+ * @brief Free the pending batch and its requests.
+ */
+static void
+_free_pending_batch (PendingBatch * batch)
+{
+  g_ptr_array_set_free_func (batch->requests, (GDestroyNotify) gst_buffer_unref);
+  g_ptr_array_free (batch->requests, TRUE);
+  g_free (batch);
+}
+
+/**
+ * @brief Batcher thread, collects up to B requests or waits up to T usec.
+ */
+static gpointer
+_batcher_thread (gpointer user_data)
+{
+  QueryServer *server = (QueryServer *) user_data;
+  QueryOptions *opt = server->opt;
+  GstBuffer *req, *batch_buf;
+  PendingBatch *batch;
+  GstMapInfo map;
+  gint64 deadline, now;
+  guint i;
+
+  while (g_atomic_int_get (&server->running)) {
+    /* wait for the first request of the batch */
+    req = (GstBuffer *) g_async_queue_timeout_pop (server->requests, 100000);
+    if (!req)
+      continue;
+
+    batch = g_new0 (PendingBatch, 1);
+    batch->id = server->batches;
+    batch->requests = g_ptr_array_sized_new (opt->batch);
+    g_ptr_array_add (batch->requests, req);
+
+    deadline = g_get_monotonic_time () + opt->timeout_us;
+    while (batch->requests->len < opt->batch) {
+      now = g_get_monotonic_time ();
+      if (now >= deadline)
+        break;
+
+      req = (GstBuffer *) g_async_queue_timeout_pop (server->requests,
+          deadline - now);
+      if (!req)
+        break;
+      g_ptr_array_add (batch->requests, req);
+    }
+
+    /* concatenate requests, the rest of the batch is zero-padded */
+    batch_buf = gst_buffer_new_allocate (NULL, server->frame_size * opt->batch,
+        NULL);
+    gst_buffer_map (batch_buf, &map, GST_MAP_WRITE);
+    for (i = 0; i < batch->requests->len; i++) {
+      req = (GstBuffer *) g_ptr_array_index (batch->requests, i);
+      gst_buffer_extract (req, 0, map.data + i * server->frame_size,
+          server->frame_size);
+    }
+    if (i < opt->batch)
+      memset (map.data + i * server->frame_size, 0,
+          (opt->batch - i) * server->frame_size);
+    gst_buffer_unmap (batch_buf, &map);
+
+    /* tensor_filter copies the offset to the result, to match the result to the batch */
+    GST_BUFFER_OFFSET (batch_buf) = batch->id;
+
+    server->batches++;
+    server->frames += batch->requests->len;
+    _print_log ("batch [%" G_GUINT64_FORMAT "] frames %u", server->batches,
+        batch->requests->len);
+
+    g_async_queue_push (server->pending, batch);
+    if (gst_app_src_push_buffer (GST_APP_SRC (server->batch_src),
+            batch_buf) != GST_FLOW_OK) {
+      /* no result for this batch, the clients resend the frames */
+      _print_log ("failed to push batch");
+      if (g_async_queue_remove (server->pending, batch))
+        _free_pending_batch (batch);
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief Callback for batched result, slice it and route each frame to its client.
+ */
+static void
+_batch_result_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  QueryServer *server = (QueryServer *) user_data;
+  PendingBatch *batch;
+  GstBuffer *req, *res;
+  GstMemory *mem;
+  gsize slice;
+  guint i, m, num_mems;
+
+  /**
+   * The batches without result (the invoke failed or the result was dropped) are skipped,
+   * so a failed invoke does not shift the results of the following batches.
+   */
+  while ((batch = (PendingBatch *) g_async_queue_try_pop (server->pending))) {
+    if (GST_BUFFER_OFFSET (buffer) == GST_BUFFER_OFFSET_NONE ||
+        batch->id == GST_BUFFER_OFFSET (buffer))
+      break;
+
+    if (batch->id > GST_BUFFER_OFFSET (buffer)) {
+      /* result of a removed batch, keep the pending one */
+      g_async_queue_push_front (server->pending, batch);
+      batch = NULL;
+      break;
+    }
+
+    _print_log ("no result for batch [%" G_GUINT64_FORMAT "]", batch->id);
+    _free_pending_batch (batch);
+  }
+
+  if (!batch) {
+    _print_log ("unexpected result, no pending batch");
+    return;
+  }
+
+  num_mems = gst_buffer_n_memory (buffer);
+  for (i = 0; i < batch->requests->len; i++) {
+    req = (GstBuffer *) g_ptr_array_index (batch->requests, i);
+    res = gst_buffer_new ();
+
+    for (m = 0; m < num_mems; m++) {
+      mem = gst_buffer_peek_memory (buffer, m);
+      slice = mem->size / server->opt->batch;
+      gst_buffer_append_memory (res, gst_memory_share (mem, i * slice, slice));
+    }
+
+    /* the query meta holds the client id */
+    gst_buffer_copy_into (res, req, GST_BUFFER_COPY_METADATA, 0, -1);
+    gst_app_src_push_buffer (GST_APP_SRC (server->res_src), res);
+  }
+
+  _free_pending_batch (batch);
+}
+
+/**
+ * @brief Start the query server.
+ */
+static gboolean
+server_start (QueryServer * server, QueryOptions * opt)
+{
+  GstTensorsInfo in_info, out_info;
+  gchar *str_pipeline, *src_props, *filter, *in_dims, *out_dims;
+  const gchar *sink_props;
+  guint batch = opt->unbatched ? 1 : opt->batch;
+  GstElement *element;
+
+  memset (server, 0, sizeof (QueryServer));
+  server->opt = opt;
+  server->frame_size = _get_frame_size (opt->dim, opt->type);
+  server->model_name = g_strdup_printf ("query_batch_%u", opt->port);
+
+  if (!opt->model) {
+    in_dims = _get_batched_dims (opt->dim, batch);
+    out_dims = _get_batched_dims (opt->out_dims, batch);
+    _parse_tensors_info (&in_info, in_dims, opt->type);
+    _parse_tensors_info (&out_info, out_dims, opt->out_types);
+    NNS_custom_easy_register (server->model_name, _synthetic_invoke, server,
+        &in_info, &out_info);
+    g_free (in_dims);
+    g_free (out_dims);
+  }
+
+  src_props = _get_serversrc_props (opt);
+  sink_props = (g_ascii_strcasecmp (opt->connect_type, "HYBRID") == 0) ?
+      "connect-type=HYBRID" : "";
+  filter = _get_filter_desc (server, batch);
+  in_dims = _get_batched_dims (opt->dim, 1);
+
+  if (opt->unbatched) {
+    str_pipeline = g_strdup_printf
+        ("tensor_query_serversrc %s ! "
+        "other/tensors,num_tensors=1,dimensions=%s,types=%s,framerate=0/1,format=static ! "
+        "%s ! tensor_query_serversink id=%u %s sync=false async=false",
+        src_props, in_dims, opt->type, filter, opt->server_id, sink_props);
+  } else {
+    gchar *batch_dims = _get_batched_dims (opt->dim, batch);
+    gchar *res_dims = _get_batched_dims (opt->out_dims, 1);
+    gchar **out_arr = g_strsplit (opt->out_dims, ",", -1);
+    guint num_outputs = g_strv_length (out_arr);
+
+    g_strfreev (out_arr);
+
+    str_pipeline = g_strdup_printf
+        ("tensor_query_serversrc %s ! "
+        "other/tensors,num_tensors=1,dimensions=%s,types=%s,framerate=0/1,format=static ! "
+        "appsink name=req_sink emit-signals=true sync=false "
+        "appsrc name=batch_src format=time is-live=true "
+        "caps=other/tensors,num_tensors=1,dimensions=%s,types=%s,framerate=0/1,format=static ! "
+        "%s ! tensor_sink name=batch_sink sync=false "
+        "appsrc name=res_src format=time is-live=true "
+        "caps=other/tensors,num_tensors=%u,dimensions=%s,types=%s,framerate=0/1,format=static ! "
+        "tensor_query_serversink id=%u %s sync=false async=false",
+        src_props, in_dims, opt->type, batch_dims, opt->type, filter,
+        num_outputs, res_dims, opt->out_types, opt->server_id, sink_props);
+
+    g_free (batch_dims);
+    g_free (res_dims);
+  }
+  g_free (src_props);
+  g_free (filter);
+  g_free (in_dims);
+
+  _print_log ("%s", str_pipeline);
+  server->pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  _check_cond_err (server->pipeline != NULL);
+
+  if (!opt->unbatched) {
+    server->requests = g_async_queue_new ();
+    server->pending = g_async_queue_new ();
+
+    element = gst_bin_get_by_name (GST_BIN (server->pipeline), "req_sink");
+    _check_cond_err (element != NULL);
+    g_signal_connect (element, "new-sample", (GCallback) _request_cb, server);
+    gst_object_unref (element);
+
+    element = gst_bin_get_by_name (GST_BIN (server->pipeline), "batch_sink");
+    _check_cond_err (element != NULL);
+    g_signal_connect (element, "new-data", (GCallback) _batch_result_cb, server);
+    gst_object_unref (element);
+
+    server->batch_src = gst_bin_get_by_name (GST_BIN (server->pipeline),
+        "batch_src");
+    server->res_src = gst_bin_get_by_name (GST_BIN (server->pipeline),
+        "res_src");
+    _check_cond_err (server->batch_src != NULL && server->res_src != NULL);
+
+    g_atomic_int_set (&server->running, 1);
+    server->batcher = g_thread_new ("query_batcher", _batcher_thread, server);
+  }
+
+  _check_cond_err (gst_element_set_state (server->pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+  return TRUE;
+
+error:
+  return FALSE;
+}
+
+/**
+ * @brief Stop the query server and release resources.
+ */
+static void
+server_stop (QueryServer * server)
+{
+  PendingBatch *batch;
+  GstBuffer *req;
+
+  if (server->batcher) {
+    g_atomic_int_set (&server->running, 0);
+    g_thread_join (server->batcher);
+    server->batcher = NULL;
+  }
+
+  if (server->pipeline) {
+    gst_element_set_state (server->pipeline, GST_STATE_NULL);
+    g_usleep (200 * 1000);
+  }
+
+  if (server->requests) {
+    while ((req = (GstBuffer *) g_async_queue_try_pop (server->requests)))
+      gst_buffer_unref (req);
+    g_async_queue_unref (server->requests);
+    server->requests = NULL;
+  }
+
+  if (server->pending) {
+    while ((batch = (PendingBatch *) g_async_queue_try_pop (server->pending)))
+      _free_pending_batch (batch);
+    g_async_queue_unref (server->pending);
+    server->pending = NULL;
+  }
+
+  if (server->batch_src) {
+    gst_object_unref (server->batch_src);
+    server->batch_src = NULL;
+  }
+
+  if (server->res_src) {
+    gst_object_unref (server->res_src);
+    server->res_src = NULL;
+  }
+
+  if (server->pipeline) {
+    gst_object_unref (server->pipeline);
+    server->pipeline = NULL;
+  }
+
+  if (!server->opt->model)
+    NNS_custom_easy_unregister (server->model_name);
+  g_free (server->model_name);
+  server->model_name = NULL;
+}
+
+/**
+ * @brief Push a new frame with the header, called with the lock.
+ */
+static void
+_client_push_frame (QueryClient * client)
+{
+  GstBuffer *buf;
+  FrameHeader *header;
+
+  buf = gst_buffer_new_allocate (NULL, client->frame_size, NULL);
+  gst_buffer_memset (buf, 0, 0x7f, client->frame_size);
+
+  header = g_new (FrameHeader, 1);
+  header->seq = client->seq++;
+  header->sent = g_get_monotonic_time ();
+  gst_buffer_fill (buf, 0, header, sizeof (FrameHeader));
+  g_queue_push_tail (client->outstanding, header);
+
+  if (gst_app_src_push_buffer (GST_APP_SRC (client->src), buf) != GST_FLOW_OK) {
+    _print_log ("failed to push buffer [%" G_GUINT64_FORMAT "]", header->seq);
+  }
+}
+
+/**
+ * @brief Find the frame in flight with the header of the reply.
+ */
+static gint
+_compare_header (gconstpointer a, gconstpointer b)
+{
+  const FrameHeader *ha = (const FrameHeader *) a;
+  const FrameHeader *hb = (const FrameHeader *) b;
+
+  return (ha->seq == hb->seq && ha->sent == hb->sent) ? 0 : 1;
+}
+
+/**
+ * @brief Callback for query result, measure the round-trip and send the next frame.
+ */
+static void
+_client_result_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  QueryClient *client = (QueryClient *) user_data;
+  FrameHeader header;
+  GList *found = NULL;
+  gint64 latency;
+
+  g_mutex_lock (&client->lock);
+  if (!client->running)
+    goto done;
+
+  if (client->echo) {
+    if (gst_buffer_extract (buffer, 0, &header, sizeof (FrameHeader)) !=
+        sizeof (FrameHeader))
+      goto done;
+
+    /* a late reply of a resent frame is not in flight anymore */
+    found = g_queue_find_custom (client->outstanding, &header, _compare_header);
+    if (!found)
+      goto done;
+
+    latency = g_get_monotonic_time () - header.sent;
+    g_array_append_val (client->latency, latency);
+    g_free (found->data);
+    g_queue_delete_link (client->outstanding, found);
+  } else {
+    /* the result of a model has no header, the reply completes the oldest frame */
+    if (g_queue_is_empty (client->outstanding))
+      goto done;
+    g_free (g_queue_pop_head (client->outstanding));
+  }
+
+  client->replies++;
+  _client_push_frame (client);
+
+done:
+  g_mutex_unlock (&client->lock);
+}
+
+/**
+ * @brief Resend the frames without reply in the timeout, so a lost reply does not stall the client.
+ */
+static void
+_client_check_timeout (QueryClient * client, guint timeout_ms)
+{
+  FrameHeader *header;
+  gint64 expired = g_get_monotonic_time () - (gint64) timeout_ms * 1000;
+
+  g_mutex_lock (&client->lock);
+  while (client->running &&
+      (header = (FrameHeader *) g_queue_peek_head (client->outstanding)) &&
+      header->sent < expired) {
+    g_free (g_queue_pop_head (client->outstanding));
+    client->timeouts++;
+    _client_push_frame (client);
+  }
+  g_mutex_unlock (&client->lock);
+}
+
+/**
+ * @brief Start a closed-loop client with given frames in flight.
+ */
+static gboolean
+client_start (QueryClient * client, QueryOptions * opt)
+{
+  gchar *str_pipeline, *in_dims;
+  GstElement *element;
+  guint i;
+
+  memset (client, 0, sizeof (QueryClient));
+  g_mutex_init (&client->lock);
+  client->frame_size = _get_frame_size (opt->dim, opt->type);
+  client->latency = g_array_new (FALSE, FALSE, sizeof (gint64));
+  client->outstanding = g_queue_new ();
+  client->echo = (opt->model == NULL);
+
+  in_dims = _get_batched_dims (opt->dim, 1);
+  if (g_ascii_strcasecmp (opt->connect_type, "HYBRID") == 0) {
+    str_pipeline = g_strdup_printf
+        ("appsrc name=src format=time is-live=true "
+        "caps=other/tensors,num_tensors=1,dimensions=%s,types=%s,framerate=0/1,format=static ! "
+        "tensor_query_client connect-type=HYBRID host=localhost port=0 "
+        "dest-host=%s dest-port=%u topic=%s ! tensor_sink name=sinkx sync=false",
+        in_dims, opt->type, opt->dest_host, opt->dest_port, opt->topic);
+  } else {
+    str_pipeline = g_strdup_printf
+        ("appsrc name=src format=time is-live=true "
+        "caps=other/tensors,num_tensors=1,dimensions=%s,types=%s,framerate=0/1,format=static ! "
+        "tensor_query_client host=localhost port=0 dest-host=%s dest-port=%u ! "
+        "tensor_sink name=sinkx sync=false",
+        in_dims, opt->type, opt->host, opt->port);
+  }
+  g_free (in_dims);
+
+  client->pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  _check_cond_err (client->pipeline != NULL);
+
+  element = gst_bin_get_by_name (GST_BIN (client->pipeline), "sinkx");
+  _check_cond_err (element != NULL);
+  g_signal_connect (element, "new-data", (GCallback) _client_result_cb, client);
+  gst_object_unref (element);
+
+  client->src = gst_bin_get_by_name (GST_BIN (client->pipeline), "src");
+  _check_cond_err (client->src != NULL);
+
+  _check_cond_err (gst_element_set_state (client->pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+
+  g_mutex_lock (&client->lock);
+  client->running = TRUE;
+  for (i = 0; i < opt->inflight; i++)
+    _client_push_frame (client);
+  g_mutex_unlock (&client->lock);
+  return TRUE;
+
+error:
+  return FALSE;
+}
+
+/**
+ * @brief Stop receiving results, latencies are kept for the report.
+ */
+static void
+client_stop (QueryClient * client)
+{
+  g_mutex_lock (&client->lock);
+  client->running = FALSE;
+  g_mutex_unlock (&client->lock);
+
+  if (client->pipeline) {
+    gst_element_set_state (client->pipeline, GST_STATE_NULL);
+    gst_object_unref (client->pipeline);
+    client->pipeline = NULL;
+  }
+
+  if (client->src) {
+    gst_object_unref (client->src);
+    client->src = NULL;
+  }
+}
+
+/**
+ * @brief Release client data.
+ */
+static void
+client_free (QueryClient * client)
+{
+  if (client->latency) {
+    g_array_free (client->latency, TRUE);
+    client->latency = NULL;
+  }
+  if (client->outstanding) {
+    g_queue_free_full (client->outstanding, g_free);
+    client->outstanding = NULL;
+  }
+  g_mutex_clear (&client->lock);
+}
+
+/**
+ * @brief Compare function for latency values.
+ */
+static gint
+_compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 la = *((const gint64 *) a);
+  gint64 lb = *((const gint64 *) b);
+
+  return (la > lb) ? 1 : ((la < lb) ? -1 : 0);
+}
+
+/**
+ * @brief Get the percentile from the sorted latency array.
+ */
+static gint64
+_percentile (GArray * sorted, gdouble p)
+{
+  guint idx;
+
+  if (sorted->len == 0)
+    return 0;
+
+  idx = (guint) (p / 100.0 * (sorted->len - 1) + 0.5);
+  return g_array_index (sorted, gint64, MIN (idx, sorted->len - 1));
+}
+
+/**
+ * @brief Print the result of clients. Latency values are merged and sorted.
+ */
+static void
+_report (const gchar * mode, guint num_clients, QueryClient * clients,
+    gdouble elapsed)
+{
+  GArray *all = g_array_new (FALSE, FALSE, sizeof (gint64));
+  guint64 replies = 0, timeouts = 0;
+  guint i;
+
+  for (i = 0; i < num_clients; i++) {
+    g_array_append_vals (all, clients[i].latency->data, clients[i].latency->len);
+    replies += clients[i].replies;
+    timeouts += clients[i].timeouts;
+  }
+  g_array_sort (all, _compare_latency);
+
+  if (all->len > 0) {
+    g_print ("%s,%u,%" G_GUINT64_FORMAT ",%.1f,%.2f,%.2f,%.2f,%.2f,%"
+        G_GUINT64_FORMAT "\n", mode, num_clients, replies, replies / elapsed,
+        _percentile (all, 50.0) / 1000.0, _percentile (all, 90.0) / 1000.0,
+        _percentile (all, 99.0) / 1000.0, _percentile (all, 99.9) / 1000.0,
+        timeouts);
+  } else {
+    /* no latency without the echo model */
+    g_print ("%s,%u,%" G_GUINT64_FORMAT ",%.1f,NA,NA,NA,NA,%" G_GUINT64_FORMAT
+        "\n", mode, num_clients, replies, replies / elapsed, timeouts);
+  }
+
+  g_array_free (all, TRUE);
+}
+
+/**
+ * @brief Run clients against the server for the given duration.
+ */
+static gboolean
+_run_clients (QueryOptions * opt, const gchar * mode, guint num_clients)
+{
+  QueryClient *clients = g_new0 (QueryClient, num_clients);
+  gint64 start, end;
+  gdouble elapsed;
+  gboolean ret = TRUE;
+  guint i;
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < num_clients; i++) {
+    if (!client_start (&clients[i], opt)) {
+      g_critical ("Failed to start client %u.", i);
+      ret = FALSE;
+    }
+  }
+
+  if (ret) {
+    /* resend the frames without reply while running */
+    end = start + (gint64) opt->duration * G_USEC_PER_SEC;
+    while (g_get_monotonic_time () < end) {
+      g_usleep (MIN (50 * 1000, MAX (end - g_get_monotonic_time (), 0)));
+      for (i = 0; i < num_clients; i++)
+        _client_check_timeout (&clients[i], opt->reply_timeout_ms);
+    }
+  }
+
+  for (i = 0; i < num_clients; i++)
+    client_stop (&clients[i]);
+  elapsed = (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+
+  if (ret)
+    _report (mode, num_clients, clients, elapsed);
+
+  for (i = 0; i < num_clients; i++)
+    client_free (&clients[i]);
+  g_free (clients);
+  return ret;
+}
+
+/**
+ * @brief Sweep client count against the unbatched and the batched server.
+ */
+static void
+_run_loadtest (QueryOptions * opt)
+{
+  QueryServer server;
+  gchar **counts = g_strsplit (opt->clients, ",", -1);
+  guint16 base_port = opt->port;
+  guint i, m, num_clients;
+  gchar *mode;
+
+  g_print ("mode,clients,frames,fps,p50_ms,p90_ms,p99_ms,p999_ms,timeouts\n");
+
+  for (i = 0; counts[i]; i++) {
+    num_clients = (guint) g_ascii_strtoull (counts[i], NULL, 10);
+    if (num_clients == 0)
+      continue;
+
+    for (m = 0; m < 2; m++) {
+      opt->unbatched = (m == 0);
+      /* use new port for each run to avoid waiting for closed sockets */
+      opt->port = base_port + i * 2 + m;
+
+      if (!server_start (&server, opt)) {
+        g_critical ("Failed to start server.");
+        server_stop (&server);
+        continue;
+      }
+      /* wait for the server to be ready */
+      g_usleep (500 * 1000);
+
+      if (opt->unbatched) {
+        mode = g_strdup ("unbatched");
+      } else {
+        mode = g_strdup_printf ("batch%u/%uus", opt->batch, opt->timeout_us);
+      }
+
+      _run_clients (opt, mode, num_clients);
+      g_free (mode);
+
+      if (!opt->unbatched) {
+        _print_log ("avg batch %.2f", server.batches ?
+            server.frames / (gdouble) server.batches : 0.0);
+      }
+      server_stop (&server);
+    }
+  }
+
+  opt->port = base_port;
+  g_strfreev (counts);
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  QueryOptions opt;
+  QueryServer server;
+  gint opt_ch;
+  struct option long_options[] = {
+      { "host", required_argument, NULL, 'u' },
+      { "port", required_argument, NULL, 'b' },
+      { "connecttype", required_argument, NULL, 'p' },
+      { "desthost", required_argument, NULL, 'm' },
+      { "destport", required_argument, NULL, 'd' },
+      { "topic", required_argument, NULL, 'o' },
+      { "dim", required_argument, NULL, 'i' },
+      { "type", required_argument, NULL, 'y' },
+      { "outdims", required_argument, NULL, 'I' },
+      { "outtypes", required_argument, NULL, 'Y' },
+      { "model", required_argument, NULL, 'f' },
+      { "batch", required_argument, NULL, 'B' },
+      { "timeout-us", required_argument, NULL, 'T' },
+      { "unbatched", no_argument, NULL, 'U' },
+      { "fixed-cost", required_argument, NULL, 'x' },
+      { "frame-cost", required_argument, NULL, 'e' },
+      { "inflight", required_argument, NULL, 'n' },
+      { "reply-timeout", required_argument, NULL, 'R' },
+      { "duration", required_argument, NULL, 't' },
+      { "clients", required_argument, NULL, 'c' },
+      { "help", no_argument, NULL, 'h' },
+      { 0, 0, 0, 0}
+  };
+  const gchar *cmd;
+
+  if (argc < 2) {
+    _usage ();
+    return 0;
+  }
+  cmd = argv[1];
+
+  /* init gstreamer */
+  gst_init (&argc, &argv);
+
+  memset (&opt, 0, sizeof (QueryOptions));
+  opt.host = g_strdup ("localhost");
+  opt.port = 5001;
+  opt.connect_type = g_strdup ("TCP");
+  opt.dest_host = g_strdup ("tcp://localhost");
+  opt.dest_port = 1883;
+  opt.topic = g_strdup ("objectDetection");
+  opt.server_id = 123;
+  opt.dim = g_strdup ("3:300:300");
+  opt.type = g_strdup ("uint8");
+  opt.batch = 8;
+  opt.timeout_us = 2000;
+  opt.fixed_cost_us = 4000;
+  opt.frame_cost_us = 500;
+  opt.inflight = 1;
+  opt.reply_timeout_ms = 1000;
+  opt.duration = 5;
+  opt.clients = g_strdup ("1,2,4,8,16");
+
+  /* skip the command */
+  optind = 2;
+  while ((opt_ch = getopt_long (argc, argv, "", long_options, NULL)) != -1) {
+    switch (opt_ch) {
+      case 'u':
+        g_free (opt.host);
+        opt.host = g_strdup (optarg);
+        break;
+      case 'b':
+        opt.port = (guint16) g_ascii_strtoll (optarg, NULL, 10);
+        break;
+      case 'p':
+        g_free (opt.connect_type);
+        opt.connect_type = g_strdup (optarg);
+        break;
+      case 'm':
+        g_free (opt.dest_host);
+        opt.dest_host = g_strdup (optarg);
+        break;
+      case 'd':
+        opt.dest_port = (guint16) g_ascii_strtoll (optarg, NULL, 10);
+        break;
+      case 'o':
+        g_free (opt.topic);
+        opt.topic = g_strdup (optarg);
+        break;
+      case 'i':
+        g_free (opt.dim);
+        opt.dim = g_strdup (optarg);
+        break;
+      case 'y':
+        g_free (opt.type);
+        opt.type = g_strdup (optarg);
+        break;
+      case 'I':
+        g_free (opt.out_dims);
+        opt.out_dims = g_strdup (optarg);
+        break;
+      case 'Y':
+        g_free (opt.out_types);
+        opt.out_types = g_strdup (optarg);
+        break;
+      case 'f':
+        g_free (opt.model);
+        opt.model = g_strdup (optarg);
+        break;
+      case 'B':
+        opt.batch = MAX (1, (guint) g_ascii_strtoull (optarg, NULL, 10));
+        break;
+      case 'T':
+        opt.timeout_us = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'U':
+        opt.unbatched = TRUE;
+        break;
+      case 'x':
+        opt.fixed_cost_us = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'e':
+        opt.frame_cost_us = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'n':
+        opt.inflight = MAX (1, (guint) g_ascii_strtoull (optarg, NULL, 10));
+        break;
+      case 'R':
+        opt.reply_timeout_ms = MAX (1, (guint) g_ascii_strtoull (optarg, NULL, 10));
+        break;
+      case 't':
+        opt.duration = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'c':
+        g_free (opt.clients);
+        opt.clients = g_strdup (optarg);
+        break;
+      default:
+        _usage ();
+        goto done;
+    }
+  }
+
+  if (!opt.out_dims)
+    opt.out_dims = g_strdup (opt.dim);
+  if (!opt.out_types)
+    opt.out_types = g_strdup (opt.type);
+
+  if (_get_frame_size (opt.dim, opt.type) < sizeof (FrameHeader)) {
+    g_critical ("The input tensor is too small to hold the frame header.");
+    goto done;
+  }
+
+  if (g_strcmp0 (cmd, "server") == 0) {
+    if (server_start (&server, &opt)) {
+      g_print ("Server is running (%s).\n", opt.unbatched ? "unbatched" :
+          "batched");
+      g_usleep ((guint64) opt.duration * G_USEC_PER_SEC);
+      if (!opt.unbatched && server.batches > 0) {
+        g_print ("batches: %" G_GUINT64_FORMAT ", frames: %" G_GUINT64_FORMAT
+            ", avg batch: %.2f\n", server.batches, server.frames,
+            server.frames / (gdouble) server.batches);
+      }
+    }
+    server_stop (&server);
+  } else if (g_strcmp0 (cmd, "client") == 0) {
+    g_print ("mode,clients,frames,fps,p50_ms,p90_ms,p99_ms,p999_ms,timeouts\n");
+    _run_clients (&opt, "client", 1);
+  } else if (g_strcmp0 (cmd, "loadtest") == 0) {
+    _run_loadtest (&opt);
+  } else {
+    _usage ();
+  }
+
+done:
+  g_free (opt.host);
+  g_free (opt.connect_type);
+  g_free (opt.dest_host);
+  g_free (opt.topic);
+  g_free (opt.dim);
+  g_free (opt.type);
+  g_free (opt.out_dims);
+  g_free (opt.out_types);
+  g_free (opt.model);
+  g_free (opt.clients);
+
+  return 0;
+}
@@ -0,0 +1,1009 @@
+/**
+ * @file	example_query_compressed.c
+ * @date	19 Oct 2026
+ * @brief	tensor query object detection with compressed-frame transport and compact results
+ * @author	Gichan Jang <gichan2.jnag@samsung.com>
+ * @bug		No known bugs.
+ *
+ * The client of example_query_object_detection sends raw frames to the server,
+ * and the server sends rendered video back. On constrained links the bandwidth dominates latency.
+ * This example encodes the frame before tensor_query_client (jpegenc or zlib) and decodes it on the server.
+ * With 'result=tensor', the server decodes SSD outputs and returns compact detection tensors
+ * (float32, 6:MAX_DETECTION) instead of video.
+ *
+ * The zlib transport compresses each frame on its own (appsink and appsrc around GZlibCompressor),
+ * with a header of the raw frame size. A stream codec such as gzenc does not keep the frame boundary,
+ * then tensor_query_client cannot send each frame as a request.
+ * The query meta (client id) of the request is copied to the decompressed frame on the server.
+ *
+ * Each row of the result tensor is [xmin, ymin, width, height, class id, score],
+ * the box is normalized to [0, 1]. The row with score 0 is empty.
+ *
+ * Run example :
+ * $ ./nnstreamer_example_query_compressed --server --transport=jpeg --result=tensor
+ * $ ./nnstreamer_example_query_compressed --client --transport=jpeg --result=tensor
+ * Headless benchmark, reports bytes per frame and round-trip latency :
+ * $ ./nnstreamer_example_query_compressed --client --transport=jpeg --result=tensor --bench --src=file:clip.mp4
+ * Without --src, the benchmark uses the snow pattern of videotestsrc, the worst case of the compression.
+ * Use a recorded clip of the camera for the compression ratio of the real frames.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <glib.h>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <gst/app/app.h>
+#include <gio/gio.h>
+#include <getopt.h>
+#include <cairo.h>
+#include <nnstreamer_plugin_api.h>
+#include <nnstreamer/tensor_filter_custom_easy.h>
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) if (DBG) g_message (__VA_ARGS__)
+
+/**
+ * @brief Macro to check error case.
+ */
+#define _check_cond_err(cond) \
+  do { \
+    if (!(cond)) { \
+      _print_log ("app failed! [line : %d]", __LINE__); \
+      goto error; \
+    } \
+  } while (0)
+
+#define VIDEO_WIDTH 640
+#define VIDEO_HEIGHT 480
+#define VIDEO_FRAME_SIZE (VIDEO_WIDTH * VIDEO_HEIGHT * 3)
+#define MODEL_WIDTH 300
+#define MODEL_HEIGHT 300
+
+#define Y_SCALE 10.0f
+#define X_SCALE 10.0f
+#define H_SCALE 5.0f
+#define W_SCALE 5.0f
+
+#define BOX_SIZE 4
+#define LABEL_SIZE 91
+#define DETECTION_MAX 1917
+
+/**
+ * @brief Max detected objects in the compact result.
+ */
+#define MAX_DETECTION 20
+
+/**
+ * @brief Values of each detected object in the compact result.
+ */
+#define DETECTION_INFO 6
+
+/**
+ * @brief Magic number of the compressed frame header.
+ */
+#define ZFRAME_MAGIC 0x4e4e535aU
+
+/**
+ * @brief Compression level of zlib, the frame is compressed in the streaming thread.
+ */
+#define ZFRAME_LEVEL 1
+
+/**
+ * @brief Header of a compressed frame.
+ */
+typedef struct
+{
+  guint32 magic; /**< ZFRAME_MAGIC */
+  guint32 size; /**< size of the raw frame */
+} ZFrameHeader;
+
+/**
+ * @brief Frame transport between client and server.
+ */
+typedef enum
+{
+  TRANSPORT_RAW,
+  TRANSPORT_JPEG,
+  TRANSPORT_ZLIB
+} transport_type;
+
+/**
+ * @brief Detected object, the box is normalized to [0, 1].
+ */
+typedef struct
+{
+  gfloat x;
+  gfloat y;
+  gfloat width;
+  gfloat height;
+  gint class_id;
+  gfloat prob;
+} DetectedObject;
+
+/**
+ * @brief Data structure for app.
+ */
+typedef struct
+{
+  GMainLoop *loop; /**< main event loop */
+  GstElement *pipeline; /**< gst pipeline for data stream */
+  GstElement *zsrc; /**< appsrc pushing the compressed or decompressed frames (zlib transport) */
+  gboolean is_server;
+  gboolean bench; /**< headless client without display, print statistics */
+  gchar *src; /**< video source of the client, NULL for the default */
+  gboolean result_tensor; /**< server returns compact detection tensors */
+  transport_type transport;
+  guint quality; /**< jpeg quality */
+  guint framerate;
+  guint timeout; /**< running time in sec */
+  gchar *host;
+  guint16 port;
+  gchar *model_path;
+  gchar *label_path;
+  gchar *box_prior_path;
+
+  gfloat box_priors[BOX_SIZE][DETECTION_MAX]; /**< box priors for SSD decoding */
+  GList *labels; /**< list of loaded labels */
+
+  GMutex mutex; /**< mutex for result and statistics */
+  DetectedObject detected[MAX_DETECTION]; /**< latest result */
+  guint num_detected;
+
+  GQueue *in_flight; /**< SentFrame of each frame in flight, in send order */
+  guint64 sent; /**< number of sent frames */
+  guint64 frames; /**< number of received results */
+  guint64 unmatched; /**< results without a sent frame of the same PTS */
+  guint64 bytes_sent; /**< total payload bytes sent to the server, without the protocol overhead */
+  guint64 bytes_received; /**< total payload bytes received from the server */
+  GArray *latency; /**< round-trip latency of each frame (usec) */
+} AppData;
+
+/**
+ * @brief Data for pipeline and result.
+ */
+static AppData g_app;
+
+/**
+ * @brief Max frames in flight to match the results.
+ */
+#define MAX_IN_FLIGHT 256
+
+/**
+ * @brief Send time of a frame, matched to the result by PTS.
+ */
+typedef struct
+{
+  GstClockTime pts;
+  gint64 time;
+} SentFrame;
+
+/**
+ * @brief Print usage info
+ */
+static void
+_usage (void)
+{
+  g_message ("\nusage: \n"
+  "    --server     Run server pipeline. \n"
+  "    --client     Run client pipeline. (default) \n"
+  "    --host       Set server host address. (default localhost) \n"
+  "    --port       Set server port. (default 3000) \n"
+  "    --transport  Set frame transport, raw, jpeg or zlib. (default raw) \n"
+  "    --quality    Set jpeg quality. (default 85) \n"
+  "    --result     Set result type, video or tensor. (default video) \n"
+  "    --framerate  Set the framerate of the video. (default 30) \n"
+  "    --timeout    Set the running time in sec. (default 10) \n"
+  "    --src        Set the video source of the client, videotestsrc, /dev/videoX or file:PATH. \n"
+  "                 (default v4l2src, snow pattern of videotestsrc with --bench) \n"
+  "    --bench      Run client without display and print statistics. \n");
+}
+
+/**
+ * @brief Read strings from file.
+ */
+static gboolean
+_read_lines (const gchar * file_name, GList ** lines)
+{
+  gchar *contents = NULL;
+  gchar **strv;
+  guint i;
+
+  if (!g_file_get_contents (file_name, &contents, NULL, NULL)) {
+    g_critical ("Failed to open file %s", file_name);
+    return FALSE;
+  }
+
+  strv = g_strsplit (contents, "\n", -1);
+  for (i = 0; strv[i]; i++) {
+    if (strv[i][0] != '\0')
+      *lines = g_list_append (*lines, g_strdup (strv[i]));
+  }
+
+  g_strfreev (strv);
+  g_free (contents);
+  return TRUE;
+}
+
+/**
+ * @brief Load box priors.
+ */
+static gboolean
+_load_box_priors (void)
+{
+  GList *rows = NULL;
+  gchar **values;
+  guint row, col, num;
+
+  if (!_read_lines (g_app.box_prior_path, &rows))
+    return FALSE;
+
+  if (g_list_length (rows) < BOX_SIZE) {
+    g_critical ("Invalid box priors %s", g_app.box_prior_path);
+    g_list_free_full (rows, g_free);
+    return FALSE;
+  }
+
+  for (row = 0; row < BOX_SIZE; row++) {
+    values = g_strsplit ((gchar *) g_list_nth_data (rows, row), " ", -1);
+    for (col = 0, num = 0; values[num] && col < DETECTION_MAX; num++) {
+      if (values[num][0] == '\0')
+        continue;
+      g_app.box_priors[row][col++] = (gfloat) g_ascii_strtod (values[num], NULL);
+    }
+
+    g_strfreev (values);
+  }
+
+  g_list_free_full (rows, g_free);
+  return TRUE;
+}
+
+/**
+ * @brief Intersection of union
+ */
+static gfloat
+_iou (const DetectedObject * a, const DetectedObject * b)
+{
+  gfloat x1 = MAX (a->x, b->x);
+  gfloat y1 = MAX (a->y, b->y);
+  gfloat x2 = MIN (a->x + a->width, b->x + b->width);
+  gfloat y2 = MIN (a->y + a->height, b->y + b->height);
+  gfloat w = MAX (0.0f, x2 - x1);
+  gfloat h = MAX (0.0f, y2 - y1);
+  gfloat inter = w * h;
+  gfloat area = a->width * a->height + b->width * b->height - inter;
+
+  return (area > 0.0f) ? inter / area : 0.0f;
+}
+
+/**
+ * @brief Compare score of detected objects.
+ */
+static gint
+_compare_objs (gconstpointer a, gconstpointer b)
+{
+  const DetectedObject *oa = (const DetectedObject *) a;
+  const DetectedObject *ob = (const DetectedObject *) b;
+
+  return (oa->prob < ob->prob) ? 1 : ((oa->prob > ob->prob) ? -1 : 0);
+}
+
+#define _expit(x) \
+    (1.f / (1.f + expf (-(x))))
+
+/**
+ * @brief Function for custom-easy filter, decodes SSD outputs into compact detections.
+ * @note input[0] boxes 4:1:1917:1, input[1] detections 91:1917:1, output[0] 6:20:1:1
+ */
+static int
+_ssd_compact_invoke (void *data, const GstTensorFilterProperties * prop,
+    const GstTensorMemory * in, GstTensorMemory * out)
+{
+  const gfloat threshold_score = .5f;
+  const gfloat threshold_iou = .5f;
+  const gfloat *boxes = (const gfloat *) in[0].data;
+  const gfloat *detections = (const gfloat *) in[1].data;
+  gfloat *result = (gfloat *) out[0].data;
+  GArray *objs = g_array_new (FALSE, FALSE, sizeof (DetectedObject));
+  DetectedObject obj, *cur;
+  gboolean *del;
+  guint d, c, i, j, num = 0;
+
+  for (d = 0; d < DETECTION_MAX; d++) {
+    gfloat ycenter = boxes[0] / Y_SCALE * g_app.box_priors[2][d] +
+        g_app.box_priors[0][d];
+    gfloat xcenter = boxes[1] / X_SCALE * g_app.box_priors[3][d] +
+        g_app.box_priors[1][d];
+    gfloat h = expf (boxes[2] / H_SCALE) * g_app.box_priors[2][d];
+    gfloat w = expf (boxes[3] / W_SCALE) * g_app.box_priors[3][d];
+
+    for (c = 1; c < LABEL_SIZE; c++) {
+      gfloat score = _expit (detections[c]);
+
+      if (score < threshold_score)
+        continue;
+
+      obj.x = xcenter - w / 2.f;
+      obj.y = ycenter - h / 2.f;
+      obj.width = w;
+      obj.height = h;
+      obj.class_id = c;
+      obj.prob = score;
+      g_array_append_val (objs, obj);
+    }
+
+    detections += LABEL_SIZE;
+    boxes += BOX_SIZE;
+  }
+
+  /* nms */
+  g_array_sort (objs, _compare_objs);
+  del = g_new0 (gboolean, objs->len + 1);
+  memset (result, 0, out[0].size);
+
+  for (i = 0; i < objs->len && num < MAX_DETECTION; i++) {
+    if (del[i])
+      continue;
+
+    cur = &g_array_index (objs, DetectedObject, i);
+    for (j = i + 1; j < objs->len; j++) {
+      if (!del[j] &&
+          _iou (cur, &g_array_index (objs, DetectedObject, j)) > threshold_iou)
+        del[j] = TRUE;
+    }
+
+    result[0] = cur->x;
+    result[1] = cur->y;
+    result[2] = cur->width;
+    result[3] = cur->height;
+    result[4] = (gfloat) cur->class_id;
+    result[5] = cur->prob;
+    result += DETECTION_INFO;
+    num++;
+  }
+
+  g_free (del);
+  g_array_free (objs, TRUE);
+  return 0;
+}
+
+/**
+ * @brief Compress or decompress the data with zlib.
+ * @return the size of the output, 0 if failed or the output is not large enough.
+ */
+static gsize
+_zlib_convert (gboolean compress, const guint8 * in, gsize in_size, guint8 * out,
+    gsize out_size)
+{
+  GConverter *converter;
+  GConverterResult result;
+  gsize read = 0, written = 0, total_read = 0, total_written = 0;
+
+  if (compress)
+    converter = G_CONVERTER (g_zlib_compressor_new (G_ZLIB_COMPRESSOR_FORMAT_ZLIB, ZFRAME_LEVEL));
+  else
+    converter = G_CONVERTER (g_zlib_decompressor_new (G_ZLIB_COMPRESSOR_FORMAT_ZLIB));
+
+  do {
+    result = g_converter_convert (converter, in + total_read, in_size - total_read,
+        out + total_written, out_size - total_written, G_CONVERTER_INPUT_AT_END,
+        &read, &written, NULL);
+    total_read += read;
+    total_written += written;
+  } while (result == G_CONVERTER_CONVERTED && total_written < out_size);
+
+  g_object_unref (converter);
+  return (result == G_CONVERTER_FINISHED) ? total_written : 0;
+}
+
+/**
+ * @brief Callback for appsink, compresses or decompresses a frame and pushes it to appsrc.
+ * @note The timestamps and the meta (query meta of the server) are copied to the new frame.
+ */
+static GstFlowReturn
+_zframe_cb (GstElement * sink, gpointer user_data)
+{
+  GstSample *sample;
+  GstBuffer *in, *out = NULL;
+  GstMapInfo in_map, out_map;
+  ZFrameHeader header;
+  gsize size = 0;
+
+  sample = gst_app_sink_pull_sample (GST_APP_SINK (sink));
+  if (!sample)
+    return GST_FLOW_EOS;
+
+  in = gst_sample_get_buffer (sample);
+  if (!gst_buffer_map (in, &in_map, GST_MAP_READ)) {
+    gst_sample_unref (sample);
+    return GST_FLOW_ERROR;
+  }
+
+  if (g_app.is_server) {
+    memcpy (&header, in_map.data, MIN (in_map.size, sizeof (ZFrameHeader)));
+    if (in_map.size > sizeof (ZFrameHeader) && header.magic == ZFRAME_MAGIC &&
+        header.size == VIDEO_FRAME_SIZE) {
+      out = gst_buffer_new_allocate (NULL, header.size, NULL);
+      gst_buffer_map (out, &out_map, GST_MAP_WRITE);
+      size = _zlib_convert (FALSE, in_map.data + sizeof (ZFrameHeader),
+          in_map.size - sizeof (ZFrameHeader), out_map.data, out_map.size);
+      gst_buffer_unmap (out, &out_map);
+      if (size != header.size)
+        size = 0;
+    }
+  } else {
+    /* the output of deflate may be larger than the input */
+    out = gst_buffer_new_allocate (NULL,
+        sizeof (ZFrameHeader) + in_map.size + in_map.size / 100 + 1024, NULL);
+    gst_buffer_map (out, &out_map, GST_MAP_WRITE);
+    header.magic = ZFRAME_MAGIC;
+    header.size = (guint32) in_map.size;
+    memcpy (out_map.data, &header, sizeof (ZFrameHeader));
+    size = _zlib_convert (TRUE, in_map.data, in_map.size,
+        out_map.data + sizeof (ZFrameHeader), out_map.size - sizeof (ZFrameHeader));
+    gst_buffer_unmap (out, &out_map);
+    if (size > 0) {
+      size += sizeof (ZFrameHeader);
+      gst_buffer_set_size (out, size);
+    }
+  }
+  gst_buffer_unmap (in, &in_map);
+
+  if (size == 0) {
+    _print_log ("failed to convert the frame, dropped");
+    if (out)
+      gst_buffer_unref (out);
+    gst_sample_unref (sample);
+    return GST_FLOW_OK;
+  }
+
+  gst_buffer_copy_into (out, in, GST_BUFFER_COPY_METADATA, 0, -1);
+  gst_sample_unref (sample);
+
+  return gst_app_src_push_buffer (GST_APP_SRC (g_app.zsrc), out);
+}
+
+/**
+ * @brief Get the server pipeline.
+ */
+static gchar *
+_server_pipeline (void)
+{
+  const gchar *decode, *result;
+  gchar *str_pipeline, *str_result = NULL;
+
+  switch (g_app.transport) {
+    case TRANSPORT_JPEG:
+      decode = "image/jpeg,width=640,height=480,framerate=0/1 ! jpegdec ! videoconvert ! ";
+      break;
+    case TRANSPORT_ZLIB:
+      /* decompressed by _zframe_cb, 640x480 RGB frame */
+      decode = "appsink name=zsink emit-signals=true sync=false "
+          "appsrc name=zsrc format=time block=true max-bytes=2000000 "
+          "caps=video/x-raw,width=640,height=480,format=RGB,framerate=0/1 ! ";
+      break;
+    default:
+      decode = "video/x-raw,width=640,height=480,format=RGB,framerate=0/1 ! ";
+      break;
+  }
+
+  if (g_app.result_tensor) {
+    result = "tensor_filter framework=custom-easy model=ssd_compact ! ";
+  } else {
+    str_result = g_strdup_printf
+        ("tensor_decoder mode=bounding_boxes option1=mobilenet-ssd option2=%s option3=%s "
+        "option4=%u:%u option5=%u:%u ! videoconvert ! ",
+        g_app.label_path, g_app.box_prior_path, VIDEO_WIDTH, VIDEO_HEIGHT,
+        MODEL_WIDTH, MODEL_HEIGHT);
+    result = str_result;
+  }
+
+  str_pipeline = g_strdup_printf
+      ("tensor_query_serversrc host=%s port=%u ! %s"
+      "videoscale ! video/x-raw,width=%u,height=%u,format=RGB ! tensor_converter ! "
+      "tensor_transform mode=arithmetic option=typecast:float32,add:-127.5,div:127.5 ! "
+      "tensor_filter framework=tensorflow-lite model=%s ! %s"
+      "tensor_query_serversink async=false",
+      g_app.host, g_app.port, decode, MODEL_WIDTH, MODEL_HEIGHT,
+      g_app.model_path, result);
+
+  g_free (str_result);
+  return str_pipeline;
+}
+
+/**
+ * @brief Get the client pipeline.
+ */
+static gchar *
+_client_pipeline (void)
+{
+  gchar *str_pipeline, *encode, *src, *source, *display;
+  const gchar *result;
+  gboolean from_file = FALSE;
+
+  switch (g_app.transport) {
+    case TRANSPORT_JPEG:
+      encode = g_strdup_printf ("jpegenc quality=%u ! ", g_app.quality);
+      break;
+    case TRANSPORT_ZLIB:
+      /* compressed by _zframe_cb, a buffer for each frame */
+      encode = g_strdup ("appsink name=zsink emit-signals=true sync=false "
+          "appsrc name=zsrc is-live=true format=time block=true max-bytes=2000000 "
+          "caps=application/x-nns-zframe ! ");
+      break;
+    default:
+      encode = g_strdup ("");
+      break;
+  }
+
+  /* the noise of snow is the worst case of the compression, the ball pattern compresses too well */
+  if (g_app.src && g_str_has_prefix (g_app.src, "file:")) {
+    source = g_strdup_printf ("filesrc location=%s ! decodebin", g_app.src + 5);
+    from_file = TRUE;
+  } else if (g_app.src && g_str_has_prefix (g_app.src, "/dev/")) {
+    source = g_strdup_printf ("v4l2src device=%s", g_app.src);
+  } else if (g_app.bench || g_strcmp0 (g_app.src, "videotestsrc") == 0) {
+    source = g_strdup ("videotestsrc is-live=true pattern=snow");
+  } else {
+    source = g_strdup ("v4l2src");
+  }
+
+  /* the file is played at the framerate */
+  src = g_strdup_printf ("%s ! videoconvert ! videoscale ! videorate ! "
+      "video/x-raw,width=%u,height=%u,format=RGB,framerate=%u/1 ! %s tee name=t ",
+      source, VIDEO_WIDTH, VIDEO_HEIGHT, g_app.framerate,
+      from_file ? "identity sync=true !" : "");
+  g_free (source);
+
+  if (g_app.bench) {
+    result = g_app.result_tensor ? "tensor_sink name=res sync=false" :
+        "fakesink name=res sync=false";
+    display = g_strdup ("");
+  } else if (g_app.result_tensor) {
+    /* draw boxes from compact result */
+    result = "tensor_sink name=res sync=false";
+    display = g_strdup ("t. ! queue ! videoconvert ! cairooverlay name=overlay ! "
+        "videoconvert ! ximagesink");
+  } else {
+    result = "videoconvert ! video/x-raw,width=640,height=480,format=RGBA ! identity name=res ! mix.sink_0";
+    display = g_strdup ("compositor name=mix sink_0::zorder=2 sink_1::zorder=1 ! "
+        "videoconvert ! ximagesink t. ! queue ! mix.sink_1");
+  }
+
+  str_pipeline = g_strdup_printf
+      ("%s t. ! queue leaky=2 max-size-buffers=2 ! %s"
+      "tensor_query_client name=qc host=localhost port=0 dest-host=%s dest-port=%u ! %s %s",
+      src, encode, g_app.host, g_app.port, result, display);
+
+  g_free (encode);
+  g_free (src);
+  g_free (display);
+  return str_pipeline;
+}
+
+/**
+ * @brief Probe for frames sent to the server.
+ */
+static GstPadProbeReturn
+_sent_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  SentFrame *frame = g_new (SentFrame, 1);
+
+  frame->pts = GST_BUFFER_PTS (buffer);
+  frame->time = g_get_monotonic_time ();
+
+  g_mutex_lock (&g_app.mutex);
+  g_queue_push_tail (g_app.in_flight, frame);
+  /* the results without PTS never complete a frame, keep the recent ones */
+  if (g_queue_get_length (g_app.in_flight) > MAX_IN_FLIGHT)
+    g_free (g_queue_pop_head (g_app.in_flight));
+  g_app.sent++;
+  g_app.bytes_sent += gst_buffer_get_size (buffer);
+  g_mutex_unlock (&g_app.mutex);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Probe for results from the server.
+ */
+static GstPadProbeReturn
+_result_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstClockTime pts = GST_BUFFER_PTS (buffer);
+  SentFrame *frame;
+  gint64 latency;
+
+  g_mutex_lock (&g_app.mutex);
+  g_app.frames++;
+  g_app.bytes_received += gst_buffer_get_size (buffer);
+
+  /**
+   * Match the result to the sent frame with the same PTS. The frames sent before it
+   * have no result (dropped by tensor_query_client), so a dropped frame does not
+   * shift the latency of the following frames.
+   */
+  while (GST_CLOCK_TIME_IS_VALID (pts) &&
+      (frame = (SentFrame *) g_queue_peek_head (g_app.in_flight)) &&
+      frame->pts < pts)
+    g_free (g_queue_pop_head (g_app.in_flight));
+
+  frame = (SentFrame *) g_queue_peek_head (g_app.in_flight);
+  if (GST_CLOCK_TIME_IS_VALID (pts) && frame && frame->pts == pts) {
+    latency = g_get_monotonic_time () - frame->time;
+    g_array_append_val (g_app.latency, latency);
+    g_free (g_queue_pop_head (g_app.in_flight));
+  } else {
+    g_app.unmatched++;
+  }
+  g_mutex_unlock (&g_app.mutex);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Callback for compact result.
+ */
+static void
+_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  GstMapInfo info;
+  gfloat *result;
+  guint i, num = 0;
+
+  if (!gst_buffer_map (buffer, &info, GST_MAP_READ))
+    return;
+
+  result = (gfloat *) info.data;
+
+  g_mutex_lock (&g_app.mutex);
+  for (i = 0; i < MAX_DETECTION && (i + 1) * DETECTION_INFO * sizeof (gfloat) <= info.size; i++) {
+    if (result[5] <= 0.0f)
+      break;
+
+    g_app.detected[num].x = result[0];
+    g_app.detected[num].y = result[1];
+    g_app.detected[num].width = result[2];
+    g_app.detected[num].height = result[3];
+    g_app.detected[num].class_id = (gint) result[4];
+    g_app.detected[num].prob = result[5];
+    num++;
+    result += DETECTION_INFO;
+  }
+  g_app.num_detected = num;
+  g_mutex_unlock (&g_app.mutex);
+
+  gst_buffer_unmap (buffer, &info);
+}
+
+/**
+ * @brief Callback to draw the overlay.
+ */
+static void
+_draw_overlay_cb (GstElement * overlay, cairo_t * cr, guint64 timestamp,
+    guint64 duration, gpointer user_data)
+{
+  DetectedObject detected[MAX_DETECTION];
+  const gchar *label;
+  guint i, num;
+
+  g_mutex_lock (&g_app.mutex);
+  num = g_app.num_detected;
+  memcpy (detected, g_app.detected, sizeof (DetectedObject) * num);
+  g_mutex_unlock (&g_app.mutex);
+
+  cairo_select_font_face (cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
+      CAIRO_FONT_WEIGHT_BOLD);
+  cairo_set_font_size (cr, 20.0);
+
+  for (i = 0; i < num; i++) {
+    gfloat x = detected[i].x * VIDEO_WIDTH;
+    gfloat y = detected[i].y * VIDEO_HEIGHT;
+
+    cairo_rectangle (cr, x, y, detected[i].width * VIDEO_WIDTH,
+        detected[i].height * VIDEO_HEIGHT);
+    cairo_set_source_rgb (cr, 1, 0, 0);
+    cairo_set_line_width (cr, 1.5);
+    cairo_stroke (cr);
+
+    label = (const gchar *) g_list_nth_data (g_app.labels, detected[i].class_id);
+    if (label) {
+      cairo_move_to (cr, x + 5, y + 25);
+      cairo_show_text (cr, label);
+    }
+  }
+}
+
+/**
+ * @brief Compare function for latency values.
+ */
+static gint
+_compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 la = *((const gint64 *) a);
+  gint64 lb = *((const gint64 *) b);
+
+  return (la > lb) ? 1 : ((la < lb) ? -1 : 0);
+}
+
+/**
+ * @brief Get the percentile from the sorted latency array.
+ */
+static gdouble
+_percentile_ms (GArray * sorted, gdouble p)
+{
+  guint idx;
+
+  if (sorted->len == 0)
+    return 0.0;
+
+  idx = (guint) (p / 100.0 * (sorted->len - 1) + 0.5);
+  return g_array_index (sorted, gint64, MIN (idx, sorted->len - 1)) / 1000.0;
+}
+
+/**
+ * @brief Print statistics of the client.
+ */
+static void
+_print_statistics (gdouble elapsed)
+{
+  const gchar *transport[] = { "raw", "jpeg", "zlib" };
+  guint64 frames;
+
+  g_mutex_lock (&g_app.mutex);
+  frames = MAX (g_app.frames, 1);
+  g_array_sort (g_app.latency, _compare_latency);
+
+  /* payload of the buffers, the bytes on the wire include the protocol overhead */
+  g_print ("transport,result,frames,fps,sent_payload_bytes_per_frame,"
+      "recv_payload_bytes_per_frame,p50_ms,p90_ms,p99_ms,unmatched\n");
+  g_print ("%s,%s,%" G_GUINT64_FORMAT ",%.1f,%.0f,%.0f,%.2f,%.2f,%.2f,%"
+      G_GUINT64_FORMAT "\n", transport[g_app.transport],
+      g_app.result_tensor ? "tensor" : "video", g_app.frames, g_app.frames / elapsed,
+      g_app.bytes_sent / (gdouble) MAX (g_app.sent, 1),
+      g_app.bytes_received / (gdouble) frames,
+      _percentile_ms (g_app.latency, 50.0), _percentile_ms (g_app.latency, 90.0),
+      _percentile_ms (g_app.latency, 99.0), g_app.unmatched);
+  g_mutex_unlock (&g_app.mutex);
+}
+
+/**
+ * @brief Timer callback to stop the app.
+ */
+static gboolean
+_timeout_cb (gpointer user_data)
+{
+  g_main_loop_quit (g_app.loop);
+  return FALSE;
+}
+
+/**
+ * @brief Connect signals and probes of the client.
+ */
+static gboolean
+_connect_client (void)
+{
+  GstElement *element;
+  GstPad *pad;
+
+  element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "qc");
+  g_return_val_if_fail (element != NULL, FALSE);
+  pad = gst_element_get_static_pad (element, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, _sent_probe_cb, NULL, NULL);
+  gst_object_unref (pad);
+  gst_object_unref (element);
+
+  element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "res");
+  g_return_val_if_fail (element != NULL, FALSE);
+  pad = gst_element_get_static_pad (element, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, _result_probe_cb, NULL, NULL);
+  gst_object_unref (pad);
+
+  if (g_app.result_tensor)
+    g_signal_connect (element, "new-data", (GCallback) _new_data_cb, NULL);
+  gst_object_unref (element);
+
+  if (g_app.result_tensor && !g_app.bench) {
+    element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "overlay");
+    g_return_val_if_fail (element != NULL, FALSE);
+    g_signal_connect (element, "draw", (GCallback) _draw_overlay_cb, NULL);
+    gst_object_unref (element);
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Connect the appsink and appsrc of the zlib transport.
+ */
+static gboolean
+_connect_zlib (void)
+{
+  GstElement *element;
+
+  element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "zsink");
+  g_return_val_if_fail (element != NULL, FALSE);
+  g_signal_connect (element, "new-sample", (GCallback) _zframe_cb, NULL);
+  gst_object_unref (element);
+
+  g_app.zsrc = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "zsrc");
+  return (g_app.zsrc != NULL);
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  const gchar tflite_model_path[] = "./tflite_model";
+  gchar *str_pipeline = NULL;
+  GstTensorsInfo info_in, info_out;
+  gint64 start;
+  gint opt;
+  struct option long_options[] = {
+      { "server", no_argument, NULL, 's' },
+      { "client", no_argument, NULL, 'c' },
+      { "host", required_argument, NULL, 'u' },
+      { "port", required_argument, NULL, 'p' },
+      { "transport", required_argument, NULL, 'r' },
+      { "quality", required_argument, NULL, 'q' },
+      { "result", required_argument, NULL, 'o' },
+      { "framerate", required_argument, NULL, 'f' },
+      { "timeout", required_argument, NULL, 't' },
+      { "bench", no_argument, NULL, 'b' },
+      { "src", required_argument, NULL, 'i' },
+      { "help", no_argument, NULL, 'h' },
+      { 0, 0, 0, 0}
+  };
+
+  /* init gstreamer */
+  gst_init (&argc, &argv);
+
+  memset (&g_app, 0, sizeof (AppData));
+  g_mutex_init (&g_app.mutex);
+  g_app.host = g_strdup ("localhost");
+  g_app.port = 3000;
+  g_app.quality = 85;
+  g_app.framerate = 30;
+  g_app.timeout = 10;
+
+  while ((opt = getopt_long (argc, argv, "", long_options, NULL)) != -1) {
+    switch (opt) {
+      case 's':
+        g_app.is_server = TRUE;
+        break;
+      case 'c':
+        g_app.is_server = FALSE;
+        break;
+      case 'u':
+        g_free (g_app.host);
+        g_app.host = g_strdup (optarg);
+        break;
+      case 'p':
+        g_app.port = (guint16) g_ascii_strtoll (optarg, NULL, 10);
+        break;
+      case 'r':
+        if (g_ascii_strcasecmp (optarg, "jpeg") == 0)
+          g_app.transport = TRANSPORT_JPEG;
+        else if (g_ascii_strcasecmp (optarg, "zlib") == 0)
+          g_app.transport = TRANSPORT_ZLIB;
+        else
+          g_app.transport = TRANSPORT_RAW;
+        break;
+      case 'q':
+        g_app.quality = CLAMP ((guint) g_ascii_strtoull (optarg, NULL, 10), 1, 100);
+        break;
+      case 'o':
+        g_app.result_tensor = (g_ascii_strcasecmp (optarg, "tensor") == 0);
+        break;
+      case 'f':
+        g_app.framerate = MAX (1, (guint) g_ascii_strtoull (optarg, NULL, 10));
+        break;
+      case 't':
+        g_app.timeout = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'b':
+        g_app.bench = TRUE;
+        break;
+      case 'i':
+        g_free (g_app.src);
+        g_app.src = g_strdup (optarg);
+        break;
+      default:
+        _usage ();
+        goto error;
+    }
+  }
+
+  g_app.in_flight = g_queue_new ();
+  g_app.latency = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+  g_app.model_path = g_strdup_printf ("%s/ssd_mobilenet_v2_coco.tflite", tflite_model_path);
+  g_app.label_path = g_strdup_printf ("%s/coco_labels_list.txt", tflite_model_path);
+  g_app.box_prior_path = g_strdup_printf ("%s/box_priors.txt", tflite_model_path);
+
+  if (g_app.is_server) {
+    if (g_app.result_tensor) {
+      _check_cond_err (_load_box_priors ());
+
+      gst_tensors_info_init (&info_in);
+      gst_tensors_info_init (&info_out);
+      info_in.num_tensors = gst_tensors_info_parse_dimensions_string (&info_in,
+          "4:1:1917:1,91:1917:1");
+      gst_tensors_info_parse_types_string (&info_in, "float32,float32");
+      info_out.num_tensors = 1U;
+      info_out.info[0].type = _NNS_FLOAT32;
+      gst_tensor_parse_dimension ("6:20:1:1", info_out.info[0].dimension);
+
+      NNS_custom_easy_register ("ssd_compact", _ssd_compact_invoke, NULL,
+          &info_in, &info_out);
+    }
+    str_pipeline = _server_pipeline ();
+  } else {
+    if (g_app.result_tensor && !g_app.bench)
+      _read_lines (g_app.label_path, &g_app.labels);
+    str_pipeline = _client_pipeline ();
+  }
+  g_print ("%s\n", str_pipeline);
+
+  g_app.loop = g_main_loop_new (NULL, FALSE);
+  g_app.pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  _check_cond_err (g_app.pipeline != NULL);
+
+  if (g_app.transport == TRANSPORT_ZLIB)
+    _check_cond_err (_connect_zlib ());
+  if (!g_app.is_server)
+    _check_cond_err (_connect_client ());
+
+  /** Shut down the application after timeout. */
+  g_timeout_add_seconds (g_app.timeout, _timeout_cb, NULL);
+
+  start = g_get_monotonic_time ();
+  gst_element_set_state (g_app.pipeline, GST_STATE_PLAYING);
+  g_main_loop_run (g_app.loop);
+  gst_element_set_state (g_app.pipeline, GST_STATE_NULL);
+
+  if (!g_app.is_server)
+    _print_statistics ((g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC);
+
+error:
+  if (g_app.is_server && g_app.result_tensor)
+    NNS_custom_easy_unregister ("ssd_compact");
+
+  if (g_app.zsrc)
+    gst_object_unref (g_app.zsrc);
+  if (g_app.pipeline)
+    gst_object_unref (g_app.pipeline);
+  if (g_app.loop)
+    g_main_loop_unref (g_app.loop);
+  if (g_app.in_flight)
+    g_queue_free_full (g_app.in_flight, g_free);
+  if (g_app.latency)
+    g_array_free (g_app.latency, TRUE);
+  g_list_free_full (g_app.labels, g_free);
+  g_mutex_clear (&g_app.mutex);
+
+  g_free (g_app.host);
+  g_free (g_app.src);
+  g_free (g_app.model_path);
+  g_free (g_app.label_path);
+  g_free (g_app.box_prior_path);
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+#!/usr/bin/env bash
+##
+## @file query_transport_benchmark.sh
+## @brief Compare frame transports of tensor query over a tc/netem-shaped loopback.
+##        Requires root privilege (or CAP_NET_ADMIN) to shape the loopback device.
+##
+## usage: ./query_transport_benchmark.sh [rate] [delay] [running time] [video clip]
+##   e.g) ./query_transport_benchmark.sh 20mbit 10ms 10 ./camera_clip.mp4
+##   Without the clip, the client uses the snow pattern of videotestsrc (worst case of the compression).
+if [ -z "$1" ]; then
+  echo "Link rate is not given. Use 20mbit."
+  RATE="20mbit"
+else
+  RATE="$1"
+fi
+if [ -z "$2" ]; then
+  echo "Link delay is not given. Use 10ms."
+  DELAY="10ms"
+else
+  DELAY="$2"
+fi
+if [ -z "$3" ]; then
+  RUNNING_TIME=10
+else
+  RUNNING_TIME="$3"
+fi
+if [ -z "$4" ]; then
+  echo "Video clip is not given. Use the snow pattern of videotestsrc."
+  SRC="videotestsrc"
+else
+  SRC="file:$4"
+fi
+
+PORT=3000
+RESULT_FILE="query_transport_result.csv"
+
+## Shape the loopback device, and restore it on exit.
+tc qdisc del dev lo root 2> /dev/null
+tc qdisc add dev lo root netem delay $DELAY rate $RATE
+if [[ $? != 0 ]]; then
+  echo "Failed to shape the loopback device. Run as root."
+  exit 1
+fi
+trap "tc qdisc del dev lo root 2> /dev/null" EXIT
+
+echo "# rate=$RATE delay=$DELAY src=$SRC" > $RESULT_FILE
+
+for RESULT in video tensor; do
+  for TRANSPORT in raw jpeg zlib; do
+    echo "transport: $TRANSPORT, result: $RESULT"
+    ./nnstreamer_example_query_compressed --server --port=$PORT --transport=$TRANSPORT --result=$RESULT --timeout=$(( RUNNING_TIME + 3 )) &
+    SERVER_PID=$!
+    sleep 2
+
+    ./nnstreamer_example_query_compressed --client --bench --src=$SRC --port=$PORT --transport=$TRANSPORT --result=$RESULT --timeout=$RUNNING_TIME | tail -n 1 >> $RESULT_FILE
+
+    wait $SERVER_PID
+    PORT=$(( PORT + 1 ))
+  done
+done
+
+echo "transport,result,frames,fps,sent_payload_bytes_per_frame,recv_payload_bytes_per_frame,p50_ms,p90_ms,p99_ms,unmatched"
+cat $RESULT_FILE
@@ -7,17 +7,24 @@
  * @bug		No known bugs.
  *
  * Simple example to init tensor sink element and get data.
+ * The data is handled by tensor_sink_consumer, which hands the buffers off the
+ * streaming thread to worker threads. It also benchmarks the consumer, the handler
+ * simulates slow post-processing (--work-us) and it prints the throughput and the
+ * drop/backpressure statistics for each number of workers.
  *
  * Run example :
  * Before running this example, GST_PLUGIN_PATH should be updated for nnstreamer plug-in.
  * $ export GST_PLUGIN_PATH=$GST_PLUGIN_PATH:<nnstreamer plugin path>
- * $ ./nnstreamer_sink_example
+ * $ ./nnstreamer_sink_example [0(video)|1(audio)|2(text)]
+ * $ ./nnstreamer_sink_example --workers=0,1,2,4 --work-us=2000 --num-buffers=300 --policy=block
  */
 
 #include <stdlib.h>
 #include <string.h>
+#include <getopt.h>
 #include <gst/gst.h>
 #include <gst/app/gstappsrc.h>
+#include "tensor_sink_consumer.h"
 
 /**
  * @brief Macro for debug mode.
@@ -62,7 +69,13 @@ typedef struct
   GstBus *bus; /**< gst bus for test */
 
   guint received; /**< received buffer count */
+  guint pushed; /**< pushed buffer count (text) */
   test_media_type media_type; /**< test media type */
+  GMutex mutex; /**< mutex for handler */
+  GstCaps *last_caps; /**< caps printed in the handler */
+
+  guint num_buffers; /**< number of buffers (video and audio) */
+  guint work_us; /**< simulated post-processing time of a buffer */
 } AppData;
 
 /**
@@ -180,67 +193,58 @@ _message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
 }
 
 /**
- * @brief Callback for signal new-data.
+ * @brief Handler of the buffer, called on the worker thread of the consumer.
+ * @param caps cached caps, not queried for each buffer
  */
 static void
-_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+_handle_buffer (GstBuffer * buffer, GstCaps * caps, gpointer user_data)
 {
-  g_app.received++;
-  if (g_app.received % 150 == 0) {
-    _print_log ("receiving new data [%d]", g_app.received);
+  GstMemory *mem;
+  GstMapInfo info;
+  guint i, num_mems, received;
+  gint64 end_time;
+  volatile guint8 sum = 0;
+  gsize j;
+
+  g_mutex_lock (&g_app.mutex);
+  received = ++g_app.received;
+
+  /* example to get caps, print when the caps is changed */
+  if (caps && caps != g_app.last_caps) {
+    g_app.last_caps = caps;
+    _parse_caps (caps);
   }
+  g_mutex_unlock (&g_app.mutex);
 
-  /* example to get data */
-  {
-    GstMemory *mem;
-    GstMapInfo info;
-    guint i;
-    guint num_mems;
-
-    num_mems = gst_buffer_n_memory (buffer);
-    for (i = 0; i < num_mems; i++) {
-      mem = gst_buffer_peek_memory (buffer, i);
-
-      if (gst_memory_map (mem, &info, GST_MAP_READ)) {
-        /* check data (info.data, info.size) */
-        if (g_app.media_type == TEST_TYPE_TEXT) {
-          _print_log ("received %zd [%s]", info.size, (gchar *) info.data);
-        } else {
-          _print_log ("received %zd", info.size);
-        }
-
-        gst_memory_unmap (mem, &info);
-      }
-    }
+  if (received % 150 == 0) {
+    _print_log ("receiving new data [%d]", received);
   }
 
-  /* example to get caps */
-  {
-    GstPad *sink_pad;
-    GstCaps *caps;
-
-    sink_pad = gst_element_get_static_pad (element, "sink");
-
-    if (sink_pad) {
-      /* negotiated */
-      caps = gst_pad_get_current_caps (sink_pad);
-
-      if (caps) {
-        _parse_caps (caps);
-        gst_caps_unref (caps);
+  /* example to get data */
+  end_time = g_get_monotonic_time () + g_app.work_us;
+
+  num_mems = gst_buffer_n_memory (buffer);
+  for (i = 0; i < num_mems; i++) {
+    mem = gst_buffer_peek_memory (buffer, i);
+
+    if (gst_memory_map (mem, &info, GST_MAP_READ)) {
+      /* check data (info.data, info.size) */
+      if (g_app.media_type == TEST_TYPE_TEXT) {
+        _print_log ("received %zd [%s]", info.size, (gchar *) info.data);
+      } else {
+        _print_log ("received %zd", info.size);
       }
 
-      /* template */
-      caps = gst_pad_get_pad_template_caps (sink_pad);
-
-      if (caps) {
-        _parse_caps (caps);
-        gst_caps_unref (caps);
-      }
+      for (j = 0; j < info.size; j += 64)
+        sum += info.data[j];
 
-      gst_object_unref (sink_pad);
+      gst_memory_unmap (mem, &info);
     }
   }
+
+  /* simulate slow post-processing */
+  while (g_get_monotonic_time () < end_time)
+    ;
 }
 
 /**
@@ -272,7 +276,7 @@ _test_src_timer_cb (gpointer user_data)
   GstBuffer *buf;
   guint buffer_index;
 
-  buffer_index = g_app.received + 1;
+  buffer_index = ++g_app.pushed;
   appsrc = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "appsrc");
 
   switch (g_app.media_type) {
@@ -285,6 +289,7 @@ _test_src_timer_cb (gpointer user_data)
         if (gst_app_src_end_of_stream (GST_APP_SRC (appsrc)) != GST_FLOW_OK) {
           _print_log ("failed to indicate eos");
         }
+        gst_object_unref (appsrc);
         return FALSE;
       }
 
@@ -302,9 +307,11 @@ _test_src_timer_cb (gpointer user_data)
     }
     default:
       /* nothing to do */
+      gst_object_unref (appsrc);
       return FALSE;
   }
 
+  gst_object_unref (appsrc);
   return TRUE;
 }
 
@@ -322,16 +329,16 @@ _test_pipeline (test_media_type type)
       /* video 640x480 30fps 100 buffers */
       str_pipeline =
           g_strdup_printf
-          ("videotestsrc num-buffers=100 ! video/x-raw,format=RGB,width=640,height=480 ! "
-          "tensor_converter ! tensor_sink name=tensor_sink");
+          ("videotestsrc num-buffers=%u ! video/x-raw,format=RGB,width=640,height=480 ! "
+          "tensor_converter ! tensor_sink name=tensor_sink", g_app.num_buffers);
       break;
 
     case TEST_TYPE_AUDIO:
       /* audio sample rate 16000 (16 bits, signed, little endian) 30 buffers */
       str_pipeline =
           g_strdup_printf
-          ("audiotestsrc num-buffers=30 ! audio/x-raw,format=S16LE,rate=16000 ! "
-          "tensor_converter ! tensor_sink name=tensor_sink");
+          ("audiotestsrc num-buffers=%u ! audio/x-raw,format=S16LE,rate=16000 ! "
+          "tensor_converter ! tensor_sink name=tensor_sink", g_app.num_buffers);
       break;
 
     case TEST_TYPE_TEXT:
@@ -350,26 +357,27 @@ _test_pipeline (test_media_type type)
 }
 
 /**
- * @brief Main function.
+ * @brief Run the pipeline with the given number of workers and print the statistics.
  */
-int
-main (int argc, char **argv)
+static gboolean
+_run_test (test_media_type test_type, guint workers, guint capacity,
+    TensorSinkConsumerPolicy policy, const gchar * policy_name)
 {
-  test_media_type test_type = TEST_TYPE_VIDEO;
   gchar *str_pipeline;
   gulong handle_id;
   GstStateChangeReturn state_ret;
-  GstElement *element;
-
-  if (argc > 1) {
-    test_type = atoi (argv[1]);
-  }
-
-  /* init gstreamer */
-  gst_init (&argc, &argv);
+  GstElement *element = NULL;
+  GstCaps *caps;
+  GstPad *sink_pad;
+  TensorSinkConsumer *consumer = NULL;
+  TensorSinkConsumerStats stats;
+  gint64 start_time, elapsed;
+  gboolean ret = FALSE;
 
   /* init app variable */
   g_app.received = 0;
+  g_app.pushed = 0;
+  g_app.last_caps = NULL;
   g_app.media_type = test_type;
 
   /* main loop and pipeline */
@@ -402,10 +410,23 @@ main (int argc, char **argv)
   /* enable emit-signal, default TRUE */
   g_object_set (element, "emit-signal", (gboolean) TRUE, NULL);
 
-  /* tensor sink signal : new data callback */
-  handle_id = g_signal_connect (element, "new-data",
-      (GCallback) _new_data_cb, NULL);
-  _check_cond_err (handle_id > 0);
+  /* example to get template caps, it is not changed so get it once */
+  sink_pad = gst_element_get_static_pad (element, "sink");
+  if (sink_pad) {
+    caps = gst_pad_get_pad_template_caps (sink_pad);
+
+    if (caps) {
+      _parse_caps (caps);
+      gst_caps_unref (caps);
+    }
+
+    gst_object_unref (sink_pad);
+  }
+
+  /* tensor sink signal : new data, handled by the workers of the consumer */
+  consumer = tensor_sink_consumer_new (element, workers, capacity, policy,
+      _handle_buffer, NULL);
+  _check_cond_err (consumer != NULL);
 
   /* tensor sink signal : stream-start callback, optional */
   handle_id = g_signal_connect (element, "stream-start",
@@ -416,9 +437,8 @@ main (int argc, char **argv)
   handle_id = g_signal_connect (element, "eos", (GCallback) _eos_cb, NULL);
   _check_cond_err (handle_id > 0);
 
-  gst_object_unref (element);
-
   /* start pipeline */
+  start_time = g_get_monotonic_time ();
   state_ret = gst_element_set_state (g_app.pipeline, GST_STATE_PLAYING);
   _check_cond_err (state_ret != GST_STATE_CHANGE_FAILURE);
 
@@ -427,13 +447,129 @@ main (int argc, char **argv)
   /* run main loop */
   g_main_loop_run (g_app.loop);
 
-  /* quit when received eos message */
+  /* quit when received eos message, wait for the workers */
+  tensor_sink_consumer_wait_idle (consumer, 10 * G_USEC_PER_SEC);
+  elapsed = g_get_monotonic_time () - start_time;
+
   state_ret = gst_element_set_state (g_app.pipeline, GST_STATE_NULL);
   _check_cond_err (state_ret != GST_STATE_CHANGE_FAILURE);
 
+  tensor_sink_consumer_get_stats (consumer, &stats);
   _print_log ("total received %d", g_app.received);
 
+  g_print ("%d,%u,%s,%u,%u,%" G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT ",%"
+      G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT ",%.2f,%u,%" G_GINT64_FORMAT ",%"
+      G_GINT64_FORMAT ",%u,%.2f\n", test_type, workers,
+      workers > 0 ? policy_name : "inline", capacity, g_app.work_us,
+      stats.received, stats.processed, stats.dropped, stats.blocked,
+      stats.blocked_us / 1000.0, stats.max_depth, stats.wait_us_avg,
+      stats.wait_us_max, stats.caps_changes,
+      (elapsed > 0) ? stats.processed * (gdouble) G_USEC_PER_SEC / elapsed : 0.0);
+  ret = TRUE;
+
 error:
+  if (consumer)
+    tensor_sink_consumer_free (consumer);
+  if (element)
+    gst_object_unref (element);
+
   _free_app_data ();
+  return ret;
+}
+
+/**
+ * @brief Print usage info.
+ */
+static void
+_usage (void)
+{
+  g_print ("usage: nnstreamer_sink_example [0(video)|1(audio)|2(text)] [options]\n"
+      "    --workers      Comma-separated number of workers, 0 to handle in new-data signal. (default 2)\n"
+      "    --capacity     Number of buffers in the ring. (default 16)\n"
+      "    --policy       block, drop-new or drop-old when the ring is full. (default block)\n"
+      "    --work-us      Simulated post-processing time of a buffer. (default 0)\n"
+      "    --num-buffers  Number of buffers, video and audio. (default 100)\n");
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  test_media_type test_type = TEST_TYPE_VIDEO;
+  TensorSinkConsumerPolicy policy = TENSOR_SINK_CONSUMER_BLOCK;
+  gchar *workers_list = g_strdup ("2");
+  gchar *policy_name = g_strdup ("block");
+  gchar **workers;
+  guint capacity = 16, i;
+  gint opt;
+  struct option long_options[] = {
+    {"workers", required_argument, NULL, 'w'},
+    {"capacity", required_argument, NULL, 'c'},
+    {"policy", required_argument, NULL, 'p'},
+    {"work-us", required_argument, NULL, 'u'},
+    {"num-buffers", required_argument, NULL, 'n'},
+    {"help", no_argument, NULL, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  g_app.num_buffers = 100;
+  g_app.work_us = 0;
+
+  while ((opt = getopt_long (argc, argv, "w:c:p:u:n:h", long_options, NULL)) != -1) {
+    switch (opt) {
+      case 'w':
+        g_free (workers_list);
+        workers_list = g_strdup (optarg);
+        break;
+      case 'c':
+        capacity = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'p':
+        g_free (policy_name);
+        policy_name = g_strdup (optarg);
+        break;
+      case 'u':
+        g_app.work_us = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'n':
+        g_app.num_buffers = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      default:
+        _usage ();
+        g_free (workers_list);
+        g_free (policy_name);
+        return 0;
+    }
+  }
+
+  if (optind < argc) {
+    test_type = atoi (argv[optind]);
+  }
+
+  if (g_strcmp0 (policy_name, "drop-new") == 0)
+    policy = TENSOR_SINK_CONSUMER_DROP_NEW;
+  else if (g_strcmp0 (policy_name, "drop-old") == 0)
+    policy = TENSOR_SINK_CONSUMER_DROP_OLD;
+
+  /* init gstreamer */
+  gst_init (&argc, &argv);
+  g_mutex_init (&g_app.mutex);
+
+  g_print ("type,workers,policy,capacity,work_us,received,processed,dropped,blocked,"
+      "blocked_ms,max_depth,wait_avg_us,wait_max_us,caps_changes,fps\n");
+
+  workers = g_strsplit (workers_list, ",", -1);
+  for (i = 0; workers[i]; i++) {
+    if (!_run_test (test_type, (guint) g_ascii_strtoull (workers[i], NULL, 10),
+            capacity, policy, policy_name))
+      break;
+  }
+
+  g_strfreev (workers);
+  g_free (workers_list);
+  g_free (policy_name);
+  g_mutex_clear (&g_app.mutex);
   return 0;
 }
@@ -0,0 +1,566 @@
+/**
+ * @file	tensor_sink_consumer.c
+ * @date	19 October 2026
+ * @brief	Consumer of tensor_sink, hands the buffers off the streaming thread to worker threads
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Jaeyun Jung <jy1210.jung@samsung.com>
+ * @bug		No known bugs.
+ *
+ * The ring is a bounded array of cells, the capacity is a power of 2.
+ * - SPSC (one worker) : the producer owns the tail and the worker owns the head.
+ * - MPMC (more workers or drop-old policy) : each cell has a sequence number (bounded MPMC queue by D. Vyukov).
+ * Threads sleep on a condition only when the ring is empty (workers) or full (producer),
+ * the hand-off itself does not take a lock.
+ */
+
+#include <string.h>
+#include "tensor_sink_consumer.h"
+
+/**
+ * @brief Spin count before sleeping on the condition.
+ */
+#define CONSUMER_SPIN 64
+
+/**
+ * @brief Max time to sleep, in case the wake-up is missed.
+ */
+#define CONSUMER_WAIT_US 1000
+
+/**
+ * @brief Padding to keep the head and tail on different cache lines.
+ */
+#define CONSUMER_CACHE_LINE 64
+
+/**
+ * @brief Buffer in the ring.
+ */
+typedef struct
+{
+  GstBuffer *buffer; /**< buffer from tensor_sink */
+  GstCaps *caps; /**< caps of the buffer */
+  gint64 queued; /**< time when the buffer is queued */
+} ConsumerItem;
+
+/**
+ * @brief Cell of the ring.
+ */
+typedef struct
+{
+  gint seq; /**< sequence number (MPMC) */
+  ConsumerItem item; /**< buffer in the cell */
+} ConsumerCell;
+
+/**
+ * @brief Worker thread and its statistics.
+ */
+typedef struct
+{
+  TensorSinkConsumer *consumer; /**< the consumer */
+  GThread *thread; /**< worker thread */
+  guint64 processed; /**< buffers handled by this worker */
+  gint64 wait_us_sum; /**< total time the buffers stayed in the ring */
+  gint64 wait_us_max; /**< max time a buffer stayed in the ring */
+} ConsumerWorker;
+
+/**
+ * @brief Consumer of tensor_sink.
+ */
+struct _TensorSinkConsumer
+{
+  gint tail; /**< next position to push, producer side */
+  gchar pad_tail[CONSUMER_CACHE_LINE - sizeof (gint)];
+  gint head; /**< next position to pop, worker side */
+  gchar pad_head[CONSUMER_CACHE_LINE - sizeof (gint)];
+
+  ConsumerCell *cells; /**< the ring */
+  guint capacity; /**< number of cells, power of 2 */
+  guint mask; /**< capacity - 1 */
+  gboolean mpmc; /**< use the MPMC ring */
+
+  GstElement *sink; /**< tensor_sink */
+  GstPad *pad; /**< sink pad of tensor_sink */
+  gulong data_handler; /**< handler id of new-data */
+  gulong caps_handler; /**< handler id of notify::caps */
+  GstCaps *caps; /**< cached caps, updated on the streaming thread */
+  GMutex caps_lock; /**< lock to update and get the cached caps */
+
+  TensorSinkConsumerFunc func; /**< handler of the buffer */
+  gpointer user_data; /**< user data of the handler */
+  TensorSinkConsumerPolicy policy; /**< what to do when the ring is full */
+
+  ConsumerWorker *workers; /**< worker threads */
+  guint num_workers; /**< number of worker threads, 0 to handle on the streaming thread */
+  gint stop; /**< set when the workers should stop */
+
+  GMutex lock; /**< lock for the conditions */
+  GCond not_empty; /**< signaled when a buffer is pushed */
+  GCond not_full; /**< signaled when a buffer is popped */
+  gint waiting_workers; /**< number of sleeping workers */
+  gint waiting_producer; /**< set when the producer is sleeping */
+
+  GMutex stats_lock; /**< lock for the statistics of the producer and the workers */
+  TensorSinkConsumerStats stats; /**< producer side statistics */
+};
+
+/**
+ * @brief Push an item to the ring (single producer).
+ */
+static gboolean
+_ring_push (TensorSinkConsumer * c, const ConsumerItem * item)
+{
+  ConsumerCell *cell;
+  guint pos, seq;
+
+  if (c->mpmc) {
+    pos = (guint) g_atomic_int_get (&c->tail);
+    while (TRUE) {
+      cell = &c->cells[pos & c->mask];
+      seq = (guint) g_atomic_int_get (&cell->seq);
+
+      if (seq == pos) {
+        if (g_atomic_int_compare_and_exchange (&c->tail, (gint) pos, (gint) (pos + 1)))
+          break;
+      } else if ((gint) (seq - pos) < 0) {
+        return FALSE;
+      }
+
+      pos = (guint) g_atomic_int_get (&c->tail);
+    }
+
+    cell->item = *item;
+    g_atomic_int_set (&cell->seq, (gint) (pos + 1));
+    return TRUE;
+  }
+
+  pos = (guint) c->tail;
+  if (pos - (guint) g_atomic_int_get (&c->head) >= c->capacity)
+    return FALSE;
+
+  c->cells[pos & c->mask].item = *item;
+  g_atomic_int_set (&c->tail, (gint) (pos + 1));
+  return TRUE;
+}
+
+/**
+ * @brief Pop an item from the ring.
+ */
+static gboolean
+_ring_pop (TensorSinkConsumer * c, ConsumerItem * item)
+{
+  ConsumerCell *cell;
+  guint pos, seq;
+
+  if (c->mpmc) {
+    pos = (guint) g_atomic_int_get (&c->head);
+    while (TRUE) {
+      cell = &c->cells[pos & c->mask];
+      seq = (guint) g_atomic_int_get (&cell->seq);
+
+      if (seq == pos + 1) {
+        if (g_atomic_int_compare_and_exchange (&c->head, (gint) pos, (gint) (pos + 1)))
+          break;
+      } else if ((gint) (seq - (pos + 1)) < 0) {
+        return FALSE;
+      }
+
+      pos = (guint) g_atomic_int_get (&c->head);
+    }
+
+    *item = cell->item;
+    g_atomic_int_set (&cell->seq, (gint) (pos + c->mask + 1));
+    return TRUE;
+  }
+
+  pos = (guint) c->head;
+  if (pos == (guint) g_atomic_int_get (&c->tail))
+    return FALSE;
+
+  *item = c->cells[pos & c->mask].item;
+  g_atomic_int_set (&c->head, (gint) (pos + 1));
+  return TRUE;
+}
+
+/**
+ * @brief Get the number of items in the ring (approximate).
+ */
+static guint
+_ring_depth (TensorSinkConsumer * c)
+{
+  return (guint) g_atomic_int_get (&c->tail) - (guint) g_atomic_int_get (&c->head);
+}
+
+/**
+ * @brief Wake up a sleeping thread.
+ */
+static void
+_wake_up (TensorSinkConsumer * c, gint * waiting, GCond * cond)
+{
+  if (g_atomic_int_get (waiting) > 0) {
+    g_mutex_lock (&c->lock);
+    g_cond_signal (cond);
+    g_mutex_unlock (&c->lock);
+  }
+}
+
+/**
+ * @brief Call the handler and release the item.
+ */
+static void
+_handle_item (TensorSinkConsumer * c, ConsumerItem * item)
+{
+  c->func (item->buffer, item->caps, c->user_data);
+
+  gst_buffer_unref (item->buffer);
+  if (item->caps)
+    gst_caps_unref (item->caps);
+}
+
+/**
+ * @brief Worker thread, handles the buffers until the consumer is stopped and the ring is empty.
+ */
+static gpointer
+_worker_thread (gpointer data)
+{
+  ConsumerWorker *worker = (ConsumerWorker *) data;
+  TensorSinkConsumer *c = worker->consumer;
+  ConsumerItem item;
+  gint64 wait_us, end_time;
+  guint spin = 0;
+
+  while (TRUE) {
+    if (_ring_pop (c, &item)) {
+      spin = 0;
+      _wake_up (c, &c->waiting_producer, &c->not_full);
+
+      wait_us = g_get_monotonic_time () - item.queued;
+
+      _handle_item (c, &item);
+
+      g_mutex_lock (&c->stats_lock);
+      worker->wait_us_sum += wait_us;
+      worker->wait_us_max = MAX (worker->wait_us_max, wait_us);
+      worker->processed++;
+      g_mutex_unlock (&c->stats_lock);
+      continue;
+    }
+
+    if (g_atomic_int_get (&c->stop))
+      break;
+
+    if (++spin < CONSUMER_SPIN) {
+      g_thread_yield ();
+      continue;
+    }
+
+    /* check again after registering as a sleeper, the producer signals under the lock */
+    g_mutex_lock (&c->lock);
+    g_atomic_int_inc (&c->waiting_workers);
+    if (_ring_depth (c) == 0 && !g_atomic_int_get (&c->stop)) {
+      end_time = g_get_monotonic_time () + CONSUMER_WAIT_US;
+      g_cond_wait_until (&c->not_empty, &c->lock, end_time);
+    }
+    g_atomic_int_add (&c->waiting_workers, -1);
+    g_mutex_unlock (&c->lock);
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief Callback for notify::caps of the sink pad, cache the negotiated caps.
+ */
+static void
+_caps_notify_cb (GObject * object, GParamSpec * pspec, gpointer user_data)
+{
+  TensorSinkConsumer *c = (TensorSinkConsumer *) user_data;
+  GstCaps *caps, *old;
+
+  caps = gst_pad_get_current_caps (GST_PAD (object));
+
+  g_mutex_lock (&c->caps_lock);
+  old = c->caps;
+  c->caps = caps;
+  g_mutex_unlock (&c->caps_lock);
+
+  g_mutex_lock (&c->stats_lock);
+  c->stats.caps_changes++;
+  g_mutex_unlock (&c->stats_lock);
+
+  if (old)
+    gst_caps_unref (old);
+}
+
+/**
+ * @brief Callback for signal new-data, runs on the streaming thread.
+ */
+static void
+_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  TensorSinkConsumer *c = (TensorSinkConsumer *) user_data;
+  ConsumerItem item, old;
+  gint64 start = 0, end_time;
+  guint depth;
+
+  g_mutex_lock (&c->stats_lock);
+  c->stats.received++;
+  g_mutex_unlock (&c->stats_lock);
+
+  /* the caps is updated on this thread before the buffer, no lock to read it */
+  item.buffer = gst_buffer_ref (buffer);
+  item.caps = c->caps ? gst_caps_ref (c->caps) : NULL;
+
+  if (c->num_workers == 0) {
+    _handle_item (c, &item);
+
+    g_mutex_lock (&c->stats_lock);
+    c->stats.processed++;
+    g_mutex_unlock (&c->stats_lock);
+    return;
+  }
+
+  item.queued = g_get_monotonic_time ();
+
+  while (!_ring_push (c, &item)) {
+    if (c->policy == TENSOR_SINK_CONSUMER_DROP_NEW) {
+      g_mutex_lock (&c->stats_lock);
+      c->stats.dropped++;
+      g_mutex_unlock (&c->stats_lock);
+
+      gst_buffer_unref (item.buffer);
+      if (item.caps)
+        gst_caps_unref (item.caps);
+      return;
+    }
+
+    if (c->policy == TENSOR_SINK_CONSUMER_DROP_OLD) {
+      if (_ring_pop (c, &old)) {
+        g_mutex_lock (&c->stats_lock);
+        c->stats.dropped++;
+        g_mutex_unlock (&c->stats_lock);
+
+        gst_buffer_unref (old.buffer);
+        if (old.caps)
+          gst_caps_unref (old.caps);
+      }
+      continue;
+    }
+
+    /* block, backpressure to the upstream */
+    if (start == 0) {
+      start = g_get_monotonic_time ();
+      g_mutex_lock (&c->stats_lock);
+      c->stats.blocked++;
+      g_mutex_unlock (&c->stats_lock);
+    }
+
+    g_mutex_lock (&c->lock);
+    g_atomic_int_set (&c->waiting_producer, 1);
+    if (_ring_depth (c) >= c->capacity) {
+      end_time = g_get_monotonic_time () + CONSUMER_WAIT_US;
+      g_cond_wait_until (&c->not_full, &c->lock, end_time);
+    }
+    g_atomic_int_set (&c->waiting_producer, 0);
+    g_mutex_unlock (&c->lock);
+  }
+
+  depth = _ring_depth (c);
+
+  g_mutex_lock (&c->stats_lock);
+  if (start > 0)
+    c->stats.blocked_us += g_get_monotonic_time () - start;
+  if (depth > c->stats.max_depth)
+    c->stats.max_depth = depth;
+  g_mutex_unlock (&c->stats_lock);
+
+  _wake_up (c, &c->waiting_workers, &c->not_empty);
+}
+
+/**
+ * @brief Create the consumer and connect it to tensor_sink.
+ * @param sink tensor_sink element
+ * @param num_workers number of worker threads, 0 to call the handler on the streaming thread
+ * @param capacity number of buffers in the ring, rounded up to a power of 2
+ * @param policy what to do when the ring is full
+ * @param func handler of the buffer
+ * @param user_data user data of the handler
+ * @return newly created consumer, NULL if failed
+ */
+TensorSinkConsumer *
+tensor_sink_consumer_new (GstElement * sink, guint num_workers, guint capacity,
+    TensorSinkConsumerPolicy policy, TensorSinkConsumerFunc func, gpointer user_data)
+{
+  TensorSinkConsumer *c;
+  gchar *name;
+  guint i;
+
+  g_return_val_if_fail (GST_IS_ELEMENT (sink), NULL);
+  g_return_val_if_fail (func != NULL, NULL);
+
+  c = g_new0 (TensorSinkConsumer, 1);
+  c->sink = gst_object_ref (sink);
+  c->func = func;
+  c->user_data = user_data;
+  c->policy = policy;
+  c->num_workers = num_workers;
+  g_mutex_init (&c->lock);
+  g_mutex_init (&c->caps_lock);
+  g_mutex_init (&c->stats_lock);
+  g_cond_init (&c->not_empty);
+  g_cond_init (&c->not_full);
+
+  c->capacity = 1;
+  while (c->capacity < MAX (capacity, 2U))
+    c->capacity <<= 1;
+  c->mask = c->capacity - 1;
+
+  /* the producer pops in drop-old policy, it needs the MPMC ring */
+  c->mpmc = (num_workers > 1 || policy == TENSOR_SINK_CONSUMER_DROP_OLD);
+  c->cells = g_new0 (ConsumerCell, c->capacity);
+  for (i = 0; i < c->capacity; i++)
+    c->cells[i].seq = (gint) i;
+
+  c->pad = gst_element_get_static_pad (sink, "sink");
+  if (c->pad) {
+    c->caps = gst_pad_get_current_caps (c->pad);
+    c->caps_handler = g_signal_connect (c->pad, "notify::caps",
+        G_CALLBACK (_caps_notify_cb), c);
+  }
+
+  if (num_workers > 0) {
+    c->workers = g_new0 (ConsumerWorker, num_workers);
+
+    for (i = 0; i < num_workers; i++) {
+      c->workers[i].consumer = c;
+
+      name = g_strdup_printf ("consumer-%u", i);
+      c->workers[i].thread = g_thread_new (name, _worker_thread, &c->workers[i]);
+      g_free (name);
+    }
+  }
+
+  c->data_handler = g_signal_connect (sink, "new-data", G_CALLBACK (_new_data_cb), c);
+  return c;
+}
+
+/**
+ * @brief Disconnect from tensor_sink, wait for the workers to handle the queued buffers, and free the consumer.
+ * @note Call this after the pipeline is stopped.
+ */
+void
+tensor_sink_consumer_free (TensorSinkConsumer * consumer)
+{
+  TensorSinkConsumer *c = consumer;
+  ConsumerItem item;
+  guint i;
+
+  g_return_if_fail (c != NULL);
+
+  if (c->data_handler > 0)
+    g_signal_handler_disconnect (c->sink, c->data_handler);
+  if (c->caps_handler > 0)
+    g_signal_handler_disconnect (c->pad, c->caps_handler);
+
+  g_atomic_int_set (&c->stop, 1);
+  g_mutex_lock (&c->lock);
+  g_cond_broadcast (&c->not_empty);
+  g_mutex_unlock (&c->lock);
+
+  for (i = 0; i < c->num_workers; i++)
+    g_thread_join (c->workers[i].thread);
+
+  /* no worker, release the remaining buffers */
+  while (_ring_pop (c, &item)) {
+    gst_buffer_unref (item.buffer);
+    if (item.caps)
+      gst_caps_unref (item.caps);
+  }
+
+  if (c->caps)
+    gst_caps_unref (c->caps);
+  if (c->pad)
+    gst_object_unref (c->pad);
+  gst_object_unref (c->sink);
+
+  g_cond_clear (&c->not_empty);
+  g_cond_clear (&c->not_full);
+  g_mutex_clear (&c->lock);
+  g_mutex_clear (&c->caps_lock);
+  g_mutex_clear (&c->stats_lock);
+  g_free (c->workers);
+  g_free (c->cells);
+  g_free (c);
+}
+
+/**
+ * @brief Get the statistics of the consumer.
+ */
+void
+tensor_sink_consumer_get_stats (TensorSinkConsumer * consumer, TensorSinkConsumerStats * stats)
+{
+  TensorSinkConsumer *c = consumer;
+  gint64 wait_sum = 0;
+  guint64 processed = 0;
+  guint i;
+
+  g_return_if_fail (c != NULL && stats != NULL);
+
+  /* one snapshot of the producer and the workers */
+  g_mutex_lock (&c->stats_lock);
+  *stats = c->stats;
+
+  stats->wait_us_max = 0;
+  for (i = 0; i < c->num_workers; i++) {
+    processed += c->workers[i].processed;
+    wait_sum += c->workers[i].wait_us_sum;
+    stats->wait_us_max = MAX (stats->wait_us_max, c->workers[i].wait_us_max);
+  }
+  g_mutex_unlock (&c->stats_lock);
+
+  if (c->num_workers > 0)
+    stats->processed = processed;
+  stats->wait_us_avg = (processed > 0) ? (wait_sum / (gint64) processed) : 0;
+}
+
+/**
+ * @brief Wait until all received buffers are handled or dropped, e.g., after EOS.
+ * @return TRUE if the consumer is idle, FALSE if timed out
+ */
+gboolean
+tensor_sink_consumer_wait_idle (TensorSinkConsumer * consumer, gint64 timeout_us)
+{
+  TensorSinkConsumerStats stats;
+  gint64 end_time;
+
+  g_return_val_if_fail (consumer != NULL, FALSE);
+
+  end_time = g_get_monotonic_time () + timeout_us;
+  while (TRUE) {
+    tensor_sink_consumer_get_stats (consumer, &stats);
+    if (stats.processed + stats.dropped >= stats.received)
+      return TRUE;
+
+    if (g_get_monotonic_time () > end_time)
+      return FALSE;
+
+    g_usleep (1000);
+  }
+}
+
+/**
+ * @brief Get the cached caps of tensor_sink.
+ * @return caps with a reference (unref it after use), NULL if not negotiated
+ */
+GstCaps *
+tensor_sink_consumer_get_caps (TensorSinkConsumer * consumer)
+{
+  GstCaps *caps = NULL;
+
+  g_return_val_if_fail (consumer != NULL, NULL);
+
+  g_mutex_lock (&consumer->caps_lock);
+  if (consumer->caps)
+    caps = gst_caps_ref (consumer->caps);
+  g_mutex_unlock (&consumer->caps_lock);
+
+  return caps;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file	tensor_sink_consumer.h
+ * @date	19 October 2026
+ * @brief	Consumer of tensor_sink, hands the buffers off the streaming thread to worker threads
+ * @see		https://github.com/nnstreamer/nnstreamer
+ * @author	Jaeyun Jung <jy1210.jung@samsung.com>
+ * @bug		No known bugs.
+ *
+ * The new-data signal of tensor_sink runs on the streaming thread, so a slow handler stalls the pipeline.
+ * The consumer connects to the signal, takes a reference of the buffer and passes it to the worker threads
+ * through a lock-free ring (SPSC for one worker, MPMC for more workers or drop-old policy).
+ * The negotiated caps are cached when the caps of the sink pad is changed, not queried for each buffer.
+ *
+ * The handler is called on a worker thread with the buffer and its caps. Do not unref them.
+ * With multiple workers, buffers may be handled out of order.
+ */
+#ifndef __TENSOR_SINK_CONSUMER_H__
+#define __TENSOR_SINK_CONSUMER_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Handler of the buffer, called on the worker thread.
+ */
+typedef void (*TensorSinkConsumerFunc) (GstBuffer * buffer, GstCaps * caps, gpointer user_data);
+
+/**
+ * @brief What to do when the ring is full.
+ */
+typedef enum
+{
+  TENSOR_SINK_CONSUMER_BLOCK = 0, /**< wait for a free slot, backpressure to the pipeline */
+  TENSOR_SINK_CONSUMER_DROP_NEW, /**< drop the incoming buffer */
+  TENSOR_SINK_CONSUMER_DROP_OLD /**< drop the oldest buffer in the ring */
+} TensorSinkConsumerPolicy;
+
+/**
+ * @brief Statistics of the consumer. The values are approximate while the pipeline is running.
+ */
+typedef struct
+{
+  guint64 received; /**< buffers from tensor_sink */
+  guint64 processed; /**< buffers handled by the workers */
+  guint64 dropped; /**< buffers dropped because the ring is full */
+  guint64 blocked; /**< times the streaming thread waited for a free slot */
+  gint64 blocked_us; /**< total time the streaming thread waited */
+  guint max_depth; /**< max number of buffers in the ring */
+  guint caps_changes; /**< number of caps updates */
+  gint64 wait_us_avg; /**< average time a buffer stays in the ring */
+  gint64 wait_us_max; /**< max time a buffer stays in the ring */
+} TensorSinkConsumerStats;
+
+typedef struct _TensorSinkConsumer TensorSinkConsumer;
+
+extern TensorSinkConsumer * tensor_sink_consumer_new (GstElement * sink, guint num_workers,
+    guint capacity, TensorSinkConsumerPolicy policy, TensorSinkConsumerFunc func, gpointer user_data);
+extern void tensor_sink_consumer_free (TensorSinkConsumer * consumer);
+extern gboolean tensor_sink_consumer_wait_idle (TensorSinkConsumer * consumer, gint64 timeout_us);
+extern void tensor_sink_consumer_get_stats (TensorSinkConsumer * consumer, TensorSinkConsumerStats * stats);
+extern GstCaps * tensor_sink_consumer_get_caps (TensorSinkConsumer * consumer);
+
+G_END_DECLS
+
+#endif /* __TENSOR_SINK_CONSUMER_H__ */
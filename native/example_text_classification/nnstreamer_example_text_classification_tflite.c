@@ -4,13 +4,19 @@
  * @brief	Example with tensorflolw-lite model for text classification.
  * @author	Gichan Jang <gichan2.jang@samsung.com>
  * @bug		No known bugs.
+ *
+ * --parallel-init loads the labels and the dictionary on worker threads while the pipeline
+ * starts, --trace-startup prints the startup phases until the app is ready for the input.
  */
 
 #include <stdio.h>
 #include <string.h>
+#include <getopt.h>
 #include <glib.h>
 #include <gst/gst.h>
 #include <gst/app/app.h>
+#include "appsrc_feeder.h"
+#include "startup_tracer.h"
 
 #define MAX_SENTENCE_LENGTH 256
 
@@ -24,10 +30,16 @@ typedef struct
   GstElement *pipeline; /**< gst pipeline for data stream */
   GstBus *bus; /**< gst bus for data pipeline */
   GstElement *src; /**< appsrc element in pipeline */
+  AppsrcFeeder *feeder; /**< recycles the input buffers of appsrc */
 
   gchar *model_file; /**< tensorflow-lite model file */
+  gchar *label_file; /**< label file */
+  gchar *vocab_file; /**< dictionary file */
   gchar **labels;
   GHashTable *words;
+
+  StartupTracer *tracer; /**< startup phases, NULL if not traced */
+  StartupTasks *tasks; /**< loaders of the labels and the dictionary */
 } app_data_s;
 
 
@@ -105,44 +117,34 @@ bus_message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
 }
 
 /**
- * @brief Function to load dictionary.
+ * @brief Function to load label file.
  */
 static gboolean
-load_model_files (app_data_s * app)
+load_labels (gpointer user_data)
 {
-  const gchar path[] = "./tflite_text_classification";
-
-  gboolean failed = FALSE;
-  gchar *model = g_build_filename (path, "text_classification.tflite", NULL);
-  gchar *label = g_build_filename (path, "labels.txt", NULL);
-  gchar *vocab = g_build_filename (path, "vocab.txt", NULL);
+  app_data_s *app = (app_data_s *) user_data;
   gchar *contents;
 
-  /* check the model files */
-  if (!g_file_test (model, G_FILE_TEST_EXISTS) ||
-      !g_file_test (label, G_FILE_TEST_EXISTS) ||
-      !g_file_test (vocab, G_FILE_TEST_EXISTS)) {
-    g_critical ("Failed to get model files.");
-    g_print ("Please enter as below to download and locate the model.\n");
-    g_print ("$ cd $NNST_ROOT/bin/ \n");
-    g_print ("$ ./get-model.sh text-classification-tflite \n");
-    failed = TRUE;
-    goto error;
+  if (!g_file_get_contents (app->label_file, &contents, NULL, NULL)) {
+    g_critical ("Failed to load label file.");
+    return FALSE;
   }
 
-  /* load label file */
-  if (g_file_get_contents (label, &contents, NULL, NULL)) {
-    app->labels = g_strsplit (contents, "\n", -1);
+  app->labels = g_strsplit (contents, "\n", -1);
+  g_free (contents);
+  return TRUE;
+}
 
-    g_free (contents);
-  } else {
-    g_critical ("Failed to load label file.");
-    failed = TRUE;
-    goto error;
-  }
+/**
+ * @brief Function to load dictionary.
+ */
+static gboolean
+load_vocab (gpointer user_data)
+{
+  app_data_s *app = (app_data_s *) user_data;
+  gchar *contents;
 
-  /* load dictionary */
-  if (g_file_get_contents (vocab, &contents, NULL, NULL)) {
+  if (g_file_get_contents (app->vocab_file, &contents, NULL, NULL)) {
     gchar **dics = g_strsplit (contents, "\n", -1);
     guint dics_len = g_strv_length (dics);
     guint i;
@@ -173,16 +175,39 @@ load_model_files (app_data_s * app)
     g_free (contents);
   } else {
     g_critical ("Failed to load dictionary file.");
-    failed = TRUE;
-    goto error;
+    return FALSE;
   }
 
-error:
-  g_free (label);
-  g_free (vocab);
+  return TRUE;
+}
 
-  app->model_file = model;
-  return !failed;
+/**
+ * @brief Function to check the model files and load the labels and the dictionary.
+ */
+static gboolean
+load_model_files (app_data_s * app)
+{
+  const gchar path[] = "./tflite_text_classification";
+
+  app->model_file = g_build_filename (path, "text_classification.tflite", NULL);
+  app->label_file = g_build_filename (path, "labels.txt", NULL);
+  app->vocab_file = g_build_filename (path, "vocab.txt", NULL);
+
+  /* check the model files */
+  if (!g_file_test (app->model_file, G_FILE_TEST_EXISTS) ||
+      !g_file_test (app->label_file, G_FILE_TEST_EXISTS) ||
+      !g_file_test (app->vocab_file, G_FILE_TEST_EXISTS)) {
+    g_critical ("Failed to get model files.");
+    g_print ("Please enter as below to download and locate the model.\n");
+    g_print ("$ cd $NNST_ROOT/bin/ \n");
+    g_print ("$ ./get-model.sh text-classification-tflite \n");
+    return FALSE;
+  }
+
+  /* on worker threads with --parallel-init, the input waits for them */
+  startup_tasks_add (app->tasks, "labels", load_labels, app);
+  startup_tasks_add (app->tasks, "vocab", load_vocab, app);
+  return TRUE;
 }
 
 /**
@@ -192,13 +217,11 @@ static void
 handle_input_string (app_data_s * app)
 {
   GstBuffer *buf;
+  GstMapInfo map;
   gchar **tokens;
   gint tokens_len, i, value, start, unknown, pad;
   gfloat *float_array;
 
-  float_array = g_malloc0 (sizeof (gfloat) * MAX_SENTENCE_LENGTH);
-  g_assert (float_array);
-
   /* Get user input */
   gchar sentence[MAX_SENTENCE_LENGTH] = { 0, };
   g_print ("Please enter your movie review : ");
@@ -211,6 +234,12 @@ handle_input_string (app_data_s * app)
   pad = GPOINTER_TO_INT (g_hash_table_lookup (app->words, "<PAD>"));
   unknown = GPOINTER_TO_INT (g_hash_table_lookup (app->words, "<UNKNOWN>"));
 
+  /* buffer from the pool, all elements are filled below */
+  buf = appsrc_feeder_acquire (app->feeder,
+      MAX_SENTENCE_LENGTH * sizeof (gfloat), &map);
+  g_assert (buf);
+  float_array = (gfloat *) map.data;
+
   float_array[0] = (gfloat) start;
 
   tokens = g_strsplit_set (sentence, " \n\t", MAX_SENTENCE_LENGTH);
@@ -225,13 +254,7 @@ handle_input_string (app_data_s * app)
     float_array[i++] = (gfloat) pad;
   }
 
-  buf =
-      gst_buffer_new_wrapped (float_array,
-      MAX_SENTENCE_LENGTH * sizeof (gfloat));
-  g_assert (buf);
-
-  g_assert (gst_app_src_push_buffer (GST_APP_SRC (app->src),
-          buf) == GST_FLOW_OK);
+  g_assert (appsrc_feeder_push (app->feeder, buf, &map) == GST_FLOW_OK);
 }
 
 /**
@@ -272,13 +295,50 @@ main (int argc, char **argv)
   GstElement *element;
   gchar *str_dim, *str_type, *str_caps;
   GstCaps *caps;
+  StartupTracer *tracer;
+  gboolean trace = FALSE, parallel_init = FALSE, loaded;
+  gint64 start;
+  gint opt;
+  struct option long_options[] = {
+    {"trace-startup", no_argument, NULL, 'r'},
+    {"parallel-init", no_argument, NULL, 'p'},
+    {"help", no_argument, NULL, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  /* created before gst_init, freed below without --trace-startup */
+  tracer = startup_tracer_new ();
 
   /* init gstreamer */
+  start = g_get_monotonic_time ();
   gst_init (&argc, &argv);
+  startup_tracer_span (tracer, "gst_init", start);
+
+  while ((opt = getopt_long (argc, argv, "rph", long_options, NULL)) != -1) {
+    switch (opt) {
+      case 'r':
+        trace = TRUE;
+        break;
+      case 'p':
+        parallel_init = TRUE;
+        break;
+      default:
+        g_print ("usage: nnstreamer_example_text_classification_tflite [--trace-startup] [--parallel-init]\n");
+        startup_tracer_free (tracer);
+        return 0;
+    }
+  }
+
+  if (!trace) {
+    startup_tracer_free (tracer);
+    tracer = NULL;
+  }
 
   /* init app variable */
   app = g_new0 (app_data_s, 1);
   g_assert (app);
+  app->tracer = tracer;
+  app->tasks = startup_tasks_new (parallel_init, tracer);
 
   /* load model files */
   g_assert (load_model_files (app));
@@ -290,9 +350,12 @@ main (int argc, char **argv)
       "tensor_filter name=tfilter framework=tensorflow-lite model=%s ! "
       "tensor_sink name=tensor_sink", app->model_file);
 
+  start = g_get_monotonic_time ();
   app->pipeline = gst_parse_launch (pipeline, NULL);
+  startup_tracer_span (app->tracer, "parse", start);
   g_free (pipeline);
   g_assert (app->pipeline);
+  startup_tracer_attach (app->tracer, app->pipeline);
 
   /* bus and message callback */
   app->bus = gst_element_get_bus (app->pipeline);
@@ -335,8 +398,21 @@ main (int argc, char **argv)
   gst_caps_unref (caps);
   gst_object_unref (element);
 
+  /* preallocated buffers for the input sentence */
+  app->feeder = appsrc_feeder_new (app->src,
+      MAX_SENTENCE_LENGTH * sizeof (gfloat), 2, 4, 64);
+  g_assert (app->feeder);
+
   /* Start playing */
+  start = g_get_monotonic_time ();
   gst_element_set_state (app->pipeline, GST_STATE_PLAYING);
+  startup_tracer_span (app->tracer, "set_state_playing", start);
+
+  /* the labels and the dictionary are loaded while the pipeline starts */
+  loaded = startup_tasks_wait (app->tasks);
+  g_assert (loaded);
+  startup_tracer_mark (app->tracer, "ready");
+  startup_tracer_print (app->tracer, stdout);
 
   /* ready to get input sentence */
   app->running = TRUE;
@@ -351,11 +427,16 @@ main (int argc, char **argv)
   gst_element_set_state (app->pipeline, GST_STATE_NULL);
 
   /* close app */
+  startup_tracer_free (app->tracer);
+  startup_tasks_free (app->tasks);
+  appsrc_feeder_free (app->feeder);
   gst_bus_remove_signal_watch (app->bus);
   gst_object_unref (app->bus);
   gst_object_unref (app->pipeline);
 
   g_free (app->model_file);
+  g_free (app->label_file);
+  g_free (app->vocab_file);
   g_strfreev (app->labels);
   g_hash_table_destroy (app->words);
 
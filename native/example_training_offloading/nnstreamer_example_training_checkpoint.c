@@ -0,0 +1,515 @@
+/**
+ * @file	nnstreamer_example_training_checkpoint.c
+ * @date	19 October 2026
+ * @brief	checkpointed and resumable training example
+ * @author	Hyunil Park <hyunil46.park@samsung.com>
+ * @bug		No known bugs.
+ *
+ * tensor_trainer saves the model when the training is completed. This example trains
+ * the model in segments of --checkpoint-interval epochs, each segment loads the model
+ * saved by the previous one. A writer thread makes each saved model durable and updates
+ * the checkpoint manifest, so the training does not wait for the storage. When the example
+ * runs again, the training resumes from the last checkpoint in --checkpoint-dir.
+ *
+ * With --prefetch=K, the samples of datareposrc are augmented and normalized by worker
+ * threads, K mini-batches ahead of tensor_trainer (see training_prefetch.h).
+ * --prefetch=0 processes the samples in the streaming thread, to compare with.
+ *
+ * $ ./nnstreamer_example_training_checkpoint --filename=mnist.data --json=mnist.json \
+ *     --model-config=mnist.ini --epochs=10 --checkpoint-interval=2 --checkpoint-dir=checkpoint
+ */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gst/gst.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "training_prefetch.h"
+#include "training_stats.h"
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) if (DBG) g_message (__VA_ARGS__)
+
+/**
+ * @brief Name of the checkpoint manifest.
+ */
+#define CHECKPOINT_MANIFEST "checkpoint.ini"
+
+/**
+ * @brief Checkpoint to write.
+ */
+typedef struct
+{
+  guint epochs; /**< the number of finished epochs, 0 to stop the writer */
+  gchar *model; /**< model saved by tensor_trainer */
+} CheckpointJob;
+
+/**
+ * @brief Data structure for the checkpoint writer.
+ */
+typedef struct
+{
+  GThread *thread;
+  GAsyncQueue *jobs;
+  GQueue models; /**< models of the checkpoints, oldest first */
+  gchar *dir;
+  guint keep; /**< the number of checkpoints to keep */
+  guint written;
+  gint64 write_us; /**< time to write the checkpoints */
+  gint64 write_max_us;
+} CheckpointWriter;
+
+/**
+ * @brief Data structure for app.
+ */
+typedef struct
+{
+  GMainLoop *loop; /**< main event loop */
+  GstElement *pipeline; /**< gst pipeline for data stream */
+  GstBus *bus; /**< gst bus for data pipeline */
+  gboolean failed; /**< error message is received */
+} AppData;
+
+/**
+ * @brief Data for pipeline and result.
+ */
+static AppData g_app;
+
+static const gchar *filename = NULL;
+static const gchar *json = NULL;
+static const gchar *model_config = NULL;
+static const gchar *model_load_path = NULL;
+static const gchar *checkpoint_dir = "checkpoint";
+static gint epochs = 10;
+static gint checkpoint_interval = 2;
+static gint keep = 2;
+static gint start_sample_index = 0;
+static gint stop_sample_index = 999;
+static gint num_training_sample = 500;
+static gint num_validation_sample = 500;
+static gint num_inputs = 1;
+static gint num_labels = 1;
+static gboolean no_resume = FALSE;
+static gint prefetch_depth = -1;
+static gint prefetch_batch = 16;
+static gint workers = 2;
+static gboolean augment = FALSE;
+static gdouble normalize_scale = 1.0;
+static gdouble normalize_offset = 0.0;
+
+static GOptionEntry entries[] = {
+  {"filename", 0, 0, G_OPTION_ARG_STRING, &filename,
+      "filename to be read by datareposrc"},
+  {"json", 0, 0, G_OPTION_ARG_STRING, &json,
+      "stream meta info to be read by datareposrc"},
+  {"model-config", 0, 0, G_OPTION_ARG_STRING, &model_config,
+      "model configuration file is used to configure the model"},
+  {"model-load-path", 0, 0, G_OPTION_ARG_STRING, &model_load_path,
+      "initial model to load if there is no checkpoint"},
+  {"checkpoint-dir", 0, 0, G_OPTION_ARG_STRING, &checkpoint_dir,
+      "directory of the checkpoints"},
+  {"epochs", 0, 0, G_OPTION_ARG_INT, &epochs, "total number of epochs"},
+  {"checkpoint-interval", 0, 0, G_OPTION_ARG_INT, &checkpoint_interval,
+      "save a checkpoint every N epochs"},
+  {"keep", 0, 0, G_OPTION_ARG_INT, &keep,
+      "the number of checkpoints to keep"},
+  {"start-sample-index", 0, 0, G_OPTION_ARG_INT, &start_sample_index,
+      "Set start index of range of samples"},
+  {"stop-sample-index", 0, 0, G_OPTION_ARG_INT, &stop_sample_index,
+      "Set stop index of range of samples"},
+  {"num-training-sample", 0, 0, G_OPTION_ARG_INT, &num_training_sample,
+      "set how many samples are taken for training model"},
+  {"num-validation-sample", 0, 0, G_OPTION_ARG_INT, &num_validation_sample,
+      "set how many samples are taken validation model"},
+  {"num-inputs", 0, 0, G_OPTION_ARG_INT, &num_inputs,
+      "set how many inputs are received"},
+  {"num-labels", 0, 0, G_OPTION_ARG_INT, &num_labels,
+      "set how many labels are received"},
+  {"no-resume", 0, 0, G_OPTION_ARG_NONE, &no_resume,
+      "start from the beginning, ignore the checkpoints"},
+  {"prefetch", 0, 0, G_OPTION_ARG_INT, &prefetch_depth,
+      "prepare K mini-batches ahead of the trainer, 0 to process them inline"},
+  {"prefetch-batch", 0, 0, G_OPTION_ARG_INT, &prefetch_batch,
+      "the number of samples in a mini-batch of the prefetch stage"},
+  {"workers", 0, 0, G_OPTION_ARG_INT, &workers,
+      "the number of worker threads of the prefetch stage"},
+  {"augment", 0, 0, G_OPTION_ARG_NONE, &augment,
+      "random brightness, contrast and noise on the feature (float32)"},
+  {"normalize-scale", 0, 0, G_OPTION_ARG_DOUBLE, &normalize_scale,
+      "normalize the feature (float32), x * scale + offset"},
+  {"normalize-offset", 0, 0, G_OPTION_ARG_DOUBLE, &normalize_offset,
+      "normalize the feature (float32), x * scale + offset"},
+  {NULL}
+};
+
+/**
+ * @brief Bus callback for message.
+ */
+static gboolean
+bus_callback (GstBus * bus, GstMessage * message, gpointer data)
+{
+  GError *error = NULL;
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_EOS:
+      _print_log ("received eos message");
+      g_main_loop_quit (g_app.loop);
+      break;
+    case GST_MESSAGE_ERROR:
+      gst_message_parse_error (message, &error, NULL);
+      g_critical ("received error message: %s", error ? error->message : "unknown");
+      g_clear_error (&error);
+      g_app.failed = TRUE;
+      g_main_loop_quit (g_app.loop);
+      break;
+    default:
+      break;
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Flush the file to the storage.
+ */
+static gboolean
+_sync_file (const gchar * path)
+{
+  gint fd;
+  gboolean ret;
+
+  fd = g_open (path, O_RDONLY, 0);
+  if (fd < 0)
+    return FALSE;
+
+  ret = (fsync (fd) == 0);
+  close (fd);
+  return ret;
+}
+
+/**
+ * @brief Write the checkpoint manifest, replaced at once by rename.
+ */
+static gboolean
+_write_manifest (CheckpointWriter * writer, CheckpointJob * job)
+{
+  GKeyFile *key_file;
+  gchar *data, *path, *tmp;
+  gsize len;
+  FILE *fp;
+  gboolean ret = FALSE;
+
+  key_file = g_key_file_new ();
+  g_key_file_set_integer (key_file, "checkpoint", "epochs", job->epochs);
+  g_key_file_set_string (key_file, "checkpoint", "model", job->model);
+  g_key_file_set_int64 (key_file, "checkpoint", "time", g_get_real_time () / G_USEC_PER_SEC);
+  data = g_key_file_to_data (key_file, &len, NULL);
+
+  path = g_build_filename (writer->dir, CHECKPOINT_MANIFEST, NULL);
+  tmp = g_strdup_printf ("%s.tmp", path);
+
+  fp = g_fopen (tmp, "w");
+  if (fp) {
+    ret = (fwrite (data, 1, len, fp) == len && fflush (fp) == 0 && fsync (fileno (fp)) == 0);
+    ret = (fclose (fp) == 0) && ret;
+  }
+
+  if (ret)
+    ret = (g_rename (tmp, path) == 0);
+  else
+    g_unlink (tmp);
+
+  /* the directory entry of the manifest */
+  if (ret)
+    _sync_file (writer->dir);
+
+  g_free (path);
+  g_free (tmp);
+  g_free (data);
+  g_key_file_free (key_file);
+  return ret;
+}
+
+/**
+ * @brief Checkpoint writer thread, off the training path.
+ */
+static gpointer
+_writer_thread (gpointer user_data)
+{
+  CheckpointWriter *writer = (CheckpointWriter *) user_data;
+  CheckpointJob *job;
+  gint64 start, elapsed;
+  gchar *old;
+
+  while ((job = (CheckpointJob *) g_async_queue_pop (writer->jobs)) != NULL) {
+    if (job->epochs == 0) {
+      g_free (job);
+      break;
+    }
+
+    start = g_get_monotonic_time ();
+
+    /* the model is complete before the manifest points to it */
+    if (_sync_file (job->model) && _write_manifest (writer, job)) {
+      g_message ("checkpoint: %u epochs, %s", job->epochs, job->model);
+      writer->written++;
+
+      g_queue_push_tail (&writer->models, job->model);
+      job->model = NULL;
+
+      while (g_queue_get_length (&writer->models) > writer->keep) {
+        old = (gchar *) g_queue_pop_head (&writer->models);
+        g_unlink (old);
+        g_free (old);
+      }
+    } else {
+      g_critical ("Failed to write the checkpoint %s", job->model);
+    }
+
+    elapsed = g_get_monotonic_time () - start;
+    writer->write_us += elapsed;
+    writer->write_max_us = MAX (writer->write_max_us, elapsed);
+
+    g_free (job->model);
+    g_free (job);
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief Push the checkpoint to the writer.
+ */
+static void
+_push_checkpoint (CheckpointWriter * writer, guint epochs_done, const gchar * model)
+{
+  CheckpointJob *job = g_new0 (CheckpointJob, 1);
+
+  job->epochs = epochs_done;
+  job->model = g_strdup (model);
+  g_async_queue_push (writer->jobs, job);
+}
+
+/**
+ * @brief Read the last checkpoint.
+ * @return the number of finished epochs, 0 if there is no checkpoint
+ */
+static guint
+_read_checkpoint (const gchar * dir, gchar ** model)
+{
+  GKeyFile *key_file;
+  gchar *path;
+  guint done = 0;
+
+  *model = NULL;
+  path = g_build_filename (dir, CHECKPOINT_MANIFEST, NULL);
+  key_file = g_key_file_new ();
+
+  if (g_key_file_load_from_file (key_file, path, G_KEY_FILE_NONE, NULL)) {
+    *model = g_key_file_get_string (key_file, "checkpoint", "model", NULL);
+    done = (guint) g_key_file_get_integer (key_file, "checkpoint", "epochs", NULL);
+
+    if (!*model || !g_file_test (*model, G_FILE_TEST_EXISTS)) {
+      g_free (*model);
+      *model = NULL;
+      done = 0;
+    }
+  }
+
+  g_key_file_free (key_file);
+  g_free (path);
+  return done;
+}
+
+/**
+ * @brief Train a segment of epochs.
+ */
+static gboolean
+_train_segment (TrainingStats * stats, TrainingPrefetch * prefetch, guint seg_epochs,
+    const gchar * load_path, const gchar * save_path)
+{
+  gchar *str_pipeline, *load_prop = NULL;
+  gboolean ret = FALSE;
+
+  if (load_path)
+    load_prop = g_strdup_printf ("model-load-path=%s", load_path);
+
+  str_pipeline =
+      g_strdup_printf
+      ("datareposrc location=%s json=%s epochs=%u start-sample-index=%d stop-sample-index=%d ! "
+      "%squeue name=dataq ! tensor_trainer name=trainer framework=nntrainer model-config=%s "
+      "model-save-path=%s %s num-inputs=%d num-labels=%d "
+      "num-training-samples=%d num-validation-samples=%d epochs=%u ! "
+      "tensor_sink name=result_sink",
+      filename, json, seg_epochs, start_sample_index, stop_sample_index,
+      prefetch ? "appsink name=prefetch_in appsrc name=prefetch_out ! " : "", model_config, save_path, load_prop ? load_prop : "", num_inputs, num_labels,
+      num_training_sample, num_validation_sample, seg_epochs);
+  _print_log ("%s", str_pipeline);
+
+  g_app.failed = FALSE;
+  g_app.pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  g_free (load_prop);
+  if (!g_app.pipeline)
+    return FALSE;
+
+  if (!training_stats_attach (stats, g_app.pipeline, "dataq", "trainer", "result_sink"))
+    goto done;
+
+  if (prefetch &&
+      !training_prefetch_start (prefetch, g_app.pipeline, "prefetch_in", "prefetch_out"))
+    goto done;
+
+  g_app.bus = gst_element_get_bus (g_app.pipeline);
+  gst_bus_add_watch (g_app.bus, bus_callback, NULL);
+
+  gst_element_set_state (g_app.pipeline, GST_STATE_PLAYING);
+  g_main_loop_run (g_app.loop);
+  gst_element_set_state (g_app.pipeline, GST_STATE_NULL);
+  if (prefetch)
+    training_prefetch_stop (prefetch);
+
+  gst_bus_remove_watch (g_app.bus);
+  gst_object_unref (g_app.bus);
+  g_app.bus = NULL;
+
+  /* tensor_trainer saves the model before EOS */
+  ret = !g_app.failed && g_file_test (save_path, G_FILE_TEST_EXISTS);
+
+done:
+  gst_object_unref (g_app.pipeline);
+  g_app.pipeline = NULL;
+  return ret;
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *err = NULL;
+  CheckpointWriter writer;
+  TrainingStats *stats = NULL;
+  TrainingPrefetch *prefetch = NULL;
+  TrainingPrefetchOption prefetch_option;
+  gchar *load_path = NULL, *save_path;
+  guint done = 0, seg_epochs;
+  gint64 start, elapsed;
+  gint ret = 0;
+
+  memset (&writer, 0, sizeof (CheckpointWriter));
+  context = g_option_context_new (" - checkpointed training option");
+  g_option_context_add_main_entries (context, entries, NULL);
+  g_option_context_add_group (context, gst_init_get_option_group ());
+  if (!g_option_context_parse (context, &argc, &argv, &err)) {
+    g_printerr ("Error initializing: %s\n", err->message);
+    g_error_free (err);
+    g_option_context_free (context);
+    return -1;
+  }
+  g_option_context_free (context);
+
+  if (!filename || !json || !model_config || epochs <= 0 || checkpoint_interval <= 0) {
+    g_critical ("command example: ./nnstreamer_example_training_checkpoint "
+        "--filename=mnist.data --json=mnist.json --model-config=mnist.ini "
+        "--epochs=10 --checkpoint-interval=2 --checkpoint-dir=checkpoint");
+    return -1;
+  }
+
+  gst_init (&argc, &argv);
+
+  if (g_mkdir_with_parents (checkpoint_dir, 0700) != 0) {
+    g_critical ("Failed to create %s", checkpoint_dir);
+    return -1;
+  }
+
+  /* resume from the last checkpoint */
+  if (!no_resume)
+    done = _read_checkpoint (checkpoint_dir, &load_path);
+  if (load_path)
+    g_message ("resume from the checkpoint: %u epochs, %s", done, load_path);
+  else if (model_load_path)
+    load_path = g_strdup (model_load_path);
+
+  if (done >= (guint) epochs) {
+    g_message ("The training is already finished (%u epochs).", done);
+    g_free (load_path);
+    return 0;
+  }
+
+  writer.dir = g_strdup (checkpoint_dir);
+  writer.keep = MAX (keep, 1);
+  writer.jobs = g_async_queue_new ();
+  g_queue_init (&writer.models);
+  writer.thread = g_thread_new ("checkpoint_writer", _writer_thread, &writer);
+
+  g_app.loop = g_main_loop_new (NULL, FALSE);
+  stats = training_stats_new (done, stdout);
+
+  if (prefetch_depth >= 0) {
+    training_prefetch_option_init (&prefetch_option);
+    prefetch_option.depth = (guint) prefetch_depth;
+    prefetch_option.batch = (guint) MAX (prefetch_batch, 1);
+    prefetch_option.workers = (guint) MAX (workers, 1);
+    prefetch_option.augment = augment;
+    prefetch_option.scale = (gfloat) normalize_scale;
+    prefetch_option.offset = (gfloat) normalize_offset;
+    prefetch = training_prefetch_new (&prefetch_option);
+  }
+  start = g_get_monotonic_time ();
+
+  while (done < (guint) epochs) {
+    seg_epochs = MIN ((guint) checkpoint_interval, (guint) epochs - done);
+    save_path = g_strdup_printf ("%s/model-epoch%04u.bin", checkpoint_dir, done + seg_epochs);
+
+    if (!_train_segment (stats, prefetch, seg_epochs, load_path, save_path)) {
+      g_critical ("Failed to train the epochs %u-%u, run again to resume.", done + 1,
+          done + seg_epochs);
+      g_free (save_path);
+      ret = -1;
+      break;
+    }
+
+    /* the next segment starts while the writer flushes the model */
+    done += seg_epochs;
+    _push_checkpoint (&writer, done, save_path);
+
+    g_free (load_path);
+    load_path = save_path;
+  }
+
+  elapsed = g_get_monotonic_time () - start;
+
+  /* stop the writer after the last checkpoint */
+  _push_checkpoint (&writer, 0, NULL);
+  g_thread_join (writer.thread);
+
+  training_stats_print_summary (stats, stdout);
+  g_print ("total_ms,checkpoints,checkpoint_write_ms,checkpoint_write_max_ms\n");
+  g_print ("%.1f,%u,%.1f,%.1f\n", elapsed / 1000.0, writer.written,
+      writer.write_us / 1000.0, writer.write_max_us / 1000.0);
+  if (prefetch)
+    training_prefetch_print_stats (prefetch, stdout);
+
+  training_prefetch_free (prefetch);
+  training_stats_free (stats);
+  g_queue_clear_full (&writer.models, g_free);
+  g_async_queue_unref (writer.jobs);
+  g_free (writer.dir);
+  g_free (load_path);
+  g_main_loop_unref (g_app.loop);
+
+  return ret;
+}
@@ -10,6 +10,7 @@
 #include <glib/gstdio.h>
 #include <gst/gst.h>
 #include <string.h>
+#include "training_stats.h"
 
 /**
  * @brief Macro for debug mode.
@@ -99,6 +100,7 @@ static const gchar *json = NULL;
 static const gchar *framework = NULL;
 static const gchar *model_config = NULL;
 static const gchar *model_save_path = NULL;
+static const gchar *model_load_path = NULL;
 static const gchar *capsfilter = NULL;
 static const gchar *dest_host = NULL;
 static gint dest_port = -1;
@@ -109,6 +111,7 @@ static gint num_training_sample = 500;
 static gint num_validation_sample = 500;
 static gint num_inputs = 1;
 static gint num_labels = 1;
+static gboolean print_stats = FALSE;
 
 static GOptionEntry entries[] = {
   {"stream-role", 0, 0, G_OPTION_ARG_STRING, &stream_role,
@@ -123,6 +126,8 @@ static GOptionEntry entries[] = {
       "model configuration file is used to configure the model"},
   {"model-save-path", 0, 0, G_OPTION_ARG_STRING, &model_save_path,
       "Path to save the trained model"},
+  {"model-load-path", 0, 0, G_OPTION_ARG_STRING, &model_load_path,
+      "Path of the model to resume the training from"},
   {"input-caps", 0, 0, G_OPTION_ARG_STRING, &capsfilter,
       "input caps of tensor_trainer"},
   {"dest-host", 0, 0, G_OPTION_ARG_STRING, &dest_host,
@@ -142,6 +147,8 @@ static GOptionEntry entries[] = {
       "set how many inputs are received"},
   {"num-labels", 0, 0, G_OPTION_ARG_INT, &num_labels,
       "set how many labels are received"},
+  {"stats", 0, 0, G_OPTION_ARG_NONE, &print_stats,
+      "print samples/sec, epoch time and time blocked on data of the receiver"},
   {NULL}
 };
 
@@ -153,6 +160,8 @@ main (int argc, char **argv)
 {
   GOptionContext *context;
   GError *err = NULL;
+  TrainingStats *stats = NULL;
+  gchar *load_prop = NULL;
 
   context = g_option_context_new (" - training offloading option");
   g_option_context_add_main_entries (context, entries, NULL);
@@ -193,14 +202,17 @@ main (int argc, char **argv)
     _check_cond_err (capsfilter != NULL);
     _check_cond_err (model_config != NULL);
     _check_cond_err (model_save_path != NULL);
+    if (model_load_path)
+      load_prop = g_strdup_printf ("model-load-path=%s", model_load_path);
     str_pipeline =
         g_strdup_printf
-        ("edgesrc dest-host=%s dest-port=%d connect-type=HYBRID topic=tempTopic port=0 ! queue ! %s ! "
-        "tensor_trainer framework=%s model-config=%s model-save-path=%s num-inputs=%d num-labels=%d "
-        "num-training-samples=%d num-validation-samples=%d epochs=%d ! tensor_sink",
+        ("edgesrc dest-host=%s dest-port=%d connect-type=HYBRID topic=tempTopic port=0 ! queue name=dataq ! %s ! "
+        "tensor_trainer name=trainer framework=%s model-config=%s model-save-path=%s %s num-inputs=%d num-labels=%d "
+        "num-training-samples=%d num-validation-samples=%d epochs=%d ! tensor_sink name=result_sink",
         dest_host, dest_port, capsfilter, framework, model_config,
-        model_save_path, num_inputs, num_labels, num_training_sample,
-        num_validation_sample, epochs);
+        model_save_path, load_prop ? load_prop : "", num_inputs, num_labels,
+        num_training_sample, num_validation_sample, epochs);
+    g_free (load_prop);
   } else {
     g_critical ("Invaild stream role");
     goto error;
@@ -210,6 +222,12 @@ main (int argc, char **argv)
   g_free (str_pipeline);
   _check_cond_err (g_app.pipeline != NULL);
 
+  /* throughput of the trainer, the data comes from the peer */
+  if (print_stats && !g_strcmp0 (stream_role, "receiver")) {
+    stats = training_stats_new (0, stdout);
+    training_stats_attach (stats, g_app.pipeline, "dataq", "trainer", "result_sink");
+  }
+
   /* bus and message callback */
   g_app.bus = gst_element_get_bus (g_app.pipeline);
   _check_cond_err (g_app.bus != NULL);
@@ -221,6 +239,11 @@ main (int argc, char **argv)
 
   gst_element_set_state (g_app.pipeline, GST_STATE_NULL);
 
+  if (stats) {
+    training_stats_print_summary (stats, stdout);
+    training_stats_free (stats);
+  }
+
 error:
   _print_log ("close app..");
   g_critical
@@ -0,0 +1,53 @@
+#!/usr/bin/env bash
+##
+## @file prefetch_bench.sh
+## @brief Compare the samples/sec of tensor_trainer with and without the prefetch stage.
+##
+## Each mode trains the same epochs with the same augmentation and normalization.
+##   direct   : datareposrc ! queue ! tensor_trainer (no augmentation)
+##   inline   : the samples are processed in the streaming thread (--prefetch=0)
+##   prefetch : K mini-batches are processed ahead by the workers (--prefetch=K)
+##
+## MNIST (res/mnist.*) is used, and YOLO if YOLO_DIR has yolo.data, yolo.json and yolov2.ini
+## (made by Tizen.native/yolo_model_training).
+##
+## usage: [YOLO_DIR=<dir>] ./prefetch_bench.sh [epochs] [K] [workers] [batch]
+##
+
+EPOCHS=${1:-10}
+DEPTH=${2:-2}
+WORKERS=${3:-$(nproc)}
+BATCH=${4:-16}
+BIN=${BIN:-./nnstreamer_example_training_checkpoint}
+WORK=$(mktemp -d /tmp/prefetch_bench.XXXXXX)
+
+trap 'rm -rf ${WORK}' EXIT
+
+# $1: dataset, $2: mode, $3: data options, $4: prefetch options
+run () {
+  ${BIN} $3 $4 --epochs=${EPOCHS} --checkpoint-interval=${EPOCHS} --no-resume \
+      --checkpoint-dir=${WORK}/$1-$2 > ${WORK}/$1-$2.log 2>/dev/null
+
+  PREFETCH=$(grep -A1 '^prefetch,' ${WORK}/$1-$2.log | tail -1)
+  echo "$1,$2,$(grep -A1 '^epochs,' ${WORK}/$1-$2.log | tail -1),${PREFETCH:-,,,,,,,,}"
+}
+
+# $1: dataset, $2: data options
+bench () {
+  AUG="--augment --prefetch-batch=${BATCH}"
+
+  run $1 direct "$2" ""
+  run $1 inline "$2" "--prefetch=0 ${AUG}"
+  run $1 prefetch "$2" "--prefetch=${DEPTH} --workers=${WORKERS} ${AUG}"
+}
+
+echo "dataset,mode,epochs,samples,train_ms,samples_per_sec,blocked_ms,blocked_pct,setup_ms,\
+prefetch,batch,workers,prefetch_samples,batches,process_ms,consumer_wait_ms,producer_wait_ms,push_ms"
+
+bench mnist "--filename=mnist.data --json=mnist.json --model-config=mnist.ini"
+
+if [ -n "${YOLO_DIR}" ] && [ -f ${YOLO_DIR}/yolo.data ]; then
+  bench yolo "--filename=${YOLO_DIR}/yolo.data --json=${YOLO_DIR}/yolo.json \
+      --model-config=${YOLO_DIR}/yolov2.ini --start-sample-index=0 --stop-sample-index=3 \
+      --num-training-sample=4 --num-validation-sample=4"
+fi
@@ -0,0 +1,518 @@
+/**
+ * @file	training_prefetch.c
+ * @date	19 October 2026
+ * @brief	Prefetch stage between datareposrc and tensor_trainer
+ * @author	Hyunil Park <hyunil46.park@samsung.com>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+#include <gst/app/app.h>
+#include "training_prefetch.h"
+
+/**
+ * @brief Range of the random brightness and contrast, and the amplitude of the noise.
+ */
+#define AUGMENT_BRIGHTNESS 0.1
+#define AUGMENT_CONTRAST 0.2
+#define AUGMENT_NOISE 0.04
+
+/**
+ * @brief Mini-batch of samples.
+ */
+typedef struct
+{
+  guint seq; /**< order of the batch */
+  GPtrArray *buffers;
+  gboolean ready; /**< processed by a worker */
+} PrefetchBatch;
+
+/**
+ * @brief Data structure for the prefetch stage.
+ */
+struct _TrainingPrefetch
+{
+  TrainingPrefetchOption option;
+  GstAppSink *in;
+  GstAppSrc *out;
+  GThread *reader;
+  GThread *pusher;
+  GThreadPool *pool;
+
+  GMutex lock;
+  GCond cond;
+  GQueue pending; /**< batches in order, being processed or ready */
+  gboolean eos; /**< the reader dispatched the last batch */
+  gboolean stopping;
+  gboolean transform; /**< the feature is float32 and there is something to do */
+  guint seq;
+
+  TrainingPrefetchStats stats;
+};
+
+/**
+ * @brief Set the default options.
+ */
+void
+training_prefetch_option_init (TrainingPrefetchOption * option)
+{
+  g_return_if_fail (option != NULL);
+
+  memset (option, 0, sizeof (TrainingPrefetchOption));
+  option->depth = 2;
+  option->batch = 16;
+  option->workers = 2;
+  option->scale = 1.0f;
+  option->offset = 0.0f;
+  option->seed = 1;
+}
+
+/**
+ * @brief Unref the buffer which is not pushed yet.
+ */
+static void
+_unref_buffer (gpointer data)
+{
+  if (data)
+    gst_buffer_unref (GST_BUFFER (data));
+}
+
+/**
+ * @brief Free the batch.
+ */
+static void
+_batch_free (gpointer data)
+{
+  PrefetchBatch *batch = (PrefetchBatch *) data;
+
+  g_ptr_array_free (batch->buffers, TRUE);
+  g_free (batch);
+}
+
+/**
+ * @brief Augment and normalize the feature of the sample.
+ */
+static GstBuffer *
+_process_sample (TrainingPrefetch * prefetch, GstBuffer * in, GRand * rand)
+{
+  GstBuffer *out;
+  GstMemory *mem, *new_mem;
+  GstMapInfo in_map, out_map;
+  gfloat *src, *dst;
+  gdouble contrast = 1.0, brightness = 0.0, v;
+  gsize i, n;
+  guint m;
+
+  if (!prefetch->transform)
+    return in;
+
+  out = gst_buffer_new ();
+  gst_buffer_copy_into (out, in, GST_BUFFER_COPY_METADATA, 0, -1);
+
+  if (prefetch->option.augment) {
+    contrast = 1.0 + (g_rand_double (rand) * 2.0 - 1.0) * AUGMENT_CONTRAST;
+    brightness = (g_rand_double (rand) * 2.0 - 1.0) * AUGMENT_BRIGHTNESS;
+  }
+
+  for (m = 0; m < gst_buffer_n_memory (in); m++) {
+    mem = gst_buffer_peek_memory (in, m);
+
+    /* label and the other tensors */
+    if (m > 0 || !gst_memory_map (mem, &in_map, GST_MAP_READ)) {
+      gst_buffer_append_memory (out, gst_memory_ref (mem));
+      continue;
+    }
+
+    new_mem = gst_allocator_alloc (NULL, in_map.size, NULL);
+    if (!gst_memory_map (new_mem, &out_map, GST_MAP_WRITE)) {
+      gst_memory_unmap (mem, &in_map);
+      gst_memory_unref (new_mem);
+      gst_buffer_append_memory (out, gst_memory_ref (mem));
+      continue;
+    }
+
+    src = (gfloat *) in_map.data;
+    dst = (gfloat *) out_map.data;
+    n = in_map.size / sizeof (gfloat);
+
+    for (i = 0; i < n; i++) {
+      v = src[i];
+      if (prefetch->option.augment)
+        v = v * contrast + brightness + (g_rand_double (rand) - 0.5) * AUGMENT_NOISE;
+      dst[i] = (gfloat) (v * prefetch->option.scale + prefetch->option.offset);
+    }
+
+    gst_memory_unmap (new_mem, &out_map);
+    gst_memory_unmap (mem, &in_map);
+    gst_buffer_append_memory (out, new_mem);
+  }
+
+  gst_buffer_unref (in);
+  return out;
+}
+
+/**
+ * @brief Process the samples of the batch.
+ */
+static void
+_process_batch (TrainingPrefetch * prefetch, PrefetchBatch * batch)
+{
+  GRand *rand;
+  guint i;
+
+  /* seeded by the order of the batch, so the samples do not depend on the workers */
+  rand = g_rand_new_with_seed (prefetch->option.seed + batch->seq);
+  for (i = 0; i < batch->buffers->len; i++)
+    batch->buffers->pdata[i] = _process_sample (prefetch,
+        GST_BUFFER (batch->buffers->pdata[i]), rand);
+  g_rand_free (rand);
+}
+
+/**
+ * @brief Worker thread, prepare a batch.
+ */
+static void
+_worker_func (gpointer data, gpointer user_data)
+{
+  TrainingPrefetch *prefetch = (TrainingPrefetch *) user_data;
+  PrefetchBatch *batch = (PrefetchBatch *) data;
+  gint64 start = g_get_monotonic_time ();
+
+  _process_batch (prefetch, batch);
+
+  g_mutex_lock (&prefetch->lock);
+  batch->ready = TRUE;
+  prefetch->stats.process_us += g_get_monotonic_time () - start;
+  g_cond_broadcast (&prefetch->cond);
+  g_mutex_unlock (&prefetch->lock);
+}
+
+/**
+ * @brief Push the samples of the batch to appsrc.
+ * @return FALSE if the pipeline is stopped
+ */
+static gboolean
+_push_batch (TrainingPrefetch * prefetch, PrefetchBatch * batch)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  gint64 start = g_get_monotonic_time ();
+  guint i;
+
+  for (i = 0; i < batch->buffers->len && ret == GST_FLOW_OK; i++) {
+    ret = gst_app_src_push_buffer (prefetch->out, GST_BUFFER (batch->buffers->pdata[i]));
+    batch->buffers->pdata[i] = NULL;
+  }
+
+  g_mutex_lock (&prefetch->lock);
+  prefetch->stats.push_us += g_get_monotonic_time () - start;
+  prefetch->stats.samples += i;
+  prefetch->stats.batches++;
+  g_mutex_unlock (&prefetch->lock);
+
+  return (ret == GST_FLOW_OK);
+}
+
+/**
+ * @brief Hand the batch to the workers, or process it inline.
+ */
+static gboolean
+_dispatch_batch (TrainingPrefetch * prefetch, PrefetchBatch * batch)
+{
+  gint64 start;
+  gboolean ret;
+
+  /* baseline, the samples are processed and pushed in the same thread */
+  if (prefetch->option.depth == 0) {
+    start = g_get_monotonic_time ();
+    _process_batch (prefetch, batch);
+
+    g_mutex_lock (&prefetch->lock);
+    prefetch->stats.process_us += g_get_monotonic_time () - start;
+    g_mutex_unlock (&prefetch->lock);
+
+    ret = _push_batch (prefetch, batch);
+    _batch_free (batch);
+    return ret;
+  }
+
+  g_mutex_lock (&prefetch->lock);
+  start = g_get_monotonic_time ();
+  while (!prefetch->stopping && prefetch->pending.length >= prefetch->option.depth)
+    g_cond_wait (&prefetch->cond, &prefetch->lock);
+  prefetch->stats.producer_wait_us += g_get_monotonic_time () - start;
+
+  if (prefetch->stopping) {
+    g_mutex_unlock (&prefetch->lock);
+    _batch_free (batch);
+    return FALSE;
+  }
+
+  g_queue_push_tail (&prefetch->pending, batch);
+  g_mutex_unlock (&prefetch->lock);
+
+  g_thread_pool_push (prefetch->pool, batch, NULL);
+  return TRUE;
+}
+
+/**
+ * @brief Check the type of the feature, only float32 is processed.
+ */
+static void
+_set_caps (TrainingPrefetch * prefetch, GstCaps * caps)
+{
+  GstStructure *s;
+  const gchar *types;
+
+  gst_app_src_set_caps (prefetch->out, caps);
+
+  s = gst_caps_get_structure (caps, 0);
+  types = s ? gst_structure_get_string (s, "types") : NULL;
+
+  prefetch->transform = (prefetch->option.augment || prefetch->option.scale != 1.0f ||
+      prefetch->option.offset != 0.0f);
+
+  if (prefetch->transform && (!types || !g_str_has_prefix (types, "float32"))) {
+    g_warning ("The feature is not float32 (%s), the samples are not processed.",
+        types ? types : "unknown");
+    prefetch->transform = FALSE;
+  }
+}
+
+/**
+ * @brief Reader thread, pull the samples and make the batches.
+ */
+static gpointer
+_reader_thread (gpointer user_data)
+{
+  TrainingPrefetch *prefetch = (TrainingPrefetch *) user_data;
+  PrefetchBatch *batch = NULL;
+  GstSample *sample;
+  gboolean caps_set = FALSE, ret = TRUE;
+
+  while (ret && (sample = gst_app_sink_pull_sample (prefetch->in)) != NULL) {
+    if (!caps_set) {
+      _set_caps (prefetch, gst_sample_get_caps (sample));
+      caps_set = TRUE;
+    }
+
+    if (!batch) {
+      batch = g_new0 (PrefetchBatch, 1);
+      batch->seq = prefetch->seq++;
+      batch->buffers = g_ptr_array_new_with_free_func (_unref_buffer);
+    }
+
+    g_ptr_array_add (batch->buffers, gst_buffer_ref (gst_sample_get_buffer (sample)));
+    gst_sample_unref (sample);
+
+    if (batch->buffers->len >= prefetch->option.batch) {
+      ret = _dispatch_batch (prefetch, batch);
+      batch = NULL;
+    }
+  }
+
+  if (ret && batch)
+    ret = _dispatch_batch (prefetch, batch);
+  else if (batch)
+    _batch_free (batch);
+
+  g_mutex_lock (&prefetch->lock);
+  prefetch->eos = TRUE;
+  g_cond_broadcast (&prefetch->cond);
+  g_mutex_unlock (&prefetch->lock);
+
+  if (ret && prefetch->option.depth == 0)
+    gst_app_src_end_of_stream (prefetch->out);
+
+  return NULL;
+}
+
+/**
+ * @brief Pusher thread, push the prepared batches in order.
+ */
+static gpointer
+_pusher_thread (gpointer user_data)
+{
+  TrainingPrefetch *prefetch = (TrainingPrefetch *) user_data;
+  PrefetchBatch *batch;
+  gint64 start;
+  gboolean ret = TRUE;
+
+  while (ret) {
+    g_mutex_lock (&prefetch->lock);
+    start = g_get_monotonic_time ();
+
+    while (!prefetch->stopping) {
+      batch = (PrefetchBatch *) g_queue_peek_head (&prefetch->pending);
+      if ((batch && batch->ready) || (!batch && prefetch->eos))
+        break;
+      g_cond_wait (&prefetch->cond, &prefetch->lock);
+    }
+
+    batch = prefetch->stopping ? NULL : (PrefetchBatch *) g_queue_pop_head (&prefetch->pending);
+    if (batch) {
+      prefetch->stats.consumer_wait_us += g_get_monotonic_time () - start;
+      /* a slot is free, the reader dispatches the next batch */
+      g_cond_broadcast (&prefetch->cond);
+    }
+    g_mutex_unlock (&prefetch->lock);
+
+    if (!batch)
+      break;
+
+    ret = _push_batch (prefetch, batch);
+    _batch_free (batch);
+  }
+
+  if (ret && !prefetch->stopping)
+    gst_app_src_end_of_stream (prefetch->out);
+
+  return NULL;
+}
+
+/**
+ * @brief Create the prefetch stage.
+ */
+TrainingPrefetch *
+training_prefetch_new (const TrainingPrefetchOption * option)
+{
+  TrainingPrefetch *prefetch;
+
+  g_return_val_if_fail (option != NULL, NULL);
+
+  prefetch = g_new0 (TrainingPrefetch, 1);
+  prefetch->option = *option;
+  prefetch->option.batch = MAX (prefetch->option.batch, 1U);
+  prefetch->option.workers = MAX (prefetch->option.workers, 1U);
+  g_mutex_init (&prefetch->lock);
+  g_cond_init (&prefetch->cond);
+  g_queue_init (&prefetch->pending);
+
+  return prefetch;
+}
+
+/**
+ * @brief Free the prefetch stage.
+ */
+void
+training_prefetch_free (TrainingPrefetch * prefetch)
+{
+  if (!prefetch)
+    return;
+
+  training_prefetch_stop (prefetch);
+  g_mutex_clear (&prefetch->lock);
+  g_cond_clear (&prefetch->cond);
+  g_free (prefetch);
+}
+
+/**
+ * @brief Start the threads for the pipeline.
+ */
+gboolean
+training_prefetch_start (TrainingPrefetch * prefetch, GstElement * pipeline,
+    const gchar * appsink_name, const gchar * appsrc_name)
+{
+  GstElement *in, *out;
+
+  g_return_val_if_fail (prefetch != NULL, FALSE);
+  g_return_val_if_fail (pipeline != NULL, FALSE);
+  g_return_val_if_fail (prefetch->reader == NULL, FALSE);
+
+  in = gst_bin_get_by_name (GST_BIN (pipeline), appsink_name);
+  out = gst_bin_get_by_name (GST_BIN (pipeline), appsrc_name);
+  if (!in || !out) {
+    if (in)
+      gst_object_unref (in);
+    if (out)
+      gst_object_unref (out);
+    return FALSE;
+  }
+
+  /* datareposrc does not read ahead of the batches */
+  g_object_set (in, "sync", FALSE, "max-buffers", prefetch->option.batch, NULL);
+  g_object_set (out, "format", GST_FORMAT_TIME, "block", TRUE, NULL);
+
+  prefetch->in = GST_APP_SINK (in);
+  prefetch->out = GST_APP_SRC (out);
+  prefetch->eos = FALSE;
+  prefetch->stopping = FALSE;
+
+  if (prefetch->option.depth > 0) {
+    prefetch->pool = g_thread_pool_new (_worker_func, prefetch,
+        (gint) prefetch->option.workers, TRUE, NULL);
+    prefetch->pusher = g_thread_new ("prefetch_push", _pusher_thread, prefetch);
+  }
+  prefetch->reader = g_thread_new ("prefetch_read", _reader_thread, prefetch);
+
+  return TRUE;
+}
+
+/**
+ * @brief Stop the threads.
+ */
+void
+training_prefetch_stop (TrainingPrefetch * prefetch)
+{
+  g_return_if_fail (prefetch != NULL);
+
+  if (!prefetch->reader)
+    return;
+
+  g_mutex_lock (&prefetch->lock);
+  prefetch->stopping = TRUE;
+  g_cond_broadcast (&prefetch->cond);
+  g_mutex_unlock (&prefetch->lock);
+
+  /* appsink and appsrc do not block after EOS or in NULL state */
+  g_thread_join (prefetch->reader);
+  prefetch->reader = NULL;
+
+  if (prefetch->pool) {
+    g_thread_pool_free (prefetch->pool, FALSE, TRUE);
+    prefetch->pool = NULL;
+  }
+
+  if (prefetch->pusher) {
+    g_thread_join (prefetch->pusher);
+    prefetch->pusher = NULL;
+  }
+
+  g_queue_clear_full (&prefetch->pending, _batch_free);
+  gst_object_unref (prefetch->in);
+  gst_object_unref (prefetch->out);
+  prefetch->in = NULL;
+  prefetch->out = NULL;
+}
+
+/**
+ * @brief Get the counters of all pipelines.
+ */
+void
+training_prefetch_get_stats (TrainingPrefetch * prefetch, TrainingPrefetchStats * stats)
+{
+  g_return_if_fail (prefetch != NULL);
+  g_return_if_fail (stats != NULL);
+
+  g_mutex_lock (&prefetch->lock);
+  *stats = prefetch->stats;
+  g_mutex_unlock (&prefetch->lock);
+}
+
+/**
+ * @brief Print the counters (CSV).
+ */
+void
+training_prefetch_print_stats (TrainingPrefetch * prefetch, FILE * out)
+{
+  TrainingPrefetchStats stats;
+
+  training_prefetch_get_stats (prefetch, &stats);
+
+  fprintf (out, "prefetch,batch,workers,samples,batches,process_ms,consumer_wait_ms,"
+      "producer_wait_ms,push_ms\n");
+  fprintf (out, "%u,%u,%u,%" G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT ",%.1f,%.1f,%.1f,%.1f\n",
+      prefetch->option.depth, prefetch->option.batch,
+      prefetch->option.depth > 0 ? prefetch->option.workers : 0, stats.samples, stats.batches,
+      stats.process_us / 1000.0, stats.consumer_wait_us / 1000.0,
+      stats.producer_wait_us / 1000.0, stats.push_us / 1000.0);
+}
@@ -0,0 +1,90 @@
+/**
+ * @file	training_prefetch.h
+ * @date	19 October 2026
+ * @brief	Prefetch stage between datareposrc and tensor_trainer
+ * @author	Hyunil Park <hyunil46.park@samsung.com>
+ * @bug		No known bugs.
+ *
+ * The samples from appsink (after datareposrc) are grouped into mini-batches, and worker
+ * threads augment and normalize the next K batches while tensor_trainer consumes the current
+ * one. The batches are pushed to appsrc (in front of tensor_trainer) in the original order.
+ * The first tensor of a sample (feature) is processed if it is float32, the others are passed as is.
+ */
+#ifndef __TRAINING_PREFETCH_H__
+#define __TRAINING_PREFETCH_H__
+
+#include <stdio.h>
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _TrainingPrefetch TrainingPrefetch;
+
+/**
+ * @brief Options of the prefetch stage.
+ */
+typedef struct
+{
+  guint depth; /**< the number of batches prepared ahead (K), 0 to process the samples inline */
+  guint batch; /**< the number of samples in a batch */
+  guint workers; /**< the number of worker threads */
+  gboolean augment; /**< random brightness, contrast and noise */
+  gfloat scale; /**< normalization, x * scale + offset */
+  gfloat offset;
+  guint32 seed; /**< seed of the augmentation, the same for all modes */
+} TrainingPrefetchOption;
+
+/**
+ * @brief Counters of the prefetch stage.
+ */
+typedef struct
+{
+  guint64 samples;
+  guint64 batches;
+  gint64 process_us; /**< time to augment and normalize the samples */
+  gint64 consumer_wait_us; /**< the trainer side waited for a prepared batch */
+  gint64 producer_wait_us; /**< K batches were prepared, waited for the trainer */
+  gint64 push_us; /**< blocked in appsrc, the trainer was busy */
+} TrainingPrefetchStats;
+
+/**
+ * @brief Set the default options.
+ */
+void training_prefetch_option_init (TrainingPrefetchOption * option);
+
+/**
+ * @brief Create the prefetch stage.
+ */
+TrainingPrefetch *training_prefetch_new (const TrainingPrefetchOption * option);
+
+/**
+ * @brief Free the prefetch stage.
+ */
+void training_prefetch_free (TrainingPrefetch * prefetch);
+
+/**
+ * @brief Start the threads for the pipeline, before the pipeline starts.
+ * The stage can be started again for the next pipeline after training_prefetch_stop().
+ */
+gboolean training_prefetch_start (TrainingPrefetch * prefetch, GstElement * pipeline,
+    const gchar * appsink_name, const gchar * appsrc_name);
+
+/**
+ * @brief Stop the threads, after EOS or after the pipeline is stopped.
+ */
+void training_prefetch_stop (TrainingPrefetch * prefetch);
+
+/**
+ * @brief Get the counters of all pipelines.
+ */
+void training_prefetch_get_stats (TrainingPrefetch * prefetch, TrainingPrefetchStats * stats);
+
+/**
+ * @brief Print the counters (CSV).
+ */
+void training_prefetch_print_stats (TrainingPrefetch * prefetch, FILE * out);
+
+G_END_DECLS
+
+#endif /* __TRAINING_PREFETCH_H__ */
@@ -0,0 +1,264 @@
+/**
+ * @file	training_stats.c
+ * @date	19 October 2026
+ * @brief	Throughput statistics of tensor_trainer
+ * @author	Hyunil Park <hyunil46.park@samsung.com>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+#include "training_stats.h"
+
+/**
+ * @brief The number of values tensor_trainer pushes at the end of each epoch.
+ */
+#define NUM_RESULTS 4
+
+/**
+ * @brief Data structure for the statistics.
+ */
+struct _TrainingStats
+{
+  GMutex lock;
+  FILE *out; /**< stream of the epoch rows */
+  gboolean header; /**< header of the epoch rows is printed */
+  guint first_epoch;
+  guint epoch; /**< the number of finished epochs */
+
+  gint64 attach_time; /**< time the pipeline is attached */
+  gint64 epoch_start; /**< start of the epoch, 0 until the first sample of the pipeline */
+  gint64 underrun_time; /**< time the queue became empty, 0 if not empty */
+
+  guint64 samples;
+  guint64 epoch_samples;
+  gint64 train_us; /**< sum of the epoch times */
+  gint64 blocked_us; /**< trainer waited for data */
+  gint64 epoch_blocked_us;
+  gint64 setup_us; /**< from the start of each pipeline to its first sample */
+};
+
+/**
+ * @brief Create the statistics.
+ */
+TrainingStats *
+training_stats_new (guint first_epoch, FILE * out)
+{
+  TrainingStats *stats = g_new0 (TrainingStats, 1);
+
+  g_mutex_init (&stats->lock);
+  stats->out = out;
+  stats->first_epoch = first_epoch;
+  stats->epoch = first_epoch;
+
+  return stats;
+}
+
+/**
+ * @brief Free the statistics.
+ */
+void
+training_stats_free (TrainingStats * stats)
+{
+  if (!stats)
+    return;
+
+  g_mutex_clear (&stats->lock);
+  g_free (stats);
+}
+
+/**
+ * @brief Add the time the queue was empty until now.
+ */
+static void
+_add_blocked_time (TrainingStats * stats, gint64 now)
+{
+  if (stats->underrun_time > 0) {
+    stats->blocked_us += now - stats->underrun_time;
+    stats->epoch_blocked_us += now - stats->underrun_time;
+    stats->underrun_time = 0;
+  }
+}
+
+/**
+ * @brief Callback for queue signal, the trainer has no data.
+ */
+static void
+_underrun_cb (GstElement * queue, gpointer user_data)
+{
+  TrainingStats *stats = (TrainingStats *) user_data;
+
+  g_mutex_lock (&stats->lock);
+  /* the queue is empty before the first sample while the pipeline starts */
+  if (stats->epoch_start > 0)
+    stats->underrun_time = g_get_monotonic_time ();
+  g_mutex_unlock (&stats->lock);
+}
+
+/**
+ * @brief Callback for queue signal, the data arrived.
+ */
+static void
+_running_cb (GstElement * queue, gpointer user_data)
+{
+  TrainingStats *stats = (TrainingStats *) user_data;
+
+  g_mutex_lock (&stats->lock);
+  _add_blocked_time (stats, g_get_monotonic_time ());
+  g_mutex_unlock (&stats->lock);
+}
+
+/**
+ * @brief Pad probe of tensor_trainer, count the samples.
+ */
+static GstPadProbeReturn
+_sample_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  TrainingStats *stats = (TrainingStats *) user_data;
+  gint64 now = g_get_monotonic_time ();
+
+  g_mutex_lock (&stats->lock);
+  if (stats->epoch_start == 0) {
+    stats->epoch_start = now;
+    stats->setup_us += now - stats->attach_time;
+  }
+  stats->samples++;
+  stats->epoch_samples++;
+  g_mutex_unlock (&stats->lock);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Callback for tensor_sink signal, the result of an epoch.
+ */
+static void
+_epoch_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  TrainingStats *stats = (TrainingStats *) user_data;
+  gdouble result[NUM_RESULTS] = { 0, };
+  GstMemory *mem;
+  GstMapInfo map;
+  gint64 now, epoch_us;
+
+  mem = gst_buffer_peek_memory (buffer, 0);
+  if (mem && gst_memory_map (mem, &map, GST_MAP_READ)) {
+    memcpy (result, map.data, MIN (map.size, sizeof (result)));
+    gst_memory_unmap (mem, &map);
+  }
+
+  g_mutex_lock (&stats->lock);
+  now = g_get_monotonic_time ();
+  if (stats->underrun_time > 0) {
+    _add_blocked_time (stats, now);
+    stats->underrun_time = now;
+  }
+
+  epoch_us = (stats->epoch_start > 0) ? now - stats->epoch_start : 0;
+  stats->epoch++;
+  stats->train_us += epoch_us;
+
+  if (stats->out) {
+    if (!stats->header) {
+      fprintf (stats->out, "epoch,epoch_ms,samples,samples_per_sec,blocked_ms,blocked_pct,"
+          "training_loss,training_accuracy,validation_loss,validation_accuracy\n");
+      stats->header = TRUE;
+    }
+
+    fprintf (stats->out, "%u,%.1f,%" G_GUINT64_FORMAT ",%.1f,%.1f,%.1f,%f,%f,%f,%f\n",
+        stats->epoch, epoch_us / 1000.0, stats->epoch_samples,
+        epoch_us > 0 ? stats->epoch_samples * (gdouble) G_USEC_PER_SEC / epoch_us : 0.0,
+        stats->epoch_blocked_us / 1000.0,
+        epoch_us > 0 ? 100.0 * stats->epoch_blocked_us / epoch_us : 0.0,
+        result[0], result[1], result[2], result[3]);
+    fflush (stats->out);
+  }
+
+  stats->epoch_start = now;
+  stats->epoch_samples = 0;
+  stats->epoch_blocked_us = 0;
+  g_mutex_unlock (&stats->lock);
+}
+
+/**
+ * @brief Attach the statistics to the elements of the pipeline.
+ */
+gboolean
+training_stats_attach (TrainingStats * stats, GstElement * pipeline,
+    const gchar * queue_name, const gchar * trainer_name, const gchar * sink_name)
+{
+  GstElement *queue, *trainer, *sink;
+  GstPad *pad = NULL;
+  gboolean ret = FALSE;
+
+  g_return_val_if_fail (stats != NULL, FALSE);
+  g_return_val_if_fail (pipeline != NULL, FALSE);
+
+  queue = gst_bin_get_by_name (GST_BIN (pipeline), queue_name);
+  trainer = gst_bin_get_by_name (GST_BIN (pipeline), trainer_name);
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), sink_name);
+  if (trainer)
+    pad = gst_element_get_static_pad (trainer, "sink");
+
+  if (queue && pad && sink) {
+    g_mutex_lock (&stats->lock);
+    stats->attach_time = g_get_monotonic_time ();
+    stats->epoch_start = 0;
+    stats->underrun_time = 0;
+    stats->epoch_samples = 0;
+    stats->epoch_blocked_us = 0;
+    g_mutex_unlock (&stats->lock);
+
+    g_signal_connect (queue, "underrun", G_CALLBACK (_underrun_cb), stats);
+    g_signal_connect (queue, "running", G_CALLBACK (_running_cb), stats);
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, _sample_probe_cb, stats, NULL);
+    g_signal_connect (sink, "new-data", G_CALLBACK (_epoch_cb), stats);
+    ret = TRUE;
+  }
+
+  if (pad)
+    gst_object_unref (pad);
+  if (queue)
+    gst_object_unref (queue);
+  if (trainer)
+    gst_object_unref (trainer);
+  if (sink)
+    gst_object_unref (sink);
+
+  return ret;
+}
+
+/**
+ * @brief Get the number of finished epochs, including first_epoch.
+ */
+guint
+training_stats_get_epochs (TrainingStats * stats)
+{
+  guint epoch;
+
+  g_return_val_if_fail (stats != NULL, 0);
+
+  g_mutex_lock (&stats->lock);
+  epoch = stats->epoch;
+  g_mutex_unlock (&stats->lock);
+
+  return epoch;
+}
+
+/**
+ * @brief Print the summary (CSV) of all epochs.
+ */
+void
+training_stats_print_summary (TrainingStats * stats, FILE * out)
+{
+  g_return_if_fail (stats != NULL);
+
+  g_mutex_lock (&stats->lock);
+  fprintf (out, "epochs,samples,train_ms,samples_per_sec,blocked_ms,blocked_pct,setup_ms\n");
+  fprintf (out, "%u,%" G_GUINT64_FORMAT ",%.1f,%.1f,%.1f,%.1f,%.1f\n",
+      stats->epoch - stats->first_epoch, stats->samples, stats->train_us / 1000.0,
+      stats->train_us > 0 ? stats->samples * (gdouble) G_USEC_PER_SEC / stats->train_us : 0.0,
+      stats->blocked_us / 1000.0,
+      stats->train_us > 0 ? 100.0 * stats->blocked_us / stats->train_us : 0.0,
+      stats->setup_us / 1000.0);
+  g_mutex_unlock (&stats->lock);
+}
@@ -0,0 +1,56 @@
+/**
+ * @file	training_stats.h
+ * @date	19 October 2026
+ * @brief	Throughput statistics of tensor_trainer
+ * @author	Hyunil Park <hyunil46.park@samsung.com>
+ * @bug		No known bugs.
+ *
+ * Counts the samples pushed to tensor_trainer, the time the trainer waits for data
+ * (the queue in front of it is empty), and the time of each epoch (tensor_trainer
+ * pushes the loss and accuracy to the sink at the end of each epoch).
+ */
+#ifndef __TRAINING_STATS_H__
+#define __TRAINING_STATS_H__
+
+#include <stdio.h>
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _TrainingStats TrainingStats;
+
+/**
+ * @brief Create the statistics. Epochs are numbered from first_epoch + 1.
+ * @param out stream of the epoch rows (CSV), NULL to disable
+ */
+TrainingStats *training_stats_new (guint first_epoch, FILE * out);
+
+/**
+ * @brief Free the statistics.
+ */
+void training_stats_free (TrainingStats * stats);
+
+/**
+ * @brief Attach the statistics to the elements of the pipeline.
+ * It can be attached to the pipeline of each training segment in turn.
+ * @param queue_name queue in front of tensor_trainer
+ * @param trainer_name tensor_trainer
+ * @param sink_name tensor_sink of the training result
+ */
+gboolean training_stats_attach (TrainingStats * stats, GstElement * pipeline,
+    const gchar * queue_name, const gchar * trainer_name, const gchar * sink_name);
+
+/**
+ * @brief Get the number of finished epochs, including first_epoch.
+ */
+guint training_stats_get_epochs (TrainingStats * stats);
+
+/**
+ * @brief Print the summary (CSV) of all epochs.
+ */
+void training_stats_print_summary (TrainingStats * stats, FILE * out);
+
+G_END_DECLS
+
+#endif /* __TRAINING_STATS_H__ */
@@ -0,0 +1,851 @@
+/**
+ * @file	nnstreamer_example_video_crop_cascade_tflite.cc
+ * @date	19 October 2026
+ * @brief	Two-stage cascade, classify all detected regions of a frame in one batch
+ * @author	Harsh Jain <hjain24in@gmail.com>
+ * @bug		No known bugs.
+ *
+ * Stage 1 detects objects (ssd_mobilenet_v2_coco) and tensor_decoder::tensor_region
+ * gives the regions of top N objects. The raw frame and the regions are muxed into
+ * one buffer, so that the cascade stage gets all regions of the same frame at once.
+ *
+ * Stage 2 (cascade) crops and resizes all regions into a single batched tensor
+ * [3:224:224:N] in one pass, and runs the classifier (mobilenet_v1) once per frame.
+ * The results are attached back to the regions of the frame.
+ * With --mode=single, each region is pushed as a buffer (batch 1) for comparison.
+ * mobilenet_v1_1.0_224_quant.tflite has a fixed batch of 1, the batch mode needs the classifier
+ * exported with a batch of --max-regions (--cls-model), the run stops if the result is not a batch.
+ *
+ * Get model by
+ * $ cd $NNST_ROOT/bin
+ * $ bash get-model.sh object-detection-tflite
+ * $ bash get-model.sh image-classification-tflite
+ *
+ * Run example :
+ * Before running this example, GST_PLUGIN_PATH should be updated for nnstreamer plug-in.
+ * $ export GST_PLUGIN_PATH=$GST_PLUGIN_PATH:<nnstreamer plugin path>
+ * $ ./nnstreamer_example_video_crop_cascade_tflite --src=file:video.mp4 --max-regions=8 --cls-model=./mobilenet_v1_batch8.tflite
+ * $ ./nnstreamer_example_video_crop_cascade_tflite --src=file:video.mp4 --max-regions=8 --mode=single
+ *
+ * It prints per-frame latency of the cascade stage (CSV) by the number of regions.
+ */
+
+#include <glib.h>
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) \
+  if (DBG)              \
+  g_message (__VA_ARGS__)
+
+/**
+ * @brief Macro to check error case.
+ */
+#define _check_cond_err(cond)                           \
+  do {                                                  \
+    if (!(cond)) {                                      \
+      _print_log ("app failed! [line : %d]", __LINE__); \
+      goto error;                                       \
+    }                                                   \
+  } while (0)
+
+#define FRAME_WIDTH 640
+#define FRAME_HEIGHT 480
+#define DETECT_SIZE 300
+#define CLS_SIZE 224
+#define CLS_BYTES (CLS_SIZE * CLS_SIZE * 3)
+#define MAX_REGIONS 32
+
+/**
+ * @brief Region of a detected object, in the frame coordinates.
+ */
+typedef struct {
+  guint x;
+  guint y;
+  guint w;
+  guint h;
+} Region;
+
+/**
+ * @brief Regions of a frame and the classification results.
+ */
+typedef struct {
+  gint64 start; /**< time when the regions of the frame arrived */
+  gint64 packed; /**< time when the last region is packed */
+  guint num; /**< number of regions */
+  guint pending; /**< number of classifier results to wait */
+  Region regions[MAX_REGIONS]; /**< detected regions */
+  guint label[MAX_REGIONS]; /**< classified label index of each region */
+  guint8 score[MAX_REGIONS]; /**< score of the label */
+} CascadeJob;
+
+/**
+ * @brief Data structure for app.
+ */
+typedef struct {
+  GMainLoop *loop; /**< main event loop */
+  GstElement *pipeline; /**< gst pipeline for detection */
+  GstElement *cls_pipeline; /**< gst pipeline for classification */
+  GstElement *cls_src; /**< appsrc to push the batched regions */
+  GstBus *bus; /**< gst bus for detection pipeline */
+  GstBus *cls_bus; /**< gst bus for classification pipeline */
+  gboolean running; /**< true when app is running */
+
+  gchar *det_model; /**< detection model file path */
+  gchar *det_label; /**< detection label file path */
+  gchar *det_box_priors; /**< box prior file path */
+  gchar *cls_model; /**< classification model file path */
+  gchar **cls_labels; /**< classification labels */
+  guint cls_total_labels; /**< count of classification labels */
+  gint invalid; /**< set when the classifier result is not a batch of the regions */
+
+  gboolean batched; /**< classify all regions of a frame at once */
+  guint max_regions; /**< max regions per frame */
+  guint max_frames; /**< stop after this number of frames (0 for no limit) */
+  guint frames; /**< number of processed frames */
+
+  GAsyncQueue *jobs; /**< frames pushed to the classifier, in order */
+  GMutex lock; /**< lock for the current job and the results, updated by both pipelines */
+  CascadeJob *current; /**< frame waiting for more results (single mode) */
+  GArray *latency[MAX_REGIONS + 1]; /**< cascade latency (usec) by number of regions */
+  GArray *pack[MAX_REGIONS + 1]; /**< crop and resize time (usec) by number of regions */
+} AppData;
+
+/**
+ * @brief Data for pipeline and result.
+ */
+static AppData g_app;
+
+/**
+ * @brief Compare function to sort latency.
+ */
+static gint
+_compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 la = *((const gint64 *) a);
+  gint64 lb = *((const gint64 *) b);
+
+  return (la > lb) ? 1 : ((la < lb) ? -1 : 0);
+}
+
+/**
+ * @brief Get the percentile from the sorted latency array.
+ */
+static gint64
+_percentile (GArray *sorted, gdouble p)
+{
+  guint idx;
+
+  if (sorted->len == 0)
+    return 0;
+
+  idx = (guint) (p / 100.0 * (sorted->len - 1) + 0.5);
+  return g_array_index (sorted, gint64, MIN (idx, sorted->len - 1));
+}
+
+/**
+ * @brief Check the model files and load classification labels.
+ * @param cls_file classification model file, NULL for the model in cls_path
+ */
+static gboolean
+init_model_info (const gchar *det_path, const gchar *cls_path, const gchar *cls_file)
+{
+  gchar *label_path;
+  gchar *contents = NULL;
+
+  g_app.det_model = g_strdup_printf ("%s/%s", det_path, "ssd_mobilenet_v2_coco.tflite");
+  g_app.det_label = g_strdup_printf ("%s/%s", det_path, "coco_labels_list.txt");
+  g_app.det_box_priors = g_strdup_printf ("%s/%s", det_path, "box_priors.txt");
+  if (cls_file)
+    g_app.cls_model = g_strdup (cls_file);
+  else
+    g_app.cls_model = g_strdup_printf ("%s/%s", cls_path, "mobilenet_v1_1.0_224_quant.tflite");
+
+  if (!g_file_test (g_app.det_model, G_FILE_TEST_IS_REGULAR)) {
+    g_critical ("cannot find tflite model [%s]", g_app.det_model);
+    return FALSE;
+  }
+  if (!g_file_test (g_app.det_label, G_FILE_TEST_IS_REGULAR)) {
+    g_critical ("cannot find tflite label [%s]", g_app.det_label);
+    return FALSE;
+  }
+  if (!g_file_test (g_app.det_box_priors, G_FILE_TEST_IS_REGULAR)) {
+    g_critical ("cannot find tflite box_prior [%s]", g_app.det_box_priors);
+    return FALSE;
+  }
+  if (!g_file_test (g_app.cls_model, G_FILE_TEST_IS_REGULAR)) {
+    g_critical ("cannot find tflite model [%s]", g_app.cls_model);
+    return FALSE;
+  }
+
+  label_path = g_strdup_printf ("%s/%s", cls_path, "labels.txt");
+  if (!g_file_get_contents (label_path, &contents, NULL, NULL)) {
+    g_critical ("cannot find tflite label [%s]", label_path);
+    g_free (label_path);
+    return FALSE;
+  }
+
+  g_app.cls_labels = g_strsplit (contents, "\n", -1);
+  g_app.cls_total_labels = g_strv_length (g_app.cls_labels);
+  /* the last line ends with a newline */
+  while (g_app.cls_total_labels > 0 && g_app.cls_labels[g_app.cls_total_labels - 1][0] == '\0')
+    g_app.cls_total_labels--;
+  g_free (contents);
+  g_free (label_path);
+  return TRUE;
+}
+
+/**
+ * @brief Free resources in app data.
+ */
+static void
+free_app_data (void)
+{
+  CascadeJob *job;
+  guint i;
+
+  if (g_app.loop) {
+    g_main_loop_unref (g_app.loop);
+    g_app.loop = NULL;
+  }
+
+  if (g_app.bus) {
+    gst_bus_remove_signal_watch (g_app.bus);
+    gst_object_unref (g_app.bus);
+    g_app.bus = NULL;
+  }
+
+  if (g_app.cls_bus) {
+    gst_bus_remove_signal_watch (g_app.cls_bus);
+    gst_object_unref (g_app.cls_bus);
+    g_app.cls_bus = NULL;
+  }
+
+  if (g_app.cls_src) {
+    gst_object_unref (g_app.cls_src);
+    g_app.cls_src = NULL;
+  }
+
+  if (g_app.pipeline) {
+    gst_object_unref (g_app.pipeline);
+    g_app.pipeline = NULL;
+  }
+
+  if (g_app.cls_pipeline) {
+    gst_object_unref (g_app.cls_pipeline);
+    g_app.cls_pipeline = NULL;
+  }
+
+  if (g_app.jobs) {
+    while ((job = (CascadeJob *) g_async_queue_try_pop (g_app.jobs)) != NULL)
+      g_free (job);
+    g_async_queue_unref (g_app.jobs);
+    g_app.jobs = NULL;
+    g_mutex_clear (&g_app.lock);
+  }
+
+  g_free (g_app.current);
+  g_app.current = NULL;
+
+  for (i = 0; i <= MAX_REGIONS; i++) {
+    if (g_app.latency[i])
+      g_array_free (g_app.latency[i], TRUE);
+    if (g_app.pack[i])
+      g_array_free (g_app.pack[i], TRUE);
+    g_app.latency[i] = g_app.pack[i] = NULL;
+  }
+
+  g_free (g_app.det_model);
+  g_free (g_app.det_label);
+  g_free (g_app.det_box_priors);
+  g_free (g_app.cls_model);
+  g_strfreev (g_app.cls_labels);
+  g_app.det_model = g_app.det_label = g_app.det_box_priors = g_app.cls_model = NULL;
+  g_app.cls_labels = NULL;
+}
+
+/**
+ * @brief Function to print error message.
+ */
+static void
+_parse_err_message (GstMessage *message)
+{
+  gchar *debug;
+  GError *error;
+
+  g_return_if_fail (message != NULL);
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_ERROR:
+      gst_message_parse_error (message, &error, &debug);
+      break;
+
+    case GST_MESSAGE_WARNING:
+      gst_message_parse_warning (message, &error, &debug);
+      break;
+
+    default:
+      return;
+  }
+
+  gst_object_default_error (GST_MESSAGE_SRC (message), error, debug);
+  g_error_free (error);
+  g_free (debug);
+}
+
+/**
+ * @brief Callback for message.
+ */
+static void
+bus_message_cb (GstBus *bus, GstMessage *message, gpointer user_data)
+{
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_EOS:
+      _print_log ("Received EOS message");
+      g_main_loop_quit (g_app.loop);
+      break;
+
+    case GST_MESSAGE_ERROR:
+      _print_log ("Received error message");
+      _parse_err_message (message);
+      g_main_loop_quit (g_app.loop);
+      break;
+
+    case GST_MESSAGE_WARNING:
+      _print_log ("Received warning message");
+      _parse_err_message (message);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Crop the region and resize it to the classifier input (nearest), RGB.
+ */
+static void
+crop_resize (const guint8 *frame, const Region *region, guint8 *dst)
+{
+  guint x_offset[CLS_SIZE];
+  const guint8 *row;
+  guint x, y;
+
+  for (x = 0; x < CLS_SIZE; x++)
+    x_offset[x] = (region->x + (x * region->w) / CLS_SIZE) * 3;
+
+  for (y = 0; y < CLS_SIZE; y++) {
+    row = frame + (region->y + (y * region->h) / CLS_SIZE) * FRAME_WIDTH * 3;
+
+    for (x = 0; x < CLS_SIZE; x++) {
+      dst[0] = row[x_offset[x]];
+      dst[1] = row[x_offset[x] + 1];
+      dst[2] = row[x_offset[x] + 2];
+      dst += 3;
+    }
+  }
+}
+
+/**
+ * @brief Get the regions from tensor_region, scaled to the frame coordinates.
+ * @return the number of valid regions
+ */
+static guint
+get_regions (const guint32 *info, gsize size, Region *regions)
+{
+  guint num, n, i;
+  guint x, y, w, h;
+
+  /* tensor_region gives [4:N] uint32, x, y, width and height in the model input scale */
+  num = MIN ((guint) (size / (4 * sizeof (guint32))), g_app.max_regions);
+
+  for (i = 0, n = 0; i < num; i++, info += 4) {
+    x = info[0] * FRAME_WIDTH / DETECT_SIZE;
+    y = info[1] * FRAME_HEIGHT / DETECT_SIZE;
+    w = info[2] * FRAME_WIDTH / DETECT_SIZE;
+    h = info[3] * FRAME_HEIGHT / DETECT_SIZE;
+
+    if (x >= FRAME_WIDTH || y >= FRAME_HEIGHT)
+      continue;
+
+    w = MIN (w, FRAME_WIDTH - x);
+    h = MIN (h, FRAME_HEIGHT - y);
+    if (w == 0 || h == 0)
+      continue;
+
+    regions[n].x = x;
+    regions[n].y = y;
+    regions[n].w = w;
+    regions[n].h = h;
+    n++;
+  }
+
+  return n;
+}
+
+/**
+ * @brief Push the batch of cropped regions to the classifier.
+ */
+static void
+push_regions (CascadeJob *job, const guint8 *frame, guint first, guint count, guint batch)
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+  guint i;
+
+  buffer = gst_buffer_new_allocate (NULL, batch * CLS_BYTES, NULL);
+  if (!gst_buffer_map (buffer, &map, GST_MAP_WRITE)) {
+    gst_buffer_unref (buffer);
+    return;
+  }
+
+  for (i = 0; i < count; i++)
+    crop_resize (frame, &job->regions[first + i], map.data + i * CLS_BYTES);
+
+  gst_buffer_unmap (buffer, &map);
+
+  /* clear unused slots of the batch, the results are ignored */
+  if (count < batch)
+    gst_buffer_memset (buffer, count * CLS_BYTES, 0, (batch - count) * CLS_BYTES);
+
+  /* the job may be done and freed once the last region is pushed */
+  if (first + count == job->num)
+    job->packed = g_get_monotonic_time ();
+
+  gst_app_src_push_buffer (GST_APP_SRC (g_app.cls_src), buffer);
+}
+
+/**
+ * @brief Record the latency of the frame, called with the lock.
+ */
+static void
+record_job (CascadeJob *job)
+{
+  gint64 now = g_get_monotonic_time ();
+  gint64 latency = now - job->start;
+  gint64 pack = job->packed - job->start;
+  guint i;
+
+  g_array_append_val (g_app.latency[job->num], latency);
+  g_array_append_val (g_app.pack[job->num], pack);
+
+  for (i = 0; i < job->num; i++) {
+    _print_log ("frame %u region %u (%u,%u,%u,%u) : %s (%u)", g_app.frames, i,
+        job->regions[i].x, job->regions[i].y, job->regions[i].w,
+        job->regions[i].h,
+        (job->label[i] < g_app.cls_total_labels) ? g_app.cls_labels[job->label[i]] : "",
+        job->score[i]);
+  }
+
+  g_app.frames++;
+  if (g_app.max_frames > 0 && g_app.frames == g_app.max_frames)
+    g_main_loop_quit (g_app.loop);
+
+  g_free (job);
+}
+
+/**
+ * @brief Callback for tensor sink signal, the frame and its regions.
+ */
+static void
+regions_cb (GstElement *element, GstBuffer *buffer, gpointer user_data)
+{
+  GstMemory *mem_frame, *mem_regions;
+  GstMapInfo info_frame, info_regions;
+  CascadeJob *job;
+  guint num, i;
+
+  if (!g_app.running)
+    return;
+
+  /**
+   * [0] raw frame, uint8 3:640:480:1
+   * [1] regions, uint32 4:N
+   */
+  g_return_if_fail (gst_buffer_n_memory (buffer) == 2);
+
+  job = g_new0 (CascadeJob, 1);
+  job->start = g_get_monotonic_time ();
+
+  mem_frame = gst_buffer_peek_memory (buffer, 0);
+  mem_regions = gst_buffer_peek_memory (buffer, 1);
+  if (!gst_memory_map (mem_regions, &info_regions, GST_MAP_READ)) {
+    g_free (job);
+    return;
+  }
+
+  job->num = get_regions ((const guint32 *) info_regions.data, info_regions.size, job->regions);
+  gst_memory_unmap (mem_regions, &info_regions);
+
+  if (job->num == 0) {
+    job->packed = job->start;
+    g_mutex_lock (&g_app.lock);
+    record_job (job);
+    g_mutex_unlock (&g_app.lock);
+    return;
+  }
+
+  if (!gst_memory_map (mem_frame, &info_frame, GST_MAP_READ)) {
+    g_free (job);
+    return;
+  }
+
+  if (info_frame.size != FRAME_WIDTH * FRAME_HEIGHT * 3) {
+    gst_memory_unmap (mem_frame, &info_frame);
+    g_free (job);
+    return;
+  }
+
+  /**
+   * The job is queued before pushing, the classifier result may arrive before returning.
+   * The job is freed once its last region is classified, do not access it after the last push.
+   */
+  num = job->num;
+  job->pending = g_app.batched ? 1 : num;
+  g_async_queue_push (g_app.jobs, job);
+
+  if (g_app.batched) {
+    /* all regions in one batch, the classifier runs once */
+    push_regions (job, (const guint8 *) info_frame.data, 0, num, g_app.max_regions);
+  } else {
+    for (i = 0; i < num; i++)
+      push_regions (job, (const guint8 *) info_frame.data, i, 1, 1);
+  }
+
+  gst_memory_unmap (mem_frame, &info_frame);
+}
+
+/**
+ * @brief Idle callback to quit the main loop, the streaming threads add it.
+ */
+static gboolean
+quit_loop_cb (gpointer user_data)
+{
+  g_main_loop_quit (g_app.loop);
+  return FALSE;
+}
+
+/**
+ * @brief Callback for tensor sink signal, the classifier result.
+ */
+static void
+classified_cb (GstElement *element, GstBuffer *buffer, gpointer user_data)
+{
+  GstMemory *mem;
+  GstMapInfo info;
+  CascadeJob *job;
+  const guint8 *scores;
+  guint labels, first, count, i, j;
+
+  g_mutex_lock (&g_app.lock);
+  job = g_app.current;
+  if (job == NULL)
+    job = (CascadeJob *) g_async_queue_try_pop (g_app.jobs);
+  if (job == NULL)
+    goto done;
+
+  mem = gst_buffer_peek_memory (buffer, 0);
+  if (!gst_memory_map (mem, &info, GST_MAP_READ)) {
+    g_free (job);
+    g_app.current = NULL;
+    goto done;
+  }
+
+  /* uint8 [1001:B], the job is pushed before its buffers */
+  if (g_app.batched) {
+    first = 0;
+    count = job->num;
+  } else {
+    first = job->num - job->pending;
+    count = 1;
+  }
+
+  labels = info.size / (g_app.batched ? g_app.max_regions : 1);
+  scores = (const guint8 *) info.data;
+
+  /* the model did not resize the batch, e.g., a model with a fixed batch of 1 */
+  if (labels < g_app.cls_total_labels) {
+    if (g_atomic_int_compare_and_exchange (&g_app.invalid, 0, 1)) {
+      g_critical ("Invalid result size %zd, the classifier should have a batch of %u",
+          info.size, g_app.batched ? g_app.max_regions : 1);
+      g_idle_add (quit_loop_cb, NULL);
+    }
+
+    gst_memory_unmap (mem, &info);
+    g_free (job);
+    g_app.current = NULL;
+    goto done;
+  }
+
+  for (i = 0; i < count; i++, scores += labels) {
+    job->label[first + i] = 0;
+    job->score[first + i] = scores[0];
+
+    for (j = 1; j < labels; j++) {
+      if (scores[j] > job->score[first + i]) {
+        job->label[first + i] = j;
+        job->score[first + i] = scores[j];
+      }
+    }
+  }
+
+  gst_memory_unmap (mem, &info);
+
+  job->pending--;
+  if (job->pending == 0) {
+    g_app.current = NULL;
+    record_job (job);
+  } else {
+    g_app.current = job;
+  }
+
+done:
+  g_mutex_unlock (&g_app.lock);
+}
+
+/**
+ * @brief Get the description of the source.
+ * @param src videotestsrc, /dev/videoX or file:PATH
+ */
+static gchar *
+get_source_desc (const gchar *src)
+{
+  if (g_str_has_prefix (src, "file:"))
+    return g_strdup_printf ("filesrc location=%s ! decodebin", src + 5);
+
+  if (g_str_has_prefix (src, "/dev/"))
+    return g_strdup_printf ("v4l2src device=%s ! decodebin", src);
+
+  return g_strdup ("videotestsrc is-live=true");
+}
+
+/**
+ * @brief Print the latency by the number of regions.
+ * @note The batch size is fixed, padded_slots is the number of unused slots the classifier runs with.
+ */
+static void
+print_report (void)
+{
+  GArray *lat, *pack;
+  guint n, batch;
+
+  g_print ("mode,regions,batch,padded_slots,frames,pack_p50_us,latency_p50_us,"
+      "latency_p90_us,latency_p99_us,latency_per_region_us\n");
+
+  for (n = 0; n <= g_app.max_regions; n++) {
+    lat = g_app.latency[n];
+    pack = g_app.pack[n];
+    if (lat->len == 0)
+      continue;
+
+    g_array_sort (lat, _compare_latency);
+    g_array_sort (pack, _compare_latency);
+    /* a frame without region is not classified */
+    batch = (n == 0) ? 0 : (g_app.batched ? g_app.max_regions : 1);
+
+    g_print ("%s,%u,%u,%u,%u,%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT
+        ",%" G_GINT64_FORMAT ",%.1f\n",
+        g_app.batched ? "batch" : "single", n, batch, g_app.batched ? batch - MIN (n, batch) : 0,
+        lat->len, _percentile (pack, 50.0),
+        _percentile (lat, 50.0), _percentile (lat, 90.0), _percentile (lat, 99.0),
+        (n > 0) ? _percentile (lat, 50.0) / (gdouble) n : 0.0);
+  }
+}
+
+/**
+ * @brief Print usage info.
+ */
+static void
+_usage (void)
+{
+  g_print ("usage: nnstreamer_example_video_crop_cascade_tflite [options]\n"
+      "    --src          videotestsrc, /dev/videoX or file:PATH. (default /dev/video0)\n"
+      "    --mode         batch (all regions at once) or single (a region per buffer). (default batch)\n"
+      "    --max-regions  Max regions per frame, 1 ~ %d. (default 8)\n"
+      "    --frames       Stop after this number of frames, 0 to run until EOS. (default 0)\n"
+      "    --cls-model    Classification model file. (default ./tflite_model_img/mobilenet_v1_1.0_224_quant.tflite)\n"
+      "                   batch mode needs a model with a batch of --max-regions, the default model has a batch of 1.\n",
+      MAX_REGIONS);
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  const gchar det_model_path[] = "./tflite_model";
+  const gchar cls_model_path[] = "./tflite_model_img";
+
+  gchar *str_pipeline, *src_desc;
+  gchar *src = g_strdup ("/dev/video0");
+  gchar *cls_file = NULL;
+  GstElement *element;
+  guint i;
+  gint opt;
+  struct option long_options[] = {
+      { "src", required_argument, NULL, 's' },
+      { "mode", required_argument, NULL, 'm' },
+      { "max-regions", required_argument, NULL, 'r' },
+      { "frames", required_argument, NULL, 'f' },
+      { "cls-model", required_argument, NULL, 'c' },
+      { "help", no_argument, NULL, 'h' },
+      { 0, 0, 0, 0 }
+  };
+
+  _print_log ("start app..");
+
+  /** init app variable */
+  memset (&g_app, 0, sizeof (AppData));
+  g_app.batched = TRUE;
+  g_app.max_regions = 8;
+
+  while ((opt = getopt_long (argc, argv, "s:m:r:f:c:h", long_options, NULL)) != -1) {
+    switch (opt) {
+      case 's':
+        g_free (src);
+        src = g_strdup (optarg);
+        break;
+      case 'm':
+        g_app.batched = (g_strcmp0 (optarg, "single") != 0);
+        break;
+      case 'r':
+        g_app.max_regions = CLAMP ((guint) g_ascii_strtoull (optarg, NULL, 10), 1, MAX_REGIONS);
+        break;
+      case 'f':
+        g_app.max_frames = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'c':
+        g_free (cls_file);
+        cls_file = g_strdup (optarg);
+        break;
+      default:
+        _usage ();
+        g_free (src);
+        g_free (cls_file);
+        return 0;
+    }
+  }
+
+  for (i = 0; i <= MAX_REGIONS; i++) {
+    g_app.latency[i] = g_array_new (FALSE, FALSE, sizeof (gint64));
+    g_app.pack[i] = g_array_new (FALSE, FALSE, sizeof (gint64));
+  }
+  g_app.jobs = g_async_queue_new ();
+  g_mutex_init (&g_app.lock);
+
+  _check_cond_err (init_model_info (det_model_path, cls_model_path, cls_file));
+
+  /** init gstreamer */
+  gst_init (&argc, &argv);
+
+  /** main loop */
+  g_app.loop = g_main_loop_new (NULL, FALSE);
+  _check_cond_err (g_app.loop != NULL);
+
+  /**
+   * init classification pipeline
+   * appsrc blocks when the classifier is behind, then the leaky queue of detection drops the frames.
+   */
+  str_pipeline = g_strdup_printf (
+      "appsrc name=cls_src block=true max-bytes=%u "
+      "caps=other/tensor,type=uint8,dimension=3:%d:%d:%u,framerate=0/1 ! "
+      "tensor_filter framework=tensorflow2-lite model=%s input=3:%d:%d:%u inputtype=uint8 ! "
+      "tensor_sink name=cls_sink",
+      (g_app.batched ? g_app.max_regions : MAX_REGIONS) * CLS_BYTES * 2,
+      CLS_SIZE, CLS_SIZE, g_app.batched ? g_app.max_regions : 1,
+      g_app.cls_model, CLS_SIZE, CLS_SIZE, g_app.batched ? g_app.max_regions : 1);
+
+  _print_log ("%s\n", str_pipeline);
+
+  g_app.cls_pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  _check_cond_err (g_app.cls_pipeline != NULL);
+
+  g_app.cls_src = gst_bin_get_by_name (GST_BIN (g_app.cls_pipeline), "cls_src");
+  _check_cond_err (g_app.cls_src != NULL);
+
+  element = gst_bin_get_by_name (GST_BIN (g_app.cls_pipeline), "cls_sink");
+  _check_cond_err (element != NULL);
+  g_signal_connect (element, "new-data", G_CALLBACK (classified_cb), NULL);
+  gst_object_unref (element);
+
+  /** init detection pipeline, the frame and its regions are muxed into a buffer */
+  src_desc = get_source_desc (src);
+  str_pipeline = g_strdup_printf (
+      "%s ! videoconvert ! videoscale ! video/x-raw,format=RGB,width=%d,height=%d ! "
+      "queue leaky=2 max-size-buffers=2 ! tee name=t "
+      "t. ! queue ! tensor_converter ! mux.sink_0 "
+      "t. ! queue ! videoscale ! video/x-raw,width=%d,height=%d ! tensor_converter ! "
+      "tensor_transform mode=arithmetic option=typecast:float32,add:-127.5,div:127.5 ! "
+      "tensor_filter framework=tensorflow2-lite model=%s ! "
+      "tensor_decoder mode=tensor_region option1=%u option2=%s option3=%s option4=%d:%d ! mux.sink_1 "
+      "tensor_mux name=mux sync-mode=slowest ! tensor_sink name=regions_sink",
+      src_desc, FRAME_WIDTH, FRAME_HEIGHT, DETECT_SIZE, DETECT_SIZE,
+      g_app.det_model, g_app.max_regions, g_app.det_label, g_app.det_box_priors,
+      DETECT_SIZE, DETECT_SIZE);
+  g_free (src_desc);
+
+  _print_log ("%s\n", str_pipeline);
+
+  g_app.pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  _check_cond_err (g_app.pipeline != NULL);
+
+  element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "regions_sink");
+  _check_cond_err (element != NULL);
+  g_signal_connect (element, "new-data", G_CALLBACK (regions_cb), NULL);
+  gst_object_unref (element);
+
+  /** bus and message callback */
+  g_app.bus = gst_element_get_bus (g_app.pipeline);
+  _check_cond_err (g_app.bus != NULL);
+  gst_bus_add_signal_watch (g_app.bus);
+  g_signal_connect (g_app.bus, "message", G_CALLBACK (bus_message_cb), NULL);
+
+  g_app.cls_bus = gst_element_get_bus (g_app.cls_pipeline);
+  _check_cond_err (g_app.cls_bus != NULL);
+  gst_bus_add_signal_watch (g_app.cls_bus);
+  g_signal_connect (g_app.cls_bus, "message", G_CALLBACK (bus_message_cb), NULL);
+
+  /** start pipeline, classifier first */
+  gst_element_set_state (g_app.cls_pipeline, GST_STATE_PLAYING);
+  gst_element_set_state (g_app.pipeline, GST_STATE_PLAYING);
+  g_app.running = TRUE;
+
+  /** run main loop */
+  g_main_loop_run (g_app.loop);
+
+  /** quit when received eos or error message */
+  g_app.running = FALSE;
+
+  /* unblock the appsrc, then stop the detection */
+  gst_app_src_end_of_stream (GST_APP_SRC (g_app.cls_src));
+  gst_element_set_state (g_app.cls_pipeline, GST_STATE_NULL);
+  gst_element_set_state (g_app.pipeline, GST_STATE_NULL);
+
+  print_report ();
+
+error:
+  _print_log ("close app..");
+
+  g_free (src);
+  g_free (cls_file);
+  free_app_data ();
+  return 0;
+}
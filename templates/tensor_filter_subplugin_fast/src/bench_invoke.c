@@ -0,0 +1,274 @@
+/**
+ * GStreamer Tensor_Filter TEMPLATE Code (fast-path variant)
+ * Copyright (C) 2019 MyungJoo Ham <myungjoo.ham@samsung.com>
+ *
+ * This is a template with no license requirements.
+ * Writers may alter the license to anything they want.
+ * The author hereby allows to do so.
+ */
+/**
+ * @file	bench_invoke.c
+ * @date	19 Oct 2026
+ * @brief	Standalone driver to measure the invoke overhead of the TEMPLATE subplugin
+ * @see		http://github.com/nnsuite/nnstreamer
+ * @author	MyungJoo Ham <myungjoo.ham@samsung.com>
+ * @bug		No known bugs
+ *
+ * This calls the subplugin callbacks directly (open, setInputDimension,
+ * invoke, destroyNotify, close) without a pipeline, so the result does not
+ * include GStreamer scheduling or caps negotiation.
+ *
+ * Run example :
+ * $ ./bench_invoke_TEMPLATE --dim=3:224:224:8 --type=uint8 --iter=1000 --custom=threads:4,pool:4
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <glib.h>
+#include <nnstreamer_plugin_api_filter.h>
+#include "tensor_filter_subplugin_fast.h"
+
+/**
+ * @brief Compare function for latency values.
+ */
+static gint
+_compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 la = *((const gint64 *) a);
+  gint64 lb = *((const gint64 *) b);
+
+  return (la > lb) ? 1 : ((la < lb) ? -1 : 0);
+}
+
+/**
+ * @brief Get the percentile from the sorted latency array.
+ */
+static gint64
+_percentile (GArray * sorted, gdouble p)
+{
+  guint idx;
+
+  if (sorted->len == 0)
+    return 0;
+
+  idx = (guint) (p / 100.0 * (sorted->len - 1) + 0.5);
+  return g_array_index (sorted, gint64, MIN (idx, sorted->len - 1));
+}
+
+/**
+ * @brief Print usage info
+ */
+static void
+_usage (void)
+{
+  g_print ("\nusage: \n"
+      "    --dim       Input dimension, e.g., 3:224:224:1 (default) \n"
+      "    --type      Input type, e.g., uint8 (default), float32 \n"
+      "    --iter      Number of invokes. (default 1000) \n"
+      "    --warmup    Number of invokes before measuring. (default 50) \n"
+      "    --custom    Custom property given to the subplugin, e.g., threads:4,pool:4 \n"
+      "    --csv       Print the result as a CSV row. \n");
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  const GstTensorFilterFramework *fw;
+  GstTensorFilterProperties prop;
+  GstTensorsInfo in_info, out_info;
+  GstTensorMemory input[NNS_TENSOR_SIZE_LIMIT], output[NNS_TENSOR_SIZE_LIMIT];
+  TEMPLATE_stats stats;
+  void *pdata = NULL;
+  gchar *dim = g_strdup ("3:224:224:1"), *type = g_strdup ("uint8");
+  gchar *custom = NULL;
+  guint iter = 1000, warmup = 50, i, t;
+  gboolean csv = FALSE, alloc_in_invoke;
+  gint64 start, open_us, release_us = 0, elapsed;
+  GArray *latency;
+  gdouble total_us = 0.0;
+  gint ch, ret = 1;
+  struct option long_options[] = {
+      { "dim", required_argument, NULL, 'd' },
+      { "type", required_argument, NULL, 't' },
+      { "iter", required_argument, NULL, 'i' },
+      { "warmup", required_argument, NULL, 'w' },
+      { "custom", required_argument, NULL, 'c' },
+      { "csv", no_argument, NULL, 's' },
+      { "help", no_argument, NULL, 'h' },
+      { 0, 0, 0, 0}
+  };
+
+  while ((ch = getopt_long (argc, argv, "d:t:i:w:c:sh", long_options, NULL)) != -1) {
+    switch (ch) {
+      case 'd':
+        g_free (dim);
+        dim = g_strdup (optarg);
+        break;
+      case 't':
+        g_free (type);
+        type = g_strdup (optarg);
+        break;
+      case 'i':
+        iter = MAX (1, (guint) g_ascii_strtoull (optarg, NULL, 10));
+        break;
+      case 'w':
+        warmup = (guint) g_ascii_strtoull (optarg, NULL, 10);
+        break;
+      case 'c':
+        g_free (custom);
+        custom = g_strdup (optarg);
+        break;
+      case 's':
+        csv = TRUE;
+        break;
+      default:
+        _usage ();
+        goto done;
+    }
+  }
+
+  fw = nnstreamer_filter_find ("TEMPLATE");
+  if (!fw || !fw->invoke_NN || !fw->setInputDimension) {
+    g_printerr ("Cannot find the tensor_filter subplugin TEMPLATE.\n");
+    goto done;
+  }
+
+  gst_tensors_info_init (&in_info);
+  gst_tensors_info_init (&out_info);
+  in_info.num_tensors = 1;
+  in_info.info[0].type = gst_tensor_get_type (type);
+  gst_tensor_parse_dimension (dim, in_info.info[0].dimension);
+  if (in_info.info[0].type == _NNS_END) {
+    g_printerr ("Invalid type %s.\n", type);
+    goto done;
+  }
+
+  memset (&prop, 0, sizeof (GstTensorFilterProperties));
+  prop.fwname = "TEMPLATE";
+  prop.custom_properties = custom;
+
+  start = g_get_monotonic_time ();
+  if (fw->open (&prop, &pdata) < 0) {
+    g_printerr ("Failed to open the subplugin.\n");
+    goto done;
+  }
+  open_us = g_get_monotonic_time () - start;
+
+  if (fw->setInputDimension (&prop, &pdata, &in_info, &out_info) != 0) {
+    g_printerr ("Failed to set the input dimension %s.\n", dim);
+    fw->close (&prop, &pdata);
+    goto done;
+  }
+
+  alloc_in_invoke = fw->allocate_in_invoke;
+#ifdef GST_TENSOR_FILTER_API_VERSION_DEFINED
+  if (alloc_in_invoke && fw->allocateInInvoke)
+    alloc_in_invoke = (fw->allocateInInvoke (&pdata) == 0);
+#endif
+
+  memset (input, 0, sizeof (input));
+  memset (output, 0, sizeof (output));
+  for (t = 0; t < in_info.num_tensors; t++) {
+    input[t].size = gst_tensor_info_get_size (&in_info.info[t]);
+    input[t].data = g_malloc0 (input[t].size);
+  }
+  for (t = 0; t < out_info.num_tensors; t++) {
+    output[t].size = gst_tensor_info_get_size (&out_info.info[t]);
+    if (!alloc_in_invoke)
+      output[t].data = g_malloc0 (output[t].size);
+  }
+
+  latency = g_array_sized_new (FALSE, FALSE, sizeof (gint64), iter);
+
+  for (i = 0; i < warmup + iter; i++) {
+    if (i == warmup)
+      TEMPLATE_reset_stats (pdata);
+
+    start = g_get_monotonic_time ();
+    if (fw->invoke_NN (&prop, &pdata, input, output) != 0) {
+      g_printerr ("Failed to invoke [%u].\n", i);
+      break;
+    }
+    elapsed = g_get_monotonic_time () - start;
+
+    if (alloc_in_invoke) {
+      /* downstream releases the output, done right away here */
+      start = g_get_monotonic_time ();
+      for (t = 0; t < out_info.num_tensors; t++) {
+        fw->destroyNotify (&pdata, output[t].data);
+        output[t].data = NULL;
+      }
+      if (i >= warmup)
+        release_us += g_get_monotonic_time () - start;
+    }
+
+    if (i >= warmup) {
+      g_array_append_val (latency, elapsed);
+      total_us += elapsed;
+    }
+  }
+
+  memset (&stats, 0, sizeof (TEMPLATE_stats));
+  TEMPLATE_get_stats (pdata, &stats);
+  g_array_sort (latency, _compare_latency);
+
+  if (latency->len > 0) {
+    gdouble avg = total_us / latency->len;
+    gdouble compute = (stats.invoke_count > 0) ?
+        (gdouble) stats.compute_total_us / stats.invoke_count : 0.0;
+    gdouble mbps = (avg > 0.0) ? input[0].size / avg : 0.0;
+
+    if (csv) {
+      g_print ("dim,type,custom,alloc_in_invoke,threads,open_us,invoke_avg_us,"
+          "invoke_p50_us,invoke_p99_us,invoke_max_us,compute_avg_us,"
+          "overhead_avg_us,release_avg_us,pool_hits,pool_misses,mb_per_sec\n");
+      g_print ("%s,%s,%s,%d,%u,%" G_GINT64_FORMAT ",%.2f,%" G_GINT64_FORMAT
+          ",%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%.2f,%.2f,%.2f,%"
+          G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT ",%.1f\n", dim, type,
+          custom ? custom : "", alloc_in_invoke, stats.num_threads, open_us,
+          avg, _percentile (latency, 50.0), _percentile (latency, 99.0),
+          _percentile (latency, 100.0), compute, avg - compute,
+          (gdouble) release_us / latency->len, stats.pool_hits,
+          stats.pool_misses, mbps);
+    } else {
+      g_print ("input %s (%s), %u invokes, %u threads, allocate_in_invoke %d\n",
+          dim, type, latency->len, stats.num_threads, alloc_in_invoke);
+      g_print ("open          : %" G_GINT64_FORMAT " us\n", open_us);
+      g_print ("invoke        : avg %.2f, p50 %" G_GINT64_FORMAT ", p99 %"
+          G_GINT64_FORMAT ", max %" G_GINT64_FORMAT " us\n", avg,
+          _percentile (latency, 50.0), _percentile (latency, 99.0),
+          _percentile (latency, 100.0));
+      g_print ("  compute     : avg %.2f us\n", compute);
+      g_print ("  overhead    : avg %.2f us\n", avg - compute);
+      g_print ("release       : avg %.2f us\n", (gdouble) release_us / latency->len);
+      g_print ("output pool   : hit %" G_GUINT64_FORMAT ", miss %" G_GUINT64_FORMAT
+          ", outstanding %d\n", stats.pool_hits, stats.pool_misses,
+          stats.pool_outstanding);
+      g_print ("throughput    : %.1f MB/s\n", mbps);
+    }
+    ret = 0;
+  }
+
+  fw->close (&prop, &pdata);
+
+  for (t = 0; t < NNS_TENSOR_SIZE_LIMIT; t++) {
+    g_free (input[t].data);
+    if (!alloc_in_invoke)
+      g_free (output[t].data);
+  }
+  g_array_free (latency, TRUE);
+  gst_tensors_info_free (&in_info);
+  gst_tensors_info_free (&out_info);
+
+done:
+  g_free (dim);
+  g_free (type);
+  g_free (custom);
+
+  return ret;
+}
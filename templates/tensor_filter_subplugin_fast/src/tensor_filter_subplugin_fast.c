@@ -0,0 +1,786 @@
+/**
+ * GStreamer Tensor_Filter TEMPLATE Code (fast-path variant)
+ * Copyright (C) 2019 MyungJoo Ham <myungjoo.ham@samsung.com>
+ *
+ * This is a template with no license requirements.
+ * Writers may alter the license to anything they want.
+ * The author hereby allows to do so.
+ */
+/**
+ * @file	tensor_filter_subplugin_fast.c
+ * @date	19 Oct 2026
+ * @brief	NNStreamer tensor-filter subplugin template with the fast path
+ * @see		http://github.com/nnsuite/nnstreamer
+ * @author	MyungJoo Ham <myungjoo.ham@samsung.com>
+ * @bug		No known bugs
+ *
+ * Compared to ../tensor_filter_subplugin, this template shows:
+ *  - allocate_in_invoke: output memory comes from a pool of aligned blocks and
+ *    is returned with destroyNotify, so steady-state invokes do not allocate.
+ *  - A persistent worker pool: threads are created in open and woken per invoke.
+ *  - Batch handling: the job is split per batch item, or within an item if the
+ *    batch is smaller than the number of threads.
+ *  - Timing counters: see tensor_filter_subplugin_fast.h and the "report" option.
+ *
+ * Options are given with the custom property of tensor_filter, e.g.,
+ *   custom=threads:4,pool:8,batch-dim:3,report:100
+ *  - threads   : number of threads running a job including the caller. (default: number of processors)
+ *  - pool      : max free output blocks kept per tensor. (default 4)
+ *                0 lets tensor_filter allocate the output with the versioned filter API.
+ *                Without it, allocate_in_invoke is fixed, so 0 allocates a block per invoke.
+ *  - batch-dim : index of the batch dimension. (default 3, e.g., C:W:H:N)
+ *  - report    : print the counters every N invokes. 0 prints on close only. (default 0)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <nnstreamer_plugin_api_filter.h>
+#include "tensor_filter_subplugin_fast.h"
+
+void init_filter_TEMPLATE (void) __attribute__ ((constructor));
+void fini_filter_TEMPLATE (void) __attribute__ ((destructor));
+
+/**
+ * @brief Alignment of the output blocks. The block header is stored in this space.
+ */
+#define TEMPLATE_BLOCK_ALIGN 64
+
+/**
+ * @brief Jobs smaller than this (bytes) are run by the caller only.
+ */
+#define TEMPLATE_MIN_PARALLEL_SIZE (64 * 1024)
+
+/**
+ * @brief Pool of output blocks. Refcounted because tensor_filter may call
+ *        destroyNotify after close, when downstream releases the buffer late.
+ */
+typedef struct
+{
+  gint refcount; /**< 1 for the owner + 1 for each outstanding block */
+  GMutex lock;
+  gboolean closed; /**< owner released the pool, do not keep returned blocks */
+  guint max_free; /**< max free blocks per tensor */
+  GSList *free_list[NNS_TENSOR_SIZE_LIMIT]; /**< free blocks per output tensor */
+  guint num_free[NNS_TENSOR_SIZE_LIMIT];
+  guint64 hits;
+  guint64 misses;
+} TEMPLATE_pool;
+
+/**
+ * @brief Header of an output block, located right before the data.
+ */
+typedef struct
+{
+  TEMPLATE_pool *pool;
+  guint index; /**< output tensor index */
+  gsize size; /**< data size */
+} TEMPLATE_block;
+
+/**
+ * @brief Function to run a chunk of a job.
+ */
+typedef void (*TEMPLATE_job_func) (guint chunk, gpointer user_data);
+
+/**
+ * @brief Persistent worker threads. The caller runs chunks as well.
+ */
+typedef struct
+{
+  GMutex lock;
+  GCond cond_start;
+  GCond cond_done;
+  GThread **threads;
+  guint num_workers; /**< threads except the caller */
+  guint generation; /**< increased for every job */
+  guint start_generation; /**< generation when the threads are created */
+  gboolean running;
+  guint pending; /**< workers still running the current job */
+
+  TEMPLATE_job_func func;
+  gpointer user_data;
+  gint num_chunks;
+  gint next_chunk;
+} TEMPLATE_workers;
+
+/**
+ * @brief If you need to store session or model data,
+ *        this is what you want to fill in.
+ */
+typedef struct
+{
+  gchar *model_path; /**< This is a sample. You may remove/change it */
+  GstTensorsInfo in_info;
+  GstTensorsInfo out_info;
+  guint batch_dim;
+  guint report;
+
+  TEMPLATE_pool *pool; /**< NULL if allocate_in_invoke is disabled */
+  TEMPLATE_workers workers;
+
+  GMutex stats_lock;
+  TEMPLATE_stats stats;
+} TEMPLATE_pdata;
+
+/**
+ * @brief Job data of an invoke.
+ */
+typedef struct
+{
+  TEMPLATE_pdata *pdata;
+  const GstTensorMemory *input;
+  GstTensorMemory *output;
+  guint index; /**< tensor index */
+  gsize chunk_size; /**< bytes per chunk */
+} TEMPLATE_job;
+
+static void TEMPLATE_close (const GstTensorFilterProperties * prop,
+    void **private_data);
+
+/**
+ * @brief Drop a reference of the pool, free it with the last one.
+ */
+static void
+TEMPLATE_pool_unref (TEMPLATE_pool * pool)
+{
+  guint i;
+
+  if (!g_atomic_int_dec_and_test (&pool->refcount))
+    return;
+
+  for (i = 0; i < NNS_TENSOR_SIZE_LIMIT; i++)
+    g_slist_free_full (pool->free_list[i], free);
+  g_mutex_clear (&pool->lock);
+  g_free (pool);
+}
+
+/**
+ * @brief Get an output block of the given size.
+ */
+static void *
+TEMPLATE_pool_acquire (TEMPLATE_pool * pool, guint index, gsize size)
+{
+  TEMPLATE_block *block = NULL;
+  void *mem;
+
+  g_mutex_lock (&pool->lock);
+  while (pool->free_list[index]) {
+    mem = pool->free_list[index]->data;
+    pool->free_list[index] =
+        g_slist_delete_link (pool->free_list[index], pool->free_list[index]);
+    pool->num_free[index]--;
+
+    if (((TEMPLATE_block *) mem)->size == size) {
+      block = (TEMPLATE_block *) mem;
+      pool->hits++;
+      break;
+    }
+    /* dimension changed, drop the stale block */
+    free (mem);
+  }
+
+  if (!block)
+    pool->misses++;
+  g_mutex_unlock (&pool->lock);
+
+  if (!block) {
+    if (posix_memalign (&mem, TEMPLATE_BLOCK_ALIGN,
+            TEMPLATE_BLOCK_ALIGN + size) != 0)
+      return NULL;
+    block = (TEMPLATE_block *) mem;
+    block->pool = pool;
+    block->index = index;
+    block->size = size;
+  }
+
+  g_atomic_int_inc (&pool->refcount);
+  return (guint8 *) block + TEMPLATE_BLOCK_ALIGN;
+}
+
+/**
+ * @brief Return an output block to its pool.
+ */
+static void
+TEMPLATE_pool_release (void *data)
+{
+  TEMPLATE_block *block =
+      (TEMPLATE_block *) ((guint8 *) data - TEMPLATE_BLOCK_ALIGN);
+  TEMPLATE_pool *pool = block->pool;
+
+  g_mutex_lock (&pool->lock);
+  if (!pool->closed && pool->num_free[block->index] < pool->max_free) {
+    pool->free_list[block->index] =
+        g_slist_prepend (pool->free_list[block->index], block);
+    pool->num_free[block->index]++;
+    block = NULL;
+  }
+  g_mutex_unlock (&pool->lock);
+
+  if (block)
+    free (block);
+  TEMPLATE_pool_unref (pool);
+}
+
+/**
+ * @brief Run chunks of the current job until none is left.
+ */
+static void
+TEMPLATE_workers_run_chunks (TEMPLATE_workers * workers)
+{
+  gint chunk;
+
+  while ((chunk = g_atomic_int_add (&workers->next_chunk, 1)) <
+      workers->num_chunks)
+    workers->func ((guint) chunk, workers->user_data);
+}
+
+/**
+ * @brief Worker thread, sleeps until a new job is given.
+ */
+static gpointer
+TEMPLATE_worker_thread (gpointer user_data)
+{
+  TEMPLATE_workers *workers = (TEMPLATE_workers *) user_data;
+  guint seen;
+
+  g_mutex_lock (&workers->lock);
+  /* a job may be given before this thread takes the lock, do not skip it */
+  seen = workers->start_generation;
+
+  while (TRUE) {
+    while (workers->running && workers->generation == seen)
+      g_cond_wait (&workers->cond_start, &workers->lock);
+
+    if (!workers->running)
+      break;
+
+    seen = workers->generation;
+    g_mutex_unlock (&workers->lock);
+
+    TEMPLATE_workers_run_chunks (workers);
+
+    g_mutex_lock (&workers->lock);
+    if (--workers->pending == 0)
+      g_cond_signal (&workers->cond_done);
+  }
+
+  g_mutex_unlock (&workers->lock);
+  return NULL;
+}
+
+/**
+ * @brief Start the worker threads.
+ */
+static void
+TEMPLATE_workers_start (TEMPLATE_workers * workers, guint num_threads)
+{
+  guint i;
+
+  g_mutex_init (&workers->lock);
+  g_cond_init (&workers->cond_start);
+  g_cond_init (&workers->cond_done);
+  workers->running = TRUE;
+  workers->num_workers = (num_threads > 1) ? num_threads - 1 : 0;
+  workers->threads = g_new0 (GThread *, workers->num_workers + 1);
+
+  g_mutex_lock (&workers->lock);
+  workers->start_generation = workers->generation;
+  g_mutex_unlock (&workers->lock);
+
+  for (i = 0; i < workers->num_workers; i++)
+    workers->threads[i] =
+        g_thread_new ("TEMPLATE-worker", TEMPLATE_worker_thread, workers);
+}
+
+/**
+ * @brief Stop and join the worker threads.
+ */
+static void
+TEMPLATE_workers_stop (TEMPLATE_workers * workers)
+{
+  guint i;
+
+  g_mutex_lock (&workers->lock);
+  workers->running = FALSE;
+  g_cond_broadcast (&workers->cond_start);
+  g_mutex_unlock (&workers->lock);
+
+  for (i = 0; i < workers->num_workers; i++)
+    g_thread_join (workers->threads[i]);
+
+  g_free (workers->threads);
+  workers->threads = NULL;
+  g_cond_clear (&workers->cond_start);
+  g_cond_clear (&workers->cond_done);
+  g_mutex_clear (&workers->lock);
+}
+
+/**
+ * @brief Run a job with the caller and the workers, returns when all chunks are done.
+ */
+static void
+TEMPLATE_workers_run (TEMPLATE_workers * workers, guint num_chunks,
+    TEMPLATE_job_func func, gpointer user_data)
+{
+  guint i;
+
+  if (workers->num_workers == 0 || num_chunks < 2) {
+    for (i = 0; i < num_chunks; i++)
+      func (i, user_data);
+    return;
+  }
+
+  g_mutex_lock (&workers->lock);
+  workers->func = func;
+  workers->user_data = user_data;
+  workers->num_chunks = (gint) num_chunks;
+  workers->next_chunk = 0;
+  workers->pending = workers->num_workers;
+  workers->generation++;
+  g_cond_broadcast (&workers->cond_start);
+  g_mutex_unlock (&workers->lock);
+
+  TEMPLATE_workers_run_chunks (workers);
+
+  g_mutex_lock (&workers->lock);
+  while (workers->pending > 0)
+    g_cond_wait (&workers->cond_done, &workers->lock);
+  g_mutex_unlock (&workers->lock);
+}
+
+/**
+ * @brief Parse the custom property (key:value,key:value).
+ */
+static void
+TEMPLATE_parse_custom (const gchar * custom, guint * num_threads,
+    guint * pool_size, guint * batch_dim, guint * report)
+{
+  gchar **options, **kv;
+  guint i;
+
+  if (!custom)
+    return;
+
+  options = g_strsplit (custom, ",", -1);
+  for (i = 0; options[i]; i++) {
+    kv = g_strsplit (options[i], ":", 2);
+
+    if (g_strv_length (kv) == 2) {
+      guint val = (guint) g_ascii_strtoull (g_strstrip (kv[1]), NULL, 10);
+      g_strstrip (kv[0]);
+
+      if (g_ascii_strcasecmp (kv[0], "threads") == 0)
+        *num_threads = MAX (val, 1);
+      else if (g_ascii_strcasecmp (kv[0], "pool") == 0)
+        *pool_size = val;
+      else if (g_ascii_strcasecmp (kv[0], "batch-dim") == 0)
+        *batch_dim = MIN (val, NNS_TENSOR_RANK_LIMIT - 1);
+      else if (g_ascii_strcasecmp (kv[0], "report") == 0)
+        *report = val;
+    }
+
+    g_strfreev (kv);
+  }
+  g_strfreev (options);
+}
+
+/**
+ * @brief Check condition to reopen model.
+ */
+static int
+TEMPLATE_reopen (const GstTensorFilterProperties * prop, void **private_data)
+{
+  /**
+   * @todo Update condition to reopen model.
+   *
+   * When called the callback 'open' with user data,
+   * check the model file or other condition whether the model or framework should be reloaded.
+   * Below is example: when model file is changed, return 1 to reopen model.
+   */
+  TEMPLATE_pdata *pdata = *private_data;
+
+  if (prop->num_models > 0 && g_strcmp0 (prop->model_files[0], pdata->model_path) != 0) {
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief The standard tensor_filter callback
+ */
+static int
+TEMPLATE_open (const GstTensorFilterProperties * prop, void **private_data)
+{
+  TEMPLATE_pdata *pdata;
+  guint num_threads, pool_size = 4, batch_dim = 3, report = 0;
+  gboolean use_pool;
+
+  if (*private_data != NULL) {
+    if (TEMPLATE_reopen (prop, private_data) != 0) {
+      TEMPLATE_close (prop, private_data);  /* "reopen" */
+    } else {
+      return 1;
+    }
+  }
+
+  pdata = g_new0 (TEMPLATE_pdata, 1);
+  if (pdata == NULL)
+    return -1;
+
+  *private_data = (void *) pdata;
+
+  /** @todo Initialize your own framework or hardware here */
+
+  if (prop->num_models > 0)
+    pdata->model_path = g_strdup (prop->model_files[0]);
+
+  num_threads = g_get_num_processors ();
+  TEMPLATE_parse_custom (prop->custom_properties, &num_threads, &pool_size,
+      &batch_dim, &report);
+
+  gst_tensors_info_init (&pdata->in_info);
+  gst_tensors_info_init (&pdata->out_info);
+  pdata->batch_dim = batch_dim;
+  pdata->report = report;
+
+#ifdef GST_TENSOR_FILTER_API_VERSION_DEFINED
+  use_pool = (pool_size > 0);
+#else
+  /* allocate_in_invoke is always TRUE, a pool without free blocks allocates per invoke */
+  use_pool = TRUE;
+#endif
+
+  if (use_pool) {
+    pdata->pool = g_new0 (TEMPLATE_pool, 1);
+    pdata->pool->refcount = 1;
+    pdata->pool->max_free = pool_size;
+    g_mutex_init (&pdata->pool->lock);
+  }
+
+  TEMPLATE_workers_start (&pdata->workers, num_threads);
+
+  g_mutex_init (&pdata->stats_lock);
+  pdata->stats.invoke_min_us = G_MAXINT64;
+  pdata->stats.num_threads = num_threads;
+
+  return 0;
+}
+
+/**
+ * @brief Print the counters.
+ */
+static void
+TEMPLATE_print_stats (TEMPLATE_pdata * pdata)
+{
+  TEMPLATE_stats stats;
+
+  if (TEMPLATE_get_stats (pdata, &stats) != 0 || stats.invoke_count == 0)
+    return;
+
+  g_message ("[TEMPLATE] invokes %" G_GUINT64_FORMAT ", avg %.1f us "
+      "(min %" G_GINT64_FORMAT ", max %" G_GINT64_FORMAT
+      ", compute %.1f us), batch %u, threads %u, pool hit %" G_GUINT64_FORMAT
+      " miss %" G_GUINT64_FORMAT " outstanding %d",
+      stats.invoke_count, (gdouble) stats.invoke_total_us / stats.invoke_count,
+      stats.invoke_min_us, stats.invoke_max_us,
+      (gdouble) stats.compute_total_us / stats.invoke_count, stats.batch,
+      stats.num_threads, stats.pool_hits, stats.pool_misses,
+      stats.pool_outstanding);
+}
+
+/**
+ * @brief The standard tensor_filter callback
+ */
+static void
+TEMPLATE_close (const GstTensorFilterProperties * prop, void **private_data)
+{
+  TEMPLATE_pdata *pdata;
+  pdata = *private_data;
+
+  /** @todo Close what you have opened/allocated with TEMPLATE_open */
+
+  TEMPLATE_print_stats (pdata);
+  TEMPLATE_workers_stop (&pdata->workers);
+
+  if (pdata->pool) {
+    /* blocks still held by downstream are freed when returned */
+    g_mutex_lock (&pdata->pool->lock);
+    pdata->pool->closed = TRUE;
+    g_mutex_unlock (&pdata->pool->lock);
+    TEMPLATE_pool_unref (pdata->pool);
+    pdata->pool = NULL;
+  }
+
+  gst_tensors_info_free (&pdata->in_info);
+  gst_tensors_info_free (&pdata->out_info);
+  g_mutex_clear (&pdata->stats_lock);
+
+  g_free (pdata->model_path);
+  pdata->model_path = NULL;
+
+  g_free (pdata);
+  *private_data = NULL;
+}
+
+/**
+ * @brief The tensor_filter callback for flexible input/output dimension.
+ * @note This template accepts any input and gives the output with the same
+ *       dimension and type. Update out_info for your model.
+ */
+static int
+TEMPLATE_setInputDim (const GstTensorFilterProperties * prop,
+    void **private_data, const GstTensorsInfo * in_info,
+    GstTensorsInfo * out_info)
+{
+  TEMPLATE_pdata *pdata = *private_data;
+
+  /** @todo Validate in_info and configure out_info for your model */
+  gst_tensors_info_free (&pdata->in_info);
+  gst_tensors_info_free (&pdata->out_info);
+  gst_tensors_info_copy (&pdata->in_info, in_info);
+  gst_tensors_info_copy (&pdata->out_info, in_info);
+  gst_tensors_info_copy (out_info, &pdata->out_info);
+
+  return 0;
+}
+
+/**
+ * @brief Get the size of the batch dimension.
+ */
+static guint
+TEMPLATE_get_batch (TEMPLATE_pdata * pdata, const GstTensorInfo * info)
+{
+  guint batch = info->dimension[pdata->batch_dim];
+
+  return (batch > 0) ? batch : 1;
+}
+
+/**
+ * @brief Run a chunk of the model. A chunk is a range of a batch item, or whole items.
+ */
+static void
+TEMPLATE_run_chunk (guint chunk, gpointer user_data)
+{
+  TEMPLATE_job *job = (TEMPLATE_job *) user_data;
+  const GstTensorMemory *in = &job->input[job->index];
+  GstTensorMemory *out = &job->output[job->index];
+  gsize offset = (gsize) chunk * job->chunk_size;
+  gsize size;
+
+  if (offset >= in->size)
+    return;
+  size = MIN (job->chunk_size, in->size - offset);
+
+  /** @todo Replace this with your kernel. This template copies input to output. */
+  memcpy ((guint8 *) out->data + offset, (const guint8 *) in->data + offset,
+      size);
+}
+
+/**
+ * @brief The standard tensor_filter callback
+ */
+static int
+TEMPLATE_invoke (const GstTensorFilterProperties * prop,
+    void **private_data, const GstTensorMemory * input,
+    GstTensorMemory * output)
+{
+  TEMPLATE_pdata *pdata = *private_data;
+  TEMPLATE_job job;
+  gint64 start, compute_start, compute_us, elapsed;
+  guint i, num_threads, batch, num_chunks, per_item;
+  gsize item_size;
+  gboolean report;
+
+  start = g_get_monotonic_time ();
+
+  /* an empty tensor has no chunk to run */
+  for (i = 0; i < pdata->in_info.num_tensors; i++) {
+    if (input[i].size == 0)
+      return -1;
+  }
+
+  if (pdata->pool) {
+    for (i = 0; i < pdata->out_info.num_tensors; i++) {
+      output[i].data = TEMPLATE_pool_acquire (pdata->pool, i, output[i].size);
+      if (output[i].data == NULL) {
+        while (i-- > 0)
+          TEMPLATE_pool_release (output[i].data);
+        return -1;
+      }
+    }
+  }
+
+  num_threads = pdata->workers.num_workers + 1;
+  batch = TEMPLATE_get_batch (pdata, &pdata->in_info.info[0]);
+
+  job.pdata = pdata;
+  job.input = input;
+  job.output = output;
+
+  compute_start = g_get_monotonic_time ();
+  for (i = 0; i < pdata->in_info.num_tensors; i++) {
+    job.index = i;
+    item_size = input[i].size / batch;
+
+    if (input[i].size < TEMPLATE_MIN_PARALLEL_SIZE || item_size == 0) {
+      /* not worth waking the workers */
+      job.chunk_size = input[i].size;
+    } else if (batch >= num_threads) {
+      /* one batch item per chunk */
+      job.chunk_size = item_size;
+    } else {
+      /* split each batch item so that every thread gets a chunk */
+      per_item = (num_threads + batch - 1) / batch;
+      job.chunk_size = (item_size + per_item - 1) / per_item;
+      job.chunk_size = (job.chunk_size + TEMPLATE_BLOCK_ALIGN - 1) &
+          ~((gsize) TEMPLATE_BLOCK_ALIGN - 1);
+    }
+
+    num_chunks = (guint) ((input[i].size + job.chunk_size - 1) /
+        MAX (job.chunk_size, 1));
+    TEMPLATE_workers_run (&pdata->workers, num_chunks, TEMPLATE_run_chunk,
+        &job);
+  }
+  compute_us = g_get_monotonic_time () - compute_start;
+  elapsed = g_get_monotonic_time () - start;
+
+  g_mutex_lock (&pdata->stats_lock);
+  pdata->stats.invoke_count++;
+  pdata->stats.invoke_total_us += elapsed;
+  pdata->stats.compute_total_us += compute_us;
+  pdata->stats.invoke_last_us = elapsed;
+  pdata->stats.invoke_min_us = MIN (pdata->stats.invoke_min_us, elapsed);
+  pdata->stats.invoke_max_us = MAX (pdata->stats.invoke_max_us, elapsed);
+  pdata->stats.batch = batch;
+  report = (pdata->report > 0 &&
+      (pdata->stats.invoke_count % pdata->report) == 0);
+  g_mutex_unlock (&pdata->stats_lock);
+
+  if (report)
+    TEMPLATE_print_stats (pdata);
+
+  return 0;
+}
+
+/**
+ * @brief The tensor_filter callback to free the output allocated in invoke.
+ */
+static void
+TEMPLATE_destroyNotify (void **private_data, void *data)
+{
+  if (data)
+    TEMPLATE_pool_release (data);
+}
+
+#ifdef GST_TENSOR_FILTER_API_VERSION_DEFINED
+/**
+ * @brief The tensor_filter callback to check allocate_in_invoke.
+ * @return 0 if the output is allocated by the subplugin.
+ */
+static int
+TEMPLATE_allocateInInvoke (void **private_data)
+{
+  TEMPLATE_pdata *pdata = *private_data;
+
+  return (pdata && pdata->pool) ? 0 : -1;
+}
+#endif
+
+/**
+ * @brief Get the counters of an opened subplugin instance.
+ */
+int
+TEMPLATE_get_stats (void *private_data, TEMPLATE_stats * stats)
+{
+  TEMPLATE_pdata *pdata = (TEMPLATE_pdata *) private_data;
+
+  if (!pdata || !stats)
+    return -1;
+
+  g_mutex_lock (&pdata->stats_lock);
+  *stats = pdata->stats;
+  g_mutex_unlock (&pdata->stats_lock);
+
+  if (stats->invoke_count == 0)
+    stats->invoke_min_us = 0;
+
+  if (pdata->pool) {
+    g_mutex_lock (&pdata->pool->lock);
+    stats->pool_hits = pdata->pool->hits;
+    stats->pool_misses = pdata->pool->misses;
+    g_mutex_unlock (&pdata->pool->lock);
+    /* the owner holds one reference */
+    stats->pool_outstanding = g_atomic_int_get (&pdata->pool->refcount) - 1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Reset the counters of an opened subplugin instance.
+ */
+void
+TEMPLATE_reset_stats (void *private_data)
+{
+  TEMPLATE_pdata *pdata = (TEMPLATE_pdata *) private_data;
+  guint num_threads;
+
+  if (!pdata)
+    return;
+
+  g_mutex_lock (&pdata->stats_lock);
+  num_threads = pdata->stats.num_threads;
+  memset (&pdata->stats, 0, sizeof (TEMPLATE_stats));
+  pdata->stats.invoke_min_us = G_MAXINT64;
+  pdata->stats.num_threads = num_threads;
+  g_mutex_unlock (&pdata->stats_lock);
+
+  if (pdata->pool) {
+    g_mutex_lock (&pdata->pool->lock);
+    pdata->pool->hits = pdata->pool->misses = 0;
+    g_mutex_unlock (&pdata->pool->lock);
+  }
+}
+
+static gchar filter_subplugin_TEMPLATE[] = "TEMPLATE";
+
+static GstTensorFilterFramework NNS_support_TEMPLATE = {
+#ifdef GST_TENSOR_FILTER_API_VERSION_DEFINED
+  .version = GST_TENSOR_FILTER_FRAMEWORK_V0,
+#else
+  .name = filter_subplugin_TEMPLATE,
+  .allow_in_place = FALSE,
+  .allocate_in_invoke = TRUE,
+  .run_without_model = TRUE,
+  .invoke_NN = TEMPLATE_invoke,
+  .setInputDimension = TEMPLATE_setInputDim,
+  .destroyNotify = TEMPLATE_destroyNotify,
+#endif
+  .open = TEMPLATE_open,
+  .close = TEMPLATE_close,
+};
+
+/**@brief Initialize this object for tensor_filter subplugin runtime register */
+void
+init_filter_TEMPLATE (void)
+{
+#ifdef GST_TENSOR_FILTER_API_VERSION_DEFINED
+  NNS_support_TEMPLATE.name = filter_subplugin_TEMPLATE;
+  NNS_support_TEMPLATE.allow_in_place = FALSE;
+  NNS_support_TEMPLATE.allocate_in_invoke = TRUE;
+  NNS_support_TEMPLATE.run_without_model = TRUE;
+  NNS_support_TEMPLATE.invoke_NN = TEMPLATE_invoke;
+  NNS_support_TEMPLATE.setInputDimension = TEMPLATE_setInputDim;
+  NNS_support_TEMPLATE.destroyNotify = TEMPLATE_destroyNotify;
+  NNS_support_TEMPLATE.allocateInInvoke = TEMPLATE_allocateInInvoke;
+#endif
+  nnstreamer_filter_probe (&NNS_support_TEMPLATE);
+}
+
+/** @brief Destruct the subplugin */
+void
+fini_filter_TEMPLATE (void)
+{
+  nnstreamer_filter_exit (NNS_support_TEMPLATE.name);
+}
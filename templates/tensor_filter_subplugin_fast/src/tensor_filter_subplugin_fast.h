@@ -0,0 +1,57 @@
+/**
+ * GStreamer Tensor_Filter TEMPLATE Code (fast-path variant)
+ * Copyright (C) 2019 MyungJoo Ham <myungjoo.ham@samsung.com>
+ *
+ * This is a template with no license requirements.
+ * Writers may alter the license to anything they want.
+ * The author hereby allows to do so.
+ */
+/**
+ * @file	tensor_filter_subplugin_fast.h
+ * @date	19 Oct 2026
+ * @brief	Timing counters of the fast-path tensor-filter subplugin template
+ * @see		http://github.com/nnsuite/nnstreamer
+ * @author	MyungJoo Ham <myungjoo.ham@samsung.com>
+ * @bug		No known bugs
+ */
+#ifndef __TENSOR_FILTER_SUBPLUGIN_TEMPLATE_FAST_H__
+#define __TENSOR_FILTER_SUBPLUGIN_TEMPLATE_FAST_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Per-instance counters, updated by every invoke.
+ */
+typedef struct
+{
+  guint64 invoke_count; /**< number of invokes */
+  guint64 invoke_total_us; /**< sum of invoke time (usec) */
+  gint64 invoke_min_us; /**< fastest invoke (usec) */
+  gint64 invoke_max_us; /**< slowest invoke (usec) */
+  gint64 invoke_last_us; /**< latest invoke (usec) */
+  guint64 compute_total_us; /**< sum of the time spent in the worker pool (usec) */
+  guint64 pool_hits; /**< output buffers reused from the pool */
+  guint64 pool_misses; /**< output buffers newly allocated */
+  gint pool_outstanding; /**< output buffers not yet returned by destroyNotify */
+  guint num_threads; /**< threads running a job, including the caller */
+  guint batch; /**< size of the batch dimension of the first input tensor */
+} TEMPLATE_stats;
+
+/**
+ * @brief Get the counters of an opened subplugin instance.
+ * @param private_data The private data given by the open callback.
+ * @param stats The counters are copied here.
+ * @return 0 on success, negative on error.
+ */
+extern int TEMPLATE_get_stats (void *private_data, TEMPLATE_stats * stats);
+
+/**
+ * @brief Reset the counters of an opened subplugin instance.
+ */
+extern void TEMPLATE_reset_stats (void *private_data);
+
+G_END_DECLS
+
+#endif /* __TENSOR_FILTER_SUBPLUGIN_TEMPLATE_FAST_H__ */